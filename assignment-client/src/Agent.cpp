@@ -38,6 +38,7 @@
 
 #include <recording/ClipCache.h>
 #include <recording/Deck.h>
+#include <recording/Ensemble.h>
 #include <recording/Recorder.h>
 #include <recording/Frame.h>
 
@@ -72,6 +73,9 @@ Agent::Agent(ReceivedMessage& message) :
     DependencyManager::set<AudioScriptingInterface>();
     DependencyManager::set<AudioInjectorManager>();
 
+    // the deck plays its clip on the thread of the ensemble
+    DependencyManager::set<recording::Ensemble>();
+    DependencyManager::get<recording::Ensemble>()->initialize();
     DependencyManager::set<recording::Deck>();
     DependencyManager::set<recording::Recorder>();
     DependencyManager::set<recording::ClipCache>();
@@ -818,6 +822,7 @@ void Agent::aboutToFinish() {
     DependencyManager::destroy<recording::Deck>();
     DependencyManager::destroy<recording::Recorder>();
     DependencyManager::destroy<recording::ClipCache>();
+    DependencyManager::destroy<recording::Ensemble>();
 
     QMetaObject::invokeMethod(&_avatarAudioTimer, "stop");
 
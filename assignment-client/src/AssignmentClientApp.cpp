@@ -20,6 +20,7 @@
 #include <HifiConfigVariantMap.h>
 #include <SharedUtil.h>
 #include <ShutdownEventListener.h>
+#include <udt/NetworkImpairment.h>
 
 #include "Assignment.h"
 #include "AssignmentClient.h"
@@ -90,6 +91,10 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     const QCommandLineOption parentPIDOption(PARENT_PID_OPTION, "PID of the parent process", "parent-pid");
     parser.addOption(parentPIDOption);
 
+    const QCommandLineOption networkImpairmentOption(udt::NETWORK_IMPAIRMENT_OPTION,
+                                                     udt::NETWORK_IMPAIRMENT_OPTION_DESCRIPTION, "settings");
+    parser.addOption(networkImpairmentOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -216,6 +221,23 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         }
     }
 
+    QString networkImpairment;
+    if (parser.isSet(networkImpairmentOption)) {
+        networkImpairment = parser.value(networkImpairmentOption);
+
+        udt::NetworkImpairment::Settings impairmentSettings;
+        if (!udt::NetworkImpairment::parseSettings(networkImpairment, impairmentSettings)) {
+            qCritical() << "Could not parse --" + udt::NETWORK_IMPAIRMENT_OPTION << networkImpairment;
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+
+        if (!(numForks || minForks || maxForks)) {
+            // a monitor isn't impaired itself, it passes the settings on to its children
+            udt::NetworkImpairment::setDefaultSettings(impairmentSettings);
+        }
+    }
+
     QThread::currentThread()->setObjectName("main thread");
 
     DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
@@ -224,7 +246,8 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
         AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks,
                                                                         requestAssignmentType, assignmentPool,
                                                                         listenPort, walletUUID, assignmentServerHostname,
-                                                                        assignmentServerPort, httpStatusPort, logDirectory);
+                                                                        assignmentServerPort, httpStatusPort, logDirectory,
+                                                                        networkImpairment);
         monitor->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, monitor, &AssignmentClientMonitor::aboutToQuit);
     } else {
@@ -17,6 +17,7 @@
 
 #include <AddressManager.h>
 #include <LogHandler.h>
+#include <udt/NetworkImpairment.h>
 #include <udt/PacketHeaders.h>
 
 #include "AssignmentClientMonitor.h"
@@ -33,7 +34,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
                                                  const unsigned int maxAssignmentClientForks,
                                                  Assignment::Type requestAssignmentType, QString assignmentPool,
                                                  quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory) :
+                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory,
+                                                 QString networkImpairment) :
     _httpManager(QHostAddress::LocalHost, httpStatusServerPort, "", this),
     _numAssignmentClientForks(numAssignmentClientForks),
     _minAssignmentClientForks(minAssignmentClientForks),
@@ -42,7 +44,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
     _assignmentPool(assignmentPool),
     _walletUUID(walletUUID),
     _assignmentServerHostname(assignmentServerHostname),
-    _assignmentServerPort(assignmentServerPort)
+    _assignmentServerPort(assignmentServerPort),
+    _networkImpairment(networkImpairment)
 
 {
     qDebug() << "_requestAssignmentType =" << _requestAssignmentType;
@@ -166,6 +169,10 @@ void AssignmentClientMonitor::spawnChildClient() {
         _childArguments.append("--" + ASSIGNMENT_TYPE_OVERRIDE_OPTION);
         _childArguments.append(QString::number(_requestAssignmentType));
     }
+    if (!_networkImpairment.isEmpty()) {
+        _childArguments.append("--" + udt::NETWORK_IMPAIRMENT_OPTION);
+        _childArguments.append(_networkImpairment);
+    }
 
     // tell children which assignment monitor port to use
     // for now they simply talk to us on localhost
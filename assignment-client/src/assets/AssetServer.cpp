@@ -12,10 +12,12 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
 #include <thread>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
@@ -28,6 +30,7 @@
 
 #include "NetworkLogging.h"
 #include "NodeType.h"
+#include "SendAssetPeersTask.h"
 #include "SendAssetTask.h"
 #include "UploadAssetTask.h"
 #include <ClientServerUtils.h>
@@ -41,6 +44,8 @@ static const int INTERFACE_RUNNING_CHECK_FREQUENCY_MS = 1000;
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
+static const size_t MAX_PEERS_PER_ASSET_REQUEST = 4;
+
 bool interfaceRunning() {
     bool result = false;
 
@@ -87,6 +92,11 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
     packetReceiver.registerListener(PacketType::AssetUpload, this, "handleAssetUpload");
     packetReceiver.registerListener(PacketType::AssetMappingOperation, this, "handleAssetMappingOperation");
+    packetReceiver.registerListener(PacketType::AssetHolderUpdate, this, "handleAssetHolderUpdate");
+    packetReceiver.registerListener(PacketType::AssetGetPeers, this, "handleAssetGetPeers");
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetServer::handleNodeKilled);
     
 #ifdef Q_OS_WIN
     updateConsumedCores();
@@ -419,6 +429,145 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
     }
 }
 
+void AssetServer::handleAssetHolderUpdate(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto holder = senderNode->getUUID();
+
+    bool isSharing;
+    if (message->getSize() < qint64(sizeof(isSharing))) {
+        qDebug() << "ERROR bad asset holder update from" << uuidStringWithoutCurlyBraces(holder);
+        return;
+    }
+    message->readPrimitive(&isSharing);
+
+    if (!isSharing) {
+        forgetHeldAssets(holder);
+        return;
+    }
+
+    uint32_t count;
+    if (message->getBytesLeftToRead() < qint64(sizeof(count))) {
+        qDebug() << "ERROR bad asset holder update from" << uuidStringWithoutCurlyBraces(holder);
+        return;
+    }
+    message->readPrimitive(&count);
+
+    if (count > message->getBytesLeftToRead() / SHA256_HASH_LENGTH) {
+        qDebug() << "ERROR asset holder update from" << uuidStringWithoutCurlyBraces(holder) << "claims" << count
+            << "assets but only has room for" << message->getBytesLeftToRead() / SHA256_HASH_LENGTH;
+        return;
+    }
+
+    auto& heldAssets = _heldAssets[holder];
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto assetHash = message->read(SHA256_HASH_LENGTH);
+
+        // only point others at assets we have, so that they can be checked against our hashes
+        if (heldAssets.contains(assetHash) || !isMappedHash(assetHash)) {
+            continue;
+        }
+
+        heldAssets.insert(assetHash);
+        _assetHolders[assetHash].holders.push_back(holder);
+    }
+}
+
+bool AssetServer::isMappedHash(const QByteArray& assetHash) {
+    if (_mappedHashesDirty) {
+        _mappedHashes.clear();
+        for (const auto& hash : _fileMappings) {
+            _mappedHashes.insert(QByteArray::fromHex(hash.toString().toLatin1()));
+        }
+        _mappedHashesDirty = false;
+    }
+    return _mappedHashes.contains(assetHash);
+}
+
+void AssetServer::handleAssetGetPeers(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    MessageID messageID;
+
+    if (message->getSize() < qint64(SHA256_HASH_LENGTH + sizeof(messageID))) {
+        qDebug() << "ERROR bad asset peers request";
+        return;
+    }
+
+    message->readPrimitive(&messageID);
+    auto assetHash = message->read(SHA256_HASH_LENGTH);
+
+    auto peers = takePeersForAsset(assetHash, senderNode);
+
+    // working out the hashes of the chunks reads the whole file the first time
+    auto task = new SendAssetPeersTask(messageID, assetHash, senderNode, peers, _filesDirectory, _chunkHashes);
+    _taskPool.start(task);
+}
+
+std::vector<SharedNodePointer> AssetServer::takePeersForAsset(const QByteArray& assetHash,
+                                                              const SharedNodePointer& requester) {
+    std::vector<SharedNodePointer> peers;
+
+    auto it = _assetHolders.find(assetHash);
+    if (it == _assetHolders.end()) {
+        return peers;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto& holders = it->holders;
+
+    // start after the last holder we handed out so that the load spreads across all of them
+    for (size_t i = 0; i < holders.size() && peers.size() < MAX_PEERS_PER_ASSET_REQUEST; ++i) {
+        const auto& holder = holders[(it->nextHolder + i) % holders.size()];
+
+        if (holder != requester->getUUID()) {
+            auto node = nodeList->nodeWithUUID(holder);
+            if (node && node->getActiveSocket()) {
+                peers.push_back(node);
+            }
+        }
+    }
+    it->nextHolder = (it->nextHolder + peers.size()) % holders.size();
+
+    // the requester isn't a node to the peers, they need to hear from us that it may connect
+    for (const auto& peer : peers) {
+        auto expectPacket = NLPacket::create(PacketType::AssetPeerExpect, -1, true);
+
+        QDataStream expectStream(expectPacket.get());
+        expectStream << requester->getPublicSocket() << requester->getLocalSocket();
+
+        nodeList->sendPacket(std::move(expectPacket), *peer);
+    }
+
+    return peers;
+}
+
+void AssetServer::forgetHeldAssets(const QUuid& holder) {
+    auto heldIt = _heldAssets.find(holder);
+    if (heldIt == _heldAssets.end()) {
+        return;
+    }
+
+    for (const auto& assetHash : heldIt.value()) {
+        auto it = _assetHolders.find(assetHash);
+        if (it == _assetHolders.end()) {
+            continue;
+        }
+
+        auto& holders = it->holders;
+        holders.erase(std::remove(holders.begin(), holders.end(), holder), holders.end());
+
+        if (holders.empty()) {
+            _assetHolders.erase(it);
+        } else {
+            it->nextHolder %= holders.size();
+        }
+    }
+
+    _heldAssets.erase(heldIt);
+}
+
+void AssetServer::handleNodeKilled(SharedNodePointer node) {
+    forgetHeldAssets(node->getUUID());
+}
+
 void AssetServer::sendStatsPacket() {
     QJsonObject serverStats;
 
@@ -442,6 +591,8 @@ void AssetServer::sendStatsPacket() {
         connectionStats["5. Period (us)"] = stat.second.packetSendPeriod;
         connectionStats["6. Up (Mb/s)"] = stat.second.sentBytes * megabitsPerSecPerByte;
         connectionStats["7. Down (Mb/s)"] = stat.second.receivedBytes * megabitsPerSecPerByte;
+        connectionStats["8. Pacing Threads"] = stat.second.pacingThreads;
+        connectionStats["9. Sched. Latency (us)"] = stat.second.schedulingLatency;
         nodeStats["Connection Stats"] = connectionStats;
 
         using Events = udt::ConnectionStats::Stats::Event;
@@ -484,6 +635,11 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    QJsonObject peerStats;
+    peerStats["1. Shared Assets"] = _assetHolders.size();
+    peerStats["2. Sharing Agents"] = _heldAssets.size();
+    serverStats["Peer Assist"] = peerStats;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -503,6 +659,7 @@ bool AssetServer::loadMappingsFromFile() {
 
             if (error.error == QJsonParseError::NoError) {
                 _fileMappings = jsonDocument.object().toVariantHash();
+                _mappedHashesDirty = true;
 
                 // remove any mappings that don't match the expected format
                 auto it = _fileMappings.begin();
@@ -541,6 +698,9 @@ bool AssetServer::loadMappingsFromFile() {
 }
 
 bool AssetServer::writeMappingsToFile() {
+    // every change to the mappings is written, or undone after a failed write
+    _mappedHashesDirty = true;
+
     auto mapFilePath = _resourcesDirectory.absoluteFilePath(MAP_FILE_NAME);
 
     QFile mapFile { mapFilePath };
@@ -12,13 +12,18 @@
 #ifndef hifi_AssetServer_h
 #define hifi_AssetServer_h
 
+#include <vector>
+
 #include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QThreadPool>
 
 #include <ThreadedAssignment.h>
 
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
+#include "SendAssetPeersTask.h"
 
 class AssetServer : public ThreadedAssignment {
     Q_OBJECT
@@ -35,6 +40,10 @@ private slots:
     void handleAssetGet(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetUpload(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer senderNode);
     void handleAssetMappingOperation(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetHolderUpdate(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetGetPeers(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+
+    void handleNodeKilled(SharedNodePointer node);
 
     void sendStatsPacket() override;
 
@@ -63,11 +72,31 @@ private:
     // deletes any unmapped files from the local asset directory
     void cleanupUnmappedFiles();
 
+    // the agents that hold the asset, taking turns between them, and tells each to expect the requester
+    std::vector<SharedNodePointer> takePeersForAsset(const QByteArray& assetHash, const SharedNodePointer& requester);
+    void forgetHeldAssets(const QUuid& holder);
+
+    // whether a mapping points at the asset, unmapped files are only around until the next cleanup
+    bool isMappedHash(const QByteArray& assetHash);
+
     Mappings _fileMappings;
 
     QDir _resourcesDirectory;
     QDir _filesDirectory;
     QThreadPool _taskPool;
+
+    // the agents that told us they hold each asset, by the raw hash, and the assets each of them holds
+    struct AssetHolders {
+        std::vector<QUuid> holders;
+        size_t nextHolder { 0 };
+    };
+    QHash<QByteArray, AssetHolders> _assetHolders;
+    QHash<QUuid, QSet<QByteArray>> _heldAssets;
+
+    // the raw hashes of _fileMappings, so that holder updates don't go to the disk for each asset
+    QSet<QByteArray> _mappedHashes;
+    bool _mappedHashesDirty { true };
+    AssetChunkHashes _chunkHashes;
 };
 
 #endif
@@ -0,0 +1,96 @@
+//
+//  SendAssetPeersTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendAssetPeersTask.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+
+#include <DependencyManager.h>
+#include <NetworkLogging.h>
+#include <NLPacketList.h>
+#include <NodeList.h>
+
+// about 2MB of hashes, for 64GB of assets
+static const int MAX_CACHED_CHUNK_HASHES = 64 * 1024;
+
+AssetChunkHashes::AssetChunkHashes() : _hashes(MAX_CACHED_CHUNK_HASHES) {
+}
+
+QList<QByteArray> AssetChunkHashes::get(const QString& filePath) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto hashes = _hashes.object(filePath);
+        if (hashes) {
+            return *hashes;
+        }
+    }
+
+    // assets don't change, so if two tasks get here at once they work out the same hashes
+    QFile file { filePath };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QList<QByteArray>();
+    }
+
+    auto hashes = hashChunks(file);
+    if (!hashes.isEmpty()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _hashes.insert(filePath, new QList<QByteArray>(hashes), hashes.size());
+    }
+    return hashes;
+}
+
+SendAssetPeersTask::SendAssetPeersTask(MessageID messageID, const QByteArray& assetHash, const SharedNodePointer& sendToNode,
+                                       const std::vector<SharedNodePointer>& peers, const QDir& resourcesDir,
+                                       AssetChunkHashes& chunkHashes) :
+    QRunnable(),
+    _messageID(messageID),
+    _assetHash(assetHash),
+    _senderNode(sendToNode),
+    _peers(peers),
+    _resourcesDir(resourcesDir),
+    _chunkHashes(chunkHashes)
+{
+
+}
+
+void SendAssetPeersTask::run() {
+    QString hexHash = _assetHash.toHex();
+    QString filePath = _resourcesDir.filePath(hexHash);
+
+    auto replyPacketList = NLPacketList::create(PacketType::AssetGetPeersReply, QByteArray(), true, true);
+    replyPacketList->writePrimitive(_messageID);
+
+    QFile file { filePath };
+    if (!file.exists()) {
+        qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+        replyPacketList->writePrimitive(AssetServerError::AssetNotFound);
+    } else {
+        auto hashes = _chunkHashes.get(filePath);
+
+        if (hashes.isEmpty() && file.size() > 0) {
+            replyPacketList->writePrimitive(AssetServerError::FileOperationFailed);
+        } else {
+            replyPacketList->writePrimitive(AssetServerError::NoError);
+
+            QDataStream stream(replyPacketList.get());
+            stream << (qint64)file.size() << (qint64)ASSET_PEER_CHUNK_SIZE << hashes << (quint8)_peers.size();
+
+            for (const auto& peer : _peers) {
+                stream << peer->getUUID() << peer->getPublicSocket() << peer->getLocalSocket();
+            }
+
+            qCDebug(networking) << "Sending" << _peers.size() << "peers for asset" << hexHash;
+        }
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->sendPacketList(std::move(replyPacketList), *_senderNode);
+}
@@ -0,0 +1,58 @@
+//
+//  SendAssetPeersTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendAssetPeersTask_h
+#define hifi_SendAssetPeersTask_h
+
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QDir>
+#include <QtCore/QList>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+
+#include "AssetUtils.h"
+#include "ClientServerUtils.h"
+#include "Node.h"
+
+// The hashes of the chunks of the assets agents have asked to fetch from peers, worked out once per asset while it's
+// among the most recently asked for.
+class AssetChunkHashes {
+public:
+    AssetChunkHashes();
+
+    // the hash of each chunk of the file, or an empty list if it can't be read
+    QList<QByteArray> get(const QString& filePath);
+
+private:
+    std::mutex _mutex;
+    QCache<QString, QList<QByteArray>> _hashes; // costed by the number of chunks
+};
+
+class SendAssetPeersTask : public QRunnable {
+public:
+    SendAssetPeersTask(MessageID messageID, const QByteArray& assetHash, const SharedNodePointer& sendToNode,
+                       const std::vector<SharedNodePointer>& peers, const QDir& resourcesDir, AssetChunkHashes& chunkHashes);
+
+    void run() override;
+
+private:
+    MessageID _messageID;
+    QByteArray _assetHash;
+    SharedNodePointer _senderNode;
+    std::vector<SharedNodePointer> _peers;
+    QDir _resourcesDir;
+    AssetChunkHashes& _chunkHashes;
+};
+
+#endif
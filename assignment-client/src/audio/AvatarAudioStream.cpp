@@ -36,11 +36,9 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         bool isStereo = channelFlag == 1;
         readBytes += sizeof(quint8);
 
-        // if isStereo value has changed, restart the ring buffer with new frame size
+        // if isStereo value has changed, restart the stream with the new number of channels
         if (isStereo != _isStereo) {
-            _ringBuffer.resizeForFrameSize(isStereo
-                                           ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
-                                           : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            setNumChannels(isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
             _isStereo = isStereo;
         }
 
@@ -0,0 +1,165 @@
+//
+//  EntityPhysicsThread.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityPhysicsThread.h"
+
+#include <chrono>
+#include <thread>
+
+#include <PhysicsHelpers.h>
+#include <SimulationOwner.h>
+
+// one tick per physics substep
+const quint64 PHYSICS_TICK_USECS = (quint64)(PHYSICS_ENGINE_FIXED_SUBSTEP * USECS_PER_SECOND);
+
+// shapes that nothing uses any more are deleted about once a second
+const uint64_t SHAPE_GARBAGE_COLLECTION_TICKS = (uint64_t)(1.0f / PHYSICS_ENGINE_FIXED_SUBSTEP);
+
+void LocalEntityEditSender::queueEditEntityMessage(PacketType type, EntityTreePointer entityTree,
+                                                   EntityItemID entityItemID, const EntityItemProperties& properties) {
+    // we are inside PhysicalEntitySimulation::handleChangedMotionStates(), which holds the lock that the tree's
+    // updateEntity() would take, so the edit waits for the end of the tick
+    _queuedEdits.emplace_back(entityItemID, properties);
+}
+
+int LocalEntityEditSender::applyQueuedEdits(EntityTreePointer tree) {
+    int numApplied = 0;
+    for (const auto& edit : _queuedEdits) {
+        EntityItemPointer entity = tree->findEntityByEntityItemID(edit.first);
+        if (!entity) {
+            continue;
+        }
+        uint32_t preFlags = entity->getDirtyFlags();
+        // a null sender is the entity-server itself
+        if (tree->updateEntity(edit.first, edit.second)) {
+            entity->markAsChangedOnServer();
+            // the RigidBody is already where the update puts the entity, so don't push it back into physics
+            entity->clearDirtyFlags(~preFlags & (Simulation::DIRTY_TRANSFORM | Simulation::DIRTY_VELOCITIES));
+            ++numApplied;
+        }
+    }
+    _queuedEdits.clear();
+    return numApplied;
+}
+
+EntityPhysicsThread::EntityPhysicsThread(EntityTreePointer tree) :
+    _tree(tree),
+    _physicsEngine(new PhysicsEngine(Vectors::ZERO)),
+    _entitySimulation(new PhysicalEntitySimulation())
+{
+    setObjectName("Entity Physics Thread");
+
+    ObjectMotionState::setShapeManager(&_shapeManager);
+    _physicsEngine->init();
+    _physicsEngine->setParallelIslandSolving(true);
+
+    _entitySimulation->init(tree, _physicsEngine, &_editSender);
+    _entitySimulation->setVolunteerPriority(SERVER_SIMULATION_PRIORITY);
+}
+
+EntityPhysicsThread::~EntityPhysicsThread() {
+    // the tree must have let go of our simulation by now, which removed every object from physics
+    _shapeManager.waitForCookedShapes();
+    _shapeManager.collectGarbage();
+}
+
+void EntityPhysicsThread::clearOwnership(const QUuid& sessionID) {
+    QMutexLocker lock(&_goneSimulatorsMutex);
+    _goneSimulators.push_back(sessionID);
+}
+
+bool EntityPhysicsThread::process() {
+    quint64 start = usecTimestampNow();
+
+    tick();
+
+    if (isStillRunning()) {
+        // sleep until the next tick (when we fall behind the PhysicsEngine catches up with extra substeps)
+        quint64 elapsed = usecTimestampNow() - start;
+        if (elapsed < PHYSICS_TICK_USECS) {
+            std::this_thread::sleep_for(std::chrono::microseconds(PHYSICS_TICK_USECS - elapsed));
+        }
+    }
+
+    return isStillRunning();
+}
+
+void EntityPhysicsThread::tick() {
+    quint64 tickStart = usecTimestampNow();
+
+    QVector<QUuid> goneSimulators;
+    {
+        QMutexLocker lock(&_goneSimulatorsMutex);
+        goneSimulators.swap(_goneSimulators);
+    }
+    if (!goneSimulators.isEmpty()) {
+        _tree->withWriteLock([&] {
+            for (const QUuid& sessionID : goneSimulators) {
+                _entitySimulation->clearOwnership(sessionID);
+            }
+        });
+    }
+
+    _entitySimulation->getObjectsToRemoveFromPhysics(_motionStates);
+    _physicsEngine->removeObjects(_motionStates);
+    _entitySimulation->deleteObjectsRemovedFromPhysics();
+    if (_numTicks % SHAPE_GARBAGE_COLLECTION_TICKS == 0) {
+        _shapeManager.collectGarbage();
+    }
+
+    _tree->withReadLock([&] {
+        _entitySimulation->getObjectsToAddToPhysics(_motionStates);
+        _physicsEngine->addObjects(_motionStates);
+    });
+    _tree->withReadLock([&] {
+        _entitySimulation->getObjectsToChange(_motionStates);
+        VectorOfMotionStates stillNeedChange = _physicsEngine->changeObjects(_motionStates);
+        _entitySimulation->setObjectsToChange(stillNeedChange);
+    });
+
+    _entitySimulation->applyDynamicChanges();
+    _physicsEngine->forEachDynamic([&](EntityDynamicPointer dynamic) {
+        dynamic->prepareForPhysicsSimulation();
+    });
+
+    quint64 stepStart = usecTimestampNow();
+    _tree->withWriteLock([&] {
+        _physicsEngine->stepSimulation();
+    });
+    int stepUsecs = (int)(usecTimestampNow() - stepStart);
+
+    if (_physicsEngine->hasOutgoingChanges()) {
+        // grab the collision events BEFORE handleChangedMotionStates() because at this point
+        // we have a better idea of which objects we own or should own.
+        auto& collisionEvents = _physicsEngine->getCollisionEvents();
+
+        _tree->withWriteLock([&] {
+            const VectorOfMotionStates& outgoingChanges = _physicsEngine->getChangedMotionStates();
+            _numActiveObjects = (int)outgoingChanges.size();
+            _entitySimulation->handleChangedMotionStates(outgoingChanges);
+
+            const VectorOfMotionStates& deactivations = _physicsEngine->getDeactivatedMotionStates();
+            _entitySimulation->handleDeactivatedMotionStates(deactivations);
+
+            _numUpdatesSent += _editSender.applyQueuedEdits(_tree);
+        });
+
+        _entitySimulation->handleCollisionEvents(collisionEvents);
+    }
+
+    _stepTime.updateAverage((float)stepUsecs);
+    _tickTime.updateAverage((float)(usecTimestampNow() - tickStart));
+    if (stepUsecs > _maxStepUsecs) {
+        _maxStepUsecs = stepUsecs;
+    }
+    _numObjects = _physicsEngine->getNumCollisionObjects();
+    _numCookingShapes = _shapeManager.getNumCookingShapes();
+    ++_numTicks;
+}
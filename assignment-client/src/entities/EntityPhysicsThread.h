@@ -0,0 +1,91 @@
+//
+//  EntityPhysicsThread.h
+//  assignment-client/src/entities
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityPhysicsThread_h
+#define hifi_EntityPhysicsThread_h
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include <QMutex>
+#include <QVector>
+
+#include <EntityEditPacketSender.h>
+#include <EntityTree.h>
+#include <GenericThread.h>
+#include <PhysicalEntitySimulation.h>
+#include <PhysicsEngine.h>
+#include <ShapeManager.h>
+#include <SimpleMovingAverage.h>
+
+/// Hands the updates of the objects we simulate to our own tree rather than to the network, from where the send
+/// threads deliver them to the viewers like any other edit.
+class LocalEntityEditSender : public EntityEditPacketSender {
+public:
+    virtual void queueEditEntityMessage(PacketType type, EntityTreePointer entityTree,
+                                        EntityItemID entityItemID, const EntityItemProperties& properties) override;
+
+    /// applies the queued edits, the tree must be write-locked
+    int applyQueuedEdits(EntityTreePointer tree);
+
+private:
+    std::vector<std::pair<EntityItemID, EntityItemProperties>> _queuedEdits;
+};
+
+/// Runs a PhysicalEntitySimulation inside the entity-server at a fixed tick, so the server simulates the dynamic
+/// entities that no viewer is interacting with.
+class EntityPhysicsThread : public GenericThread {
+    Q_OBJECT
+public:
+    EntityPhysicsThread(EntityTreePointer tree);
+    ~EntityPhysicsThread();
+
+    /// the simulation to give to the tree, before any entities are added to it
+    PhysicalEntitySimulationPointer getSimulation() const { return _entitySimulation; }
+
+    /// clears the ownership of a viewer that has gone away, on the next tick
+    void clearOwnership(const QUuid& sessionID);
+
+    virtual bool process() override;
+
+    float getAverageStepUsecs() const { return _stepTime.getAverage(); }
+    float getAverageTickUsecs() const { return _tickTime.getAverage(); }
+    int takeMaxStepUsecs() { return _maxStepUsecs.exchange(0); }
+    int getNumObjects() const { return _numObjects; }
+    int getNumActiveObjects() const { return _numActiveObjects; }
+    int getNumCookingShapes() const { return _numCookingShapes; }
+    uint64_t getNumUpdatesSent() const { return _numUpdatesSent; }
+    uint64_t getNumTicks() const { return _numTicks; }
+
+private:
+    void tick();
+
+    EntityTreePointer _tree;
+    ShapeManager _shapeManager;
+    PhysicsEnginePointer _physicsEngine;
+    PhysicalEntitySimulationPointer _entitySimulation;
+    LocalEntityEditSender _editSender;
+    VectorOfMotionStates _motionStates;
+
+    QMutex _goneSimulatorsMutex;
+    QVector<QUuid> _goneSimulators;
+
+    SimpleMovingAverage _stepTime;
+    SimpleMovingAverage _tickTime;
+    std::atomic<int> _maxStepUsecs { 0 };
+    std::atomic<int> _numObjects { 0 };
+    std::atomic<int> _numActiveObjects { 0 };
+    std::atomic<int> _numCookingShapes { 0 };
+    std::atomic<uint64_t> _numUpdatesSent { 0 };
+    std::atomic<uint64_t> _numTicks { 0 };
+};
+
+#endif // hifi_EntityPhysicsThread_h
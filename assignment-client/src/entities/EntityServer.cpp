@@ -16,9 +16,11 @@
 #include <ResourceCache.h>
 #include <ScriptCache.h>
 #include <EntityEditFilters.h>
+#include <PhysicsHelpers.h>
 
 #include "AssignmentParentFinder.h"
 #include "EntityNodeData.h"
+#include "EntityPhysicsThread.h"
 #include "EntityServer.h"
 #include "EntityServerConsts.h"
 #include "EntityTreeSendThread.h"
@@ -48,11 +50,24 @@ EntityServer::~EntityServer() {
 
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->removeNewlyCreatedHook(this);
+
+    if (_physicsThread) {
+        _physicsThread->terminate();
+        // take the simulation's objects out of physics before its ShapeManager goes away
+        tree->setSimulation(nullptr);
+        delete _physicsThread;
+        _physicsThread = nullptr;
+    }
 }
 
 void EntityServer::aboutToFinish() {
     DependencyManager::get<ResourceManager>()->cleanup();
 
+    if (_physicsThread) {
+        // stop simulating before the final persist
+        _physicsThread->terminate();
+    }
+
     OctreeServer::aboutToFinish();
 }
 
@@ -306,6 +321,13 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
         tree->setEntityScriptSourceWhitelist("");
     }
     
+    bool wantPhysicsSimulation = false;
+    readOptionBool(QString("physicsSimulation"), settingsSectionObject, wantPhysicsSimulation);
+    qDebug("physicsSimulation=%s", debug::valueOf(wantPhysicsSimulation));
+    if (wantPhysicsSimulation && !_physicsThread) {
+        startPhysicsSimulation();
+    }
+
     auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
     
     QString filterURL;
@@ -317,6 +339,25 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     }
 }
 
+void EntityServer::startPhysicsSimulation() {
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+
+    // the objects we simulate are owned by our session
+    auto nodeList = DependencyManager::get<NodeList>();
+    Physics::setSessionUUID(nodeList->getSessionUUID());
+    connect(nodeList.data(), &NodeList::uuidChanged, this, [](const QUuid& sessionUUID) {
+        Physics::setSessionUUID(sessionUUID);
+    });
+
+    // the configuration is read before the persist thread loads the entities, so the SimpleEntitySimulation
+    // we are replacing is still empty
+    _physicsThread = new EntityPhysicsThread(tree);
+    tree->setSimulation(_physicsThread->getSimulation());
+    _entitySimulation.reset();
+
+    _physicsThread->initialize(true);
+}
+
 void EntityServer::entityFilterAdded(EntityItemID id, bool success) {
     if (id.isInvalidID()) {
         if (success) {
@@ -354,6 +395,8 @@ void EntityServer::trackViewerGone(const QUuid& sessionID) {
     _viewerSendingStats.remove(sessionID);
     if (_entitySimulation) {
         _entitySimulation->clearOwnership(sessionID);
+    } else if (_physicsThread) {
+        _physicsThread->clearOwnership(sessionID);
     }
 }
 
@@ -367,6 +410,25 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    if (_physicsThread) {
+        const float USECS_PER_MSEC_FLOAT = (float)USECS_PER_MSEC;
+        statsString += "<b>Entity Server Physics Statistics</b>\r\n";
+        statsString += QString().sprintf("         Objects in physics... %d (%d active)\r\n",
+                                         _physicsThread->getNumObjects(), _physicsThread->getNumActiveObjects());
+        statsString += QString().sprintf("       Shapes being cooked... %d\r\n", _physicsThread->getNumCookingShapes());
+        statsString += QString().sprintf("    Average step simulation... %.3f msecs\r\n",
+                                         _physicsThread->getAverageStepUsecs() / USECS_PER_MSEC_FLOAT);
+        statsString += QString().sprintf("        Max step simulation... %.3f msecs (since last report)\r\n",
+                                         (float)_physicsThread->takeMaxStepUsecs() / USECS_PER_MSEC_FLOAT);
+        statsString += QString().sprintf("          Average full tick... %.3f msecs\r\n",
+                                         _physicsThread->getAverageTickUsecs() / USECS_PER_MSEC_FLOAT);
+        statsString += QString("                      Ticks... %1\r\n")
+            .arg(locale.toString((qulonglong)_physicsThread->getNumTicks()));
+        statsString += QString("               Updates sent... %1\r\n")
+            .arg(locale.toString((qulonglong)_physicsThread->getNumUpdatesSent()));
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
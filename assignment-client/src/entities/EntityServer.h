@@ -29,6 +29,7 @@ struct ViewerSendingStats {
 
 class SimpleEntitySimulation;
 using SimpleEntitySimulationPointer = std::shared_ptr<SimpleEntitySimulation>;
+class EntityPhysicsThread;
 
 
 class EntityServer : public OctreeServer, public NewlyCreatedEntityHook {
@@ -75,7 +76,10 @@ private slots:
     void handleEntityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
+    void startPhysicsSimulation();
+
     SimpleEntitySimulationPointer _entitySimulation;
+    EntityPhysicsThread* _physicsThread { nullptr };
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
 
     QReadWriteLock _viewerSendingStatsLock;
@@ -0,0 +1,84 @@
+#
+#  PatchQuickprof.cmake
+#  cmake/externals/bullet
+#
+#  Copyright 2017 High Fidelity, Inc.
+#
+#  Distributed under the Apache License, Version 2.0.
+#  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+#
+#  Run as the PATCH_COMMAND of the bullet external with -DSOURCE_DIR=<SOURCE_DIR>.
+#
+#  Bullet's CProfileManager keeps a single call tree that isn't thread safe, so every BT_PROFILE inside the
+#  constraint solver would corrupt it when simulation islands are solved on worker threads.  This adds a
+#  per-thread switch that those threads use to skip their samples.
+#
+
+set(QUICKPROF_HEADER "${SOURCE_DIR}/src/LinearMath/btQuickprof.h")
+set(QUICKPROF_SOURCE "${SOURCE_DIR}/src/LinearMath/btQuickprof.cpp")
+
+file(READ "${QUICKPROF_HEADER}" HEADER_CONTENTS)
+if (HEADER_CONTENTS MATCHES "BT_HAS_THREAD_PROFILING_SWITCH")
+  # already patched
+  return()
+endif ()
+
+set(THREAD_PROFILE_SAMPLE [=[
+///Samples are skipped on threads that have turned profiling off, CProfileManager can only be used from one thread
+#define BT_HAS_THREAD_PROFILING_SWITCH
+void btSetThreadProfilingEnabled(bool enabled);
+bool btIsThreadProfilingEnabled();
+
+class CThreadProfileSample {
+public:
+	CThreadProfileSample(const char* name) : m_enabled(btIsThreadProfilingEnabled())
+	{
+		if (m_enabled) {
+			CProfileManager::Start_Profile(name);
+		}
+	}
+
+	~CThreadProfileSample()
+	{
+		if (m_enabled) {
+			CProfileManager::Stop_Profile();
+		}
+	}
+
+private:
+	bool m_enabled;
+};
+
+#define	BT_PROFILE( name )			CThreadProfileSample __profile( name )]=])
+
+string(REGEX REPLACE "#define[ \t]+BT_PROFILE\\([ \t]*name[ \t]*\\)[ \t]+CProfileSample[ \t]+__profile\\([ \t]*name[ \t]*\\)"
+  "${THREAD_PROFILE_SAMPLE}" PATCHED_HEADER_CONTENTS "${HEADER_CONTENTS}")
+
+if (PATCHED_HEADER_CONTENTS STREQUAL HEADER_CONTENTS)
+  message(FATAL_ERROR "Could not find the BT_PROFILE definition to patch in ${QUICKPROF_HEADER}")
+endif ()
+
+file(WRITE "${QUICKPROF_HEADER}" "${PATCHED_HEADER_CONTENTS}")
+
+file(APPEND "${QUICKPROF_SOURCE}" [=[
+
+#ifndef BT_NO_PROFILE
+
+#if defined(_MSC_VER)
+static __declspec(thread) bool gThreadProfilingDisabled = false;
+#else
+static __thread bool gThreadProfilingDisabled = false;
+#endif
+
+void btSetThreadProfilingEnabled(bool enabled)
+{
+	gThreadProfilingDisabled = !enabled;
+}
+
+bool btIsThreadProfilingEnabled()
+{
+	return !gThreadProfilingDisabled;
+}
+
+#endif //BT_NO_PROFILE
+]=])
@@ -0,0 +1,12 @@
+# 
+#  Copyright 2017 High Fidelity, Inc.
+#
+#  Distributed under the Apache License, Version 2.0.
+#  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+# 
+macro(TARGET_ZSTD)
+  add_dependency_external_projects(zstd)
+  find_package(Zstd REQUIRED)
+  target_include_directories(${TARGET_NAME} SYSTEM PRIVATE ${ZSTD_INCLUDE_DIRS})
+  target_link_libraries(${TARGET_NAME} ${ZSTD_LIBRARIES})
+endmacro()
@@ -0,0 +1,34 @@
+#
+#  FindZstd.cmake
+# 
+#  Try to find the zstd compression library
+#
+#  You can provide a ZSTD_ROOT_DIR which contains lib and include directories
+#
+#  Once done this will define
+#
+#  ZSTD_FOUND - system found zstd
+#  ZSTD_INCLUDE_DIRS - the zstd include directory
+#  ZSTD_LIBRARIES - link to this to use zstd
+#
+#  Copyright 2017 High Fidelity, Inc.
+#
+#  Distributed under the Apache License, Version 2.0.
+#  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+# 
+
+include("${MACRO_DIR}/HifiLibrarySearchHints.cmake")
+hifi_library_search_hints("zstd")
+
+find_path(ZSTD_INCLUDE_DIRS zstd.h PATH_SUFFIXES include HINTS ${ZSTD_SEARCH_DIRS})
+
+find_library(ZSTD_LIBRARY_DEBUG NAMES zstd_static zstd PATH_SUFFIXES lib/Debug lib HINTS ${ZSTD_SEARCH_DIRS})
+find_library(ZSTD_LIBRARY_RELEASE NAMES zstd_static zstd PATH_SUFFIXES lib/Release lib HINTS ${ZSTD_SEARCH_DIRS})
+
+include(SelectLibraryConfigurations)
+select_library_configurations(ZSTD)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd DEFAULT_MSG ZSTD_INCLUDE_DIRS ZSTD_LIBRARIES)
+
+mark_as_advanced(ZSTD_INCLUDE_DIRS ZSTD_LIBRARIES ZSTD_SEARCH_DIRS)
@@ -32,6 +32,7 @@
 #include <HTTPConnection.h>
 #include <LogUtils.h>
 #include <NetworkingConstants.h>
+#include <udt/NetworkImpairment.h>
 #include <udt/PacketHeaders.h>
 #include <SettingHandle.h>
 #include <SharedUtil.h>
@@ -224,6 +225,10 @@ void DomainServer::parseCommandLine() {
     const QCommandLineOption parentPIDOption(PARENT_PID_OPTION, "PID of the parent process", "parent-pid");
     parser.addOption(parentPIDOption);
 
+    const QCommandLineOption networkImpairmentOption(udt::NETWORK_IMPAIRMENT_OPTION,
+                                                     udt::NETWORK_IMPAIRMENT_OPTION_DESCRIPTION, "settings");
+    parser.addOption(networkImpairmentOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qWarning() << parser.errorText() << endl;
         parser.showHelp();
@@ -262,6 +267,17 @@ void DomainServer::parseCommandLine() {
             watchParentProcess(parentPID);
         }
     }
+
+    if (parser.isSet(networkImpairmentOption)) {
+        // this has to be set before the LimitedNodeList creates its sockets
+        udt::NetworkImpairment::Settings impairmentSettings;
+        if (udt::NetworkImpairment::parseSettings(parser.value(networkImpairmentOption), impairmentSettings)) {
+            udt::NetworkImpairment::setDefaultSettings(impairmentSettings);
+        } else {
+            qWarning() << "Could not parse network impairment settings from" << parser.value(networkImpairmentOption);
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+    }
 }
 
 DomainServer::~DomainServer() {
@@ -852,6 +868,16 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
     }
 }
 
+const quint64 DOMAIN_LIST_FRAGMENT_REFRESH_INTERVAL_USECS = 100 * USECS_PER_MSEC;
+const size_t MAX_DOMAIN_LIST_REMOVALS = 32;
+
+static QByteArray domainListFragmentForNode(const Node& node) {
+    QByteArray fragment;
+    QDataStream fragmentStream(&fragment, QIODevice::WriteOnly);
+    fragmentStream << node;
+    return fragment;
+}
+
 void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
 
     QDataStream packetStream(message->getMessage());
@@ -870,12 +896,25 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
         safeInterestSet.remove(NodeType::Agent);
     }
 
+    // a node whose interest set changed can't be brought up to date with a delta, so it gets a full list
+    bool interestSetChanged = nodeData->getNodeInterestSet() != safeInterestSet;
+    if (interestSetChanged) {
+        // the interest set of an agent decides if the entity-script-server hears about it, so treat this as a change
+        recordDomainListChange(sendingNode, domainListFragmentForNode(*sendingNode));
+    }
+
     nodeData->setNodeInterestSet(safeInterestSet);
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
 
-    sendDomainListToNode(sendingNode, message->getSenderSockAddr());
+    // newer nodes tell us the last domain list revision they have seen, so they can be sent only what changed since
+    quint32 lastDomainListRevision = 0;
+    if (!packetStream.atEnd() && !interestSetChanged) {
+        packetStream >> lastDomainListRevision;
+    }
+
+    sendDomainListToNode(sendingNode, message->getSenderSockAddr(), lastDomainListRevision);
 }
 
 bool DomainServer::isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
@@ -990,8 +1029,79 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+void DomainServer::recordDomainListChange(const SharedNodePointer& node, const QByteArray& fragment) {
+    auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (!nodeData) {
+        return;
+    }
+
+    // each node only has one entry in the change log, at the revision of its latest change
+    _domainListChanges.erase(nodeData->getDomainListRevision());
+
+    nodeData->setDomainListFragment(fragment, ++_domainListRevision);
+    _domainListChanges[_domainListRevision] = node->getUUID();
+}
+
+void DomainServer::recordDomainListRemoval(const SharedNodePointer& node) {
+    auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (nodeData) {
+        _domainListChanges.erase(nodeData->getDomainListRevision());
+    }
+
+    _domainListRemovals[++_domainListRevision] = node->getUUID();
+
+    // only a limited number of removals are remembered - nodes that have seen a revision older
+    // than the oldest removal we still know about will need a full list
+    while (_domainListRemovals.size() > MAX_DOMAIN_LIST_REMOVALS) {
+        _oldestDomainListDeltaRevision = _domainListRemovals.begin()->first;
+        _domainListRemovals.erase(_domainListRemovals.begin());
+    }
+}
+
+void DomainServer::refreshDomainListFragments() {
+    // sockets and permissions change rarely, so only look for changes every so often
+    // instead of on every list request - what we miss now is picked up at the next refresh
+    quint64 now = usecTimestampNow();
+    if (now - _lastDomainListRefresh < DOMAIN_LIST_FRAGMENT_REFRESH_INTERVAL_USECS) {
+        return;
+    }
+    _lastDomainListRefresh = now;
+
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+    limitedNodeList->eachNode([&](const SharedNodePointer& node) {
+        auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+        if (nodeData) {
+            QByteArray fragment = domainListFragmentForNode(*node);
+            if (fragment != nodeData->getDomainListFragment()) {
+                recordDomainListChange(node, fragment);
+            }
+        }
+    });
+}
+
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 lastDomainListRevision) {
+    refreshDomainListFragments();
+
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // we can only send the changes since the revision the node has seen if we still know about all of them,
+    // and if nothing about the node itself changed since then (its permissions decide which nodes it may hear about)
+    bool isDelta = lastDomainListRevision != 0
+        && lastDomainListRevision <= _domainListRevision
+        && lastDomainListRevision >= _oldestDomainListDeltaRevision
+        && nodeData->getDomainListRevision() <= lastDomainListRevision
+        && !nodeData->getDomainListFragment().isEmpty();
+
+    QList<QUuid> removedNodes;
+    if (isDelta) {
+        for (auto it = _domainListRemovals.upper_bound(lastDomainListRevision); it != _domainListRemovals.end(); ++it) {
+            removedNodes << it->second;
+        }
+    }
+
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2
+        + sizeof(quint32) + sizeof(bool) + sizeof(quint32) + removedNodes.size() * NUM_BYTES_RFC4122_UUID;
 
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
@@ -1003,37 +1113,58 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getPermissions();
+    extendedHeaderStream << _domainListRevision;
+    extendedHeaderStream << isDelta;
+    extendedHeaderStream << removedNodes;
 
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
-    if (nodeInterestSet.size() > 0) {
+    auto addNodeToList = [&](const SharedNodePointer& otherNode) {
+        auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        if (otherNodeData && otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
+            if (otherNodeData->getDomainListFragment().isEmpty()) {
+                // this node was added since the last refresh, serialize it now
+                recordDomainListChange(otherNode, domainListFragmentForNode(*otherNode));
+            }
+
+            // since we're about to add a node to the packet we start a segment
+            domainListPackets->startSegment();
+
+            // the serialized node is shared by every list it is sent in
+            const QByteArray& fragment = otherNodeData->getDomainListFragment();
+            domainListStream.writeRawData(fragment.constData(), fragment.size());
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+            // pack the secret that these two nodes will use to communicate with each other
+            domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+            // we've added the node we wanted so end the segment now
+            domainListPackets->endSegment();
+        }
+    };
+
+    if (nodeInterestSet.size() > 0) {
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+        if (nodeData->isAuthenticated()) {
+            if (isDelta) {
+                // only the nodes that changed since the revision this node has seen need to be sent
+                for (auto it = _domainListChanges.upper_bound(lastDomainListRevision); it != _domainListChanges.end(); ++it) {
+                    auto otherNode = limitedNodeList->nodeWithUUID(it->second);
+                    if (otherNode) {
+                        addNodeToList(otherNode);
+                    }
                 }
-            });
+            } else {
+                // if this authenticated node has any interest types, send back those nodes as well
+                limitedNodeList->eachNode(addNodeToList);
+            }
         }
     }
 
@@ -2463,6 +2594,9 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
 
+    // remember the removal so that nodes receiving incremental domain lists hear about it
+    recordDomainListRemoval(node);
+
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
     if (nodeData) {
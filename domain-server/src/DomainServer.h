@@ -21,6 +21,8 @@
 #include <QtCore/QUrl>
 #include <QAbstractNativeEventFilter>
 
+#include <map>
+
 #include <Assignment.h>
 #include <HTTPSConnection.h>
 #include <LimitedNodeList.h>
@@ -144,7 +146,12 @@ private:
 
     void handleKillNode(SharedNodePointer nodeToKill);
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 lastDomainListRevision = 0);
+
+    void refreshDomainListFragments();
+    void recordDomainListChange(const SharedNodePointer& node, const QByteArray& fragment);
+    void recordDomainListRemoval(const SharedNodePointer& node);
 
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
@@ -242,6 +249,14 @@ private:
     bool _sendICEServerAddressToMetaverseAPIRedo { false };
 
     QHash<QUuid, QPointer<HTTPSConnection>> _pendingOAuthConnections;
+
+    // Domain lists are versioned so that nodes checking in only receive what changed since the revision they last saw.
+    // Each node is tracked at the revision of its latest change, removed nodes are kept as tombstones for a while.
+    quint32 _domainListRevision { 0 };
+    quint32 _oldestDomainListDeltaRevision { 0 };
+    quint64 _lastDomainListRefresh { 0 };
+    std::map<quint32, QUuid> _domainListChanges;
+    std::map<quint32, QUuid> _domainListRemovals;
 };
 
 
@@ -68,6 +68,14 @@ public:
 
     bool wasAssigned() const { return _wasAssigned; };
     void setWasAssigned(bool wasAssigned) { _wasAssigned = wasAssigned; }
+
+    // the serialized form of this node sent to others in domain lists, and the domain list revision it last changed at
+    const QByteArray& getDomainListFragment() const { return _domainListFragment; }
+    quint32 getDomainListRevision() const { return _domainListRevision; }
+    void setDomainListFragment(const QByteArray& fragment, quint32 revision) {
+        _domainListFragment = fragment;
+        _domainListRevision = revision;
+    }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -93,6 +101,9 @@ private:
     QString _placeName;
 
     bool _wasAssigned { false };
+
+    QByteArray _domainListFragment;
+    quint32 _domainListRevision { 0 };
 };
 
 #endif // hifi_DomainServerNodeData_h
@@ -14,6 +14,8 @@
 #include <openssl/x509.h>
 
 #include <QtCore/QJsonDocument>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -21,11 +23,38 @@
 #include <LimitedNodeList.h>
 #include <NetworkAccessManager.h>
 #include <NetworkingConstants.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
+const int HEARTBEAT_STATS_INTERVAL_MSECS = 10 * 1000;
+const quint64 VERIFIED_HEARTBEAT_TTL_USECS = 30 * USECS_PER_SECOND;
+
+class HeartbeatVerifier : public QRunnable {
+public:
+    HeartbeatVerifier(IceServer* server, const PendingHeartbeat& heartbeat, RSASharedPtr publicKey) :
+        _server(server), _heartbeat(heartbeat), _publicKey(publicKey) {}
+
+    void run() override {
+        int verificationResult = RSA_verify(NID_sha256,
+                                            reinterpret_cast<const unsigned char*>(_heartbeat.plaintextHash.constData()),
+                                            _heartbeat.plaintextHash.size(),
+                                            reinterpret_cast<const unsigned char*>(_heartbeat.signature.constData()),
+                                            _heartbeat.signature.size(),
+                                            _publicKey.get());
+
+        // hand the result back to the ice-server so it can reply from the packet thread
+        QMetaObject::invokeMethod(_server, "heartbeatVerificationFinished", Qt::QueuedConnection,
+                                  Q_ARG(PendingHeartbeat, _heartbeat), Q_ARG(bool, verificationResult == 1));
+    }
+
+private:
+    IceServer* _server;
+    PendingHeartbeat _heartbeat;
+    RSASharedPtr _publicKey;
+};
 
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
@@ -49,6 +78,14 @@ IceServer::IceServer(int argc, char* argv[]) :
     connect(inactivePeerTimer, &QTimer::timeout, this, &IceServer::clearInactivePeers);
     inactivePeerTimer->start(CLEAR_INACTIVE_PEERS_INTERVAL_MSECS);
 
+    // RSA verification of heartbeats happens on these threads
+    qRegisterMetaType<PendingHeartbeat>("PendingHeartbeat");
+    _verificationThreadPool.setMaxThreadCount(QThread::idealThreadCount());
+
+    QTimer* heartbeatStatsTimer = new QTimer(this);
+    connect(heartbeatStatsTimer, &QTimer::timeout, this, &IceServer::logHeartbeatStats);
+    heartbeatStatsTimer->start(HEARTBEAT_STATS_INTERVAL_MSECS);
+
     // handle public keys when they arrive from the QNetworkAccessManager
     auto& networkAccessManager = NetworkAccessManager::getInstance();
     connect(&networkAccessManager, &QNetworkAccessManager::finished, this, &IceServer::publicKeyReplyFinished);
@@ -73,20 +110,7 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
-
-                // we have an active and verified heartbeating peer
-                // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
-            } else {
-                // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
-            }
+            processHeartbeat(*nlPacket);
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
             QDataStream heartbeatStream(nlPacket.get());
             
@@ -123,85 +147,130 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
+void IceServer::processHeartbeat(NLPacket& packet) {
+    PendingHeartbeat heartbeat;
+    heartbeat.senderSocket = packet.getSenderSockAddr();
 
     // pull the UUID, public and private sock addrs for this peer
-    QUuid senderUUID;
-    HifiSockAddr publicSocket, localSocket;
-    QByteArray signature;
-
     QDataStream heartbeatStream(&packet);
-    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
+    heartbeatStream >> heartbeat.domainID >> heartbeat.publicSocket >> heartbeat.localSocket;
 
     auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
-    heartbeatStream >> signature;
+    heartbeatStream >> heartbeat.signature;
 
-    // make sure this is a verified heartbeat before performing any more processing
-    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
-        // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+    heartbeat.plaintextHash = QCryptographicHash::hash(signedPlaintext, QCryptographicHash::Sha256);
 
-        if (!matchingPeer) {
-            // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
-
-            qDebug() << "Added a new network peer" << *matchingPeer;
-        } else {
-            // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
-        }
-
-        // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-        
-        return matchingPeer;
-    } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+    // a heartbeat identical to one we recently verified doesn't need another signature check
+    if (hasCachedVerification(heartbeat)) {
+        ++_numCachedVerifications;
+        sendHeartbeatReply(heartbeat, true);
+        return;
     }
-}
 
-bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
     // make sure we're not already waiting for a public key for this domain-server
-    if (!_pendingPublicKeyRequests.contains(domainID)) {
+    if (!_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
         // check if we have a public key for this domain ID - if we do not then fire off the request for it
-        auto it = _domainPublicKeys.find(domainID);
+        auto it = _domainPublicKeys.find(heartbeat.domainID);
         if (it != _domainPublicKeys.end()) {
-
-            // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
-
-            if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
+            if (it->second) {
+                // only one heartbeat per domain is verified at a time - the domain-server will send another one shortly
+                if (!_pendingVerifications.contains(heartbeat.domainID)) {
+                    _pendingVerifications.insert(heartbeat.domainID);
+                    _verificationThreadPool.start(new HeartbeatVerifier(this, heartbeat, it->second));
                 } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
+                    ++_numDroppedHeartbeats;
                 }
 
+                // we'll reply once the signature has been checked
+                return;
             } else {
                 // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
+                qWarning() << "Public key for" << heartbeat.domainID << "is not a usable RSA* public key.";
                 qWarning() << "Re-requesting public key from API";
             }
         }
 
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
-        requestDomainPublicKey(domainID);
+        // we could not verify this heartbeat (missing public key, could not load public key)
+        // ask the metaverse API for the right public key
+        requestDomainPublicKey(heartbeat.domainID);
+    }
+
+    ++_numDeniedHeartbeats;
+    sendHeartbeatReply(heartbeat, false);
+}
+
+void IceServer::heartbeatVerificationFinished(PendingHeartbeat heartbeat, bool isVerified) {
+    _pendingVerifications.remove(heartbeat.domainID);
+
+    if (isVerified) {
+        ++_numRSAVerifications;
+        _verifiedHeartbeats[heartbeat.domainID] = { heartbeat.plaintextHash, heartbeat.signature, usecTimestampNow() };
+    } else {
+        qDebug() << "Failed to verify heartbeat for" << heartbeat.domainID << "- re-requesting public key from API.";
+        ++_numDeniedHeartbeats;
+
+        // bad actor or a domain-server that has re-generated its keypair, get the current public key
+        if (!_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
+            requestDomainPublicKey(heartbeat.domainID);
+        }
+    }
+
+    sendHeartbeatReply(heartbeat, isVerified);
+}
+
+bool IceServer::hasCachedVerification(const PendingHeartbeat& heartbeat) {
+    auto it = _verifiedHeartbeats.find(heartbeat.domainID);
+    if (it == _verifiedHeartbeats.end()) {
+        return false;
     }
 
-    return false;
+    if (usecTimestampNow() - it->second.verifiedAt > VERIFIED_HEARTBEAT_TTL_USECS) {
+        // make sure we check the signature again every so often, in case the domain's key was revoked
+        _verifiedHeartbeats.erase(it);
+        return false;
+    }
+
+    return it->second.plaintextHash == heartbeat.plaintextHash && it->second.signature == heartbeat.signature;
+}
+
+void IceServer::sendHeartbeatReply(const PendingHeartbeat& heartbeat, bool isVerified) {
+    if (isVerified) {
+        SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(heartbeat);
+
+        // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+        peer->activateMatchingOrNewSymmetricSocket(heartbeat.senderSocket);
+
+        // we have an active and verified heartbeating peer
+        // send them an ACK packet so they know that they are being heard and ready for ICE
+        static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+        _serverSocket.writePacket(*ackPacket, heartbeat.senderSocket);
+    } else {
+        // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
+        static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+        _serverSocket.writePacket(*deniedPacket, heartbeat.senderSocket);
+    }
+}
+
+SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(const PendingHeartbeat& heartbeat) {
+    // make sure we have this sender in our peer hash
+    SharedNetworkPeer matchingPeer = _activePeers.value(heartbeat.domainID);
+
+    if (!matchingPeer) {
+        // if we don't have this sender we need to create them now
+        matchingPeer = QSharedPointer<NetworkPeer>::create(heartbeat.domainID, heartbeat.publicSocket, heartbeat.localSocket);
+        _activePeers.insert(heartbeat.domainID, matchingPeer);
+
+        qDebug() << "Added a new network peer" << *matchingPeer;
+    } else {
+        // we already had the peer so just potentially update their sockets
+        matchingPeer->setPublicSocket(heartbeat.publicSocket);
+        matchingPeer->setLocalSocket(heartbeat.localSocket);
+    }
+
+    // update our last heard microstamp for this network peer to now
+    matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+
+    return matchingPeer;
 }
 
 void IceServer::requestDomainPublicKey(const QUuid& domainID) {
@@ -253,7 +322,10 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
 
                 if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+                    _domainPublicKeys[domainID] = RSASharedPtr(rsaPublicKey, RSA_free);
+
+                    // anything verified with a previous key for this domain has to be checked again
+                    _verifiedHeartbeats.erase(domainID);
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -298,8 +370,9 @@ void IceServer::clearInactivePeers() {
         if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
             qDebug() << "Removing peer from memory for inactivity -" << *peer;
 
-            // if we had a public key for this domain, remove it now
+            // if we had a public key or a verified heartbeat for this domain, remove them now
             _domainPublicKeys.erase(peer->getUUID());
+            _verifiedHeartbeats.erase(peer->getUUID());
 
             // remove the peer object
             peerItem = _activePeers.erase(peerItem);
@@ -309,3 +382,16 @@ void IceServer::clearInactivePeers() {
         }
     }
 }
+
+void IceServer::logHeartbeatStats() {
+    if (_numCachedVerifications + _numRSAVerifications + _numDeniedHeartbeats + _numDroppedHeartbeats > 0) {
+        qDebug() << "Heartbeats in the last" << HEARTBEAT_STATS_INTERVAL_MSECS / 1000 << "seconds -"
+            << _numCachedVerifications << "verified from cache," << _numRSAVerifications << "verified with RSA,"
+            << _numDeniedHeartbeats << "denied," << _numDroppedHeartbeats << "dropped while verifying";
+    }
+
+    _numCachedVerifications = 0;
+    _numRSAVerifications = 0;
+    _numDeniedHeartbeats = 0;
+    _numDroppedHeartbeats = 0;
+}
@@ -14,6 +14,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 #include <QUdpSocket>
 
 #include <openssl/rsa.h>
@@ -28,6 +29,19 @@
 
 class QNetworkReply;
 
+using RSASharedPtr = std::shared_ptr<RSA>;
+
+// the parts of a heartbeat we need to hold on to while its signature is checked away from the packet thread
+struct PendingHeartbeat {
+    QUuid domainID;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+    HifiSockAddr senderSocket;
+    QByteArray plaintextHash;
+    QByteArray signature;
+};
+Q_DECLARE_METATYPE(PendingHeartbeat)
+
 class IceServer : public QCoreApplication {
     Q_OBJECT
 public:
@@ -35,14 +49,18 @@ public:
 private slots:
     void clearInactivePeers();
     void publicKeyReplyFinished(QNetworkReply* reply);
+    void heartbeatVerificationFinished(PendingHeartbeat heartbeat, bool isVerified);
+    void logHeartbeatStats();
 private:
     bool packetVersionMatch(const udt::Packet& packet);
     void processPacket(std::unique_ptr<udt::Packet> packet);
     
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
+    void processHeartbeat(NLPacket& packet);
+    SharedNetworkPeer addOrUpdateHeartbeatingPeer(const PendingHeartbeat& heartbeat);
+    void sendHeartbeatReply(const PendingHeartbeat& heartbeat, bool isVerified);
     void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
 
-    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
+    bool hasCachedVerification(const PendingHeartbeat& heartbeat);
     void requestDomainPublicKey(const QUuid& domainID);
 
     QUuid _id;
@@ -51,11 +69,27 @@ private:
     using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
     NetworkPeerHash _activePeers;
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
+    using DomainPublicKeyHash = std::unordered_map<QUuid, RSASharedPtr>;
     DomainPublicKeyHash _domainPublicKeys;
 
     QSet<QUuid> _pendingPublicKeyRequests;
+
+    // domain-servers re-send the same signed heartbeat until their sockets change, so once a heartbeat has been
+    // verified we remember it for a little while and skip the RSA verification for identical heartbeats
+    struct VerifiedHeartbeat {
+        QByteArray plaintextHash;
+        QByteArray signature;
+        quint64 verifiedAt;
+    };
+    std::unordered_map<QUuid, VerifiedHeartbeat> _verifiedHeartbeats;
+
+    QThreadPool _verificationThreadPool;
+    QSet<QUuid> _pendingVerifications;
+
+    int _numCachedVerifications { 0 };
+    int _numRSAVerifications { 0 };
+    int _numDeniedHeartbeats { 0 };
+    int _numDroppedHeartbeats { 0 };
 };
 
 #endif // hifi_IceServer_h
@@ -113,6 +113,11 @@ Item {
                         visible: root.expanded
                         text: "Avatars NOT Updated: " + root.notUpdatedAvatarCount
                     }
+                    StatText {
+                        visible: root.expanded
+                        text: "Avatars Animated (high/med/low): " + root.highLODAnimatedAvatarCount + " / " +
+                            root.mediumLODAnimatedAvatarCount + " / " + root.lowLODAnimatedAvatarCount
+                    }
                 }
             }
 
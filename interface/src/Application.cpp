@@ -106,6 +106,7 @@
 #include <PathUtils.h>
 #include <PerfStat.h>
 #include <PhysicsEngine.h>
+#include <CookedShapeCache.h>
 #include <PhysicsHelpers.h>
 #include <plugins/CodecPlugin.h>
 #include <plugins/PluginManager.h>
@@ -132,6 +133,7 @@
 #include <UsersScriptingInterface.h>
 #include <recording/ClipCache.h>
 #include <recording/Deck.h>
+#include <recording/Ensemble.h>
 #include <recording/Recorder.h>
 #include <shared/StringHelpers.h>
 #include <QmlWebWindowClass.h>
@@ -528,6 +530,7 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
     DependencyManager::set<ScriptEngines>(ScriptEngine::CLIENT_SCRIPT);
     DependencyManager::set<Preferences>();
     DependencyManager::set<recording::ClipCache>();
+    DependencyManager::set<recording::Ensemble>();
     DependencyManager::set<recording::Deck>();
     DependencyManager::set<recording::Recorder>();
     DependencyManager::set<AddressManager>();
@@ -773,6 +776,9 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
     });
     audioIO->startThread();
 
+    // the deck plays its clip on the thread of the ensemble
+    DependencyManager::get<recording::Ensemble>()->initialize();
+
     auto audioScriptingInterface = DependencyManager::set<AudioScriptingInterface, scripting::Audio>();
     connect(audioIO.data(), &AudioClient::mutedByMixer, audioScriptingInterface.data(), &AudioScriptingInterface::mutedByMixer);
     connect(audioIO.data(), &AudioClient::receivedFirstPacket, audioScriptingInterface.data(), &AudioScriptingInterface::receivedFirstPacket);
@@ -1479,6 +1485,13 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
             + bytesDownloaded["file"].toInt();
         properties["bytesDownloaded"] = bytesDownloaded;
 
+        QJsonObject ktxSupercompression;
+        ktxSupercompression["compressed_bytes"] = statTracker->getStat(STAT_KTX_SUPERCOMPRESSED_BYTES).toInt();
+        ktxSupercompression["decompressed_bytes"] = statTracker->getStat(STAT_KTX_DECOMPRESSED_BYTES).toInt();
+        ktxSupercompression["decompress_usecs"] = statTracker->getStat(STAT_KTX_DECOMPRESS_USECS).toInt();
+        ktxSupercompression["decompress_failures"] = statTracker->getStat(STAT_KTX_DECOMPRESS_FAILURES).toInt();
+        properties["ktx_supercompression"] = ktxSupercompression;
+
         auto myAvatar = getMyAvatar();
         glm::vec3 avatarPosition = myAvatar->getPosition();
         properties["avatar_has_moved"] = lastAvatarPosition != avatarPosition;
@@ -1895,6 +1908,7 @@ Application::~Application() {
     _physicsEngine->setCharacterController(nullptr);
 
     // the _shapeManager should have zero references
+    _shapeManager.waitForCookedShapes();
     _shapeManager.collectGarbage();
     assert(_shapeManager.getNumShapes() == 0);
 
@@ -1914,6 +1928,7 @@ Application::~Application() {
     _entityEditSender.terminate();
 
 
+    DependencyManager::destroy<recording::Ensemble>();
     DependencyManager::destroy<AvatarManager>();
     DependencyManager::destroy<AnimationCache>();
     DependencyManager::destroy<FramebufferCache>();
@@ -4260,6 +4275,9 @@ void Application::init() {
         return atan2(maxSize, distance);
     });
 
+    auto cookedShapeCache = std::make_shared<CookedShapeCache>();
+    cookedShapeCache->initialize();
+    _shapeManager.setCookedShapeCache(cookedShapeCache);
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
 
@@ -4890,6 +4908,7 @@ void Application::update(float deltaTime) {
         {
             PROFILE_RANGE_EX(simulation_physics, "StepSimulation", 0xffff8000, (uint64_t)getActiveDisplayPlugin()->presentCount());
             PerformanceTimer perfTimer("stepSimulation");
+            _physicsEngine->setParallelIslandSolving(Menu::getInstance()->isOptionChecked(MenuOption::PhysicsParallelIslands));
             getEntities()->getTree()->withWriteLock([&] {
                 _physicsEngine->stepSimulation();
             });
@@ -27,6 +27,7 @@
 #include <VrMenu.h>
 #include <ScriptEngines.h>
 #include <MenuItemProperties.h>
+#include <model-networking/CookedGeometryCache.h>
 
 #include "Application.h"
 #include "AccountManager.h"
@@ -436,6 +437,14 @@ Menu::Menu() {
         });
     }
 
+    {
+        auto action = addActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::RenderClearCookedGeometryCache);
+        connect(action, &QAction::triggered, []{
+            Setting::Handle<int>(CookedGeometryCache::SETTING_VERSION_NAME, CookedGeometryCache::INVALID_VERSION)
+                .set(CookedGeometryCache::INVALID_VERSION);
+        });
+    }
+
     // Developer > Render > LOD Tools
     addActionToQMenuAndActionHash(renderOptionsMenu, MenuOption::LodTools, 0,
                                   qApp, SLOT(loadLODToolsDialog()));
@@ -587,6 +596,8 @@ Menu::Menu() {
     addActionToQMenuAndActionHash(networkMenu, MenuOption::ReloadContent, 0, qApp, SLOT(reloadResourceCaches()));
     addActionToQMenuAndActionHash(networkMenu, MenuOption::ClearDiskCache, 0,
         DependencyManager::get<AssetClient>().data(), SLOT(clearCache()));
+    addCheckableActionToQMenuAndActionHash(networkMenu, MenuOption::PeerAssistedAssetDownloads, 0, false,
+        DependencyManager::get<AssetClient>().data(), SLOT(setPeerAssistEnabled(bool)));
     addCheckableActionToQMenuAndActionHash(networkMenu,
         MenuOption::DisableActivityLogger,
         0,
@@ -685,6 +696,7 @@ Menu::Menu() {
             0, false, drawStatusConfig, SLOT(setShowNetwork(bool)));
     }
     addCheckableActionToQMenuAndActionHash(physicsOptionsMenu, MenuOption::PhysicsShowHulls);
+    addCheckableActionToQMenuAndActionHash(physicsOptionsMenu, MenuOption::PhysicsParallelIslands, 0, false);
 
     // Developer > Ask to Reset Settings
     addCheckableActionToQMenuAndActionHash(developerMenu, MenuOption::AskToResetSettings, 0, false);
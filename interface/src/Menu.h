@@ -136,6 +136,8 @@ namespace MenuOption {
     const QString Overlays = "Overlays";
     const QString PackageModel = "Package Model...";
     const QString Pair = "Pair";
+    const QString PeerAssistedAssetDownloads = "Peer-Assisted Asset Downloads";
+    const QString PhysicsParallelIslands = "Solve Islands in Parallel";
     const QString PhysicsShowHulls = "Draw Collision Shapes";
     const QString PhysicsShowOwned = "Highlight Simulation Ownership";
     const QString PipelineWarnings = "Log Render Pipeline Warnings";
@@ -144,6 +146,7 @@ namespace MenuOption {
     const QString ReloadAllScripts = "Reload All Scripts";
     const QString ReloadContent = "Reload Content (Clears all caches)";
     const QString RenderClearKtxCache = "Clear KTX Cache (requires restart)";
+    const QString RenderClearCookedGeometryCache = "Clear Cooked Geometry Cache (requires restart)";
     const QString RenderMaxTextureMemory = "Maximum Texture Memory";
     const QString RenderMaxTextureAutomatic = "Automatic Texture Memory";
     const QString RenderMaxTexture4MB = "4 MB";
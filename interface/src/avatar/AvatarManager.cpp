@@ -28,14 +28,17 @@
 #include <shared/QtHelpers.h>
 #include <AvatarData.h>
 #include <PerfStat.h>
+#include <Profile.h>
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
 #include <SettingHandle.h>
+#include <TBBHelpers.h>
 #include <UsersScriptingInterface.h>
 #include <UUID.h>
 #include <avatars-renderer/OtherAvatar.h>
 
 #include "Application.h"
+#include "LODManager.h"
 #include "AvatarManager.h"
 #include "InterfaceLogging.h"
 #include "Menu.h"
@@ -132,6 +135,59 @@ float AvatarManager::getAvatarSimulationRate(const QUuid& sessionID, const QStri
     return avatar ? avatar->getSimulationRate(rateName) : 0.0f;
 }
 
+// Avatars in view get less animation detail the smaller they are on screen, and past the first few by priority.  The
+// sizes are scaled by the LOD manager's octree size scale, so when it lowers the detail to keep the frame rate up
+// avatars drop to lower animation LODs closer in.
+static const int MAX_HIGH_ANIMATION_LOD_AVATARS = 20;
+static const float HIGH_ANIMATION_LOD_MIN_APPARENT_SIZE = 0.1f; // an avatar about 20m away
+static const float MEDIUM_ANIMATION_LOD_MIN_APPARENT_SIZE = 0.025f;
+
+AnimationLOD AvatarManager::computeAnimationLOD(const Avatar& avatar, const glm::vec3& cameraPosition,
+                                                int priorityRank, float lodScale) const {
+    float distance = glm::distance(avatar.getPosition(), cameraPosition) + 0.001f; // add 1mm to avoid divide by zero
+    float apparentSize = lodScale * 2.0f * avatar.getBoundingRadius() / distance;
+    if (apparentSize >= HIGH_ANIMATION_LOD_MIN_APPARENT_SIZE && priorityRank < MAX_HIGH_ANIMATION_LOD_AVATARS) {
+        return AnimationLOD::High;
+    } else if (apparentSize >= MEDIUM_ANIMATION_LOD_MIN_APPARENT_SIZE) {
+        return AnimationLOD::Medium;
+    }
+    return AnimationLOD::Low;
+}
+
+void AvatarManager::computeJointPoses(const std::priority_queue<AvatarPriority>& sortedAvatars, float inViewThreshold,
+                                      const glm::vec3& cameraPosition, float deltaTime) {
+    float lodScale = DependencyManager::get<LODManager>()->getOctreeSizeScale() / DEFAULT_OCTREE_SIZE_SCALE;
+    uint64_t now = usecTimestampNow();
+
+    // the in-view avatars that need posing, in the order they will be simulated
+    _avatarsToPose.clear();
+    std::priority_queue<AvatarPriority> avatars = sortedAvatars;
+    int priorityRank = 0;
+    while (!avatars.empty() && avatars.top().priority > inViewThreshold) {
+        const auto& avatar = std::static_pointer_cast<Avatar>(avatars.top().avatar);
+        avatar->setAnimationLOD(computeAnimationLOD(*avatar, cameraPosition, priorityRank++, lodScale));
+        if (avatar->needsJointPoses(now)) {
+            _avatarsToPose.push_back(avatar.get());
+        }
+        avatars.pop();
+    }
+
+    // the timers aren't thread safe, so while they are on the avatars are left for simulate() to pose one by one
+    if (_avatarsToPose.size() < 2 || PerformanceTimer::isActive()) {
+        _avatarsToPose.clear();
+        return;
+    }
+
+    PROFILE_RANGE(simulation, "computeJointPoses");
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _avatarsToPose.size(), 1),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                _avatarsToPose[i]->computeJointPoses(now, deltaTime);
+            }
+        });
+    _avatarsToPose.clear();
+}
+
 void AvatarManager::updateOtherAvatars(float deltaTime) {
     // lock the hash for read to check the size
     QReadLocker lock(&_hashLock);
@@ -168,11 +224,15 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             return false;
         });
 
+    const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
+    computeJointPoses(sortedAvatars, OUT_OF_VIEW_THRESHOLD, cameraView.getPosition(), deltaTime);
+
     uint64_t startTime = usecTimestampNow();
     const uint64_t UPDATE_BUDGET = 2000; // usec
     uint64_t updateExpiry = startTime + UPDATE_BUDGET;
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
+    std::array<int, (int)AnimationLOD::NumLODs> numAvatarsAnimated {};
 
     render::Transaction transaction;
     while (!sortedAvatars.empty()) {
@@ -197,7 +257,6 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         }
         avatar->animateScaleChanges(deltaTime);
 
-        const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
         uint64_t now = usecTimestampNow();
         if (now < updateExpiry) {
             // we're within budget
@@ -205,6 +264,9 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             if (inView && avatar->hasNewJointData()) {
                 numAvatarsUpdated++;
             }
+            if (inView && avatar->needsJointPoses(now)) {
+                numAvatarsAnimated[(int)avatar->getAnimationLOD()]++;
+            }
             avatar->simulate(deltaTime, inView);
             avatar->updateRenderItem(transaction);
             avatar->setLastRenderUpdateTime(startTime);
@@ -255,6 +317,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     _avatarSimulationTime = (float)(usecTimestampNow() - startTime) / (float)USECS_PER_MSEC;
     _numAvatarsUpdated = numAvatarsUpdated;
     _numAvatarsNotUpdated = numAVatarsNotUpdated;
+    _numAvatarsAnimated = numAvatarsAnimated;
 
     simulateAvatarFades(deltaTime);
 }
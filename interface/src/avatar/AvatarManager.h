@@ -12,6 +12,8 @@
 #ifndef hifi_AvatarManager_h
 #define hifi_AvatarManager_h
 
+#include <array>
+
 #include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
@@ -50,6 +52,8 @@ public:
 
     int getNumAvatarsUpdated() const { return _numAvatarsUpdated; }
     int getNumAvatarsNotUpdated() const { return _numAvatarsNotUpdated; }
+    // the avatars posed at an animation LOD in the last update
+    int getNumAvatarsAnimated(AnimationLOD lod) const { return _numAvatarsAnimated[(int)lod]; }
     float getAvatarSimulationTime() const { return _avatarSimulationTime; }
 
     void updateMyAvatar(float deltaTime);
@@ -88,6 +92,12 @@ private:
     explicit AvatarManager(const AvatarManager& other);
 
     void simulateAvatarFades(float deltaTime);
+    AnimationLOD computeAnimationLOD(const Avatar& avatar, const glm::vec3& cameraPosition, int priorityRank,
+                                     float lodScale) const;
+    // picks the animation LODs of the avatars in view, then poses the ones that need it across the task pool ahead of
+    // simulating them one by one
+    void computeJointPoses(const std::priority_queue<AvatarPriority>& sortedAvatars, float inViewThreshold,
+                           const glm::vec3& cameraPosition, float deltaTime);
 
     AvatarSharedPointer newSharedAvatar() override;
     void deleteMotionStates();
@@ -105,10 +115,12 @@ private:
     quint64 _lastSendAvatarDataTime = 0; // Controls MyAvatar send data rate.
 
     std::list<AudioInjectorPointer> _collisionInjectors;
+    std::vector<Avatar*> _avatarsToPose; // scratch for computeJointPoses()
 
     RateCounter<> _myAvatarSendRate;
     int _numAvatarsUpdated { 0 };
     int _numAvatarsNotUpdated { 0 };
+    std::array<int, (int)AnimationLOD::NumLODs> _numAvatarsAnimated {{}};
     float _avatarSimulationTime { 0.0f };
     bool _shouldRender { true };
 };
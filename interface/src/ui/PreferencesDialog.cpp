@@ -357,6 +357,12 @@ void setupPreferences() {
             auto preference = new CheckPreference(RENDER, "Compress Cube Textures", getter, setter);
             preferences->addPreference(preference);
         }
+        {
+            auto getter = []()->bool { return image::isNativeTextureProcessingEnabled(); };
+            auto setter = [](bool value) { return image::setNativeTextureProcessingEnabled(value); };
+            auto preference = new CheckPreference(RENDER, "Fast Texture Processing", getter, setter);
+            preferences->addPreference(preference);
+        }
     }
     {
         static const QString RENDER("Networking");
@@ -128,6 +128,9 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE(avatarCount, avatarManager->size() - 1);
     STAT_UPDATE(updatedAvatarCount, avatarManager->getNumAvatarsUpdated());
     STAT_UPDATE(notUpdatedAvatarCount, avatarManager->getNumAvatarsNotUpdated());
+    STAT_UPDATE(highLODAnimatedAvatarCount, avatarManager->getNumAvatarsAnimated(AnimationLOD::High));
+    STAT_UPDATE(mediumLODAnimatedAvatarCount, avatarManager->getNumAvatarsAnimated(AnimationLOD::Medium));
+    STAT_UPDATE(lowLODAnimatedAvatarCount, avatarManager->getNumAvatarsAnimated(AnimationLOD::Low));
     STAT_UPDATE(serverCount, (int)nodeList->size());
     STAT_UPDATE_FLOAT(framerate, qApp->getFps(), 0.1f);
     if (qApp->getActiveDisplayPlugin()) {
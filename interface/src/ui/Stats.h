@@ -52,6 +52,9 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, avatarCount, 0)
     STATS_PROPERTY(int, updatedAvatarCount, 0)
     STATS_PROPERTY(int, notUpdatedAvatarCount, 0)
+    STATS_PROPERTY(int, highLODAnimatedAvatarCount, 0)
+    STATS_PROPERTY(int, mediumLODAnimatedAvatarCount, 0)
+    STATS_PROPERTY(int, lowLODAnimatedAvatarCount, 0)
     STATS_PROPERTY(int, packetInCount, 0)
     STATS_PROPERTY(int, packetOutCount, 0)
     STATS_PROPERTY(float, mbpsIn, 0)
@@ -180,6 +183,9 @@ signals:
     void avatarCountChanged();
     void updatedAvatarCountChanged();
     void notUpdatedAvatarCountChanged();
+    void highLODAnimatedAvatarCountChanged();
+    void mediumLODAnimatedAvatarCountChanged();
+    void lowLODAnimatedAvatarCountChanged();
     void packetInCountChanged();
     void packetOutCountChanged();
     void mbpsInChanged();
@@ -19,3 +19,16 @@ AnimContext::AnimContext(bool enableDebugDrawIKTargets, bool enableDebugDrawIKCo
     _rigToWorldMatrix(rigToWorldMatrix)
 {
 }
+
+AnimPoseVec& AnimPoseArena::allocate(size_t numPoses) {
+    if (_numAllocated == _vectors.size()) {
+        _vectors.emplace_back();
+    }
+    AnimPoseVec& poses = _vectors[_numAllocated++];
+    poses.resize(numPoses);
+    return poses;
+}
+
+AnimPoseVec& AnimContext::allocatePoses(size_t numPoses) const {
+    return _poseArena ? _poseArena->allocate(numPoses) : _localPoseArena.allocate(numPoses);
+}
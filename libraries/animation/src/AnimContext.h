@@ -11,9 +11,28 @@
 #ifndef hifi_AnimContext_h
 #define hifi_AnimContext_h
 
+#include <deque>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "AnimPose.h"
+
+// Scratch pose vectors for one evaluation of an anim graph.  The vectors are handed out in order and all taken back by
+// reset() before the next evaluation, so once a graph has been evaluated a few times its nodes stop allocating.
+class AnimPoseArena {
+public:
+    // numPoses poses holding whatever was left in them, valid until reset()
+    AnimPoseVec& allocate(size_t numPoses);
+    void reset() { _numAllocated = 0; }
+
+    size_t getNumVectors() const { return _vectors.size(); }
+
+private:
+    std::deque<AnimPoseVec> _vectors; // a deque so that the vectors already handed out don't move
+    size_t _numAllocated { 0 };
+};
+
 class AnimContext {
 public:
     AnimContext(bool enableDebugDrawIKTargets, bool enableDebugDrawIKConstraints, bool enableDebugDrawIKChains,
@@ -25,6 +44,12 @@ public:
     const glm::mat4& getGeometryToRigMatrix() const { return _geometryToRigMatrix; }
     const glm::mat4& getRigToWorldMatrix() const { return _rigToWorldMatrix; }
 
+    // the arena is kept by the owner of the graph from one evaluation to the next
+    void setPoseArena(AnimPoseArena* poseArena) { _poseArena = poseArena; }
+
+    // scratch poses for a node, valid for the rest of the evaluation
+    AnimPoseVec& allocatePoses(size_t numPoses) const;
+
 protected:
 
     bool _enableDebugDrawIKTargets { false };
@@ -32,6 +57,8 @@ protected:
     bool _enableDebugDrawIKChains { false };
     glm::mat4 _geometryToRigMatrix;
     glm::mat4 _rigToWorldMatrix;
+    AnimPoseArena* _poseArena { nullptr };
+    mutable AnimPoseArena _localPoseArena; // when there is no arena, only lasts as long as the context
 };
 
 #endif  // hifi_AnimContext_h
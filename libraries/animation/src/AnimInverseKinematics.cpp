@@ -208,8 +208,7 @@ void AnimInverseKinematics::computeTargets(const AnimVariantMap& animVars, std::
 
 void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<IKTarget>& targets, float dt, JointChainInfoVec& jointChainInfoVec) {
     // compute absolute poses that correspond to relative target poses
-    AnimPoseVec absolutePoses;
-    absolutePoses.resize(_relativePoses.size());
+    AnimPoseVec& absolutePoses = context.allocatePoses(_relativePoses.size());
     computeAbsolutePoses(absolutePoses);
 
     // clear the accumulators before we start the IK solver
@@ -54,13 +54,32 @@ glm::vec3 AnimPose::xformVectorFast(const glm::vec3& rhs) const {
     return _rot * (_scale * rhs);
 }
 
+// With a uniform scale the scale commutes with any rotation, so products and inverses are poses that can be computed
+// from the parts without going through a matrix.  Skeletons almost always have uniform scales.
+static const float UNIFORM_SCALE_EPSILON = 1.0e-5f;
+
+static bool isUniformPositiveScale(const glm::vec3& scale) {
+    return scale.x > 0.0f &&
+        fabsf(scale.y - scale.x) <= UNIFORM_SCALE_EPSILON * scale.x &&
+        fabsf(scale.z - scale.x) <= UNIFORM_SCALE_EPSILON * scale.x;
+}
+
 AnimPose AnimPose::operator*(const AnimPose& rhs) const {
+    if (isUniformPositiveScale(_scale) && rhs._scale.x > 0.0f && rhs._scale.y > 0.0f && rhs._scale.z > 0.0f) {
+        float scale = _scale.x;
+        return AnimPose(scale * rhs._scale, _rot * rhs._rot, _trans + _rot * (scale * rhs._trans));
+    }
     glm::mat4 result;
     glm_mat4u_mul(*this, rhs, result);
     return AnimPose(result);
 }
 
 AnimPose AnimPose::inverse() const {
+    if (isUniformPositiveScale(_scale)) {
+        float invScale = 1.0f / _scale.x;
+        glm::quat invRot = glm::conjugate(_rot);
+        return AnimPose(glm::vec3(invScale), invRot, invRot * (-invScale * _trans));
+    }
     return AnimPose(glm::inverse(static_cast<glm::mat4>(*this)));
 }
 
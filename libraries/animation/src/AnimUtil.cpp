@@ -11,25 +11,103 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define ANIM_UTIL_SSE
+#include <emmintrin.h>
+#endif
 
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
-    for (size_t i = 0; i < numPoses; i++) {
-        const AnimPose& aPose = a[i];
-        const AnimPose& bPose = b[i];
-
-        // adjust signs if necessary
-        const glm::quat& q1 = aPose.rot();
-        glm::quat q2 = bPose.rot();
-        float dot = glm::dot(q1, q2);
-        if (dot < 0.0f) {
-            q2 = -q2;
-        }
+static void blendPose(const AnimPose& aPose, const AnimPose& bPose, float alpha, AnimPose& result) {
+    result.scale() = lerp(aPose.scale(), bPose.scale(), alpha);
+    result.rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
+    result.trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+}
+
+#ifdef ANIM_UTIL_SSE
+
+// An AnimPose is ten floats: scale xyz, rot xyzw, trans xyz.
+static const int POSE_FLOATS = 10;
+static const int POSE_SCALE = 0;
+static const int POSE_ROT = 3;
+static const int POSE_ROT_W = 6;
+static_assert(sizeof(AnimPose) == POSE_FLOATS * sizeof(float), "blend4 expects AnimPose to be ten packed floats");
+
+// Blends four poses at once.  The scale and translation of each pose are lerped in place, four floats at a time, and
+// the rotations are transposed so that each register holds one component of four quaternions.  All of the inputs are
+// loaded before any of the results are stored, so result may be a or b.
+static void blend4(const AnimPose* a, const AnimPose* b, __m128 alpha, AnimPose* result) {
+    const float* aFloats = reinterpret_cast<const float*>(a);
+    const float* bFloats = reinterpret_cast<const float*>(b);
+    float* resultFloats = reinterpret_cast<float*>(result);
+
+    // scale xyz + rot x, and rot w + trans xyz, the rot components are overwritten below
+    __m128 scales[4];
+    __m128 translations[4];
+    for (int i = 0; i < 4; i++) {
+        const float* aPose = aFloats + i * POSE_FLOATS;
+        const float* bPose = bFloats + i * POSE_FLOATS;
+        __m128 aScale = _mm_loadu_ps(aPose + POSE_SCALE);
+        __m128 aTrans = _mm_loadu_ps(aPose + POSE_ROT_W);
+        scales[i] = _mm_add_ps(aScale, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bPose + POSE_SCALE), aScale), alpha));
+        translations[i] = _mm_add_ps(aTrans, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bPose + POSE_ROT_W), aTrans), alpha));
+    }
+
+    __m128 ax = _mm_loadu_ps(aFloats + POSE_ROT);
+    __m128 ay = _mm_loadu_ps(aFloats + POSE_FLOATS + POSE_ROT);
+    __m128 az = _mm_loadu_ps(aFloats + 2 * POSE_FLOATS + POSE_ROT);
+    __m128 aw = _mm_loadu_ps(aFloats + 3 * POSE_FLOATS + POSE_ROT);
+    _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+    __m128 bx = _mm_loadu_ps(bFloats + POSE_ROT);
+    __m128 by = _mm_loadu_ps(bFloats + POSE_FLOATS + POSE_ROT);
+    __m128 bz = _mm_loadu_ps(bFloats + 2 * POSE_FLOATS + POSE_ROT);
+    __m128 bw = _mm_loadu_ps(bFloats + 3 * POSE_FLOATS + POSE_ROT);
+    _MM_TRANSPOSE4_PS(bx, by, bz, bw);
 
-        result[i].scale() = lerp(aPose.scale(), bPose.scale(), alpha);
-        result[i].rot() = safeLerp(aPose.rot(), bPose.rot(), alpha);
-        result[i].trans() = lerp(aPose.trans(), bPose.trans(), alpha);
+    // adjust signs if necessary, as safeLerp() does
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                            _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+    bx = _mm_xor_ps(bx, sign);
+    by = _mm_xor_ps(by, sign);
+    bz = _mm_xor_ps(bz, sign);
+    bw = _mm_xor_ps(bw, sign);
+
+    __m128 x = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), alpha));
+    __m128 y = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), alpha));
+    __m128 z = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), alpha));
+    __m128 w = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), alpha));
+
+    // normalize, a zero quaternion becomes the identity as it does with glm::normalize()
+    __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                      _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+    __m128 isZero = _mm_cmple_ps(lengthSquared, _mm_setzero_ps());
+    __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+    x = _mm_andnot_ps(isZero, _mm_mul_ps(x, invLength));
+    y = _mm_andnot_ps(isZero, _mm_mul_ps(y, invLength));
+    z = _mm_andnot_ps(isZero, _mm_mul_ps(z, invLength));
+    w = _mm_or_ps(_mm_andnot_ps(isZero, _mm_mul_ps(w, invLength)), _mm_and_ps(isZero, _mm_set1_ps(1.0f)));
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    __m128 rotations[4] = { x, y, z, w };
+
+    for (int i = 0; i < 4; i++) {
+        float* resultPose = resultFloats + i * POSE_FLOATS;
+        _mm_storeu_ps(resultPose + POSE_SCALE, scales[i]);
+        _mm_storeu_ps(resultPose + POSE_ROT_W, translations[i]);
+        _mm_storeu_ps(resultPose + POSE_ROT, rotations[i]);
+    }
+}
+
+#endif
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    size_t i = 0;
+#ifdef ANIM_UTIL_SSE
+    __m128 alpha4 = _mm_set1_ps(alpha);
+    for (; i + 4 <= numPoses; i += 4) {
+        blend4(a + i, b + i, alpha4, result + i);
+    }
+#endif
+    for (; i < numPoses; i++) {
+        blendPose(a[i], b[i], alpha, result[i]);
     }
 }
 
@@ -193,6 +193,8 @@ void Rig::initJointStates(const FBXGeometry& geometry, const glm::mat4& modelOff
     _rightHandJointIndex = geometry.rightHandJointIndex;
     _rightElbowJointIndex = _rightHandJointIndex >= 0 ? geometry.joints.at(_rightHandJointIndex).parentIndex : -1;
     _rightShoulderJointIndex = _rightElbowJointIndex >= 0 ? geometry.joints.at(_rightElbowJointIndex).parentIndex : -1;
+
+    buildReducedJointSet(geometry);
 }
 
 void Rig::reset(const FBXGeometry& geometry) {
@@ -222,6 +224,8 @@ void Rig::reset(const FBXGeometry& geometry) {
     _rightElbowJointIndex = _rightHandJointIndex >= 0 ? geometry.joints.at(_rightHandJointIndex).parentIndex : -1;
     _rightShoulderJointIndex = _rightElbowJointIndex >= 0 ? geometry.joints.at(_rightElbowJointIndex).parentIndex : -1;
 
+    buildReducedJointSet(geometry);
+
     if (!_animGraphURL.isEmpty()) {
         initAnimGraph(_animGraphURL);
     }
@@ -975,6 +979,8 @@ void Rig::updateAnimations(float deltaTime, const glm::mat4& rootTransform, cons
 
         AnimContext context(_enableDebugDrawIKTargets, _enableDebugDrawIKConstraints, _enableDebugDrawIKChains,
                             getGeometryToRigTransform(), rigToWorldTransform);
+        _poseArena.reset();
+        context.setPoseArena(&_poseArena);
 
         // evaluate the animation
         AnimNode::Triggers triggersOut;
@@ -1574,7 +1580,7 @@ void Rig::copyJointsIntoJointData(QVector<JointData>& jointDataVec) const {
     }
 }
 
-void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
+void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec, bool reducedJointSet, float blendDuration) {
     PerformanceTimer perfTimer("copyJoints");
     PROFILE_RANGE(simulation_animation_detail, "copyJoints");
     if (!_animSkeleton) {
@@ -1586,6 +1592,20 @@ void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
         // jointData is incompatible
         return;
     }
+    if (numJoints != (int)_internalPoseSet._relativePoses.size()) {
+        _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
+        reducedJointSet = false;
+        blendDuration = 0.0f;
+    }
+    if (numJoints != (int)_reducedJointSet.size()) {
+        reducedJointSet = false;
+    }
+
+    // blend from wherever the joints are now, which may be part way through the previous blend
+    if (blendDuration > 0.0f) {
+        _jointBlendStartPoses = _internalPoseSet._relativePoses;
+    }
+    _jointBlendDuration = 0.0f;
 
     // make a vector of rotations in absolute-geometry-frame
     std::vector<glm::quat> rotations;
@@ -1605,11 +1625,11 @@ void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
     _animSkeleton->convertAbsoluteRotationsToRelative(rotations);
 
     // store new relative poses
-    if (numJoints != (int)_internalPoseSet._relativePoses.size()) {
-        _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
-    }
     const AnimPoseVec& relativeDefaultPoses = _animSkeleton->getRelativeDefaultPoses();
     for (int i = 0; i < numJoints; i++) {
+        if (reducedJointSet && !_reducedJointSet[i]) {
+            continue;
+        }
         const JointData& data = jointDataVec.at(i);
         _internalPoseSet._relativePoses[i].scale() = Vectors::ONE;
         _internalPoseSet._relativePoses[i].rot() = rotations[i];
@@ -1620,6 +1640,28 @@ void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
             _internalPoseSet._relativePoses[i].trans() = relativeDefaultPoses[i].trans();
         }
     }
+
+    if (blendDuration > 0.0f) {
+        _jointBlendTargetPoses.swap(_internalPoseSet._relativePoses);
+        _internalPoseSet._relativePoses = _jointBlendStartPoses;
+        _jointBlendTime = 0.0f;
+        _jointBlendDuration = blendDuration;
+    }
+}
+
+void Rig::blendJoints(float deltaTime) {
+    if (_jointBlendDuration <= 0.0f) {
+        return;
+    }
+    _jointBlendTime += deltaTime;
+    if (_jointBlendTime >= _jointBlendDuration) {
+        _internalPoseSet._relativePoses.swap(_jointBlendTargetPoses);
+        _jointBlendDuration = 0.0f;
+        return;
+    }
+    float alpha = _jointBlendTime / _jointBlendDuration;
+    ::blend(_internalPoseSet._relativePoses.size(), &_jointBlendStartPoses[0], &_jointBlendTargetPoses[0], alpha,
+            &_internalPoseSet._relativePoses[0]);
 }
 
 void Rig::computeExternalPoses(const glm::mat4& modelOffsetMat) {
@@ -1632,6 +1674,20 @@ void Rig::computeExternalPoses(const glm::mat4& modelOffsetMat) {
     _externalPoseSet = _internalPoseSet;
 }
 
+void Rig::buildReducedJointSet(const FBXGeometry& geometry) {
+    // everything but the fingers and whatever else hangs off the hands, which is most of the joints of a typical avatar
+    int numJoints = (int)geometry.joints.size();
+    _reducedJointSet.assign(numJoints, true);
+    for (int i = 0; i < numJoints; i++) {
+        int parentIndex = geometry.joints[i].parentIndex;
+        if (parentIndex >= 0 && parentIndex < i) {
+            bool parentIsHand = parentIndex == geometry.leftHandJointIndex || parentIndex == geometry.rightHandJointIndex;
+            _reducedJointSet[i] = _reducedJointSet[parentIndex] && !parentIsHand;
+        }
+    }
+    _jointBlendDuration = 0.0f;
+}
+
 void Rig::computeAvatarBoundingCapsule(
         const FBXGeometry& geometry,
         float& radiusOut,
@@ -203,7 +203,12 @@ public:
     bool getRelativeDefaultJointTranslation(int index, glm::vec3& translationOut) const;
 
     void copyJointsIntoJointData(QVector<JointData>& jointDataVec) const;
-    void copyJointsFromJointData(const QVector<JointData>& jointDataVec);
+    // With reducedJointSet the joints beyond the hands hold their poses, and with a blendDuration the relative poses go
+    // from what they were to the new ones over that many seconds of blendJoints(), for avatars posed at reduced detail.
+    void copyJointsFromJointData(const QVector<JointData>& jointDataVec, bool reducedJointSet = false,
+                                 float blendDuration = 0.0f);
+    bool isBlendingJoints() const { return _jointBlendDuration > 0.0f; }
+    void blendJoints(float deltaTime);
     void computeExternalPoses(const glm::mat4& modelOffsetMat);
 
     void computeAvatarBoundingCapsule(const FBXGeometry& geometry, float& radiusOut, float& heightOut, glm::vec3& offsetOut) const;
@@ -228,6 +233,7 @@ protected:
     void updateAnimationStateHandlers();
     void applyOverridePoses();
     void buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut);
+    void buildReducedJointSet(const FBXGeometry& geometry);
 
     void updateHead(bool headEnabled, bool hipsEnabled, const AnimPose& headMatrix);
     void updateHands(bool leftHandEnabled, bool rightHandEnabled, bool hipsEnabled, bool leftArmEnabled, bool rightArmEnabled, float dt,
@@ -259,6 +265,12 @@ protected:
     PoseSet _externalPoseSet;
     mutable QReadWriteLock _externalPoseSetLock;
 
+    std::vector<bool> _reducedJointSet; // the joints copied from joint data at reduced detail
+    AnimPoseVec _jointBlendStartPoses;
+    AnimPoseVec _jointBlendTargetPoses;
+    float _jointBlendTime { 0.0f };
+    float _jointBlendDuration { 0.0f };
+
     AnimPoseVec _absoluteDefaultPoses; // rig space, not relative to parent.
 
     glm::mat4 _geometryToRigTransform;
@@ -283,6 +295,7 @@ protected:
     std::shared_ptr<AnimSkeleton> _animSkeleton;
     std::unique_ptr<AnimNodeLoader> _animLoader;
     AnimVariantMap _animVars;
+    AnimPoseArena _poseArena; // scratch poses for the anim graph, reused by every evaluation
     enum class RigRole {
         Idle = 0,
         Turn,
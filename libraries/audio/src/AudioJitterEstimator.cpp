@@ -0,0 +1,92 @@
+//
+//  AudioJitterEstimator.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioJitterEstimator.h"
+
+#include <algorithm>
+#include <cassert>
+
+// the percentile is recomputed on every this many queries, once the window has at least as many packets
+static const int PERCENTILE_UPDATE_INTERVAL = 25;
+
+AudioJitterEstimator::AudioJitterEstimator(int windowPackets, float percentile, int frameUsecs) :
+    _delays(windowPackets),
+    _percentile(percentile),
+    _frameUsecs(frameUsecs)
+{
+    assert(windowPackets > 0);
+    assert(percentile > 0.0f && percentile <= 1.0f);
+    _scratch.reserve(windowPackets);
+}
+
+void AudioJitterEstimator::reset() {
+    _nextDelay = 0;
+    _numDelays = 0;
+    _hasSequence = false;
+    _lastSequence = 0;
+    _sequenceIndex = 0;
+    _firstArrivalUsecs = 0;
+    _queriesSinceUpdate = 0;
+    _percentileDelayUsecs = 0;
+}
+
+void AudioJitterEstimator::packetReceived(uint16_t sequence, uint64_t arrivalUsecs) {
+    int64_t packetIndex = 0;
+
+    if (!_hasSequence) {
+        _hasSequence = true;
+        _lastSequence = sequence;
+        _sequenceIndex = 0;
+        _firstArrivalUsecs = arrivalUsecs;
+    } else {
+        // unwrap the sequence number, late packets have a negative difference
+        int16_t sequenceDiff = (int16_t)(sequence - _lastSequence);
+        if (sequenceDiff > 0) {
+            _lastSequence = sequence;
+            _sequenceIndex += sequenceDiff;
+            packetIndex = _sequenceIndex;
+        } else {
+            packetIndex = _sequenceIndex + sequenceDiff;
+        }
+    }
+
+    // the delay is relative to the first packet, only the spread of delays in the window matters
+    int64_t delay = (int64_t)(arrivalUsecs - _firstArrivalUsecs) - packetIndex * _frameUsecs;
+
+    _delays[_nextDelay] = delay;
+    _nextDelay = (_nextDelay + 1) % (int)_delays.size();
+    _numDelays = std::min(_numDelays + 1, (int)_delays.size());
+}
+
+int AudioJitterEstimator::getPercentileDelayUsecs() {
+    if (_numDelays == 0) {
+        return 0;
+    }
+
+    if (_queriesSinceUpdate++ % PERCENTILE_UPDATE_INTERVAL != 0 && _numDelays >= PERCENTILE_UPDATE_INTERVAL) {
+        return _percentileDelayUsecs;
+    }
+
+    _scratch.assign(_delays.begin(), _delays.begin() + _numDelays);
+
+    int64_t fastest = *std::min_element(_scratch.begin(), _scratch.end());
+
+    int percentileIndex = std::min((int)(_percentile * _numDelays), _numDelays - 1);
+    std::nth_element(_scratch.begin(), _scratch.begin() + percentileIndex, _scratch.end());
+
+    _percentileDelayUsecs = (int)(_scratch[percentileIndex] - fastest);
+    return _percentileDelayUsecs;
+}
+
+int AudioJitterEstimator::getTargetFrames() {
+    // one frame to cover the granularity of reading the buffer, plus enough to cover the delay spread
+    int delayUsecs = getPercentileDelayUsecs();
+    return 1 + (delayUsecs + _frameUsecs - 1) / _frameUsecs;
+}
@@ -0,0 +1,58 @@
+//
+//  AudioJitterEstimator.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioJitterEstimator_h
+#define hifi_AudioJitterEstimator_h
+
+#include <stdint.h>
+#include <vector>
+
+// Estimates how deep a jitter buffer has to be from the arrival times of recent packets.
+//
+// Each packet's delay is measured relative to when it should have arrived given its sequence number, and the
+// jitter buffer target is the chosen percentile of those delays (over the fastest packet in the window),
+// so a single late packet doesn't inflate the latency for everyone and clock drift is tracked for free.
+class AudioJitterEstimator {
+public:
+    AudioJitterEstimator(int windowPackets, float percentile, int frameUsecs);
+
+    void reset();
+
+    // record the arrival of a packet, including late and out of order ones
+    void packetReceived(uint16_t sequence, uint64_t arrivalUsecs);
+
+    // the delay (in usecs) that the chosen percentile of packets arrive within
+    int getPercentileDelayUsecs();
+
+    // the number of frames a jitter buffer needs to hold to play the chosen percentile of packets without starving
+    int getTargetFrames();
+
+    int getNumSamples() const { return _numDelays; }
+
+private:
+    std::vector<int64_t> _delays;
+    int _nextDelay { 0 };
+    int _numDelays { 0 };
+
+    float _percentile;
+    int _frameUsecs;
+
+    bool _hasSequence { false };
+    uint16_t _lastSequence { 0 };
+    int64_t _sequenceIndex { 0 };
+    uint64_t _firstArrivalUsecs { 0 };
+
+    // the percentile is only recomputed every so often, sorting the window per packet isn't worth it
+    int _queriesSinceUpdate { 0 };
+    int _percentileDelayUsecs { 0 };
+    std::vector<int64_t> _scratch;
+};
+
+#endif // hifi_AudioJitterEstimator_h
@@ -0,0 +1,188 @@
+//
+//  AudioLossConcealment.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioLossConcealment.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "InboundAudioStream.h"
+
+// frames of received audio kept around to search for a pitch period in
+static const int HISTORY_FRAMES = 3;
+
+AudioLossConcealment::AudioLossConcealment(int numChannels, int frameSamplesPerChannel) :
+    _numChannels(numChannels),
+    _frameSamplesPerChannel(frameSamplesPerChannel),
+    _history(HISTORY_FRAMES * frameSamplesPerChannel * numChannels, 0),
+    _crossfade(frameSamplesPerChannel * numChannels, 0)
+{
+    assert(numChannels > 0);
+}
+
+void AudioLossConcealment::reset() {
+    std::fill(_history.begin(), _history.end(), 0);
+    _historyFrames = 0;
+    _consecutiveLostFrames = 0;
+    _pitchPeriod = 0;
+    _concealmentPosition = 0;
+    _concealmentGain = 1.0f;
+}
+
+void AudioLossConcealment::frameReceived(int16_t* samples) {
+    int frameSamples = _frameSamplesPerChannel * _numChannels;
+
+    if (_consecutiveLostFrames > 0) {
+        // cross-fade from where the concealment would have continued into the audio we actually received
+        int crossfadeFrames = _frameSamplesPerChannel / 4;
+        renderConcealment(_crossfade.data(), crossfadeFrames, _concealmentGain, _concealmentGain, false);
+
+        for (int i = 0; i < crossfadeFrames; i++) {
+            float fade = (float)(i + 1) / (crossfadeFrames + 1);
+            for (int ch = 0; ch < _numChannels; ch++) {
+                int index = i * _numChannels + ch;
+                samples[index] = (int16_t)lrintf(_crossfade[index] + fade * (samples[index] - _crossfade[index]));
+            }
+        }
+
+        _consecutiveLostFrames = 0;
+    }
+
+    // shift the history and append this frame
+    std::memmove(_history.data(), _history.data() + frameSamples, (_history.size() - frameSamples) * sizeof(int16_t));
+    std::memcpy(_history.data() + _history.size() - frameSamples, samples, frameSamples * sizeof(int16_t));
+    _historyFrames = std::min(_historyFrames + 1, HISTORY_FRAMES);
+}
+
+void AudioLossConcealment::frameLost(int16_t* samples) {
+    int frameSamples = _frameSamplesPerChannel * _numChannels;
+
+    if (_historyFrames == 0) {
+        // nothing to conceal with yet
+        std::memset(samples, 0, frameSamples * sizeof(int16_t));
+        return;
+    }
+
+    if (_consecutiveLostFrames == 0) {
+        // this is the start of a loss, find what to repeat
+        _pitchPeriod = (_historyFrames == HISTORY_FRAMES) ? findPitchPeriod() : _frameSamplesPerChannel;
+        _concealmentPosition = 0;
+        _concealmentGain = 1.0f;
+    }
+
+    bool isStart = (_consecutiveLostFrames == 0);
+    ++_consecutiveLostFrames;
+
+    float endGain = calculateRepeatedFrameFadeFactor(_consecutiveLostFrames);
+    renderConcealment(samples, _frameSamplesPerChannel, _concealmentGain, endGain, isStart);
+
+    _concealmentPosition = (_concealmentPosition + _frameSamplesPerChannel) % _pitchPeriod;
+    _concealmentGain = endGain;
+}
+
+int AudioLossConcealment::findPitchPeriod() const {
+    // search for pitches between roughly 66Hz and 400Hz at 24kHz, scaled with the frame size
+    const int minPeriod = _frameSamplesPerChannel / 4;
+    const int maxPeriod = _frameSamplesPerChannel * 3 / 2;
+    const int window = _frameSamplesPerChannel / 2;
+
+    int historyLength = (int)_history.size() / _numChannels;
+    assert(maxPeriod + window <= historyLength);
+
+    // mix down to mono for the search
+    std::vector<float> mono(historyLength);
+    for (int i = 0; i < historyLength; i++) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < _numChannels; ch++) {
+            sum += _history[i * _numChannels + ch];
+        }
+        mono[i] = sum;
+    }
+
+    const float* reference = &mono[historyLength - window];
+    float referenceEnergy = 0.0f;
+    for (int i = 0; i < window; i++) {
+        referenceEnergy += reference[i] * reference[i];
+    }
+
+    int bestPeriod = _frameSamplesPerChannel;
+    float bestCorrelation = 0.0f;
+
+    if (referenceEnergy > 0.0f) {
+        for (int period = minPeriod; period <= maxPeriod; period++) {
+            const float* candidate = reference - period;
+
+            float correlation = 0.0f;
+            float energy = 0.0f;
+            for (int i = 0; i < window; i++) {
+                correlation += reference[i] * candidate[i];
+                energy += candidate[i] * candidate[i];
+            }
+
+            if (correlation > 0.0f && energy > 0.0f) {
+                float normalized = correlation / sqrtf(referenceEnergy * energy);
+                if (normalized > bestCorrelation) {
+                    bestCorrelation = normalized;
+                    bestPeriod = period;
+                }
+            }
+        }
+    }
+
+    // repeating a single short period sounds buzzy, so repeat as many whole periods as fit
+    while (bestPeriod * 2 <= maxPeriod) {
+        bestPeriod *= 2;
+    }
+
+    return bestPeriod;
+}
+
+void AudioLossConcealment::renderConcealment(int16_t* samples, int numFrames, float startGain, float endGain,
+                                             bool isStart) {
+    int historyLength = (int)_history.size() / _numChannels;
+    int periodStart = historyLength - _pitchPeriod;
+
+    // pitch periods aren't a whole number of samples, so overlap-add into the start of the period around each seam
+    int overlap = std::min(_frameSamplesPerChannel / 8, periodStart);
+
+    for (int i = 0; i < numFrames; i++) {
+        float gain = startGain + (endGain - startGain) * (float)i / numFrames;
+        int position = _concealmentPosition + i;
+        int source = periodStart + position % _pitchPeriod;
+
+        // how far into the overlap before the seam (where the period wraps back to its start) we are
+        int untilSeam = _pitchPeriod - position % _pitchPeriod;
+        float seamWeight = (untilSeam <= overlap) ? 1.0f - (float)untilSeam / (overlap + 1) : 0.0f;
+
+        // the very first samples after the received audio also sit on a seam, blend from the received audio's trend
+        float startWeight = (isStart && position < overlap) ? 1.0f - (float)(position + 1) / (overlap + 1) : 0.0f;
+
+        for (int ch = 0; ch < _numChannels; ch++) {
+            float value = _history[source * _numChannels + ch];
+
+            if (seamWeight > 0.0f) {
+                // the sample a period earlier leads smoothly into the start of the period
+                float beforeStart = _history[(source - _pitchPeriod) * _numChannels + ch];
+                value += seamWeight * (beforeStart - value);
+            }
+
+            if (startWeight > 0.0f) {
+                float last = _history[(historyLength - 1) * _numChannels + ch];
+                float slope = last - _history[(historyLength - 2) * _numChannels + ch];
+                float extrapolated = last + slope * (position + 1);
+                value += startWeight * (extrapolated - value);
+            }
+
+            samples[i * _numChannels + ch] = (int16_t)lrintf(std::max(std::min(gain * value, 32767.0f), -32768.0f));
+        }
+    }
+}
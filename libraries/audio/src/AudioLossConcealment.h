@@ -0,0 +1,55 @@
+//
+//  AudioLossConcealment.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioLossConcealment_h
+#define hifi_AudioLossConcealment_h
+
+#include <stdint.h>
+#include <vector>
+
+// Packet loss concealment for streams without a codec of their own that can interpolate lost frames.
+//
+// Lost frames are replaced by repeating the last pitch period of the audio that was received, faded out
+// with calculateRepeatedFrameFadeFactor() as more frames are lost in a row. The first frame received after
+// a loss is cross-faded from the concealment, so neither edge of the gap clicks.
+class AudioLossConcealment {
+public:
+    AudioLossConcealment(int numChannels, int frameSamplesPerChannel);
+
+    void reset();
+
+    // interleaved int16_t frames, modified in place when they follow a loss
+    void frameReceived(int16_t* samples);
+
+    // produces one frame of concealment audio
+    void frameLost(int16_t* samples);
+
+    int getConsecutiveLostFrames() const { return _consecutiveLostFrames; }
+
+private:
+    int findPitchPeriod() const;
+    void renderConcealment(int16_t* samples, int numFrames, float startGain, float endGain, bool isStart);
+
+    int _numChannels;
+    int _frameSamplesPerChannel;
+
+    // the most recently received audio, interleaved, oldest first
+    std::vector<int16_t> _history;
+    int _historyFrames { 0 };
+
+    int _consecutiveLostFrames { 0 };
+    int _pitchPeriod { 0 };
+    int _concealmentPosition { 0 };
+    float _concealmentGain { 1.0f };
+
+    std::vector<int16_t> _crossfade;
+};
+
+#endif // hifi_AudioLossConcealment_h
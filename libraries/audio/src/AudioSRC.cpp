@@ -1449,11 +1449,48 @@ AudioSRC::AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels, Q
 
     //printf("up=%d down=%.3f taps=%d\n", _upFactor, _downFactor + (LO32(_step)<<SRC_PHASEBITS) * Q32_TO_FLOAT, _numTaps);
 
+    allocateBuffers(_step);
+}
+
+AudioSRC::AudioSRC(int numChannels, float maxStretch, Quality quality) {
+
+    assert(numChannels > 0);
+    assert(numChannels <= SRC_MAX_CHANNELS);
+    assert(maxStretch >= 0.0f && maxStretch < 0.5f);
+
+    _inputSampleRate = SRC_PHASES;
+    _outputSampleRate = SRC_PHASES;
+    _numChannels = numChannels;
+    _maxStretch = maxStretch;
+
+    // always irrational, so the step can be changed between renders
+    _upFactor = SRC_PHASES;
+    _downFactor = SRC_PHASES;
+    _unityStep = (int64_t)1 << 32;
+    _step = _unityStep;
+
+    _polyphaseFilter = nullptr;
+    _stepTable = nullptr;
+
+    // design the filter for the fastest rate we will play at, to keep aliasing out when shortening
+    int downFactor = (int)(SRC_PHASES * (1.0f + maxStretch));
+    _numTaps = createIrrationalFilter(_upFactor, downFactor, 1.0f, quality);
+
+    // the smallest step is the longest stretch, which produces the most output per input
+    allocateBuffers((int64_t)(_unityStep / (1.0f + maxStretch)));
+}
+
+void AudioSRC::allocateBuffers(int64_t minStep) {
+
     // filter history size
     _numHistory = _numTaps - 1;
 
     // input blocking size, such that input and output are both guaranteed not to exceed SRC_BLOCK frames
-    _inputBlock = MIN(SRC_BLOCK, getMaxInput(SRC_BLOCK));
+    if (minStep == 0) {
+        _inputBlock = MIN(SRC_BLOCK, getMaxInput(SRC_BLOCK));
+    } else {
+        _inputBlock = MIN(SRC_BLOCK, (int)(((int64_t)SRC_BLOCK * minStep) >> 32));
+    }
 
     // allocate buffers
     for (int ch = 0; ch < _numChannels; ch++) {
@@ -1535,6 +1572,13 @@ int AudioSRC::render(const float* input, float* output, int inputFrames) {
     return outputFrames;
 }
 
+void AudioSRC::setStretch(float stretch) {
+    assert(_unityStep != 0);    // only in time-stretching mode
+
+    stretch = MIN(MAX(stretch, 1.0f - _maxStretch), 1.0f + _maxStretch);
+    _step = (int64_t)(_unityStep / stretch);
+}
+
 // the min output frames that will be produced by inputFrames
 int AudioSRC::getMinOutput(int inputFrames) {
     if (_step == 0) {
@@ -38,8 +38,15 @@ public:
     };
 
     AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels, Quality quality = MEDIUM_QUALITY);
+
+    // time-stretching mode, where the ratio of output to input frames can be varied by up to +/- maxStretch
+    AudioSRC(int numChannels, float maxStretch, Quality quality = LOW_QUALITY);
+
     ~AudioSRC();
 
+    // set the ratio of output to input frames in time-stretching mode, clamped to 1 +/- maxStretch
+    void setStretch(float stretch);
+
     // deinterleaved float input/output (native format)
     int render(float** inputs, float** outputs, int inputFrames);
 
@@ -76,6 +83,11 @@ private:
     int64_t _offset;
     int64_t _step;
 
+    float _maxStretch { 0.0f };
+    int64_t _unityStep { 0 };
+
+    void allocateBuffers(int64_t minStep);
+
     int createRationalFilter(int upFactor, int downFactor, float gain, Quality quality);
     int createIrrationalFilter(int upFactor, int downFactor, float gain, Quality quality);
 
@@ -26,8 +26,15 @@ const int InboundAudioStream::WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVE
 const int InboundAudioStream::WINDOW_SECONDS_FOR_DESIRED_REDUCTION = 10;
 const bool InboundAudioStream::USE_STDEV_FOR_JITTER = false;
 const bool InboundAudioStream::REPETITION_WITH_FADE = true;
+const float InboundAudioStream::JITTER_BUFFER_TARGET_PERCENTILE = 0.95f;
+const int InboundAudioStream::JITTER_WINDOW_PACKETS = 500; // 5s
+const float InboundAudioStream::MAX_TIME_STRETCH = 0.05f;
 
-static const int STARVE_HISTORY_CAPACITY = 50;
+// how quickly the time-stretch reacts to the depth of the buffer, in stretch per frame of error
+static const float TIME_STRETCH_GAIN = 0.01f;
+
+// the buffer depth is smoothed over roughly this many packets before it is compared to the desired depth
+static const float TIME_STRETCH_AVERAGING = 0.1f;
 
 // This is called 1x/s, and we want it to log the last 5s
 static const int UNPLAYED_MS_WINDOW_SECS = 5;
@@ -53,7 +60,8 @@ InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBl
     _staticJitterBufferFrames(std::max(numStaticJitterBlocks, DEFAULT_STATIC_JITTER_FRAMES)),
     _desiredJitterBufferFrames(_dynamicJitterBufferEnabled ? 1 : _staticJitterBufferFrames),
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
-    _starveHistory(STARVE_HISTORY_CAPACITY),
+    _jitterEstimator(JITTER_WINDOW_PACKETS, JITTER_BUFFER_TARGET_PERCENTILE, AudioConstants::NETWORK_FRAME_USECS),
+    _lossConcealment(numChannels, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL),
     _unplayedMs(0, UNPLAYED_MS_WINDOW_SECS),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {}
 
@@ -67,12 +75,27 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    _lossConcealment.reset();
+    _timeStretcher.reset();
     resetStats();
     // FIXME: calling cleanupCodec() seems to be the cause of the buzzsaw -- we get an assert
     // after this is called in AudioClient.  Ponder and fix...
     // cleanupCodec();
 }
 
+void InboundAudioStream::setNumChannels(int numChannels) {
+    if (numChannels == _numChannels) {
+        return;
+    }
+
+    _numChannels = numChannels;
+    _ringBuffer.resizeForFrameSize(numChannels * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    // the concealment history and the time-stretcher state are interleaved by channel
+    _lossConcealment = AudioLossConcealment(numChannels, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    _timeStretcher.reset();
+}
+
 void InboundAudioStream::resetStats() {
     if (_dynamicJitterBufferEnabled) {
         _desiredJitterBufferFrames = 1;
@@ -83,9 +106,10 @@ void InboundAudioStream::resetStats() {
     _oldFramesDropped = 0;
     _incomingSequenceNumberStats.reset();
     _lastPacketReceivedTime = 0;
-    _timeGapStatsForDesiredCalcOnTooManyStarves.reset();
-    _timeGapStatsForDesiredReduction.reset();
-    _starveHistory.clear();
+    _jitterEstimator.reset();
+    _calculatedJitterBufferFrames = 0;
+    _timeStretch = 1.0f;
+    _averageFramesAvailable = 0.0f;
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
@@ -106,8 +130,6 @@ void InboundAudioStream::setReverb(float reverbTime, float wetLevel) {
 
 void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _incomingSequenceNumberStats.pushStatsToHistory();
-    _timeGapStatsForDesiredCalcOnTooManyStarves.currentIntervalComplete();
-    _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
     _unplayedMs.currentIntervalComplete();
 }
@@ -120,7 +142,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
                                                                                                        message.getSourceID());
     QString codecInPacket = message.readString();
 
-    packetReceivedUpdateTimingStats();
+    packetReceivedUpdateTimingStats(sequence);
 
     int networkFrames;
 
@@ -225,16 +247,10 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
 }
 
 int InboundAudioStream::lostAudioData(int numPackets) {
-    QByteArray decodedBuffer;
-
     while (numPackets--) {
-        if (_decoder) {
-            _decoder->lostFrame(decodedBuffer);
-        } else {
-            decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-            memset(decodedBuffer.data(), 0, decodedBuffer.size());
-        }
-        _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
+        QByteArray decodedBuffer = concealLostFrame();
+        writeTimeStretched(reinterpret_cast<const int16_t*>(decodedBuffer.constData()),
+                           decodedBuffer.size() / AudioConstants::SAMPLE_SIZE, _numChannels);
     }
     return 0;
 }
@@ -246,8 +262,62 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
     } else {
         decodedBuffer = packetAfterStreamProperties;
     }
-    auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+
+    decodedFrameReceived(decodedBuffer);
+
+    return writeTimeStretched(reinterpret_cast<const int16_t*>(decodedBuffer.constData()),
+                              decodedBuffer.size() / AudioConstants::SAMPLE_SIZE, _numChannels);
+}
+
+QByteArray InboundAudioStream::concealLostFrame() {
+    QByteArray decodedBuffer;
+
+    if (_decoder) {
+        // the codec knows best how to interpolate its own audio
+        _decoder->lostFrame(decodedBuffer);
+    } else {
+        decodedBuffer.resize(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * _numChannels * AudioConstants::SAMPLE_SIZE);
+        _lossConcealment.frameLost(reinterpret_cast<int16_t*>(decodedBuffer.data()));
+    }
+
+    return decodedBuffer;
+}
+
+void InboundAudioStream::decodedFrameReceived(QByteArray& decodedBuffer) {
+    int frameBytes = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * _numChannels * AudioConstants::SAMPLE_SIZE;
+    if (!_decoder && decodedBuffer.size() == frameBytes) {
+        _lossConcealment.frameReceived(reinterpret_cast<int16_t*>(decodedBuffer.data()));
+    }
+}
+
+int InboundAudioStream::writeTimeStretched(const int16_t* samples, int numSamples, int numChannels) {
+    if (!_dynamicJitterBufferEnabled || numChannels <= 0 || numChannels > SRC_MAX_CHANNELS) {
+        return _ringBuffer.writeSamples(samples, numSamples);
+    }
+
+    // play slightly faster when the buffer is deeper than it needs to be, and slightly slower when it's shallower,
+    // which converges on the desired depth without the jumps of dropping or repeating whole frames
+    _averageFramesAvailable += TIME_STRETCH_AVERAGING * (_ringBuffer.framesAvailable() - _averageFramesAvailable);
+    float framesOverDesired = _averageFramesAvailable - _desiredJitterBufferFrames;
+
+    if (fabsf(framesOverDesired) < 1.0f) {
+        _timeStretch = 1.0f;
+    } else {
+        _timeStretch = 1.0f - glm::clamp(TIME_STRETCH_GAIN * framesOverDesired, -MAX_TIME_STRETCH, MAX_TIME_STRETCH);
+    }
+
+    if (!_timeStretcher || _timeStretcherChannels != numChannels) {
+        _timeStretcher.reset(new AudioSRC(numChannels, MAX_TIME_STRETCH));
+        _timeStretcherChannels = numChannels;
+    }
+    _timeStretcher->setStretch(_timeStretch);
+
+    int numFrames = numSamples / numChannels;
+    int maxOutputFrames = (int)ceilf(numFrames * (1.0f + MAX_TIME_STRETCH)) + 1;
+    _timeStretchBuffer.resize(maxOutputFrames * numChannels);
+
+    int outputFrames = _timeStretcher->render(samples, _timeStretchBuffer.data(), numFrames);
+    return _ringBuffer.writeSamples(_timeStretchBuffer.data(), outputFrames * numChannels);
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -271,6 +341,9 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
         _decoder->lostFrame(decodedBuffer);
     }
 
+    // there is nothing worth concealing with after silence
+    _lossConcealment.reset();
+
     // calculate how many silent frames we should drop.
     int silentSamples = silentFrames * _numChannels;
     int samplesPerFrame = _ringBuffer.getNumFrameSamples();
@@ -368,42 +441,8 @@ void InboundAudioStream::setToStarved() {
     // be considered refilled. in that case, there's no need to set _isStarved to true.
     _isStarved = (_ringBuffer.framesAvailable() < _desiredJitterBufferFrames);
 
-    // record the time of this starve in the starve history
-    quint64 now = usecTimestampNow();
-    _starveHistory.insert(now);
-
-    if (_dynamicJitterBufferEnabled) {
-        // dynamic jitter buffers are enabled. check if this starve put us over the window
-        // starve threshold
-        quint64 windowEnd = now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND;
-        RingBufferHistory<quint64>::Iterator starvesIterator = _starveHistory.begin();
-        RingBufferHistory<quint64>::Iterator end = _starveHistory.end();
-        int starvesInWindow = 1;
-        do {
-            ++starvesIterator;
-            if (*starvesIterator < windowEnd) {
-                break;
-            }
-            starvesInWindow++;
-        } while (starvesIterator != end);
-
-        // this starve put us over the starve threshold. update _desiredJitterBufferFrames to
-        // value determined by window A.
-        if (starvesInWindow >= WINDOW_STARVE_THRESHOLD) {
-            int calculatedJitterBufferFrames;
-            // we don't know when the next packet will arrive, so it's possible the gap between the last packet and the
-            // next packet will exceed the max time gap in the window.  If the time since the last packet has already exceeded
-            // the window max gap, then we should use that value to calculate desired frames.
-            int framesSinceLastPacket = ceilf((float)(now - _lastPacketReceivedTime)
-                                              / (float)AudioConstants::NETWORK_FRAME_USECS);
-            calculatedJitterBufferFrames = std::max(_calculatedJitterBufferFrames, framesSinceLastPacket);
-            // make sure _desiredJitterBufferFrames does not become lower here
-            if (calculatedJitterBufferFrames >= _desiredJitterBufferFrames) {
-                _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                qCInfo(audiostream, "Set desired jitter frames to %d (starved)", _desiredJitterBufferFrames);
-            }
-        }
-    }
+    // with dynamic jitter buffers the late packet that caused this starve shows up in the arrival statistics,
+    // which raise the desired frames once it arrives
 }
 
 void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
@@ -425,39 +464,27 @@ void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrame
     }
 }
 
-void InboundAudioStream::packetReceivedUpdateTimingStats() {
-    
-    // update our timegap stats and desired jitter buffer frames if necessary
+void InboundAudioStream::packetReceivedUpdateTimingStats(quint16 sequence) {
+    quint64 now = usecTimestampNow();
+
+    // every packet (including late ones) tells us how deep the jitter buffer needs to be
+    _jitterEstimator.packetReceived(sequence, now);
+
+    // never ask for more than half of what the ring buffer can hold, so there is room to absorb bursts
+    int maxJitterBufferFrames = std::max(_ringBuffer.getFrameCapacity() / 2, 1);
+    _calculatedJitterBufferFrames = glm::clamp(_jitterEstimator.getTargetFrames(), 1, maxJitterBufferFrames);
+
+    // the estimator's target can move with almost every packet, so this isn't logged; it's in the stream stats
+    if (_dynamicJitterBufferEnabled) {
+        _desiredJitterBufferFrames = _calculatedJitterBufferFrames;
+    }
+
+    // update our timegap stats
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 1000; // 10s
-    quint64 now = usecTimestampNow();
     if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
-
-        // update all stats used for desired frames calculations under dynamic jitter buffer mode
-        _timeGapStatsForDesiredCalcOnTooManyStarves.update(gap);
-        _timeGapStatsForDesiredReduction.update(gap);
-
-        if (_timeGapStatsForDesiredCalcOnTooManyStarves.getNewStatsAvailableFlag()) {
-            _calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredCalcOnTooManyStarves.getWindowMax()
-                                                             / (float) AudioConstants::NETWORK_FRAME_USECS);
-            _timeGapStatsForDesiredCalcOnTooManyStarves.clearNewStatsAvailableFlag();
-        }
-
-        if (_dynamicJitterBufferEnabled) {
-            // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
-            // then reduce _desiredJitterBufferFrames to that number of frames.
-            if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
-                int calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredReduction.getWindowMax()
-                                                         / (float)AudioConstants::NETWORK_FRAME_USECS);
-                if (calculatedJitterBufferFrames < _desiredJitterBufferFrames) {
-                    _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                    qCInfo(audiostream, "Set desired jitter frames to %d (reduced)", _desiredJitterBufferFrames);
-                }
-                _timeGapStatsForDesiredReduction.clearNewStatsAvailableFlag();
-            }
-        }
     }
 
     _lastPacketReceivedTime = now;
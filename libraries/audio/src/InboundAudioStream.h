@@ -12,6 +12,9 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <memory>
+#include <vector>
+
 #include <Node.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
@@ -21,7 +24,10 @@
 
 #include <plugins/CodecPlugin.h>
 
+#include "AudioJitterEstimator.h"
+#include "AudioLossConcealment.h"
 #include "AudioRingBuffer.h"
+#include "AudioSRC.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
 #include "AudioStreamStats.h"
@@ -37,6 +43,9 @@ public:
     // settings
     static const bool DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED;
     static const int DEFAULT_STATIC_JITTER_FRAMES;
+    static const float JITTER_BUFFER_TARGET_PERCENTILE;
+    static const int JITTER_WINDOW_PACKETS;
+    static const float MAX_TIME_STRETCH;
     // legacy (now static) settings
     static const int MAX_FRAMES_OVER_DESIRED;
     static const int WINDOW_STARVE_THRESHOLD;
@@ -71,7 +80,7 @@ public:
 
     virtual AudioStreamStats getAudioStreamStats() const;
 
-    /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
+    /// returns the number of jitter buffer frames that covers JITTER_BUFFER_TARGET_PERCENTILE of recent packet arrivals
     int getCalculatedJitterBufferFrames() const { return _calculatedJitterBufferFrames; }
     
     bool dynamicJitterBufferEnabled() const { return _dynamicJitterBufferEnabled; }
@@ -91,6 +100,7 @@ public:
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    float getTimeStretch() const { return _timeStretch; }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -113,7 +123,7 @@ public slots:
     void perSecondCallbackForUpdatingStats();
 
 private:
-    void packetReceivedUpdateTimingStats();
+    void packetReceivedUpdateTimingStats(quint16 sequence);
 
     void popSamplesNoCheck(int samples);
     void framesAvailableChanged();
@@ -137,6 +147,18 @@ protected:
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
+
+    /// produces one network frame of audio for a lost packet, from the codec if it can interpolate or by concealment
+    QByteArray concealLostFrame();
+
+    /// lets the loss concealment follow the decoded network audio (and fade in after a loss)
+    void decodedFrameReceived(QByteArray& decodedBuffer);
+
+    /// writes interleaved samples to the ring buffer, time-stretched towards the desired jitter buffer depth
+    int writeTimeStretched(const int16_t* samples, int numSamples, int numChannels);
+
+    /// switches the stream between mono and stereo, which starts the ring buffer, loss concealment and time-stretcher over
+    void setNumChannels(int numChannels);
     
 protected:
 
@@ -163,11 +185,17 @@ protected:
     SequenceNumberStats _incomingSequenceNumberStats;
 
     quint64 _lastPacketReceivedTime { 0 };
-    MovingMinMaxAvg<quint64> _timeGapStatsForDesiredCalcOnTooManyStarves { 0, WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES };
+    AudioJitterEstimator _jitterEstimator;
     int _calculatedJitterBufferFrames { 0 };
-    MovingMinMaxAvg<quint64> _timeGapStatsForDesiredReduction { 0, WINDOW_SECONDS_FOR_DESIRED_REDUCTION };
 
-    RingBufferHistory<quint64> _starveHistory;
+    // the buffer depth is steered towards the desired frames by playing slightly faster or slower
+    std::unique_ptr<AudioSRC> _timeStretcher;
+    int _timeStretcherChannels { 0 };
+    float _timeStretch { 1.0f };
+    float _averageFramesAvailable { 0.0f };
+    std::vector<int16_t> _timeStretchBuffer;
+
+    AudioLossConcealment _lossConcealment;
 
     TimeWeightedAvg<int> _framesAvailableStat;
     MovingMinMaxAvg<float> _unplayedMs;
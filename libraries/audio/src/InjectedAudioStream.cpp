@@ -40,11 +40,9 @@ int InjectedAudioStream::parseStreamProperties(PacketType type,
     bool isStereo;
     packetStream >> isStereo;
     
-    // if isStereo value has changed, restart the ring buffer with new frame size
+    // if isStereo value has changed, restart the stream with the new number of channels
     if (isStereo != _isStereo) {
-        _ringBuffer.resizeForFrameSize(isStereo
-                                       ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
-                                       : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        setNumChannels(isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
         _isStereo = isStereo;
     }
 
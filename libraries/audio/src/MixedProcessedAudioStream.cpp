@@ -32,22 +32,17 @@ int MixedProcessedAudioStream::writeDroppableSilentFrames(int silentFrames) {
 }
 
 int MixedProcessedAudioStream::lostAudioData(int numPackets) {
-    QByteArray decodedBuffer;
     QByteArray outputBuffer;
 
     while (numPackets--) {
-        if (_decoder) {
-            _decoder->lostFrame(decodedBuffer);
-        } else {
-            decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-            memset(decodedBuffer.data(), 0, decodedBuffer.size());
-        }
+        QByteArray decodedBuffer = concealLostFrame();
 
         emit addedStereoSamples(decodedBuffer);
 
         emit processSamples(decodedBuffer, outputBuffer);
 
-        _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+        writeTimeStretched(reinterpret_cast<const int16_t*>(outputBuffer.constData()),
+                           outputBuffer.size() / AudioConstants::SAMPLE_SIZE, (int)_outputChannelCount);
         qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
     }
     return 0;
@@ -61,12 +56,15 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
         decodedBuffer = packetAfterStreamProperties;
     }
 
+    decodedFrameReceived(decodedBuffer);
+
     emit addedStereoSamples(decodedBuffer);
 
     QByteArray outputBuffer;
     emit processSamples(decodedBuffer, outputBuffer);
 
-    _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+    writeTimeStretched(reinterpret_cast<const int16_t*>(outputBuffer.constData()),
+                       outputBuffer.size() / AudioConstants::SAMPLE_SIZE, (int)_outputChannelCount);
     qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
 
     return packetAfterStreamProperties.size();
@@ -351,16 +351,21 @@ void Avatar::simulate(float deltaTime, bool inView) {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView) {
             Head* head = getHead();
-            if (_hasNewJointData) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
-                _jointDataSimulationRate.increment();
+            uint64_t now = usecTimestampNow();
+            if (needsJointPoses(now)) {
+                if (!_hasComputedJointPoses) {
+                    computeJointPoses(now, deltaTime);
+                }
+                _hasComputedJointPoses = false;
+                if (_hasPosedNewJointData) {
+                    _jointDataSimulationRate.increment();
+                    _hasNewJointData = false;
+                    _hasPosedNewJointData = false;
+                }
 
                 _skeletonModel->simulate(deltaTime, true);
 
                 locationChanged(); // joints changed, so if there are any children, update them.
-                _hasNewJointData = false;
 
                 glm::vec3 headPosition = getPosition();
                 if (!_skeletonModel->getHeadPosition(headPosition)) {
@@ -406,6 +411,37 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 }
 
+// how often an avatar at each AnimationLOD is posed from new joint data
+static const uint64_t JOINT_POSE_INTERVALS[(int)AnimationLOD::NumLODs] = {
+    0,
+    USECS_PER_SECOND / 30,
+    USECS_PER_SECOND / 10
+};
+
+bool Avatar::needsJointPoses(uint64_t now) const {
+    return _hasComputedJointPoses || (_hasNewJointData && now >= _nextJointPoseTime) ||
+        _skeletonModel->getRig().isBlendingJoints();
+}
+
+void Avatar::computeJointPoses(uint64_t now, float deltaTime) {
+    Rig& rig = _skeletonModel->getRig();
+    if (_hasNewJointData && now >= _nextJointPoseTime) {
+        uint64_t interval = JOINT_POSE_INTERVALS[(int)_animationLOD];
+        _nextJointPoseTime = now + interval;
+
+        // at medium detail the joints are blended over the time until they are posed again, rather than jumping
+        bool reducedJointSet = _animationLOD == AnimationLOD::Low;
+        float blendDuration = (_animationLOD == AnimationLOD::Medium) ? (float)interval / USECS_PER_SECOND : 0.0f;
+        rig.copyJointsFromJointData(_jointData, reducedJointSet, blendDuration);
+        _hasPosedNewJointData = true;
+    }
+    rig.blendJoints(deltaTime);
+
+    glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+    rig.computeExternalPoses(rootTransform);
+    _hasComputedJointPoses = true;
+}
+
 float Avatar::getSimulationRate(const QString& rateName) const {
     if (rateName == "") {
         return _simulationRate.rate();
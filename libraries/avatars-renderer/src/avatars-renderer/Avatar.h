@@ -53,6 +53,14 @@ class Texture;
 
 using AvatarPhysicsCallback = std::function<void(uint32_t)>;
 
+// How much of the animation of an avatar in view is computed, from the avatars nearest and largest on screen down.
+enum class AnimationLOD : uint8_t {
+    High = 0, // posed from every new joint data
+    Medium,   // posed from joint data at a reduced rate and blended in between
+    Low,      // posed from joint data at a low rate, with the fingers held and without the eye look-at
+    NumLODs
+};
+
 class Avatar : public AvatarData {
     Q_OBJECT
 
@@ -239,6 +247,16 @@ public:
 
     bool hasNewJointData() const { return _hasNewJointData; }
 
+    void setAnimationLOD(AnimationLOD lod) { _animationLOD = lod; }
+    AnimationLOD getAnimationLOD() const { return _animationLOD; }
+
+    // whether simulate() will pose the joints if the avatar is in view
+    bool needsJointPoses(uint64_t now) const;
+
+    // Poses the rig from new joint data, which is the part of simulate() that touches nothing but this avatar, so that
+    // it can be done for many avatars in parallel before they are simulated.  simulate() does it if it hasn't been.
+    void computeJointPoses(uint64_t now, float deltaTime);
+
     float getBoundingRadius() const;
     
     void addToScene(AvatarSharedPointer self, const render::ScenePointer& scene);
@@ -330,6 +348,10 @@ protected:
     RateCounter<> _simulationInViewRate;
     RateCounter<> _skeletonModelSimulationRate;
     RateCounter<> _jointDataSimulationRate;
+    bool _hasComputedJointPoses { false };
+    bool _hasPosedNewJointData { false };
+    AnimationLOD _animationLOD { AnimationLOD::High };
+    uint64_t _nextJointPoseTime { 0 };
 
 private:
     class AvatarEntityDataHash {
@@ -107,6 +107,11 @@ void SkeletonModel::updateRig(float deltaTime, glm::mat4 parentTransform) {
     head->setBaseYaw(glm::degrees(eulers.y));
     head->setBaseRoll(glm::degrees(-eulers.z));
 
+    // avatars animated at low detail are too small on screen for anyone to see where they're looking
+    if (_owningAvatar->getAnimationLOD() == AnimationLOD::Low) {
+        return;
+    }
+
     Rig::EyeParameters eyeParams;
     eyeParams.eyeLookAt = lookAt;
     eyeParams.eyeSaccade = glm::vec3(0.0f);
@@ -2171,24 +2171,253 @@ void AvatarData::fromJson(const QJsonObject& json, bool useFrameSkeleton) {
     }
 }
 
+// Binary recording frames.  The fixed size part comes first and the joints are quantized the way they are for the
+// avatar mixer, so that consecutive frames of an avatar differ in few bytes and the delta frames of the clip are small.
+static const char AVATAR_FRAME_TAG[] = { 'h', 'f', 'a', 'v' };
+static const int AVATAR_FRAME_TAG_SIZE = sizeof(AVATAR_FRAME_TAG);
+static const quint8 AVATAR_FRAME_VERSION = 1;
+static const int AVATAR_FRAME_JOINT_SIZE = 6 + 6; // packed rotation, packed translation
+
+enum AvatarFrameFlags : quint16 {
+    AVATAR_FRAME_HAS_BASIS = 0x0001,
+    AVATAR_FRAME_HAS_RELATIVE = 0x0002,
+    AVATAR_FRAME_HAS_SCALE = 0x0004,
+    AVATAR_FRAME_HAS_HEAD = 0x0008,
+    AVATAR_FRAME_HAS_SKELETON_MODEL = 0x0010,
+    AVATAR_FRAME_HAS_DISPLAY_NAME = 0x0020,
+    AVATAR_FRAME_HAS_ATTACHMENTS = 0x0040
+};
+
+static void writeFrameTransform(QDataStream& out, const Transform& transform) {
+    out << transform.getTranslation() << transform.getRotation() << transform.getScale();
+}
+
+static Transform readFrameTransform(QDataStream& in) {
+    glm::vec3 translation;
+    glm::quat rotation;
+    glm::vec3 scale;
+    in >> translation >> rotation >> scale;
+    // through the setters, which keep the flags of the transform, as Transform::fromJson() does
+    Transform result;
+    result.setRotation(rotation);
+    result.setTranslation(translation);
+    result.setScale(scale);
+    return result;
+}
+
+bool AvatarData::isBinaryFrame(const QByteArray& frameData) {
+    return frameData.size() > AVATAR_FRAME_TAG_SIZE &&
+        memcmp(frameData.constData(), AVATAR_FRAME_TAG, AVATAR_FRAME_TAG_SIZE) == 0;
+}
+
+QByteArray AvatarData::toBinaryFrame() const {
+    auto recordingBasis = getRecordingBasis();
+    bool success;
+    Transform avatarTransform = getTransform(success);
+    if (!success) {
+        qCWarning(avatars) << "Warning -- AvatarData::toBinaryFrame couldn't get avatar transform";
+    }
+    avatarTransform.setScale(getDomainLimitedScale());
+    Transform relativeTransform = recordingBasis ? recordingBasis->relativeTransform(avatarTransform) : avatarTransform;
+
+    auto scale = getDomainLimitedScale();
+    const HeadData* head = getHeadData();
+    QByteArray headData = head ? head->toFrameData() : QByteArray();
+    QVector<AttachmentData> attachments = getAttachmentData();
+
+    quint16 flags = 0;
+    if (recordingBasis) {
+        flags |= AVATAR_FRAME_HAS_BASIS;
+    }
+    if (!recordingBasis || !relativeTransform.isIdentity()) {
+        flags |= AVATAR_FRAME_HAS_RELATIVE;
+    }
+    if (scale != 1.0f) {
+        flags |= AVATAR_FRAME_HAS_SCALE;
+    }
+    if (!headData.isEmpty()) {
+        flags |= AVATAR_FRAME_HAS_HEAD;
+    }
+    if (!getSkeletonModelURL().isEmpty()) {
+        flags |= AVATAR_FRAME_HAS_SKELETON_MODEL;
+    }
+    if (!getDisplayName().isEmpty()) {
+        flags |= AVATAR_FRAME_HAS_DISPLAY_NAME;
+    }
+    if (!attachments.isEmpty()) {
+        flags |= AVATAR_FRAME_HAS_ATTACHMENTS;
+    }
+
+    QByteArray frameData;
+    QDataStream out(&frameData, QIODevice::WriteOnly);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out.writeRawData(AVATAR_FRAME_TAG, AVATAR_FRAME_TAG_SIZE);
+    out << AVATAR_FRAME_VERSION << flags;
+
+    if (flags & AVATAR_FRAME_HAS_BASIS) {
+        writeFrameTransform(out, *recordingBasis);
+    }
+    if (flags & AVATAR_FRAME_HAS_RELATIVE) {
+        writeFrameTransform(out, relativeTransform);
+    }
+    if (flags & AVATAR_FRAME_HAS_SCALE) {
+        out << scale;
+    }
+
+    // Skeleton pose
+    QVector<JointData> jointData = getRawJointData();
+    out << (quint16)jointData.size();
+    QByteArray packedJoints(jointData.size() * AVATAR_FRAME_JOINT_SIZE, 0);
+    unsigned char* destination = (unsigned char*)packedJoints.data();
+    for (const auto& joint : jointData) {
+        destination += packOrientationQuatToSixBytes(destination, joint.rotation);
+        destination += packFloatVec3ToSignedTwoByteFixed(destination, joint.translation, TRANSLATION_COMPRESSION_RADIX);
+    }
+    out.writeRawData(packedJoints.constData(), packedJoints.size());
+
+    if (flags & AVATAR_FRAME_HAS_HEAD) {
+        out << headData;
+    }
+    if (flags & AVATAR_FRAME_HAS_SKELETON_MODEL) {
+        out << getSkeletonModelURL().toString();
+    }
+    if (flags & AVATAR_FRAME_HAS_DISPLAY_NAME) {
+        out << getDisplayName();
+    }
+    if (flags & AVATAR_FRAME_HAS_ATTACHMENTS) {
+        out << attachments;
+    }
+    return frameData;
+}
+
+bool AvatarData::fromBinaryFrame(const QByteArray& frameData, bool useFrameSkeleton) {
+    QDataStream in(frameData);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    in.skipRawData(AVATAR_FRAME_TAG_SIZE);
+    quint8 version;
+    quint16 flags;
+    in >> version >> flags;
+    if (version > AVATAR_FRAME_VERSION) {
+        quint64 now = usecTimestampNow();
+        if (shouldLogError(now)) {
+            qCWarning(avatars) << "Avatar recording frame version" << version << "is not supported";
+        }
+        return false;
+    }
+
+    Transform basis;
+    if (flags & AVATAR_FRAME_HAS_BASIS) {
+        basis = readFrameTransform(in);
+    }
+    Transform relativeTransform;
+    if (flags & AVATAR_FRAME_HAS_RELATIVE) {
+        relativeTransform = readFrameTransform(in);
+    }
+    float scale = 1.0f;
+    if (flags & AVATAR_FRAME_HAS_SCALE) {
+        in >> scale;
+    }
+    quint16 numJoints;
+    in >> numJoints;
+    QByteArray packedJoints(numJoints * AVATAR_FRAME_JOINT_SIZE, 0);
+    in.readRawData(packedJoints.data(), packedJoints.size());
+    QByteArray headData;
+    if (flags & AVATAR_FRAME_HAS_HEAD) {
+        in >> headData;
+    }
+    QString bodyModelURL;
+    if (flags & AVATAR_FRAME_HAS_SKELETON_MODEL) {
+        in >> bodyModelURL;
+    }
+    QString newDisplayName = "";
+    if (flags & AVATAR_FRAME_HAS_DISPLAY_NAME) {
+        in >> newDisplayName;
+    }
+    QVector<AttachmentData> attachments;
+    if (flags & AVATAR_FRAME_HAS_ATTACHMENTS) {
+        in >> attachments;
+    }
+    if (in.status() != QDataStream::Ok) {
+        quint64 now = usecTimestampNow();
+        if (shouldLogError(now)) {
+            qCWarning(avatars) << "Avatar recording frame is truncated";
+        }
+        return false;
+    }
+
+    // the same as fromJson()
+    if ((flags & AVATAR_FRAME_HAS_SKELETON_MODEL) && useFrameSkeleton &&
+        bodyModelURL != getSkeletonModelURL().toString()) {
+        setSkeletonModelURL(bodyModelURL);
+    }
+    if (newDisplayName != getDisplayName()) {
+        setDisplayName(newDisplayName);
+    }
+
+    auto currentBasis = getRecordingBasis();
+    if (!currentBasis) {
+        currentBasis = std::make_shared<Transform>(basis);
+    }
+    if (flags & AVATAR_FRAME_HAS_RELATIVE) {
+        auto worldTransform = currentBasis->worldTransform(relativeTransform);
+        setPosition(worldTransform.getTranslation());
+        setOrientation(worldTransform.getRotation());
+    } else {
+        setPosition(currentBasis->getTranslation());
+        setOrientation(currentBasis->getRotation());
+    }
+
+    // Do after avatar orientation because head look-at needs avatar orientation.
+    if (flags & AVATAR_FRAME_HAS_HEAD) {
+        if (!_headData) {
+            _headData = new HeadData(this);
+        }
+        _headData->fromFrameData(headData);
+    }
+
+    if (flags & AVATAR_FRAME_HAS_SCALE) {
+        setTargetScale(scale);
+    }
+
+    if (attachments != getAttachmentData()) {
+        setAttachmentData(attachments);
+    }
+
+    QVector<JointData> jointArray(numJoints);
+    const unsigned char* source = (const unsigned char*)packedJoints.constData();
+    for (auto& joint : jointArray) {
+        source += unpackOrientationQuatFromSixBytes(source, joint.rotation);
+        joint.rotationSet = true;
+        source += unpackFloatVec3FromSignedTwoByteFixed(source, joint.translation, TRANSLATION_COMPRESSION_RADIX);
+        joint.translationSet = true;
+    }
+    setRawJointData(jointArray);
+    return true;
+}
+
 // Every frame will store both a basis for the recording and a relative transform
 // This allows the application to decide whether playback should be relative to an avatar's
 // transform at the start of playback, or relative to the transform of the recorded
 // avatar
 QByteArray AvatarData::toFrame(const AvatarData& avatar) {
-    QJsonObject root = avatar.toJson();
 #ifdef WANT_JSON_DEBUG
     {
-        QJsonObject obj = root;
+        QJsonObject obj = avatar.toJson();
         obj.remove(JSON_AVATAR_JOINT_ARRAY);
         qCDebug(avatars).noquote() << QJsonDocument(obj).toJson(QJsonDocument::JsonFormat::Indented);
     }
 #endif
-    return QJsonDocument(root).toBinaryData();
+    return avatar.toBinaryFrame();
 }
 
 
 void AvatarData::fromFrame(const QByteArray& frameData, AvatarData& result, bool useFrameSkeleton) {
+    if (isBinaryFrame(frameData)) {
+        result.fromBinaryFrame(frameData, useFrameSkeleton);
+        return;
+    }
+
+    // recorded before the binary frames
     QJsonDocument doc = QJsonDocument::fromBinaryData(frameData);
 
 #ifdef WANT_JSON_DEBUG
@@ -2201,6 +2430,24 @@ void AvatarData::fromFrame(const QByteArray& frameData, AvatarData& result, bool
     result.fromJson(doc.object(), useFrameSkeleton);
 }
 
+QByteArray AvatarData::convertLegacyFrame(const QByteArray& frameData) {
+    if (isBinaryFrame(frameData)) {
+        return frameData;
+    }
+    QJsonObject json = QJsonDocument::fromBinaryData(frameData).object();
+    if (json.isEmpty()) {
+        return QByteArray();
+    }
+
+    // play the frame back on an avatar recorded against the same basis, then record it again
+    AvatarData avatar;
+    if (json.contains(JSON_AVATAR_BASIS)) {
+        avatar.setRecordingBasis(std::make_shared<Transform>(Transform::fromJson(json[JSON_AVATAR_BASIS])));
+    }
+    avatar.fromJson(json);
+    return avatar.toBinaryFrame();
+}
+
 float AvatarData::getBodyYaw() const {
     glm::vec3 eulerAngles = glm::degrees(safeEulerAngles(getOrientation()));
     return eulerAngles.y;
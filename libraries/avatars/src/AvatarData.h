@@ -393,6 +393,10 @@ public:
 
     static void fromFrame(const QByteArray& frameData, AvatarData& avatar, bool useFrameSkeleton = true);
     static QByteArray toFrame(const AvatarData& avatar);
+    // frames recorded before the binary frame format are QJsonDocument binary data, which fromFrame() still reads
+    static bool isBinaryFrame(const QByteArray& frameData);
+    // the binary frame for a frame in either format, or an empty array if it can't be read
+    static QByteArray convertLegacyFrame(const QByteArray& frameData);
 
     AvatarData();
     virtual ~AvatarData();
@@ -608,6 +612,8 @@ public:
     void setRecordingBasis(TransformPointer recordingBasis = TransformPointer());
     QJsonObject toJson() const;
     void fromJson(const QJsonObject& json, bool useFrameSkeleton = true);
+    QByteArray toBinaryFrame() const;
+    bool fromBinaryFrame(const QByteArray& frameData, bool useFrameSkeleton = true);
 
     glm::vec3 getClientGlobalPosition() const { return _globalPosition; }
     glm::vec3 getGlobalBoundingBoxCorner() const { return _globalPosition + _globalBoundingBoxOffset - _globalBoundingBoxDimensions; }
@@ -193,3 +193,114 @@ void HeadData::fromJson(const QJsonObject& json) {
         setHeadOrientation(quatFromJsonValue(json[JSON_AVATAR_HEAD_ROTATION]));
     }
 }
+
+enum HeadFrameFlags : quint8 {
+    HEAD_FRAME_HAS_ROTATION = 0x01,
+    HEAD_FRAME_HAS_LOOKAT = 0x02
+};
+
+QByteArray HeadData::toFrameData() const {
+    const auto& blendshapeLookupMap = getBlendshapesLookupMap();
+    QByteArray frameData;
+    quint8 flags = 0;
+    glm::quat rotation = getRawOrientation();
+    if (rotation != quat()) {
+        flags |= HEAD_FRAME_HAS_ROTATION;
+    }
+    auto lookat = getLookAtPosition();
+    if (lookat != vec3()) {
+        flags |= HEAD_FRAME_HAS_LOOKAT;
+    }
+    frameData.append((char)flags);
+
+    if (flags & HEAD_FRAME_HAS_ROTATION) {
+        unsigned char packedRotation[6];
+        packOrientationQuatToSixBytes(packedRotation, rotation);
+        frameData.append((const char*)packedRotation, sizeof(packedRotation));
+    }
+    if (flags & HEAD_FRAME_HAS_LOOKAT) {
+        vec3 relativeLookAt = glm::inverse(_owningAvatar->getOrientation()) *
+            (getLookAtPosition() - _owningAvatar->getPosition());
+        frameData.append((const char*)&relativeLookAt, sizeof(vec3));
+    }
+
+    // index and value of each blendshape that isn't zero
+    QByteArray blendshapes;
+    for (auto index : blendshapeLookupMap.values()) {
+        float value = 0.0f;
+        if (index < _blendshapeCoefficients.size()) {
+            value += _blendshapeCoefficients[index];
+        }
+        if (index < _transientBlendshapeCoefficients.size()) {
+            value += _transientBlendshapeCoefficients[index];
+        }
+        if (value != 0.0f) {
+            blendshapes.append((char)(quint8)index);
+            blendshapes.append((const char*)&value, sizeof(float));
+        }
+    }
+    frameData.append((char)(quint8)(blendshapes.size() / (1 + sizeof(float))));
+    frameData.append(blendshapes);
+    return frameData;
+}
+
+bool HeadData::fromFrameData(const QByteArray& frameData) {
+    const char* data = frameData.constData();
+    const char* end = data + frameData.size();
+    if (data == end) {
+        return false;
+    }
+    quint8 flags = (quint8)*data++;
+
+    glm::quat rotation;
+    if (flags & HEAD_FRAME_HAS_ROTATION) {
+        if (end - data < 6) {
+            return false;
+        }
+        data += unpackOrientationQuatFromSixBytes((const unsigned char*)data, rotation);
+    }
+    vec3 relativeLookAt;
+    if (flags & HEAD_FRAME_HAS_LOOKAT) {
+        if (end - data < (int)sizeof(vec3)) {
+            return false;
+        }
+        memcpy(&relativeLookAt, data, sizeof(vec3));
+        data += sizeof(vec3);
+    }
+
+    if (data == end) {
+        return false;
+    }
+    int numBlendshapes = (quint8)*data++;
+    const int BLENDSHAPE_SIZE = 1 + sizeof(float);
+    if (end - data < numBlendshapes * BLENDSHAPE_SIZE) {
+        return false;
+    }
+    // the blendshapes that aren't in the frame are zero
+    QVector<float> blendshapeCoefficients;
+    for (int i = 0; i < numBlendshapes; i++) {
+        int index = (quint8)data[0];
+        float value;
+        memcpy(&value, data + 1, sizeof(float));
+        data += BLENDSHAPE_SIZE;
+        if (index >= NUM_FACESHIFT_BLENDSHAPES) {
+            continue;
+        }
+        if (blendshapeCoefficients.size() <= index) {
+            blendshapeCoefficients.resize(index + 1);
+        }
+        blendshapeCoefficients[index] = value;
+    }
+    if (_transientBlendshapeCoefficients.size() < blendshapeCoefficients.size()) {
+        _transientBlendshapeCoefficients.resize(blendshapeCoefficients.size());
+    }
+    setBlendshapeCoefficients(blendshapeCoefficients);
+
+    if (glm::length2(relativeLookAt) > 0.01f) {
+        setLookAtPosition((_owningAvatar->getOrientation() * relativeLookAt) + _owningAvatar->getPosition());
+    }
+    if (flags & HEAD_FRAME_HAS_ROTATION) {
+        setHeadOrientation(rotation);
+    }
+    return true;
+}
@@ -74,6 +74,10 @@ public:
     QJsonObject toJson() const;
     void fromJson(const QJsonObject& json);
 
+    // the same state as toJson()/fromJson(), in the binary avatar recording frames
+    QByteArray toFrameData() const;
+    bool fromFrameData(const QByteArray& frameData);
+
 protected:
     // degrees
     float _baseYaw;
@@ -52,11 +52,9 @@ public:
         glm::vec3 spare;
     };
     
-    struct ParticlePrimitive {
-        ParticlePrimitive(glm::vec3 xyzIn, glm::vec2 uvIn) : xyz(xyzIn), uv(uvIn) {}
-        glm::vec3 xyz; // Position
-        glm::vec2 uv; // Lifetime + seed
-    };
+    // Position, lifetime + seed, as written by the ParticleSystem
+    using ParticlePrimitive = ParticleSystem::Primitive;
+    static_assert(sizeof(ParticlePrimitive) == 5 * sizeof(float), "particle primitives must be tightly packed");
     
     using Payload = render::Payload<ParticlePayloadData>;
     using Pointer = Payload::DataPointer;
@@ -263,11 +261,8 @@ void RenderableParticleEffectEntityItem::updateRenderItem() {
     particleUniforms.lifespan = getLifespan();
     
     // Build particle primitives
-    auto particlePrimitives = std::make_shared<ParticlePrimitives>();
-    particlePrimitives->reserve(_particles.size()); // Reserve space
-    for (auto& particle : _particles) {
-        particlePrimitives->emplace_back(particle.position, glm::vec2(particle.lifetime, particle.seed));
-    }
+    auto particlePrimitives = std::make_shared<ParticlePrimitives>(_particles.getNumParticles());
+    _particles.writePrimitives(particlePrimitives->data());
 
     bool successb, successp, successr;
     auto bounds = getAABox(successb);
@@ -60,11 +60,12 @@
 #include "PhysicalEntitySimulation.h"
 
 const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
+const int MESH_BRICK_SIZE = PolyVoxBricks::BRICK_SIZE;
 
 /*
   A PolyVoxEntity has several interdependent parts:
 
-  _voxelData -- compressed QByteArray representation of which voxels have which values
+  _voxelData -- compressed QByteArray representation of which voxels have which values, in bricks (see PolyVoxBricks)
   _volData -- datastructure from the PolyVox library which holds which voxels have which values
   _mesh -- renderable representation of the voxels
   _shape -- used for bullet collisions
@@ -78,13 +79,17 @@ const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
   _meshDirty
 
   In RenderablePolyVoxEntityItem::render, these flags are checked and changes are propagated along the chain.
-  decompressVolumeData() is called to decompress _voxelData into _volData.  recomputeMesh() is called to invoke the
-  polyVox surface extractor to create _mesh (as well as set Simulation _dirtyFlags).  Because Simulation::DIRTY_SHAPE
-  is set, isReadyToComputeShape() gets called and _shape is created either from _volData or _shape, depending on
-  the surface style.
+  decompressVolumeData() is called to decompress _voxelData into _volData.  Only the bricks that differ from the
+  ones already applied (_bricks) are expanded.  recomputeMesh() is called to invoke the polyVox surface extractor to
+  create _mesh (as well as set Simulation _dirtyFlags).  The extractor runs on one 16^3 mesh-brick at a time, and
+  only on the mesh-bricks that contain changed voxels; _mesh is the concatenation of the mesh-bricks.  Because
+  Simulation::DIRTY_SHAPE is set, isReadyToComputeShape() gets called and _shape is created either from _volData or
+  _shape, depending on the surface style.
 
   When a script changes _volData, compressVolumeDataAndSendEditPacket is called to update _voxelData and to
-  send a packet to the entity-server.
+  send a packet to the entity-server.  Only the bricks the script changed are re-encoded, and the edit packet only
+  carries those bricks (a delta) which the entity-server merges into its _voxelData.  Several people can edit
+  different parts of the same polyvox at once without undoing each other's changes.
 
   decompressVolumeData, recomputeMesh, computeShapeInfoWorker, and compressVolumeDataAndSendEditPacket are too expensive
   to run on a thread that has other things to do.  These use QtConcurrent::run to spawn a thread.  As each thread
@@ -155,8 +160,9 @@ bool isEdged(PolyVoxEntityItem::PolyVoxSurfaceStyle surfaceStyle) {
 void RenderablePolyVoxEntityItem::setVoxelData(QByteArray voxelData) {
     // compressed voxel information from the entity-server
     withWriteLock([&] {
-        if (_voxelData != voxelData) {
-            _voxelData = voxelData;
+        QByteArray newVoxelData = PolyVoxBricks::mergeVoxelData(_voxelData, voxelData);
+        if (_voxelData != newVoxelData) {
+            _voxelData = newVoxelData;
             _voxelDataDirty = true;
         }
     });
@@ -188,6 +194,10 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
         } else {
             _volDataDirty = true;
             _voxelSurfaceStyle = voxelSurfaceStyle;
+            if (_volData) {
+                // a different extractor, so every mesh-brick changes
+                markAllMeshBricksDirty();
+            }
         }
     });
 
@@ -275,32 +285,24 @@ void RenderablePolyVoxEntityItem::forEachVoxelValue(quint16 voxelXSize, quint16
     });
 }
 
-QByteArray RenderablePolyVoxEntityItem::volDataToArray(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) const {
-    int totalSize = voxelXSize * voxelYSize * voxelZSize;
-    QByteArray result = QByteArray(totalSize, '\0');
-    int index = 0;
-    int lowX = 0;
-    int lowY = 0;
-    int lowZ = 0;
-
-    withReadLock([&] {
-        if (isEdged(_voxelSurfaceStyle)) {
-            lowX++;
-            lowY++;
-            lowZ++;
-            voxelXSize++;
-            voxelYSize++;
-            voxelZSize++;
-        }
-
-        for (int z = lowZ; z < voxelZSize; z++) {
-            for (int y = lowY; y < voxelYSize; y++) {
-                for (int x = lowX; x < voxelXSize; x++) {
-                    result[index++] = _volData->getVoxelAt(x, y, z);
-                }
+QByteArray RenderablePolyVoxEntityItem::volDataToBrickArray(const PolyVoxBricks& bricks, int brickIndex) const {
+    // the caller read-locks the entity
+    QByteArray result = QByteArray(PolyVoxBricks::VOXELS_PER_BRICK, '\0');
+    int cornerX, cornerY, cornerZ;
+    bricks.getBrickCorner(brickIndex, cornerX, cornerY, cornerZ);
+    int highX = std::min(cornerX + PolyVoxBricks::BRICK_SIZE, (int)bricks.getXSize());
+    int highY = std::min(cornerY + PolyVoxBricks::BRICK_SIZE, (int)bricks.getYSize());
+    int highZ = std::min(cornerZ + PolyVoxBricks::BRICK_SIZE, (int)bricks.getZSize());
+
+    for (int z = cornerZ; z < highZ; z++) {
+        for (int y = cornerY; y < highY; y++) {
+            int index = (z - cornerZ) * PolyVoxBricks::BRICK_SIZE * PolyVoxBricks::BRICK_SIZE +
+                (y - cornerY) * PolyVoxBricks::BRICK_SIZE;
+            for (int x = cornerX; x < highX; x++) {
+                result[index++] = getVoxelInternal(x, y, z);
             }
         }
-    });
+    }
 
     return result;
 }
@@ -953,6 +955,11 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(glm::vec3 voxelVolumeSize)
 
         // having the "outside of voxel-space" value be 255 has helped me notice some problems.
         _volData->setBorderValue(255);
+
+        // the voxel data has to be applied from scratch
+        _bricks = PolyVoxBricks();
+        _dirtyBricks.clear();
+        resetMeshBricks();
     });
 }
 
@@ -1009,19 +1016,31 @@ bool RenderablePolyVoxEntityItem::setVoxelInternal(int x, int y, int z, uint8_t
         return result;
     }
 
+    bool changed = getVoxelInternal(x, y, z) != toValue;
     result = updateOnCount(x, y, z, toValue);
 
+    int volX = x;
+    int volY = y;
+    int volZ = z;
     if (isEdged(_voxelSurfaceStyle)) {
-        _volData->setVoxelAt(x + 1, y + 1, z + 1, toValue);
-    } else {
-        _volData->setVoxelAt(x, y, z, toValue);
+        volX++;
+        volY++;
+        volZ++;
     }
+    _volData->setVoxelAt(volX, volY, volZ, toValue);
 
     if (x == 0 || y == 0 || z == 0) {
         _neighborsNeedUpdate = true;
     }
 
-    _volDataDirty |= result;
+    if (changed) {
+        markMeshBricksDirty(volX, volY, volZ, volX, volY, volZ);
+        // non-edged styles have a layer past the end of the voxel data, for copies of the neighbors' voxels
+        if (x < _bricks.getXSize() && y < _bricks.getYSize() && z < _bricks.getZSize()) {
+            _dirtyBricks.insert(_bricks.getBrickIndex(x, y, z));
+        }
+        _volDataDirty = true;
+    }
 
     return result;
 }
@@ -1051,7 +1070,7 @@ bool RenderablePolyVoxEntityItem::updateOnCount(int x, int y, int z, uint8_t toV
 }
 
 void RenderablePolyVoxEntityItem::decompressVolumeData() {
-    // take compressed data and expand it into _volData.
+    // take compressed data and expand the bricks that changed into _volData.
     QByteArray voxelData;
     auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
@@ -1060,90 +1079,144 @@ void RenderablePolyVoxEntityItem::decompressVolumeData() {
     });
 
     QtConcurrent::run([=] {
-        QDataStream reader(voxelData);
-        quint16 voxelXSize, voxelYSize, voxelZSize;
-        reader >> voxelXSize;
-        reader >> voxelYSize;
-        reader >> voxelZSize;
-
-        if (voxelXSize == 0 || voxelXSize > PolyVoxEntityItem::MAX_VOXEL_DIMENSION ||
-            voxelYSize == 0 || voxelYSize > PolyVoxEntityItem::MAX_VOXEL_DIMENSION ||
-            voxelZSize == 0 || voxelZSize > PolyVoxEntityItem::MAX_VOXEL_DIMENSION) {
-            qCDebug(entities) << "voxelSize is not reasonable, skipping decompressions."
-                     << voxelXSize << voxelYSize << voxelZSize << getName() << getID();
-            entity->setVoxelDataDirty(false);
-            return;
-        }
-        int rawSize = voxelXSize * voxelYSize * voxelZSize;
-
-        QByteArray compressedData;
-        reader >> compressedData;
-
-        QByteArray uncompressedData = qUncompress(compressedData);
-
-        if (uncompressedData.size() != rawSize) {
-            qCDebug(entities) << "PolyVox decompress -- size is (" << voxelXSize << voxelYSize << voxelZSize << ")"
-                     << "so expected uncompressed length of" << rawSize << "but length is" << uncompressedData.size()
-                     << getName() << getID();
+        PolyVoxBricks bricks;
+        if (!bricks.fromVoxelData(voxelData)) {
+            qCDebug(entities) << "PolyVox voxel data can't be read, skipping decompression." << getName() << getID();
             entity->setVoxelDataDirty(false);
             return;
         }
 
-        entity->setVoxelsFromData(uncompressedData, voxelXSize, voxelYSize, voxelZSize);
+        entity->setVoxelsFromBricks(bricks);
     });
 }
 
-void RenderablePolyVoxEntityItem::setVoxelsFromData(QByteArray uncompressedData,
-                                                    quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) {
+void RenderablePolyVoxEntityItem::setVoxelsFromBricks(const PolyVoxBricks& bricks) {
     // this accepts the payload from decompressVolumeData
     withWriteLock([&] {
-        for (int z = 0; z < voxelZSize; z++) {
-            for (int y = 0; y < voxelYSize; y++) {
-                for (int x = 0; x < voxelXSize; x++) {
-                    int uncompressedIndex = (z * voxelYSize * voxelXSize) + (y * voxelZSize) + x;
-                    setVoxelInternal(x, y, z, uncompressedData[uncompressedIndex]);
+        std::vector<int> changedBricks;
+        if (_bricks.hasSize(bricks.getXSize(), bricks.getYSize(), bricks.getZSize())) {
+            changedBricks = bricks.findChangedBricks(_bricks);
+        } else {
+            // the first voxel data since _volData was allocated, or data of another size: write every voxel
+            _bricks = PolyVoxBricks(bricks.getXSize(), bricks.getYSize(), bricks.getZSize());
+            _dirtyBricks.clear();
+            for (int brickIndex = 0; brickIndex < bricks.getNumBricks(); brickIndex++) {
+                changedBricks.push_back(brickIndex);
+            }
+        }
+
+        for (int brickIndex : changedBricks) {
+            if (_dirtyBricks.find(brickIndex) != _dirtyBricks.end()) {
+                // a script changed this brick and its edit hasn't gone out yet.  the entity-server will have our
+                // version of the brick once it has, so don't roll it back in the meantime.
+                continue;
+            }
+
+            QByteArray voxels = bricks.getBrickVoxels(brickIndex);
+            int cornerX, cornerY, cornerZ;
+            bricks.getBrickCorner(brickIndex, cornerX, cornerY, cornerZ);
+            int highX = std::min(cornerX + PolyVoxBricks::BRICK_SIZE, (int)bricks.getXSize());
+            int highY = std::min(cornerY + PolyVoxBricks::BRICK_SIZE, (int)bricks.getYSize());
+            int highZ = std::min(cornerZ + PolyVoxBricks::BRICK_SIZE, (int)bricks.getZSize());
+            for (int z = cornerZ; z < highZ; z++) {
+                for (int y = cornerY; y < highY; y++) {
+                    int index = (z - cornerZ) * PolyVoxBricks::BRICK_SIZE * PolyVoxBricks::BRICK_SIZE +
+                        (y - cornerY) * PolyVoxBricks::BRICK_SIZE;
+                    for (int x = cornerX; x < highX; x++) {
+                        setVoxelInternal(x, y, z, voxels[index++]);
+                    }
                 }
             }
+
+            _bricks.setEncodedBrick(brickIndex, bricks.getEncodedBrick(brickIndex));
+            // setVoxelInternal marked it, but it now matches _voxelData
+            _dirtyBricks.erase(brickIndex);
         }
         _volDataDirty = true;
     });
 }
 
+bool RenderablePolyVoxEntityItem::encodeDirtyBricks(QByteArray& editVoxelData) {
+    // re-encode the bricks that scripts have changed into _voxelData.  editVoxelData is set to what the entity-server
+    // needs to bring its copy up to date.  this is run off the main thread.
+    PolyVoxBricks bricks;
+    std::vector<int> brickIndices;
+    bool wholeVolume = false;
+    withWriteLock([&] {
+        quint16 voxelXSize = _voxelVolumeSize.x;
+        quint16 voxelYSize = _voxelVolumeSize.y;
+        quint16 voxelZSize = _voxelVolumeSize.z;
+        if (_bricks.hasSize(voxelXSize, voxelYSize, voxelZSize)) {
+            bricks = _bricks;
+            brickIndices.assign(_dirtyBricks.begin(), _dirtyBricks.end());
+        } else {
+            // _voxelData is for a volume of another size, so the entity-server can't apply a delta to it
+            wholeVolume = true;
+            bricks = PolyVoxBricks(voxelXSize, voxelYSize, voxelZSize);
+            for (int brickIndex = 0; brickIndex < bricks.getNumBricks(); brickIndex++) {
+                brickIndices.push_back(brickIndex);
+            }
+        }
+        _dirtyBricks.clear();
+    });
+    if (brickIndices.empty()) {
+        return false;
+    }
+
+    withReadLock([&] {
+        for (int brickIndex : brickIndices) {
+            bricks.setBrickVoxels(brickIndex, volDataToBrickArray(bricks, brickIndex));
+        }
+    });
+
+    // make sure the compressed data can be sent over the wire-protocol
+    if (bricks.toVoxelData().size() > 1150) {
+        // HACK -- until we have a way to allow for properties larger than MTU, don't update.
+        qCDebug(entities) << "compressed voxel data is too large" << getName() << getID();
+        if (!wholeVolume) {
+            withWriteLock([&] {
+                _dirtyBricks.insert(brickIndices.begin(), brickIndices.end());
+            });
+        }
+        return false;
+    }
+
+    editVoxelData = wholeVolume ? bricks.toVoxelData() : bricks.toDeltaVoxelData(brickIndices);
+
+    bool committed = false;
+    withWriteLock([&] {
+        if (!bricks.hasSize(_voxelVolumeSize.x, _voxelVolumeSize.y, _voxelVolumeSize.z)) {
+            // the volume was resized while we were encoding
+            return;
+        }
+        if (_bricks.hasSize(bricks.getXSize(), bricks.getYSize(), bricks.getZSize())) {
+            // other bricks may have been encoded by another thread in the meantime, keep them
+            for (int brickIndex : brickIndices) {
+                _bricks.setEncodedBrick(brickIndex, bricks.getEncodedBrick(brickIndex));
+            }
+        } else {
+            _bricks = bricks;
+        }
+        // _volData already has these voxels, so don't set _voxelDataDirty
+        _voxelData = _bricks.toVoxelData();
+        committed = true;
+    });
+    return committed;
+}
+
 void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacket() {
     // compress the data in _volData and save the results.  The compressed form is used during
     // saves to disk and for transmission over the wire to the entity-server
 
     EntityItemPointer entity = getThisPointer();
 
-    quint16 voxelXSize;
-    quint16 voxelYSize;
-    quint16 voxelZSize;
-    withReadLock([&] {
-        voxelXSize = _voxelVolumeSize.x;
-        voxelYSize = _voxelVolumeSize.y;
-        voxelZSize = _voxelVolumeSize.z;
-    });
-
     EntityTreeElementPointer element = getElement();
     EntityTreePointer tree = element ? element->getTree() : nullptr;
 
-    QtConcurrent::run([voxelXSize, voxelYSize, voxelZSize, entity, tree] {
+    QtConcurrent::run([entity, tree] {
         auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QByteArray uncompressedData = polyVoxEntity->volDataToArray(voxelXSize, voxelYSize, voxelZSize);
-
-        QByteArray newVoxelData;
-        QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
-
-        writer << voxelXSize << voxelYSize << voxelZSize;
-
-        QByteArray compressedData = qCompress(uncompressedData, 9);
-        writer << compressedData;
-
-        // make sure the compressed data can be sent over the wire-protocol
-        if (newVoxelData.size() > 1150) {
-            // HACK -- until we have a way to allow for properties larger than MTU, don't update.
-            // revert the active voxel-space to the last version that fit.
-            qCDebug(entities) << "compressed voxel data is too large" << entity->getName() << entity->getID();
+        QByteArray editVoxelData;
+        if (!polyVoxEntity->encodeDirtyBricks(editVoxelData)) {
             return;
         }
 
@@ -1151,14 +1224,15 @@ void RenderablePolyVoxEntityItem::compressVolumeDataAndSendEditPacket() {
         entity->setLastEdited(now);
         entity->setLastBroadcast(now);
 
-        std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->setVoxelData(newVoxelData);
-
+        if (!tree) {
+            return;
+        }
         tree->withReadLock([&] {
             EntityItemProperties properties = entity->getProperties();
-            properties.setVoxelDataDirty();
+            properties.setVoxelData(editVoxelData);
             properties.setLastEdited(now);
 
-            EntitySimulationPointer simulation = tree ? tree->getSimulation() : nullptr;
+            EntitySimulationPointer simulation = tree->getSimulation();
             PhysicalEntitySimulationPointer peSimulation = std::static_pointer_cast<PhysicalEntitySimulation>(simulation);
             EntityEditPacketSender* packetSender = peSimulation ? peSimulation->getPacketSender() : nullptr;
             if (packetSender) {
@@ -1225,6 +1299,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int y = 0; y < _volData->getHeight(); y++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentXPNeighbor->getVoxel(0, y, z);
+                    if (_volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
+                        markMeshBricksDirty(_volData->getWidth() - 1, y, z, _volData->getWidth() - 1, y, z);
+                    }
                     if ((y == 0 || z == 0) && _volData->getVoxelAt(_volData->getWidth() - 1, y, z) != neighborValue) {
                         bonkNeighbors();
                     }
@@ -1240,6 +1317,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int z = 0; z < _volData->getDepth(); z++) {
                     uint8_t neighborValue = currentYPNeighbor->getVoxel(x, 0, z);
+                    if (_volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
+                        markMeshBricksDirty(x, _volData->getHeight() - 1, z, x, _volData->getHeight() - 1, z);
+                    }
                     if ((x == 0 || z == 0) && _volData->getVoxelAt(x, _volData->getHeight() - 1, z) != neighborValue) {
                         bonkNeighbors();
                     }
@@ -1255,6 +1335,9 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
             for (int x = 0; x < _volData->getWidth(); x++) {
                 for (int y = 0; y < _volData->getHeight(); y++) {
                     uint8_t neighborValue = currentZPNeighbor->getVoxel(x, y, 0);
+                    if (_volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
+                        markMeshBricksDirty(x, y, _volData->getDepth() - 1, x, y, _volData->getDepth() - 1);
+                    }
                     _volData->setVoxelAt(x, y, _volData->getDepth() - 1, neighborValue);
                     if ((x == 0 || y == 0) && _volData->getVoxelAt(x, y, _volData->getDepth() - 1) != neighborValue) {
                         bonkNeighbors();
@@ -1266,94 +1349,208 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
     }
 }
 
+void RenderablePolyVoxEntityItem::resetMeshBricks() {
+    // lay out the mesh-bricks for a newly allocated _volData.  the caller write-locks the entity.
+    // the extractors work on the cells between voxels, so a volume N voxels wide is N - 1 cells wide.
+    int width = _volData->getWidth();
+    int height = _volData->getHeight();
+    int depth = _volData->getDepth();
+    _numMeshBricksX = std::max(1, (width - 1 + MESH_BRICK_SIZE - 1) / MESH_BRICK_SIZE);
+    _numMeshBricksY = std::max(1, (height - 1 + MESH_BRICK_SIZE - 1) / MESH_BRICK_SIZE);
+    _numMeshBricksZ = std::max(1, (depth - 1 + MESH_BRICK_SIZE - 1) / MESH_BRICK_SIZE);
+
+    _meshBricks.clear();
+    _meshBricks.resize(_numMeshBricksX * _numMeshBricksY * _numMeshBricksZ);
+    _dirtyMeshBricks.clear();
+    for (int z = 0; z < _numMeshBricksZ; z++) {
+        for (int y = 0; y < _numMeshBricksY; y++) {
+            for (int x = 0; x < _numMeshBricksX; x++) {
+                int meshBrickIndex = x + y * _numMeshBricksX + z * _numMeshBricksX * _numMeshBricksY;
+                // neighboring regions share their boundary voxels, the corners are inclusive
+                PolyVox::Vector3DInt32 lowCorner(x * MESH_BRICK_SIZE, y * MESH_BRICK_SIZE, z * MESH_BRICK_SIZE);
+                PolyVox::Vector3DInt32 highCorner(std::min((x + 1) * MESH_BRICK_SIZE, width - 1),
+                                                  std::min((y + 1) * MESH_BRICK_SIZE, height - 1),
+                                                  std::min((z + 1) * MESH_BRICK_SIZE, depth - 1));
+                _meshBricks[meshBrickIndex].region = PolyVox::Region(lowCorner, highCorner);
+                markMeshBrickDirty(meshBrickIndex);
+            }
+        }
+    }
+}
+
+void RenderablePolyVoxEntityItem::markMeshBrickDirty(int meshBrickIndex) {
+    _meshBricks[meshBrickIndex].generation = ++_meshGeneration;
+    _dirtyMeshBricks.insert(meshBrickIndex);
+}
+
+void RenderablePolyVoxEntityItem::markMeshBricksDirty(int lowX, int lowY, int lowZ, int highX, int highY, int highZ) {
+    // mark the mesh-bricks that see the voxels between low and high (inclusive, in _volData coords).  the
+    // marching-cubes normals come from the voxels on either side of a cell corner, so the range grows by one voxel.
+    // the caller write-locks the entity.
+    if (_meshBricks.empty()) {
+        return;
+    }
+    int firstX = std::max(0, (lowX - 2) / MESH_BRICK_SIZE);
+    int firstY = std::max(0, (lowY - 2) / MESH_BRICK_SIZE);
+    int firstZ = std::max(0, (lowZ - 2) / MESH_BRICK_SIZE);
+    int lastX = std::min(_numMeshBricksX - 1, (highX + 1) / MESH_BRICK_SIZE);
+    int lastY = std::min(_numMeshBricksY - 1, (highY + 1) / MESH_BRICK_SIZE);
+    int lastZ = std::min(_numMeshBricksZ - 1, (highZ + 1) / MESH_BRICK_SIZE);
+    for (int z = firstZ; z <= lastZ; z++) {
+        for (int y = firstY; y <= lastY; y++) {
+            for (int x = firstX; x <= lastX; x++) {
+                markMeshBrickDirty(x + y * _numMeshBricksX + z * _numMeshBricksX * _numMeshBricksY);
+            }
+        }
+    }
+}
+
+void RenderablePolyVoxEntityItem::markAllMeshBricksDirty() {
+    for (int meshBrickIndex = 0; meshBrickIndex < (int)_meshBricks.size(); meshBrickIndex++) {
+        markMeshBrickDirty(meshBrickIndex);
+    }
+}
+
 void RenderablePolyVoxEntityItem::recomputeMesh() {
     // use _volData to make a renderable mesh
+    cacheNeighbors();
+    copyUpperEdgesFromNeighbors();
+
     PolyVoxSurfaceStyle voxelSurfaceStyle;
-    withReadLock([&] {
+    std::vector<std::pair<int, quint32>> bricksToExtract;
+    withWriteLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
+        for (int meshBrickIndex : _dirtyMeshBricks) {
+            bricksToExtract.emplace_back(meshBrickIndex, _meshBricks[meshBrickIndex].generation);
+        }
+        _dirtyMeshBricks.clear();
     });
 
-    cacheNeighbors();
-    copyUpperEdgesFromNeighbors();
-
     auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
-    QtConcurrent::run([entity, voxelSurfaceStyle] {
-        model::MeshPointer mesh(new model::Mesh());
+    QtConcurrent::run([entity, voxelSurfaceStyle, bricksToExtract] {
+        entity->extractMeshBricks(voxelSurfaceStyle, bricksToExtract);
+    });
+}
+
+void RenderablePolyVoxEntityItem::extractMeshBricks(PolyVoxSurfaceStyle voxelSurfaceStyle,
+                                                   const std::vector<std::pair<int, quint32>>& bricksToExtract) {
+    // this is run off the main thread by recomputeMesh
+    std::vector<std::pair<int, MeshBrick>> extractedBricks;
+    withReadLock([&] {
+        for (const auto& brickToExtract : bricksToExtract) {
+            int meshBrickIndex = brickToExtract.first;
+            if (meshBrickIndex >= (int)_meshBricks.size() ||
+                _meshBricks[meshBrickIndex].generation != brickToExtract.second) {
+                // the brick has been marked again since (or _volData was reallocated), a later
+                // recomputeMesh will extract it
+                continue;
+            }
 
-        // A mesh object to hold the result of surface extraction
-        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+            extractedBricks.emplace_back(meshBrickIndex, MeshBrick());
+            MeshBrick& meshBrick = extractedBricks.back().second;
+            meshBrick.region = _meshBricks[meshBrickIndex].region;
+            meshBrick.generation = brickToExtract.second;
 
-        entity->withReadLock([&] {
-            PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
             switch (voxelSurfaceStyle) {
-                case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES: {
-                    PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
+                case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
                 case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
                     PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
-                    surfaceExtractor.execute();
-                    break;
-                }
-                case PolyVoxEntityItem::SURFACE_EDGED_CUBIC: {
-                    PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
+                        (_volData, meshBrick.region, &meshBrick.mesh);
                     surfaceExtractor.execute();
                     break;
                 }
+                case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
                 case PolyVoxEntityItem::SURFACE_CUBIC: {
                     PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
+                        (_volData, meshBrick.region, &meshBrick.mesh);
                     surfaceExtractor.execute();
                     break;
                 }
             }
-        });
+        }
+    });
+
+    setMeshBricks(extractedBricks);
+}
 
-        // convert PolyVox mesh to a Sam mesh
-        const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
-        auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
-                                                         (gpu::Byte*)vecIndices.data());
-        auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
-        gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
-        mesh->setIndexBuffer(indexBufferView);
-
-        const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getRawVertexData();
-        auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
-                                                          (gpu::Byte*)vecVertices.data());
-        auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
-        gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
-                                         vertexBufferPtr->getSize(),
-                                         sizeof(PolyVox::PositionMaterialNormal),
-                                         gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-        mesh->setVertexBuffer(vertexBufferView);
-
-
-        // TODO -- use 3-byte normals rather than 3-float normals
-        mesh->addAttribute(gpu::Stream::NORMAL,
-                           gpu::BufferView(vertexBufferPtr,
-                                           sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
-                                           vertexBufferPtr->getSize(),
-                                           sizeof(PolyVox::PositionMaterialNormal),
-                                           gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
-
-        std::vector<model::Mesh::Part> parts;
-        parts.emplace_back(model::Mesh::Part((model::Index)0, // startIndex
-                                             (model::Index)vecIndices.size(), // numIndices
-                                             (model::Index)0, // baseVertex
-                                             model::Mesh::TRIANGLES)); // topology
-        mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(model::Mesh::Part),
-                                                            (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
-        entity->setMesh(mesh);
+void RenderablePolyVoxEntityItem::setMeshBricks(std::vector<std::pair<int, MeshBrick>>& extractedBricks) {
+    // this catches the payload from extractMeshBricks
+    withWriteLock([&] {
+        for (auto& extractedBrick : extractedBricks) {
+            int meshBrickIndex = extractedBrick.first;
+            if (meshBrickIndex < (int)_meshBricks.size() &&
+                _meshBricks[meshBrickIndex].generation == extractedBrick.second.generation) {
+                _meshBricks[meshBrickIndex].mesh = std::move(extractedBrick.second.mesh);
+            }
+        }
     });
+
+    // stitch the mesh-bricks together.  the extractors make vertices relative to the low corner of their region.
+    std::vector<PolyVox::PositionMaterialNormal> vecVertices;
+    std::vector<uint32_t> vecIndices;
+    withReadLock([&] {
+        size_t numVertices = 0;
+        size_t numIndices = 0;
+        for (const MeshBrick& meshBrick : _meshBricks) {
+            numVertices += meshBrick.mesh.getRawVertexData().size();
+            numIndices += meshBrick.mesh.getIndices().size();
+        }
+        vecVertices.reserve(numVertices);
+        vecIndices.reserve(numIndices);
+
+        for (const MeshBrick& meshBrick : _meshBricks) {
+            uint32_t baseVertex = (uint32_t)vecVertices.size();
+            const PolyVox::Vector3DInt32& lowCorner = meshBrick.region.getLowerCorner();
+            PolyVox::Vector3DFloat offset((float)lowCorner.getX(), (float)lowCorner.getY(), (float)lowCorner.getZ());
+            for (PolyVox::PositionMaterialNormal vertex : meshBrick.mesh.getRawVertexData()) {
+                vertex.setPosition(vertex.getPosition() + offset);
+                vecVertices.push_back(vertex);
+            }
+            for (uint32_t index : meshBrick.mesh.getIndices()) {
+                vecIndices.push_back(baseVertex + index);
+            }
+        }
+    });
+
+    // convert PolyVox mesh to a Sam mesh
+    model::MeshPointer mesh(new model::Mesh());
+    auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
+                                                     (gpu::Byte*)vecIndices.data());
+    auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
+    gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
+    mesh->setIndexBuffer(indexBufferView);
+
+    auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
+                                                      (gpu::Byte*)vecVertices.data());
+    auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
+    gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
+                                     vertexBufferPtr->getSize(),
+                                     sizeof(PolyVox::PositionMaterialNormal),
+                                     gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+    mesh->setVertexBuffer(vertexBufferView);
+
+
+    // TODO -- use 3-byte normals rather than 3-float normals
+    mesh->addAttribute(gpu::Stream::NORMAL,
+                       gpu::BufferView(vertexBufferPtr,
+                                       sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
+                                       vertexBufferPtr->getSize(),
+                                       sizeof(PolyVox::PositionMaterialNormal),
+                                       gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+
+    std::vector<model::Mesh::Part> parts;
+    parts.emplace_back(model::Mesh::Part((model::Index)0, // startIndex
+                                         (model::Index)vecIndices.size(), // numIndices
+                                         (model::Index)0, // baseVertex
+                                         model::Mesh::TRIANGLES)); // topology
+    mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(model::Mesh::Part),
+                                                        (gpu::Byte*) parts.data()), gpu::Element::PART_DRAWCALL));
+    setMesh(mesh);
 }
 
 void RenderablePolyVoxEntityItem::setMesh(model::MeshPointer mesh) {
-    // this catches the payload from recomputeMesh
+    // this catches the payload from setMeshBricks
     bool neighborsNeedUpdate;
     withWriteLock([&] {
         if (!_collisionless) {
@@ -13,15 +13,27 @@
 #define hifi_RenderablePolyVoxEntityItem_h
 
 #include <atomic>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include <QSemaphore>
 
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning( disable : 4267 )
+#endif
 #include <PolyVoxCore/SimpleVolume.h>
 #include <PolyVoxCore/Raycast.h>
+#include <PolyVoxCore/SurfaceMesh.h>
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
 
 #include <gpu/Context.h>
 #include <model/Forward.h>
 #include <TextureCache.h>
+#include <PolyVoxBricks.h>
 #include <PolyVoxEntityItem.h>
 
 #include "RenderableEntityItem.h"
@@ -147,12 +159,15 @@ public:
 
     virtual void updateRegistrationPoint(const glm::vec3& value) override;
 
-    void setVoxelsFromData(QByteArray uncompressedData, quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize);
+    void setVoxelsFromBricks(const PolyVoxBricks& bricks);
     void forEachVoxelValue(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize,
                            std::function<void(int, int, int, uint8_t)> thunk);
-    QByteArray volDataToArray(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) const;
+    QByteArray volDataToBrickArray(const PolyVoxBricks& bricks, int brickIndex) const;
+    bool encodeDirtyBricks(QByteArray& editVoxelData);
 
     void setMesh(model::MeshPointer mesh);
+    void extractMeshBricks(PolyVoxSurfaceStyle voxelSurfaceStyle,
+                           const std::vector<std::pair<int, quint32>>& bricksToExtract);
     void setCollisionPoints(ShapeInfo::PointCollection points, AABox box);
     PolyVox::SimpleVolume<uint8_t>* getVolData() { return _volData; }
 
@@ -192,6 +207,30 @@ private:
 
     bool _neighborsNeedUpdate { false };
 
+    // _voxelData as bricks, as far as it has been applied to _volData
+    PolyVoxBricks _bricks;
+    // bricks that scripts have changed in _volData since they were last encoded into _bricks
+    std::set<int> _dirtyBricks;
+
+    // the mesh is extracted from _volData a brick at a time, and only the bricks with changed voxels are extracted
+    // again.  mesh-bricks are laid out in _volData coords, so they include the extra layer of edged styles.
+    struct MeshBrick {
+        PolyVox::Region region;
+        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> mesh;
+        quint32 generation { 0 }; // changes each time the brick is marked dirty
+    };
+    std::vector<MeshBrick> _meshBricks;
+    std::set<int> _dirtyMeshBricks;
+    int _numMeshBricksX { 0 };
+    int _numMeshBricksY { 0 };
+    int _numMeshBricksZ { 0 };
+    quint32 _meshGeneration { 0 };
+    void resetMeshBricks();
+    void markMeshBrickDirty(int meshBrickIndex);
+    void markMeshBricksDirty(int lowX, int lowY, int lowZ, int highX, int highY, int highZ);
+    void markAllMeshBricksDirty();
+    void setMeshBricks(std::vector<std::pair<int, MeshBrick>>& extractedBricks);
+
     bool updateOnCount(int x, int y, int z, uint8_t toValue);
     PolyVox::RaycastResult doRayCast(glm::vec4 originInVoxel, glm::vec4 farInVoxel, glm::vec4& result) const;
 
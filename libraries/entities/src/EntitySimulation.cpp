@@ -10,10 +10,12 @@
 //
 
 #include <AACube.h>
+#include <TBBHelpers.h>
 
 #include "EntitySimulation.h"
 #include "EntitiesLogging.h"
 #include "MovingEntitiesOperator.h"
+#include "ParticleEffectEntityItem.h"
 
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
@@ -123,6 +125,7 @@ void EntitySimulation::expireMortalEntities(const quint64& now) {
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     PerformanceTimer perfTimer("updatingEntities");
     QMutexLocker lock(&_mutex);
+    stepParticleEffects(now);
     SetOfEntities::iterator itemItr = _entitiesToUpdate.begin();
     while (itemItr != _entitiesToUpdate.end()) {
         EntityItemPointer entity = *itemItr;
@@ -137,6 +140,31 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     }
 }
 
+// protected
+void EntitySimulation::stepParticleEffects(const quint64& now) {
+    // the particles of one emitter don't depend on anything another emitter changes, so they are stepped across the
+    // task pool here and update() finds them already stepped
+    _particleEffectsToStep.clear();
+    for (auto& entity : _entitiesToUpdate) {
+        if (entity->getType() == EntityTypes::ParticleEffect && entity->needsToCallUpdate()) {
+            _particleEffectsToStep.push_back(std::static_pointer_cast<ParticleEffectEntityItem>(entity).get());
+        }
+    }
+    if (_particleEffectsToStep.size() < 2) {
+        _particleEffectsToStep.clear();
+        return;
+    }
+
+    PerformanceTimer perfTimer("stepParticles");
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _particleEffectsToStep.size(), 1),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                _particleEffectsToStep[i]->stepParticles(now);
+            }
+        });
+    _particleEffectsToStep.clear();
+}
+
 // protected
 void EntitySimulation::sortEntitiesThatMoved() {
     // NOTE: this is only for entities that have been moved by THIS EntitySimulation.
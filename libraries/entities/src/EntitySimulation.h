@@ -12,6 +12,8 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
+#include <vector>
+
 #include <QtCore/QObject>
 #include <QSet>
 #include <QVector>
@@ -42,6 +44,8 @@ const int DIRTY_SIMULATION_FLAGS =
         Simulation::DIRTY_MATERIAL |
         Simulation::DIRTY_SIMULATOR_ID;
 
+class ParticleEffectEntityItem;
+
 class EntitySimulation : public QObject, public std::enable_shared_from_this<EntitySimulation> {
 Q_OBJECT
 public:
@@ -97,6 +101,7 @@ protected:
 
     void expireMortalEntities(const quint64& now);
     void callUpdateOnEntitiesThatNeedIt(const quint64& now);
+    void stepParticleEffects(const quint64& now);
     virtual void sortEntitiesThatMoved();
 
     QMutex _mutex{ QMutex::Recursive };
@@ -123,6 +128,7 @@ private:
 
 
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
+    std::vector<ParticleEffectEntityItem*> _particleEffectsToStep; // scratch for stepParticleEffects()
 
 };
 
@@ -108,6 +108,7 @@ ParticleEffectEntityItem::ParticleEffectEntityItem(const EntityItemID& entityIte
 {
     _type = EntityTypes::ParticleEffect;
     setColor(DEFAULT_COLOR);
+    _particles.setCapacity(_maxParticles);
 }
 
 void ParticleEffectEntityItem::setAlpha(float alpha) {
@@ -550,7 +551,7 @@ void ParticleEffectEntityItem::appendSubclassData(OctreePacketData* packetData,
 
 bool ParticleEffectEntityItem::isEmittingParticles() const {
     // keep emitting if there are particles still alive.
-    return (getIsEmitting() || !_particles.empty());
+    return (getIsEmitting() || !_particles.isEmpty());
 }
 
 bool ParticleEffectEntityItem::needsToCallUpdate() const {
@@ -558,7 +559,15 @@ bool ParticleEffectEntityItem::needsToCallUpdate() const {
 }
 
 void ParticleEffectEntityItem::update(const quint64& now) {
+    // the particles may already have been stepped to now, along with those of other emitters
+    if (now != _lastSimulated) {
+        stepParticles(now);
+    }
+
+    EntityItem::update(now); // let our base class handle it's updates...
+}
 
+void ParticleEffectEntityItem::stepParticles(const quint64& now) {
     // we check for 'now' in the past in case users set their clock backward
     if (now < _lastSimulated) {
         _lastSimulated = now;
@@ -571,8 +580,6 @@ void ParticleEffectEntityItem::update(const quint64& now) {
     if (isEmittingParticles()) {
         stepSimulation(deltaTime);
     }
-
-    EntityItem::update(now); // let our base class handle it's updates...
 }
 
 void ParticleEffectEntityItem::debugDump() const {
@@ -591,133 +598,31 @@ void ParticleEffectEntityItem::setShapeType(ShapeType type) {
     }
 }
 
-void ParticleEffectEntityItem::integrateParticle(Particle& particle, float deltaTime) {
-    glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * particle.acceleration;
-    glm::vec3 at = particle.acceleration * deltaTime;
-    particle.position += particle.velocity * deltaTime + atSquared;
-    particle.velocity += at;
+ParticleEmitter ParticleEffectEntityItem::getEmitter() const {
+    ParticleEmitter emitter;
+    emitter.isEmitting = getIsEmitting();
+    emitter.shouldTrail = getEmitterShouldTrail();
+    emitter.maxParticles = _maxParticles;
+    emitter.lifespan = _lifespan;
+    emitter.emitRate = _emitRate;
+    emitter.emitSpeed = _emitSpeed;
+    emitter.speedSpread = _speedSpread;
+    emitter.emitOrientation = _emitOrientation;
+    emitter.emitDimensions = _emitDimensions;
+    emitter.emitRadiusStart = _emitRadiusStart;
+    emitter.emitAcceleration = _emitAcceleration;
+    emitter.accelerationSpread = _accelerationSpread;
+    emitter.polarStart = _polarStart;
+    emitter.polarFinish = _polarFinish;
+    emitter.azimuthStart = _azimuthStart;
+    emitter.azimuthFinish = _azimuthFinish;
+    return emitter;
 }
 
 void ParticleEffectEntityItem::stepSimulation(float deltaTime) {
-    // update particles between head and tail
-    int popCount = 0;
-    for (Particle& particle : _particles) {
-        particle.lifetime += deltaTime;
-
-        // if particle has died.
-        if (particle.lifetime >= _lifespan) {
-            // move head forward
-            popCount++;
-        } else {
-            // Otherwise update it
-            integrateParticle(particle, deltaTime);
-        }
-    }
-    _particles.erase(_particles.begin(), _particles.begin() + popCount);
-
-    // emit new particles, but only if we are emmitting
-    if (getIsEmitting() && _emitRate > 0.0f && _lifespan > 0.0f && _polarStart <= _polarFinish) {
-
-        float timeLeftInFrame = deltaTime;
-        while (_timeUntilNextEmit < timeLeftInFrame) {
-            // overflow! move head forward by one.
-            // because the case of head == tail indicates an empty array, not a full one.
-            // This can drop an existing older particle, but this is by design, newer particles are a higher priority.
-            if (_particles.size() >= _maxParticles) {
-                _particles.pop_front();
-            }
-            
-            // emit a new particle at tail index.
-            _particles.push_back(createParticle(glm::mix(_previousPosition, getPosition(),
-                (deltaTime - timeLeftInFrame) / deltaTime)));
-            auto particle = _particles.back();
-            particle.lifetime += timeLeftInFrame;
-            
-            // Initialize it
-            integrateParticle(particle, deltaTime);
-            
-            // Advance in frame
-            timeLeftInFrame -= _timeUntilNextEmit;
-            _timeUntilNextEmit = 1.0f / _emitRate;
-        }
-
-        _timeUntilNextEmit -= timeLeftInFrame;
-    }
-    _previousPosition = getPosition();
-}
-
-ParticleEffectEntityItem::Particle ParticleEffectEntityItem::createParticle(const glm::vec3& position) {
-    Particle particle;
-
- 
-    particle.seed = randFloatInRange(-1.0f, 1.0f);
-    if (getEmitterShouldTrail()) {
-        particle.position = position;
-    }
-    // Position, velocity, and acceleration
-    if (_polarStart == 0.0f && _polarFinish == 0.0f && _emitDimensions.z == 0.0f) {
-        // Emit along z-axis from position
-
-        particle.velocity = (_emitSpeed + 0.2f * _speedSpread) * (_emitOrientation * Vectors::UNIT_Z);
-        particle.acceleration = _emitAcceleration + randFloatInRange(-1.0f, 1.0f) * _accelerationSpread;
-        
-    } else {
-        // Emit around point or from ellipsoid
-        // - Distribute directions evenly around point
-        // - Distribute points relatively evenly over ellipsoid surface
-        // - Distribute points relatively evenly within ellipsoid volume
-        
-        float elevationMinZ = sin(PI_OVER_TWO - _polarFinish);
-        float elevationMaxZ = sin(PI_OVER_TWO - _polarStart);
-      //  float elevation = asin(elevationMinZ + (elevationMaxZ - elevationMinZ) * randFloat());
-        float elevation = asin(elevationMinZ + (elevationMaxZ - elevationMinZ) *randFloat());
-        
-        float azimuth;
-        if (_azimuthFinish >= _azimuthStart) {
-            azimuth = _azimuthStart + (_azimuthFinish - _azimuthStart) *  randFloat();
-        } else {
-            azimuth = _azimuthStart + (TWO_PI + _azimuthFinish - _azimuthStart) * randFloat();
-        }
-        
-        glm::vec3 emitDirection;
-        
-        if (_emitDimensions == Vectors::ZERO) {
-            // Point
-            emitDirection = glm::quat(glm::vec3(PI_OVER_TWO - elevation, 0.0f, azimuth)) * Vectors::UNIT_Z;
-        } else {
-            // Ellipsoid
-            float radiusScale = 1.0f;
-            if (_emitRadiusStart < 1.0f) {
-                float emitRadiusStart = glm::max(_emitRadiusStart, EPSILON);  // Avoid math complications at center
-                float randRadius =
-                emitRadiusStart + randFloatInRange(0.0f, MAXIMUM_EMIT_RADIUS_START - emitRadiusStart);
-                radiusScale = 1.0f - std::pow(1.0f - randRadius, 3.0f);
-            }
-            
-            glm::vec3 radii = radiusScale * 0.5f * _emitDimensions;
-            float x = radii.x * glm::cos(elevation) * glm::cos(azimuth);
-            float y = radii.y * glm::cos(elevation) * glm::sin(azimuth);
-            float z = radii.z * glm::sin(elevation);
-            glm::vec3 emitPosition = glm::vec3(x, y, z);
-            emitDirection = glm::normalize(glm::vec3(
-                radii.x > 0.0f ? x / (radii.x * radii.x) : 0.0f,
-                radii.y > 0.0f ? y / (radii.y * radii.y) : 0.0f,
-                radii.z > 0.0f ? z / (radii.z * radii.z) : 0.0f
-            ));
-            
-            if (getEmitterShouldTrail()) {
-                particle.position += _emitOrientation * emitPosition;
-            }
-            else {
-                particle.position = _emitOrientation * emitPosition;
-            }
-        }
-        
-        particle.velocity = (_emitSpeed + randFloatInRange(-1.0f, 1.0f) * _speedSpread) * (_emitOrientation * emitDirection);
-        particle.acceleration = _emitAcceleration + randFloatInRange(-1.0f, 1.0f) * _accelerationSpread;
-    }
-    
-    return particle;
+    glm::vec3 position = getPosition();
+    _particles.step(getEmitter(), _previousPosition, position, deltaTime);
+    _previousPosition = position;
 }
 
 void ParticleEffectEntityItem::setMaxParticles(quint32 maxParticles) {
@@ -725,12 +630,10 @@ void ParticleEffectEntityItem::setMaxParticles(quint32 maxParticles) {
         _maxParticles = maxParticles;
 
         // Pop all the overflowing oldest particles
-        while (_particles.size() > _maxParticles) {
-            _particles.pop_front();
-        }
+        _particles.setCapacity(_maxParticles);
 
         // effectively clear all particles and start emitting new ones from scratch.
-        _timeUntilNextEmit = 0.0f;
+        _particles.restartEmission();
     }
 }
 
@@ -11,11 +11,10 @@
 #ifndef hifi_ParticleEffectEntityItem_h
 #define hifi_ParticleEffectEntityItem_h
 
-#include <deque>
-
 #include "EntityItem.h"
 
 #include "ColorUtils.h"
+#include "ParticleSystem.h"
 
 class ParticleEffectEntityItem : public EntityItem {
 public:
@@ -45,6 +44,10 @@ public:
                                                  bool& somethingChanged) override;
 
     virtual void update(const quint64& now) override;
+
+    /// steps the particles up to now, independently of every other entity so that many emitters can be stepped in
+    /// parallel before their update() is called
+    void stepParticles(const quint64& now);
     virtual bool needsToCallUpdate() const override;
 
     const rgbColor& getColor() const { return _color; }
@@ -217,25 +220,13 @@ public:
     virtual bool supportsDetailedRayIntersection() const override { return false; }
 
 protected:
-    struct Particle;
-    using Particles = std::deque<Particle>;
-
     bool isAnimatingSomething() const;
-    
-    Particle createParticle(const glm::vec3& position);
+
     void stepSimulation(float deltaTime);
-    void integrateParticle(Particle& particle, float deltaTime);
-    
-    struct Particle {
-        float seed { 0.0f };
-        float lifetime { 0.0f };
-        glm::vec3 position { Vectors::ZERO };
-        glm::vec3 velocity { Vectors::ZERO };
-        glm::vec3 acceleration { Vectors::ZERO };
-    };
-    
+    ParticleEmitter getEmitter() const;
+
     // Particles container
-    Particles _particles;
+    ParticleSystem _particles;
     
     // Particles properties
     rgbColor _color;
@@ -278,7 +269,6 @@ protected:
     bool _texturesChangedFlag { false };
     ShapeType _shapeType { SHAPE_TYPE_NONE };
     
-    float _timeUntilNextEmit { 0.0f };
 
     
     bool _emitterShouldTrail { DEFAULT_EMITTER_SHOULD_TRAIL };
@@ -0,0 +1,403 @@
+//
+//  ParticleSystem.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define PARTICLE_SYSTEM_SSE
+#include <emmintrin.h>
+#endif
+
+static const int MIN_STORAGE_SIZE = 64;
+
+// seed, elevation, azimuth, radius, speed, acceleration
+static const int RANDOMS_PER_PARTICLE = 6;
+
+static uint32_t hashSeed(uint32_t value) {
+    // the finalizer of murmur3, so that neighbouring seeds give unrelated lanes
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+    return value;
+}
+
+ParticleRandom::ParticleRandom(uint32_t seed) {
+    this->seed(seed);
+}
+
+void ParticleRandom::seed(uint32_t seed) {
+    for (int lane = 0; lane < NUM_LANES; lane++) {
+        _state[lane] = hashSeed(seed + lane * 0x9e3779b9);
+        if (_state[lane] == 0) {
+            // xorshift never leaves zero
+            _state[lane] = 0x6b8b4567 + lane;
+        }
+    }
+    _numSpare = 0;
+}
+
+void ParticleRandom::fill(float* values, int count) {
+    const float TO_UNIT = 1.0f / 16777216.0f; // the top 24 bits make a float in [0, 1)
+
+    while (_numSpare > 0 && count > 0) {
+        *values++ = _spare[NUM_LANES - _numSpare];
+        --_numSpare;
+        --count;
+    }
+    if (count == 0) {
+        return;
+    }
+
+#ifdef PARTICLE_SYSTEM_SSE
+    __m128i state = _mm_loadu_si128((const __m128i*)_state);
+    const __m128 toUnit = _mm_set1_ps(TO_UNIT);
+    while (count > 0) {
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+        state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+        __m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(state, 8)), toUnit);
+        if (count >= NUM_LANES) {
+            _mm_storeu_ps(values, unit);
+            values += NUM_LANES;
+            count -= NUM_LANES;
+        } else {
+            _mm_storeu_ps(_spare, unit);
+            for (int lane = 0; lane < count; lane++) {
+                values[lane] = _spare[lane];
+            }
+            _numSpare = NUM_LANES - count;
+            count = 0;
+        }
+    }
+    _mm_storeu_si128((__m128i*)_state, state);
+#else
+    while (count > 0) {
+        float unit[NUM_LANES];
+        for (int lane = 0; lane < NUM_LANES; lane++) {
+            uint32_t x = _state[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            _state[lane] = x;
+            unit[lane] = (float)(x >> 8) * TO_UNIT;
+        }
+        if (count >= NUM_LANES) {
+            std::copy(unit, unit + NUM_LANES, values);
+            values += NUM_LANES;
+            count -= NUM_LANES;
+        } else {
+            std::copy(unit, unit + NUM_LANES, _spare);
+            std::copy(unit, unit + count, values);
+            _numSpare = NUM_LANES - count;
+            count = 0;
+        }
+    }
+#endif
+}
+
+// position += velocity * dt + acceleration * dt^2 / 2, velocity += acceleration * dt, along one axis
+static void integrateAxis(float* position, float* velocity, const float* acceleration, int begin, int end,
+                          float deltaTime) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    int i = begin;
+#ifdef PARTICLE_SYSTEM_SSE
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 halfDt2 = _mm_set1_ps(halfDeltaTimeSquared);
+    for (; i + 4 <= end; i += 4) {
+        __m128 p = _mm_loadu_ps(position + i);
+        __m128 v = _mm_loadu_ps(velocity + i);
+        __m128 a = _mm_loadu_ps(acceleration + i);
+        p = _mm_add_ps(_mm_add_ps(p, _mm_mul_ps(v, dt)), _mm_mul_ps(a, halfDt2));
+        v = _mm_add_ps(v, _mm_mul_ps(a, dt));
+        _mm_storeu_ps(position + i, p);
+        _mm_storeu_ps(velocity + i, v);
+    }
+#endif
+    for (; i < end; i++) {
+        position[i] = (position[i] + velocity[i] * deltaTime) + acceleration[i] * halfDeltaTimeSquared;
+        velocity[i] = velocity[i] + acceleration[i] * deltaTime;
+    }
+}
+
+static void ageParticles(float* lifetime, int begin, int end, float deltaTime) {
+    int i = begin;
+#ifdef PARTICLE_SYSTEM_SSE
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (; i + 4 <= end; i += 4) {
+        _mm_storeu_ps(lifetime + i, _mm_add_ps(_mm_loadu_ps(lifetime + i), dt));
+    }
+#endif
+    for (; i < end; i++) {
+        lifetime[i] += deltaTime;
+    }
+}
+
+ParticleSystem::ParticleSystem() {
+    // every system gets its own sequence
+    static std::atomic<uint32_t> nextSeed { 1 };
+    _random.seed(nextSeed++);
+}
+
+void ParticleSystem::setCapacity(uint32_t capacity) {
+    _capacity = std::max(capacity, 1u);
+    if ((uint32_t)_storageSize > _capacity) {
+        resizeStorage((int)_capacity);
+    }
+}
+
+void ParticleSystem::clear() {
+    _head = 0;
+    _count = 0;
+    _timeUntilNextEmit = 0.0f;
+}
+
+glm::vec3 ParticleSystem::getPosition(int index) const {
+    int slot = toSlot(index);
+    return glm::vec3(_positionX[slot], _positionY[slot], _positionZ[slot]);
+}
+
+glm::vec3 ParticleSystem::getVelocity(int index) const {
+    int slot = toSlot(index);
+    return glm::vec3(_velocityX[slot], _velocityY[slot], _velocityZ[slot]);
+}
+
+int ParticleSystem::toSlot(int index) const {
+    int slot = _head + index;
+    return (slot < _storageSize) ? slot : slot - _storageSize;
+}
+
+void ParticleSystem::resizeStorage(int size) {
+    // keep the newest particles that fit, starting the ring over at the front of the new storage
+    int keep = std::min(_count, size);
+    int first = _count - keep;
+    auto resizeArray = [&](std::vector<float>& values) {
+        std::vector<float> resized(size);
+        for (int i = 0; i < keep; i++) {
+            resized[i] = values[toSlot(first + i)];
+        }
+        values.swap(resized);
+    };
+    resizeArray(_seed);
+    resizeArray(_lifetime);
+    resizeArray(_positionX);
+    resizeArray(_positionY);
+    resizeArray(_positionZ);
+    resizeArray(_velocityX);
+    resizeArray(_velocityY);
+    resizeArray(_velocityZ);
+    resizeArray(_accelerationX);
+    resizeArray(_accelerationY);
+    resizeArray(_accelerationZ);
+
+    _storageSize = size;
+    _head = 0;
+    _count = keep;
+}
+
+int ParticleSystem::pushSlot() {
+    if (_count == _storageSize) {
+        if ((uint32_t)_storageSize < _capacity) {
+            int size = std::max(MIN_STORAGE_SIZE, 2 * _storageSize);
+            resizeStorage((int)std::min((uint32_t)size, _capacity));
+        } else {
+            // overflow! drop the oldest particle
+            _head = toSlot(1);
+            --_count;
+        }
+    }
+    int slot = toSlot(_count);
+    ++_count;
+    return slot;
+}
+
+void ParticleSystem::integrate(int begin, int end, float deltaTime) {
+    ageParticles(_lifetime.data(), begin, end, deltaTime);
+    integrateAxis(_positionX.data(), _velocityX.data(), _accelerationX.data(), begin, end, deltaTime);
+    integrateAxis(_positionY.data(), _velocityY.data(), _accelerationY.data(), begin, end, deltaTime);
+    integrateAxis(_positionZ.data(), _velocityZ.data(), _accelerationZ.data(), begin, end, deltaTime);
+}
+
+void ParticleSystem::step(const ParticleEmitter& emitter, const glm::vec3& previousPosition, const glm::vec3& position,
+                          float deltaTime) {
+    if (std::max(emitter.maxParticles, 1u) != _capacity) {
+        setCapacity(emitter.maxParticles);
+    }
+
+    // update the particles between head and tail, in at most two contiguous runs
+    int end = _head + _count;
+    integrate(_head, std::min(end, _storageSize), deltaTime);
+    if (end > _storageSize) {
+        integrate(0, end - _storageSize, deltaTime);
+    }
+
+    // pop the particles that have died
+    while (_count > 0 && _lifetime[_head] >= emitter.lifespan) {
+        _head = toSlot(1);
+        --_count;
+    }
+
+    // emit new particles, but only if we are emitting
+    if (emitter.isEmitting && emitter.emitRate > 0.0f && emitter.lifespan > 0.0f &&
+        emitter.polarStart <= emitter.polarFinish) {
+        emit(emitter, previousPosition, position, deltaTime);
+    }
+}
+
+void ParticleSystem::emit(const ParticleEmitter& emitter, const glm::vec3& previousPosition, const glm::vec3& position,
+                          float deltaTime) {
+    // find when in this step each particle is emitted
+    _emitAges.clear();
+    float timeLeftInFrame = deltaTime;
+    while (_timeUntilNextEmit < timeLeftInFrame) {
+        timeLeftInFrame -= _timeUntilNextEmit;
+        _emitAges.push_back(timeLeftInFrame);
+        _timeUntilNextEmit = 1.0f / emitter.emitRate;
+    }
+    _timeUntilNextEmit -= timeLeftInFrame;
+
+    // only the newest particles would survive the overflow, and the ones that would already be dead aren't needed
+    size_t first = _emitAges.size() - std::min(_emitAges.size(), (size_t)_capacity);
+    while (first < _emitAges.size() && _emitAges[first] >= emitter.lifespan) {
+        ++first;
+    }
+    size_t numToEmit = _emitAges.size() - first;
+    if (numToEmit == 0) {
+        return;
+    }
+
+    _emitRandoms.resize(numToEmit * RANDOMS_PER_PARTICLE);
+    _random.fill(_emitRandoms.data(), (int)_emitRandoms.size());
+
+    for (size_t i = 0; i < numToEmit; i++) {
+        float age = _emitAges[first + i];
+        float emitTime = deltaTime - age;
+        glm::vec3 emitPosition = (deltaTime > 0.0f) ?
+            glm::mix(previousPosition, position, emitTime / deltaTime) : position;
+        emitParticle(emitter, emitPosition, &_emitRandoms[i * RANDOMS_PER_PARTICLE], age);
+    }
+}
+
+void ParticleSystem::emitParticle(const ParticleEmitter& emitter, const glm::vec3& emitterPosition, const float* random,
+                                  float age) {
+    auto randomInRange = [](float unit, float min, float max) {
+        return min + unit * (max - min);
+    };
+
+    glm::vec3 particlePosition;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+    float seed = randomInRange(random[0], -1.0f, 1.0f);
+    if (emitter.shouldTrail) {
+        particlePosition = emitterPosition;
+    }
+
+    // Position, velocity, and acceleration
+    if (emitter.polarStart == 0.0f && emitter.polarFinish == 0.0f && emitter.emitDimensions.z == 0.0f) {
+        // Emit along z-axis from position
+        velocity = (emitter.emitSpeed + 0.2f * emitter.speedSpread) * (emitter.emitOrientation * Vectors::UNIT_Z);
+        acceleration = emitter.emitAcceleration + randomInRange(random[5], -1.0f, 1.0f) * emitter.accelerationSpread;
+
+    } else {
+        // Emit around point or from ellipsoid
+        // - Distribute directions evenly around point
+        // - Distribute points relatively evenly over ellipsoid surface
+        // - Distribute points relatively evenly within ellipsoid volume
+
+        float elevationMinZ = sinf(PI_OVER_TWO - emitter.polarFinish);
+        float elevationMaxZ = sinf(PI_OVER_TWO - emitter.polarStart);
+        float elevation = asinf(elevationMinZ + (elevationMaxZ - elevationMinZ) * random[1]);
+
+        float azimuth;
+        if (emitter.azimuthFinish >= emitter.azimuthStart) {
+            azimuth = emitter.azimuthStart + (emitter.azimuthFinish - emitter.azimuthStart) * random[2];
+        } else {
+            azimuth = emitter.azimuthStart + (TWO_PI + emitter.azimuthFinish - emitter.azimuthStart) * random[2];
+        }
+
+        glm::vec3 emitDirection;
+
+        if (emitter.emitDimensions == Vectors::ZERO) {
+            // Point
+            emitDirection = glm::quat(glm::vec3(PI_OVER_TWO - elevation, 0.0f, azimuth)) * Vectors::UNIT_Z;
+        } else {
+            // Ellipsoid
+            float radiusScale = 1.0f;
+            if (emitter.emitRadiusStart < 1.0f) {
+                // emitRadiusStart is a fraction of the radii
+                // Avoid math complications at center
+                float emitRadiusStart = glm::max(emitter.emitRadiusStart, EPSILON);
+                float randRadius = randomInRange(random[3], emitRadiusStart, 1.0f);
+                radiusScale = 1.0f - std::pow(1.0f - randRadius, 3.0f);
+            }
+
+            glm::vec3 radii = radiusScale * 0.5f * emitter.emitDimensions;
+            float cosElevation = cosf(elevation);
+            float x = radii.x * cosElevation * cosf(azimuth);
+            float y = radii.y * cosElevation * sinf(azimuth);
+            float z = radii.z * sinf(elevation);
+            glm::vec3 emitPosition = glm::vec3(x, y, z);
+            emitDirection = glm::normalize(glm::vec3(
+                radii.x > 0.0f ? x / (radii.x * radii.x) : 0.0f,
+                radii.y > 0.0f ? y / (radii.y * radii.y) : 0.0f,
+                radii.z > 0.0f ? z / (radii.z * radii.z) : 0.0f
+            ));
+
+            particlePosition += emitter.emitOrientation * emitPosition;
+        }
+
+        velocity = (emitter.emitSpeed + randomInRange(random[4], -1.0f, 1.0f) * emitter.speedSpread) *
+            (emitter.emitOrientation * emitDirection);
+        acceleration = emitter.emitAcceleration + randomInRange(random[5], -1.0f, 1.0f) * emitter.accelerationSpread;
+    }
+
+    // move it along by the part of the step that it has been alive for
+    particlePosition += velocity * age + (0.5f * age * age) * acceleration;
+    velocity += acceleration * age;
+
+    int slot = pushSlot();
+    _seed[slot] = seed;
+    _lifetime[slot] = age;
+    _positionX[slot] = particlePosition.x;
+    _positionY[slot] = particlePosition.y;
+    _positionZ[slot] = particlePosition.z;
+    _velocityX[slot] = velocity.x;
+    _velocityY[slot] = velocity.y;
+    _velocityZ[slot] = velocity.z;
+    _accelerationX[slot] = acceleration.x;
+    _accelerationY[slot] = acceleration.y;
+    _accelerationZ[slot] = acceleration.z;
+}
+
+void ParticleSystem::writePrimitives(Primitive* primitives) const {
+    int end = _head + _count;
+    auto writeRun = [&](int begin, int end) {
+        for (int slot = begin; slot < end; slot++) {
+            Primitive& primitive = *primitives++;
+            primitive.xyz = glm::vec3(_positionX[slot], _positionY[slot], _positionZ[slot]);
+            primitive.uv = glm::vec2(_lifetime[slot], _seed[slot]);
+        }
+    };
+    writeRun(_head, std::min(end, _storageSize));
+    if (end > _storageSize) {
+        writeRun(0, end - _storageSize);
+    }
+}
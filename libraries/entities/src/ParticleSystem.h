@@ -0,0 +1,138 @@
+//
+//  ParticleSystem.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParticleSystem_h
+#define hifi_ParticleSystem_h
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// A fast random number generator for particle emission: four xorshift32 generators side by side, stepped together
+// with SSE2 where it is available.  Unlike rand() it has no shared state, so emitters can be stepped on any thread.
+class ParticleRandom {
+public:
+    ParticleRandom(uint32_t seed = 1);
+
+    void seed(uint32_t seed);
+
+    // count values uniformly distributed in [0, 1)
+    void fill(float* values, int count);
+
+private:
+    static const int NUM_LANES = 4;
+
+    uint32_t _state[NUM_LANES];
+    float _spare[NUM_LANES]; // values generated but not yet handed out by fill()
+    int _numSpare { 0 };
+};
+
+// What a ParticleSystem emits, copied from the properties of its entity at each step.
+struct ParticleEmitter {
+    bool isEmitting { true };
+    bool shouldTrail { false }; // particles are emitted in world frame rather than in the frame of the emitter
+    uint32_t maxParticles { 1000 };
+    float lifespan { 3.0f };
+    float emitRate { 15.0f };
+    float emitSpeed { 5.0f };
+    float speedSpread { 1.0f };
+    glm::quat emitOrientation;
+    glm::vec3 emitDimensions;
+    float emitRadiusStart { 1.0f };
+    glm::vec3 emitAcceleration;
+    glm::vec3 accelerationSpread;
+    float polarStart { 0.0f };
+    float polarFinish { 0.0f };
+    float azimuthStart { 0.0f };
+    float azimuthFinish { 0.0f };
+};
+
+// The particles of one emitter, stored as a structure of arrays.
+//
+// Particles are kept in a ring buffer in the order they were emitted, and since they all have the same lifespan the
+// ones that die are always at its head.  Each step integrates every particle in contiguous runs of floats (four at a
+// time with SSE), then pops the dead ones off the head and appends the newly emitted ones at the tail.  When the
+// buffer is full the oldest particles are dropped to make room, newer particles have the higher priority.
+//
+// The steps of different systems are independent, so many emitters can be stepped in parallel.
+class ParticleSystem {
+public:
+    // One particle as drawn by the particle shader, which interpolates radius, color and alpha from lifetime and seed.
+    struct Primitive {
+        glm::vec3 xyz; // position
+        glm::vec2 uv;  // lifetime, seed
+    };
+
+    ParticleSystem();
+
+    int getNumParticles() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+    uint32_t getCapacity() const { return _capacity; }
+    // drops the oldest particles that no longer fit
+    void setCapacity(uint32_t capacity);
+
+    // emit the next particle as soon as possible
+    void restartEmission() { _timeUntilNextEmit = 0.0f; }
+    void clear();
+
+    void seedRandom(uint32_t seed) { _random.seed(seed); }
+
+    // ages and moves the particles, then emits along the path of the emitter from previousPosition to position
+    void step(const ParticleEmitter& emitter, const glm::vec3& previousPosition, const glm::vec3& position,
+              float deltaTime);
+
+    // writes getNumParticles() primitives, oldest first
+    void writePrimitives(Primitive* primitives) const;
+
+    // the particles, oldest first, for tests and debugging
+    float getLifetime(int index) const { return _lifetime[toSlot(index)]; }
+    float getSeed(int index) const { return _seed[toSlot(index)]; }
+    glm::vec3 getPosition(int index) const;
+    glm::vec3 getVelocity(int index) const;
+
+private:
+    // every particle is aged and integrated, including the ones that are about to be popped
+    void integrate(int begin, int end, float deltaTime);
+    void emit(const ParticleEmitter& emitter, const glm::vec3& previousPosition, const glm::vec3& position,
+              float deltaTime);
+    void emitParticle(const ParticleEmitter& emitter, const glm::vec3& position, const float* random, float age);
+
+    int toSlot(int index) const;
+    int pushSlot();
+    void resizeStorage(int size);
+
+    std::vector<float> _seed;
+    std::vector<float> _lifetime;
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _positionZ;
+    std::vector<float> _velocityX;
+    std::vector<float> _velocityY;
+    std::vector<float> _velocityZ;
+    std::vector<float> _accelerationX;
+    std::vector<float> _accelerationY;
+    std::vector<float> _accelerationZ;
+
+    // the storage grows up to the capacity as particles are emitted, rather than being allocated up front
+    int _storageSize { 0 };
+    int _head { 0 };
+    int _count { 0 };
+    uint32_t _capacity { 1000 };
+
+    float _timeUntilNextEmit { 0.0f };
+    std::vector<float> _emitAges; // scratch, the age at the end of the step of each particle emitted by a step
+    std::vector<float> _emitRandoms; // scratch
+    ParticleRandom _random;
+};
+
+#endif // hifi_ParticleSystem_h
@@ -0,0 +1,384 @@
+//
+//  PolyVoxBricks.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PolyVoxBricks.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include <QDataStream>
+
+#include "EntitiesLogging.h"
+#include "PolyVoxEntityItem.h"
+
+// Bricked voxelData starts with a zero where the older format has the x size, which is never zero:
+//
+//   quint16 0, quint8 version, quint8 flags, quint16 xSize, ySize, zSize,
+//   QByteArray qCompress(quint16 numBricks, numBricks * (quint16 brickIndex, QByteArray encodedBrick))
+//
+// A whole volume lists its non-empty bricks.  A delta lists the bricks it replaces, with an empty encodedBrick for a
+// brick that was cleared.
+const quint16 BRICKED_VOXEL_DATA_MARKER = 0;
+const quint8 BRICKED_VOXEL_DATA_VERSION = 1;
+const quint8 BRICKED_VOXEL_DATA_DELTA = 0x01;
+const int BRICKED_VOXEL_DATA_HEADER_SIZE = 10;
+const int VOXEL_DATA_COMPRESSION_LEVEL = 9;
+
+static int numBricksFor(quint16 size) {
+    return (size + PolyVoxBricks::BRICK_SIZE - 1) / PolyVoxBricks::BRICK_SIZE;
+}
+
+static bool isReasonableSize(quint16 xSize, quint16 ySize, quint16 zSize) {
+    return xSize > 0 && xSize <= PolyVoxEntityItem::MAX_VOXEL_DIMENSION &&
+        ySize > 0 && ySize <= PolyVoxEntityItem::MAX_VOXEL_DIMENSION &&
+        zSize > 0 && zSize <= PolyVoxEntityItem::MAX_VOXEL_DIMENSION;
+}
+
+PolyVoxBricks::PolyVoxBricks(quint16 xSize, quint16 ySize, quint16 zSize) :
+    _xSize(xSize),
+    _ySize(ySize),
+    _zSize(zSize),
+    _numBricksX(numBricksFor(xSize)),
+    _numBricksY(numBricksFor(ySize)),
+    _numBricksZ(numBricksFor(zSize))
+{
+    _bricks.resize(_numBricksX * _numBricksY * _numBricksZ);
+}
+
+bool PolyVoxBricks::hasSize(quint16 xSize, quint16 ySize, quint16 zSize) const {
+    return _xSize == xSize && _ySize == ySize && _zSize == zSize;
+}
+
+int PolyVoxBricks::getBrickIndex(int x, int y, int z) const {
+    return (x / BRICK_SIZE) + (y / BRICK_SIZE) * _numBricksX + (z / BRICK_SIZE) * _numBricksX * _numBricksY;
+}
+
+void PolyVoxBricks::getBrickCorner(int brickIndex, int& x, int& y, int& z) const {
+    x = (brickIndex % _numBricksX) * BRICK_SIZE;
+    y = ((brickIndex / _numBricksX) % _numBricksY) * BRICK_SIZE;
+    z = (brickIndex / (_numBricksX * _numBricksY)) * BRICK_SIZE;
+}
+
+QByteArray PolyVoxBricks::getBrickVoxels(int brickIndex) const {
+    QByteArray voxels;
+    if (!decodeBrick(_bricks[brickIndex], voxels)) {
+        // only bricks that decode are ever stored
+        voxels = QByteArray(VOXELS_PER_BRICK, '\0');
+    }
+    return voxels;
+}
+
+void PolyVoxBricks::setBrickVoxels(int brickIndex, const QByteArray& voxels) {
+    assert(voxels.size() == VOXELS_PER_BRICK);
+    _bricks[brickIndex] = encodeBrick(voxels);
+}
+
+std::vector<int> PolyVoxBricks::findChangedBricks(const PolyVoxBricks& other) const {
+    // the encoding is canonical, so bricks with the same voxels have the same bytes
+    std::vector<int> changed;
+    int numBricks = std::min(getNumBricks(), other.getNumBricks());
+    for (int i = 0; i < numBricks; i++) {
+        if (_bricks[i] != other._bricks[i]) {
+            changed.push_back(i);
+        }
+    }
+    return changed;
+}
+
+QByteArray PolyVoxBricks::toVoxelData() const {
+    std::vector<int> nonEmptyBricks;
+    for (int i = 0; i < getNumBricks(); i++) {
+        if (!_bricks[i].isEmpty()) {
+            nonEmptyBricks.push_back(i);
+        }
+    }
+    return writeVoxelData(nonEmptyBricks, false);
+}
+
+QByteArray PolyVoxBricks::toDeltaVoxelData(const std::vector<int>& brickIndices) const {
+    return writeVoxelData(brickIndices, true);
+}
+
+QByteArray PolyVoxBricks::writeVoxelData(const std::vector<int>& brickIndices, bool isDelta) const {
+    QByteArray table;
+    QDataStream tableWriter(&table, QIODevice::WriteOnly | QIODevice::Truncate);
+    tableWriter << (quint16)brickIndices.size();
+    for (int brickIndex : brickIndices) {
+        tableWriter << (quint16)brickIndex << _bricks[brickIndex];
+    }
+
+    QByteArray voxelData;
+    QDataStream writer(&voxelData, QIODevice::WriteOnly | QIODevice::Truncate);
+    writer << BRICKED_VOXEL_DATA_MARKER << BRICKED_VOXEL_DATA_VERSION;
+    writer << (quint8)(isDelta ? BRICKED_VOXEL_DATA_DELTA : 0);
+    writer << _xSize << _ySize << _zSize;
+    writer << qCompress(table, VOXEL_DATA_COMPRESSION_LEVEL);
+    return voxelData;
+}
+
+bool PolyVoxBricks::isDeltaVoxelData(const QByteArray& voxelData) {
+    return voxelData.size() >= BRICKED_VOXEL_DATA_HEADER_SIZE &&
+        voxelData[0] == 0 && voxelData[1] == 0 &&
+        ((quint8)voxelData[3] & BRICKED_VOXEL_DATA_DELTA);
+}
+
+// reads the bricks of a bricked voxelData into bricks, which is resized if it doesn't have the size of the data
+static bool readBrickedVoxelData(const QByteArray& voxelData, bool expectDelta, PolyVoxBricks& bricks,
+                                 std::vector<std::pair<int, QByteArray>>& readBricks) {
+    QDataStream reader(voxelData);
+    quint16 marker;
+    quint8 version;
+    quint8 flags;
+    quint16 xSize, ySize, zSize;
+    reader >> marker >> version >> flags >> xSize >> ySize >> zSize;
+    if (reader.status() != QDataStream::Ok || marker != BRICKED_VOXEL_DATA_MARKER) {
+        return false;
+    }
+    if (version > BRICKED_VOXEL_DATA_VERSION) {
+        qCDebug(entities) << "PolyVoxBricks -- voxel data version" << version << "is newer than" <<
+            BRICKED_VOXEL_DATA_VERSION;
+        return false;
+    }
+    if (((flags & BRICKED_VOXEL_DATA_DELTA) != 0) != expectDelta) {
+        return false;
+    }
+    if (!isReasonableSize(xSize, ySize, zSize)) {
+        qCDebug(entities) << "PolyVoxBricks -- voxel size is not reasonable" << xSize << ySize << zSize;
+        return false;
+    }
+    if (expectDelta && !bricks.hasSize(xSize, ySize, zSize)) {
+        qCDebug(entities) << "PolyVoxBricks -- delta is for a volume of" << xSize << ySize << zSize <<
+            "but the volume is" << bricks.getXSize() << bricks.getYSize() << bricks.getZSize();
+        return false;
+    }
+    if (!expectDelta) {
+        bricks = PolyVoxBricks(xSize, ySize, zSize);
+    }
+
+    QByteArray compressedTable;
+    reader >> compressedTable;
+    QByteArray table = qUncompress(compressedTable);
+    QDataStream tableReader(table);
+    quint16 numBricks = 0;
+    tableReader >> numBricks;
+    if (reader.status() != QDataStream::Ok || tableReader.status() != QDataStream::Ok) {
+        qCDebug(entities) << "PolyVoxBricks -- malformed brick table";
+        return false;
+    }
+    QByteArray voxels;
+    for (int i = 0; i < numBricks; i++) {
+        quint16 brickIndex;
+        QByteArray encodedBrick;
+        tableReader >> brickIndex >> encodedBrick;
+        if (tableReader.status() != QDataStream::Ok || brickIndex >= bricks.getNumBricks() ||
+            !PolyVoxBricks::decodeBrick(encodedBrick, voxels)) {
+            qCDebug(entities) << "PolyVoxBricks -- malformed brick table";
+            return false;
+        }
+        readBricks.emplace_back(brickIndex, encodedBrick);
+    }
+    return true;
+}
+
+bool PolyVoxBricks::fromVoxelData(const QByteArray& voxelData) {
+    if (voxelData.size() >= 2 && (voxelData[0] != 0 || voxelData[1] != 0)) {
+        return readLegacyVoxelData(voxelData);
+    }
+
+    PolyVoxBricks bricks;
+    std::vector<std::pair<int, QByteArray>> readBricks;
+    if (!readBrickedVoxelData(voxelData, false, bricks, readBricks)) {
+        return false;
+    }
+    for (const auto& brick : readBricks) {
+        bricks._bricks[brick.first] = brick.second;
+    }
+    *this = bricks;
+    return true;
+}
+
+bool PolyVoxBricks::applyDeltaVoxelData(const QByteArray& deltaVoxelData) {
+    std::vector<std::pair<int, QByteArray>> readBricks;
+    if (!readBrickedVoxelData(deltaVoxelData, true, *this, readBricks)) {
+        return false;
+    }
+    for (const auto& brick : readBricks) {
+        _bricks[brick.first] = brick.second;
+    }
+    return true;
+}
+
+bool PolyVoxBricks::readLegacyVoxelData(const QByteArray& voxelData) {
+    QDataStream reader(voxelData);
+    quint16 xSize, ySize, zSize;
+    reader >> xSize >> ySize >> zSize;
+    if (!isReasonableSize(xSize, ySize, zSize)) {
+        qCDebug(entities) << "PolyVoxBricks -- voxel size is not reasonable" << xSize << ySize << zSize;
+        return false;
+    }
+
+    QByteArray compressedData;
+    reader >> compressedData;
+    QByteArray uncompressedData = qUncompress(compressedData);
+    int rawSize = xSize * ySize * zSize;
+    if (uncompressedData.size() != rawSize) {
+        qCDebug(entities) << "PolyVoxBricks -- size is (" << xSize << ySize << zSize << ") so expected uncompressed"
+            << "length of" << rawSize << "but length is" << uncompressedData.size();
+        return false;
+    }
+
+    PolyVoxBricks bricks(xSize, ySize, zSize);
+    QByteArray voxels(VOXELS_PER_BRICK, '\0');
+    for (int brickIndex = 0; brickIndex < bricks.getNumBricks(); brickIndex++) {
+        int cornerX, cornerY, cornerZ;
+        bricks.getBrickCorner(brickIndex, cornerX, cornerY, cornerZ);
+        voxels.fill('\0');
+        for (int z = cornerZ; z < std::min(cornerZ + BRICK_SIZE, (int)zSize); z++) {
+            for (int y = cornerY; y < std::min(cornerY + BRICK_SIZE, (int)ySize); y++) {
+                for (int x = cornerX; x < std::min(cornerX + BRICK_SIZE, (int)xSize); x++) {
+                    int brickOffset = (x - cornerX) + (y - cornerY) * BRICK_SIZE +
+                        (z - cornerZ) * BRICK_SIZE * BRICK_SIZE;
+                    voxels[brickOffset] = uncompressedData[(z * ySize * xSize) + (y * xSize) + x];
+                }
+            }
+        }
+        bricks.setBrickVoxels(brickIndex, voxels);
+    }
+    *this = bricks;
+    return true;
+}
+
+QByteArray PolyVoxBricks::mergeVoxelData(const QByteArray& voxelData, const QByteArray& incoming) {
+    if (!isDeltaVoxelData(incoming)) {
+        return incoming;
+    }
+
+    quint16 xSize, ySize, zSize;
+    if (!readVoxelDataSize(incoming, xSize, ySize, zSize)) {
+        return voxelData;
+    }
+
+    PolyVoxBricks bricks;
+    if (!bricks.fromVoxelData(voxelData)) {
+        bricks = PolyVoxBricks(xSize, ySize, zSize);
+    } else if (!bricks.hasSize(xSize, ySize, zSize)) {
+        // the sender's volume has been resized since our voxelData was written.  like the sender, keep the voxels
+        // that are inside both sizes.
+        bricks = bricks.resized(xSize, ySize, zSize);
+    }
+    if (!bricks.applyDeltaVoxelData(incoming)) {
+        qCDebug(entities) << "PolyVoxBricks -- ignoring a malformed voxel delta";
+        return voxelData;
+    }
+    return bricks.toVoxelData();
+}
+
+bool PolyVoxBricks::readVoxelDataSize(const QByteArray& voxelData, quint16& xSize, quint16& ySize, quint16& zSize) {
+    QDataStream reader(voxelData);
+    quint16 first;
+    reader >> first;
+    if (first == BRICKED_VOXEL_DATA_MARKER) {
+        quint8 version;
+        quint8 flags;
+        reader >> version >> flags >> xSize >> ySize >> zSize;
+    } else {
+        xSize = first;
+        reader >> ySize >> zSize;
+    }
+    return reader.status() == QDataStream::Ok && isReasonableSize(xSize, ySize, zSize);
+}
+
+PolyVoxBricks PolyVoxBricks::resized(quint16 xSize, quint16 ySize, quint16 zSize) const {
+    PolyVoxBricks result(xSize, ySize, zSize);
+    for (int brickIndex = 0; brickIndex < getNumBricks(); brickIndex++) {
+        if (_bricks[brickIndex].isEmpty()) {
+            continue;
+        }
+        QByteArray voxels = getBrickVoxels(brickIndex);
+        int cornerX, cornerY, cornerZ;
+        getBrickCorner(brickIndex, cornerX, cornerY, cornerZ);
+        if (cornerX >= xSize || cornerY >= ySize || cornerZ >= zSize) {
+            continue;
+        }
+        // bricks are aligned to the origin in both volumes, so a brick that survives keeps its place
+        int resultIndex = result.getBrickIndex(cornerX, cornerY, cornerZ);
+        for (int z = 0; z < BRICK_SIZE; z++) {
+            for (int y = 0; y < BRICK_SIZE; y++) {
+                for (int x = 0; x < BRICK_SIZE; x++) {
+                    if (cornerX + x >= std::min(_xSize, xSize) || cornerY + y >= std::min(_ySize, ySize) ||
+                        cornerZ + z >= std::min(_zSize, zSize)) {
+                        voxels[x + y * BRICK_SIZE + z * BRICK_SIZE * BRICK_SIZE] = 0;
+                    }
+                }
+            }
+        }
+        result.setBrickVoxels(resultIndex, voxels);
+    }
+    return result;
+}
+
+// A brick is a list of runs: the voxel value followed by the length of the run, 7 bits per byte with the high bit
+// set on all but the last byte.  Trailing zeros are left out, so a brick of zeros is encoded as nothing at all.
+QByteArray PolyVoxBricks::encodeBrick(const QByteArray& voxels) {
+    QByteArray encoded;
+    const char* data = voxels.constData();
+    int i = 0;
+    while (i < VOXELS_PER_BRICK) {
+        char value = data[i];
+        int runLength = 1;
+        while (i + runLength < VOXELS_PER_BRICK && data[i + runLength] == value) {
+            runLength++;
+        }
+        if (value == 0 && i + runLength == VOXELS_PER_BRICK) {
+            break;
+        }
+        i += runLength;
+
+        encoded.append(value);
+        while (runLength >= 0x80) {
+            encoded.append((char)(0x80 | (runLength & 0x7f)));
+            runLength >>= 7;
+        }
+        encoded.append((char)runLength);
+    }
+    return encoded;
+}
+
+bool PolyVoxBricks::decodeBrick(const QByteArray& encodedBrick, QByteArray& voxels) {
+    voxels = QByteArray(VOXELS_PER_BRICK, '\0');
+    char* data = voxels.data();
+    const char* encoded = encodedBrick.constData();
+    int encodedSize = encodedBrick.size();
+    int i = 0;
+    int at = 0;
+    while (at < encodedSize) {
+        char value = encoded[at++];
+        int runLength = 0;
+        int shift = 0;
+        quint8 byte;
+        do {
+            if (at >= encodedSize || shift > 14) {
+                return false;
+            }
+            byte = (quint8)encoded[at++];
+            runLength |= (byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        if (runLength == 0 || i + runLength > VOXELS_PER_BRICK) {
+            return false;
+        }
+        memset(data + i, value, runLength);
+        i += runLength;
+    }
+    return true;
+}
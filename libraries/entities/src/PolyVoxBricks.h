@@ -0,0 +1,88 @@
+//
+//  PolyVoxBricks.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PolyVoxBricks_h
+#define hifi_PolyVoxBricks_h
+
+#include <vector>
+
+#include <QByteArray>
+
+// The voxel values of a polyvox, split into BRICK_SIZE^3 bricks that are each run-length encoded on their own.
+//
+// This is the format of the voxelData property.  Because the bricks are independent, an edit only has to re-encode
+// and send the bricks it touched (a delta), and whoever holds the whole volume can merge the delta into it without
+// expanding the untouched bricks.  Bricks that are all zero take no space at all.
+//
+// voxelData written before bricks existed (the sizes followed by the qCompress'ed volume) is still understood.
+class PolyVoxBricks {
+public:
+    static const int BRICK_SIZE = 16;
+    static const int VOXELS_PER_BRICK = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+
+    PolyVoxBricks() {}
+    PolyVoxBricks(quint16 xSize, quint16 ySize, quint16 zSize);
+
+    quint16 getXSize() const { return _xSize; }
+    quint16 getYSize() const { return _ySize; }
+    quint16 getZSize() const { return _zSize; }
+    bool hasSize(quint16 xSize, quint16 ySize, quint16 zSize) const;
+    bool isNull() const { return _bricks.empty(); }
+
+    int getNumBricks() const { return (int)_bricks.size(); }
+    int getBrickIndex(int x, int y, int z) const; // x, y, z are voxel coords
+    void getBrickCorner(int brickIndex, int& x, int& y, int& z) const;
+
+    bool isBrickEmpty(int brickIndex) const { return _bricks[brickIndex].isEmpty(); }
+    const QByteArray& getEncodedBrick(int brickIndex) const { return _bricks[brickIndex]; }
+    void setEncodedBrick(int brickIndex, const QByteArray& encodedBrick) { _bricks[brickIndex] = encodedBrick; }
+
+    // VOXELS_PER_BRICK values, x varying fastest.  Voxels of edge bricks that are outside the volume are zero.
+    QByteArray getBrickVoxels(int brickIndex) const;
+    void setBrickVoxels(int brickIndex, const QByteArray& voxels);
+
+    // bricks whose values differ from those of other, which must be the same size
+    std::vector<int> findChangedBricks(const PolyVoxBricks& other) const;
+
+    // reads a whole volume in either format, fails on deltas and malformed data
+    bool fromVoxelData(const QByteArray& voxelData);
+    QByteArray toVoxelData() const;
+
+    // a voxelData that only carries the given bricks
+    QByteArray toDeltaVoxelData(const std::vector<int>& brickIndices) const;
+    // replaces the bricks carried by a delta, fails if the delta is for a volume of another size
+    bool applyDeltaVoxelData(const QByteArray& deltaVoxelData);
+
+    // the same volume with another size, keeping the voxels that are inside both
+    PolyVoxBricks resized(quint16 xSize, quint16 ySize, quint16 zSize) const;
+
+    static bool isDeltaVoxelData(const QByteArray& voxelData);
+    static bool readVoxelDataSize(const QByteArray& voxelData, quint16& xSize, quint16& ySize, quint16& zSize);
+
+    // what voxelData becomes after incoming is received: incoming itself unless it is a delta
+    static QByteArray mergeVoxelData(const QByteArray& voxelData, const QByteArray& incoming);
+
+    static QByteArray encodeBrick(const QByteArray& voxels);
+    static bool decodeBrick(const QByteArray& encodedBrick, QByteArray& voxels);
+
+private:
+    QByteArray writeVoxelData(const std::vector<int>& brickIndices, bool isDelta) const;
+    bool readLegacyVoxelData(const QByteArray& voxelData);
+
+    quint16 _xSize { 0 };
+    quint16 _ySize { 0 };
+    quint16 _zSize { 0 };
+    int _numBricksX { 0 };
+    int _numBricksY { 0 };
+    int _numBricksZ { 0 };
+    std::vector<QByteArray> _bricks; // encoded, empty when all the voxels are zero
+};
+
+#endif // hifi_PolyVoxBricks_h
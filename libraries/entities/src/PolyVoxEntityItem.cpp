@@ -20,6 +20,7 @@
 #include "EntityItemProperties.h"
 #include "EntityTree.h"
 #include "EntityTreeElement.h"
+#include "PolyVoxBricks.h"
 #include "PolyVoxEntityItem.h"
 
 const glm::vec3 PolyVoxEntityItem::DEFAULT_VOXEL_VOLUME_SIZE = glm::vec3(32, 32, 32);
@@ -38,17 +39,7 @@ EntityItemPointer PolyVoxEntityItem::factory(const EntityItemID& entityID, const
 }
 
 QByteArray PolyVoxEntityItem::makeEmptyVoxelData(quint16 voxelXSize, quint16 voxelYSize, quint16 voxelZSize) {
-    int rawSize = voxelXSize * voxelYSize * voxelZSize;
-
-    QByteArray uncompressedData = QByteArray(rawSize, '\0');
-    QByteArray newVoxelData;
-    QDataStream writer(&newVoxelData, QIODevice::WriteOnly | QIODevice::Truncate);
-    writer << voxelXSize << voxelYSize << voxelZSize;
-
-    QByteArray compressedData = qCompress(uncompressedData, 9);
-    writer << compressedData;
-
-    return newVoxelData;
+    return PolyVoxBricks(voxelXSize, voxelYSize, voxelZSize).toVoxelData();
 }
 
 PolyVoxEntityItem::PolyVoxEntityItem(const EntityItemID& entityItemID) :
@@ -230,7 +221,8 @@ void PolyVoxEntityItem::debugDump() const {
 
 void PolyVoxEntityItem::setVoxelData(QByteArray voxelData) {
     withWriteLock([&] {
-        _voxelData = voxelData;
+        // edits only carry the bricks they changed, see PolyVoxBricks
+        _voxelData = PolyVoxBricks::mergeVoxelData(_voxelData, voxelData);
         _voxelDataDirty = true;
     });
 }
@@ -33,6 +33,11 @@ const quint8 AVATAR_ENTITY_SIMULATION_PRIORITY = SCRIPT_GRAB_SIMULATION_PRIORITY
 // which really just means: things that collide with it will be bid at a priority level one lower
 const quint8 PERSONAL_SIMULATION_PRIORITY = SCRIPT_GRAB_SIMULATION_PRIORITY;
 
+// An entity-server that runs its own physics simulation bids at SERVER priority: above VOLUNTEER and RECRUIT so that
+// it ends up simulating the objects nobody is interacting with, but below the bids of an observer whose avatar or
+// scripts touch an object.
+const quint8 SERVER_SIMULATION_PRIORITY = 0x40;
+
 
 class SimulationOwner {
 public:
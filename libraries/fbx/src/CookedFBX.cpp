@@ -0,0 +1,585 @@
+//
+//  CookedFBX.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CookedFBX.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+const char COOKED_FBX_MAGIC[4] = { 'H', 'F', 'C', 'G' };
+
+// Every record is padded to this boundary so that arrays of floats, vectors and matrices
+// can be consumed straight out of a mapped file without unaligned access
+const size_t COOKED_FBX_ALIGNMENT = 4;
+
+struct CookedHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t length;
+};
+
+class CookedWriter {
+public:
+    CookedWriter() {
+        CookedHeader header;
+        memcpy(header.magic, COOKED_FBX_MAGIC, sizeof(header.magic));
+        header.version = COOKED_FBX_VERSION;
+        header.length = 0;
+        writeRaw(&header, sizeof(header));
+    }
+
+    template <typename T>
+    void write(const T& value) {
+        writeRaw(&value, sizeof(T));
+    }
+
+    void write(bool value) { write<uint32_t>(value ? 1 : 0); }
+    void write(const QByteArray& value) {
+        write<uint32_t>(value.size());
+        writeRaw(value.constData(), value.size());
+    }
+    void write(const QString& value) { write(value.toUtf8()); }
+    void write(const Extents& value) {
+        write(value.minimum);
+        write(value.maximum);
+    }
+    void write(const Transform& value) {
+        write(value.getTranslation());
+        write(value.getRotation());
+        write(value.getScale());
+    }
+
+    template <typename T>
+    void writeArray(const QVector<T>& values) {
+        write<uint32_t>(values.size());
+        writeRaw(values.constData(), values.size() * sizeof(T));
+    }
+
+    QByteArray finish() {
+        uint64_t length = _data.size();
+        memcpy(_data.data() + offsetof(CookedHeader, length), &length, sizeof(length));
+        return _data;
+    }
+
+private:
+    void writeRaw(const void* data, size_t size) {
+        _data.append(reinterpret_cast<const char*>(data), (int)size);
+        size_t padding = (COOKED_FBX_ALIGNMENT - (size % COOKED_FBX_ALIGNMENT)) % COOKED_FBX_ALIGNMENT;
+        _data.append((int)padding, '\0');
+    }
+
+    QByteArray _data;
+};
+
+class CookedReader {
+public:
+    CookedReader(const uint8_t* data, size_t length) : _data(data), _length(length) {
+        CookedHeader header;
+        readRaw(&header, sizeof(header));
+        if (memcmp(header.magic, COOKED_FBX_MAGIC, sizeof(header.magic)) != 0) {
+            throw QString("not a cooked geometry");
+        }
+        if (header.version != COOKED_FBX_VERSION) {
+            throw QString("cooked geometry version %1 does not match %2").arg(header.version).arg(COOKED_FBX_VERSION);
+        }
+        if (header.length != length) {
+            throw QString("cooked geometry is truncated");
+        }
+    }
+
+    template <typename T>
+    void read(T& value) {
+        readRaw(&value, sizeof(T));
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        read(value);
+        return value;
+    }
+
+    void read(bool& value) { value = read<uint32_t>() != 0; }
+    void read(QByteArray& value) {
+        uint32_t size = read<uint32_t>();
+        const uint8_t* start = consume(size);
+        value = QByteArray(reinterpret_cast<const char*>(start), size);
+    }
+    void read(QString& value) {
+        QByteArray utf8;
+        read(utf8);
+        value = QString::fromUtf8(utf8);
+    }
+    void read(Extents& value) {
+        read(value.minimum);
+        read(value.maximum);
+    }
+    void read(Transform& value) {
+        value.setTranslation(read<glm::vec3>());
+        value.setRotation(read<glm::quat>());
+        value.setScale(read<glm::vec3>());
+    }
+
+    template <typename T>
+    void readArray(QVector<T>& values) {
+        uint32_t count = read<uint32_t>();
+        const uint8_t* start = consume(count * sizeof(T));
+        values.resize(count);
+        if (count > 0) {
+            memcpy(values.data(), start, count * sizeof(T));
+        }
+    }
+
+    bool atEnd() const { return _offset == _length; }
+
+private:
+    void readRaw(void* data, size_t size) {
+        memcpy(data, consume(size), size);
+    }
+
+    const uint8_t* consume(size_t size) {
+        size_t padded = size + (COOKED_FBX_ALIGNMENT - (size % COOKED_FBX_ALIGNMENT)) % COOKED_FBX_ALIGNMENT;
+        if (padded > _length - _offset) {
+            throw QString("cooked geometry is truncated");
+        }
+        const uint8_t* start = _data + _offset;
+        _offset += padded;
+        return start;
+    }
+
+    const uint8_t* _data;
+    const size_t _length;
+    size_t _offset { 0 };
+};
+
+void writeTexture(CookedWriter& writer, const FBXTexture& texture) {
+    writer.write(texture.name);
+    writer.write(texture.filename);
+    writer.write(texture.content);
+    writer.write(texture.transform);
+    writer.write<int32_t>(texture.maxNumPixels);
+    writer.write<int32_t>(texture.texcoordSet);
+    writer.write(texture.texcoordSetName);
+    writer.write(texture.isBumpmap);
+}
+
+void readTexture(CookedReader& reader, FBXTexture& texture) {
+    reader.read(texture.name);
+    reader.read(texture.filename);
+    reader.read(texture.content);
+    reader.read(texture.transform);
+    texture.maxNumPixels = reader.read<int32_t>();
+    texture.texcoordSet = reader.read<int32_t>();
+    reader.read(texture.texcoordSetName);
+    reader.read(texture.isBumpmap);
+}
+
+void writeMaterial(CookedWriter& writer, const FBXMaterial& material) {
+    writer.write(material.diffuseColor);
+    writer.write(material.diffuseFactor);
+    writer.write(material.specularColor);
+    writer.write(material.specularFactor);
+    writer.write(material.emissiveColor);
+    writer.write(material.emissiveFactor);
+    writer.write(material.shininess);
+    writer.write(material.opacity);
+    writer.write(material.metallic);
+    writer.write(material.roughness);
+    writer.write(material.emissiveIntensity);
+    writer.write(material.ambientFactor);
+
+    writer.write(material.materialID);
+    writer.write(material.name);
+    writer.write(material.shadingModel);
+
+    writeTexture(writer, material.normalTexture);
+    writeTexture(writer, material.albedoTexture);
+    writeTexture(writer, material.opacityTexture);
+    writeTexture(writer, material.glossTexture);
+    writeTexture(writer, material.roughnessTexture);
+    writeTexture(writer, material.specularTexture);
+    writeTexture(writer, material.metallicTexture);
+    writeTexture(writer, material.emissiveTexture);
+    writeTexture(writer, material.occlusionTexture);
+    writeTexture(writer, material.scatteringTexture);
+    writeTexture(writer, material.lightmapTexture);
+    writer.write(material.lightmapParams);
+
+    writer.write(material.isPBSMaterial);
+    writer.write(material.useNormalMap);
+    writer.write(material.useAlbedoMap);
+    writer.write(material.useOpacityMap);
+    writer.write(material.useRoughnessMap);
+    writer.write(material.useSpecularMap);
+    writer.write(material.useMetallicMap);
+    writer.write(material.useEmissiveMap);
+    writer.write(material.useOcclusionMap);
+
+    // The resolved model::Material is what the renderer consumes, so store its final values rather than
+    // re-deriving them from the FBX properties (which would also need the FST material map)
+    bool hasMaterial = (bool)material._material;
+    writer.write(hasMaterial);
+    if (hasMaterial) {
+        const auto& resolved = *material._material;
+        writer.write(resolved.getEmissive(false));
+        writer.write(resolved.getAlbedo(false));
+        writer.write(resolved.getRoughness());
+        writer.write(resolved.getMetallic());
+        writer.write(resolved.getScattering());
+        writer.write(resolved.getOpacity());
+        writer.write(resolved.isUnlit());
+    }
+}
+
+void readMaterial(CookedReader& reader, FBXMaterial& material) {
+    reader.read(material.diffuseColor);
+    reader.read(material.diffuseFactor);
+    reader.read(material.specularColor);
+    reader.read(material.specularFactor);
+    reader.read(material.emissiveColor);
+    reader.read(material.emissiveFactor);
+    reader.read(material.shininess);
+    reader.read(material.opacity);
+    reader.read(material.metallic);
+    reader.read(material.roughness);
+    reader.read(material.emissiveIntensity);
+    reader.read(material.ambientFactor);
+
+    reader.read(material.materialID);
+    reader.read(material.name);
+    reader.read(material.shadingModel);
+
+    readTexture(reader, material.normalTexture);
+    readTexture(reader, material.albedoTexture);
+    readTexture(reader, material.opacityTexture);
+    readTexture(reader, material.glossTexture);
+    readTexture(reader, material.roughnessTexture);
+    readTexture(reader, material.specularTexture);
+    readTexture(reader, material.metallicTexture);
+    readTexture(reader, material.emissiveTexture);
+    readTexture(reader, material.occlusionTexture);
+    readTexture(reader, material.scatteringTexture);
+    readTexture(reader, material.lightmapTexture);
+    reader.read(material.lightmapParams);
+
+    reader.read(material.isPBSMaterial);
+    reader.read(material.useNormalMap);
+    reader.read(material.useAlbedoMap);
+    reader.read(material.useOpacityMap);
+    reader.read(material.useRoughnessMap);
+    reader.read(material.useSpecularMap);
+    reader.read(material.useMetallicMap);
+    reader.read(material.useEmissiveMap);
+    reader.read(material.useOcclusionMap);
+
+    bool hasMaterial;
+    reader.read(hasMaterial);
+    if (hasMaterial) {
+        material._material = std::make_shared<model::Material>();
+        material._material->setEmissive(reader.read<glm::vec3>(), false);
+        material._material->setAlbedo(reader.read<glm::vec3>(), false);
+        material._material->setRoughness(reader.read<float>());
+        material._material->setMetallic(reader.read<float>());
+        float scattering = reader.read<float>();
+        if (scattering > 0.0f) {
+            material._material->setScattering(scattering);
+        }
+        material._material->setOpacity(reader.read<float>());
+        bool unlit;
+        reader.read(unlit);
+        material._material->setUnlit(unlit);
+    }
+}
+
+void writeJoint(CookedWriter& writer, const FBXJoint& joint) {
+    writer.writeArray(joint.shapeInfo.points);
+    writer.writeArray(joint.freeLineage);
+    writer.write(joint.isFree);
+    writer.write<int32_t>(joint.parentIndex);
+    writer.write(joint.distanceToParent);
+
+    writer.write(joint.translation);
+    writer.write(joint.preTransform);
+    writer.write(joint.preRotation);
+    writer.write(joint.rotation);
+    writer.write(joint.postRotation);
+    writer.write(joint.postTransform);
+    writer.write(joint.transform);
+    writer.write(joint.rotationMin);
+    writer.write(joint.rotationMax);
+    writer.write(joint.inverseDefaultRotation);
+    writer.write(joint.inverseBindRotation);
+    writer.write(joint.bindTransform);
+    writer.write(joint.name);
+    writer.write(joint.isSkeletonJoint);
+    writer.write(joint.bindTransformFoundInCluster);
+
+    writer.write(joint.hasGeometricOffset);
+    writer.write(joint.geometricTranslation);
+    writer.write(joint.geometricRotation);
+    writer.write(joint.geometricScaling);
+}
+
+void readJoint(CookedReader& reader, FBXJoint& joint) {
+    reader.readArray(joint.shapeInfo.points);
+    reader.readArray(joint.freeLineage);
+    reader.read(joint.isFree);
+    joint.parentIndex = reader.read<int32_t>();
+    reader.read(joint.distanceToParent);
+
+    reader.read(joint.translation);
+    reader.read(joint.preTransform);
+    reader.read(joint.preRotation);
+    reader.read(joint.rotation);
+    reader.read(joint.postRotation);
+    reader.read(joint.postTransform);
+    reader.read(joint.transform);
+    reader.read(joint.rotationMin);
+    reader.read(joint.rotationMax);
+    reader.read(joint.inverseDefaultRotation);
+    reader.read(joint.inverseBindRotation);
+    reader.read(joint.bindTransform);
+    reader.read(joint.name);
+    reader.read(joint.isSkeletonJoint);
+    reader.read(joint.bindTransformFoundInCluster);
+
+    reader.read(joint.hasGeometricOffset);
+    reader.read(joint.geometricTranslation);
+    reader.read(joint.geometricRotation);
+    reader.read(joint.geometricScaling);
+}
+
+void writeMesh(CookedWriter& writer, const FBXMesh& mesh) {
+    writer.write<uint32_t>(mesh.meshIndex);
+    writer.write(mesh.meshExtents);
+    writer.write(mesh.modelTransform);
+
+    // vertex buffer, followed by the attribute channels in the order buildModelMesh packs them
+    writer.writeArray(mesh.vertices);
+    writer.writeArray(mesh.normals);
+    writer.writeArray(mesh.tangents);
+    writer.writeArray(mesh.colors);
+    writer.writeArray(mesh.texCoords);
+    writer.writeArray(mesh.texCoords1);
+    writer.writeArray(mesh.clusterIndices);
+    writer.writeArray(mesh.clusterWeights);
+
+    // index buffer, in part order
+    writer.write<uint32_t>(mesh.parts.size());
+    for (const FBXMeshPart& part : mesh.parts) {
+        writer.writeArray(part.quadIndices);
+        writer.writeArray(part.quadTrianglesIndices);
+        writer.writeArray(part.triangleIndices);
+        writer.write(part.materialID);
+    }
+
+    writer.write<uint32_t>(mesh.clusters.size());
+    for (const FBXCluster& cluster : mesh.clusters) {
+        writer.write<int32_t>(cluster.jointIndex);
+        writer.write(cluster.inverseBindMatrix);
+    }
+
+    writer.write<uint32_t>(mesh.blendshapes.size());
+    for (const FBXBlendshape& blendshape : mesh.blendshapes) {
+        writer.writeArray(blendshape.indices);
+        writer.writeArray(blendshape.vertices);
+        writer.writeArray(blendshape.normals);
+    }
+}
+
+void readMesh(CookedReader& reader, FBXMesh& mesh) {
+    mesh.meshIndex = reader.read<uint32_t>();
+    reader.read(mesh.meshExtents);
+    reader.read(mesh.modelTransform);
+
+    reader.readArray(mesh.vertices);
+    reader.readArray(mesh.normals);
+    reader.readArray(mesh.tangents);
+    reader.readArray(mesh.colors);
+    reader.readArray(mesh.texCoords);
+    reader.readArray(mesh.texCoords1);
+    reader.readArray(mesh.clusterIndices);
+    reader.readArray(mesh.clusterWeights);
+
+    mesh.parts.resize(reader.read<uint32_t>());
+    for (FBXMeshPart& part : mesh.parts) {
+        reader.readArray(part.quadIndices);
+        reader.readArray(part.quadTrianglesIndices);
+        reader.readArray(part.triangleIndices);
+        reader.read(part.materialID);
+    }
+
+    mesh.clusters.resize(reader.read<uint32_t>());
+    for (FBXCluster& cluster : mesh.clusters) {
+        cluster.jointIndex = reader.read<int32_t>();
+        reader.read(cluster.inverseBindMatrix);
+    }
+
+    mesh.blendshapes.resize(reader.read<uint32_t>());
+    for (FBXBlendshape& blendshape : mesh.blendshapes) {
+        reader.readArray(blendshape.indices);
+        reader.readArray(blendshape.vertices);
+        reader.readArray(blendshape.normals);
+    }
+}
+
+}
+
+QByteArray writeCookedFBX(const FBXGeometry& geometry) {
+    CookedWriter writer;
+
+    writer.write(geometry.originalURL);
+    writer.write(geometry.author);
+    writer.write(geometry.applicationName);
+
+    writer.write<uint32_t>(geometry.joints.size());
+    for (const FBXJoint& joint : geometry.joints) {
+        writeJoint(writer, joint);
+    }
+    writer.write<uint32_t>(geometry.jointIndices.size());
+    for (auto it = geometry.jointIndices.cbegin(); it != geometry.jointIndices.cend(); ++it) {
+        writer.write(it.key());
+        writer.write<int32_t>(it.value());
+    }
+    writer.write(geometry.hasSkeletonJoints);
+
+    writer.write<uint32_t>(geometry.meshes.size());
+    for (const FBXMesh& mesh : geometry.meshes) {
+        writeMesh(writer, mesh);
+    }
+
+    writer.write<uint32_t>(geometry.materials.size());
+    for (auto it = geometry.materials.cbegin(); it != geometry.materials.cend(); ++it) {
+        writer.write(it.key());
+        writeMaterial(writer, it.value());
+    }
+
+    writer.write(geometry.offset);
+    writer.write<int32_t>(geometry.leftEyeJointIndex);
+    writer.write<int32_t>(geometry.rightEyeJointIndex);
+    writer.write<int32_t>(geometry.neckJointIndex);
+    writer.write<int32_t>(geometry.rootJointIndex);
+    writer.write<int32_t>(geometry.leanJointIndex);
+    writer.write<int32_t>(geometry.headJointIndex);
+    writer.write<int32_t>(geometry.leftHandJointIndex);
+    writer.write<int32_t>(geometry.rightHandJointIndex);
+    writer.write<int32_t>(geometry.leftToeJointIndex);
+    writer.write<int32_t>(geometry.rightToeJointIndex);
+    writer.write(geometry.leftEyeSize);
+    writer.write(geometry.rightEyeSize);
+    writer.writeArray(geometry.humanIKJointIndices);
+    writer.write(geometry.palmDirection);
+    writer.write(geometry.neckPivot);
+    writer.write(geometry.bindExtents);
+    writer.write(geometry.meshExtents);
+
+    writer.write<uint32_t>(geometry.animationFrames.size());
+    for (const FBXAnimationFrame& frame : geometry.animationFrames) {
+        writer.writeArray(frame.rotations);
+        writer.writeArray(frame.translations);
+    }
+
+    writer.write<uint32_t>(geometry.meshIndicesToModelNames.size());
+    for (auto it = geometry.meshIndicesToModelNames.cbegin(); it != geometry.meshIndicesToModelNames.cend(); ++it) {
+        writer.write<int32_t>(it.key());
+        writer.write(it.value());
+    }
+
+    writer.write<uint32_t>(geometry.blendshapeChannelNames.size());
+    for (const QString& name : geometry.blendshapeChannelNames) {
+        writer.write(name);
+    }
+
+    return writer.finish();
+}
+
+FBXGeometry* readCookedFBX(const uint8_t* data, size_t length, const QString& url) {
+    CookedReader reader(data, length);
+    auto geometryPtr = std::unique_ptr<FBXGeometry>(new FBXGeometry());
+    FBXGeometry& geometry = *geometryPtr;
+
+    reader.read(geometry.originalURL);
+    reader.read(geometry.author);
+    reader.read(geometry.applicationName);
+
+    geometry.joints.resize(reader.read<uint32_t>());
+    for (FBXJoint& joint : geometry.joints) {
+        readJoint(reader, joint);
+    }
+    uint32_t numJointIndices = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < numJointIndices; ++i) {
+        QString name;
+        reader.read(name);
+        geometry.jointIndices.insert(name, reader.read<int32_t>());
+    }
+    reader.read(geometry.hasSkeletonJoints);
+
+    geometry.meshes.resize(reader.read<uint32_t>());
+    for (FBXMesh& mesh : geometry.meshes) {
+        readMesh(reader, mesh);
+        FBXReader::buildModelMesh(mesh, url);
+    }
+
+    uint32_t numMaterials = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < numMaterials; ++i) {
+        QString materialID;
+        reader.read(materialID);
+        readMaterial(reader, geometry.materials[materialID]);
+    }
+
+    reader.read(geometry.offset);
+    geometry.leftEyeJointIndex = reader.read<int32_t>();
+    geometry.rightEyeJointIndex = reader.read<int32_t>();
+    geometry.neckJointIndex = reader.read<int32_t>();
+    geometry.rootJointIndex = reader.read<int32_t>();
+    geometry.leanJointIndex = reader.read<int32_t>();
+    geometry.headJointIndex = reader.read<int32_t>();
+    geometry.leftHandJointIndex = reader.read<int32_t>();
+    geometry.rightHandJointIndex = reader.read<int32_t>();
+    geometry.leftToeJointIndex = reader.read<int32_t>();
+    geometry.rightToeJointIndex = reader.read<int32_t>();
+    reader.read(geometry.leftEyeSize);
+    reader.read(geometry.rightEyeSize);
+    reader.readArray(geometry.humanIKJointIndices);
+    reader.read(geometry.palmDirection);
+    reader.read(geometry.neckPivot);
+    reader.read(geometry.bindExtents);
+    reader.read(geometry.meshExtents);
+
+    geometry.animationFrames.resize(reader.read<uint32_t>());
+    for (FBXAnimationFrame& frame : geometry.animationFrames) {
+        reader.readArray(frame.rotations);
+        reader.readArray(frame.translations);
+    }
+
+    uint32_t numModelNames = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < numModelNames; ++i) {
+        int32_t meshIndex = reader.read<int32_t>();
+        QString name;
+        reader.read(name);
+        geometry.meshIndicesToModelNames.insert(meshIndex, name);
+    }
+
+    uint32_t numBlendshapeChannels = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < numBlendshapeChannels; ++i) {
+        QString name;
+        reader.read(name);
+        geometry.blendshapeChannelNames.append(name);
+    }
+
+    if (!reader.atEnd()) {
+        throw QString("cooked geometry has trailing data");
+    }
+
+    return geometryPtr.release();
+}
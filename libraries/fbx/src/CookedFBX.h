@@ -0,0 +1,31 @@
+//
+//  CookedFBX.h
+//  libraries/fbx/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CookedFBX_h
+#define hifi_CookedFBX_h
+
+#include <QByteArray>
+#include <QString>
+
+#include "FBXReader.h"
+
+// Whenever a change is made to the cooked layout that isn't backward compatible, this value should be incremented.
+// Readers reject any other version, which causes the caller to fall back to parsing the original model.
+const uint32_t COOKED_FBX_VERSION = 1;
+
+/// Serializes a parsed geometry into a flat binary form suitable for memory mapping.
+/// Mesh attributes are laid out in the same order buildModelMesh packs them into gpu buffers.
+QByteArray writeCookedFBX(const FBXGeometry& geometry);
+
+/// Reads a geometry previously written by writeCookedFBX and rebuilds its render meshes (url is only used for logging).
+/// \exception QString if the data is truncated or was written with a different COOKED_FBX_VERSION
+FBXGeometry* readCookedFBX(const uint8_t* data, size_t length, const QString& url);
+
+#endif // hifi_CookedFBX_h
@@ -30,6 +30,7 @@
 #include <OctalCode.h>
 #include <gpu/Format.h>
 #include <LogHandler.h>
+#include <TBBHelpers.h>
 
 #include "FBXReader.h"
 #include "ModelFormatLogging.h"
@@ -470,6 +471,12 @@ QByteArray fileOnUrl(const QByteArray& filepath, const QString& url) {
 FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QString& url) {
     const FBXNode& node = _fbxNode;
     QMap<QString, ExtractedMesh> meshes;
+    struct DeferredMesh {
+        QString id;
+        const FBXNode* object;
+        unsigned int meshIndex;
+    };
+    std::vector<DeferredMesh> deferredMeshes;
     QHash<QString, QString> modelIDsToNames;
     QHash<QString, int> meshIDsToMeshIndices;
     QHash<QString, QString> ooChildToParent;
@@ -600,7 +607,8 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
             foreach (const FBXNode& object, child.children) {
                 if (object.name == "Geometry") {
                     if (object.properties.at(2) == "Mesh") {
-                        meshes.insert(getID(object.properties), extractMesh(object, meshIndex));
+                        // meshes are independent of each other, so they are extracted in parallel once every object is seen
+                        deferredMeshes.push_back({ getID(object.properties), &object, meshIndex++ });
                     } else { // object.properties.at(2) == "Shape"
                         ExtractedBlendshape extracted = { getID(object.properties), extractBlendshape(object) };
                         blendshapes.append(extracted);
@@ -1283,6 +1291,15 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
 #endif
     }
 
+    std::vector<ExtractedMesh> extractedMeshes(deferredMeshes.size());
+    tbb::parallel_for(size_t(0), deferredMeshes.size(), [&](size_t i) {
+        unsigned int deferredMeshIndex = deferredMeshes[i].meshIndex;
+        extractedMeshes[i] = extractMesh(*deferredMeshes[i].object, deferredMeshIndex);
+    });
+    for (size_t i = 0; i < deferredMeshes.size(); ++i) {
+        meshes.insert(deferredMeshes[i].id, extractedMeshes[i]);
+    }
+
     // TODO: check if is code is needed
     if (!lights.empty()) {
         if (hifiGlobalNodeID.isEmpty()) {
@@ -20,11 +20,13 @@
 #include <QFileInfo>
 #include <QHash>
 #include <LogHandler.h>
+#include <TBBHelpers.h>
 #include "ModelFormatLogging.h"
 
 #include "FBXReader.h"
 
 #include <memory>
+#include <vector>
 
 
 class Vertex {
@@ -34,14 +36,89 @@ public:
     glm::vec2 texCoord1;
 };
 
-uint qHash(const Vertex& vertex, uint seed = 0) {
-    return qHash(vertex.originalIndex, seed);
-}
-
 bool operator==(const Vertex& v1, const Vertex& v2) {
     return v1.originalIndex == v2.originalIndex && v1.texCoord == v2.texCoord && v1.texCoord1 == v2.texCoord1;
 }
 
+static const size_t MIN_DEDUP_TABLE_CAPACITY = 64;
+
+// Only the original index is hashed: texcoords are compared with float equality (so 0.0 == -0.0),
+// which a bitwise hash of the texcoords would not respect
+static uint32_t hashVertex(const Vertex& vertex) {
+    return (uint32_t)vertex.originalIndex * 2654435761u;
+}
+
+// A single polygon vertex with all of its attributes resolved, but not yet deduplicated
+class Corner {
+public:
+    Vertex vertex;
+    uint32_t hash;
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec4 color;
+};
+
+// Open-addressing (linear probing) table mapping a Vertex to its index in the extracted mesh.
+// Keys live in a flat array indexed by the extracted index, so a probe touches one contiguous slot array
+// instead of chasing QHash nodes.
+class VertexDedupTable {
+public:
+    void reserve(int count) {
+        size_t capacity = MIN_DEDUP_TABLE_CAPACITY;
+        while (capacity < (size_t)count * 2) {
+            capacity <<= 1;
+        }
+        _slots.assign(capacity, Slot());
+        _vertices.clear();
+        _vertices.reserve(count);
+    }
+
+    // Returns the index of an equal vertex if one was already inserted, otherwise inserts
+    // the vertex with the next index and returns -1
+    int findOrInsert(const Vertex& vertex, uint32_t hash) {
+        if ((_vertices.size() + 1) * 2 > _slots.size()) {
+            grow();
+        }
+        size_t mask = _slots.size() - 1;
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+            Slot& slot = _slots[i];
+            if (slot.index < 0) {
+                slot.hash = hash;
+                slot.index = (int)_vertices.size();
+                _vertices.push_back(vertex);
+                return -1;
+            }
+            if (slot.hash == hash && _vertices[slot.index] == vertex) {
+                return slot.index;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t hash { 0 };
+        int index { -1 };
+    };
+
+    void grow() {
+        std::vector<Slot> oldSlots(_slots.size() * 2);
+        oldSlots.swap(_slots);
+        size_t mask = _slots.size() - 1;
+        for (const Slot& old : oldSlots) {
+            if (old.index >= 0) {
+                size_t i = old.hash & mask;
+                while (_slots[i].index >= 0) {
+                    i = (i + 1) & mask;
+                }
+                _slots[i] = old;
+            }
+        }
+    }
+
+    std::vector<Slot> _slots = std::vector<Slot>(MIN_DEDUP_TABLE_CAPACITY);
+    std::vector<Vertex> _vertices;
+};
+
 class AttributeData {
 public:
     QVector<glm::vec2> texCoords;
@@ -67,29 +144,27 @@ public:
     QVector<glm::vec2> texCoords;
     QVector<int> texCoordIndices;
 
-    QHash<Vertex, int> indices;
+    std::vector<Corner> corners;
+    VertexDedupTable indices;
 
     std::vector<AttributeData> attributes;
 };
 
 
-void appendIndex(MeshData& data, QVector<int>& indices, int index) {
-    if (index >= data.polygonIndices.size()) {
-        return;
-    }
+void resolveCorner(const MeshData& data, int index, Corner& corner) {
     int vertexIndex = data.polygonIndices.at(index);
     if (vertexIndex < 0) {
         vertexIndex = -vertexIndex - 1;
     }
-    Vertex vertex;
+    Vertex& vertex = corner.vertex;
     vertex.originalIndex = vertexIndex;
     
-    glm::vec3 position;
+    glm::vec3& position = corner.position;
     if (vertexIndex < data.vertices.size()) {
         position = data.vertices.at(vertexIndex);
     }
 
-    glm::vec3 normal;
+    glm::vec3& normal = corner.normal;
     int normalIndex = data.normalsByVertex ? vertexIndex : index;
     if (data.normalIndices.isEmpty()) {    
         if (normalIndex < data.normals.size()) {
@@ -103,7 +178,7 @@ void appendIndex(MeshData& data, QVector<int>& indices, int index) {
     }
 
 
-    glm::vec4 color;
+    glm::vec4& color = corner.color;
     bool hasColors = (data.colors.size() > 1);
     if (hasColors) {
         int colorIndex = data.colorsByVertex ? vertexIndex : index;
@@ -144,24 +219,34 @@ void appendIndex(MeshData& data, QVector<int>& indices, int index) {
         }
     }
 
-    QHash<Vertex, int>::const_iterator it = data.indices.find(vertex);
-    if (it == data.indices.constEnd()) {
+    corner.hash = hashVertex(vertex);
+}
+
+void appendIndex(MeshData& data, QVector<int>& indices, int index) {
+    if (index >= data.polygonIndices.size()) {
+        return;
+    }
+    const Corner& corner = data.corners[index];
+    bool hasColors = (data.colors.size() > 1);
+    bool hasMoreTexcoords = (data.attributes.size() > 1);
+
+    int existingIndex = data.indices.findOrInsert(corner.vertex, corner.hash);
+    if (existingIndex < 0) {
         int newIndex = data.extracted.mesh.vertices.size();
         indices.append(newIndex);
-        data.indices.insert(vertex, newIndex);
-        data.extracted.newIndices.insert(vertexIndex, newIndex);
-        data.extracted.mesh.vertices.append(position);
-        data.extracted.mesh.normals.append(normal);
-        data.extracted.mesh.texCoords.append(vertex.texCoord);
+        data.extracted.newIndices.insert(corner.vertex.originalIndex, newIndex);
+        data.extracted.mesh.vertices.append(corner.position);
+        data.extracted.mesh.normals.append(corner.normal);
+        data.extracted.mesh.texCoords.append(corner.vertex.texCoord);
         if (hasColors) {
-            data.extracted.mesh.colors.append(glm::vec3(color));
+            data.extracted.mesh.colors.append(glm::vec3(corner.color));
         }
         if (hasMoreTexcoords) {
-            data.extracted.mesh.texCoords1.append(vertex.texCoord1);
+            data.extracted.mesh.texCoords1.append(corner.vertex.texCoord1);
         }
     } else {
-        indices.append(*it);
-        data.extracted.mesh.normals[*it] += normal;
+        indices.append(existingIndex);
+        data.extracted.mesh.normals[existingIndex] += corner.normal;
     }
 }
 
@@ -328,6 +413,19 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
     // TODO: make excellent use of isMultiMaterial
     Q_UNUSED(isMultiMaterial);
 
+    // Resolving the attributes of every polygon vertex is independent work, so do it across cores in chunks.
+    // Deduplication below stays serial so that vertex order and accumulated normals are identical to
+    // a single threaded extraction.
+    const int CORNER_CHUNK_SIZE = 4096;
+    data.corners.resize(data.polygonIndices.size());
+    tbb::parallel_for(tbb::blocked_range<int>(0, data.polygonIndices.size(), CORNER_CHUNK_SIZE),
+        [&data](const tbb::blocked_range<int>& range) {
+        for (int index = range.begin(); index != range.end(); ++index) {
+            resolveCorner(data, index, data.corners[index]);
+        }
+    });
+    data.indices.reserve(data.vertices.size());
+
     // convert the polygons to quads and triangles
     int polygonIndex = 0;
     QHash<QPair<int, int>, int> materialTextureParts;
@@ -0,0 +1,306 @@
+//
+//  BlockCompressor.cpp
+//  image/src/image
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <Profile.h>
+#include <TBBHelpers.h>
+
+static const int BLOCK_WIDTH = 4;
+static const int BLOCK_TEXELS = BLOCK_WIDTH * BLOCK_WIDTH;
+static const int BLOCK_ROWS_PER_TASK = 4;
+
+static const int POWER_ITERATIONS = 8;
+static const int REFINE_ITERATIONS = 2;
+
+// the weight of the first endpoint in each of the colors of a 4 color block
+static const float COLOR_WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+namespace {
+
+void writeUInt16(uint8_t* dest, uint16_t value) {
+    dest[0] = (uint8_t)(value & 0xFF);
+    dest[1] = (uint8_t)(value >> 8);
+}
+
+void writeUInt32(uint8_t* dest, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        dest[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+uint16_t packRGB565(const glm::vec3& color) {
+    glm::ivec3 quantized = glm::ivec3(glm::clamp(color, 0.0f, 255.0f) * glm::vec3(31.0f, 63.0f, 31.0f) / 255.0f + 0.5f);
+    return (uint16_t)((quantized.r << 11) | (quantized.g << 5) | quantized.b);
+}
+
+glm::vec3 unpackRGB565(uint16_t packed) {
+    int red = (packed >> 11) & 31;
+    int green = (packed >> 5) & 63;
+    int blue = packed & 31;
+    return glm::vec3((float)((red << 3) | (red >> 2)), (float)((green << 2) | (green >> 4)), (float)((blue << 3) | (blue >> 2)));
+}
+
+float distanceSquared(const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 difference = a - b;
+    return glm::dot(difference, difference);
+}
+
+// picks the closest of the 4 colors for each texel, and returns the squared error
+float evalColorIndices(const glm::vec3* texels, uint16_t& color0, uint16_t& color1, uint32_t& indices) {
+    // the first endpoint must be the greater for a BC1 block to have 4 colors
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    indices = 0;
+    float error = 0.0f;
+    if (color0 == color1) {
+        glm::vec3 color = unpackRGB565(color0);
+        for (int i = 0; i < BLOCK_TEXELS; ++i) {
+            error += distanceSquared(texels[i], color);
+        }
+        return error;
+    }
+
+    glm::vec3 endpoint0 = unpackRGB565(color0);
+    glm::vec3 endpoint1 = unpackRGB565(color1);
+    glm::vec3 palette[4];
+    for (int i = 0; i < 4; ++i) {
+        palette[i] = endpoint0 * COLOR_WEIGHTS[i] + endpoint1 * (1.0f - COLOR_WEIGHTS[i]);
+    }
+
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        int closest = 0;
+        float closestDistance = FLT_MAX;
+        for (int j = 0; j < 4; ++j) {
+            float distance = distanceSquared(texels[i], palette[j]);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closest = j;
+            }
+        }
+        indices |= (uint32_t)closest << (2 * i);
+        error += closestDistance;
+    }
+    return error;
+}
+
+// the endpoints that best fit the texels in the least squares sense for the colors they were given
+bool refineEndpoints(const glm::vec3* texels, uint32_t indices, glm::vec3& endpoint0, glm::vec3& endpoint1) {
+    float alphaSquared = 0.0f;
+    float betaSquared = 0.0f;
+    float alphaBeta = 0.0f;
+    glm::vec3 alphaTexels(0.0f);
+    glm::vec3 betaTexels(0.0f);
+
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        float alpha = COLOR_WEIGHTS[(indices >> (2 * i)) & 3];
+        float beta = 1.0f - alpha;
+        alphaSquared += alpha * alpha;
+        betaSquared += beta * beta;
+        alphaBeta += alpha * beta;
+        alphaTexels += texels[i] * alpha;
+        betaTexels += texels[i] * beta;
+    }
+
+    float determinant = alphaSquared * betaSquared - alphaBeta * alphaBeta;
+    if (fabsf(determinant) < FLT_EPSILON) {
+        return false;
+    }
+
+    endpoint0 = (alphaTexels * betaSquared - betaTexels * alphaBeta) / determinant;
+    endpoint1 = (betaTexels * alphaSquared - alphaTexels * alphaBeta) / determinant;
+    return true;
+}
+
+// a BC1 color block in 4 color mode, which is also the color block of BC3
+void compressColorBlock(const glm::vec3* texels, uint8_t* dest) {
+    glm::vec3 mean(0.0f);
+    glm::vec3 minimum(FLT_MAX);
+    glm::vec3 maximum(-FLT_MAX);
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        mean += texels[i];
+        minimum = glm::min(minimum, texels[i]);
+        maximum = glm::max(maximum, texels[i]);
+    }
+    mean /= (float)BLOCK_TEXELS;
+
+    // the endpoints are the extremes of the texels along the principal axis of their colors
+    glm::mat3 covariance(0.0f);
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        glm::vec3 offset = texels[i] - mean;
+        covariance += glm::outerProduct(offset, offset);
+    }
+
+    glm::vec3 axis = maximum - minimum;
+    for (int i = 0; i < POWER_ITERATIONS; ++i) {
+        glm::vec3 next = covariance * axis;
+        float length = glm::length(next);
+        if (length < FLT_EPSILON) {
+            break;
+        }
+        axis = next / length;
+    }
+
+    glm::vec3 endpoint0 = maximum;
+    glm::vec3 endpoint1 = minimum;
+    float minProjection = FLT_MAX;
+    float maxProjection = -FLT_MAX;
+    for (int i = 0; i < BLOCK_TEXELS; ++i) {
+        float projection = glm::dot(texels[i] - mean, axis);
+        if (projection < minProjection) {
+            minProjection = projection;
+            endpoint1 = texels[i];
+        }
+        if (projection > maxProjection) {
+            maxProjection = projection;
+            endpoint0 = texels[i];
+        }
+    }
+
+    uint16_t color0 = packRGB565(endpoint0);
+    uint16_t color1 = packRGB565(endpoint1);
+    uint32_t indices;
+    float error = evalColorIndices(texels, color0, color1, indices);
+
+    for (int i = 0; i < REFINE_ITERATIONS && error > 0.0f; ++i) {
+        if (!refineEndpoints(texels, indices, endpoint0, endpoint1)) {
+            break;
+        }
+
+        uint16_t refinedColor0 = packRGB565(endpoint0);
+        uint16_t refinedColor1 = packRGB565(endpoint1);
+        uint32_t refinedIndices;
+        float refinedError = evalColorIndices(texels, refinedColor0, refinedColor1, refinedIndices);
+        if (refinedError >= error) {
+            break;
+        }
+        color0 = refinedColor0;
+        color1 = refinedColor1;
+        indices = refinedIndices;
+        error = refinedError;
+    }
+
+    writeUInt16(dest, color0);
+    writeUInt16(dest + 2, color1);
+    writeUInt32(dest + 4, indices);
+}
+
+// a BC4 block in 8 value mode, which is also the alpha block of BC3 and each channel of BC5
+void compressChannelBlock(const uint8_t* values, uint8_t* dest) {
+    uint8_t minimum = *std::min_element(values, values + BLOCK_TEXELS);
+    uint8_t maximum = *std::max_element(values, values + BLOCK_TEXELS);
+
+    uint64_t indices = 0;
+    if (maximum > minimum) {
+        float scale = 7.0f / (float)(maximum - minimum);
+        for (int i = 0; i < BLOCK_TEXELS; ++i) {
+            // the steps from the minimum, which are indices 1, 7, 6, ..., 2, 0
+            int step = (int)((float)(values[i] - minimum) * scale + 0.5f);
+            uint64_t index = step == 7 ? 0 : (step == 0 ? 1 : 8 - step);
+            indices |= index << (3 * i);
+        }
+    }
+
+    dest[0] = maximum;
+    dest[1] = minimum;
+    for (int i = 0; i < 6; ++i) {
+        dest[2 + i] = (uint8_t)(indices >> (8 * i));
+    }
+}
+
+} // anonymous namespace
+
+namespace image {
+
+size_t evalBlockCompressedSize(int width, int height, BlockFormat format) {
+    size_t blockSize = (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8 : 16;
+    size_t blocksWide = (width + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+    size_t blocksHigh = (height + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+    return blocksWide * blocksHigh * blockSize;
+}
+
+void compressBlocks(const QImage& srcImage, BlockFormat format, uint8_t* dest) {
+    PROFILE_RANGE(resource_parse, "compressBlocks");
+
+    QImage image = srcImage;
+    if (image.format() != QImage::Format_ARGB32) {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    const int blocksWide = (width + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+    const int blocksHigh = (height + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+    const size_t blockSize = evalBlockCompressedSize(BLOCK_WIDTH, BLOCK_WIDTH, format);
+    const uchar* bits = image.constBits();
+    const int stride = image.bytesPerLine();
+
+    tbb::parallel_for(tbb::blocked_range<int>(0, blocksHigh, BLOCK_ROWS_PER_TASK), [&](const tbb::blocked_range<int>& range) {
+        QRgb texels[BLOCK_TEXELS];
+        glm::vec3 colors[BLOCK_TEXELS];
+        uint8_t values[BLOCK_TEXELS];
+
+        for (int blockY = range.begin(); blockY < range.end(); ++blockY) {
+            uint8_t* block = dest + blockY * blocksWide * blockSize;
+
+            for (int blockX = 0; blockX < blocksWide; ++blockX, block += blockSize) {
+                for (int y = 0; y < BLOCK_WIDTH; ++y) {
+                    auto row = reinterpret_cast<const QRgb*>(bits + std::min(blockY * BLOCK_WIDTH + y, height - 1) * stride);
+                    for (int x = 0; x < BLOCK_WIDTH; ++x) {
+                        texels[y * BLOCK_WIDTH + x] = row[std::min(blockX * BLOCK_WIDTH + x, width - 1)];
+                    }
+                }
+
+                switch (format) {
+                    case BlockFormat::BC1:
+                    case BlockFormat::BC3: {
+                        uint8_t* colorBlock = block;
+                        if (format == BlockFormat::BC3) {
+                            for (int i = 0; i < BLOCK_TEXELS; ++i) {
+                                values[i] = (uint8_t)qAlpha(texels[i]);
+                            }
+                            compressChannelBlock(values, block);
+                            colorBlock += 8;
+                        }
+                        for (int i = 0; i < BLOCK_TEXELS; ++i) {
+                            colors[i] = glm::vec3((float)qRed(texels[i]), (float)qGreen(texels[i]), (float)qBlue(texels[i]));
+                        }
+                        compressColorBlock(colors, colorBlock);
+                        break;
+                    }
+
+                    case BlockFormat::BC4:
+                    case BlockFormat::BC5:
+                        for (int i = 0; i < BLOCK_TEXELS; ++i) {
+                            values[i] = (uint8_t)qRed(texels[i]);
+                        }
+                        compressChannelBlock(values, block);
+                        if (format == BlockFormat::BC5) {
+                            for (int i = 0; i < BLOCK_TEXELS; ++i) {
+                                values[i] = (uint8_t)qGreen(texels[i]);
+                            }
+                            compressChannelBlock(values, block + 8);
+                        }
+                        break;
+                }
+            }
+        }
+    });
+}
+
+} // namespace image
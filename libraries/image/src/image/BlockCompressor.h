@@ -0,0 +1,37 @@
+//
+//  BlockCompressor.h
+//  image/src/image
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_image_BlockCompressor_h
+#define hifi_image_BlockCompressor_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include <QImage>
+
+namespace image {
+
+enum class BlockFormat {
+    BC1, // opaque color
+    BC3, // color and alpha
+    BC4, // red
+    BC5  // red and green
+};
+
+// The size of an image once compressed, in rows of 4x4 blocks.
+size_t evalBlockCompressedSize(int width, int height, BlockFormat format);
+
+// Compresses the image to dest, which holds evalBlockCompressedSize bytes.  The rows of blocks are compressed in parallel,
+// and the blocks at the right and bottom edges of an image that isn't a multiple of 4 repeat its last column and row.
+void compressBlocks(const QImage& image, BlockFormat format, uint8_t* dest);
+
+} // namespace image
+
+#endif // hifi_image_BlockCompressor_h
@@ -24,7 +24,9 @@
 #include <GLMHelpers.h>
 #include <SettingHandle.h>
 
+#include "BlockCompressor.h"
 #include "ImageLogging.h"
+#include "MipGenerator.h"
 
 using namespace gpu;
 
@@ -35,6 +37,7 @@ static Setting::Handle<bool> compressColorTextures("hifi.graphics.compressColorT
 static Setting::Handle<bool> compressNormalTextures("hifi.graphics.compressNormalTextures", false);
 static Setting::Handle<bool> compressGrayscaleTextures("hifi.graphics.compressGrayscaleTextures", false);
 static Setting::Handle<bool> compressCubeTextures("hifi.graphics.compressCubeTextures", false);
+static Setting::Handle<bool> nativeTextureProcessing("hifi.graphics.nativeTextureProcessing", false);
 
 static const glm::uvec2 SPARSE_PAGE_SIZE(128);
 static const glm::uvec2 MAX_TEXTURE_SIZE(4096);
@@ -204,6 +207,16 @@ void setCubeTexturesCompressionEnabled(bool enabled) {
     compressCubeTextures.set(enabled);
 }
 
+bool isNativeTextureProcessingEnabled() {
+    std::lock_guard<std::mutex> guard(settingsMutex);
+    return nativeTextureProcessing.get();
+}
+
+void setNativeTextureProcessingEnabled(bool enabled) {
+    std::lock_guard<std::mutex> guard(settingsMutex);
+    nativeTextureProcessing.set(enabled);
+}
+
 
 gpu::TexturePointer processImage(const QByteArray& content, const std::string& filename, int maxNumPixels, TextureUsage::Type textureType) {
     // Help the QImage loader by extracting the image file format from the url filename ext.
@@ -262,7 +275,7 @@ gpu::TexturePointer processImage(const QByteArray& content, const std::string& f
 
 
 
-QImage processSourceImage(const QImage& srcImage, bool cubemap) {
+QImage processSourceImage(const QImage& srcImage, bool cubemap, const MipOptions& mipOptions = MipOptions()) {
     PROFILE_RANGE(resource_parse, "processSourceImage");
     const glm::uvec2 srcImageSize = toGlm(srcImage.size());
     glm::uvec2 targetSize = srcImageSize;
@@ -286,7 +299,18 @@ QImage processSourceImage(const QImage& srcImage, bool cubemap) {
     if (targetSize != srcImageSize) {
         PROFILE_RANGE(resource_parse, "processSourceImage Rectify");
         qCDebug(imagelogging) << "Resizing texture from " << srcImageSize.x << "x" << srcImageSize.y << " to " << targetSize.x << "x" << targetSize.y;
-        return srcImage.scaled(fromGlm(targetSize), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        QImage image = srcImage;
+        if (isNativeTextureProcessingEnabled()) {
+            // halve it as a mip while that doesn't go below the target, which usually is all of the way
+            while (glm::all(glm::greaterThanEqual(toGlm(image.size()) / 2u, targetSize))) {
+                image = generateMip(image, mipOptions);
+            }
+            if (toGlm(image.size()) == targetSize) {
+                return image;
+            }
+        }
+        return image.scaled(fromGlm(targetSize), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     }
 
     return srcImage;
@@ -331,6 +355,87 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
+// Copies the texels of an uncompressed mip in the layout of its format, each line padded to lineSize.
+void copyMipTexels(const QImage& mip, const gpu::Element& mipFormat, size_t lineSize, gpu::Byte* dest) {
+    for (int y = 0; y < mip.height(); ++y) {
+        auto row = reinterpret_cast<const QRgb*>(mip.constScanLine(y));
+        gpu::Byte* line = dest + y * lineSize;
+        for (int x = 0; x < mip.width(); ++x) {
+            QRgb texel = row[x];
+            if (mipFormat == gpu::Element::COLOR_RGBA_32 || mipFormat == gpu::Element::COLOR_SRGBA_32) {
+                *line++ = qRed(texel);
+                *line++ = qGreen(texel);
+                *line++ = qBlue(texel);
+                *line++ = qAlpha(texel);
+            } else if (mipFormat == gpu::Element::COLOR_BGRA_32 || mipFormat == gpu::Element::COLOR_SBGRA_32) {
+                *line++ = qBlue(texel);
+                *line++ = qGreen(texel);
+                *line++ = qRed(texel);
+                *line++ = qAlpha(texel);
+            } else if (mipFormat == gpu::Element::COLOR_R_8) {
+                *line++ = qRed(texel);
+            } else {
+                *line++ = qRed(texel);
+                *line++ = qGreen(texel);
+            }
+        }
+    }
+}
+
+// Generates the mips with MipGenerator and BlockCompressor, returns false for the formats only nvtt handles.
+bool generateNativeMips(gpu::Texture* texture, const QImage& image, int face) {
+    PROFILE_RANGE(resource_parse, "generateNativeMips");
+
+    MipOptions options;
+    BlockFormat blockFormat = BlockFormat::BC1;
+    bool isCompressed = true;
+
+    // data textures are filtered as they are, color ones in linear space
+    auto mipFormat = texture->getStoredMipFormat();
+    if (mipFormat == gpu::Element::COLOR_COMPRESSED_SRGB) {
+        blockFormat = BlockFormat::BC1;
+    } else if (mipFormat == gpu::Element::COLOR_COMPRESSED_SRGBA) {
+        blockFormat = BlockFormat::BC3;
+    } else if (mipFormat == gpu::Element::COLOR_COMPRESSED_RED) {
+        options.isSRGB = false;
+        blockFormat = BlockFormat::BC4;
+    } else if (mipFormat == gpu::Element::COLOR_COMPRESSED_XY) {
+        options.isNormalMap = true;
+        blockFormat = BlockFormat::BC5;
+    } else if (mipFormat == gpu::Element::COLOR_RGBA_32 || mipFormat == gpu::Element::COLOR_BGRA_32 ||
+               mipFormat == gpu::Element::COLOR_R_8) {
+        options.isSRGB = false;
+        isCompressed = false;
+    } else if (mipFormat == gpu::Element::COLOR_SRGBA_32 || mipFormat == gpu::Element::COLOR_SBGRA_32) {
+        isCompressed = false;
+    } else if (mipFormat == gpu::Element::VEC2NU8_XY) {
+        options.isNormalMap = true;
+        isCompressed = false;
+    } else {
+        return false;
+    }
+
+    auto mips = generateMipChain(image, options, texture->getNumMips());
+    for (uint16 level = 0; level < (uint16)mips.size(); ++level) {
+        const QImage& mip = mips[level];
+        std::vector<gpu::Byte> data(texture->evalStoredMipFaceSize(level, mipFormat), 0);
+
+        if (isCompressed) {
+            assert(data.size() == evalBlockCompressedSize(mip.width(), mip.height(), blockFormat));
+            compressBlocks(mip, blockFormat, data.data());
+        } else {
+            copyMipTexels(mip, mipFormat, texture->evalStoredMipLineSize(level, mipFormat), data.data());
+        }
+
+        if (face >= 0) {
+            texture->assignStoredMipFace(level, face, data.size(), data.data());
+        } else {
+            texture->assignStoredMip(level, data.size(), data.data());
+        }
+    }
+    return true;
+}
+
 void generateMips(gpu::Texture* texture, QImage& image, int face = -1) {
 #if CPU_MIPMAPS
     PROFILE_RANGE(resource_parse, "generateMips");
@@ -339,6 +444,10 @@ void generateMips(gpu::Texture* texture, QImage& image, int face = -1) {
         image = image.convertToFormat(QImage::Format_ARGB32);
     }
 
+    if (isNativeTextureProcessingEnabled() && generateNativeMips(texture, image, face)) {
+        return;
+    }
+
     const int width = image.width(), height = image.height();
     const void* data = static_cast<const void*>(image.constBits());
 
@@ -607,7 +716,10 @@ QImage processBumpMap(QImage& image) {
 }
 gpu::TexturePointer TextureUsage::process2DTextureNormalMapFromImage(const QImage& srcImage, const std::string& srcImageName, bool isBumpMap) {
     PROFILE_RANGE(resource_parse, "process2DTextureNormalMapFromImage");
-    QImage image = processSourceImage(srcImage, false);
+    MipOptions mipOptions;
+    mipOptions.isSRGB = false;
+    mipOptions.isNormalMap = !isBumpMap;
+    QImage image = processSourceImage(srcImage, false, mipOptions);
 
     if (isBumpMap) {
         image = processBumpMap(image);
@@ -638,7 +750,9 @@ gpu::TexturePointer TextureUsage::process2DTextureNormalMapFromImage(const QImag
 
 gpu::TexturePointer TextureUsage::process2DTextureGrayscaleFromImage(const QImage& srcImage, const std::string& srcImageName, bool isInvertedPixels) {
     PROFILE_RANGE(resource_parse, "process2DTextureGrayscaleFromImage");
-    QImage image = processSourceImage(srcImage, false);
+    MipOptions mipOptions;
+    mipOptions.isSRGB = false;
+    QImage image = processSourceImage(srcImage, false, mipOptions);
 
     if (image.format() != QImage::Format_ARGB32) {
         image = image.convertToFormat(QImage::Format_ARGB32);
@@ -74,6 +74,10 @@ void setNormalTexturesCompressionEnabled(bool enabled);
 void setGrayscaleTexturesCompressionEnabled(bool enabled);
 void setCubeTexturesCompressionEnabled(bool enabled);
 
+// Mips are filtered and compressed by MipGenerator and BlockCompressor rather than nvtt, except for BC7 and BC1a
+bool isNativeTextureProcessingEnabled();
+void setNativeTextureProcessingEnabled(bool enabled);
+
 gpu::TexturePointer processImage(const QByteArray& content, const std::string& url, int maxNumPixels, TextureUsage::Type textureType);
 
 } // namespace image
@@ -0,0 +1,307 @@
+//
+//  MipGenerator.cpp
+//  image/src/image
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include <NumericalConstants.h>
+#include <Profile.h>
+#include <TBBHelpers.h>
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define MIP_GENERATOR_SSE
+#include <emmintrin.h>
+#endif
+
+static const int ROWS_PER_TASK = 16;
+
+static const int LINEAR_TO_SRGB_SIZE = 1 << 14;
+
+// the Kaiser filter is 3 mip texels wide on each side, so 12 source texels contribute to each mip texel
+static const float KAISER_WIDTH = 3.0f;
+static const float KAISER_ALPHA = 4.0f;
+static const int KAISER_TAPS = 12;
+static const int KAISER_FIRST_TAP = -5;
+
+namespace {
+
+struct ColorTables {
+    float srgbToLinear[256];
+    float unormToFloat[256];
+    uint8_t linearToSRGB[LINEAR_TO_SRGB_SIZE + 1];
+
+    ColorTables() {
+        for (int i = 0; i < 256; ++i) {
+            float value = (float)i / 255.0f;
+            unormToFloat[i] = value;
+            srgbToLinear[i] = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i <= LINEAR_TO_SRGB_SIZE; ++i) {
+            float value = (float)i / (float)LINEAR_TO_SRGB_SIZE;
+            float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+            linearToSRGB[i] = (uint8_t)glm::clamp((int)(srgb * 255.0f + 0.5f), 0, 255);
+        }
+    }
+};
+
+const ColorTables& getColorTables() {
+    static const ColorTables tables;
+    return tables;
+}
+
+// the weights of the source texels of a mip texel, which are the same for every texel of a mip half the size
+struct KaiserKernel {
+    float weights[KAISER_TAPS];
+
+    KaiserKernel() {
+        auto besselI0 = [](float x) {
+            float sum = 1.0f;
+            float term = 1.0f;
+            for (int k = 1; k < 20; ++k) {
+                term *= (x / (2.0f * k)) * (x / (2.0f * k));
+                sum += term;
+            }
+            return sum;
+        };
+
+        float total = 0.0f;
+        for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+            // the distance from the center of the mip texel in mip texels
+            float x = ((float)(tap + KAISER_FIRST_TAP) - 0.5f) / 2.0f;
+            float sinc = x == 0.0f ? 1.0f : sinf(PI * x) / (PI * x);
+            float ratio = x / KAISER_WIDTH;
+            float window = fabsf(ratio) < 1.0f ? besselI0(KAISER_ALPHA * sqrtf(1.0f - ratio * ratio)) / besselI0(KAISER_ALPHA) : 0.0f;
+            weights[tap] = sinc * window;
+            total += weights[tap];
+        }
+        for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+            weights[tap] /= total;
+        }
+    }
+};
+
+const KaiserKernel& getKaiserKernel() {
+    static const KaiserKernel kernel;
+    return kernel;
+}
+
+// reflects a texel coordinate about the edges, more than once for images smaller than the filter
+int mirror(int coordinate, int size) {
+    while (coordinate < 0 || coordinate >= size) {
+        coordinate = coordinate < 0 ? -coordinate - 1 : 2 * size - 1 - coordinate;
+    }
+    return coordinate;
+}
+
+void decodeRow(const QRgb* src, int width, bool isSRGB, glm::vec4* dst) {
+    const auto& tables = getColorTables();
+    const float* colorTable = isSRGB ? tables.srgbToLinear : tables.unormToFloat;
+    for (int x = 0; x < width; ++x) {
+        QRgb pixel = src[x];
+        dst[x] = glm::vec4(colorTable[qRed(pixel)], colorTable[qGreen(pixel)], colorTable[qBlue(pixel)],
+                           tables.unormToFloat[qAlpha(pixel)]);
+    }
+}
+
+void encodeRow(glm::vec4* src, int width, const image::MipOptions& options, QRgb* dst) {
+    if (options.isNormalMap) {
+        for (int x = 0; x < width; ++x) {
+            glm::vec3 normal = glm::vec3(src[x]) * 2.0f - 1.0f;
+            float length = glm::length(normal);
+            if (length > 0.0f) {
+                normal /= length;
+            }
+            src[x] = glm::vec4(normal * 0.5f + 0.5f, src[x].w);
+        }
+    }
+
+    const auto& tables = getColorTables();
+    const bool isSRGB = options.isSRGB && !options.isNormalMap;
+    const float colorScale = isSRGB ? (float)LINEAR_TO_SRGB_SIZE : 255.0f;
+
+#ifdef MIP_GENERATOR_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_setr_ps(colorScale, colorScale, colorScale, 255.0f);
+    alignas(16) int32_t values[4];
+    for (int x = 0; x < width; ++x) {
+        __m128 color = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&src[x].x), zero), one);
+        _mm_store_si128(reinterpret_cast<__m128i*>(values), _mm_cvtps_epi32(_mm_mul_ps(color, scale)));
+        if (isSRGB) {
+            dst[x] = qRgba(tables.linearToSRGB[values[0]], tables.linearToSRGB[values[1]], tables.linearToSRGB[values[2]], values[3]);
+        } else {
+            dst[x] = qRgba(values[0], values[1], values[2], values[3]);
+        }
+    }
+#else
+    for (int x = 0; x < width; ++x) {
+        glm::vec4 color = glm::clamp(src[x], 0.0f, 1.0f);
+        glm::ivec4 values = glm::ivec4(color * glm::vec4(colorScale, colorScale, colorScale, 255.0f) + 0.5f);
+        if (isSRGB) {
+            dst[x] = qRgba(tables.linearToSRGB[values.r], tables.linearToSRGB[values.g], tables.linearToSRGB[values.b], values.a);
+        } else {
+            dst[x] = qRgba(values.r, values.g, values.b, values.a);
+        }
+    }
+#endif
+}
+
+void boxFilterRow(const glm::vec4* row0, const glm::vec4* row1, int srcWidth, glm::vec4* dst, int dstWidth) {
+    for (int x = 0; x < dstWidth; ++x) {
+        int x0 = 2 * x;
+        int x1 = std::min(x0 + 1, srcWidth - 1);
+#ifdef MIP_GENERATOR_SSE
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(&row0[x0].x), _mm_loadu_ps(&row0[x1].x)),
+                                _mm_add_ps(_mm_loadu_ps(&row1[x0].x), _mm_loadu_ps(&row1[x1].x)));
+        _mm_storeu_ps(&dst[x].x, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+        dst[x] = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * 0.25f;
+#endif
+    }
+}
+
+void kaiserFilterRow(const glm::vec4* src, int srcWidth, glm::vec4* dst, int dstWidth) {
+    const auto& kernel = getKaiserKernel();
+    for (int x = 0; x < dstWidth; ++x) {
+        int first = 2 * x + KAISER_FIRST_TAP;
+#ifdef MIP_GENERATOR_SSE
+        __m128 sum = _mm_setzero_ps();
+        for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+            __m128 texel = _mm_loadu_ps(&src[mirror(first + tap, srcWidth)].x);
+            sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(kernel.weights[tap])));
+        }
+        _mm_storeu_ps(&dst[x].x, sum);
+#else
+        glm::vec4 sum(0.0f);
+        for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+            sum += src[mirror(first + tap, srcWidth)] * kernel.weights[tap];
+        }
+        dst[x] = sum;
+#endif
+    }
+}
+
+void kaiserFilterColumns(const glm::vec4* const* rows, glm::vec4* dst, int width) {
+    const auto& kernel = getKaiserKernel();
+    for (int x = 0; x < width; ++x) {
+#ifdef MIP_GENERATOR_SSE
+        __m128 sum = _mm_setzero_ps();
+        for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&rows[tap][x].x), _mm_set1_ps(kernel.weights[tap])));
+        }
+        _mm_storeu_ps(&dst[x].x, sum);
+#else
+        glm::vec4 sum(0.0f);
+        for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+            sum += rows[tap][x] * kernel.weights[tap];
+        }
+        dst[x] = sum;
+#endif
+    }
+}
+
+} // anonymous namespace
+
+namespace image {
+
+QImage generateMip(const QImage& srcImage, const MipOptions& options) {
+    QImage image = srcImage;
+    if (image.format() != QImage::Format_ARGB32) {
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    const int srcWidth = image.width();
+    const int srcHeight = image.height();
+    const int dstWidth = std::max(srcWidth / 2, 1);
+    const int dstHeight = std::max(srcHeight / 2, 1);
+    const bool isSRGB = options.isSRGB && !options.isNormalMap;
+
+    QImage mip(dstWidth, dstHeight, QImage::Format_ARGB32);
+
+    // QImage detaches on non-const access, so the tasks only ever touch the bits
+    const uchar* srcBits = image.constBits();
+    const int srcStride = image.bytesPerLine();
+    uchar* dstBits = mip.bits();
+    const int dstStride = mip.bytesPerLine();
+
+    auto srcRow = [&](int y) {
+        return reinterpret_cast<const QRgb*>(srcBits + y * srcStride);
+    };
+    auto dstRow = [&](int y) {
+        return reinterpret_cast<QRgb*>(dstBits + y * dstStride);
+    };
+
+    tbb::parallel_for(tbb::blocked_range<int>(0, dstHeight, ROWS_PER_TASK), [&](const tbb::blocked_range<int>& range) {
+        std::vector<glm::vec4> filtered(dstWidth);
+
+        if (options.filter == MipFilter::Box) {
+            std::vector<glm::vec4> row0(srcWidth);
+            std::vector<glm::vec4> row1(srcWidth);
+
+            for (int y = range.begin(); y < range.end(); ++y) {
+                decodeRow(srcRow(2 * y), srcWidth, isSRGB, row0.data());
+                decodeRow(srcRow(std::min(2 * y + 1, srcHeight - 1)), srcWidth, isSRGB, row1.data());
+                boxFilterRow(row0.data(), row1.data(), srcWidth, filtered.data(), dstWidth);
+                encodeRow(filtered.data(), dstWidth, options, dstRow(y));
+            }
+        } else {
+            // filter the source rows of the band horizontally once, then each mip row from them vertically
+            int first = srcHeight;
+            int last = -1;
+            for (int y = range.begin(); y < range.end(); ++y) {
+                for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+                    int row = mirror(2 * y + KAISER_FIRST_TAP + tap, srcHeight);
+                    first = std::min(first, row);
+                    last = std::max(last, row);
+                }
+            }
+
+            std::vector<glm::vec4> decoded(srcWidth);
+            std::vector<glm::vec4> horizontal((last - first + 1) * dstWidth);
+            for (int row = first; row <= last; ++row) {
+                decodeRow(srcRow(row), srcWidth, isSRGB, decoded.data());
+                kaiserFilterRow(decoded.data(), srcWidth, &horizontal[(row - first) * dstWidth], dstWidth);
+            }
+
+            const glm::vec4* rows[KAISER_TAPS];
+            for (int y = range.begin(); y < range.end(); ++y) {
+                for (int tap = 0; tap < KAISER_TAPS; ++tap) {
+                    rows[tap] = &horizontal[(mirror(2 * y + KAISER_FIRST_TAP + tap, srcHeight) - first) * dstWidth];
+                }
+                kaiserFilterColumns(rows, filtered.data(), dstWidth);
+                encodeRow(filtered.data(), dstWidth, options, dstRow(y));
+            }
+        }
+    });
+
+    return mip;
+}
+
+std::vector<QImage> generateMipChain(const QImage& image, const MipOptions& options, int maxNumMips) {
+    PROFILE_RANGE(resource_parse, "generateMipChain");
+
+    std::vector<QImage> mips;
+    mips.push_back(image.format() == QImage::Format_ARGB32 ? image : image.convertToFormat(QImage::Format_ARGB32));
+
+    while ((mips.back().width() > 1 || mips.back().height() > 1) && (maxNumMips < 0 || (int)mips.size() < maxNumMips)) {
+        // each mip is filtered from the one before it, the work is in the first few anyway
+        mips.push_back(generateMip(mips.back(), options));
+    }
+    return mips;
+}
+
+} // namespace image
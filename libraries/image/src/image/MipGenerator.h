@@ -0,0 +1,44 @@
+//
+//  MipGenerator.h
+//  image/src/image
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_image_MipGenerator_h
+#define hifi_image_MipGenerator_h
+
+#include <vector>
+
+#include <QImage>
+
+namespace image {
+
+enum class MipFilter {
+    Box,    // the average of each 2x2 block
+    Kaiser  // a Kaiser windowed sinc three texels wide, sharper than the box
+};
+
+struct MipOptions {
+    MipFilter filter { MipFilter::Box };
+
+    // the color channels are sRGB encoded and are filtered in linear space, alpha always is linear
+    bool isSRGB { true };
+
+    // the color channels hold a normal, which is renormalized in each mip
+    bool isNormalMap { false };
+};
+
+// The mip after image, half its size rounded down.  The image is split in bands of rows that are filtered in parallel.
+// Both are QImage::Format_ARGB32.
+QImage generateMip(const QImage& image, const MipOptions& options = MipOptions());
+
+// The mips of image from the image itself down to 1x1, or down to maxNumMips of them.
+std::vector<QImage> generateMipChain(const QImage& image, const MipOptions& options = MipOptions(), int maxNumMips = -1);
+
+} // namespace image
+
+#endif // hifi_image_MipGenerator_h
@@ -17,6 +17,7 @@
 using namespace ktx;
 
 int ktxDescriptorMetaTypeId = qRegisterMetaType<KTXDescriptor*>();
+int ktxDecompressorMetaTypeId = qRegisterMetaType<Decompressor*>();
 
 const Header::Identifier ktx::Header::IDENTIFIER {{
     0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
@@ -144,6 +145,22 @@ ImageDescriptors Header::generateImageDescriptors() const {
 }
 
 
+size_t SupercompressionTable::getImageOffset(uint16_t level) const {
+    size_t imageOffset = 0;
+    for (uint16_t l = 0; l < level && l < imageSizes.size(); ++l) {
+        imageOffset += ktx::IMAGE_SIZE_WIDTH + evalPaddedSize(imageSizes[l]);
+    }
+    return imageOffset;
+}
+
+size_t SupercompressionTable::getDictionaryOffset() const {
+    return getImageOffset((uint16_t)imageSizes.size());
+}
+
+size_t SupercompressionTable::getTexelsDataSize() const {
+    return getDictionaryOffset() + evalPaddedSize(dictionarySize);
+}
+
 KeyValue::KeyValue(const std::string& key, uint32_t valueByteSize, const Byte* value) :
     _byteSize((uint32_t) key.size() + 1 + valueByteSize), // keyString size + '\0' ending char + the value size
     _key(key),
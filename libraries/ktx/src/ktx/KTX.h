@@ -86,6 +86,7 @@ namespace ktx {
 
     // FIXME move out of this header, not specific to ktx
     const std::string HIFI_MIN_POPULATED_MIP_KEY { "hifi.minMip" };
+    const std::string HIFI_SUPERCOMPRESSION_KEY { "hifi.zstd" };
 
 
     using Byte = uint8_t;
@@ -309,6 +310,60 @@ namespace ktx {
 
     using Images = std::vector<Image>;
 
+    /*
+    **** A supercompressed KTX keeps the header of the KTX it was made from, which still describes the texels, but each
+    **** image is compressed with zstd on its own so that a byte range of the file still holds whole mips
+
+    for each keyValuePair of the original KTX, and
+        HIFI_SUPERCOMPRESSION_KEY
+            UInt32 version
+            UInt32 dictionarySize
+            UInt32 numberOfMipmapLevels
+            UInt32 compressedImageSize[numberOfMipmapLevels]
+    end
+
+    for each mipmap_level in numberOfMipmapLevels*
+        UInt32 compressedImageSize
+        Byte   data[compressedImageSize]
+        Byte   mipPadding[3 - ((compressedImageSize + 3) % 4)]
+    end
+
+    Byte dictionary[dictionarySize]
+    Byte dictionaryPadding[3 - ((dictionarySize + 3) % 4)]
+
+    The dictionary is last so that it comes with the smallest mips in a request for the end of the file.
+    */
+    struct SupercompressionTable {
+        static const uint32_t VERSION { 1 };
+
+        uint32_t dictionarySize { 0 };
+        std::vector<uint32_t> imageSizes;
+
+        // False if the key values aren't those of a supercompressed KTX
+        static bool parse(const KeyValues& keyValues, SupercompressionTable& table);
+        KeyValue toKeyValue() const;
+
+        // The byte offset of the compressed image from the start of the image region, like ImageHeader::_imageOffset
+        size_t getImageOffset(uint16_t level) const;
+        size_t getDictionaryOffset() const;
+        size_t getTexelsDataSize() const;
+    };
+
+    // Decompresses the images of a supercompressed KTX, from any number of threads at once
+    class Decompressor {
+    public:
+        Decompressor(const Byte* dictionary = nullptr, size_t dictionarySize = 0);
+        ~Decompressor();
+        Decompressor(const Decompressor& other) = delete;
+        Decompressor& operator=(const Decompressor& other) = delete;
+
+        // False unless the source decompresses to exactly destSize bytes
+        bool decompress(const Byte* srcBytes, size_t srcSize, Byte* destBytes, size_t destSize) const;
+
+    private:
+        void* _dictionary { nullptr };
+    };
+
     class KTX;
 
     // A KTX descriptor is a lightweight container for all the information about a serialized KTX file, but without the
@@ -357,9 +412,21 @@ namespace ktx {
 
         void writeMipData(uint16_t level, const Byte* sourceBytes, size_t source_size);
 
-        // Parse a block of memory and create a KTX object from it
+        static const int DEFAULT_SUPERCOMPRESSION_LEVEL { 19 };
+        // Small enough to come with the smallest mips when the end of the file is requested
+        static const size_t MAX_DICTIONARY_SIZE { 2048 };
+
+        // Parse a block of memory and create a KTX object from it, a supercompressed KTX is decompressed first
         static std::unique_ptr<KTX> create(const StoragePointer& src);
 
+        // Compress each image of a KTX with zstd, with the dictionary if there is one, see SupercompressionTable
+        static StoragePointer supercompress(const KTX& src, const std::vector<Byte>& dictionary = std::vector<Byte>(),
+                                            int compressionLevel = DEFAULT_SUPERCOMPRESSION_LEVEL);
+        // Train a zstd dictionary on the images of a KTX, empty if there isn't enough data to train one
+        static std::vector<Byte> trainSupercompressionDictionary(const KTX& src, size_t maxDictionarySize = MAX_DICTIONARY_SIZE);
+        // A plain KTX from a supercompressed one, null if it doesn't decompress
+        static StoragePointer decompress(const StoragePointer& src);
+
         static bool checkHeaderFromStorage(size_t srcSize, const Byte* srcBytes);
         static KeyValues parseKeyValues(size_t srcSize, const Byte* srcBytes);
         static Images parseImages(const Header& header, size_t srcSize, const Byte* srcBytes);
@@ -388,5 +455,6 @@ namespace ktx {
 }
 
 Q_DECLARE_METATYPE(ktx::KTXDescriptor*);
+Q_DECLARE_METATYPE(ktx::Decompressor*);
 
 #endif // hifi_ktx_KTX_h
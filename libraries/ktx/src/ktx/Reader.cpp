@@ -10,10 +10,13 @@
 //
 #include "KTX.h"
 
+#include <algorithm>
 #include <list>
 #include <QtGlobal>
 #include <QtCore/QDebug>
 
+#include <zstd.h>
+
 #ifndef _MSC_VER
 #define NOEXCEPT noexcept
 #else
@@ -186,6 +189,128 @@ namespace ktx {
         return images;
     }
 
+    bool SupercompressionTable::parse(const KeyValues& keyValues, SupercompressionTable& table) {
+        auto found = std::find_if(keyValues.begin(), keyValues.end(), [](const KeyValue& keyValue) {
+            return keyValue._key == HIFI_SUPERCOMPRESSION_KEY;
+        });
+        if (found == keyValues.end()) {
+            return false;
+        }
+
+        try {
+            // version, dictionary size and number of levels, then the size of each level
+            static const size_t FIELDS_SIZE { 3 * sizeof(uint32_t) };
+            const auto& value = found->_value;
+            if (value.size() < FIELDS_SIZE) {
+                throw ReaderException("supercompression table is too short");
+            }
+
+            uint32_t fields[3];
+            memcpy(fields, value.data(), FIELDS_SIZE);
+            if (fields[0] != VERSION) {
+                throw ReaderException("unsupported supercompression version " + std::to_string(fields[0]));
+            }
+            if (value.size() != FIELDS_SIZE + fields[2] * sizeof(uint32_t)) {
+                throw ReaderException("supercompression table doesn't match its number of levels");
+            }
+
+            table.dictionarySize = fields[1];
+            table.imageSizes.resize(fields[2]);
+            memcpy(table.imageSizes.data(), value.data() + FIELDS_SIZE, fields[2] * sizeof(uint32_t));
+            return true;
+        }
+        catch (const ReaderException& e) {
+            qWarning() << e.what();
+            return false;
+        }
+    }
+
+    Decompressor::Decompressor(const Byte* dictionary, size_t dictionarySize) {
+        if (dictionary && dictionarySize > 0) {
+            _dictionary = ZSTD_createDDict(dictionary, dictionarySize);
+        }
+    }
+
+    Decompressor::~Decompressor() {
+        ZSTD_freeDDict(static_cast<ZSTD_DDict*>(_dictionary));
+    }
+
+    bool Decompressor::decompress(const Byte* srcBytes, size_t srcSize, Byte* destBytes, size_t destSize) const {
+        // the dictionary can be shared between threads but a context can't
+        auto context = ZSTD_createDCtx();
+        if (!context) {
+            return false;
+        }
+
+        size_t result;
+        if (_dictionary) {
+            result = ZSTD_decompress_usingDDict(context, destBytes, destSize, srcBytes, srcSize, static_cast<const ZSTD_DDict*>(_dictionary));
+        } else {
+            result = ZSTD_decompressDCtx(context, destBytes, destSize, srcBytes, srcSize);
+        }
+        ZSTD_freeDCtx(context);
+
+        if (ZSTD_isError(result)) {
+            qWarning() << "KTX deserialization error: " << ZSTD_getErrorName(result);
+            return false;
+        }
+        return result == destSize;
+    }
+
+    StoragePointer KTX::decompress(const StoragePointer& src) {
+        if (!src || !(*src) || !checkHeaderFromStorage(src->size(), src->data())) {
+            return nullptr;
+        }
+
+        Header header;
+        memcpy(&header, src->data(), sizeof(Header));
+        auto keyValues = parseKeyValues(header.bytesOfKeyValueData, src->data() + sizeof(Header));
+
+        SupercompressionTable table;
+        if (!SupercompressionTable::parse(keyValues, table)) {
+            return nullptr;
+        }
+
+        auto descriptors = header.generateImageDescriptors();
+        auto texels = src->data() + sizeof(Header) + header.bytesOfKeyValueData;
+        auto texelsSize = src->size() - sizeof(Header) - header.bytesOfKeyValueData;
+        try {
+            if (descriptors.size() != table.imageSizes.size()) {
+                throw ReaderException("supercompression table doesn't match the number of levels");
+            }
+            if (texelsSize < table.getTexelsDataSize()) {
+                throw ReaderException("length is too short for supercompressed data");
+            }
+        }
+        catch (const ReaderException& e) {
+            qWarning() << e.what();
+            return nullptr;
+        }
+
+        // the decompressed KTX is the one it was made from
+        keyValues.remove_if([](const KeyValue& keyValue) {
+            return keyValue._key == HIFI_SUPERCOMPRESSION_KEY;
+        });
+
+        auto storageSize = evalStorageSize(header, descriptors, keyValues);
+        std::unique_ptr<storage::MemoryStorage> memoryStorage { new storage::MemoryStorage(storageSize) };
+        writeWithoutImages(memoryStorage->data(), storageSize, header, descriptors, keyValues);
+        auto destHeader = reinterpret_cast<const Header*>(memoryStorage->data());
+        auto destTexels = memoryStorage->data() + sizeof(Header) + destHeader->bytesOfKeyValueData;
+
+        Decompressor decompressor(texels + table.getDictionaryOffset(), table.dictionarySize);
+        for (uint16_t level = 0; level < descriptors.size(); ++level) {
+            const auto& descriptor = descriptors[level];
+            if (!decompressor.decompress(texels + table.getImageOffset(level) + IMAGE_SIZE_WIDTH, table.imageSizes[level],
+                                         destTexels + descriptor._imageOffset + IMAGE_SIZE_WIDTH, descriptor._imageSize)) {
+                qWarning() << "KTX deserialization error: unable to decompress level" << level;
+                return nullptr;
+            }
+        }
+
+        return StoragePointer(memoryStorage.release());
+    }
+
     std::unique_ptr<KTX> KTX::create(const StoragePointer& src) {
         if (!src || !(*src)) {
             return nullptr;
@@ -201,6 +326,11 @@ namespace ktx {
         // read metadata
         result->_keyValues = parseKeyValues(result->getHeader().bytesOfKeyValueData, result->getKeyValueData());
 
+        SupercompressionTable table;
+        if (SupercompressionTable::parse(result->_keyValues, table)) {
+            return create(decompress(src));
+        }
+
         // populate image table
         result->_images = parseImages(result->getHeader(), result->getTexelsDataSize(), result->getTexelsData());
         if (result->_images.size() != result->getHeader().getNumberOfLevels()) {
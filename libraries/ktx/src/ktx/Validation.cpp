@@ -320,6 +320,33 @@ bool validateKeyValueData(AlignedStreamBuffer kvbuffer) {
     return true;
 }
 
+bool validateSupercompressedImageData(AlignedStreamBuffer buffer, const Header& header, const SupercompressionTable& table) {
+    if (table.imageSizes.size() != header.numberOfMipmapLevels) {
+        qDebug() << "Supercompression table doesn't match the number of mips";
+        return false;
+    }
+
+    for (auto compressedImageSize : table.imageSizes) {
+        uint32_t imageSize;
+        if (!buffer.read(imageSize) || imageSize != compressedImageSize) {
+            qDebug() << "Invalid compressed image size";
+            return false;
+        }
+        if (!buffer.skip(imageSize)) {
+            qDebug() << "Unable to skip past compressed image data";
+            return false;
+        }
+    }
+
+    if (!buffer.skip(table.dictionarySize)) {
+        qDebug() << "Unable to skip past compression dictionary";
+        return false;
+    }
+
+    // The buffer should be empty afer we've skipped the dictionary
+    return buffer.empty();
+}
+
 bool KTX::validate(const StoragePointer& src) {
     if (!checkAlignment(src->size())) {
         // All KTX data is 4-byte aligned
@@ -352,6 +379,12 @@ bool KTX::validate(const StoragePointer& src) {
         return false;
     }
 
+    // A supercompressed KTX has compressed images and a dictionary instead
+    SupercompressionTable table;
+    auto keyValues = parseKeyValues(header.bytesOfKeyValueData, src->data() + sizeof(Header));
+    if (SupercompressionTable::parse(keyValues, table)) {
+        return validateSupercompressedImageData(buffer, header, table);
+    }
 
     // Validate the images
     for (uint32_t mip = 0; mip < header.numberOfMipmapLevels; ++mip) {
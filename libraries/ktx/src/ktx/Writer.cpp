@@ -11,8 +11,14 @@
 #include "KTX.h"
 
 
+#include <algorithm>
+
 #include <QtGlobal>
 #include <QtCore/QDebug>
+
+#include <zstd.h>
+#include <zdict.h>
+
 #ifndef _MSC_VER
 #define NOEXCEPT noexcept
 #else
@@ -253,4 +259,111 @@ namespace ktx {
 
         //memcpy(reinterpret_cast<void*>(_images[level]._faceBytes[0]), sourceBytes, sourceSize);
     }
+
+    KeyValue SupercompressionTable::toKeyValue() const {
+        std::vector<uint32_t> value { VERSION, dictionarySize, (uint32_t)imageSizes.size() };
+        value.insert(value.end(), imageSizes.begin(), imageSizes.end());
+        return KeyValue(HIFI_SUPERCOMPRESSION_KEY, (uint32_t)(value.size() * sizeof(uint32_t)), reinterpret_cast<const Byte*>(value.data()));
+    }
+
+    StoragePointer KTX::supercompress(const KTX& src, const std::vector<Byte>& dictionary, int compressionLevel) {
+        const auto& header = src.getHeader();
+        if (src._images.size() != header.getNumberOfLevels()) {
+            qWarning() << "KTX serialization error: cannot supercompress a KTX without all of its mips";
+            return nullptr;
+        }
+
+        SupercompressionTable table;
+        table.dictionarySize = (uint32_t)dictionary.size();
+        std::vector<std::vector<Byte>> compressedImages;
+
+        auto context = ZSTD_createCCtx();
+        auto compressionDictionary = dictionary.empty() ? nullptr :
+            ZSTD_createCDict(dictionary.data(), dictionary.size(), compressionLevel);
+        for (const auto& image : src._images) {
+            if (image._faceBytes.empty()) {
+                break;
+            }
+
+            // the faces of an image are next to each other, so they are compressed together
+            std::vector<Byte> compressed(ZSTD_compressBound(image._imageSize));
+            size_t compressedSize;
+            if (compressionDictionary) {
+                compressedSize = ZSTD_compress_usingCDict(context, compressed.data(), compressed.size(),
+                                                          image._faceBytes[0], image._imageSize, compressionDictionary);
+            } else {
+                compressedSize = ZSTD_compressCCtx(context, compressed.data(), compressed.size(),
+                                                   image._faceBytes[0], image._imageSize, compressionLevel);
+            }
+            if (ZSTD_isError(compressedSize)) {
+                qWarning() << "KTX serialization error: " << ZSTD_getErrorName(compressedSize);
+                break;
+            }
+
+            compressed.resize(compressedSize);
+            table.imageSizes.push_back((uint32_t)compressedSize);
+            compressedImages.push_back(std::move(compressed));
+        }
+        ZSTD_freeCDict(compressionDictionary);
+        ZSTD_freeCCtx(context);
+
+        if (compressedImages.size() != src._images.size()) {
+            return nullptr;
+        }
+
+        auto keyValues = src._keyValues;
+        keyValues.emplace_back(table.toKeyValue());
+        auto keyValuesSize = KeyValue::serializedKeyValuesByteSize(keyValues);
+
+        auto storageSize = sizeof(Header) + keyValuesSize + table.getTexelsDataSize();
+        auto memoryStorage = new storage::MemoryStorage(storageSize);
+        auto destBytes = memoryStorage->data();
+
+        auto destHeader = reinterpret_cast<Header*>(destBytes);
+        memcpy(destBytes, &header, sizeof(Header));
+        destHeader->bytesOfKeyValueData = (uint32_t)writeKeyValues(destBytes + sizeof(Header), keyValuesSize, keyValues);
+
+        auto destTexels = destBytes + sizeof(Header) + destHeader->bytesOfKeyValueData;
+        for (uint16_t level = 0; level < compressedImages.size(); ++level) {
+            auto destImage = destTexels + table.getImageOffset(level);
+            *reinterpret_cast<uint32_t*>(destImage) = table.imageSizes[level];
+            memcpy(destImage + IMAGE_SIZE_WIDTH, compressedImages[level].data(), compressedImages[level].size());
+        }
+        if (!dictionary.empty()) {
+            memcpy(destTexels + table.getDictionaryOffset(), dictionary.data(), dictionary.size());
+        }
+
+        return StoragePointer(memoryStorage);
+    }
+
+    std::vector<Byte> KTX::trainSupercompressionDictionary(const KTX& src, size_t maxDictionarySize) {
+        // zstd trains on many small samples, about a hundred times the size of the dictionary.  They are taken from the
+        // smallest mips up, which are those that compress poorly on their own
+        static const size_t SAMPLE_SIZE { 1024 };
+        const size_t maxSamplesSize = 100 * maxDictionarySize;
+
+        std::vector<Byte> samples;
+        std::vector<size_t> sampleSizes;
+        for (auto image = src._images.rbegin(); image != src._images.rend() && samples.size() < maxSamplesSize; ++image) {
+            if (image->_faceBytes.empty()) {
+                continue;
+            }
+            for (size_t offset = 0; offset < image->_imageSize && samples.size() < maxSamplesSize; offset += SAMPLE_SIZE) {
+                auto sampleSize = std::min(SAMPLE_SIZE, image->_imageSize - offset);
+                samples.insert(samples.end(), image->_faceBytes[0] + offset, image->_faceBytes[0] + offset + sampleSize);
+                sampleSizes.push_back(sampleSize);
+            }
+        }
+
+        std::vector<Byte> dictionary(maxDictionarySize);
+        auto dictionarySize = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(),
+                                                    sampleSizes.data(), (unsigned)sampleSizes.size());
+        if (ZDICT_isError(dictionarySize)) {
+            // too little or too uniform data to learn from, which is fine
+            return std::vector<Byte>();
+        }
+
+        dictionary.resize(dictionarySize);
+        return dictionary;
+    }
 }
@@ -0,0 +1,40 @@
+//
+//  CookedGeometryCache.cpp
+//  libraries/model-networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CookedGeometryCache.h"
+
+#include <SettingHandle.h>
+#include <CookedFBX.h>
+
+using File = cache::File;
+
+// The cooked layout carries its own version (COOKED_FBX_VERSION), which is folded in here so that
+// bumping either one wipes stale entries instead of failing to read them one at a time
+const int CookedGeometryCache::CURRENT_VERSION = 0x01 + (COOKED_FBX_VERSION << 8);
+const int CookedGeometryCache::INVALID_VERSION = 0x00;
+const char* CookedGeometryCache::SETTING_VERSION_NAME = "hifi.geometry.cache_version";
+
+CookedGeometryCache::CookedGeometryCache(const std::string& dir, const std::string& ext) :
+    FileCache(dir, ext) { }
+
+void CookedGeometryCache::initialize() {
+    FileCache::initialize();
+    Setting::Handle<int> cacheVersionHandle(SETTING_VERSION_NAME, INVALID_VERSION);
+    auto cacheVersion = cacheVersionHandle.get();
+    if (cacheVersion != CURRENT_VERSION) {
+        wipe();
+        cacheVersionHandle.set(CURRENT_VERSION);
+    }
+}
+
+std::unique_ptr<File> CookedGeometryCache::createFile(Metadata&& metadata, const std::string& filepath) {
+    qCInfo(file_cache) << "Wrote cooked geometry" << metadata.key.c_str();
+    return FileCache::createFile(std::move(metadata), filepath);
+}
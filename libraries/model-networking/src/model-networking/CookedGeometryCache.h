@@ -0,0 +1,36 @@
+//
+//  CookedGeometryCache.h
+//  libraries/model-networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CookedGeometryCache_h
+#define hifi_CookedGeometryCache_h
+
+#include <shared/FileCache.h>
+
+// Persists parsed model geometry (see CookedFBX.h) keyed by a hash of the source content,
+// so that models seen in a previous session can skip FBX/OBJ parsing entirely
+class CookedGeometryCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    // Whenever a change is made to the serialized format for the geometry cache that isn't backward compatible,
+    // this value should be incremented.  This will force the geometry cache to be wiped
+    static const int CURRENT_VERSION;
+    static const int INVALID_VERSION;
+    static const char* SETTING_VERSION_NAME;
+
+    CookedGeometryCache(const std::string& dir, const std::string& ext);
+
+    void initialize() override;
+
+protected:
+    std::unique_ptr<cache::File> createFile(Metadata&& metadata, const std::string& filepath) override final;
+};
+
+#endif // hifi_CookedGeometryCache_h
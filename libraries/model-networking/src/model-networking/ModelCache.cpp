@@ -14,13 +14,20 @@
 #include <FSTReader.h>
 #include "FBXReader.h"
 #include "OBJReader.h"
+#include "CookedFBX.h"
 
 #include <gpu/Batch.h>
 #include <gpu/Stream.h>
 
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QThreadPool>
 
 #include <Gzip.h>
+#include <TBBHelpers.h>
+#include <shared/Storage.h>
 
 #include "ModelNetworkingLogging.h"
 #include <Trace.h>
@@ -117,6 +124,7 @@ void GeometryMappingResource::onGeometryMappingLoaded(bool success) {
         _fbxGeometry = _geometryResource->_fbxGeometry;
         _meshParts = _geometryResource->_meshParts;
         _meshes = _geometryResource->_meshes;
+        _triangleBVHs = _geometryResource->_triangleBVHs;
         _materials = _geometryResource->_materials;
 
         // Avoid holding onto extra references
@@ -141,6 +149,12 @@ public:
     virtual void run() override;
 
 private:
+    std::string getCookedGeometryKey() const;
+    FBXGeometry::Pointer readCookedGeometry(const std::string& key) const;
+    void writeCookedGeometry(const std::string& key, const FBXGeometry& geometry) const;
+
+    FBXGeometry::Pointer parseGeometry();
+
     QWeakPointer<Resource> _resource;
     QUrl _url;
     QVariantHash _mapping;
@@ -148,6 +162,73 @@ private:
     bool _combineParts;
 };
 
+std::string GeometryReader::getCookedGeometryKey() const {
+    // The parsed result depends on more than the raw bytes: the FST mapping (offsets, joint names, materials),
+    // whether parts are combined, and for OBJ the url used to resolve material libraries
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(_url.toEncoded());
+    hash.addData(_data);
+    hash.addData(QJsonDocument(QJsonObject::fromVariantHash(_mapping)).toJson(QJsonDocument::Compact));
+    hash.addData(QByteArray(_combineParts ? "1" : "0"));
+    return hash.result().toHex().toStdString();
+}
+
+FBXGeometry::Pointer GeometryReader::readCookedGeometry(const std::string& key) const {
+    FBXGeometry::Pointer fbxGeometry;
+    auto file = DependencyManager::get<ModelCache>()->_cookedGeometryCache->getFile(key);
+    if (!file) {
+        return fbxGeometry;
+    }
+
+    PROFILE_RANGE_EX(resource_parse_geometry, "GeometryReader::readCookedGeometry", 0xFF00FFFF, 0, { { "url", _url.toString() } });
+    storage::FileStorage storage(QString::fromStdString(file->getFilepath()));
+    if (!storage) {
+        qCWarning(modelnetworking) << "Failed to map cooked geometry for" << _url;
+        return fbxGeometry;
+    }
+
+    try {
+        fbxGeometry.reset(readCookedFBX(storage.data(), storage.size(), _url.path()));
+    } catch (const QString& error) {
+        qCWarning(modelnetworking) << "Ignoring cooked geometry for" << _url << ":" << error;
+    }
+    return fbxGeometry;
+}
+
+void GeometryReader::writeCookedGeometry(const std::string& key, const FBXGeometry& geometry) const {
+    PROFILE_RANGE_EX(resource_parse_geometry, "GeometryReader::writeCookedGeometry", 0xFF00FFFF, 0, { { "url", _url.toString() } });
+    QByteArray cooked = writeCookedFBX(geometry);
+    auto& cookedGeometryCache = DependencyManager::get<ModelCache>()->_cookedGeometryCache;
+    if (!cookedGeometryCache->writeFile(cooked.constData(), cache::FileCache::Metadata(key, cooked.size()))) {
+        qCWarning(modelnetworking) << _url << "failed to write cooked geometry";
+    }
+}
+
+FBXGeometry::Pointer GeometryReader::parseGeometry() {
+    FBXGeometry::Pointer fbxGeometry;
+
+    if (_url.path().toLower().endsWith(".fbx")) {
+        fbxGeometry.reset(readFBX(_data, _mapping, _url.path()));
+        if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
+            throw QString("empty geometry, possibly due to an unsupported FBX version");
+        }
+    } else if (_url.path().toLower().endsWith(".obj")) {
+        fbxGeometry.reset(OBJReader().readOBJ(_data, _mapping, _combineParts, _url));
+    } else if (_url.path().toLower().endsWith(".obj.gz")) {
+        QByteArray uncompressedData;
+        if (gunzip(_data, uncompressedData)){
+            fbxGeometry.reset(OBJReader().readOBJ(uncompressedData, _mapping, _combineParts, _url));
+        } else {
+            throw QString("failed to decompress .obj.gz" );
+        }
+
+    } else {
+        throw QString("unsupported format");
+    }
+
+    return fbxGeometry;
+}
+
 void GeometryReader::run() {
     DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
     CounterStat counter("Processing");
@@ -173,28 +254,21 @@ void GeometryReader::run() {
 
         QString urlname = _url.path().toLower();
         if (!urlname.isEmpty() && !_url.path().isEmpty() &&
-			(_url.path().toLower().endsWith(".fbx") || 
-			_url.path().toLower().endsWith(".obj") || 
-			_url.path().toLower().endsWith(".obj.gz"))) {
-            FBXGeometry::Pointer fbxGeometry;
-
-            if (_url.path().toLower().endsWith(".fbx")) {
-                fbxGeometry.reset(readFBX(_data, _mapping, _url.path()));
-                if (fbxGeometry->meshes.size() == 0 && fbxGeometry->joints.size() == 0) {
-                    throw QString("empty geometry, possibly due to an unsupported FBX version");
-                }
-            } else if (_url.path().toLower().endsWith(".obj")) {
-                fbxGeometry.reset(OBJReader().readOBJ(_data, _mapping, _combineParts, _url));
-			} else if (_url.path().toLower().endsWith(".obj.gz")) {
-				QByteArray uncompressedData;
-				if (gunzip(_data, uncompressedData)){
-					fbxGeometry.reset(OBJReader().readOBJ(uncompressedData, _mapping, _combineParts, _url));
-				} else {
-					throw QString("failed to decompress .obj.gz" );
-				}
-
-			} else {
-                throw QString("unsupported format");
+            (_url.path().toLower().endsWith(".fbx") ||
+            _url.path().toLower().endsWith(".obj") ||
+            _url.path().toLower().endsWith(".obj.gz"))) {
+
+            QElapsedTimer loadTimer;
+            loadTimer.start();
+
+            auto cookedKey = getCookedGeometryKey();
+            FBXGeometry::Pointer fbxGeometry = readCookedGeometry(cookedKey);
+            if (fbxGeometry) {
+                qCDebug(modelnetworking) << "Loaded cooked geometry for" << _url << "in" << loadTimer.elapsed() << "ms";
+            } else {
+                fbxGeometry = parseGeometry();
+                qCDebug(modelnetworking) << "Parsed geometry for" << _url << "in" << loadTimer.elapsed() << "ms";
+                writeCookedGeometry(cookedKey, *fbxGeometry);
             }
 
             // Ensure the resource has not been deleted
@@ -269,11 +343,16 @@ void GeometryDefinitionResource::setGeometryDefinition(FBXGeometry::Pointer fbxG
     }
     _meshes = meshes;
     _meshParts = parts;
+    _triangleBVHs = std::make_shared<TriangleBVHs>();
 
     finishedLoading(true);
 }
 
+const std::string ModelCache::COOKED_GEOMETRY_DIRNAME { "geometry_cache" };
+const std::string ModelCache::COOKED_GEOMETRY_EXT { "hfg" };
+
 ModelCache::ModelCache() {
+    _cookedGeometryCache->initialize();
     const qint64 GEOMETRY_DEFAULT_UNUSED_MAX_SIZE = DEFAULT_UNUSED_MAX_SIZE;
     setUnusedResourceCacheSize(GEOMETRY_DEFAULT_UNUSED_MAX_SIZE);
     setObjectName("ModelCache");
@@ -339,6 +418,7 @@ Geometry::Geometry(const Geometry& geometry) {
     _fbxGeometry = geometry._fbxGeometry;
     _meshes = geometry._meshes;
     _meshParts = geometry._meshParts;
+    _triangleBVHs = geometry._triangleBVHs;
 
     _materials.reserve(geometry._materials.size());
     for (const auto& material : geometry._materials) {
@@ -419,6 +499,74 @@ const std::shared_ptr<const NetworkMaterial> Geometry::getShapeMaterial(int part
     return nullptr;
 }
 
+static std::vector<Triangle> getModelSpaceTriangles(const FBXGeometry& geometry, const FBXMesh& mesh) {
+    const int INDICES_PER_TRIANGLE = 3;
+    const int INDICES_PER_QUAD = 4;
+    const int TRIANGLES_PER_QUAD = 2;
+
+    int totalTriangles = 0;
+    for (const FBXMeshPart& part : mesh.parts) {
+        totalTriangles += (part.quadIndices.size() / INDICES_PER_QUAD) * TRIANGLES_PER_QUAD +
+            part.triangleIndices.size() / INDICES_PER_TRIANGLE;
+    }
+
+    std::vector<Triangle> triangles;
+    triangles.reserve(totalTriangles);
+
+    // these points are transformed by the FST's offset, which includes the scaling, rotation, and translation
+    // specified by the FST/FBX. this can't change at runtime, so every model using this geometry can share them
+    auto meshTransform = geometry.offset * mesh.modelTransform;
+    auto modelSpace = [&](int index) {
+        return glm::vec3(meshTransform * glm::vec4(mesh.vertices[index], 1.0f));
+    };
+
+    for (const FBXMeshPart& part : mesh.parts) {
+        int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
+        for (int q = 0; q < numberOfQuads; q++) {
+            int vIndex = q * INDICES_PER_QUAD;
+            glm::vec3 v0 = modelSpace(part.quadIndices[vIndex]);
+            glm::vec3 v1 = modelSpace(part.quadIndices[vIndex + 1]);
+            glm::vec3 v2 = modelSpace(part.quadIndices[vIndex + 2]);
+            glm::vec3 v3 = modelSpace(part.quadIndices[vIndex + 3]);
+
+            triangles.push_back({ v0, v1, v3 });
+            triangles.push_back({ v1, v2, v3 });
+        }
+
+        int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
+        for (int t = 0; t < numberOfTris; t++) {
+            int vIndex = t * INDICES_PER_TRIANGLE;
+            glm::vec3 v0 = modelSpace(part.triangleIndices[vIndex]);
+            glm::vec3 v1 = modelSpace(part.triangleIndices[vIndex + 1]);
+            glm::vec3 v2 = modelSpace(part.triangleIndices[vIndex + 2]);
+
+            triangles.push_back({ v0, v1, v2 });
+        }
+    }
+
+    return triangles;
+}
+
+std::shared_ptr<const Geometry::MeshTriangleBVHs> Geometry::getMeshTriangleBVHs() const {
+    assert(isGeometryLoaded());
+
+    std::shared_ptr<TriangleBVHs> triangleBVHs = _triangleBVHs;
+    std::shared_ptr<const FBXGeometry> fbxGeometry = _fbxGeometry;
+    std::call_once(triangleBVHs->built, [&] {
+        PROFILE_RANGE(resource_parse, "Geometry::buildMeshTriangleBVHs");
+
+        int numberOfMeshes = fbxGeometry->meshes.size();
+        triangleBVHs->meshes.resize(numberOfMeshes);
+        tbb::parallel_for(0, numberOfMeshes, [&](int i) {
+            const FBXMesh& mesh = fbxGeometry->meshes.at(i);
+            triangleBVHs->meshes[i] = TriangleBVH(getModelSpaceTriangles(*fbxGeometry, mesh));
+        });
+    });
+
+    // alias the holder, so the trees outlive this geometry for as long as a model is using them
+    return std::shared_ptr<const MeshTriangleBVHs>(triangleBVHs, &triangleBVHs->meshes);
+}
+
 void GeometryResource::deleter() {
     resetTextures();
     Resource::deleter();
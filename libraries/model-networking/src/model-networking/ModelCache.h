@@ -12,14 +12,18 @@
 #ifndef hifi_ModelCache_h
 #define hifi_ModelCache_h
 
+#include <mutex>
+
 #include <DependencyManager.h>
 #include <ResourceCache.h>
+#include <TriangleBVH.h>
 
 #include <model/Material.h>
 #include <model/Asset.h>
 
 #include "FBXReader.h"
 #include "TextureCache.h"
+#include "CookedGeometryCache.h"
 
 // Alias instead of derive to avoid copying
 
@@ -41,6 +45,9 @@ public:
     using GeometryMeshes = std::vector<std::shared_ptr<const model::Mesh>>;
     using GeometryMeshParts = std::vector<std::shared_ptr<const MeshPart>>;
 
+    // Model space triangles of each mesh, for precision picking
+    using MeshTriangleBVHs = std::vector<TriangleBVH>;
+
     // Mutable, but must retain structure of vector
     using NetworkMaterials = std::vector<std::shared_ptr<NetworkMaterial>>;
 
@@ -50,6 +57,9 @@ public:
     const GeometryMeshes& getMeshes() const { return *_meshes; }
     const std::shared_ptr<const NetworkMaterial> getShapeMaterial(int shapeID) const;
 
+    // Built on first use, and shared by every copy of this geometry
+    std::shared_ptr<const MeshTriangleBVHs> getMeshTriangleBVHs() const;
+
     const QVariantMap getTextures() const;
     void setTextures(const QVariantMap& textureMap);
 
@@ -64,6 +74,12 @@ protected:
     std::shared_ptr<const GeometryMeshes> _meshes;
     std::shared_ptr<const GeometryMeshParts> _meshParts;
 
+    struct TriangleBVHs {
+        std::once_flag built;
+        MeshTriangleBVHs meshes;
+    };
+    std::shared_ptr<TriangleBVHs> _triangleBVHs { std::make_shared<TriangleBVHs>() };
+
     // Copied to each geometry, mutable throughout lifetime via setTextures
     NetworkMaterials _materials;
 
@@ -152,8 +168,16 @@ protected:
                                                     const void* extra) override;
 
 private:
+    friend class GeometryReader;
+
     ModelCache();
     virtual ~ModelCache() = default;
+
+    static const std::string COOKED_GEOMETRY_DIRNAME;
+    static const std::string COOKED_GEOMETRY_EXT;
+
+    std::shared_ptr<cache::FileCache> _cookedGeometryCache {
+        std::make_shared<CookedGeometryCache>(COOKED_GEOMETRY_DIRNAME, COOKED_GEOMETRY_EXT) };
 };
 
 class NetworkMaterial : public model::Material {
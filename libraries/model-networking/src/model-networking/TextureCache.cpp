@@ -365,6 +365,23 @@ NetworkTexture::~NetworkTexture() {
     }
 }
 
+// Decompresses a mip of a supercompressed KTX into mip, which is the size of the decompressed mip
+static bool decompressMip(const ktx::Decompressor& decompressor, const uint8_t* srcBytes, size_t srcSize, std::vector<uint8_t>& mip) {
+    PROFILE_RANGE(resource_parse_image_ktx, __FUNCTION__);
+    auto start = usecTimestampNow();
+    bool success = decompressor.decompress(srcBytes, srcSize, mip.data(), mip.size());
+
+    auto statTracker = DependencyManager::get<StatTracker>();
+    if (!success) {
+        statTracker->incrementStat(STAT_KTX_DECOMPRESS_FAILURES);
+        return false;
+    }
+    statTracker->updateStat(STAT_KTX_SUPERCOMPRESSED_BYTES, (int)srcSize);
+    statTracker->updateStat(STAT_KTX_DECOMPRESSED_BYTES, (int)mip.size());
+    statTracker->updateStat(STAT_KTX_DECOMPRESS_USECS, (int)(usecTimestampNow() - start));
+    return true;
+}
+
 const uint16_t NetworkTexture::NULL_MIP_LEVEL = std::numeric_limits<uint16_t>::max();
 void NetworkTexture::makeRequest() {
     if (!_sourceIsKTX) {
@@ -443,6 +460,12 @@ void NetworkTexture::startRequestForNextMipLevel() {
     }
 }
 
+void NetworkTexture::handleFailedMipLoad() {
+    // the texture keeps the mips it has, but no more are requested for it
+    _ktxResourceState = FAILED_TO_LOAD;
+    finishedLoading(false);
+}
+
 // Load mips in the range [low, high] (inclusive)
 void NetworkTexture::startMipRangeRequest(uint16_t low, uint16_t high) {
     if (_ktxMipRequest) {
@@ -471,10 +494,20 @@ void NetworkTexture::startMipRangeRequest(uint16_t low, uint16_t high) {
         connect(_ktxMipRequest, &ResourceRequest::finished, this, &NetworkTexture::ktxInitialDataRequestFinished);
     } else {
         ByteRange range;
-        range.fromInclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
-                              + _originalKtxDescriptor->images[low]._imageOffset + ktx::IMAGE_SIZE_WIDTH;
-        range.toExclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
-                              + _originalKtxDescriptor->images[high + 1]._imageOffset;
+        ktx::SupercompressionTable supercompressionTable;
+        if (ktx::SupercompressionTable::parse(_originalKtxDescriptor->keyValues, supercompressionTable)) {
+            // the mips are only as big as they compress to
+            range.fromInclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
+                                  + supercompressionTable.getImageOffset(low) + ktx::IMAGE_SIZE_WIDTH;
+            range.toExclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
+                                  + supercompressionTable.getImageOffset(high) + ktx::IMAGE_SIZE_WIDTH
+                                  + supercompressionTable.imageSizes[high];
+        } else {
+            range.fromInclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
+                                  + _originalKtxDescriptor->images[low]._imageOffset + ktx::IMAGE_SIZE_WIDTH;
+            range.toExclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
+                                  + _originalKtxDescriptor->images[high + 1]._imageOffset;
+        }
         _ktxMipRequest->setByteRange(range);
 
         connect(_ktxMipRequest, &ResourceRequest::finished, this, &NetworkTexture::ktxMipRequestFinished);
@@ -573,8 +606,10 @@ void NetworkTexture::ktxMipRequestFinished() {
             auto data = _ktxMipRequest->getData();
             auto mipLevel = _ktxMipLevelRangeInFlight.first;
             auto texture = _textureSource->getGPUTexture();
+            auto decompressor = _decompressor;
+            auto mipSize = _originalKtxDescriptor->images[mipLevel]._imageSize;
             DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-            QtConcurrent::run(QThreadPool::globalInstance(), [self, data, mipLevel, url, texture] {
+            QtConcurrent::run(QThreadPool::globalInstance(), [self, data, mipLevel, url, texture, decompressor, mipSize] {
                 PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Processing Mip Data", 0xffff0000, 0, { { "url", url.toString() } });
                 DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
                 CounterStat counter("Processing");
@@ -594,7 +629,17 @@ void NetworkTexture::ktxMipRequestFinished() {
 
                 Q_ASSERT_X(texture, "Async - NetworkTexture::ktxMipRequestFinished", "NetworkTexture should have been assigned a GPU texture by now.");
 
-                texture->assignStoredMip(mipLevel, data.size(), reinterpret_cast<const uint8_t*>(data.data()));
+                if (decompressor) {
+                    std::vector<uint8_t> mip(mipSize);
+                    if (!decompressMip(*decompressor, reinterpret_cast<const uint8_t*>(data.data()), data.size(), mip)) {
+                        qCWarning(modelnetworking) << url << "failed to decompress mip" << mipLevel;
+                        QMetaObject::invokeMethod(resource.data(), "handleFailedMipLoad");
+                        return;
+                    }
+                    texture->assignStoredMip(mipLevel, mip.size(), mip.data());
+                } else {
+                    texture->assignStoredMip(mipLevel, data.size(), reinterpret_cast<const uint8_t*>(data.data()));
+                }
 
                 QMetaObject::invokeMethod(resource.data(), "setImage",
                     Q_ARG(gpu::TexturePointer, texture),
@@ -686,10 +731,36 @@ void NetworkTexture::handleFinishedInitialLoad() {
                 Q_ARG(int, 0));
             return;
         }
+
+        // A supercompressed KTX is cached as the KTX it was made from, and the mips from it are decompressed first
+        ktx::SupercompressionTable supercompressionTable;
+        std::unique_ptr<ktx::Decompressor> decompressor;
+        if (ktx::SupercompressionTable::parse(keyValues, supercompressionTable)) {
+            auto dictionarySize = supercompressionTable.dictionarySize;
+            if (supercompressionTable.imageSizes.size() != imageDescriptors.size() ||
+                ktx::evalPaddedSize(dictionarySize) > (size_t)ktxHighMipData.size()) {
+                qWarning(networking) << "Failed to process supercompressed ktx file " << url;
+                QMetaObject::invokeMethod(resource.data(), "setImage",
+                    Q_ARG(gpu::TexturePointer, nullptr),
+                    Q_ARG(int, 0),
+                    Q_ARG(int, 0));
+                return;
+            }
+
+            // the dictionary is at the very end of the file
+            auto dictionary = reinterpret_cast<const ktx::Byte*>(ktxHighMipData.data()) + ktxHighMipData.size()
+                              - ktx::evalPaddedSize(dictionarySize);
+            decompressor.reset(new ktx::Decompressor(dictionary, dictionarySize));
+        }
+
         auto originalKtxDescriptor = new ktx::KTXDescriptor(*header, keyValues, imageDescriptors);
         QMetaObject::invokeMethod(resource.data(), "setOriginalDescriptor",
             Q_ARG(ktx::KTXDescriptor*, originalKtxDescriptor));
 
+        keyValues.remove_if([](const ktx::KeyValue& keyValue) {
+            return keyValue._key == ktx::HIFI_SUPERCOMPRESSION_KEY;
+        });
+
         // Create bare ktx in memory
         auto found = std::find_if(keyValues.begin(), keyValues.end(), [](const ktx::KeyValue& val) -> bool {
             return val._key.compare(gpu::SOURCE_HASH_KEY) == 0;
@@ -757,19 +828,52 @@ void NetworkTexture::handleFinishedInitialLoad() {
             texture->setSource(filename);
 
             auto& images = originalKtxDescriptor->images;
-            size_t imageSizeRemaining = ktxHighMipData.size();
-            const uint8_t* ktxData = reinterpret_cast<const uint8_t*>(ktxHighMipData.data());
-            ktxData += ktxHighMipData.size();
-            // TODO Move image offset calculation to ktx ImageDescriptor
-            for (int level = static_cast<int>(images.size()) - 1; level >= 0; --level) {
-                auto& image = images[level];
-                if (image._imageSize > imageSizeRemaining) {
-                    break;
+            bool decompressedMips = true;
+            if (decompressor) {
+                size_t imageSizeRemaining = ktxHighMipData.size() - ktx::evalPaddedSize(supercompressionTable.dictionarySize);
+                const uint8_t* ktxData = reinterpret_cast<const uint8_t*>(ktxHighMipData.data());
+                ktxData += imageSizeRemaining;
+                for (int level = static_cast<int>(images.size()) - 1; level >= 0; --level) {
+                    auto compressedSize = supercompressionTable.imageSizes[level];
+                    auto paddedSize = ktx::evalPaddedSize(compressedSize);
+                    if (paddedSize + ktx::IMAGE_SIZE_WIDTH > imageSizeRemaining) {
+                        break;
+                    }
+                    ktxData -= paddedSize;
+                    std::vector<uint8_t> mip(images[level]._imageSize);
+                    if (!decompressMip(*decompressor, ktxData, compressedSize, mip)) {
+                        qCWarning(modelnetworking) << url << "failed to decompress mip" << level;
+                        decompressedMips = false;
+                        break;
+                    }
+                    texture->assignStoredMip(static_cast<gpu::uint16>(level), mip.size(), mip.data());
+                    ktxData -= ktx::IMAGE_SIZE_WIDTH;
+                    imageSizeRemaining -= (paddedSize + ktx::IMAGE_SIZE_WIDTH);
+                }
+            } else {
+                size_t imageSizeRemaining = ktxHighMipData.size();
+                const uint8_t* ktxData = reinterpret_cast<const uint8_t*>(ktxHighMipData.data());
+                ktxData += ktxHighMipData.size();
+                // TODO Move image offset calculation to ktx ImageDescriptor
+                for (int level = static_cast<int>(images.size()) - 1; level >= 0; --level) {
+                    auto& image = images[level];
+                    if (image._imageSize > imageSizeRemaining) {
+                        break;
+                    }
+                    ktxData -= image._imageSize;
+                    texture->assignStoredMip(static_cast<gpu::uint16>(level), image._imageSize, ktxData);
+                    ktxData -= ktx::IMAGE_SIZE_WIDTH;
+                    imageSizeRemaining -= (image._imageSize + ktx::IMAGE_SIZE_WIDTH);
                 }
-                ktxData -= image._imageSize;
-                texture->assignStoredMip(static_cast<gpu::uint16>(level), image._imageSize, ktxData);
-                ktxData -= ktx::IMAGE_SIZE_WIDTH;
-                imageSizeRemaining -= (image._imageSize + ktx::IMAGE_SIZE_WIDTH);
+            }
+
+            // the mips that came with the header are corrupt, so the rest of the file can't be trusted either
+            if (!decompressedMips) {
+                QMetaObject::invokeMethod(resource.data(), "setImage",
+                    Q_ARG(gpu::TexturePointer, nullptr),
+                    Q_ARG(int, 0),
+                    Q_ARG(int, 0));
+                return;
             }
 
             // We replace the texture with the one stored in the cache.  This deals with the possible race condition of two different
@@ -778,6 +882,11 @@ void NetworkTexture::handleFinishedInitialLoad() {
             texture = textureCache->cacheTextureByHash(filename, texture);
         }
 
+        if (decompressor) {
+            QMetaObject::invokeMethod(resource.data(), "setDecompressor",
+                Q_ARG(ktx::Decompressor*, decompressor.release()));
+        }
+
         QMetaObject::invokeMethod(resource.data(), "setImage",
             Q_ARG(gpu::TexturePointer, texture),
             Q_ARG(int, texture->getWidth()),
@@ -31,6 +31,11 @@ namespace gpu {
 class Batch;
 }
 
+const QString STAT_KTX_SUPERCOMPRESSED_BYTES = "KTXSupercompressedBytes";
+const QString STAT_KTX_DECOMPRESSED_BYTES = "KTXDecompressedBytes";
+const QString STAT_KTX_DECOMPRESS_USECS = "KTXDecompressUsecs";
+const QString STAT_KTX_DECOMPRESS_FAILURES = "KTXDecompressFailures";
+
 /// A simple object wrapper for an OpenGL texture.
 class Texture {
 public:
@@ -60,6 +65,7 @@ public:
     void refresh() override;
 
     Q_INVOKABLE void setOriginalDescriptor(ktx::KTXDescriptor* descriptor) { _originalKtxDescriptor.reset(descriptor); }
+    Q_INVOKABLE void setDecompressor(ktx::Decompressor* decompressor) { _decompressor.reset(decompressor); }
 
 signals:
     void networkTextureCreated(const QWeakPointer<NetworkTexture>& self);
@@ -80,6 +86,9 @@ protected:
 
     Q_INVOKABLE void startRequestForNextMipLevel();
 
+    // called from the processing thread when a mip that was received could not be used
+    Q_INVOKABLE void handleFailedMipLoad();
+
     void startMipRangeRequest(uint16_t low, uint16_t high);
     void handleFinishedInitialLoad();
 
@@ -119,6 +128,9 @@ private:
     // mip offsets to change.
     ktx::KTXDescriptorPointer _originalKtxDescriptor;
 
+    // Set when the source is a supercompressed KTX, its mips are decompressed before they are cached
+    std::shared_ptr<ktx::Decompressor> _decompressor;
+
 
     int _originalWidth { 0 };
     int _originalHeight { 0 };
@@ -0,0 +1,173 @@
+//
+//  AssetCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCache.h"
+
+#include <algorithm>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "NetworkLogging.h"
+
+static const std::string ASSET_CACHE_EXTENSION = "atp";
+
+// separates the hash from the range in the key of a byte range, the file cache takes what comes after a '.' as the extension
+static const char RANGE_SEPARATOR = '_';
+
+QByteArray AssetFile::read(int64_t offset, int64_t length) {
+    {
+        std::lock_guard<std::mutex> lock(_mapMutex);
+        if (!_map) {
+            _file.setFileName(QString::fromStdString(getFilepath()));
+            if (!_file.open(QIODevice::ReadOnly) || !(_map = _file.map(0, getLength()))) {
+                qCWarning(asset_client) << "Could not map" << _file.fileName() << _file.errorString();
+                return QByteArray();
+            }
+        }
+    }
+
+    // the mapping is read-only and lives as long as the file, so readers can copy from it at the same time
+    return QByteArray(reinterpret_cast<const char*>(_map) + offset, length);
+}
+
+AssetCache::AssetCache(const std::string& dirname, QObject* parent) :
+    FileCache(dirname, ASSET_CACHE_EXTENSION, parent) {
+}
+
+AssetCache::Key AssetCache::getKey(const AssetHash& hash, const ByteRange& byteRange) {
+    auto key = hash.toLower().toStdString();
+    if (byteRange.isSet()) {
+        key += RANGE_SEPARATOR + std::to_string(byteRange.fromInclusive) + RANGE_SEPARATOR + std::to_string(byteRange.toExclusive);
+    }
+    return key;
+}
+
+std::unique_ptr<cache::File> AssetCache::createFile(Metadata&& metadata, const std::string& filepath) {
+    // called for each file that is written and each that was persisted, so this keeps the ranges up to date
+    auto parts = QString::fromStdString(metadata.key).split(RANGE_SEPARATOR);
+    if (parts.size() == 3) {
+        ByteRange byteRange;
+        byteRange.fromInclusive = parts[1].toLongLong();
+        byteRange.toExclusive = parts[2].toLongLong();
+
+        if (byteRange.fromInclusive >= 0 && byteRange.size() == (int64_t)metadata.length) {
+            std::lock_guard<std::mutex> lock(_rangesMutex);
+            _ranges[parts[0].toStdString()].push_back(byteRange);
+        }
+    } else if (parts.size() == 1) {
+        std::lock_guard<std::mutex> lock(_rangesMutex);
+        _assets.insert(metadata.key);
+    }
+
+    return std::unique_ptr<cache::File>(new AssetFile(std::move(metadata), filepath));
+}
+
+AssetFilePointer AssetCache::getAssetFile(const Key& key) {
+    return std::static_pointer_cast<AssetFile>(getFile(key));
+}
+
+QByteArray AssetCache::read(const AssetHash& hash, const ByteRange& byteRange) {
+    auto hashKey = getKey(hash, ByteRange());
+
+    if (auto file = getAssetFile(hashKey)) {
+        int64_t length = (int64_t)file->getLength();
+
+        // resolve the range against the asset as the asset server does
+        ByteRange range = byteRange;
+        range.fixupRange(length);
+        if (range.fromInclusive < 0) {
+            range.fromInclusive += length;
+            range.toExclusive = length;
+        }
+
+        if (range.fromInclusive > range.toExclusive || range.toExclusive > length) {
+            // the asset server would refuse this range, let it
+            return QByteArray();
+        }
+        return file->read(range.fromInclusive, range.size());
+    }
+
+    if (!byteRange.isSet()) {
+        return QByteArray();
+    }
+
+    // the very range we asked for before
+    if (auto file = getAssetFile(getKey(hash, byteRange))) {
+        return file->read(0, file->getLength());
+    }
+
+    if (byteRange.fromInclusive < 0 || byteRange.toExclusive <= 0) {
+        // relative to the end of the asset, which only the whole asset or the same range can serve
+        return QByteArray();
+    }
+
+    // a range that covers it
+    std::vector<ByteRange> ranges;
+    {
+        std::lock_guard<std::mutex> lock(_rangesMutex);
+        auto it = _ranges.find(hashKey);
+        if (it != _ranges.end()) {
+            ranges = it->second;
+        }
+    }
+
+    for (const auto& range : ranges) {
+        if (range.fromInclusive <= byteRange.fromInclusive && range.toExclusive >= byteRange.toExclusive) {
+            if (auto file = getAssetFile(getKey(hash, range))) {
+                return file->read(byteRange.fromInclusive - range.fromInclusive, byteRange.size());
+            }
+
+            // it was evicted
+            std::lock_guard<std::mutex> lock(_rangesMutex);
+            auto& hashRanges = _ranges[hashKey];
+            hashRanges.erase(std::remove_if(hashRanges.begin(), hashRanges.end(), [&](const ByteRange& other) {
+                return other.fromInclusive == range.fromInclusive && other.toExclusive == range.toExclusive;
+            }), hashRanges.end());
+        }
+    }
+
+    return QByteArray();
+}
+
+bool AssetCache::write(const AssetHash& hash, const QByteArray& data, const ByteRange& byteRange) {
+    auto key = getKey(hash, byteRange);
+    if (getFile(key)) {
+        // assets don't change, what is cached already is what we have
+        return true;
+    }
+
+    if (byteRange.isSet() && getFile(getKey(hash, ByteRange()))) {
+        // the whole asset already serves this range
+        return true;
+    }
+
+    return (bool)writeFile(data.constData(), Metadata(key, data.size()));
+}
+
+std::vector<AssetHash> AssetCache::getAssetHashes() {
+    std::vector<Key> keys;
+    {
+        std::lock_guard<std::mutex> lock(_rangesMutex);
+        keys.assign(_assets.begin(), _assets.end());
+    }
+
+    std::vector<AssetHash> hashes;
+    for (const auto& key : keys) {
+        if (getFile(key)) {
+            hashes.push_back(QString::fromStdString(key));
+        } else {
+            // it was evicted
+            std::lock_guard<std::mutex> lock(_rangesMutex);
+            _assets.erase(key);
+        }
+    }
+    return hashes;
+}
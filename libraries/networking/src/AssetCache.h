@@ -0,0 +1,84 @@
+//
+//  AssetCache.h
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCache_h
+#define hifi_AssetCache_h
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+
+#include <shared/FileCache.h>
+
+#include "AssetUtils.h"
+#include "ByteRange.h"
+
+class AssetCacheTests;
+
+// An asset on disk, read through a mapping of the file so that a byte range of it doesn't read the rest.
+class AssetFile : public cache::File {
+public:
+    // a copy of length bytes from offset, or a null array if the file can't be mapped
+    QByteArray read(int64_t offset, int64_t length);
+
+protected:
+    AssetFile(Metadata&& metadata, const std::string& filepath) : cache::File(std::move(metadata), filepath) {}
+
+private:
+    friend class AssetCache;
+
+    std::mutex _mapMutex;
+    QFile _file;
+    const uchar* _map { nullptr };
+};
+
+using AssetFilePointer = std::shared_ptr<AssetFile>;
+
+// A disk cache of ATP assets keyed by their hash.
+//
+// Assets never change once they have a hash, so there is nothing to revalidate and the cache only stores the bytes.
+// Byte ranges of an asset are cached on their own when the whole asset isn't, so a range can be read back from the
+// whole asset or from a cached range that covers it.  It can be read from and written to from any thread.
+class AssetCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    AssetCache(const std::string& dirname, QObject* parent = nullptr);
+
+    // the asset or the byte range of it, or a null array if it isn't cached
+    QByteArray read(const AssetHash& hash, const ByteRange& byteRange = ByteRange());
+
+    // caches the asset, or the byte range of it that data holds
+    bool write(const AssetHash& hash, const QByteArray& data, const ByteRange& byteRange = ByteRange());
+
+    // the hashes of the whole assets in the cache
+    std::vector<AssetHash> getAssetHashes();
+
+protected:
+    std::unique_ptr<cache::File> createFile(Metadata&& metadata, const std::string& filepath) override final;
+
+private:
+    friend class ::AssetCacheTests;
+
+    static Key getKey(const AssetHash& hash, const ByteRange& byteRange);
+
+    AssetFilePointer getAssetFile(const Key& key);
+
+    // the ranges cached for each hash that are neither whole nor relative to the end of the asset, and the whole assets
+    std::mutex _rangesMutex;
+    std::unordered_map<Key, std::vector<ByteRange>> _ranges;
+    std::unordered_set<Key> _assets;
+};
+
+#endif // hifi_AssetCache_h
@@ -14,6 +14,8 @@
 #include <cstdint>
 
 #include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QThread>
 #include <QtScript/QScriptEngine>
@@ -29,12 +31,26 @@
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "PacketReceiver.h"
+#include "PeerAssetTransfer.h"
 #include "ResourceCache.h"
 
 MessageID AssetClient::_currentID = 0;
 
+static const QString ASSET_CACHE_DIRNAME = "atp";
+
+static const int PEER_UPDATE_INTERVAL_MS = 1000;
+static const quint64 PEER_ALLOWED_USECS = 60 * USECS_PER_SECOND;
+
 AssetClient::AssetClient() {
     _cacheDir = qApp->property(hifi::properties::APP_LOCAL_DATA_PATH).toString();
+    if (_cacheDir.isEmpty()) {
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+        _cacheDir = !cachePath.isEmpty() ? cachePath : "interfaceCache";
+    }
+
+    // made here so that requests on other threads can use it, it misses until init has restored what is on disk
+    _assetCache = std::make_shared<AssetCache>(QDir(_cacheDir).filePath(ASSET_CACHE_DIRNAME).toStdString());
+
     setCustomDeleter([](Dependency* dependency){
         static_cast<AssetClient*>(dependency)->deleteLater();
     });
@@ -46,7 +62,12 @@ AssetClient::AssetClient() {
     packetReceiver.registerListener(PacketType::AssetGetInfoReply, this, "handleAssetGetInfoReply");
     packetReceiver.registerListener(PacketType::AssetGetReply, this, "handleAssetGetReply", true);
     packetReceiver.registerListener(PacketType::AssetUploadReply, this, "handleAssetUploadReply");
+    packetReceiver.registerListener(PacketType::AssetGetPeersReply, this, "handleAssetGetPeersReply");
+    packetReceiver.registerListener(PacketType::AssetPeerExpect, this, "handleAssetPeerExpect");
+    packetReceiver.registerListener(PacketType::AssetPeerGet, this, "handleAssetPeerGet");
+    packetReceiver.registerListener(PacketType::AssetPeerGetReply, this, "handleAssetPeerGetReply");
 
+    connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, &AssetClient::handleNodeActivated);
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetClient::handleNodeKilled);
     connect(nodeList.data(), &LimitedNodeList::clientConnectionToNodeReset,
             this, &AssetClient::handleNodeClientConnectionReset);
@@ -55,13 +76,18 @@ AssetClient::AssetClient() {
 void AssetClient::init() {
     Q_ASSERT(QThread::currentThread() == thread());
 
-    // Setup disk cache if not already
+    _assetCache->initialize();
+    _assetCache->setMaxSize(MAXIMUM_CACHE_SIZE);
+
+    if (!_peerTimer) {
+        _peerTimer = new QTimer(this);
+        connect(_peerTimer, &QTimer::timeout, this, &AssetClient::updatePeers);
+        _peerTimer->start(PEER_UPDATE_INTERVAL_MS);
+    }
+
+    // Setup disk cache for the HTTP requests on this thread if not already, assets don't go through it
     auto& networkAccessManager = NetworkAccessManager::getInstance();
     if (!networkAccessManager.cache()) {
-        if (_cacheDir.isEmpty()) {
-            QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-            _cacheDir = !cachePath.isEmpty() ? cachePath : "interfaceCache";
-        }
         QNetworkDiskCache* cache = new QNetworkDiskCache();
         cache->setMaximumCacheSize(MAXIMUM_CACHE_SIZE);
         cache->setCacheDirectory(_cacheDir);
@@ -82,8 +108,8 @@ void AssetClient::cacheInfoRequest(QObject* reciever, QString slot) {
     if (auto* cache = qobject_cast<QNetworkDiskCache*>(NetworkAccessManager::getInstance().cache())) {
         QMetaObject::invokeMethod(reciever, slot.toStdString().data(), Qt::QueuedConnection,
                                   Q_ARG(QString, cache->cacheDirectory()),
-                                  Q_ARG(qint64, cache->cacheSize()),
-                                  Q_ARG(qint64, cache->maximumCacheSize()));
+                                  Q_ARG(qint64, cache->cacheSize() + (qint64)_assetCache->getSizeTotalFiles()),
+                                  Q_ARG(qint64, cache->maximumCacheSize() + MAXIMUM_CACHE_SIZE));
     } else {
         qCWarning(asset_client) << "No disk cache to get info from.";
     }
@@ -95,6 +121,9 @@ void AssetClient::clearCache() {
         return;
     }
 
+    qInfo() << "AssetClient::clearCache(): Clearing asset cache.";
+    _assetCache->wipe();
+
     if (auto cache = NetworkAccessManager::getInstance().cache()) {
         qInfo() << "AssetClient::clearCache(): Clearing disk cache.";
         cache->clear();
@@ -103,6 +132,35 @@ void AssetClient::clearCache() {
     }
 }
 
+void AssetClient::setPeerAssistEnabled(bool enabled) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setPeerAssistEnabled", Qt::QueuedConnection, Q_ARG(bool, enabled));
+        return;
+    }
+
+    if (enabled == _isPeerAssistEnabled) {
+        return;
+    }
+    _isPeerAssistEnabled = enabled;
+
+    qCDebug(asset_client) << (enabled ? "Enabling" : "Disabling") << "peer-assisted asset downloads.";
+
+    if (enabled) {
+        sendHolderUpdate(_assetCache->getAssetHashes());
+    } else {
+        sendHolderUpdate({}, false);
+
+        auto nodeList = DependencyManager::get<NodeList>();
+        for (const auto& peer : _allowedPeers) {
+            nodeList->setPeerSockAddrAllowed(peer.first, false);
+        }
+        _allowedPeers.clear();
+
+        std::lock_guard<std::mutex> lock(_heldHashesMutex);
+        _newHeldHashes.clear();
+    }
+}
+
 void AssetClient::handleAssetMappingOperationReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -219,6 +277,29 @@ MessageID AssetClient::getAsset(const QString& hash, DataOffset start, DataOffse
         return false;
     }
 
+    ByteRange byteRange;
+    byteRange.fromInclusive = start;
+    byteRange.toExclusive = end;
+
+    if (_isPeerAssistEnabled && !byteRange.isSet()) {
+        // whole assets are worth splitting between the peers that hold them, ranges go to the asset server
+        auto messageID = ++_currentID;
+
+        auto transfer = new PeerAssetTransfer(messageID, hash, callback, progressCallback, this);
+        _peerTransfers[messageID] = transfer;
+        transfer->start();
+
+        // it is over already if it couldn't reach the asset server
+        return _peerTransfers.count(messageID) ? messageID : INVALID_MESSAGE_ID;
+    }
+
+    return getAssetFromServer(hash, start, end, callback, progressCallback);
+}
+
+MessageID AssetClient::getAssetFromServer(const QString& hash, DataOffset start, DataOffset end,
+                                          ReceivedAssetCallback callback, ProgressCallback progressCallback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
     auto nodeList = DependencyManager::get<NodeList>();
     SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
 
@@ -448,6 +529,247 @@ void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, Message
     messageCallbackMap.erase(messageID);
 }
 
+MessageID AssetClient::getAssetPeers(const AssetHash& hash, GetPeersCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto messageID = ++_currentID;
+
+        auto payloadSize = sizeof(messageID) + SHA256_HASH_LENGTH;
+        auto packet = NLPacket::create(PacketType::AssetGetPeers, payloadSize, true);
+
+        packet->writePrimitive(messageID);
+        packet->write(QByteArray::fromHex(hash.toLatin1()));
+
+        if (nodeList->sendPacket(std::move(packet), *assetServer) != -1) {
+            _pendingPeersRequests[assetServer][messageID] = callback;
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetServerError::NoError, AssetPeersInfo());
+    return INVALID_MESSAGE_ID;
+}
+
+void AssetClient::handleAssetGetPeersReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    AssetServerError error;
+    message->readPrimitive(&error);
+
+    AssetPeersInfo info;
+    if (!error) {
+        QDataStream stream(message->readAll());
+
+        qint64 size;
+        qint64 chunkSize;
+        quint8 numPeers;
+        stream >> size >> chunkSize >> info.chunkHashes >> numPeers;
+        info.size = size;
+        info.chunkSize = chunkSize;
+
+        for (int i = 0; i < numPeers; ++i) {
+            AssetPeer peer;
+            stream >> peer.uuid >> peer.publicSocket >> peer.localSocket;
+            info.peers.push_back(peer);
+        }
+    }
+
+    // Check if we have any pending requests for this node
+    auto messageMapIt = _pendingPeersRequests.find(senderNode);
+    if (messageMapIt != _pendingPeersRequests.end()) {
+
+        // Found the node, get the MessageID -> Callback map
+        auto& messageCallbackMap = messageMapIt->second;
+
+        // Check if we have this pending request
+        auto requestIt = messageCallbackMap.find(messageID);
+        if (requestIt != messageCallbackMap.end()) {
+            auto callback = requestIt->second;
+            messageCallbackMap.erase(requestIt);
+            callback(true, error, info);
+        }
+    }
+}
+
+void AssetClient::handleAssetPeerExpect(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    // only the asset server gets to tell us who may fetch from us
+    if (!_isPeerAssistEnabled || senderNode->getType() != NodeType::AssetServer) {
+        return;
+    }
+
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+
+    QDataStream stream(message->readAll());
+    stream >> publicSocket >> localSocket;
+
+    if (!publicSocket.isNull()) {
+        allowPeer(publicSocket);
+    }
+    if (!localSocket.isNull()) {
+        allowPeer(localSocket);
+    }
+}
+
+MessageID AssetClient::getAssetFromPeer(const HifiSockAddr& peer, const AssetHash& hash, DataOffset start, DataOffset end,
+                                        ReceivedAssetCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    // the peer isn't a node, so the socket would refuse the connection to it
+    allowPeer(peer);
+
+    auto messageID = ++_currentID;
+
+    auto payloadSize = sizeof(messageID) + SHA256_HASH_LENGTH + sizeof(start) + sizeof(end);
+    auto packet = NLPacket::create(PacketType::AssetPeerGet, payloadSize, true);
+
+    packet->writePrimitive(messageID);
+    packet->write(QByteArray::fromHex(hash.toLatin1()));
+    packet->writePrimitive(start);
+    packet->writePrimitive(end);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (nodeList->sendPacket(std::move(packet), peer) != -1) {
+        _pendingPeerRequests[messageID] = { peer, callback };
+
+        return messageID;
+    }
+
+    callback(false, AssetServerError::NoError, QByteArray());
+    return INVALID_MESSAGE_ID;
+}
+
+void AssetClient::handleAssetPeerGet(QSharedPointer<ReceivedMessage> message) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto minSize = qint64(sizeof(MessageID) + SHA256_HASH_LENGTH + sizeof(DataOffset) + sizeof(DataOffset));
+
+    // only serve the peers the asset server told us to expect
+    const auto& senderSockAddr = message->getSenderSockAddr();
+    if (!_isPeerAssistEnabled || message->getSize() < minSize || _allowedPeers.count(senderSockAddr) == 0) {
+        return;
+    }
+
+    MessageID messageID;
+    ByteRange byteRange;
+
+    message->readPrimitive(&messageID);
+    auto hash = message->read(SHA256_HASH_LENGTH).toHex();
+    message->readPrimitive(&byteRange.fromInclusive);
+    message->readPrimitive(&byteRange.toExclusive);
+
+    auto replyPacketList = NLPacketList::create(PacketType::AssetPeerGetReply, QByteArray(), true, true);
+    replyPacketList->writePrimitive(messageID);
+
+    auto data = byteRange.isValid() ? _assetCache->read(hash, byteRange) : QByteArray();
+    if (data.isNull()) {
+        // we may have lost it from the cache since we told the asset server we hold it
+        replyPacketList->writePrimitive(AssetServerError::AssetNotFound);
+    } else {
+        DataOffset length = data.size();
+        replyPacketList->writePrimitive(AssetServerError::NoError);
+        replyPacketList->writePrimitive(length);
+        replyPacketList->write(data);
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->sendPacketList(std::move(replyPacketList), senderSockAddr);
+}
+
+void AssetClient::handleAssetPeerGetReply(QSharedPointer<ReceivedMessage> message) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    auto requestIt = _pendingPeerRequests.find(messageID);
+    if (requestIt == _pendingPeerRequests.end() || requestIt->second.peer != message->getSenderSockAddr()) {
+        return;
+    }
+
+    auto callback = requestIt->second.completeCallback;
+    _pendingPeerRequests.erase(requestIt);
+
+    AssetServerError error;
+    message->readPrimitive(&error);
+
+    if (error) {
+        callback(true, error, QByteArray());
+        return;
+    }
+
+    DataOffset length = 0;
+    message->readPrimitive(&length);
+
+    if (length != message->getBytesLeftToRead()) {
+        callback(false, AssetServerError::NoError, QByteArray());
+    } else {
+        callback(true, AssetServerError::NoError, message->readAll());
+    }
+}
+
+void AssetClient::allowPeer(const HifiSockAddr& sockAddr) {
+    _allowedPeers[sockAddr] = usecTimestampNow() + PEER_ALLOWED_USECS;
+    DependencyManager::get<NodeList>()->setPeerSockAddrAllowed(sockAddr, true);
+}
+
+void AssetClient::sendHolderUpdate(const std::vector<AssetHash>& hashes, bool isSharing) {
+    if (isSharing && hashes.empty()) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto packetList = NLPacketList::create(PacketType::AssetHolderUpdate, QByteArray(), true, true);
+
+        // when we stop sharing the asset server forgets everything we told it we hold
+        packetList->writePrimitive(isSharing);
+
+        uint32_t count = (uint32_t)hashes.size();
+        packetList->writePrimitive(count);
+        for (const auto& hash : hashes) {
+            packetList->write(QByteArray::fromHex(hash.toLatin1()));
+        }
+
+        nodeList->sendPacketList(std::move(packetList), *assetServer);
+    }
+}
+
+void AssetClient::updatePeers() {
+    std::vector<AssetHash> hashes;
+    {
+        std::lock_guard<std::mutex> lock(_heldHashesMutex);
+        hashes.swap(_newHeldHashes);
+    }
+
+    if (_isPeerAssistEnabled) {
+        sendHolderUpdate(hashes);
+    }
+
+    auto now = usecTimestampNow();
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    for (auto it = _allowedPeers.begin(); it != _allowedPeers.end();) {
+        if (it->second < now) {
+            nodeList->setPeerSockAddrAllowed(it->first, false);
+            it = _allowedPeers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
 MessageID AssetClient::getAssetMapping(const AssetPath& path, MappingOperationCallback callback) {
     Q_ASSERT(QThread::currentThread() == thread());
@@ -610,6 +932,17 @@ bool AssetClient::cancelGetAssetInfoRequest(MessageID id) {
 bool AssetClient::cancelGetAssetRequest(MessageID id) {
     Q_ASSERT(QThread::currentThread() == thread());
 
+    auto transferIt = _peerTransfers.find(id);
+    if (transferIt != _peerTransfers.end()) {
+        auto transfer = transferIt->second;
+        _peerTransfers.erase(transferIt);
+
+        transfer->cancel();
+        transfer->deleteLater();
+
+        return true;
+    }
+
     // Search through each pending mapping request for id `id`
     for (auto& kv : _pendingRequests) {
         auto& messageCallbackMap = kv.second;
@@ -630,6 +963,31 @@ bool AssetClient::cancelGetAssetRequest(MessageID id) {
     return false;
 }
 
+bool AssetClient::cancelGetAssetPeersRequest(MessageID id) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    for (auto& kv : _pendingPeersRequests) {
+        if (kv.second.erase(id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetClient::cancelGetAssetFromPeerRequest(MessageID id) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    return _pendingPeerRequests.erase(id) > 0;
+}
+
+void AssetClient::finishPeerTransfer(MessageID id) {
+    auto transferIt = _peerTransfers.find(id);
+    if (transferIt != _peerTransfers.end()) {
+        transferIt->second->deleteLater();
+        _peerTransfers.erase(transferIt);
+    }
+}
+
 bool AssetClient::cancelUploadAssetRequest(MessageID id) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -669,6 +1027,29 @@ MessageID AssetClient::uploadAsset(const QByteArray& data, UploadResultCallback
     return INVALID_MESSAGE_ID;
 }
 
+QByteArray AssetClient::loadFromCache(const AssetHash& hash, const ByteRange& byteRange) {
+    auto data = _assetCache->read(hash, byteRange);
+    if (!data.isNull()) {
+        qCDebug(asset_client) << hash << "loaded from asset cache.";
+    }
+    return data;
+}
+
+bool AssetClient::saveToCache(const AssetHash& hash, const QByteArray& data, const ByteRange& byteRange) {
+    if (_assetCache->write(hash, data, byteRange)) {
+        qCDebug(asset_client) << hash << "saved to asset cache.";
+
+        if (_isPeerAssistEnabled && !byteRange.isSet()) {
+            // we can share it now, the asset server hears about it with the next update
+            std::lock_guard<std::mutex> lock(_heldHashesMutex);
+            _newHeldHashes.push_back(hash.toLower());
+        }
+        return true;
+    }
+    qCWarning(asset_client) << "Could not save" << hash << "to asset cache.";
+    return false;
+}
+
 void AssetClient::handleAssetUploadReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -709,6 +1090,15 @@ void AssetClient::handleAssetUploadReply(QSharedPointer<ReceivedMessage> message
     }
 }
 
+void AssetClient::handleNodeActivated(SharedNodePointer node) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (node->getType() == NodeType::AssetServer && _isPeerAssistEnabled) {
+        // a new asset server knows nothing of what we hold
+        sendHolderUpdate(_assetCache->getAssetHashes());
+    }
+}
+
 void AssetClient::handleNodeKilled(SharedNodePointer node) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -780,4 +1170,17 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
             messageMapIt->second.clear();
         }
     }
+
+    {
+        auto messageMapIt = _pendingPeersRequests.find(node);
+        if (messageMapIt != _pendingPeersRequests.end()) {
+            // the callbacks may make new requests, so take these out of the map first
+            auto callbacks = std::move(messageMapIt->second);
+            messageMapIt->second.clear();
+
+            for (const auto& value : callbacks) {
+                value.second(false, AssetServerError::NoError, AssetPeersInfo());
+            }
+        }
+    }
 }
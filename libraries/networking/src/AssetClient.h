@@ -15,14 +15,20 @@
 #include <QStandardItemModel>
 #include <QtQml/QJSEngine>
 #include <QString>
+#include <QTimer>
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include <DependencyManager.h>
 
+#include "AssetCache.h"
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
+#include "HifiSockAddr.h"
 #include "LimitedNodeList.h"
 #include "Node.h"
 #include "ReceivedMessage.h"
@@ -34,17 +40,34 @@ class DeleteMappingsRequest;
 class RenameMappingRequest;
 class AssetRequest;
 class AssetUpload;
+class PeerAssetTransfer;
 
 struct AssetInfo {
     QString hash;
     int64_t size;
 };
 
+// an agent the asset server told us holds an asset, and the sockets it may be reached at
+struct AssetPeer {
+    QUuid uuid;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+};
+
+// what the asset server tells us to fetch an asset from its peers
+struct AssetPeersInfo {
+    DataOffset size { 0 };
+    DataOffset chunkSize { 0 };
+    QList<QByteArray> chunkHashes; // the SHA256 of each chunk of the asset
+    std::vector<AssetPeer> peers;
+};
+
 using MappingOperationCallback = std::function<void(bool responseReceived, AssetServerError serverError, QSharedPointer<ReceivedMessage> message)>;
 using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetServerError serverError, const QByteArray& data)>;
 using GetInfoCallback = std::function<void(bool responseReceived, AssetServerError serverError, AssetInfo info)>;
 using UploadResultCallback = std::function<void(bool responseReceived, AssetServerError serverError, const QString& hash)>;
 using ProgressCallback = std::function<void(qint64 totalReceived, qint64 total)>;
+using GetPeersCallback = std::function<void(bool responseReceived, AssetServerError serverError, const AssetPeersInfo& info)>;
 
 class AssetClient : public QObject, public Dependency {
     Q_OBJECT
@@ -60,21 +83,34 @@ public:
     Q_INVOKABLE AssetUpload* createUpload(const QString& filename);
     Q_INVOKABLE AssetUpload* createUpload(const QByteArray& data);
 
+    bool isPeerAssistEnabled() const { return _isPeerAssistEnabled; }
+
 public slots:
     void init();
 
     void cacheInfoRequest(QObject* reciever, QString slot);
     void clearCache();
 
+    // fetches whole assets from the agents that hold them, as the asset server tells us, and shares what we hold
+    void setPeerAssistEnabled(bool enabled);
+
 private slots:
     void handleAssetMappingOperationReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetGetReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetUploadReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetGetPeersReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetPeerExpect(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetPeerGet(QSharedPointer<ReceivedMessage> message);
+    void handleAssetPeerGetReply(QSharedPointer<ReceivedMessage> message);
 
+    void handleNodeActivated(SharedNodePointer node);
     void handleNodeKilled(SharedNodePointer node);
     void handleNodeClientConnectionReset(SharedNodePointer node);
 
+    // announces the assets we came to hold and forgets the peers that may no longer connect to us
+    void updatePeers();
+
 private:
     MessageID getAssetMapping(const AssetHash& hash, MappingOperationCallback callback);
     MessageID getAllAssetMappings(MappingOperationCallback callback);
@@ -85,12 +121,30 @@ private:
     MessageID getAssetInfo(const QString& hash, GetInfoCallback callback);
     MessageID getAsset(const QString& hash, DataOffset start, DataOffset end,
                   ReceivedAssetCallback callback, ProgressCallback progressCallback);
+    MessageID getAssetFromServer(const QString& hash, DataOffset start, DataOffset end,
+                                 ReceivedAssetCallback callback, ProgressCallback progressCallback);
     MessageID uploadAsset(const QByteArray& data, UploadResultCallback callback);
 
+    MessageID getAssetPeers(const AssetHash& hash, GetPeersCallback callback);
+    MessageID getAssetFromPeer(const HifiSockAddr& peer, const AssetHash& hash, DataOffset start, DataOffset end,
+                               ReceivedAssetCallback callback);
+
+    // lets the peer connect to us for a while, the asset server tells us to expect a peer before it may fetch from us
+    void allowPeer(const HifiSockAddr& sockAddr);
+    void sendHolderUpdate(const std::vector<AssetHash>& hashes, bool isSharing = true);
+
+    // the asset cache can be used from any thread
+    QByteArray loadFromCache(const AssetHash& hash, const ByteRange& byteRange = ByteRange());
+    bool saveToCache(const AssetHash& hash, const QByteArray& data, const ByteRange& byteRange = ByteRange());
+
     bool cancelMappingRequest(MessageID id);
     bool cancelGetAssetInfoRequest(MessageID id);
     bool cancelGetAssetRequest(MessageID id);
     bool cancelUploadAssetRequest(MessageID id);
+    bool cancelGetAssetPeersRequest(MessageID id);
+    bool cancelGetAssetFromPeerRequest(MessageID id);
+
+    void finishPeerTransfer(MessageID id);
 
     void handleProgressCallback(const QWeakPointer<Node>& node, MessageID messageID, qint64 size, DataOffset length);
     void handleCompleteCallback(const QWeakPointer<Node>& node, MessageID messageID, DataOffset length);
@@ -103,16 +157,34 @@ private:
         ProgressCallback progressCallback;
     };
 
+    struct GetAssetFromPeerRequestData {
+        HifiSockAddr peer;
+        ReceivedAssetCallback completeCallback;
+    };
+
     static MessageID _currentID;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, MappingOperationCallback>> _pendingMappingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetRequestData>> _pendingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetPeersCallback>> _pendingPeersRequests;
+    std::unordered_map<MessageID, GetAssetFromPeerRequestData> _pendingPeerRequests;
+    std::unordered_map<MessageID, PeerAssetTransfer*> _peerTransfers;
+
+    std::atomic<bool> _isPeerAssistEnabled { false };
+    std::unordered_map<HifiSockAddr, quint64> _allowedPeers; // to when each may connect to us, in usecs since the epoch
+    QTimer* _peerTimer { nullptr };
+
+    // the assets saved to the cache since we last told the asset server what we hold, saved from any thread
+    std::mutex _heldHashesMutex;
+    std::vector<AssetHash> _newHeldHashes;
 
     QString _cacheDir;
+    std::shared_ptr<AssetCache> _assetCache;
 
     friend class AssetRequest;
     friend class AssetUpload;
+    friend class PeerAssetTransfer;
     friend class MappingRequest;
     friend class GetMappingRequest;
     friend class GetAllMappingsRequest;
@@ -60,8 +60,10 @@ void AssetRequest::start() {
         return;
     }
     
-    // Try to load from cache
-    _data = loadFromCache(getUrl());
+    auto assetClient = DependencyManager::get<AssetClient>();
+
+    // Try to load from cache, straight from disk since assets never change
+    _data = assetClient->loadFromCache(_hash, _byteRange);
     if (!_data.isNull()) {
         _error = NoError;
 
@@ -75,7 +77,6 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
-    auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
 
@@ -114,9 +115,7 @@ void AssetRequest::start() {
                 _totalReceived += data.size();
                 emit progress(_totalReceived, data.size());
 
-                if (!_byteRange.isSet()) {
-                    saveToCache(getUrl(), data);
-                }
+                DependencyManager::get<AssetClient>()->saveToCache(_hash, data, _byteRange);
             }
         }
         
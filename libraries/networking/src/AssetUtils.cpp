@@ -11,13 +11,11 @@
 
 #include "AssetUtils.h"
 
-#include <memory>
+#include <algorithm>
 
 #include <QtCore/QCryptographicHash>
-#include <QtNetwork/QAbstractNetworkCache>
-
-#include "NetworkAccessManager.h"
-#include "NetworkLogging.h"
+#include <QtCore/QIODevice>
+#include <QtCore/QRegExp>
 
 #include "ResourceManager.h"
 
@@ -29,45 +27,39 @@ QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
 
-QByteArray loadFromCache(const QUrl& url) {
-    if (auto cache = NetworkAccessManager::getInstance().cache()) {
-
-        // caller is responsible for the deletion of the ioDevice, hence the unique_ptr
-        if (auto ioDevice = std::unique_ptr<QIODevice>(cache->data(url))) {
-            qCDebug(asset_client) << url.toDisplayString() << "loaded from disk cache.";
-            return ioDevice->readAll();
-        } else {
-            qCDebug(asset_client) << url.toDisplayString() << "not in disk cache";
-        }
-
-    } else {
-        qCWarning(asset_client) << "No disk cache to load assets from.";
+int getNumChunks(DataOffset size, DataOffset chunkSize) {
+    if (size <= 0 || chunkSize <= 0) {
+        return 0;
     }
-    return QByteArray();
+    return (int)((size + chunkSize - 1) / chunkSize);
 }
 
-bool saveToCache(const QUrl& url, const QByteArray& file) {
-    if (auto cache = NetworkAccessManager::getInstance().cache()) {
-        if (!cache->metaData(url).isValid()) {
-            QNetworkCacheMetaData metaData;
-            metaData.setUrl(url);
-            metaData.setSaveToDisk(true);
-            metaData.setLastModified(QDateTime::currentDateTime());
-            metaData.setExpirationDate(QDateTime()); // Never expires
+QList<QByteArray> hashChunks(QIODevice& device, DataOffset chunkSize) {
+    QList<QByteArray> hashes;
+    if (chunkSize <= 0) {
+        return hashes;
+    }
 
-            // ioDevice is managed by the cache and should either be passed back to insert or remove!
-            if (auto ioDevice = cache->prepare(metaData)) {
-                ioDevice->write(file);
-                cache->insert(ioDevice);
-                qCDebug(asset_client) << url.toDisplayString() << "saved to disk cache";
-                return true;
-            }
-            qCWarning(asset_client) << "Could not save" << url.toDisplayString() << "to disk cache.";
+    while (!device.atEnd()) {
+        auto chunk = device.read(chunkSize);
+        if (chunk.isEmpty()) {
+            // a read error, rather than a short last chunk
+            return QList<QByteArray>();
         }
-    } else {
-        qCWarning(asset_client) << "No disk cache to save assets to.";
+        hashes << hashData(chunk);
     }
-    return false;
+    return hashes;
+}
+
+bool isValidChunk(const QByteArray& data, int index, DataOffset size, DataOffset chunkSize,
+                  const QList<QByteArray>& chunkHashes) {
+    if (index < 0 || index >= getNumChunks(size, chunkSize) || index >= chunkHashes.size()) {
+        return false;
+    }
+
+    DataOffset start = index * chunkSize;
+    DataOffset expectedSize = std::min(chunkSize, size - start);
+    return data.size() == expectedSize && hashData(data) == chunkHashes[index];
 }
 
 bool isValidFilePath(const AssetPath& filePath) {
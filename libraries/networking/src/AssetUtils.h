@@ -17,8 +17,11 @@
 #include <map>
 
 #include <QtCore/QByteArray>
+#include <QtCore/QList>
 #include <QtCore/QUrl>
 
+class QIODevice;
+
 using DataOffset = int64_t;
 
 using AssetPath = QString;
@@ -29,6 +32,7 @@ using AssetPathList = QStringList;
 const size_t SHA256_HASH_LENGTH = 32;
 const size_t SHA256_HASH_HEX_LENGTH = 64;
 const uint64_t MAX_UPLOAD_SIZE = 1000 * 1000 * 1000; // 1GB
+const DataOffset ASSET_PEER_CHUNK_SIZE = 1024 * 1024; // peers share assets in chunks of 1MB, each with its own hash
 
 const QString ASSET_FILE_PATH_REGEX_STRING = "^(\\/[^\\/\\0]+)+$";
 const QString ASSET_PATH_REGEX_STRING = "^\\/([^\\/\\0]+(\\/)?)+$";
@@ -56,8 +60,13 @@ QUrl getATPUrl(const QString& hash);
 
 QByteArray hashData(const QByteArray& data);
 
-QByteArray loadFromCache(const QUrl& url);
-bool saveToCache(const QUrl& url, const QByteArray& file);
+// assets are shared between peers in chunks, the last of which can be short
+int getNumChunks(DataOffset size, DataOffset chunkSize = ASSET_PEER_CHUNK_SIZE);
+// the hash of each chunk of the rest of device, or an empty list if it can't be read
+QList<QByteArray> hashChunks(QIODevice& device, DataOffset chunkSize = ASSET_PEER_CHUNK_SIZE);
+// whether data is the chunk at index of an asset of size with the chunk hashes from hashChunks()
+bool isValidChunk(const QByteArray& data, int index, DataOffset size, DataOffset chunkSize,
+                  const QList<QByteArray>& chunkHashes);
 
 bool isValidFilePath(const AssetPath& path);
 bool isValidPath(const AssetPath& path);
@@ -484,6 +484,24 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
     }
 }
 
+void LimitedNodeList::setPeerSockAddrAllowed(const HifiSockAddr& sockAddr, bool isAllowed) {
+    QWriteLocker writeLock(&_allowedPeerSockAddrsLock);
+    if (isAllowed) {
+        _allowedPeerSockAddrs.insert(sockAddr);
+    } else {
+        _allowedPeerSockAddrs.erase(sockAddr);
+    }
+}
+
+bool LimitedNodeList::sockAddrBelongsToNode(const HifiSockAddr& sockAddr) {
+    if (findNodeWithAddr(sockAddr)) {
+        return true;
+    }
+
+    QReadLocker readLock(&_allowedPeerSockAddrsLock);
+    return _allowedPeerSockAddrs.find(sockAddr) != _allowedPeerSockAddrs.end();
+}
+
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode,
                                    const HifiSockAddr& overridenSockAddr) {
     if (overridenSockAddr.isNull() && !destinationNode.getActiveSocket()) {
@@ -18,6 +18,7 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -137,6 +138,9 @@ public:
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
+    // lets a socket that isn't a node's have reliable connections with us, like an agent we share assets with
+    void setPeerSockAddrAllowed(const HifiSockAddr& sockAddr, bool isAllowed);
+
     std::function<void(Node*)> linkedDataCreateCallback;
 
     size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
@@ -360,11 +364,13 @@ protected:
     void sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr, const QUuid& clientID,
                                const QUuid& peerRequestID = QUuid());
 
-    bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
+    bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr);
 
     QUuid _sessionUUID;
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex;
+    std::unordered_set<HifiSockAddr> _allowedPeerSockAddrs;
+    mutable QReadWriteLock _allowedPeerSockAddrsLock;
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -241,6 +241,10 @@ void NodeList::reset() {
 
     _numNoReplyDomainCheckIns = 0;
 
+    // the next domain-server we hear from will need to send us a full list
+    _lastDomainListRevision = 0;
+    _numDomainListRequests = 0;
+
     // lock and clear our set of ignored IDs
     _ignoredSetLock.lockForWrite();
     _ignoredNodeIDs.clear();
@@ -395,6 +399,14 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
+        if (domainPacketType == PacketType::DomainListRequest) {
+            // let the domain-server know which revision of the list we have so it only sends us what changed,
+            // every so often ask for the full list in case we missed some of the unreliable list packets
+            const int FULL_DOMAIN_LIST_REQUEST_INTERVAL = 10;
+            bool requestFullList = (_numDomainListRequests++ % FULL_DOMAIN_LIST_REQUEST_INTERVAL) == 0;
+            packetStream << (requestFullList ? quint32(0) : _lastDomainListRevision);
+        }
+
         if (!_domainHandler.isConnected()) {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
@@ -624,6 +636,31 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newPermissions;
     setPermissions(newPermissions);
 
+    // pull the revision of this list, and whether it only has the changes since the revision we told the domain-server about
+    quint32 revision;
+    bool isDelta;
+    QList<QUuid> removedNodes;
+    packetStream >> revision >> isDelta >> removedNodes;
+
+    if (isDelta) {
+        _lastDomainListRevision = std::max(_lastDomainListRevision, revision);
+
+        for (auto& nodeUUID : removedNodes) {
+            killNodeWithUUID(nodeUUID);
+        }
+
+        // nodes we aren't told about in a delta are still there, keep our upstream and downstream nodes alive
+        // the same way a full list would
+        eachMatchingNode([&](const SharedNodePointer& node) {
+            return node->getType() == NodeType::downstreamType(_ownerType)
+                || node->getType() == NodeType::upstreamType(_ownerType);
+        }, [&](const SharedNodePointer& node) {
+            node->setLastHeardMicrostamp(usecTimestampNow());
+        });
+    } else {
+        _lastDomainListRevision = revision;
+    }
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
@@ -0,0 +1,321 @@
+//
+//  PeerAssetTransfer.cpp
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PeerAssetTransfer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QPointer>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "NetworkLogging.h"
+#include "NodeList.h"
+
+static const int MAX_CHUNKS_PER_PEER = 2;
+static const int MAX_CHUNKS_FROM_SERVER = 4;
+static const quint64 CHUNK_TIMEOUT_USECS = 10 * USECS_PER_SECOND;
+static const quint64 PEERS_REPLY_TIMEOUT_USECS = 5 * USECS_PER_SECOND;
+static const int TIMEOUT_CHECK_INTERVAL_MS = 500;
+
+PeerAssetTransfer::PeerAssetTransfer(MessageID id, const AssetHash& hash, ReceivedAssetCallback callback,
+                                     ProgressCallback progressCallback, AssetClient* client) :
+    QObject(client),
+    _id(id),
+    _hash(hash.toLower()),
+    _callback(callback),
+    _progressCallback(progressCallback),
+    _client(client)
+{
+    connect(&_timeoutTimer, &QTimer::timeout, this, &PeerAssetTransfer::checkTimeouts);
+}
+
+void PeerAssetTransfer::start() {
+    _timeoutTimer.start(TIMEOUT_CHECK_INTERVAL_MS);
+
+    auto that = QPointer<PeerAssetTransfer>(this);
+    _peersDeadline = usecTimestampNow() + PEERS_REPLY_TIMEOUT_USECS;
+    _peersRequestID = _client->getAssetPeers(_hash,
+        [this, that](bool responseReceived, AssetServerError serverError, const AssetPeersInfo& info) {
+        if (!that) {
+            return;
+        }
+        _peersRequestID = INVALID_MESSAGE_ID;
+        handlePeers(responseReceived, serverError, info);
+    });
+}
+
+void PeerAssetTransfer::cancel() {
+    _isFinished = true;
+    _timeoutTimer.stop();
+
+    if (_peersRequestID != INVALID_MESSAGE_ID) {
+        _client->cancelGetAssetPeersRequest(_peersRequestID);
+        _peersRequestID = INVALID_MESSAGE_ID;
+    }
+    if (_serverRequestID != INVALID_MESSAGE_ID) {
+        _client->cancelGetAssetRequest(_serverRequestID);
+        _serverRequestID = INVALID_MESSAGE_ID;
+    }
+    cancelChunks();
+}
+
+void PeerAssetTransfer::handlePeers(bool responseReceived, AssetServerError serverError, const AssetPeersInfo& info) {
+    if (!responseReceived || serverError != AssetServerError::NoError) {
+        // the asset server would fail the same way for the asset itself
+        finish(responseReceived, serverError, QByteArray());
+        return;
+    }
+
+    int numChunks = getNumChunks(info.size, info.chunkSize);
+
+    if (info.peers.empty() || numChunks == 0 || numChunks != info.chunkHashes.size()) {
+        fetchFromServer();
+        return;
+    }
+
+    _size = info.size;
+    _chunkSize = info.chunkSize;
+    _chunkHashes = info.chunkHashes;
+    _chunks.resize(numChunks);
+    _data = QByteArray((int)_size, Qt::Uninitialized);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto publicAddress = nodeList->getPublicSockAddr().getAddress();
+
+    for (const auto& assetPeer : info.peers) {
+        Peer peer;
+
+        // a peer behind the same NAT as us is reached on the network we share
+        if (assetPeer.publicSocket.getAddress() == publicAddress && !assetPeer.localSocket.isNull()) {
+            peer.sockAddr = assetPeer.localSocket;
+        } else {
+            peer.sockAddr = assetPeer.publicSocket;
+        }
+        _peers.push_back(peer);
+    }
+
+    qCDebug(asset_client) << "Fetching" << numChunks << "chunks of" << _hash << "from" << _peers.size() << "peers.";
+
+    requestChunks();
+}
+
+void PeerAssetTransfer::requestChunks() {
+    bool hasPeers = std::any_of(_peers.begin(), _peers.end(), [](const Peer& peer) {
+        return !peer.isDropped;
+    });
+
+    for (int i = 0; i < (int)_chunks.size() && !_isFinished; ++i) {
+        if (_chunks[i].state != Chunk::Queued) {
+            continue;
+        }
+
+        if (hasPeers) {
+            // the least busy peer that can take another chunk
+            int source = SERVER;
+            for (int peer = 0; peer < (int)_peers.size(); ++peer) {
+                if (!_peers[peer].isDropped && _peers[peer].numRequested < MAX_CHUNKS_PER_PEER &&
+                    (source == SERVER || _peers[peer].numRequested < _peers[source].numRequested)) {
+                    source = peer;
+                }
+            }
+
+            if (source == SERVER) {
+                return;
+            }
+            requestChunk(i, source);
+        } else {
+            if (_numServerRequested >= MAX_CHUNKS_FROM_SERVER) {
+                return;
+            }
+            requestChunk(i, SERVER);
+        }
+    }
+}
+
+void PeerAssetTransfer::requestChunk(int index, int source) {
+    auto& chunk = _chunks[index];
+    chunk.state = Chunk::Requested;
+    chunk.source = source;
+    chunk.deadline = usecTimestampNow() + CHUNK_TIMEOUT_USECS;
+    int attempt = ++chunk.attempt;
+
+    DataOffset start = index * _chunkSize;
+    DataOffset end = std::min(start + _chunkSize, _size);
+
+    auto that = QPointer<PeerAssetTransfer>(this);
+    auto callback = [this, that, index, attempt](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+        if (!that) {
+            return;
+        }
+        handleChunk(index, attempt, responseReceived, serverError, data);
+    };
+
+    MessageID requestID;
+    if (source == SERVER) {
+        ++_numServerRequested;
+        requestID = _client->getAssetFromServer(_hash, start, end, callback, [](qint64, qint64) {});
+    } else {
+        ++_peers[source].numRequested;
+        requestID = _client->getAssetFromPeer(_peers[source].sockAddr, _hash, start, end, callback);
+    }
+
+    // unless it was answered already
+    if (chunk.attempt == attempt && chunk.state == Chunk::Requested) {
+        chunk.requestID = requestID;
+    }
+}
+
+void PeerAssetTransfer::handleChunk(int index, int attempt, bool responseReceived, AssetServerError serverError,
+                                    const QByteArray& data) {
+    if (_isFinished || index >= (int)_chunks.size()) {
+        return;
+    }
+
+    auto& chunk = _chunks[index];
+    if (chunk.attempt != attempt || chunk.state != Chunk::Requested) {
+        return;
+    }
+
+    chunk.requestID = INVALID_MESSAGE_ID;
+    int source = chunk.source;
+    if (source == SERVER) {
+        --_numServerRequested;
+    } else {
+        --_peers[source].numRequested;
+    }
+
+    if (!responseReceived || serverError != AssetServerError::NoError ||
+        !isValidChunk(data, index, _size, _chunkSize, _chunkHashes)) {
+        if (source == SERVER) {
+            finish(responseReceived, serverError, QByteArray());
+            return;
+        }
+
+        qCDebug(asset_client) << "Peer" << _peers[source].sockAddr << "failed to send chunk" << index << "of" << _hash
+            << "- error code" << serverError;
+
+        chunk.state = Chunk::Queued;
+        dropPeer(source);
+        requestChunks();
+        return;
+    }
+
+    memcpy(_data.data() + index * _chunkSize, data.constData(), data.size());
+    chunk.state = Chunk::Received;
+    ++_numReceived;
+    _totalReceived += data.size();
+    _progressCallback(_totalReceived, _size);
+
+    if (_numReceived < (int)_chunks.size()) {
+        requestChunks();
+        return;
+    }
+
+    if (hashData(_data).toHex() != _hash) {
+        // every chunk matched, so the asset server gave us hashes of something else
+        qCWarning(asset_client) << "Chunks of" << _hash << "from peers don't make up the asset, fetching it from the asset server.";
+        fetchFromServer();
+        return;
+    }
+
+    finish(true, AssetServerError::NoError, _data);
+}
+
+void PeerAssetTransfer::dropPeer(int peer) {
+    _peers[peer].isDropped = true;
+
+    // what else it was asked for goes to someone else
+    for (auto& chunk : _chunks) {
+        if (chunk.state == Chunk::Requested && chunk.source == peer) {
+            _client->cancelGetAssetFromPeerRequest(chunk.requestID);
+            chunk.state = Chunk::Queued;
+            chunk.requestID = INVALID_MESSAGE_ID;
+            --_peers[peer].numRequested;
+        }
+    }
+}
+
+void PeerAssetTransfer::cancelChunks() {
+    for (auto& chunk : _chunks) {
+        if (chunk.state == Chunk::Requested) {
+            if (chunk.source == SERVER) {
+                _client->cancelGetAssetRequest(chunk.requestID);
+            } else {
+                _client->cancelGetAssetFromPeerRequest(chunk.requestID);
+            }
+            chunk.state = Chunk::Queued;
+            chunk.requestID = INVALID_MESSAGE_ID;
+        }
+    }
+}
+
+void PeerAssetTransfer::checkTimeouts() {
+    auto now = usecTimestampNow();
+
+    if (_peersRequestID != INVALID_MESSAGE_ID) {
+        if (now > _peersDeadline) {
+            // an asset server that doesn't coordinate peers won't answer
+            _client->cancelGetAssetPeersRequest(_peersRequestID);
+            _peersRequestID = INVALID_MESSAGE_ID;
+            fetchFromServer();
+        }
+        return;
+    }
+
+    bool hasDroppedPeer = false;
+    for (auto& chunk : _chunks) {
+        if (chunk.state == Chunk::Requested && chunk.source != SERVER && now > chunk.deadline) {
+            qCDebug(asset_client) << "Peer" << _peers[chunk.source].sockAddr << "timed out sending a chunk of" << _hash;
+            dropPeer(chunk.source);
+            hasDroppedPeer = true;
+        }
+    }
+
+    if (hasDroppedPeer) {
+        requestChunks();
+    }
+}
+
+void PeerAssetTransfer::fetchFromServer() {
+    cancelChunks();
+    _chunks.clear();
+    _peers.clear();
+
+    auto that = QPointer<PeerAssetTransfer>(this);
+    _serverRequestID = _client->getAssetFromServer(_hash, 0, 0,
+        [this, that](bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+        if (!that) {
+            return;
+        }
+        _serverRequestID = INVALID_MESSAGE_ID;
+        finish(responseReceived, serverError, data);
+    }, [this, that](qint64 totalReceived, qint64 total) {
+        if (!that) {
+            return;
+        }
+        _progressCallback(totalReceived, total);
+    });
+}
+
+void PeerAssetTransfer::finish(bool responseReceived, AssetServerError serverError, const QByteArray& data) {
+    if (_isFinished) {
+        return;
+    }
+    _isFinished = true;
+    _timeoutTimer.stop();
+
+    auto callback = _callback;
+    _client->finishPeerTransfer(_id);
+
+    callback(responseReceived, serverError, data);
+}
@@ -0,0 +1,100 @@
+//
+//  PeerAssetTransfer.h
+//  libraries/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PeerAssetTransfer_h
+#define hifi_PeerAssetTransfer_h
+
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include "AssetClient.h"
+#include "AssetUtils.h"
+#include "HifiSockAddr.h"
+
+// Fetches a whole asset from the agents that hold it, for the AssetClient and on its thread.
+//
+// The asset server tells us the hash of each chunk of the asset and which of its holders to ask.  Each peer is asked for a
+// couple of chunks at a time.  A chunk that doesn't match its hash or doesn't come in time is asked of another peer, and
+// the peer that sent it isn't asked again.  Once no peer is left the rest comes from the asset server by byte range, and
+// the whole asset comes from it when nobody else holds it or it doesn't know about peers.
+class PeerAssetTransfer : public QObject {
+    Q_OBJECT
+public:
+    PeerAssetTransfer(MessageID id, const AssetHash& hash, ReceivedAssetCallback callback,
+                      ProgressCallback progressCallback, AssetClient* client);
+
+    void start();
+
+    // stops the transfer without calling back
+    void cancel();
+
+private slots:
+    void checkTimeouts();
+
+private:
+    static const int SERVER = -1; // the source of a chunk that comes from the asset server
+
+    struct Chunk {
+        enum State {
+            Queued,
+            Requested,
+            Received
+        };
+
+        State state { Queued };
+        int source { SERVER }; // the index of the peer it was asked of
+        int attempt { 0 }; // so that the answer to an abandoned request is ignored
+        MessageID requestID { INVALID_MESSAGE_ID };
+        quint64 deadline { 0 };
+    };
+
+    struct Peer {
+        HifiSockAddr sockAddr;
+        int numRequested { 0 };
+        bool isDropped { false };
+    };
+
+    void handlePeers(bool responseReceived, AssetServerError serverError, const AssetPeersInfo& info);
+    void requestChunks();
+    void requestChunk(int index, int source);
+    void handleChunk(int index, int attempt, bool responseReceived, AssetServerError serverError, const QByteArray& data);
+    void dropPeer(int peer);
+    void cancelChunks();
+    void fetchFromServer();
+    void finish(bool responseReceived, AssetServerError serverError, const QByteArray& data);
+
+    const MessageID _id;
+    const AssetHash _hash;
+    ReceivedAssetCallback _callback;
+    ProgressCallback _progressCallback;
+    AssetClient* _client;
+
+    MessageID _peersRequestID { INVALID_MESSAGE_ID };
+    quint64 _peersDeadline { 0 };
+    MessageID _serverRequestID { INVALID_MESSAGE_ID };
+
+    DataOffset _size { 0 };
+    DataOffset _chunkSize { 0 };
+    QList<QByteArray> _chunkHashes;
+    std::vector<Peer> _peers;
+    std::vector<Chunk> _chunks;
+    int _numServerRequested { 0 };
+    int _numReceived { 0 };
+    qint64 _totalReceived { 0 };
+    QByteArray _data;
+
+    QTimer _timeoutTimer;
+    bool _isFinished { false };
+};
+
+#endif // hifi_PeerAssetTransfer_h
@@ -0,0 +1,264 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2 / ln(2), the smallest gain that doubles the sending rate every round trip
+static const double HIGH_GAIN = 2.885;
+static const double PROBE_BANDWIDTH_WINDOW_GAIN = 2.0;
+static const double PACING_GAIN_CYCLE[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+
+// startup is over once the bandwidth hasn't grown by a quarter in three rounds
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const auto MIN_RTT_WINDOW = seconds(10);
+static const auto PROBE_RTT_DURATION = milliseconds(200);
+
+static const int MIN_CONGESTION_WINDOW_PACKETS = 4;
+static const int INITIAL_CONGESTION_WINDOW_PACKETS = 16;
+
+// room in the window for the receiver's ACKs to be delayed or aggregated
+static const int ACK_AGGREGATION_ALLOWANCE_PACKETS = 3;
+
+static const int MAX_RTT_SAMPLE_MICROSECONDS = 10000000;
+
+BBRCC::BBRCC() :
+    _pacingGain(HIGH_GAIN),
+    _congestionWindowGain(HIGH_GAIN)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    _congestionWindowSize = INITIAL_CONGESTION_WINDOW_PACKETS;
+
+    // the RTT the connection starts out with, until it gives us its own
+    _rtt = DEFAULT_SYN_INTERVAL * 10;
+
+    // ACK every packet, each ACK is a delivery rate and RTT sample
+    setAckInterval(1);
+
+    _roundBandwidths.fill(0.0);
+
+    // we can't do this as a member initializer until our VS has support for constexpr
+    _minRTT = std::numeric_limits<int>::max();
+
+    // until there is a bandwidth sample, pace the initial window over the initial RTT
+    updateControlParameters();
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    int numNewlyDelivered = seqoff(_lastACK, ack);
+    if (numNewlyDelivered <= 0) {
+        // this ACK doesn't tell us about anything we didn't know
+        return false;
+    }
+    _lastACK = ack;
+
+    _delivered += numNewlyDelivered;
+    _deliveredTime = receiveTime;
+
+    // the ACK is cumulative, drop every packet it covers and keep the one it was sent for
+    bool hasSample = false;
+    SentPacket ackedPacket;
+    while (!_sentPackets.empty() && seqoff(_sentPackets.front().sequenceNumber, ack) >= 0) {
+        if (_sentPackets.front().sequenceNumber == ack) {
+            ackedPacket = _sentPackets.front();
+            hasSample = true;
+        }
+        _sentPackets.pop_front();
+    }
+
+    _isRoundStart = false;
+
+    if (hasSample) {
+        updateRound(ackedPacket);
+
+        if (!ackedPacket.wasRetransmitted) {
+            // we can't tell which send of a retransmitted packet was ACKed, so it is not an RTT sample
+            int rtt = (int)duration_cast<microseconds>(receiveTime - ackedPacket.sendTime).count();
+            updateMinRTT(std::max(1, std::min(rtt, MAX_RTT_SAMPLE_MICROSECONDS)), receiveTime);
+        }
+
+        // the delivery rate is what was delivered between the delivery before this packet was sent and this one
+        auto interval = duration_cast<microseconds>(receiveTime - ackedPacket.deliveredTime).count();
+        if (interval > 0) {
+            updateBandwidth((_delivered - ackedPacket.delivered) * USECS_PER_SECOND / interval);
+        }
+    }
+
+    checkFullPipe();
+    updateMode(receiveTime);
+    updateControlParameters();
+
+    // loss is repaired from the NAKs, no fast re-transmit required
+    return false;
+}
+
+void BBRCC::onTimeout() {
+    // nothing came back for a whole timeout, only send what the min window allows until something does
+    _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (_sentPackets.empty()) {
+        // nothing is in flight, the delivery rate of this packet is measured from when it is sent
+        _deliveredTime = timePoint;
+    }
+
+    if (_sentPackets.empty() || seqoff(_sentPackets.back().sequenceNumber, seqNum) > 0) {
+        _sentPackets.push_back({ seqNum, timePoint, _delivered, _deliveredTime, false });
+    } else {
+        // this is a re-transmission of a packet we're still waiting on
+        int index = seqoff(_sentPackets.front().sequenceNumber, seqNum);
+        if (index >= 0 && index < (int)_sentPackets.size()) {
+            _sentPackets[index].wasRetransmitted = true;
+        }
+    }
+}
+
+void BBRCC::updateRound(const SentPacket& packet) {
+    if (packet.delivered >= _nextRoundDelivered) {
+        // everything in flight when the round started has been delivered
+        _nextRoundDelivered = _delivered;
+        ++_roundCount;
+        _isRoundStart = true;
+
+        // the oldest round leaves the bandwidth window
+        _roundBandwidths[_roundCount % BANDWIDTH_WINDOW_ROUNDS] = 0.0;
+    }
+}
+
+void BBRCC::updateBandwidth(double sample) {
+    auto& roundBandwidth = _roundBandwidths[_roundCount % BANDWIDTH_WINDOW_ROUNDS];
+    roundBandwidth = std::max(roundBandwidth, sample);
+
+    _bottleneckBandwidth = *std::max_element(_roundBandwidths.begin(), _roundBandwidths.end());
+}
+
+void BBRCC::updateMinRTT(int rtt, TimePoint now) {
+    _isMinRTTExpired = _minRTT != std::numeric_limits<int>::max() && now - _minRTTTimestamp > MIN_RTT_WINDOW;
+
+    if (rtt <= _minRTT || _isMinRTTExpired) {
+        _minRTT = rtt;
+        _minRTTTimestamp = now;
+    }
+}
+
+void BBRCC::checkFullPipe() {
+    if (_isPipeFilled || !_isRoundStart) {
+        return;
+    }
+
+    if (_bottleneckBandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+        // the bandwidth is still growing, keep going
+        _fullBandwidth = _bottleneckBandwidth;
+        _fullBandwidthRounds = 0;
+    } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+        _isPipeFilled = true;
+    }
+}
+
+void BBRCC::updateMode(TimePoint now) {
+    if (_mode == Mode::Startup && _isPipeFilled) {
+        _mode = Mode::Drain;
+        _pacingGain = 1.0 / HIGH_GAIN;
+        _congestionWindowGain = HIGH_GAIN;
+    }
+
+    if (_mode == Mode::Drain && getPacketsInFlight() <= getBandwidthDelayProduct()) {
+        enterProbeBandwidth(now);
+    }
+
+    if (_mode == Mode::ProbeBandwidth && now - _cycleTimestamp > microseconds(_minRTT)) {
+        // each phase of the cycle lasts a min RTT
+        _cycleIndex = (_cycleIndex + 1) % NUM_PACING_GAIN_CYCLE_PHASES;
+        _cycleTimestamp = now;
+        _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+    }
+
+    if (_mode != Mode::ProbeRTT && _isMinRTTExpired) {
+        _modeBeforeProbeRTT = _mode;
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _isProbeRTTTimed = false;
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (!_isProbeRTTTimed && getPacketsInFlight() <= MIN_CONGESTION_WINDOW_PACKETS) {
+            // the queue is drained, the RTT samples from now on are the propagation delay
+            _probeRTTDoneTimestamp = now + PROBE_RTT_DURATION;
+            _isProbeRTTTimed = true;
+        } else if (_isProbeRTTTimed && now >= _probeRTTDoneTimestamp) {
+            _minRTTTimestamp = now;
+            _isMinRTTExpired = false;
+
+            if (_isPipeFilled) {
+                enterProbeBandwidth(now);
+            } else {
+                _mode = _modeBeforeProbeRTT;
+                _pacingGain = HIGH_GAIN;
+                _congestionWindowGain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::enterProbeBandwidth(TimePoint now) {
+    _mode = Mode::ProbeBandwidth;
+    _congestionWindowGain = PROBE_BANDWIDTH_WINDOW_GAIN;
+
+    // start anywhere in the cycle but on the phase that drains, so connections sharing a link don't probe together
+    _cycleIndex = rand() % (NUM_PACING_GAIN_CYCLE_PHASES - 1);
+    if (_cycleIndex >= 1) {
+        ++_cycleIndex;
+    }
+    _cycleTimestamp = now;
+    _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+}
+
+void BBRCC::updateControlParameters() {
+    double packetsPerSecond;
+    if (_bottleneckBandwidth > 0.0) {
+        packetsPerSecond = _pacingGain * _bottleneckBandwidth;
+    } else {
+        // no bandwidth sample yet
+        packetsPerSecond = _pacingGain * _congestionWindowSize * USECS_PER_SECOND / std::max(_rtt, 1);
+    }
+    setPacketSendPeriod(USECS_PER_SECOND / packetsPerSecond);
+
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+    } else if (_bottleneckBandwidth > 0.0 && _minRTT != std::numeric_limits<int>::max()) {
+        _congestionWindowSize = (int)(_congestionWindowGain * getBandwidthDelayProduct())
+            + ACK_AGGREGATION_ALLOWANCE_PACKETS;
+    }
+
+    _congestionWindowSize = std::max(MIN_CONGESTION_WINDOW_PACKETS,
+                                     std::min(_congestionWindowSize, udt::MAX_PACKETS_IN_FLIGHT));
+}
+
+int BBRCC::getBandwidthDelayProduct() const {
+    if (_minRTT == std::numeric_limits<int>::max()) {
+        return INITIAL_CONGESTION_WINDOW_PACKETS;
+    }
+    return (int)(_bottleneckBandwidth * _minRTT / USECS_PER_SECOND);
+}
+
+int BBRCC::getPacketsInFlight() const {
+    return std::max(0, seqoff(_lastACK, _sendCurrSeqNum));
+}
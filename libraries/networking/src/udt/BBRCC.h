@@ -0,0 +1,116 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <array>
+#include <deque>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Congestion control modeled on BBR (https://queue.acm.org/detail.cfm?id=3022184).
+//
+// Rather than backing off on loss or on growing delay, it models the path from the ACK stream: the bottleneck bandwidth
+// is the max delivery rate over the last few round trips, and the propagation delay is the min RTT over the last ten
+// seconds.  The packets are paced at the bottleneck bandwidth, and the congestion window is kept at a couple of
+// bandwidth-delay products.  The pacing is cycled slightly above and below that to probe for more bandwidth and to
+// drain the queue the probing built, and the window is dropped for a moment every ten seconds to measure the min RTT
+// again.  Loss is repaired from the NAKs but doesn't slow the sending down, so jitter and random loss on long links
+// don't cost throughput.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override {}
+    virtual void onTimeout() override;
+
+    virtual bool shouldProbe() override { return false; }
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    enum class Mode {
+        Startup, // doubles the sending rate every round trip until the bandwidth stops growing
+        Drain, // drains the queue built during startup
+        ProbeBandwidth, // cycles the pacing around the bottleneck bandwidth
+        ProbeRTT // drops the window to measure the min RTT
+    };
+
+    static const int BANDWIDTH_WINDOW_ROUNDS = 10;
+    static const int NUM_PACING_GAIN_CYCLE_PHASES = 8;
+
+    struct SentPacket {
+        SequenceNumber sequenceNumber;
+        TimePoint sendTime;
+        int64_t delivered; // packets delivered when it was sent
+        TimePoint deliveredTime; // time of the last delivery when it was sent
+        bool wasRetransmitted;
+    };
+
+    void updateRound(const SentPacket& packet);
+    void updateBandwidth(double sample);
+    void updateMinRTT(int rtt, TimePoint now);
+    void checkFullPipe();
+    void updateMode(TimePoint now);
+    void enterProbeBandwidth(TimePoint now);
+    void updateControlParameters();
+
+    int getBandwidthDelayProduct() const; // in packets
+    int getPacketsInFlight() const;
+
+    std::deque<SentPacket> _sentPackets; // packets waiting for an ACK, in sequence order
+
+    SequenceNumber _lastACK; // Sequence number of last packet that was ACKed
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    int64_t _delivered { 0 }; // packets delivered since the start of the connection
+    TimePoint _deliveredTime; // time of the last delivery
+
+    int64_t _nextRoundDelivered { 0 }; // delivered count that ends the current round trip
+    int _roundCount { 0 };
+    bool _isRoundStart { false };
+
+    std::array<double, BANDWIDTH_WINDOW_ROUNDS> _roundBandwidths; // max delivery rate of the last rounds, packets per second
+    double _bottleneckBandwidth { 0.0 }; // packets per second
+
+    int _minRTT; // propagation delay estimate, in microseconds
+    TimePoint _minRTTTimestamp;
+    bool _isMinRTTExpired { false };
+
+    double _fullBandwidth { 0.0 }; // bandwidth startup last saw grow by enough, packets per second
+    int _fullBandwidthRounds { 0 }; // rounds it hasn't since
+    bool _isPipeFilled { false };
+
+    int _cycleIndex { 0 };
+    TimePoint _cycleTimestamp;
+
+    TimePoint _probeRTTDoneTimestamp;
+    bool _isProbeRTTTimed { false }; // the window is down, and the probe is done at _probeRTTDoneTimestamp
+    Mode _modeBeforeProbeRTT { Mode::Startup };
+};
+
+}
+
+#endif // hifi_BBRCC_h
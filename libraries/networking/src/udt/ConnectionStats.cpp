@@ -112,3 +112,13 @@ void ConnectionStats::recordPacketSendPeriod(int sample) {
     _currentSample.packetSendPeriod = sample;
     _total.packetSendPeriod = (int)((_total.packetSendPeriod * EWMA_PREVIOUS_SAMPLES_WEIGHT) + (sample * EWMA_CURRENT_SAMPLE_WEIGHT));
 }
+
+void ConnectionStats::recordSchedulingLatency(int sample) {
+    _currentSample.schedulingLatency = sample;
+    _total.schedulingLatency = (int)((_total.schedulingLatency * EWMA_PREVIOUS_SAMPLES_WEIGHT) + (sample * EWMA_CURRENT_SAMPLE_WEIGHT));
+}
+
+void ConnectionStats::recordPacingThreads(int numThreads) {
+    _currentSample.pacingThreads = numThreads;
+    _total.pacingThreads = numThreads;
+}
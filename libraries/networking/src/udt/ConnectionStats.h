@@ -69,6 +69,9 @@ public:
         int rtt { 0 };
         int congestionWindowSize { 0 };
         int packetSendPeriod { 0 };
+        int schedulingLatency { 0 }; // how late the send queue was serviced after its pacing deadline, in microseconds
+
+        int pacingThreads { 0 }; // threads servicing the send queues of every connection
         
         // TODO: Remove once Win build supports brace initialization: `Events events {{ 0 }};`
         Stats() { events.fill(0); }
@@ -93,6 +96,8 @@ public:
     void recordRTT(int sample);
     void recordCongestionWindowSize(int sample);
     void recordPacketSendPeriod(int sample);
+    void recordSchedulingLatency(int sample);
+    void recordPacingThreads(int numThreads);
     
 private:
     Stats _currentSample;
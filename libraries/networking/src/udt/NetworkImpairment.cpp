@@ -0,0 +1,242 @@
+//
+//  NetworkImpairment.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkImpairment.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QStringList>
+
+#include <NumericalConstants.h>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double BITS_PER_BYTE = 8.0;
+
+// the shape of the pareto jitter, the smaller it is the longer its tail
+static const float PARETO_SHAPE = 3.0f;
+
+// so that a pareto outlier doesn't hold a datagram for ever
+static const int MAX_JITTER_SCALES = 20;
+
+static std::mutex defaultSettingsMutex;
+static NetworkImpairment::Settings defaultSettings;
+
+bool NetworkImpairment::Settings::isEnabled() const {
+    return loss > 0.0f || burstLoss > 0.0f || delay > 0 || jitter > 0 || reorder > 0.0f || bandwidth > 0;
+}
+
+bool NetworkImpairment::parseSettings(const QString& string, Settings& settings) {
+    Settings parsed;
+
+    for (const auto& pair : string.split(',', QString::SkipEmptyParts)) {
+        auto keyAndValue = pair.split('=');
+        if (keyAndValue.size() != 2) {
+            return false;
+        }
+
+        auto key = keyAndValue[0].trimmed().toLower();
+        auto value = keyAndValue[1].trimmed();
+
+        bool ok = true;
+        if (key == "seed") {
+            parsed.seed = value.toUInt(&ok);
+        } else if (key == "loss") {
+            parsed.loss = value.toFloat(&ok) / 100.0f;
+        } else if (key == "burst") {
+            parsed.burstLoss = value.toFloat(&ok) / 100.0f;
+        } else if (key == "burst-length") {
+            parsed.burstLength = value.toInt(&ok);
+            ok = ok && parsed.burstLength >= 1;
+        } else if (key == "delay") {
+            parsed.delay = value.toInt(&ok);
+        } else if (key == "jitter") {
+            parsed.jitter = value.toInt(&ok);
+        } else if (key == "jitter-distribution") {
+            auto distribution = value.toLower();
+            if (distribution == "uniform") {
+                parsed.jitterDistribution = Uniform;
+            } else if (distribution == "normal") {
+                parsed.jitterDistribution = Normal;
+            } else if (distribution == "pareto") {
+                parsed.jitterDistribution = Pareto;
+            } else {
+                ok = false;
+            }
+        } else if (key == "reorder") {
+            parsed.reorder = value.toFloat(&ok) / 100.0f;
+        } else if (key == "reorder-delay") {
+            parsed.reorderDelay = value.toInt(&ok);
+        } else if (key == "bandwidth") {
+            parsed.bandwidth = value.toInt(&ok);
+        } else if (key == "buffer") {
+            parsed.bufferSize = value.toInt(&ok);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+
+    auto isChance = [](float chance) { return chance >= 0.0f && chance <= 1.0f; };
+    if (!isChance(parsed.loss) || !isChance(parsed.burstLoss) || !isChance(parsed.reorder)
+        || parsed.delay < 0 || parsed.jitter < 0 || parsed.reorderDelay < 0 || parsed.bandwidth < 0
+        || parsed.bufferSize < 0) {
+        return false;
+    }
+
+    settings = parsed;
+    return true;
+}
+
+void NetworkImpairment::setDefaultSettings(const Settings& settings) {
+    std::lock_guard<std::mutex> lock(defaultSettingsMutex);
+    defaultSettings = settings;
+}
+
+NetworkImpairment::Settings NetworkImpairment::getDefaultSettings() {
+    std::lock_guard<std::mutex> lock(defaultSettingsMutex);
+    return defaultSettings;
+}
+
+NetworkImpairment::Link::Link(uint32_t seed, Direction direction, const HifiSockAddr& sockAddr) {
+    std::vector<uint32_t> seedData { seed, (uint32_t)direction, sockAddr.getPort() };
+
+    const auto& address = sockAddr.getAddress();
+    if (address.protocol() == QAbstractSocket::IPv4Protocol) {
+        seedData.push_back(address.toIPv4Address());
+    } else {
+        auto ipv6Address = address.toIPv6Address();
+        for (int i = 0; i < 16; i += 4) {
+            seedData.push_back((uint32_t)ipv6Address[i] << 24 | (uint32_t)ipv6Address[i + 1] << 16
+                               | (uint32_t)ipv6Address[i + 2] << 8 | (uint32_t)ipv6Address[i + 3]);
+        }
+    }
+
+    std::seed_seq seedSequence(seedData.begin(), seedData.end());
+    generator.seed(seedSequence);
+}
+
+NetworkImpairment::NetworkImpairment(const Settings& settings) :
+    _settings(settings)
+{
+}
+
+NetworkImpairment::Link& NetworkImpairment::getLink(Direction direction, const HifiSockAddr& sockAddr) {
+    auto& links = _links[direction];
+    auto it = links.find(sockAddr);
+    if (it == links.end()) {
+        it = links.emplace(sockAddr, Link(_settings.seed, direction, sockAddr)).first;
+    }
+    return it->second;
+}
+
+bool NetworkImpairment::queueDatagram(Direction direction, const QByteArray& data,
+                                      const HifiSockAddr& sockAddr, TimePoint now) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto& link = getLink(direction, sockAddr);
+
+    if (isLost(link)) {
+        ++_numLost;
+        return false;
+    }
+
+    auto deliveryTime = now;
+
+    if (_settings.bandwidth > 0) {
+        auto queueStart = std::max(now, link.bottleneckFreeTime);
+        if (queueStart - now > milliseconds(_settings.bufferSize)) {
+            // the bottleneck's buffer is full
+            ++_numLost;
+            return false;
+        }
+
+        // at a kilobit per second, a bit takes a millisecond
+        auto transmitTime = microseconds((int64_t)(data.size() * BITS_PER_BYTE * USECS_PER_MSEC / _settings.bandwidth));
+        link.bottleneckFreeTime = queueStart + transmitTime;
+        deliveryTime = link.bottleneckFreeTime;
+    }
+
+    deliveryTime += milliseconds(_settings.delay) + getJitter(link);
+
+    if (_settings.reorder > 0.0f && link.uniform(link.generator) < _settings.reorder) {
+        // hold this one back and let the ones after it pass
+        deliveryTime += milliseconds(_settings.reorderDelay);
+    } else {
+        // jitter alone doesn't re-order, the datagrams on a link arrive in the order they were sent
+        deliveryTime = std::max(deliveryTime, link.lastDeliveryTime);
+        link.lastDeliveryTime = deliveryTime;
+    }
+
+    // the data can be a raw view of a packet that is gone by the time this is delivered, hold a copy
+    _datagrams[direction].push({ QByteArray(data.constData(), data.size()), sockAddr, deliveryTime });
+
+    return true;
+}
+
+std::vector<NetworkImpairment::Datagram> NetworkImpairment::takeDueDatagrams(Direction direction, TimePoint now) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<Datagram> dueDatagrams;
+    auto& datagrams = _datagrams[direction];
+    while (!datagrams.empty() && datagrams.top().deliveryTime <= now) {
+        dueDatagrams.push_back(datagrams.top());
+        datagrams.pop();
+    }
+    return dueDatagrams;
+}
+
+bool NetworkImpairment::isLost(Link& link) {
+    if (link.burstRemaining > 0) {
+        --link.burstRemaining;
+        return true;
+    }
+
+    if (_settings.burstLoss > 0.0f && link.uniform(link.generator) < _settings.burstLoss) {
+        // this one and a geometric number after it, burstLength of them on average
+        std::geometric_distribution<int> burstDistribution(1.0 / _settings.burstLength);
+        link.burstRemaining = burstDistribution(link.generator);
+        return true;
+    }
+
+    return _settings.loss > 0.0f && link.uniform(link.generator) < _settings.loss;
+}
+
+microseconds NetworkImpairment::getJitter(Link& link) {
+    if (_settings.jitter <= 0) {
+        return microseconds(0);
+    }
+
+    float scale = (float)(_settings.jitter * USECS_PER_MSEC);
+    float jitter = 0.0f;
+
+    switch (_settings.jitterDistribution) {
+        case Uniform:
+            jitter = link.uniform(link.generator) * scale;
+            break;
+        case Normal:
+            // around the delay, a datagram can't arrive before it is sent
+            jitter = link.normal(link.generator) * scale;
+            break;
+        case Pareto:
+            // mostly small, with a long tail of late datagrams
+            jitter = (std::pow(1.0f - link.uniform(link.generator), -1.0f / PARETO_SHAPE) - 1.0f) * scale;
+            break;
+    }
+
+    jitter = std::min(jitter, scale * MAX_JITTER_SCALES);
+    int64_t earliest = -(int64_t)(_settings.delay * USECS_PER_MSEC);
+    return microseconds(std::max((int64_t)jitter, earliest));
+}
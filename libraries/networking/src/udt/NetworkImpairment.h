@@ -0,0 +1,135 @@
+//
+//  NetworkImpairment.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NetworkImpairment_h
+#define hifi_NetworkImpairment_h
+
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <PortableHighResolutionClock.h>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+// the command line option the servers and clients take the impairment settings from
+const QString NETWORK_IMPAIRMENT_OPTION = "network-impairment";
+const QString NETWORK_IMPAIRMENT_OPTION_DESCRIPTION =
+    "impair the network as a comma separated list of: seed=N, loss=%, burst=% (chance a burst of loss starts), "
+    "burst-length=N (datagrams), delay=ms, jitter=ms, jitter-distribution=uniform|normal|pareto, reorder=%, "
+    "reorder-delay=ms, bandwidth=kb/s (to and from each address), buffer=ms";
+
+// Makes a Socket behave as if it were on a worse network, for testing on one machine.
+//
+// Each datagram that goes through it is either lost or held until its delivery time, in each direction and separately
+// for each address: it can be lost at random or in bursts, it is delayed with jitter from one of a few distributions,
+// some are held back so that the ones after them are delivered first, and the bandwidth is capped with a buffer that
+// drops what doesn't fit.  The impairment of each address and direction is drawn from a generator of its own, seeded
+// from the seed and the address, so a run with the same traffic to an address impairs it the same way whatever else is
+// sent at the same time.
+class NetworkImpairment {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    enum Direction {
+        Outbound,
+        Inbound,
+        NumDirections
+    };
+
+    enum JitterDistribution {
+        Uniform,
+        Normal,
+        Pareto
+    };
+
+    struct Settings {
+        uint32_t seed { 0 };
+        float loss { 0.0f }; // chance of losing each datagram, out of 1
+        float burstLoss { 0.0f }; // chance of a burst of loss starting at each datagram, out of 1
+        int burstLength { 3 }; // mean number of datagrams lost in a burst
+        int delay { 0 }; // in milliseconds
+        int jitter { 0 }; // in milliseconds, the max for uniform jitter and the standard deviation or scale otherwise
+        JitterDistribution jitterDistribution { Uniform };
+        float reorder { 0.0f }; // chance of holding back each datagram behind the ones after it, out of 1
+        int reorderDelay { 10 }; // how long it is held back, in milliseconds
+        int bandwidth { 0 }; // to and from each address, in kilobits per second, 0 for no cap
+        int bufferSize { 100 }; // of the bandwidth cap, in milliseconds of datagrams
+
+        bool isEnabled() const;
+    };
+
+    struct Datagram {
+        QByteArray data;
+        HifiSockAddr sockAddr; // the destination or the sender
+        TimePoint deliveryTime;
+
+        bool operator>(const Datagram& other) const { return deliveryTime > other.deliveryTime; }
+    };
+
+    // parses settings from the NETWORK_IMPAIRMENT_OPTION format, returns false for a malformed one
+    static bool parseSettings(const QString& string, Settings& settings);
+
+    // what the sockets created from now on are impaired with
+    static void setDefaultSettings(const Settings& settings);
+    static Settings getDefaultSettings();
+
+    explicit NetworkImpairment(const Settings& settings);
+
+    const Settings& getSettings() const { return _settings; }
+
+    // holds the datagram until its delivery time, returns false if it was lost instead
+    bool queueDatagram(Direction direction, const QByteArray& data, const HifiSockAddr& sockAddr, TimePoint now);
+
+    // the datagrams that are due, in the order of their delivery
+    std::vector<Datagram> takeDueDatagrams(Direction direction, TimePoint now);
+
+    int getNumLost() const { return _numLost; }
+
+private:
+    struct Link {
+        Link(uint32_t seed, Direction direction, const HifiSockAddr& sockAddr);
+
+        std::mt19937 generator;
+        std::uniform_real_distribution<float> uniform { 0.0f, 1.0f };
+        std::normal_distribution<float> normal { 0.0f, 1.0f };
+
+        TimePoint bottleneckFreeTime; // when the bandwidth cap is done with what it holds
+        TimePoint lastDeliveryTime; // of the last datagram that wasn't held back, which the next can't pass
+        int burstRemaining { 0 }; // datagrams left to lose in the current burst
+    };
+
+    Link& getLink(Direction direction, const HifiSockAddr& sockAddr);
+    bool isLost(Link& link);
+    std::chrono::microseconds getJitter(Link& link);
+
+    Settings _settings;
+
+    std::mutex _mutex;
+
+    std::unordered_map<HifiSockAddr, Link> _links[NumDirections];
+    std::priority_queue<Datagram, std::vector<Datagram>, std::greater<Datagram>> _datagrams[NumDirections];
+
+    std::atomic<int> _numLost { 0 };
+};
+
+}
+
+#endif // hifi_NetworkImpairment_h
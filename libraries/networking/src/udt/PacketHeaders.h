@@ -121,6 +121,12 @@ public:
         ReplicatedAvatarIdentity,
         ReplicatedKillAvatar,
         ReplicatedBulkAvatarData,
+        AssetHolderUpdate,
+        AssetGetPeers,
+        AssetGetPeersReply,
+        AssetPeerExpect,
+        AssetPeerGet,
+        AssetPeerGetReply,
         NUM_PACKET_TYPE
     };
 };
@@ -218,6 +224,7 @@ const PacketVersion VERSION_ENTITIES_PHYSICS_PACKET = 67;
 const PacketVersion VERSION_ENTITIES_ZONE_FILTERS = 68;
 const PacketVersion VERSION_ENTITIES_HINGE_CONSTRAINT = 69;
 const PacketVersion VERSION_ENTITIES_BULLET_DYNAMICS = 70;
+const PacketVersion VERSION_ENTITIES_POLYVOX_BRICKS = 71;
 
 enum class EntityQueryPacketVersion: PacketVersion {
     JSONFilter = 18,
@@ -273,7 +280,13 @@ enum class DomainListVersion : PacketVersion {
     PrePermissionsGrid = 18,
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
-    GetMachineFingerprintFromUUIDSupport
+    GetMachineFingerprintFromUUIDSupport,
+    IncrementalUpdates
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreIncrementalUpdates = 17,
+    IncrementalUpdates
 };
 
 enum class AudioVersion : PacketVersion {
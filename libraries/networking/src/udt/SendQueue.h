@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -29,6 +28,7 @@
 
 #include "Constants.h"
 #include "PacketQueue.h"
+#include "SendQueueScheduler.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
 
@@ -40,7 +40,9 @@ class Packet;
 class PacketList;
 class Socket;
     
-class SendQueue : public QObject {
+// Sends the packets of one reliable connection, paced by its congestion control.  The queues don't have threads of
+// their own, they are serviced by the SendQueueScheduler shared by every connection.
+class SendQueue : public QObject, public SendQueueScheduler::Client {
     Q_OBJECT
     
 public:
@@ -68,6 +70,11 @@ public:
     void setSyncInterval(int syncInterval) { _syncInterval = syncInterval; }
 
     void setProbePacketEnabled(bool enabled);
+
+    const SendQueueScheduler& getScheduler() const { return *_scheduler; }
+    
+    // sends what the pacing allows and returns when to be serviced next, called by the scheduler
+    Schedule service(SendQueueScheduler::TimePoint now) override;
     
 public slots:
     void stop();
@@ -87,15 +94,21 @@ signals:
     void shortCircuitLoss(quint32 sequenceNumber);
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    // what the queue is waiting for when it has nothing it can send
+    enum class Wait {
+        None,
+        Handshake, // a handshake ACK, or the time to re-send the handshake
+        Empty, // something to send, or the time to consider the queue inactive
+        Response // an ACK or NAK for the packets on the wire, or the time to consider them lost
+    };
+    
     SendQueue(Socket* socket, HifiSockAddr dest);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
     void sendHandshake();
+    void wake() { _scheduler->wake(this); }
     
     int sendPacket(const Packet& packet);
     bool sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber);
@@ -103,7 +116,9 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    bool hasTimedOut() const;
+    Schedule wait(Wait wait, SendQueueScheduler::TimePoint deadline);
+    bool handleWaitTimeout(); // returns false if the queue became inactive
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -139,14 +154,16 @@ private:
     using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
     std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
-
 
     std::atomic<bool> _shouldSendProbes { true };
+
+    // only touched by the scheduler's threads, one at a time
+    Wait _wait { Wait::None };
+    SendQueueScheduler::TimePoint _waitDeadline;
+    SendQueueScheduler::TimePoint _nextPacketTimestamp; // when the next packet should have been sent
+
+    std::shared_ptr<SendQueueScheduler> _scheduler;
 };
     
 }
@@ -0,0 +1,182 @@
+//
+//  SendQueueScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueScheduler.h"
+
+#include <algorithm>
+
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QThread>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const QString PACING_THREADS_FLAG = "HIFI_UDT_PACING_THREADS";
+static const int MAX_DEFAULT_PACING_THREADS = 4;
+
+class SendQueueScheduler::PacingThread : public QThread {
+public:
+    PacingThread(SendQueueScheduler& scheduler) : _scheduler(scheduler) {}
+
+protected:
+    void run() override { _scheduler.run(); }
+
+private:
+    SendQueueScheduler& _scheduler;
+};
+
+std::shared_ptr<SendQueueScheduler> SendQueueScheduler::getInstance() {
+    static std::mutex instanceMutex;
+    static std::weak_ptr<SendQueueScheduler> instance;
+
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    auto scheduler = instance.lock();
+    if (!scheduler) {
+        scheduler = std::make_shared<SendQueueScheduler>();
+        instance = scheduler;
+    }
+    return scheduler;
+}
+
+int SendQueueScheduler::getDefaultNumThreads() {
+    bool ok = false;
+    int numThreads = QProcessEnvironment::systemEnvironment().value(PACING_THREADS_FLAG).toInt(&ok);
+    if (ok && numThreads > 0) {
+        return numThreads;
+    }
+    // sending is mostly waiting on deadlines and on the socket, so a few threads go a long way
+    return std::max(1, std::min(MAX_DEFAULT_PACING_THREADS, QThread::idealThreadCount() / 2));
+}
+
+SendQueueScheduler::SendQueueScheduler(int numThreads) {
+    for (int i = 0; i < std::max(1, numThreads); i++) {
+        auto thread = new PacingThread(*this);
+        thread->setObjectName("Networking: SendQueue pacing " + QString::number(i));
+        thread->start();
+        _threads.push_back(thread);
+    }
+}
+
+SendQueueScheduler::~SendQueueScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto thread : _threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void SendQueueScheduler::add(Client* client) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    schedule(client, _clients[client], p_high_resolution_clock::now(), false);
+}
+
+void SendQueueScheduler::wake(Client* client) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _clients.find(client);
+    if (it == _clients.end()) {
+        return;
+    }
+    auto& state = it->second;
+    if (state.isServicing) {
+        // it may have just decided to wait for what woke it, so it is rescheduled right away once it's done
+        state.wasWoken = true;
+    } else if (state.isScheduled && state.isWakeable) {
+        schedule(client, state, p_high_resolution_clock::now(), false);
+    }
+}
+
+void SendQueueScheduler::remove(Client* client) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _clients.find(client);
+    if (it == _clients.end()) {
+        return;
+    }
+    // the states aren't moved by other clients being added or removed
+    auto& state = it->second;
+    _servicedCondition.wait(lock, [&] { return !state.isServicing; });
+    _clients.erase(client);
+}
+
+void SendQueueScheduler::schedule(Client* client, ClientState& state, TimePoint deadline, bool isWakeable) {
+    // the generation is unique across clients, so an entry left in the heap for a removed client is never mistaken for
+    // one of a new client at the same address
+    state.generation = ++_lastGeneration;
+    state.deadline = deadline;
+    state.isScheduled = true;
+    state.isWakeable = isWakeable;
+
+    bool isEarliest = _deadlines.empty() || deadline < _deadlines.top().deadline;
+    _deadlines.push({ deadline, client, state.generation });
+    if (isEarliest) {
+        _condition.notify_one();
+    }
+}
+
+void SendQueueScheduler::recordLatency(TimePoint deadline, TimePoint now) {
+    static const float EWMA_CURRENT_SAMPLE_WEIGHT = 0.125f;
+    int sample = (int)duration_cast<microseconds>(now - deadline).count();
+    _schedulingLatency = (int)(_schedulingLatency * (1.0f - EWMA_CURRENT_SAMPLE_WEIGHT) +
+                               sample * EWMA_CURRENT_SAMPLE_WEIGHT);
+}
+
+void SendQueueScheduler::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_isStopping) {
+        if (_deadlines.empty()) {
+            _condition.wait(lock);
+            continue;
+        }
+
+        Entry entry = _deadlines.top();
+        auto it = _clients.find(entry.client);
+        if (it == _clients.end() || !it->second.isScheduled || it->second.generation != entry.generation) {
+            // the client was rescheduled or removed since
+            _deadlines.pop();
+            continue;
+        }
+
+        auto now = p_high_resolution_clock::now();
+        if (entry.deadline > now) {
+            _condition.wait_until(lock, entry.deadline);
+            continue;
+        }
+
+        _deadlines.pop();
+        if (!_deadlines.empty()) {
+            // let another thread look at what's next while this one is busy
+            _condition.notify_one();
+        }
+
+        auto& state = it->second;
+        state.isScheduled = false;
+        state.isServicing = true;
+        state.wasWoken = false;
+        recordLatency(entry.deadline, now);
+
+        lock.unlock();
+        auto next = entry.client->service(now);
+        lock.lock();
+
+        state.isServicing = false;
+        if (!next.isFinished) {
+            if (next.isWakeable && state.wasWoken) {
+                schedule(entry.client, state, p_high_resolution_clock::now(), false);
+            } else {
+                schedule(entry.client, state, next.deadline, next.isWakeable);
+            }
+        }
+        _servicedCondition.notify_all();
+    }
+}
@@ -0,0 +1,117 @@
+//
+//  SendQueueScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueScheduler_h
+#define hifi_SendQueueScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+class QThread;
+
+namespace udt {
+
+// Paces the send queues of every connection on a small fixed pool of threads.
+//
+// Each queue is serviced when its deadline comes up, sends what its pacing allows, and hands back the time at which it
+// wants to be serviced next.  The deadlines are kept in a heap, the threads take the earliest one that is due and
+// sleep until the next one otherwise, so a thousand idle connections cost nothing and a busy one is serviced as often
+// as its packet send period asks for.  A queue is only ever serviced by one thread at a time.
+class SendQueueScheduler {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    class Client {
+    public:
+        // When a client wants to be serviced next.  A wakeable client is waiting for something to send or for a
+        // response, and is serviced as soon as it is woken rather than at its deadline.
+        struct Schedule {
+            Schedule(TimePoint deadline, bool isWakeable = false, bool isFinished = false) :
+                deadline(deadline), isWakeable(isWakeable), isFinished(isFinished) {}
+
+            TimePoint deadline;
+            bool isWakeable;
+            bool isFinished; // the client is never serviced again
+        };
+
+        virtual ~Client() {}
+
+        virtual Schedule service(TimePoint now) = 0;
+    };
+
+    // the scheduler shared by every send queue of the process, which lasts for as long as something holds it
+    static std::shared_ptr<SendQueueScheduler> getInstance();
+
+    static int getDefaultNumThreads();
+
+    explicit SendQueueScheduler(int numThreads = getDefaultNumThreads());
+    ~SendQueueScheduler();
+
+    int getNumThreads() const { return (int)_threads.size(); }
+
+    // trailing average of how late the clients were serviced after their deadlines, in microseconds
+    int getSchedulingLatency() const { return _schedulingLatency; }
+
+    // services the client as soon as a thread is free
+    void add(Client* client);
+
+    // services a client that is waiting now rather than at its deadline
+    void wake(Client* client);
+
+    // waits for the client to finish being serviced if it is, after which it is never serviced again
+    void remove(Client* client);
+
+private:
+    class PacingThread;
+    friend class PacingThread;
+
+    struct ClientState {
+        uint64_t generation { 0 }; // of the client's entry in the heap, any other entry for the client is stale
+        TimePoint deadline;
+        bool isScheduled { false };
+        bool isServicing { false };
+        bool isWakeable { false };
+        bool wasWoken { false }; // woken while it was being serviced
+    };
+
+    struct Entry {
+        TimePoint deadline;
+        Client* client;
+        uint64_t generation;
+
+        bool operator>(const Entry& other) const { return deadline > other.deadline; }
+    };
+
+    void run();
+    void schedule(Client* client, ClientState& state, TimePoint deadline, bool isWakeable);
+    void recordLatency(TimePoint deadline, TimePoint now);
+
+    std::mutex _mutex;
+    std::condition_variable _condition; // wakes the threads for a new earliest deadline
+    std::condition_variable _servicedCondition; // wakes remove() when a client is done being serviced
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> _deadlines;
+    std::unordered_map<Client*, ClientState> _clients;
+    uint64_t _lastGeneration { 0 };
+    bool _isStopping { false };
+
+    std::vector<QThread*> _threads;
+    std::atomic<int> _schedulingLatency { 0 };
+};
+
+}
+
+#endif // hifi_SendQueueScheduler_h
@@ -54,6 +54,11 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     const int READY_READ_BACKUP_CHECK_MSECS = 2 * 1000;
     connect(_readyReadBackupTimer, &QTimer::timeout, this, &Socket::checkForReadyReadBackup);
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
+
+    auto impairmentSettings = NetworkImpairment::getDefaultSettings();
+    if (impairmentSettings.isEnabled()) {
+        setNetworkImpairment(impairmentSettings);
+    }
 }
 
 void Socket::bind(const QHostAddress& address, quint16 port) {
@@ -224,6 +229,11 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    if (_impairment) {
+        // as far as the sender can tell, an impaired datagram was written
+        _impairment->queueDatagram(NetworkImpairment::Outbound, datagram, sockAddr, p_high_resolution_clock::now());
+        return datagram.size();
+    }
 
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
 
@@ -359,70 +369,129 @@ void Socket::readPendingDatagrams() {
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        if (_impairment) {
+            // hold it until the impaired network would have delivered it
+            _impairment->queueDatagram(NetworkImpairment::Inbound, QByteArray::fromRawData(buffer.get(), sizeRead),
+                                       senderSockAddr, receiveTime);
+            continue;
+        }
+
+        processDatagram(std::move(buffer), sizeRead, senderSockAddr, receiveTime);
+    }
+}
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
-            }
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
 
-            continue;
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        return;
+    }
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
-            }
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-                        continue;
-                    }
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
+                    return;
                 }
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
 }
 
+void Socket::setNetworkImpairment(const NetworkImpairment::Settings& settings) {
+    if (!settings.isEnabled()) {
+        _impairment.reset();
+        if (_impairmentTimer) {
+            _impairmentTimer->stop();
+        }
+        return;
+    }
+
+    // this is usually set from the constructor, before the socket is bound, so there is no port to log yet
+    qCDebug(networking) << "Impairing the network of the socket - loss"
+        << settings.loss << "burst" << settings.burstLoss << "delay" << settings.delay << "ms jitter" << settings.jitter
+        << "ms reorder" << settings.reorder << "bandwidth" << settings.bandwidth << "kbps, seed" << settings.seed;
+
+    _impairment.reset(new NetworkImpairment(settings));
+
+    if (!_impairmentTimer) {
+        _impairmentTimer = new QTimer(this);
+        _impairmentTimer->setTimerType(Qt::PreciseTimer);
+        connect(_impairmentTimer, &QTimer::timeout, this, &Socket::releaseImpairedDatagrams);
+    }
+
+    // the granularity of the impaired delays
+    const int IMPAIRMENT_RELEASE_INTERVAL_MSECS = 1;
+    _impairmentTimer->start(IMPAIRMENT_RELEASE_INTERVAL_MSECS);
+}
+
+void Socket::releaseImpairedDatagrams() {
+    if (!_impairment) {
+        return;
+    }
+
+    auto now = p_high_resolution_clock::now();
+
+    for (const auto& datagram : _impairment->takeDueDatagrams(NetworkImpairment::Outbound, now)) {
+        _udpSocket.writeDatagram(datagram.data, datagram.sockAddr.getAddress(), datagram.sockAddr.getPort());
+    }
+
+    for (const auto& datagram : _impairment->takeDueDatagrams(NetworkImpairment::Inbound, now)) {
+        auto buffer = std::unique_ptr<char[]>(new char[datagram.data.size()]);
+        memcpy(buffer.get(), datagram.data.constData(), datagram.data.size());
+
+        // it is received when the impaired network delivers it
+        processDatagram(std::move(buffer), datagram.data.size(), datagram.sockAddr, datagram.deliveryTime);
+    }
+}
+
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
     auto it = _connectionsHash.find(destinationAddr);
     if (it != _connectionsHash.end()) {
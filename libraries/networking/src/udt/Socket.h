@@ -25,6 +25,7 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "NetworkImpairment.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -83,6 +84,10 @@ public:
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
+    // impairs what is written to and read from this socket, for testing on one machine - disabled settings turn it off
+    // set it before the socket is in use, it is not synchronized with the threads writing to it
+    void setNetworkImpairment(const NetworkImpairment::Settings& settings);
+
     void messageReceived(std::unique_ptr<Packet> packet);
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
     
@@ -103,6 +108,7 @@ private slots:
     void readPendingDatagrams();
     void checkForReadyReadBackup();
     void rateControlSync();
+    void releaseImpairedDatagrams();
 
     void handleSocketError(QAbstractSocket::SocketError socketError);
     void handleStateChanged(QAbstractSocket::SocketState socketState);
@@ -111,6 +117,8 @@ private:
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
+    void processDatagram(std::unique_ptr<char[]> buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -145,6 +153,9 @@ private:
 
     bool _shouldChangeSocketOptions { true };
 
+    std::unique_ptr<NetworkImpairment> _impairment;
+    QTimer* _impairmentTimer { nullptr };
+
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
@@ -0,0 +1,203 @@
+//
+//  CookedShapeCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CookedShapeCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+
+#include <SettingHandle.h>
+#include <shared/Storage.h>
+
+#include "PhysicsLogging.h"
+
+using File = cache::File;
+
+const int CookedShapeCache::CURRENT_VERSION = 0x01;
+const int CookedShapeCache::INVALID_VERSION = 0x00;
+const char* CookedShapeCache::SETTING_VERSION_NAME = "hifi.shapes.cache_version";
+
+const std::string CookedShapeCache::DIRNAME { "shape_cache" };
+const std::string CookedShapeCache::EXT { "hfs" };
+
+static bool isHullShape(ShapeType type) {
+    return type == SHAPE_TYPE_COMPOUND || type == SHAPE_TYPE_SIMPLE_HULL || type == SHAPE_TYPE_SIMPLE_COMPOUND;
+}
+
+CookedShapeCache::CookedShapeCache(const std::string& dir, const std::string& ext) :
+    FileCache(dir, ext) { }
+
+void CookedShapeCache::initialize() {
+    FileCache::initialize();
+    Setting::Handle<int> cacheVersionHandle(SETTING_VERSION_NAME, INVALID_VERSION);
+    auto cacheVersion = cacheVersionHandle.get();
+    if (cacheVersion != CURRENT_VERSION) {
+        wipe();
+        cacheVersionHandle.set(CURRENT_VERSION);
+    }
+}
+
+std::unique_ptr<File> CookedShapeCache::createFile(Metadata&& metadata, const std::string& filepath) {
+    qCDebug(physics) << "Wrote cooked shape" << metadata.key.c_str();
+    return FileCache::createFile(std::move(metadata), filepath);
+}
+
+std::string CookedShapeCache::getKey(const ShapeInfo& info) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    const DoubleHashKey& shapeKey = info.getHash();
+    uint32_t header[] = { (uint32_t)info.getType(), shapeKey.getHash(), shapeKey.getHash2() };
+    hash.addData(reinterpret_cast<const char*>(header), sizeof(header));
+
+    for (const ShapeInfo::PointList& points : info.getPointCollection()) {
+        hash.addData(reinterpret_cast<const char*>(points.constData()), points.size() * sizeof(glm::vec3));
+    }
+    const ShapeInfo::TriangleIndices& indices = info.getTriangleIndices();
+    hash.addData(reinterpret_cast<const char*>(indices.constData()), indices.size() * sizeof(int32_t));
+
+    return hash.result().toHex().toStdString();
+}
+
+const btCollisionShape* CookedShapeCache::readShape(const ShapeInfo& info) {
+    if (!isHullShape(info.getType())) {
+        return nullptr;
+    }
+
+    auto file = getFile(getKey(info));
+    if (!file) {
+        return nullptr;
+    }
+
+    storage::FileStorage storage(QString::fromStdString(file->getFilepath()));
+    if (!storage) {
+        return nullptr;
+    }
+
+    QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(storage.data()), (int)storage.size());
+    btCollisionShape* shape = readCookedShape(data);
+    if (!shape) {
+        qCWarning(physics) << "Ignoring unreadable cooked shape" << file->getKey().c_str();
+    }
+    return shape;
+}
+
+void CookedShapeCache::writeShape(const ShapeInfo& info, const btCollisionShape* shape) {
+    if (!isHullShape(info.getType())) {
+        return;
+    }
+
+    QByteArray cooked = writeCookedShape(shape);
+    if (!cooked.isEmpty()) {
+        writeFile(cooked.constData(), Metadata(getKey(info), cooked.size()));
+    }
+}
+
+static void writeHull(QDataStream& stream, const btConvexHullShape* hull, const btVector3& origin) {
+    stream << (float)origin.getX() << (float)origin.getY() << (float)origin.getZ();
+    stream << (float)hull->getMargin();
+    stream << (quint32)hull->getNumPoints();
+    for (int i = 0; i < hull->getNumPoints(); ++i) {
+        btVector3 point = hull->getScaledPoint(i);
+        stream << (float)point.getX() << (float)point.getY() << (float)point.getZ();
+    }
+}
+
+QByteArray CookedShapeCache::writeCookedShape(const btCollisionShape* shape) {
+    QByteArray cooked;
+    if (!shape) {
+        return cooked;
+    }
+
+    // the hulls and the transforms they were given within a compound (only ever a translation, for the offset)
+    std::vector<std::pair<const btConvexHullShape*, btVector3>> hulls;
+    bool isCompound = shape->getShapeType() == (int)COMPOUND_SHAPE_PROXYTYPE;
+    if (isCompound) {
+        const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+        for (int i = 0; i < compound->getNumChildShapes(); ++i) {
+            const btCollisionShape* child = compound->getChildShape(i);
+            const btTransform& transform = compound->getChildTransform(i);
+            if (child->getShapeType() != (int)CONVEX_HULL_SHAPE_PROXYTYPE || !(transform.getBasis() == btMatrix3x3::getIdentity())) {
+                return cooked;
+            }
+            hulls.emplace_back(static_cast<const btConvexHullShape*>(child), transform.getOrigin());
+        }
+    } else if (shape->getShapeType() == (int)CONVEX_HULL_SHAPE_PROXYTYPE) {
+        hulls.emplace_back(static_cast<const btConvexHullShape*>(shape), btVector3(0.0f, 0.0f, 0.0f));
+    } else {
+        return cooked;
+    }
+
+    QDataStream stream(&cooked, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << (qint32)CURRENT_VERSION << isCompound << (quint32)hulls.size();
+    for (const auto& hull : hulls) {
+        writeHull(stream, hull.first, hull.second);
+    }
+    return cooked;
+}
+
+btCollisionShape* CookedShapeCache::readCookedShape(const QByteArray& data) {
+    QDataStream stream(data);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    qint32 version;
+    bool isCompound;
+    quint32 numHulls;
+    stream >> version >> isCompound >> numHulls;
+    if (stream.status() != QDataStream::Ok || version != CURRENT_VERSION || numHulls == 0 || (!isCompound && numHulls != 1)) {
+        return nullptr;
+    }
+
+    std::vector<std::pair<btConvexHullShape*, btVector3>> hulls;
+    auto deleteHulls = [&] {
+        for (auto& hull : hulls) {
+            delete hull.first;
+        }
+    };
+
+    for (quint32 i = 0; i < numHulls; ++i) {
+        float x, y, z, margin;
+        quint32 numPoints;
+        stream >> x >> y >> z >> margin >> numPoints;
+
+        const int BYTES_PER_POINT = 3 * sizeof(float);
+        if (stream.status() != QDataStream::Ok || numPoints > (quint32)(data.size() / BYTES_PER_POINT)) {
+            deleteHulls();
+            return nullptr;
+        }
+
+        btConvexHullShape* hull = new btConvexHullShape();
+        hulls.emplace_back(hull, btVector3(x, y, z));
+        for (quint32 j = 0; j < numPoints; ++j) {
+            float px, py, pz;
+            stream >> px >> py >> pz;
+            hull->addPoint(btVector3(px, py, pz), false);
+        }
+        if (stream.status() != QDataStream::Ok) {
+            deleteHulls();
+            return nullptr;
+        }
+        hull->setMargin(margin);
+        hull->recalcLocalAabb();
+    }
+
+    if (!isCompound) {
+        return hulls[0].first;
+    }
+
+    btCompoundShape* compound = new btCompoundShape();
+    for (auto& hull : hulls) {
+        btTransform transform;
+        transform.setIdentity();
+        transform.setOrigin(hull.second);
+        compound->addChildShape(transform, hull.first);
+    }
+    return compound;
+}
@@ -0,0 +1,59 @@
+//
+//  CookedShapeCache.h
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CookedShapeCache_h
+#define hifi_CookedShapeCache_h
+
+#include <QByteArray>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <ShapeInfo.h>
+#include <shared/FileCache.h>
+
+// Persists the convex hulls built for hull and compound shapes, so that they don't have to be reduced and
+// margin corrected again when the same model is seen in a later session
+class CookedShapeCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    // Whenever a change is made to the cooked layout (or to how ShapeFactory builds hulls) that isn't backward
+    // compatible, this value should be incremented.  This will force the shape cache to be wiped
+    static const int CURRENT_VERSION;
+    static const int INVALID_VERSION;
+    static const char* SETTING_VERSION_NAME;
+
+    static const std::string DIRNAME;
+    static const std::string EXT;
+
+    CookedShapeCache(const std::string& dir = DIRNAME, const std::string& ext = EXT);
+
+    void initialize() override;
+
+    /// \return a new shape rebuilt from the cooked hulls for this info, or nullptr if there aren't any
+    const btCollisionShape* readShape(const ShapeInfo& info);
+
+    /// saves the hulls of a shape built by ShapeFactory, if it is made only of hulls
+    void writeShape(const ShapeInfo& info, const btCollisionShape* shape);
+
+    // ShapeInfo::getHash() only covers the type, extents and offset, so the points are hashed in as well
+    static std::string getKey(const ShapeInfo& info);
+
+    /// \return the cooked form of a convex hull, or a compound of them, or an empty array for any other shape
+    static QByteArray writeCookedShape(const btCollisionShape* shape);
+
+    /// \return a new shape, or nullptr if the data is truncated or was written by another version
+    static btCollisionShape* readCookedShape(const QByteArray& data);
+
+protected:
+    std::unique_ptr<cache::File> createFile(Metadata&& metadata, const std::string& filepath) override final;
+};
+
+#endif // hifi_CookedShapeCache_h
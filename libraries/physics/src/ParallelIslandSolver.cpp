@@ -0,0 +1,223 @@
+//
+//  ParallelIslandSolver.cpp
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ParallelIslandSolver.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <LinearMath/btQuickprof.h>
+
+#include <TBBHelpers.h>
+#include <tbb/enumerable_thread_specific.h>
+
+// same as btDiscreteDynamicsWorld: a constraint belongs to the island of whichever of its bodies is in one
+static int getConstraintIslandId(const btTypedConstraint* constraint) {
+    const btCollisionObject& objectA = constraint->getRigidBodyA();
+    const btCollisionObject& objectB = constraint->getRigidBodyB();
+    return objectA.getIslandTag() >= 0 ? objectA.getIslandTag() : objectB.getIslandTag();
+}
+
+// one solver per thread, created the first time a thread solves an island
+class ParallelIslandSolver::SolverPool {
+public:
+    btConstraintSolver* local() {
+        std::shared_ptr<btSequentialImpulseConstraintSolver>& solver = _solvers.local();
+        if (!solver) {
+            solver = std::make_shared<btSequentialImpulseConstraintSolver>();
+        }
+        return solver.get();
+    }
+
+private:
+    tbb::enumerable_thread_specific<std::shared_ptr<btSequentialImpulseConstraintSolver>> _solvers;
+};
+
+ParallelIslandSolver::ParallelIslandSolver() : _solverPool(new SolverPool()) {
+}
+
+ParallelIslandSolver::~ParallelIslandSolver() {
+}
+
+void ParallelIslandSolver::solveIslands(btSimulationIslandManager* islandManager, btCollisionWorld* world,
+                                        btTypedConstraint** constraints, int numConstraints,
+                                        const btContactSolverInfo& solverInfo) {
+    _bodies.clear();
+    _manifolds.clear();
+    _islands.clear();
+
+    {
+        BT_PROFILE("gatherIslands");
+        // the island tags were assigned by calculateSimulationIslands() earlier in the step
+        _sortedConstraints.assign(constraints, constraints + numConstraints);
+        std::stable_sort(_sortedConstraints.begin(), _sortedConstraints.end(),
+            [](const btTypedConstraint* a, const btTypedConstraint* b) {
+            return getConstraintIslandId(a) < getConstraintIslandId(b);
+        });
+
+        islandManager->buildAndProcessIslands(world->getDispatcher(), world, this);
+        if (_islands.empty()) {
+            return;
+        }
+        mergeIslandsSharingKinematicBodies();
+        buildGroups();
+    }
+
+    btDispatcher* dispatcher = world->getDispatcher();
+
+#ifdef BT_HAS_THREAD_PROFILING_SWITCH
+    if (_groups.size() > 1) {
+        BT_PROFILE("solveIslandsInParallel");
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, _groups.size(), 1),
+            [&](const tbb::blocked_range<size_t>& range) {
+            // CProfileManager isn't thread safe, see cmake/externals/bullet/PatchQuickprof.cmake
+            bool wasProfiling = btIsThreadProfilingEnabled();
+            btSetThreadProfilingEnabled(false);
+            btConstraintSolver* solver = _solverPool->local();
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                solveGroup(_groups[i], solver, solverInfo, dispatcher);
+            }
+            btSetThreadProfilingEnabled(wasProfiling);
+        });
+        return;
+    }
+#endif
+
+    // a single group gains nothing from the task pool
+    btConstraintSolver* solver = _solverPool->local();
+    for (const Group& group : _groups) {
+        solveGroup(group, solver, solverInfo, dispatcher);
+    }
+}
+
+void ParallelIslandSolver::processIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds,
+                                         int numManifolds, int islandId) {
+    // the constraints are sorted by island, find the ones for this island
+    auto islandIdLess = [](const btTypedConstraint* constraint, int id) {
+        return getConstraintIslandId(constraint) < id;
+    };
+    auto firstConstraint = std::lower_bound(_sortedConstraints.begin(), _sortedConstraints.end(), islandId, islandIdLess);
+    auto lastConstraint = firstConstraint;
+    while (lastConstraint != _sortedConstraints.end() && getConstraintIslandId(*lastConstraint) == islandId) {
+        ++lastConstraint;
+    }
+    int numConstraints = (int)(lastConstraint - firstConstraint);
+
+    if (numManifolds == 0 && numConstraints == 0) {
+        // the solver has nothing to do for islands of bodies that aren't touching anything
+        return;
+    }
+
+    Island island;
+    island.bodiesBegin = (int)_bodies.size();
+    island.numBodies = numBodies;
+    island.manifoldsBegin = (int)_manifolds.size();
+    island.numManifolds = numManifolds;
+    island.constraintsBegin = (int)(firstConstraint - _sortedConstraints.begin());
+    island.numConstraints = numConstraints;
+    island.parent = (int)_islands.size();
+    _islands.push_back(island);
+
+    // the arrays we are handed are reused by the island manager, so copy them
+    _bodies.insert(_bodies.end(), bodies, bodies + numBodies);
+    _manifolds.insert(_manifolds.end(), manifolds, manifolds + numManifolds);
+}
+
+int ParallelIslandSolver::findRoot(int island) {
+    while (_islands[island].parent != island) {
+        _islands[island].parent = _islands[_islands[island].parent].parent;
+        island = _islands[island].parent;
+    }
+    return island;
+}
+
+void ParallelIslandSolver::mergeIslandsSharingKinematicBodies() {
+    std::unordered_map<const btCollisionObject*, int> kinematicIslands;
+    auto touchKinematicBody = [&](const btCollisionObject* object, int island) {
+        if (!object->isKinematicObject()) {
+            return;
+        }
+        auto result = kinematicIslands.insert({ object, island });
+        if (!result.second) {
+            int rootA = findRoot(result.first->second);
+            int rootB = findRoot(island);
+            if (rootA != rootB) {
+                _islands[rootB].parent = rootA;
+            }
+        }
+    };
+
+    for (int i = 0; i < (int)_islands.size(); ++i) {
+        const Island& island = _islands[i];
+        for (int j = 0; j < island.numManifolds; ++j) {
+            const btPersistentManifold* manifold = _manifolds[island.manifoldsBegin + j];
+            touchKinematicBody(manifold->getBody0(), i);
+            touchKinematicBody(manifold->getBody1(), i);
+        }
+        for (int j = 0; j < island.numConstraints; ++j) {
+            const btTypedConstraint* constraint = _sortedConstraints[island.constraintsBegin + j];
+            touchKinematicBody(&constraint->getRigidBodyA(), i);
+            touchKinematicBody(&constraint->getRigidBodyB(), i);
+        }
+    }
+}
+
+void ParallelIslandSolver::buildGroups() {
+    int numIslands = (int)_islands.size();
+    std::vector<int> groupOfRoot(numIslands, -1);
+    std::vector<int> islandGroups(numIslands);
+
+    _groups.clear();
+    for (int i = 0; i < numIslands; ++i) {
+        int root = findRoot(i);
+        if (groupOfRoot[root] < 0) {
+            groupOfRoot[root] = (int)_groups.size();
+            _groups.push_back({ 0, 0, 0 });
+        }
+        int groupIndex = groupOfRoot[root];
+        islandGroups[i] = groupIndex;
+
+        Group& group = _groups[groupIndex];
+        group.numIslands++;
+        group.work += _islands[i].numConstraints;
+        for (int j = 0; j < _islands[i].numManifolds; ++j) {
+            group.work += _manifolds[_islands[i].manifoldsBegin + j]->getNumContacts();
+        }
+    }
+
+    // lay the islands out by group
+    int begin = 0;
+    for (Group& group : _groups) {
+        group.islandsBegin = begin;
+        begin += group.numIslands;
+        group.numIslands = 0;
+    }
+    _groupedIslands.resize(numIslands);
+    for (int i = 0; i < numIslands; ++i) {
+        Group& group = _groups[islandGroups[i]];
+        _groupedIslands[group.islandsBegin + group.numIslands++] = i;
+    }
+
+    // start the biggest groups first so that a large stack doesn't end up being solved last
+    std::stable_sort(_groups.begin(), _groups.end(), [](const Group& a, const Group& b) {
+        return a.work > b.work;
+    });
+}
+
+void ParallelIslandSolver::solveGroup(const Group& group, btConstraintSolver* solver,
+                                      const btContactSolverInfo& solverInfo, btDispatcher* dispatcher) {
+    for (int i = 0; i < group.numIslands; ++i) {
+        const Island& island = _islands[_groupedIslands[group.islandsBegin + i]];
+        btPersistentManifold** manifolds = island.numManifolds > 0 ? &_manifolds[island.manifoldsBegin] : nullptr;
+        btTypedConstraint** constraints = island.numConstraints > 0 ? &_sortedConstraints[island.constraintsBegin] : nullptr;
+        solver->solveGroup(&_bodies[island.bodiesBegin], island.numBodies, manifolds, island.numManifolds,
+                           constraints, island.numConstraints, solverInfo, nullptr, dispatcher);
+    }
+}
@@ -0,0 +1,76 @@
+//
+//  ParallelIslandSolver.h
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParallelIslandSolver_h
+#define hifi_ParallelIslandSolver_h
+
+#include <memory>
+#include <vector>
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
+
+// Solves the constraints of each simulation island with its own btSequentialImpulseConstraintSolver, spreading the
+// islands across the TBB task pool.
+//
+// Islands never share a dynamic body, but they can share a kinematic one (the solver briefly stores its own index
+// in the body's companion id), so islands that touch the same kinematic body are solved together on one thread.
+class ParallelIslandSolver : public btSimulationIslandManager::IslandCallback {
+public:
+    ParallelIslandSolver();
+    ~ParallelIslandSolver();
+
+    // solves the contacts and constraints of the awake islands in the world
+    void solveIslands(btSimulationIslandManager* islandManager, btCollisionWorld* world,
+                      btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& solverInfo);
+
+    // called by btSimulationIslandManager::buildAndProcessIslands() for each awake island
+    void processIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+                       int islandId) override;
+
+    int getNumIslands() const { return (int)_islands.size(); }
+    int getNumGroups() const { return (int)_groups.size(); }
+
+private:
+    struct Island {
+        int bodiesBegin;
+        int numBodies;
+        int manifoldsBegin;
+        int numManifolds;
+        int constraintsBegin;
+        int numConstraints;
+        int parent; // for merging islands that share kinematic bodies
+    };
+
+    struct Group {
+        int islandsBegin;
+        int numIslands;
+        int work;
+    };
+
+    int findRoot(int island);
+    void mergeIslandsSharingKinematicBodies();
+    void buildGroups();
+    void solveGroup(const Group& group, btConstraintSolver* solver, const btContactSolverInfo& solverInfo,
+                    btDispatcher* dispatcher);
+
+    class SolverPool;
+    std::unique_ptr<SolverPool> _solverPool;
+
+    // gathered for the current step, reused across steps to avoid reallocating
+    std::vector<btTypedConstraint*> _sortedConstraints;
+    std::vector<btCollisionObject*> _bodies;
+    std::vector<btPersistentManifold*> _manifolds;
+    std::vector<Island> _islands;
+    std::vector<int> _groupedIslands;
+    std::vector<Group> _groups;
+};
+
+#endif // hifi_ParallelIslandSolver_h
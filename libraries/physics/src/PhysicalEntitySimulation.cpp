@@ -10,6 +10,7 @@
 //
 
 
+#include <DirtyOctreeElementOperator.h>
 
 #include "PhysicsHelpers.h"
 #include "PhysicsLogging.h"
@@ -61,6 +62,7 @@ void PhysicalEntitySimulation::removeEntityInternal(EntityItemPointer entity) {
         EntitySimulation::removeEntityInternal(entity);
         QMutexLocker lock(&_mutex);
         _entitiesToAddToPhysics.remove(entity);
+        _shapeInfosToAdd.remove(entity);
 
         EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
         if (motionState) {
@@ -110,6 +112,7 @@ void PhysicalEntitySimulation::changeEntityInternal(EntityItemPointer entity) {
         // The intent is for this object to be in the PhysicsEngine, but it has no MotionState yet.
         // Perhaps it's shape has changed and it can now be added?
         _entitiesToAddToPhysics.insert(entity);
+        _shapeInfosToAdd.remove(entity);
         _simpleKinematicEntities.remove(entity); // just in case it's non-physical-kinematic
     } else if (entity->isMovingRelativeToParent()) {
         _simpleKinematicEntities.insert(entity);
@@ -148,6 +151,7 @@ void PhysicalEntitySimulation::clearEntitiesInternal() {
     _entitiesToRemoveFromPhysics.clear();
     _entitiesToRelease.clear();
     _entitiesToAddToPhysics.clear();
+    _shapeInfosToAdd.clear();
     _pendingChanges.clear();
     _outgoingChanges.clear();
 }
@@ -167,6 +171,7 @@ void PhysicalEntitySimulation::getObjectsToRemoveFromPhysics(VectorOfMotionState
     for (auto entity: _entitiesToRemoveFromPhysics) {
         // make sure it isn't on any side lists
         _entitiesToAddToPhysics.remove(entity);
+        _shapeInfosToAdd.remove(entity);
 
         EntityMotionState* motionState = static_cast<EntityMotionState*>(entity->getPhysicsInfo());
         if (motionState) {
@@ -208,33 +213,55 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
         assert(!entity->getPhysicsInfo());
         if (entity->isDead()) {
             prepareEntityForDelete(entity);
+            _shapeInfosToAdd.remove(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
         } else if (!entity->shouldBePhysical()) {
             // this entity should no longer be on the internal _entitiesToAddToPhysics
+            _shapeInfosToAdd.remove(entity);
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
             if (entity->isMovingRelativeToParent()) {
                 _simpleKinematicEntities.insert(entity);
             }
         } else if (entity->isReadyToComputeShape()) {
-            ShapeInfo shapeInfo;
-            entity->computeShapeInfo(shapeInfo);
-            int numPoints = shapeInfo.getLargestSubshapePointCount();
-            if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
-                if (numPoints > MAX_HULL_POINTS) {
-                    qWarning() << "convex hull with" << numPoints
-                        << "points for entity" << entity->getName()
-                        << "at" << entity->getPosition() << " will be reduced";
-                }
+            // the shape info is computed once and kept while the shape cooks, until the entity changes
+            auto shapeInfoItr = _shapeInfosToAdd.find(entity);
+            if (shapeInfoItr == _shapeInfosToAdd.end()) {
+                ShapeInfo shapeInfo;
+                entity->computeShapeInfo(shapeInfo);
+                shapeInfoItr = _shapeInfosToAdd.insert(entity, shapeInfo);
+            }
+            const ShapeInfo& shapeInfo = shapeInfoItr.value();
+            if (shapeInfo.isBuiltFromPoints() && shapeInfo.getLargestSubshapePointCount() == 0) {
+                // the entity-server doesn't download models, so it has no points to build their shapes from
+                // (the entity comes back here when it changes, e.g. to a shape that doesn't need them)
+                _shapeInfosToAdd.erase(shapeInfoItr);
+                entityItr = _entitiesToAddToPhysics.erase(entityItr);
+                continue;
             }
-            btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+            // hulls and meshes are cooked on a worker thread, the entity is added once its shape is ready
+            ShapeManager* shapeManager = ObjectMotionState::getShapeManager();
+            btCollisionShape* shape = const_cast<btCollisionShape*>(shapeManager->getShapeAsync(shapeInfo));
             if (shape) {
+                int numPoints = shapeInfo.getLargestSubshapePointCount();
+                if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
+                    if (numPoints > MAX_HULL_POINTS) {
+                        qWarning() << "convex hull with" << numPoints
+                            << "points for entity" << entity->getName()
+                            << "at" << entity->getPosition() << " will be reduced";
+                    }
+                }
                 EntityMotionState* motionState = new EntityMotionState(shape, entity);
                 entity->setPhysicsInfo(static_cast<void*>(motionState));
                 _physicalObjects.insert(motionState);
                 result.push_back(motionState);
+                _shapeInfosToAdd.erase(shapeInfoItr);
+                entityItr = _entitiesToAddToPhysics.erase(entityItr);
+            } else if (shapeManager->hasFailedToCook(shapeInfo)) {
+                // it won't cook next time either, the entity comes back here when it changes
+                qWarning() << "Failed to generate new shape for entity." << entity->getName();
+                _shapeInfosToAdd.erase(shapeInfoItr);
                 entityItr = _entitiesToAddToPhysics.erase(entityItr);
             } else {
-                //qWarning() << "Failed to generate new shape for entity." << entity->getName();
                 ++entityItr;
             }
         } else {
@@ -284,6 +311,11 @@ void PhysicalEntitySimulation::handleChangedMotionStates(const VectorOfMotionSta
             EntityMotionState* entityState = static_cast<EntityMotionState*>(state);
             EntityItemPointer entity = entityState->getEntity();
             assert(entity.get());
+            if (_volunteerPriority > entity->getSimulationPriority() && !entityState->isLocallyOwned() &&
+                    entity->getDynamic() && entity->hasLocalVelocity() && !entity->hasActions()) {
+                // objects with actions are left to whoever created the actions, we can't simulate those here
+                entityState->upgradeOutgoingPriority(_volunteerPriority);
+            }
             if (entityState->isCandidateForOwnership()) {
                 _outgoingChanges.insert(entityState);
             }
@@ -319,6 +351,25 @@ void PhysicalEntitySimulation::handleChangedMotionStates(const VectorOfMotionSta
     }
 }
 
+void PhysicalEntitySimulation::clearOwnership(const QUuid& ownerID) {
+    QMutexLocker lock(&_mutex);
+    for (auto stateItr : _physicalObjects) {
+        EntityMotionState* motionState = static_cast<EntityMotionState*>(&(*stateItr));
+        EntityItemPointer entity = motionState->getEntity();
+        if (entity && entity->getSimulatorID() == ownerID) {
+            // the simulator has abandoned this object --> remove ownership and dirty all the tree elements that contain it
+            entity->clearSimulationOwnership();
+            entity->markAsChangedOnServer();
+            DirtyOctreeElementOperator op(entity->getElement());
+            getEntityTree()->recurseTreeWithOperator(&op);
+
+            // and let the MotionState decide whether to volunteer for it
+            entity->markDirtyFlags(Simulation::DIRTY_SIMULATOR_ID);
+            _pendingChanges.insert(motionState);
+        }
+    }
+}
+
 void PhysicalEntitySimulation::handleCollisionEvents(const CollisionEvents& collisionEvents) {
     for (auto collision : collisionEvents) {
         // NOTE: The collision event is always aligned such that idA is never NULL.
@@ -354,6 +405,10 @@ void PhysicalEntitySimulation::applyDynamicChanges() {
             _physicsEngine->removeDynamic(dynamicToRemove);
         }
         foreach (EntityDynamicPointer dynamicToAdd, _dynamicsToAdd) {
+            if (!dynamicToAdd->isAction() && !dynamicToAdd->isConstraint()) {
+                // e.g. the entity-server's AssignmentDynamic, which only carries the data for others to simulate
+                continue;
+            }
             if (!_dynamicsToRemove.contains(dynamicToAdd->getID())) {
                 if (!_physicsEngine->addDynamic(dynamicToAdd)) {
                     dynamicsFailedToAdd += dynamicToAdd;
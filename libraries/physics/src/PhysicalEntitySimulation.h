@@ -60,12 +60,19 @@ public:
     void handleChangedMotionStates(const VectorOfMotionStates& motionStates);
     void handleCollisionEvents(const CollisionEvents& collisionEvents);
 
+    /// \brief volunteer for every moving dynamic entity owned at less than this priority (zero, the default, for none)
+    void setVolunteerPriority(uint8_t priority) { _volunteerPriority = priority; }
+
+    /// \brief clear the simulation ownership of a simulator that has gone away (entity-server only)
+    void clearOwnership(const QUuid& ownerID);
+
     EntityEditPacketSender* getPacketSender() { return _entityPacketSender; }
 
 private:
     SetOfEntities _entitiesToRemoveFromPhysics;
     SetOfEntities _entitiesToRelease;
     SetOfEntities _entitiesToAddToPhysics;
+    QHash<EntityItemPointer, ShapeInfo> _shapeInfosToAdd; // of the entities waiting for their shapes to cook
 
     SetOfEntityMotionStates _pendingChanges; // EntityMotionStates already in PhysicsEngine that need their physics changed
     SetOfEntityMotionStates _outgoingChanges; // EntityMotionStates for which we may need to send updates to entity-server
@@ -76,6 +83,7 @@ private:
     EntityEditPacketSender* _entityPacketSender = nullptr;
 
     uint32_t _lastStepSendPackets { 0 };
+    uint8_t _volunteerPriority { 0 };
 };
 
 
@@ -563,6 +563,15 @@ void PhysicsEngine::bumpAndPruneContacts(ObjectMotionState* motionState) {
     removeContacts(motionState);
 }
 
+int PhysicsEngine::getNumCollisionObjects() const {
+    return _dynamicsWorld ? _dynamicsWorld->getNumCollisionObjects() : 0;
+}
+
+void PhysicsEngine::setParallelIslandSolving(bool enabled) {
+    assert(_dynamicsWorld);
+    _dynamicsWorld->setParallelIslandSolving(enabled);
+}
+
 void PhysicsEngine::setCharacterController(CharacterController* character) {
     if (_myAvatarController != character) {
         if (_myAvatarController) {
@@ -66,6 +66,9 @@ public:
 
     bool hasOutgoingChanges() const { return _hasOutgoingChanges; }
 
+    /// \return number of objects in the dynamics world
+    int getNumCollisionObjects() const;
+
     /// \return reference to list of changed MotionStates.  The list is only valid until beginning of next simulation loop.
     const VectorOfMotionStates& getChangedMotionStates();
     const VectorOfMotionStates& getDeactivatedMotionStates() const { return _dynamicsWorld->getDeactivatedMotionStates(); }
@@ -86,6 +89,9 @@ public:
 
     void dumpNextStats() { _dumpNextStats = true; }
 
+    /// \brief spread the simulation islands across threads when solving contacts and constraints
+    void setParallelIslandSolving(bool enabled);
+
     EntityDynamicPointer getDynamicByID(const QUuid& dynamicID) const;
     bool addDynamic(EntityDynamicPointer dynamic);
     void removeDynamic(const QUuid dynamicID);
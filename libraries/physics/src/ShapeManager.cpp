@@ -10,22 +10,46 @@
 //
 
 #include <QDebug>
+#include <QRunnable>
 
 #include <glm/gtx/norm.hpp>
 
+#include "CookedShapeCache.h"
 #include "ShapeFactory.h"
 #include "ShapeManager.h"
 
+class ShapeCooker : public QRunnable {
+public:
+    ShapeCooker(ShapeManager* manager, const ShapeInfo& info) : _manager(manager), _info(info) {}
+
+    void run() override {
+        _manager->cookedShapeFinished(_info.getHash(), _manager->cookShape(_info));
+    }
+
+private:
+    ShapeManager* _manager;
+    ShapeInfo _info;
+};
+
 ShapeManager::ShapeManager() {
+    _cookingThreadPool.setObjectName("ShapeCooking");
 }
 
 ShapeManager::~ShapeManager() {
+    waitForCookedShapes();
+
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
         ShapeFactory::deleteShape(shapeRef->shape);
     }
     _shapeMap.clear();
+
+    int numReadyShapes = _readyShapes.size();
+    for (int i = 0; i < numReadyShapes; ++i) {
+        ShapeFactory::deleteShape(_readyShapes.getAtIndex(i)->shape);
+    }
+    _readyShapes.clear();
 }
 
 const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
@@ -38,7 +62,12 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    const btCollisionShape* shape = claimCookedShape(key);
+    if (shape) {
+        return shape;
+    }
+    // the cooked shape cache is only read on the cooking threads, a shape that is needed right away is built here
+    shape = ShapeFactory::createShapeFromInfo(info);
     if (shape) {
         ShapeReference newRef;
         newRef.refCount = 1;
@@ -49,6 +78,104 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     return shape;
 }
 
+const btCollisionShape* ShapeManager::getShapeAsync(const ShapeInfo& info) {
+    // hulls and meshes can take several milliseconds to build, too long to do on the simulation thread
+    if (!info.isBuiltFromPoints()) {
+        return getShape(info);
+    }
+
+    addCookedShapes();
+
+    DoubleHashKey key = info.getHash();
+    ShapeReference* shapeRef = _shapeMap.find(key);
+    if (shapeRef) {
+        shapeRef->refCount++;
+        return shapeRef->shape;
+    }
+
+    const btCollisionShape* shape = claimCookedShape(key);
+    if (shape) {
+        return shape;
+    }
+
+    if (!_cookingShapes.find(key) && !_failedShapes.find(key)) {
+        _cookingShapes.insert(key, true);
+        _cookingThreadPool.start(new ShapeCooker(this, info));
+    }
+    return nullptr;
+}
+
+void ShapeManager::waitForCookedShapes() {
+    _cookingThreadPool.waitForDone();
+    addCookedShapes();
+}
+
+const btCollisionShape* ShapeManager::cookShape(const ShapeInfo& info) const {
+    if (_cookedShapeCache) {
+        const btCollisionShape* shape = _cookedShapeCache->readShape(info);
+        if (shape) {
+            return shape;
+        }
+    }
+
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    if (shape && _cookedShapeCache) {
+        _cookedShapeCache->writeShape(info, shape);
+    }
+    return shape;
+}
+
+void ShapeManager::cookedShapeFinished(const DoubleHashKey& key, const btCollisionShape* shape) {
+    std::lock_guard<std::mutex> lock(_cookedShapesMutex);
+    _cookedShapes.emplace_back(key, shape);
+}
+
+void ShapeManager::addCookedShapes() {
+    std::vector<std::pair<DoubleHashKey, const btCollisionShape*>> cookedShapes;
+    {
+        std::lock_guard<std::mutex> lock(_cookedShapesMutex);
+        cookedShapes.swap(_cookedShapes);
+    }
+
+    for (const auto& cookedShape : cookedShapes) {
+        const DoubleHashKey& key = cookedShape.first;
+        const btCollisionShape* shape = cookedShape.second;
+        _cookingShapes.remove(key);
+        if (!shape) {
+            _failedShapes.insert(key, true);
+            continue;
+        }
+
+        if (_shapeMap.find(key)) {
+            // getShape() built this one while it was cooking
+            ShapeFactory::deleteShape(shape);
+            continue;
+        }
+
+        ReadyShape readyShape;
+        readyShape.shape = shape;
+        readyShape.key = key;
+        _readyShapes.insert(key, readyShape);
+    }
+}
+
+const btCollisionShape* ShapeManager::claimCookedShape(const DoubleHashKey& key) {
+    const ReadyShape* readyShape = _readyShapes.find(key);
+    if (!readyShape) {
+        return nullptr;
+    }
+
+    const btCollisionShape* shape = readyShape->shape;
+    _readyShapes.remove(key);
+
+    ShapeReference newRef;
+    newRef.refCount = 1;
+    newRef.shape = shape;
+    newRef.key = key;
+    _shapeMap.insert(key, newRef);
+    return shape;
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(const DoubleHashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -86,6 +213,8 @@ bool ShapeManager::releaseShape(const btCollisionShape* shape) {
 }
 
 void ShapeManager::collectGarbage() {
+    addCookedShapes();
+
     int numShapes = _pendingGarbage.size();
     for (int i = 0; i < numShapes; ++i) {
         DoubleHashKey& key = _pendingGarbage[i];
@@ -96,6 +225,22 @@ void ShapeManager::collectGarbage() {
         }
     }
     _pendingGarbage.clear();
+
+    // a cooked shape is picked up on the next step of whoever asked for it, one that is still here by the next pass
+    // was asked for by an object that has since gone away or changed shape
+    const int MAX_UNCLAIMED_GARBAGE_PASSES = 1;
+    btAlignedObjectArray<DoubleHashKey> unclaimedShapes;
+    int numReadyShapes = _readyShapes.size();
+    for (int i = 0; i < numReadyShapes; ++i) {
+        ReadyShape* readyShape = _readyShapes.getAtIndex(i);
+        if (++readyShape->numGarbagePasses > MAX_UNCLAIMED_GARBAGE_PASSES) {
+            ShapeFactory::deleteShape(readyShape->shape);
+            unclaimedShapes.push_back(readyShape->key);
+        }
+    }
+    for (int i = 0; i < unclaimedShapes.size(); ++i) {
+        _readyShapes.remove(unclaimedShapes[i]);
+    }
 }
 
 int ShapeManager::getNumReferences(const ShapeInfo& info) const {
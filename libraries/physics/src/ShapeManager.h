@@ -12,6 +12,12 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QThreadPool>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
@@ -19,6 +25,8 @@
 
 #include "DoubleHashKey.h"
 
+class CookedShapeCache;
+
 class ShapeManager {
 public:
 
@@ -28,21 +36,43 @@ public:
     /// \return pointer to shape
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    /// Like getShape(), except that hulls and meshes, which are expensive to build, are cooked on a worker thread.
+    /// \return pointer to shape, or nullptr if the shape is still cooking (call again later to pick it up)
+    /// or could not be built
+    const btCollisionShape* getShapeAsync(const ShapeInfo& info);
+
+    /// blocks until all shapes that are cooking have finished
+    void waitForCookedShapes();
+
+    /// optional on-disk cache of cooked hulls, must be set before any shapes are requested
+    void setCookedShapeCache(std::shared_ptr<CookedShapeCache> cache) { _cookedShapeCache = cache; }
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
-    /// delete shapes that have zero references
+    /// delete shapes that have zero references, and cooked shapes that have not been asked for since the last call
     void collectGarbage();
 
     // validation methods
     int getNumShapes() const { return _shapeMap.size(); }
+    int getNumCookingShapes() const { return _cookingShapes.size(); }
+    int getNumCookedShapes() const { return _readyShapes.size(); }
+    bool hasFailedToCook(const ShapeInfo& info) const { return _failedShapes.find(info.getHash()) != nullptr; }
     int getNumReferences(const ShapeInfo& info) const;
     int getNumReferences(const btCollisionShape* shape) const;
     bool hasShape(const btCollisionShape* shape) const;
 
 private:
+    friend class ShapeCooker;
+
     bool releaseShapeByKey(const DoubleHashKey& key);
 
+    // builds a shape, using the cooked shape cache if there is one (called from worker threads)
+    const btCollisionShape* cookShape(const ShapeInfo& info) const;
+    const btCollisionShape* claimCookedShape(const DoubleHashKey& key);
+    void cookedShapeFinished(const DoubleHashKey& key, const btCollisionShape* shape);
+    void addCookedShapes();
+
     class ShapeReference {
     public:
         int refCount;
@@ -53,6 +83,28 @@ private:
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
+
+    std::shared_ptr<CookedShapeCache> _cookedShapeCache;
+    QThreadPool _cookingThreadPool;
+    btHashMap<DoubleHashKey, bool> _cookingShapes;
+
+    class ReadyShape {
+    public:
+        const btCollisionShape* shape;
+        DoubleHashKey key;
+        int numGarbagePasses; // collectGarbage() calls since the shape was cooked
+        ReadyShape() : shape(nullptr), numGarbagePasses(0) {}
+    };
+
+    // cooked shapes are held here, unreferenced, until they are asked for again or collectGarbage() gives up on them
+    btHashMap<DoubleHashKey, ReadyShape> _readyShapes;
+
+    // shapes that could not be cooked are not cooked again
+    btHashMap<DoubleHashKey, bool> _failedShapes;
+
+    // shapes finished by the workers, waiting to be picked up on the thread that uses this ShapeManager
+    std::mutex _cookedShapesMutex;
+    std::vector<std::pair<DoubleHashKey, const btCollisionShape*>> _cookedShapes;
 };
 
 #endif // hifi_ShapeManager_h
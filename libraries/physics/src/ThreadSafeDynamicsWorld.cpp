@@ -15,10 +15,18 @@
  * Copied and modified from btDiscreteDynamicsWorld.cpp by AndrewMeadows on 2014.11.12.
  * */
 
+#include <mutex>
+
 #include <LinearMath/btQuickprof.h>
 
 #include "ThreadSafeDynamicsWorld.h"
 
+#include "ParallelIslandSolver.h"
+#include "PhysicsLogging.h"
+
+// below this many contact manifolds solving the islands on one thread is faster than handing them out
+const int MIN_MANIFOLDS_FOR_PARALLEL_SOLVE = 64;
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
@@ -27,6 +35,52 @@ ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
     :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
 }
 
+ThreadSafeDynamicsWorld::~ThreadSafeDynamicsWorld() {
+}
+
+void ThreadSafeDynamicsWorld::setParallelIslandSolving(bool enabled) {
+    if (enabled == isParallelIslandSolving()) {
+        return;
+    }
+#ifdef BT_HAS_THREAD_PROFILING_SWITCH
+    if (enabled) {
+        _islandSolver.reset(new ParallelIslandSolver());
+    } else {
+        _islandSolver.reset();
+    }
+#else
+    // Bullet's profiler would be used from several threads at once without cmake/externals/bullet/PatchQuickprof.cmake
+    // (this is called every frame with the requested state, so only say so once)
+    static std::once_flag warning;
+    std::call_once(warning, [] {
+        qCWarning(physics) << "Parallel island solving is not supported by this build of Bullet";
+    });
+#endif
+}
+
+bool ThreadSafeDynamicsWorld::supportsParallelIslandSolving() {
+#ifdef BT_HAS_THREAD_PROFILING_SWITCH
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    // the island manager only hands out islands one at a time when it is splitting them
+    if (!_islandSolver || !m_islandManager->getSplitIsland() ||
+            getDispatcher()->getNumManifolds() < MIN_MANIFOLDS_FOR_PARALLEL_SOLVE) {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+
+    BT_PROFILE("solveConstraints");
+    btTypedConstraint** constraints = m_constraints.size() > 0 ? &m_constraints[0] : nullptr;
+
+    // each island is solved by a solver of its own, so m_constraintSolver isn't used
+    _islandSolver->solveIslands(m_islandManager, this, constraints, m_constraints.size(), solverInfo);
+}
+
 int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps,
                                                                btScalar fixedTimeStep, SubStepCallback onSubStep) {
     BT_PROFILE("stepSimulationWithSubstepCallback");
@@ -24,6 +24,9 @@
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <memory>
+
+class ParallelIslandSolver;
 
 using SubStepCallback = std::function<void()>;
 
@@ -36,6 +39,7 @@ public:
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+    ~ThreadSafeDynamicsWorld();
 
     int stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps = 1,
                                           btScalar fixedTimeStep = btScalar(1.)/btScalar(60.),
@@ -53,6 +57,15 @@ public:
 
     void addChangedMotionState(ObjectMotionState* motionState) { _changedMotionStates.push_back(motionState); }
 
+    // solve the constraints of separate simulation islands on several threads
+    void setParallelIslandSolving(bool enabled);
+    bool isParallelIslandSolving() const { return (bool)_islandSolver; }
+    // false when Bullet was built without the thread-safe profiler, then islands are always solved on one thread
+    static bool supportsParallelIslandSolving();
+
+protected:
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
@@ -61,6 +74,8 @@ private:
     VectorOfMotionStates _deactivatedStates;
     SetOfMotionStates _activeStates;
     SetOfMotionStates _lastActiveStates;
+
+    std::unique_ptr<ParallelIslandSolver> _islandSolver;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
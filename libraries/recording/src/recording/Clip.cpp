@@ -8,7 +8,10 @@
 
 #include "Clip.h"
 
+#include <limits>
+
 #include "Frame.h"
+#include "FrameCodec.h"
 #include "Logging.h"
 
 #include "impl/FileClip.h"
@@ -55,7 +58,7 @@ float Clip::position() const {
 }
 
 // FIXME move to frame?
-bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
+bool writeFrame(QIODevice& output, const Frame& frame, const QByteArray& storedData) {
     if (frame.type == Frame::TYPE_INVALID) {
         qWarning() << "Attempting to write invalid frame";
         return true;
@@ -70,19 +73,17 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
     if (written != sizeof(Frame::Time)) {
         return false;
     }
-    QByteArray frameData = frame.data;
-    if (compressed) {
-        frameData = qCompress(frameData);
+    if (storedData.size() > std::numeric_limits<FrameSize>::max()) {
+        qCWarning(recordingLog) << "Frame of" << storedData.size() << "bytes is too large to write";
+        return false;
     }
-
-    uint16_t dataSize = frameData.size();
+    uint16_t dataSize = storedData.size();
     written = output.write((char*)&dataSize, sizeof(FrameSize));
     if (written != sizeof(uint16_t)) {
         return false;
     }
-
     if (dataSize != 0) {
-        written = output.write(frameData);
+        written = output.write(storedData);
         if (written != dataSize) {
             return false;
         }
@@ -92,6 +93,7 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
 
 const QString Clip::FRAME_TYPE_MAP = QStringLiteral("frameTypes");
 const QString Clip::FRAME_COMREPSSION_FLAG = QStringLiteral("compressed");
+const QString Clip::FRAME_ENCODING_VERSION = QStringLiteral("frameEncoding");
 
 bool Clip::write(QIODevice& output) {
     auto frameTypes = Frame::getFrameTypes();
@@ -104,16 +106,19 @@ bool Clip::write(QIODevice& output) {
     rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
     // Always mark new files as compressed
     rootObject.insert(FRAME_COMREPSSION_FLAG, true);
+    rootObject.insert(FRAME_ENCODING_VERSION, FrameCodec::VERSION);
     QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
     // Never compress the header frame
-    if (!writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false)) {
+    Frame headerFrame({ Frame::TYPE_HEADER, 0, headerFrameData });
+    if (!writeFrame(output, headerFrame, headerFrame.data)) {
         return false;
     }
 
     seek(0);
 
+    FrameCodec codec;
     for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
+        if (!writeFrame(output, *frame, codec.encode(*frame))) {
             return false;
         }
     }
@@ -56,6 +56,8 @@ public:
     
     static const QString FRAME_TYPE_MAP;
     static const QString FRAME_COMREPSSION_FLAG;
+    // the FrameCodec version the frames are stored with, clips written before there was one don't have it
+    static const QString FRAME_ENCODING_VERSION;
 
 protected:
     friend class WrapperClip;
@@ -7,13 +7,12 @@
 //
 
 #include "Deck.h"
- 
-#include <QtCore/QThread>
 
 #include <NumericalConstants.h>
 #include <SharedUtil.h>
 
 #include "Clip.h"
+#include "Ensemble.h"
 #include "Frame.h"
 #include "Logging.h"
 #include "impl/OffsetClip.h"
@@ -23,6 +22,10 @@ using namespace recording;
 Deck::Deck(QObject* parent) 
     : QObject(parent) {}
 
+Deck::~Deck() {
+    stopActor();
+}
+
 void Deck::queueClip(ClipPointer clip, float timeOffset) {
     Locker lock(_mutex);
 
@@ -51,31 +54,20 @@ void Deck::play() {
         _pause = false;
         _startEpoch = Frame::epochForFrameTime(_position);
         emit playbackStateChanged();
-        processFrames();
+        startActor();
     }
 }
 
 void Deck::pause() { 
     Locker lock(_mutex);
     if (!_pause) {
+        _position = Frame::frameTimeFromEpoch(_startEpoch);
         _pause = true;
+        stopActor();
         emit playbackStateChanged();
     }
 }
 
-Clip::Pointer Deck::getNextClip() {
-    Clip::Pointer result;
-    auto soonestFramePosition = Frame::INVALID_TIME;
-    for (const auto& clip : _clips) {
-        auto nextFramePosition = clip->positionFrameTime();
-        if (nextFramePosition < soonestFramePosition) {
-            result = clip;
-            soonestFramePosition = nextFramePosition;
-        }
-    }
-    return result;
-}
-
 void Deck::seek(float position) {
     Locker lock(_mutex);
     _position = Frame::secondsToFrameTime(position);
@@ -89,8 +81,9 @@ void Deck::seek(float position) {
     }
 
     if (!_pause) {
-        // FIXME what if the timer is already running?
-        processFrames();
+        // start the actor over from the new position
+        stopActor();
+        startActor();
     }
 }
 
@@ -103,86 +96,75 @@ float Deck::position() const {
     return Frame::frameTimeToSeconds(currentPosition);
 }
 
-static const Frame::Time MIN_FRAME_WAIT_INTERVAL = Frame::secondsToFrameTime(0.001f);
-static const Frame::Time MAX_FRAME_PROCESSING_TIME = Frame::secondsToFrameTime(0.004f);
-
-void Deck::processFrames() {
-    if (qApp->thread() != QThread::currentThread()) {
-        qWarning() << "Processing frames must only happen on the main thread.";
-        return;
-    }
-    Locker lock(_mutex);
-    if (_pause) {
+void Deck::startActor() {
+    auto ensemble = DependencyManager::get<Ensemble>();
+    if (_clips.empty() || !ensemble) {
+        stop();
         return;
     }
 
-    auto startingPosition = Frame::frameTimeFromEpoch(_startEpoch);
-    auto triggerPosition = startingPosition + MIN_FRAME_WAIT_INTERVAL;
-    Clip::Pointer nextClip;
-    // FIXME add code to start dropping frames if we fall behind.
-    // Alternatively, add code to cache frames here and then process only the last frame of a given type
-    // ... the latter will work for Avatar, but not well for audio I suspect.
-    bool overLimit = false;
-    for (nextClip = getNextClip(); nextClip; nextClip = getNextClip()) {
-        auto currentPosition = Frame::frameTimeFromEpoch(_startEpoch);
-        if ((currentPosition - startingPosition) >= MAX_FRAME_PROCESSING_TIME) {
-            qCWarning(recordingLog) << "Exceeded maximum frame processing time, breaking early";
-#ifdef WANT_RECORDING_DEBUG            
-            qCDebug(recordingLog) << "Starting: " << currentPosition;
-            qCDebug(recordingLog) << "Current:  " << startingPosition;
-            qCDebug(recordingLog) << "Trigger:  " << triggerPosition;
-#endif
-            overLimit = true;
-            break;
+    // FIXME disabling multiple clips for now, queueClip() keeps only one
+    auto timeline = ensemble->getTimeline(_clips.front());
+    quint32 generation = _generation;
+    auto handler = [this, generation](const FrameConstPointer& frame, const Transform& basis) {
+        // frames are handled on our own thread, which is woken for the first of a batch
+        std::unique_lock<std::mutex> lock(_dueFramesMutex);
+        bool wasEmpty = _dueFrames.empty();
+        _dueFrames.emplace_back(generation, frame);
+        if (wasEmpty) {
+            QMetaObject::invokeMethod(this, "handleDueFrames", Qt::QueuedConnection);
         }
+    };
+    auto endHandler = [this, generation](bool looped) {
+        QMetaObject::invokeMethod(this, "handleActorEnd", Qt::QueuedConnection,
+            Q_ARG(quint32, generation), Q_ARG(bool, looped));
+    };
+
+    _ensemble = ensemble;
+    _actor = ensemble->addActor(timeline, handler, Transform(), Frame::frameTimeToSeconds(_position), _loop, endHandler);
+}
 
-        // If the clip is too far in the future, just break out of the handling loop
-        Frame::Time framePosition = nextClip->positionFrameTime();
-        if (framePosition > triggerPosition) {
-            break;
+void Deck::stopActor() {
+    ++_generation;
+    if (_actor != Ensemble::INVALID_ACTOR) {
+        if (auto ensemble = _ensemble.toStrongRef()) {
+            ensemble->removeActor(_actor);
         }
-        // Handle the frame and advance the clip
-        Frame::handleFrame(nextClip->nextFrame());
+        _actor = Ensemble::INVALID_ACTOR;
+    }
+}
+
+void Deck::handleDueFrames() {
+    std::vector<std::pair<quint32, FrameConstPointer>> dueFrames;
+    {
+        std::unique_lock<std::mutex> lock(_dueFramesMutex);
+        dueFrames.swap(_dueFrames);
     }
 
-    if (!nextClip) {
-        // No more frames available, so handle the end of playback
-        if (_loop) {
-            // If we have looping enabled, start the playback over
-            seek(0);
-            // FIXME configure the recording scripting interface to reset the avatar basis on a loop 
-            // if doing relative movement
-            emit looped();
-        } else {
-            // otherwise stop playback
-            stop();
+    Locker lock(_mutex);
+    for (const auto& dueFrame : dueFrames) {
+        if (dueFrame.first == _generation) {
+            Frame::handleFrame(dueFrame.second);
         }
+    }
+}
+
+void Deck::handleActorEnd(quint32 generation, bool looped) {
+    Locker lock(_mutex);
+    if (generation != _generation || _pause) {
         return;
-    } 
-
-    // If we have more clip frames available, set the timer for the next one
-    _position = Frame::frameTimeFromEpoch(_startEpoch);
-    int nextInterval = 1;
-    if (!overLimit) {
-        auto nextFrameTime = nextClip->positionFrameTime();
-        nextInterval = (int)Frame::frameTimeToMilliseconds(nextFrameTime - _position);
-        if (nextInterval < 0) {
-            qCWarning(recordingLog) << "Unexpected nextInterval < 0 nextFrameTime:" << nextFrameTime 
-                                    << "_position:" << _position << "-- setting nextInterval to 0";
-            nextInterval = 0;
-        }
+    }
 
-#ifdef WANT_RECORDING_DEBUG
-        qCDebug(recordingLog) << "Now " << _position;
-        qCDebug(recordingLog) << "Next frame time " << nextInterval;
-#endif
+    if (looped) {
+        _startEpoch = Frame::epochForFrameTime(0);
+        // FIXME configure the recording scripting interface to reset the avatar basis on a loop
+        // if doing relative movement
+        emit looped();
+    } else {
+        // the actor has left the ensemble, so stop playback
+        _actor = Ensemble::INVALID_ACTOR;
+        stop();
     }
-#ifdef WANT_RECORDING_DEBUG
-    qCDebug(recordingLog) << "Setting timer for next processing " << nextInterval;
-#endif
-    _timer.singleShot(nextInterval, [this] {
-        processFrames();
-    });
 }
 
 void Deck::removeClip(const ClipConstPointer& clip) {
@@ -235,6 +217,11 @@ float Deck::length() const {
 void Deck::loop(bool enable) { 
     Locker lock(_mutex);
     _loop = enable;
+    if (_actor != Ensemble::INVALID_ACTOR) {
+        if (auto ensemble = _ensemble.toStrongRef()) {
+            ensemble->setActorLooping(_actor, enable);
+        }
+    }
 }
 
 bool Deck::isLooping() const { 
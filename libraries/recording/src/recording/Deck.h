@@ -10,13 +10,15 @@
 #ifndef hifi_Recording_Deck_h
 #define hifi_Recording_Deck_h
 
+#include <atomic>
 #include <utility>
 #include <list>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QObject>
-#include <QtCore/QTimer>
 #include <QtCore/QList>
+#include <QtCore/QWeakPointer>
 
 #include <DependencyManager.h>
 
@@ -33,6 +35,7 @@ public:
     using Pointer = std::shared_ptr<Deck>;
 
     Deck(QObject* parent = nullptr);
+    ~Deck();
 
     // Place a clip on the deck for recording or playback
     void queueClip(ClipPointer clip, float timeOffset = 0.0f);
@@ -65,12 +68,22 @@ private:
     using Mutex = std::recursive_mutex;
     using Locker = std::unique_lock<Mutex>;
 
-    ClipPointer getNextClip();
-    void processFrames();
+    // the clip is played as an actor of the Ensemble, which hands its frames to this thread
+    void startActor();
+    void stopActor();
+    Q_INVOKABLE void handleDueFrames();
+    Q_INVOKABLE void handleActorEnd(quint32 generation, bool looped);
 
     mutable Mutex _mutex;
-    QTimer _timer;
     ClipList _clips;
+    QWeakPointer<Ensemble> _ensemble;
+    quint32 _actor { 0 };
+    // bumped whenever the actor is stopped, so that frames it handed over before are dropped
+    std::atomic<quint32> _generation { 0 };
+
+    std::mutex _dueFramesMutex;
+    std::vector<std::pair<quint32, FrameConstPointer>> _dueFrames;
+
     quint64 _startEpoch { 0 };
     Frame::Time _position { 0 };
     bool _pause { true };
@@ -0,0 +1,232 @@
+//
+//  Ensemble.cpp
+//  libraries/recording/src/recording
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Ensemble.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "Clip.h"
+#include "Logging.h"
+
+using namespace recording;
+
+// how long the scheduler sleeps when no actor has a frame coming up
+static const quint64 IDLE_INTERVAL_USECS = 100 * USECS_PER_MSEC;
+
+Timeline::Pointer Timeline::fromClip(const ClipConstPointer& clip) {
+    auto result = std::make_shared<Timeline>();
+    result->_name = clip->getName();
+
+    // read a copy, so that the position of the clip itself is left alone
+    auto source = clip->duplicate();
+    result->_frames.reserve(source->frameCount());
+    source->seekFrameTime(0);
+    for (auto frame = source->nextFrame(); frame; frame = source->nextFrame()) {
+        result->_length = std::max(result->_length, frame->timeOffset);
+        result->_frames.push_back(frame);
+    }
+    return result;
+}
+
+size_t Timeline::findFrame(Frame::Time time) const {
+    auto itr = std::lower_bound(_frames.begin(), _frames.end(), time,
+        [](const FrameConstPointer& frame, Frame::Time time)->bool {
+            return frame->timeOffset < time;
+        }
+    );
+    return itr - _frames.begin();
+}
+
+Ensemble::Ensemble() {
+    setObjectName("Recording Ensemble");
+}
+
+Ensemble::~Ensemble() {
+    // the GenericThread destructor can no longer reach our terminating()
+    if (isStillRunning() && isThreaded()) {
+        terminate();
+    }
+}
+
+TimelinePointer Ensemble::getTimeline(const ClipConstPointer& clip) {
+    if (!clip) {
+        return TimelinePointer();
+    }
+
+    std::unique_lock<std::mutex> lock(_timelinesMutex);
+    auto& cached = _timelines[clip.get()];
+    auto timeline = cached.timeline.lock();
+    if (timeline && cached.clip.lock() == clip) {
+        return timeline;
+    }
+
+    // drop the entries of the timelines that are no longer played while we're at it
+    for (auto itr = _timelines.begin(); itr != _timelines.end();) {
+        if (itr->first != clip.get() && itr->second.timeline.expired()) {
+            itr = _timelines.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+
+    timeline = Timeline::fromClip(clip);
+    cached.clip = clip;
+    cached.timeline = timeline;
+    return timeline;
+}
+
+Ensemble::ActorID Ensemble::addActor(const TimelinePointer& timeline, Handler handler, const Transform& basis,
+                                     float timeOffset, bool loop, EndHandler endHandler) {
+    if (!timeline || !handler) {
+        qCWarning(recordingLog) << "Actor without a timeline or handler, ignoring";
+        return INVALID_ACTOR;
+    }
+
+    Actor actor;
+    actor.timeline = timeline;
+    actor.handler = handler;
+    actor.endHandler = endHandler;
+    actor.basis = basis;
+    actor.loop = loop;
+    Frame::Time position = Frame::secondsToFrameTime(std::max(timeOffset, 0.0f));
+    if (loop) {
+        position %= timeline->length() + 1;
+    }
+    actor.startEpoch = usecTimestampNow() - (quint64)position * USECS_PER_MSEC;
+    actor.nextFrame = timeline->findFrame(position);
+
+    ActorID result;
+    {
+        Locker lock(_actorsMutex);
+        result = _nextActorID++;
+        _actors[result] = actor;
+        ++_numChanges;
+    }
+    _actorsChanged.notify_all();
+    return result;
+}
+
+void Ensemble::removeActor(ActorID actor) {
+    Locker lock(_actorsMutex);
+    auto itr = _actors.find(actor);
+    if (itr == _actors.end()) {
+        return;
+    }
+    if (_isUpdating) {
+        // called from a handler, update() erases it once it's done with it
+        itr->second.removed = true;
+    } else {
+        _actors.erase(itr);
+    }
+}
+
+void Ensemble::setActorBasis(ActorID actor, const Transform& basis) {
+    Locker lock(_actorsMutex);
+    auto itr = _actors.find(actor);
+    if (itr != _actors.end()) {
+        itr->second.basis = basis;
+    }
+}
+
+void Ensemble::setActorLooping(ActorID actor, bool loop) {
+    Locker lock(_actorsMutex);
+    auto itr = _actors.find(actor);
+    if (itr != _actors.end()) {
+        itr->second.loop = loop;
+    }
+}
+
+bool Ensemble::hasActor(ActorID actor) const {
+    Locker lock(_actorsMutex);
+    auto itr = _actors.find(actor);
+    return itr != _actors.end() && !itr->second.removed;
+}
+
+int Ensemble::getNumActors() const {
+    Locker lock(_actorsMutex);
+    return (int)std::count_if(_actors.begin(), _actors.end(), [](const std::pair<const ActorID, Actor>& entry) {
+        return !entry.second.removed;
+    });
+}
+
+quint64 Ensemble::nextFrameEpoch(const Actor& actor) {
+    const auto& timeline = *actor.timeline;
+    if (actor.nextFrame < timeline.frameCount()) {
+        return actor.startEpoch + (quint64)timeline.getFrame(actor.nextFrame)->timeOffset * USECS_PER_MSEC;
+    }
+    // looping actors start over one millisecond after the last frame
+    return actor.startEpoch + ((quint64)timeline.length() + 1) * USECS_PER_MSEC;
+}
+
+bool Ensemble::updateActor(Actor& actor, quint64 now) {
+    const auto& timeline = *actor.timeline;
+    while (!actor.removed && nextFrameEpoch(actor) <= now) {
+        if (actor.nextFrame >= timeline.frameCount()) {
+            bool looped = actor.loop && timeline.frameCount() > 0;
+            if (actor.endHandler) {
+                actor.endHandler(looped);
+            }
+            if (!looped) {
+                return false;
+            }
+            actor.startEpoch += ((quint64)timeline.length() + 1) * USECS_PER_MSEC;
+            actor.nextFrame = 0;
+            continue;
+        }
+        actor.handler(timeline.getFrame(actor.nextFrame), actor.basis);
+        ++actor.nextFrame;
+        ++_numFramesHandled;
+    }
+    return !actor.removed;
+}
+
+quint64 Ensemble::update(quint64 now) {
+    Locker lock(_actorsMutex);
+    quint64 nextEpoch = now + IDLE_INTERVAL_USECS;
+    _isUpdating = true;
+    for (auto itr = _actors.begin(); itr != _actors.end();) {
+        if (!updateActor(itr->second, now)) {
+            itr = _actors.erase(itr);
+            continue;
+        }
+        nextEpoch = std::min(nextEpoch, nextFrameEpoch(itr->second));
+        ++itr;
+    }
+    _isUpdating = false;
+    return nextEpoch;
+}
+
+bool Ensemble::process() {
+    uint32_t numChanges;
+    {
+        Locker lock(_actorsMutex);
+        numChanges = _numChanges;
+    }
+    quint64 now = usecTimestampNow();
+    quint64 nextEpoch = update(now);
+
+    if (nextEpoch > now) {
+        // sleep until the next frame is due, or until an actor is added
+        Locker lock(_actorsMutex);
+        _actorsChanged.wait_for(lock, std::chrono::microseconds(nextEpoch - now), [&] {
+            return _numChanges != numChanges || !isStillRunning();
+        });
+    }
+    return isStillRunning();
+}
+
+void Ensemble::terminating() {
+    Locker lock(_actorsMutex);
+    _actorsChanged.notify_all();
+}
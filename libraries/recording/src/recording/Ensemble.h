@@ -0,0 +1,138 @@
+//
+//  Ensemble.h
+//  libraries/recording/src/recording
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Ensemble_h
+#define hifi_Recording_Ensemble_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <DependencyManager.h>
+#include <GenericThread.h>
+#include <Transform.h>
+
+#include "Forward.h"
+#include "Frame.h"
+
+namespace recording {
+
+// The frames of a clip, decoded once and then shared read only by every actor that plays the clip.
+class Timeline {
+public:
+    using Pointer = std::shared_ptr<const Timeline>;
+
+    static Pointer fromClip(const ClipConstPointer& clip);
+
+    QString getName() const { return _name; }
+    size_t frameCount() const { return _frames.size(); }
+    const FrameConstPointer& getFrame(size_t index) const { return _frames[index]; }
+
+    // the time of the last frame
+    Frame::Time length() const { return _length; }
+
+    // the index of the first frame at or after time, frameCount() if there is none
+    size_t findFrame(Frame::Time time) const;
+
+private:
+    QString _name;
+    std::vector<FrameConstPointer> _frames;
+    Frame::Time _length { 0 };
+};
+
+using TimelinePointer = Timeline::Pointer;
+
+// Plays many actors from shared timelines on a single scheduler thread.
+//
+// The actors of an Ensemble share the decoded frames of a clip and are all stepped by one thread, which sleeps until
+// the next frame of any actor is due.  Each actor has its own position in its timeline and its own basis, and its
+// frames go to its own handler rather than to the frame handlers registered with Frame.  Handlers are called on the
+// scheduler thread and must not block.  The Deck plays its clip as an actor of the Ensemble that is set as a
+// dependency, and passes the frames on to the frame handlers on its own thread.
+class Ensemble : public GenericThread, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+public:
+    using ActorID = uint32_t;
+    using Handler = std::function<void(const FrameConstPointer& frame, const Transform& basis)>;
+    // called when an actor reaches the end of its timeline, with whether it starts over
+    using EndHandler = std::function<void(bool looped)>;
+
+    static const ActorID INVALID_ACTOR = 0;
+
+    ~Ensemble();
+
+    // the shared timeline of a clip, which is only decoded the first time it is asked for
+    TimelinePointer getTimeline(const ClipConstPointer& clip);
+
+    // starts playing timeline from timeOffset seconds into it, actors on the same timeline are usually staggered
+    ActorID addActor(const TimelinePointer& timeline, Handler handler, const Transform& basis = Transform(),
+                     float timeOffset = 0.0f, bool loop = true, EndHandler endHandler = EndHandler());
+    // may be called from the actor's own handler
+    void removeActor(ActorID actor);
+    void setActorBasis(ActorID actor, const Transform& basis);
+    void setActorLooping(ActorID actor, bool loop);
+    bool hasActor(ActorID actor) const;
+    int getNumActors() const;
+
+    // hands every actor the frames that are due at now, in usecs, and returns when the next frame is due
+    quint64 update(quint64 now);
+
+    virtual bool process() override;
+    virtual void terminating() override;
+
+    uint64_t getNumFramesHandled() const { return _numFramesHandled; }
+
+private:
+    Ensemble();
+
+    struct Actor {
+        TimelinePointer timeline;
+        Handler handler;
+        EndHandler endHandler;
+        Transform basis;
+        quint64 startEpoch { 0 }; // when the actor was at the start of its timeline
+        size_t nextFrame { 0 };
+        bool loop { true };
+        bool removed { false }; // by its own handler
+    };
+
+    using Mutex = std::recursive_mutex;
+    using Locker = std::unique_lock<Mutex>;
+
+    // returns false when the actor has reached the end of a timeline it doesn't loop
+    bool updateActor(Actor& actor, quint64 now);
+    static quint64 nextFrameEpoch(const Actor& actor);
+
+    mutable Mutex _actorsMutex;
+    std::condition_variable_any _actorsChanged;
+    std::map<ActorID, Actor> _actors;
+    ActorID _nextActorID { INVALID_ACTOR + 1 };
+    uint32_t _numChanges { 0 };
+    bool _isUpdating { false };
+
+    // the timelines that are still in use, by clip
+    struct CachedTimeline {
+        std::weak_ptr<const Clip> clip;
+        std::weak_ptr<const Timeline> timeline;
+    };
+    std::mutex _timelinesMutex;
+    std::map<const Clip*, CachedTimeline> _timelines;
+
+    std::atomic<uint64_t> _numFramesHandled { 0 };
+};
+
+}
+
+#endif
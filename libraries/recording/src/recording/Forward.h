@@ -40,6 +40,9 @@ class Deck;
 // An interface for recording a single clip
 class Recorder;
 
+// Plays many actors from clips they share
+class Ensemble;
+
 }
 
 #endif
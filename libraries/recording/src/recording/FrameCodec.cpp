@@ -0,0 +1,71 @@
+//
+//  FrameCodec.cpp
+//  libraries/recording/src/recording
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameCodec.h"
+
+#include <algorithm>
+
+using namespace recording;
+
+QByteArray FrameCodec::applyDelta(const QByteArray& data, const QByteArray& reference) {
+    QByteArray result = data;
+    int size = std::min(data.size(), reference.size());
+    char* resultData = result.data();
+    const char* referenceData = reference.constData();
+    for (int i = 0; i < size; ++i) {
+        resultData[i] ^= referenceData[i];
+    }
+    return result;
+}
+
+QByteArray FrameCodec::encode(const Frame& frame) {
+    TypeState& state = _typeStates[frame.type];
+
+    QByteArray result;
+    result.append((char)KEY_FRAME);
+    result.append(qCompress(frame.data));
+
+    bool canDelta = state.framesSinceKeyFrame > 0 && state.framesSinceKeyFrame < KEY_FRAME_INTERVAL;
+    if (canDelta) {
+        QByteArray delta;
+        delta.append((char)DELTA_FRAME);
+        delta.append(qCompress(applyDelta(frame.data, state.previousData)));
+        if (delta.size() < result.size()) {
+            result = delta;
+        }
+    }
+
+    if ((uint8_t)result[0] == KEY_FRAME) {
+        state.framesSinceKeyFrame = 1;
+    } else {
+        ++state.framesSinceKeyFrame;
+    }
+    state.previousData = frame.data;
+    return result;
+}
+
+int FrameCodec::readEncoding(const char* storedData, int size) {
+    if (size < 1) {
+        return -1;
+    }
+    return (uint8_t)storedData[0];
+}
+
+QByteArray FrameCodec::decode(const QByteArray& storedData, const QByteArray& previousData) {
+    int encoding = readEncoding(storedData.constData(), storedData.size());
+    if (encoding != KEY_FRAME && encoding != DELTA_FRAME) {
+        return QByteArray();
+    }
+    QByteArray data = qUncompress((const uchar*)storedData.constData() + 1, storedData.size() - 1);
+    if (encoding == DELTA_FRAME) {
+        data = applyDelta(data, previousData);
+    }
+    return data;
+}
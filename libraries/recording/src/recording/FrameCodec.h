@@ -0,0 +1,61 @@
+//
+//  FrameCodec.h
+//  libraries/recording/src/recording
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_FrameCodec_h
+#define hifi_Recording_FrameCodec_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+
+#include "Frame.h"
+
+namespace recording {
+
+// How the data of a frame is stored in a clip whose header has a FRAME_ENCODING_VERSION.
+//
+// Each frame is stored as an encoding byte followed by qCompress'ed data.  A key frame holds the data itself, a delta
+// frame holds the data XOR'ed with that of the previous frame of the same type, so that the bytes which did not
+// change (the joints that didn't move, the strings, ...) compress to almost nothing.  Delta frames are only used when
+// they come out smaller, and there is a key frame at least every KEY_FRAME_INTERVAL frames of a type so that seeking
+// never has to decode far back.
+class FrameCodec {
+public:
+    enum Encoding : uint8_t {
+        KEY_FRAME = 0,
+        DELTA_FRAME = 1
+    };
+
+    static const int VERSION = 1;
+    static const int KEY_FRAME_INTERVAL = 60;
+
+    // the data to store for frame, which must be encoded in the order it is stored
+    QByteArray encode(const Frame& frame);
+
+    // the encoding of stored data, or -1 if it has none
+    static int readEncoding(const char* storedData, int size);
+
+    // the data of a frame from its stored data, and for a delta frame the data of the previous frame of its type
+    static QByteArray decode(const QByteArray& storedData, const QByteArray& previousData);
+
+    // XOR over the length of data, bytes beyond the end of reference are left as they are
+    static QByteArray applyDelta(const QByteArray& data, const QByteArray& reference);
+
+private:
+    struct TypeState {
+        QByteArray previousData;
+        int framesSinceKeyFrame { 0 };
+    };
+    QHash<FrameType, TypeState> _typeStates;
+};
+
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include <Finally.h>
 
 #include "../Frame.h"
+#include "../FrameCodec.h"
 #include "../Logging.h"
 #include "BufferClip.h"
 
@@ -80,6 +81,8 @@ void PointerClip::reset() {
     _data = nullptr;
     _size = 0;
     _header = QJsonDocument();
+    _encodingVersion = 0;
+    _lastDecodedFrames.clear();
 }
 
 void PointerClip::init(uchar* data, size_t size) {
@@ -113,6 +116,12 @@ void PointerClip::init(uchar* data, size_t size) {
     // Check for compression
     {
         _compressed = _header.object()[FRAME_COMREPSSION_FLAG].toBool();
+        _encodingVersion = _header.object()[FRAME_ENCODING_VERSION].toInt();
+        if (_encodingVersion > FrameCodec::VERSION) {
+            qWarning() << "Unsupported frame encoding" << _encodingVersion << ", invalid file";
+            reset();
+            return;
+        }
     }
 
     // Find the type enum translation map and fix up the frame headers
@@ -125,12 +134,19 @@ void PointerClip::init(uchar* data, size_t size) {
         }
 
         // Update the loaded headers with the frame data
+        QHash<FrameType, int> lastIndexOfType;
         _frames.reserve(parsedFrameHeaders.size());
         for (auto& frameHeader : parsedFrameHeaders) {
             if (!translationMap.contains(frameHeader.type)) {
                 continue;
             }
             frameHeader.type = translationMap[frameHeader.type];
+            if (_encodingVersion > 0) {
+                const char* storedData = (const char*)_data + frameHeader.fileOffset;
+                frameHeader.encoding = FrameCodec::readEncoding(storedData, frameHeader.size);
+                frameHeader.previousIndex = lastIndexOfType.value(frameHeader.type, -1);
+                lastIndexOfType[frameHeader.type] = (int)_frames.size();
+            }
             _frames.push_back(frameHeader);
         }
     }
@@ -145,7 +161,9 @@ FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
         const auto& header = _frames[frameIndex];
         result->type = header.type;
         result->timeOffset = header.timeOffset;
-        if (header.size) {
+        if (_encodingVersion > 0) {
+            result->data = decodeFrameData(frameIndex);
+        } else if (header.size) {
             result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
             if (_compressed) {
                 result->data = qUncompress(result->data);
@@ -155,6 +173,35 @@ FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
     return result;
 }
 
+QByteArray PointerClip::decodeFrameData(size_t frameIndex) const {
+    const FrameType type = _frames[frameIndex].type;
+    auto lastDecoded = _lastDecodedFrames.find(type);
+
+    // walk back to a key frame, or to the frame we decoded last, then apply the deltas from there
+    std::vector<size_t> chain;
+    QByteArray data;
+    for (int index = (int)frameIndex; index >= 0; index = _frames[index].previousIndex) {
+        if (lastDecoded != _lastDecodedFrames.end() && lastDecoded->index == (size_t)index) {
+            data = lastDecoded->data;
+            break;
+        }
+        chain.push_back((size_t)index);
+        if (_frames[index].encoding != FrameCodec::DELTA_FRAME) {
+            break;
+        }
+    }
+
+    for (auto itr = chain.rbegin(); itr != chain.rend(); ++itr) {
+        const auto& header = _frames[*itr];
+        const char* start = reinterpret_cast<char*>(_data) + header.fileOffset;
+        QByteArray storedData = QByteArray::fromRawData(start, header.size);
+        data = FrameCodec::decode(storedData, data);
+    }
+
+    _lastDecodedFrames[type] = { frameIndex, data };
+    return data;
+}
+
 void PointerClip::addFrame(FrameConstPointer) {
     throw std::runtime_error("Pointer clips are read only, use duplicate to create a read/write clip");
 }
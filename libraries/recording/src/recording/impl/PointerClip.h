@@ -14,6 +14,7 @@
 
 #include <mutex>
 
+#include <QtCore/QHash>
 #include <QtCore/QJsonDocument>
 
 #include "../Frame.h"
@@ -25,6 +26,8 @@ struct PointerFrameHeader : public FrameHeader {
     Frame::Time timeOffset;
     uint16_t size;
     quint64 fileOffset;
+    int encoding { -1 }; // the FrameCodec::Encoding, or -1 for frames stored without one
+    int previousIndex { -1 }; // the previous frame of the same type, that a delta frame applies to
 };
 
 using PointerFrameHeaderList = std::list<PointerFrameHeader>;
@@ -47,10 +50,20 @@ public:
 protected:
     void reset() override;
     virtual FrameConstPointer readFrame(size_t index) const override;
+    QByteArray decodeFrameData(size_t index) const;
+
     QJsonDocument _header;
     uchar* _data { nullptr };
     size_t _size { 0 };
     bool _compressed { true };
+    int _encodingVersion { 0 };
+
+    // the last frame decoded of each type, so that playing a clip in order only ever applies a single delta
+    struct DecodedFrame {
+        size_t index;
+        QByteArray data;
+    };
+    mutable QHash<FrameType, DecodedFrame> _lastDecodedFrames;
 };
 
 }
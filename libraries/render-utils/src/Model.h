@@ -29,7 +29,7 @@
 #include <render/Scene.h>
 #include <Transform.h>
 #include <SpatiallyNestable.h>
-#include <TriangleSet.h>
+#include <TriangleBVH.h>
 
 #include "GeometryCache.h"
 #include "TextureCache.h"
@@ -364,7 +364,8 @@ protected:
 
     bool _triangleSetsValid { false };
     void calculateTriangleSets();
-    QVector<TriangleSet> _modelSpaceMeshTriangleSets; // model space triangles for all sub meshes
+    // model space triangles for all sub meshes, shared with every model using the same geometry
+    std::shared_ptr<const Geometry::MeshTriangleBVHs> _modelSpaceMeshTriangleBVHs;
 
 
     void createRenderItemSet();
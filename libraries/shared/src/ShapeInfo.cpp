@@ -116,6 +116,18 @@ int ShapeInfo::getLargestSubshapePointCount() const {
     return numPoints;
 }
 
+bool ShapeInfo::isBuiltFromPoints() const {
+    switch (_type) {
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return true;
+        default:
+            return false;
+    }
+}
+
 float ShapeInfo::computeVolume() const {
     const float DEFAULT_VOLUME = 1.0f;
     float volume = DEFAULT_VOLUME;
@@ -80,6 +80,9 @@ public:
 
     int getLargestSubshapePointCount() const;
 
+    /// Returns whether the shape is a hull or mesh that is built from the point collection
+    bool isBuiltFromPoints() const;
+
     float computeVolume() const;
 
     /// Returns whether point is inside the shape
@@ -0,0 +1,612 @@
+//
+//  TriangleBVH.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleBVH.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include "GLMHelpers.h"
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define TRIANGLE_BVH_SSE
+#include <xmmintrin.h>
+#endif
+
+static const int LEAF_TRIANGLES = 4;    // a leaf is a single triangle pack
+static const int SAH_BINS = 12;
+
+// below this depth splits fall back to the median, which bounds the depth of the tree (and the traversal stack)
+static const int MAX_SAH_DEPTH = 32;
+static const int MAX_TRAVERSAL_STACK = 256;
+
+namespace {
+
+struct Bounds {
+    glm::vec3 minimum { FLT_MAX };
+    glm::vec3 maximum { -FLT_MAX };
+
+    void grow(const glm::vec3& point) {
+        minimum = glm::min(minimum, point);
+        maximum = glm::max(maximum, point);
+    }
+
+    void grow(const Bounds& other) {
+        minimum = glm::min(minimum, other.minimum);
+        maximum = glm::max(maximum, other.maximum);
+    }
+
+    float area() const {
+        if (minimum.x > maximum.x) {
+            return 0.0f;
+        }
+        glm::vec3 size = maximum - minimum;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+};
+
+struct BuildReference {
+    Bounds bounds;
+    glm::vec3 centroid;
+    int32_t triangle;
+};
+
+struct Ray {
+    Ray(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) : origin(rayOrigin), direction(rayDirection) {
+        // keep the inverse finite, so the slab tests never multiply zero by infinity
+        const float MIN_DIRECTION = 1.0e-20f;
+        for (int i = 0; i < 3; i++) {
+            float component = (fabsf(direction[i]) < MIN_DIRECTION) ? std::copysign(MIN_DIRECTION, direction[i]) : direction[i];
+            inverse[i] = 1.0f / component;
+        }
+#ifdef TRIANGLE_BVH_SSE
+        ox = _mm_set1_ps(origin.x);
+        oy = _mm_set1_ps(origin.y);
+        oz = _mm_set1_ps(origin.z);
+        dx = _mm_set1_ps(direction.x);
+        dy = _mm_set1_ps(direction.y);
+        dz = _mm_set1_ps(direction.z);
+        ix = _mm_set1_ps(inverse.x);
+        iy = _mm_set1_ps(inverse.y);
+        iz = _mm_set1_ps(inverse.z);
+#endif
+    }
+
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 inverse;
+#ifdef TRIANGLE_BVH_SSE
+    __m128 ox, oy, oz;
+    __m128 dx, dy, dz;
+    __m128 ix, iy, iz;
+#endif
+};
+
+}
+
+class TriangleBVHBuilder {
+public:
+    TriangleBVHBuilder(TriangleBVH& bvh, const std::vector<Triangle>& triangles) : _bvh(bvh), _triangles(triangles) {}
+
+    void build();
+
+private:
+    int32_t buildNode(int begin, int end, int depth);
+    int32_t buildLeaf(int begin, int end);
+    int split(int begin, int end, int depth);
+
+    TriangleBVH& _bvh;
+    const std::vector<Triangle>& _triangles;
+    std::vector<BuildReference> _references;
+};
+
+void TriangleBVHBuilder::build() {
+    _bvh._nodes.clear();
+    _bvh._packs.clear();
+    _bvh._numTriangles = _triangles.size();
+    if (_triangles.empty()) {
+        return;
+    }
+
+    Bounds bounds;
+    _references.resize(_triangles.size());
+    for (size_t i = 0; i < _triangles.size(); i++) {
+        const Triangle& triangle = _triangles[i];
+        BuildReference& reference = _references[i];
+        reference.bounds.grow(triangle.v0);
+        reference.bounds.grow(triangle.v1);
+        reference.bounds.grow(triangle.v2);
+        reference.centroid = (triangle.v0 + triangle.v1 + triangle.v2) / 3.0f;
+        reference.triangle = (int32_t)i;
+        bounds.grow(reference.bounds);
+    }
+    _bvh._bounds = AABox(bounds.minimum, bounds.maximum - bounds.minimum);
+
+    // a full tree has about one pack per LEAF_TRIANGLES triangles, and a third as many nodes
+    size_t expectedPacks = (_triangles.size() + LEAF_TRIANGLES - 1) / LEAF_TRIANGLES;
+    _bvh._packs.reserve(expectedPacks * 2);
+    _bvh._nodes.reserve(expectedPacks);
+
+    buildNode(0, (int)_references.size(), 0);
+
+    _references.clear();
+    _references.shrink_to_fit();
+    _bvh._packs.shrink_to_fit();
+    _bvh._nodes.shrink_to_fit();
+}
+
+int32_t TriangleBVHBuilder::buildNode(int begin, int end, int depth) {
+    const int WIDTH = TriangleBVH::WIDTH;
+
+    // split up to three times to fill the children, always splitting the largest range
+    int ranges[WIDTH][2] = { { begin, end } };
+    int numRanges = 1;
+    while (numRanges < WIDTH) {
+        int largest = -1;
+        int largestSize = LEAF_TRIANGLES;
+        for (int i = 0; i < numRanges; i++) {
+            int size = ranges[i][1] - ranges[i][0];
+            if (size > largestSize) {
+                largest = i;
+                largestSize = size;
+            }
+        }
+        if (largest < 0) {
+            break;
+        }
+        int middle = split(ranges[largest][0], ranges[largest][1], depth);
+        ranges[numRanges][0] = middle;
+        ranges[numRanges][1] = ranges[largest][1];
+        ranges[largest][1] = middle;
+        numRanges++;
+    }
+
+    int32_t nodeIndex = (int32_t)_bvh._nodes.size();
+    _bvh._nodes.emplace_back();
+
+    // empty children are a point at infinity, which every ray misses
+    const float INF = std::numeric_limits<float>::infinity();
+    for (int i = 0; i < WIDTH; i++) {
+        TriangleBVH::Node& node = _bvh._nodes[nodeIndex];
+        node.minX[i] = node.minY[i] = node.minZ[i] = INF;
+        node.maxX[i] = node.maxY[i] = node.maxZ[i] = INF;
+        node.children[i] = 0;
+    }
+
+    for (int i = 0; i < numRanges; i++) {
+        Bounds bounds;
+        for (int j = ranges[i][0]; j < ranges[i][1]; j++) {
+            bounds.grow(_references[j].bounds);
+        }
+
+        int32_t child = (ranges[i][1] - ranges[i][0] <= LEAF_TRIANGLES) ?
+            buildLeaf(ranges[i][0], ranges[i][1]) : buildNode(ranges[i][0], ranges[i][1], depth + 1);
+
+        // building children may have grown the node array
+        TriangleBVH::Node& node = _bvh._nodes[nodeIndex];
+        node.minX[i] = bounds.minimum.x;
+        node.minY[i] = bounds.minimum.y;
+        node.minZ[i] = bounds.minimum.z;
+        node.maxX[i] = bounds.maximum.x;
+        node.maxY[i] = bounds.maximum.y;
+        node.maxZ[i] = bounds.maximum.z;
+        node.children[i] = child;
+    }
+
+    return nodeIndex;
+}
+
+int32_t TriangleBVHBuilder::buildLeaf(int begin, int end) {
+    assert(end - begin <= TriangleBVH::WIDTH);
+
+    int32_t packIndex = (int32_t)_bvh._packs.size();
+    _bvh._packs.emplace_back();
+    TriangleBVH::TrianglePack& pack = _bvh._packs.back();
+
+    for (int i = 0; i < TriangleBVH::WIDTH; i++) {
+        int32_t triangleIndex = (begin + i < end) ? _references[begin + i].triangle : -1;
+        // padding is degenerate (zero edges), which never intersects
+        glm::vec3 v0(0.0f), e1(0.0f), e2(0.0f);
+        if (triangleIndex >= 0) {
+            const Triangle& triangle = _triangles[triangleIndex];
+            v0 = triangle.v0;
+            e1 = triangle.v1 - triangle.v0;
+            e2 = triangle.v2 - triangle.v0;
+        }
+        pack.v0x[i] = v0.x;
+        pack.v0y[i] = v0.y;
+        pack.v0z[i] = v0.z;
+        pack.e1x[i] = e1.x;
+        pack.e1y[i] = e1.y;
+        pack.e1z[i] = e1.z;
+        pack.e2x[i] = e2.x;
+        pack.e2y[i] = e2.y;
+        pack.e2z[i] = e2.z;
+        pack.triangles[i] = triangleIndex;
+    }
+
+    return ~packIndex;
+}
+
+int TriangleBVHBuilder::split(int begin, int end, int depth) {
+    Bounds centroidBounds;
+    for (int i = begin; i < end; i++) {
+        centroidBounds.grow(_references[i].centroid);
+    }
+    glm::vec3 extent = centroidBounds.maximum - centroidBounds.minimum;
+
+    int largestAxis = (extent.x > extent.y) ? ((extent.x > extent.z) ? 0 : 2) : ((extent.y > extent.z) ? 1 : 2);
+
+    if (depth < MAX_SAH_DEPTH) {
+        // binned surface area heuristic, over all three axes
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        int bestSplit = 0;
+
+        for (int axis = 0; axis < 3; axis++) {
+            if (extent[axis] <= 0.0f) {
+                continue;
+            }
+            float binScale = SAH_BINS / extent[axis];
+
+            Bounds binBounds[SAH_BINS];
+            int binCounts[SAH_BINS] = { 0 };
+            for (int i = begin; i < end; i++) {
+                int bin = std::min((int)((_references[i].centroid[axis] - centroidBounds.minimum[axis]) * binScale), SAH_BINS - 1);
+                binBounds[bin].grow(_references[i].bounds);
+                binCounts[bin]++;
+            }
+
+            // sweep from the right to find the cost of everything above each split
+            float rightCosts[SAH_BINS];
+            Bounds rightBounds;
+            int rightCount = 0;
+            for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+                rightBounds.grow(binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = rightCount * rightBounds.area();
+            }
+
+            Bounds leftBounds;
+            int leftCount = 0;
+            for (int bin = 1; bin < SAH_BINS; bin++) {
+                leftBounds.grow(binBounds[bin - 1]);
+                leftCount += binCounts[bin - 1];
+                float cost = leftCount * leftBounds.area() + rightCosts[bin];
+                if (leftCount > 0 && leftCount < end - begin && cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = bin;
+                }
+            }
+        }
+
+        if (bestAxis >= 0) {
+            float binScale = SAH_BINS / extent[bestAxis];
+            float axisMinimum = centroidBounds.minimum[bestAxis];
+            auto middle = std::partition(_references.begin() + begin, _references.begin() + end,
+                [&](const BuildReference& reference) {
+                    int bin = std::min((int)((reference.centroid[bestAxis] - axisMinimum) * binScale), SAH_BINS - 1);
+                    return bin < bestSplit;
+                });
+            int middleIndex = (int)(middle - _references.begin());
+            if (middleIndex > begin && middleIndex < end) {
+                return middleIndex;
+            }
+        }
+    }
+
+    // too deep, or all the centroids coincide: split at the median
+    int middle = (begin + end) / 2;
+    std::nth_element(_references.begin() + begin, _references.begin() + middle, _references.begin() + end,
+        [&](const BuildReference& a, const BuildReference& b) {
+            return a.centroid[largestAxis] < b.centroid[largestAxis];
+        });
+    return middle;
+}
+
+TriangleBVH::TriangleBVH(const std::vector<Triangle>& triangles) {
+    TriangleBVHBuilder(*this, triangles).build();
+}
+
+#ifdef TRIANGLE_BVH_SSE
+
+// returns a mask of the children the ray enters closer than maxDistance, and the distance it enters each
+template <typename Node>
+static inline int intersectChildren(const Node& node, const Ray& ray, float maxDistance, float* distances) {
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minX), ray.ox), ray.ix);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxX), ray.ox), ray.ix);
+    __m128 tNear = _mm_min_ps(t0, t1);
+    __m128 tFar = _mm_max_ps(t0, t1);
+
+    t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minY), ray.oy), ray.iy);
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxY), ray.oy), ray.iy);
+    tNear = _mm_max_ps(tNear, _mm_min_ps(t0, t1));
+    tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+
+    t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minZ), ray.oz), ray.iz);
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxZ), ray.oz), ray.iz);
+    tNear = _mm_max_ps(tNear, _mm_min_ps(t0, t1));
+    tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+
+    tNear = _mm_max_ps(tNear, _mm_setzero_ps());
+    tFar = _mm_min_ps(tFar, _mm_set1_ps(maxDistance));
+
+    _mm_storeu_ps(distances, tNear);
+    return _mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+}
+
+// Moller-Trumbore, four triangles at a time. returns the closest hit lane closer than maxDistance, or -1
+template <typename TrianglePack>
+static inline int intersectPack(const TrianglePack& pack, const Ray& ray, float maxDistance, bool allowBackface,
+                                float& distance) {
+    __m128 e1x = _mm_loadu_ps(pack.e1x);
+    __m128 e1y = _mm_loadu_ps(pack.e1y);
+    __m128 e1z = _mm_loadu_ps(pack.e1z);
+    __m128 e2x = _mm_loadu_ps(pack.e2x);
+    __m128 e2y = _mm_loadu_ps(pack.e2y);
+    __m128 e2z = _mm_loadu_ps(pack.e2z);
+
+    // p = direction x e2
+    __m128 px = _mm_sub_ps(_mm_mul_ps(ray.dy, e2z), _mm_mul_ps(ray.dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(ray.dz, e2x), _mm_mul_ps(ray.dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(ray.dx, e2y), _mm_mul_ps(ray.dy, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+    __m128 tx = _mm_sub_ps(ray.ox, _mm_loadu_ps(pack.v0x));
+    __m128 ty = _mm_sub_ps(ray.oy, _mm_loadu_ps(pack.v0y));
+    __m128 tz = _mm_sub_ps(ray.oz, _mm_loadu_ps(pack.v0z));
+    __m128 u = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz));
+
+    // q = (origin - v0) x e1
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ray.dx, qx), _mm_mul_ps(ray.dy, qy)), _mm_mul_ps(ray.dz, qz));
+    __m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz));
+
+    if (allowBackface) {
+        // flip back facing triangles around, so the tests below don't have to divide by det
+        __m128 sign = _mm_and_ps(det, _mm_set1_ps(-0.0f));
+        det = _mm_xor_ps(det, sign);
+        u = _mm_xor_ps(u, sign);
+        v = _mm_xor_ps(v, sign);
+        t = _mm_xor_ps(t, sign);
+    }
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 hit = _mm_cmpgt_ps(det, zero);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), det));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_mul_ps(det, _mm_set1_ps(maxDistance))));
+
+    int mask = _mm_movemask_ps(hit);
+    if (mask == 0) {
+        return -1;
+    }
+
+    float hitT[4], hitDet[4];
+    _mm_storeu_ps(hitT, t);
+    _mm_storeu_ps(hitDet, det);
+
+    int closest = -1;
+    for (int i = 0; i < 4; i++) {
+        if (mask & (1 << i)) {
+            float laneDistance = hitT[i] / hitDet[i];
+            if (laneDistance < maxDistance) {
+                maxDistance = laneDistance;
+                closest = i;
+            }
+        }
+    }
+    if (closest >= 0) {
+        distance = maxDistance;
+    }
+    return closest;
+}
+
+#else
+
+template <typename Node>
+static inline int intersectChildren(const Node& node, const Ray& ray, float maxDistance, float* distances) {
+    int mask = 0;
+    for (int i = 0; i < 4; i++) {
+        float t0 = (node.minX[i] - ray.origin.x) * ray.inverse.x;
+        float t1 = (node.maxX[i] - ray.origin.x) * ray.inverse.x;
+        float tNear = std::min(t0, t1);
+        float tFar = std::max(t0, t1);
+
+        t0 = (node.minY[i] - ray.origin.y) * ray.inverse.y;
+        t1 = (node.maxY[i] - ray.origin.y) * ray.inverse.y;
+        tNear = std::max(tNear, std::min(t0, t1));
+        tFar = std::min(tFar, std::max(t0, t1));
+
+        t0 = (node.minZ[i] - ray.origin.z) * ray.inverse.z;
+        t1 = (node.maxZ[i] - ray.origin.z) * ray.inverse.z;
+        tNear = std::max(tNear, std::min(t0, t1));
+        tFar = std::min(tFar, std::max(t0, t1));
+
+        tNear = std::max(tNear, 0.0f);
+        tFar = std::min(tFar, maxDistance);
+
+        distances[i] = tNear;
+        if (tNear <= tFar) {
+            mask |= (1 << i);
+        }
+    }
+    return mask;
+}
+
+template <typename TrianglePack>
+static inline int intersectPack(const TrianglePack& pack, const Ray& ray, float maxDistance, bool allowBackface,
+                                float& distance) {
+    int closest = -1;
+    for (int i = 0; i < 4; i++) {
+        glm::vec3 e1(pack.e1x[i], pack.e1y[i], pack.e1z[i]);
+        glm::vec3 e2(pack.e2x[i], pack.e2y[i], pack.e2z[i]);
+        glm::vec3 p = glm::cross(ray.direction, e2);
+        float det = glm::dot(e1, p);
+
+        glm::vec3 toOrigin = ray.origin - glm::vec3(pack.v0x[i], pack.v0y[i], pack.v0z[i]);
+        float u = glm::dot(toOrigin, p);
+        glm::vec3 q = glm::cross(toOrigin, e1);
+        float v = glm::dot(ray.direction, q);
+        float t = glm::dot(e2, q);
+
+        if (allowBackface && det < 0.0f) {
+            det = -det;
+            u = -u;
+            v = -v;
+            t = -t;
+        }
+
+        if (det > 0.0f && u >= 0.0f && v >= 0.0f && u + v <= det && t >= 0.0f && t < det * maxDistance) {
+            float laneDistance = t / det;
+            if (laneDistance < maxDistance) {
+                maxDistance = laneDistance;
+                closest = i;
+            }
+        }
+    }
+    if (closest >= 0) {
+        distance = maxDistance;
+    }
+    return closest;
+}
+
+#endif
+
+bool TriangleBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+                                      BoxFace& face, glm::vec3& surfaceNormal, bool precision, bool allowBackface) const {
+    int trianglesTouched = 0;
+    return findRayIntersection(origin, direction, distance, face, surfaceNormal, precision, allowBackface, trianglesTouched);
+}
+
+bool TriangleBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+                                      BoxFace& face, glm::vec3& surfaceNormal, bool precision, bool allowBackface,
+                                      int& trianglesTouched) const {
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    float boundsDistance;
+    BoxFace boundsFace;
+    glm::vec3 boundsNormal;
+    if (!_bounds.findRayIntersection(origin, direction, boundsDistance, boundsFace, boundsNormal)) {
+        return false;
+    }
+
+    if (!precision) {
+        distance = boundsDistance;
+        face = boundsFace;
+        surfaceNormal = boundsNormal;
+        return true;
+    }
+
+    Ray ray(origin, direction);
+
+    float bestDistance = FLT_MAX;
+    int32_t bestPack = -1;
+    int bestLane = -1;
+
+    int32_t stack[MAX_TRAVERSAL_STACK];
+    float stackDistances[MAX_TRAVERSAL_STACK];
+    int stackSize = 1;
+    stack[0] = 0;
+    stackDistances[0] = 0.0f;
+
+    while (stackSize > 0) {
+        --stackSize;
+        if (stackDistances[stackSize] >= bestDistance) {
+            // a closer triangle was found since this was pushed
+            continue;
+        }
+
+        int32_t index = stack[stackSize];
+        if (index < 0) {
+            int32_t packIndex = ~index;
+            trianglesTouched += WIDTH;
+            int lane = intersectPack(_packs[packIndex], ray, bestDistance, allowBackface, bestDistance);
+            if (lane >= 0) {
+                bestPack = packIndex;
+                bestLane = lane;
+            }
+            continue;
+        }
+
+        const Node& node = _nodes[index];
+        float childDistances[WIDTH];
+        int mask = intersectChildren(node, ray, bestDistance, childDistances);
+
+        // push the children that were hit farthest first, so the nearest is visited next
+        int order[WIDTH];
+        int numHits = 0;
+        for (int i = 0; i < WIDTH; i++) {
+            if (mask & (1 << i)) {
+                int j = numHits++;
+                while (j > 0 && childDistances[order[j - 1]] < childDistances[i]) {
+                    order[j] = order[j - 1];
+                    --j;
+                }
+                order[j] = i;
+            }
+        }
+
+        assert(stackSize + numHits <= MAX_TRAVERSAL_STACK);
+        for (int i = 0; i < numHits; i++) {
+            stack[stackSize] = node.children[order[i]];
+            stackDistances[stackSize] = childDistances[order[i]];
+            ++stackSize;
+        }
+    }
+
+    if (bestPack < 0) {
+        return false;
+    }
+
+    const TrianglePack& pack = _packs[bestPack];
+    glm::vec3 e1(pack.e1x[bestLane], pack.e1y[bestLane], pack.e1z[bestLane]);
+    glm::vec3 e2(pack.e2x[bestLane], pack.e2y[bestLane], pack.e2z[bestLane]);
+
+    distance = bestDistance;
+    face = boundsFace;
+    surfaceNormal = glm::normalize(glm::cross(e1, e2));
+    return true;
+}
+
+bool TriangleBVH::convexHullContains(const glm::vec3& point) const {
+    if (_nodes.empty() || !_bounds.contains(point)) {
+        return false;
+    }
+
+    for (const auto& pack : _packs) {
+        for (int i = 0; i < WIDTH; i++) {
+            if (pack.triangles[i] < 0) {
+                continue;
+            }
+            glm::vec3 v0(pack.v0x[i], pack.v0y[i], pack.v0z[i]);
+            glm::vec3 v1 = v0 + glm::vec3(pack.e1x[i], pack.e1y[i], pack.e1z[i]);
+            glm::vec3 v2 = v0 + glm::vec3(pack.e2x[i], pack.e2y[i], pack.e2z[i]);
+            if (!isPointBehindTrianglesPlane(point, v0, v1, v2)) {
+                // it's not behind at least one so we bail
+                return false;
+            }
+        }
+    }
+    return true;
+}
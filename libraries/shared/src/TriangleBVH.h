@@ -0,0 +1,76 @@
+//
+//  TriangleBVH.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TriangleBVH_h
+#define hifi_TriangleBVH_h
+
+#include <stdint.h>
+#include <vector>
+
+#include "AABox.h"
+#include "GeometryUtil.h"
+
+// A bounding volume hierarchy over a fixed set of triangles, for precision ray picking.
+//
+// The tree is built once with binned SAH splits and flattened into arrays of 4-wide nodes, with the triangles of
+// each leaf packed 4 at a time, so a ray is tested against four child boxes or four triangles at once (with SSE
+// on x86). It is immutable after construction and safe to query from multiple threads.
+class TriangleBVH {
+public:
+    TriangleBVH() {}
+    TriangleBVH(const std::vector<Triangle>& triangles);
+
+    // Determine if the given ray (origin/direction) intersects with any triangles in the set. If an intersection
+    // occurs, the distance and surface normal will be provided. If precision is false only the bounds are tested.
+    // allowBackface also accepts triangles facing away from the ray.
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance, BoxFace& face,
+                             glm::vec3& surfaceNormal, bool precision, bool allowBackface = false) const;
+
+    // as above, also counting the triangles tested
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance, BoxFace& face,
+                             glm::vec3& surfaceNormal, bool precision, bool allowBackface, int& trianglesTouched) const;
+
+    // Determine if a point is "inside" all the triangles of a convex hull. It is the responsibility of the caller to
+    // determine that the triangle set is indeed a convex hull.
+    bool convexHullContains(const glm::vec3& point) const;
+
+    const AABox& getBounds() const { return _bounds; }
+    size_t size() const { return _numTriangles; }
+    size_t getNumNodes() const { return _nodes.size(); }
+
+private:
+    static const int WIDTH = 4;
+
+    // children are tested together, so their bounds are stored per axis
+    struct Node {
+        float minX[WIDTH], minY[WIDTH], minZ[WIDTH];
+        float maxX[WIDTH], maxY[WIDTH], maxZ[WIDTH];
+        // >= 0 is the index of a child node, < 0 is ~index of a leaf's triangle pack
+        int32_t children[WIDTH];
+    };
+
+    // triangles are stored as a vertex and two edges, ready for the ray test
+    struct TrianglePack {
+        float v0x[WIDTH], v0y[WIDTH], v0z[WIDTH];
+        float e1x[WIDTH], e1y[WIDTH], e1z[WIDTH];
+        float e2x[WIDTH], e2y[WIDTH], e2z[WIDTH];
+        // index into the triangles the tree was built from, -1 for padding
+        int32_t triangles[WIDTH];
+    };
+
+    friend class TriangleBVHBuilder;
+
+    std::vector<Node> _nodes;
+    std::vector<TrianglePack> _packs;
+    AABox _bounds;
+    size_t _numTriangles { 0 };
+};
+
+#endif // hifi_TriangleBVH_h
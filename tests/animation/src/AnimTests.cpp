@@ -8,6 +8,9 @@
 //
 
 #include "AnimTests.h"
+
+#include <glm/gtx/transform.hpp>
+
 #include <AnimNodeLoader.h>
 #include <AnimClip.h>
 #include <AnimBlendLinear.h>
@@ -15,6 +18,11 @@
 #include <AnimVariant.h>
 #include <AnimExpression.h>
 #include <AnimUtil.h>
+#include <AnimContext.h>
+#include <AnimSkeleton.h>
+#include <NumericalConstants.h>
+#include <Rig.h>
+#include <TBBHelpers.h>
 
 #include <../QTestExtensions.h>
 
@@ -422,6 +430,272 @@ void AnimTests::testAnimPose() {
     }
 }
 
+void AnimTests::testAnimPoseProduct() {
+    std::vector<glm::vec3> scaleVec = {
+        glm::vec3(1.0f),
+        glm::vec3(0.01f),
+        glm::vec3(2.5f),
+        glm::vec3(2.0f, 0.5f, 1.5f)
+    };
+    std::vector<glm::quat> rotVec = {
+        glm::quat(),
+        glm::angleAxis(PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f)),
+        glm::angleAxis(PI, glm::vec3(0.0f, 1.0f, 0.0f)),
+        glm::angleAxis(0.3f, glm::normalize(glm::vec3(1.0f, 2.0f, -3.0f)))
+    };
+    std::vector<glm::vec3> transVec = {
+        glm::vec3(),
+        glm::vec3(10.0f, -5.0f, 7.5f)
+    };
+
+    std::vector<AnimPose> poses;
+    for (auto& scale : scaleVec) {
+        for (auto& rot : rotVec) {
+            for (auto& trans : transVec) {
+                poses.push_back(AnimPose(scale, rot, trans));
+            }
+        }
+    }
+
+    // uniform scales take a shortcut around the matrices, which must give the same result
+    const float EPSILON = 0.001f;
+    for (auto& lhs : poses) {
+        glm::mat4 lhsMat = lhs;
+        for (auto& rhs : poses) {
+            glm::mat4 rawMat = lhsMat * (glm::mat4)rhs;
+            AnimPose product = lhs * rhs;
+            QCOMPARE_WITH_ABS_ERROR(rawMat, (glm::mat4)product, EPSILON);
+        }
+        glm::mat4 inverseMat = lhs.inverse();
+        QCOMPARE_WITH_ABS_ERROR(glm::inverse(lhsMat), inverseMat, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR((glm::mat4)(lhs * lhs.inverse()), glm::mat4(), EPSILON);
+    }
+}
+
+void AnimTests::testBlend() {
+    // enough poses for a couple of groups of four and a tail, with some rotations in opposite hemispheres
+    const int NUM_POSES = 11;
+    std::vector<AnimPose> a, b;
+    for (int i = 0; i < NUM_POSES; i++) {
+        float t = (float)i;
+        glm::quat rotA = glm::angleAxis(0.4f * t, glm::normalize(glm::vec3(1.0f, t, 2.0f)));
+        glm::quat rotB = glm::angleAxis(-0.3f * t, glm::normalize(glm::vec3(t, -1.0f, 0.5f)));
+        if (i % 3 == 1) {
+            rotB = -rotB;
+        }
+        a.push_back(AnimPose(glm::vec3(1.0f + 0.1f * t), rotA, glm::vec3(t, -t, 2.0f * t)));
+        b.push_back(AnimPose(glm::vec3(2.0f - 0.1f * t), rotB, glm::vec3(-t, 1.0f, 0.5f * t)));
+    }
+    b[5].rot() = -a[5].rot();
+
+    const float EPSILON = 0.0001f;
+    for (float alpha : { 0.0f, 0.25f, 0.5f, 1.0f }) {
+        std::vector<AnimPose> result(NUM_POSES);
+        ::blend(NUM_POSES, &a[0], &b[0], alpha, &result[0]);
+
+        for (int i = 0; i < NUM_POSES; i++) {
+            glm::quat rotB = b[i].rot();
+            if (glm::dot(a[i].rot(), rotB) < 0.0f) {
+                rotB = -rotB;
+            }
+            glm::quat rot = glm::normalize(glm::lerp(a[i].rot(), rotB, alpha));
+            QCOMPARE_WITH_ABS_ERROR(result[i].scale(), glm::mix(a[i].scale(), b[i].scale(), alpha), EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(result[i].trans(), glm::mix(a[i].trans(), b[i].trans(), alpha), EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(result[i].rot(), rot, EPSILON);
+        }
+
+        // the anim nodes blend into one of their inputs
+        std::vector<AnimPose> inPlace = a;
+        ::blend(NUM_POSES, &inPlace[0], &b[0], alpha, &inPlace[0]);
+        for (int i = 0; i < NUM_POSES; i++) {
+            QCOMPARE_WITH_ABS_ERROR(inPlace[i].trans(), result[i].trans(), EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(inPlace[i].rot(), result[i].rot(), EPSILON);
+        }
+    }
+}
+
+void AnimTests::testPoseArena() {
+    AnimPoseArena arena;
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4());
+    context.setPoseArena(&arena);
+
+    AnimPoseVec& first = context.allocatePoses(10);
+    AnimPoseVec& second = context.allocatePoses(20);
+    QCOMPARE((int)first.size(), 10);
+    QCOMPARE((int)second.size(), 20);
+    QVERIFY(&first != &second);
+    first[0] = AnimPose(glm::vec3(2.0f), glm::quat(), glm::vec3(1.0f));
+
+    // allocating more doesn't move the poses already handed out
+    const AnimPose* firstData = &first[0];
+    for (int i = 0; i < 100; i++) {
+        context.allocatePoses(5);
+    }
+    QVERIFY(&first[0] == firstData);
+    QCOMPARE(first[0].trans(), glm::vec3(1.0f));
+
+    // and the next evaluation gets the same vectors back
+    arena.reset();
+    QCOMPARE(&context.allocatePoses(10), &first);
+    QCOMPARE((int)arena.getNumVectors(), 102);
+}
+
+// a chain of joints, each translated along y from its parent
+static FBXGeometry makeChainGeometry(int numJoints) {
+    FBXGeometry geometry;
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.isSkeletonJoint = true;
+    for (int i = 0; i < numJoints; i++) {
+        joint.name = QString("joint%1").arg(i);
+        joint.parentIndex = i - 1;
+        joint.translation = (i == 0) ? glm::vec3(0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        joint.transform = glm::translate(glm::vec3(0.0f, (float)i, 0.0f));
+        joint.bindTransform = joint.transform;
+        geometry.joints.push_back(joint);
+    }
+    return geometry;
+}
+
+void AnimTests::testJointDataBlending() {
+    // root, hand, finger
+    FBXGeometry geometry = makeChainGeometry(3);
+    geometry.leftHandJointIndex = 1;
+    Rig rig;
+    rig.initJointStates(geometry, glm::mat4());
+
+    const glm::quat ROT = glm::angleAxis(1.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+    const glm::quat FINGER_ROT = glm::angleAxis(0.5f, glm::vec3(1.0f, 0.0f, 0.0f));
+    QVector<JointData> jointData(3);
+    for (auto& data : jointData) {
+        data.rotationSet = true;
+    }
+    jointData[1].rotation = ROT;
+    jointData[2].rotation = ROT * FINGER_ROT;
+
+    // blended from the default poses to the new ones over the duration
+    const float EPSILON = 0.0001f;
+    rig.copyJointsFromJointData(jointData, false, 0.1f);
+    QVERIFY(rig.isBlendingJoints());
+    rig.blendJoints(0.05f);
+    glm::quat rotation;
+    QVERIFY(rig.getJointRotation(1, rotation));
+    QCOMPARE_WITH_ABS_ERROR(rotation, glm::normalize(glm::lerp(glm::quat(), ROT, 0.5f)), EPSILON);
+    rig.blendJoints(0.05f);
+    QVERIFY(!rig.isBlendingJoints());
+    QVERIFY(rig.getJointRotation(1, rotation));
+    QCOMPARE_WITH_ABS_ERROR(rotation, ROT, EPSILON);
+    QVERIFY(rig.getJointRotation(2, rotation));
+    QCOMPARE_WITH_ABS_ERROR(rotation, FINGER_ROT, EPSILON);
+
+    // the reduced joint set leaves the finger where it was
+    jointData[1].rotation = glm::quat();
+    jointData[2].rotation = glm::quat();
+    rig.copyJointsFromJointData(jointData, true);
+    QVERIFY(!rig.isBlendingJoints());
+    QVERIFY(rig.getJointRotation(1, rotation));
+    QCOMPARE_WITH_ABS_ERROR(rotation, glm::quat(), EPSILON);
+    QVERIFY(rig.getJointRotation(2, rotation));
+    QCOMPARE_WITH_ABS_ERROR(rotation, FINGER_ROT, EPSILON);
+}
+
+// a skeleton about the size of an avatar's, with a few joints on each parent
+static AnimSkeleton::Pointer makeBenchmarkSkeleton(int numJoints) {
+    std::vector<FBXJoint> joints;
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.isSkeletonJoint = true;
+    for (int i = 0; i < numJoints; i++) {
+        joint.name = QString("joint%1").arg(i);
+        joint.parentIndex = (i == 0) ? -1 : (i - 1) / 3;
+        joint.translation = glm::vec3(0.1f * (i % 3), 0.2f, 0.0f);
+        joint.rotation = glm::angleAxis(0.1f * i, glm::vec3(0.0f, 1.0f, 0.0f));
+        joint.transform = glm::translate(joint.translation) * glm::mat4_cast(joint.rotation);
+        if (joint.parentIndex != -1) {
+            joint.transform = joints[joint.parentIndex].transform * joint.transform;
+        }
+        joint.bindTransform = joint.transform;
+        joint.inverseBindRotation = glm::inverse(glm::quat_cast(joint.transform));
+        joint.inverseDefaultRotation = glm::inverse(joint.rotation);
+        joints.push_back(joint);
+    }
+    return std::make_shared<AnimSkeleton>(joints);
+}
+
+static AnimPoseVec makeBenchmarkPoses(int numJoints, float phase) {
+    AnimPoseVec poses;
+    for (int i = 0; i < numJoints; i++) {
+        glm::quat rot = glm::angleAxis(phase + 0.05f * i, glm::normalize(glm::vec3(1.0f, 0.5f * i, 0.25f)));
+        poses.push_back(AnimPose(glm::vec3(1.0f), rot, glm::vec3(0.0f, 0.1f * i, phase)));
+    }
+    return poses;
+}
+
+void AnimTests::benchmarkBlend() {
+    const int NUM_AVATARS = 100;
+    const int NUM_JOINTS = 80;
+    const int NUM_FRAMES = 100;
+    AnimPoseVec a = makeBenchmarkPoses(NUM_JOINTS, 0.0f);
+    AnimPoseVec b = makeBenchmarkPoses(NUM_JOINTS, 1.0f);
+    std::vector<AnimPoseVec> results(NUM_AVATARS, AnimPoseVec(NUM_JOINTS));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        float alpha = (float)frame / NUM_FRAMES;
+        for (auto& result : results) {
+            ::blend(NUM_JOINTS, &a[0], &b[0], alpha, &result[0]);
+        }
+    }
+    qDebug() << NUM_AVATARS << "avatars of" << NUM_JOINTS << "joints:"
+        << (float)timer.nsecsElapsed() / (NUM_FRAMES * 1000) << "usecs per blend of every avatar";
+}
+
+void AnimTests::benchmarkAbsolutePoses() {
+    const int NUM_AVATARS = 100;
+    const int NUM_JOINTS = 80;
+    const int NUM_FRAMES = 100;
+    AnimSkeleton::Pointer skeleton = makeBenchmarkSkeleton(NUM_JOINTS);
+    QCOMPARE(skeleton->getNumJoints(), NUM_JOINTS);
+    AnimPoseVec relativePoses = makeBenchmarkPoses(NUM_JOINTS, 0.5f);
+    std::vector<AnimPoseVec> absolutePoses(NUM_AVATARS);
+
+    for (bool parallel : { false, true }) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            auto convert = [&](size_t i) {
+                absolutePoses[i] = relativePoses;
+                skeleton->convertRelativePosesToAbsolute(absolutePoses[i]);
+            };
+            if (parallel) {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, absolutePoses.size(), 1),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            convert(i);
+                        }
+                    });
+            } else {
+                for (size_t i = 0; i < absolutePoses.size(); i++) {
+                    convert(i);
+                }
+            }
+        }
+        qDebug() << (parallel ? "parallel" : "serial") << NUM_AVATARS << "avatars of" << NUM_JOINTS << "joints:"
+            << (float)timer.nsecsElapsed() / (NUM_FRAMES * 1000) << "usecs to make the absolute poses of every avatar";
+    }
+
+    // the product of the uniformly scaled poses matches the matrices
+    glm::mat4 expected = (glm::mat4)relativePoses[0] * (glm::mat4)relativePoses[1] * (glm::mat4)relativePoses[4];
+    QCOMPARE_WITH_ABS_ERROR((glm::mat4)absolutePoses[0][4], expected, 0.001f);
+}
+
 void AnimTests::testExpressionTokenizer() {
     QString str = "(10 +  x) >= 20.1 && (y != !z)";
     AnimExpression e("x");
@@ -27,6 +27,12 @@ private slots:
     void testVariant();
     void testAccumulateTime();
     void testAnimPose();
+    void testAnimPoseProduct();
+    void testBlend();
+    void testPoseArena();
+    void testJointDataBlending();
+    void benchmarkBlend();
+    void benchmarkAbsolutePoses();
     void testExpressionTokenizer();
     void testExpressionParser();
     void testExpressionEvaluator();
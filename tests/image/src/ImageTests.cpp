@@ -0,0 +1,288 @@
+//
+//  ImageTests.cpp
+//  tests/image/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageTests.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <QtTest/QtTest>
+
+#include <gpu/Texture.h>
+#include <image/BlockCompressor.h>
+#include <image/Image.h>
+#include <image/MipGenerator.h>
+
+QTEST_GUILESS_MAIN(ImageTests)
+
+// a folder of textures to benchmark, 4K ones of the kind content uses
+static const char* CORPUS_ENVIRONMENT_VARIABLE = "HIFI_TEXTURE_CORPUS";
+static const int SYNTHETIC_CORPUS_SIZE = 4096;
+
+static const int MAX_COLOR_ERROR = 16;
+static const int MAX_CHANNEL_ERROR = 2;
+
+static QImage makeTestImage(int width, int height, bool hasAlpha) {
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        auto row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            int red = x * 255 / std::max(width - 1, 1);
+            int green = y * 255 / std::max(height - 1, 1);
+            int blue = (red + green) / 2;
+            int alpha = hasAlpha ? (255 - blue) : 255;
+            row[x] = qRgba(red, green, blue, alpha);
+        }
+    }
+    return image;
+}
+
+// a smooth image with noise on top, so that it neither compresses trivially nor is all detail
+static QImage makeNoisyImage(int size) {
+    QImage image = makeTestImage(size, size, false);
+    qsrand(size);
+    for (int y = 0; y < size; ++y) {
+        auto row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < size; ++x) {
+            int noise = qrand() % 32 - 16;
+            row[x] = qRgb(qBound(0, qRed(row[x]) + noise, 255), qBound(0, qGreen(row[x]) - noise, 255), qBlue(row[x]));
+        }
+    }
+    return image;
+}
+
+static QRgb expandRGB565(uint16_t packed) {
+    int red = (packed >> 11) & 31;
+    int green = (packed >> 5) & 63;
+    int blue = packed & 31;
+    return qRgb((red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2));
+}
+
+static void decodeColorBlock(const uint8_t* block, QRgb* texels) {
+    uint16_t color0 = block[0] | (block[1] << 8);
+    uint16_t color1 = block[2] | (block[3] << 8);
+    uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+
+    QRgb palette[4] = { expandRGB565(color0), expandRGB565(color1) };
+    auto mix = [&](int weight0, int weight1, int total) {
+        return qRgb((qRed(palette[0]) * weight0 + qRed(palette[1]) * weight1) / total,
+                    (qGreen(palette[0]) * weight0 + qGreen(palette[1]) * weight1) / total,
+                    (qBlue(palette[0]) * weight0 + qBlue(palette[1]) * weight1) / total);
+    };
+    if (color0 > color1) {
+        palette[2] = mix(2, 1, 3);
+        palette[3] = mix(1, 2, 3);
+    } else {
+        palette[2] = mix(1, 1, 2);
+        palette[3] = qRgba(0, 0, 0, 0);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        texels[i] = palette[(indices >> (2 * i)) & 3];
+    }
+}
+
+static void decodeChannelBlock(const uint8_t* block, uint8_t* values) {
+    int palette[8] = { block[0], block[1] };
+    if (palette[0] > palette[1]) {
+        for (int i = 1; i < 7; ++i) {
+            palette[i + 1] = ((7 - i) * palette[0] + i * palette[1]) / 7;
+        }
+    } else {
+        for (int i = 1; i < 5; ++i) {
+            palette[i + 1] = ((5 - i) * palette[0] + i * palette[1]) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) {
+        indices |= (uint64_t)block[2 + i] << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        values[i] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+// the largest difference of a channel between the image and its compressed blocks, the blocks are decoded by decode
+template <typename Decode>
+static int evalMaxBlockError(const QImage& image, const std::vector<uint8_t>& blocks, size_t blockSize, Decode decode) {
+    int maxError = 0;
+    int blocksWide = (image.width() + 3) / 4;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const uint8_t* block = &blocks[((y / 4) * blocksWide + x / 4) * blockSize];
+            maxError = std::max(maxError, decode(block, (y % 4) * 4 + x % 4, image.pixel(x, y)));
+        }
+    }
+    return maxError;
+}
+
+void ImageTests::initTestCase() {
+    auto corpusPath = qgetenv(CORPUS_ENVIRONMENT_VARIABLE);
+    if (!corpusPath.isEmpty()) {
+        auto fileInfoList = QDir(QString::fromLocal8Bit(corpusPath)).entryInfoList({ "*.png", "*.jpg", "*.tga" }, QDir::Files);
+        for (const auto& fileInfo : fileInfoList) {
+            QImage image(fileInfo.filePath());
+            if (!image.isNull()) {
+                _corpus.push_back(image);
+            }
+        }
+    }
+
+    if (_corpus.empty()) {
+        _corpus.push_back(makeNoisyImage(SYNTHETIC_CORPUS_SIZE));
+    }
+}
+
+void ImageTests::testMipChain() {
+    auto mips = image::generateMipChain(makeTestImage(37, 20, false));
+    QCOMPARE((int)mips.size(), 6);
+    QCOMPARE(mips[1].size(), QSize(18, 10));
+    QCOMPARE(mips[2].size(), QSize(9, 5));
+    QCOMPARE(mips[3].size(), QSize(4, 2));
+    QCOMPARE(mips[4].size(), QSize(2, 1));
+    QCOMPARE(mips[5].size(), QSize(1, 1));
+
+    QCOMPARE((int)image::generateMipChain(makeTestImage(37, 20, false), image::MipOptions(), 3).size(), 3);
+}
+
+void ImageTests::testGammaCorrectMips() {
+    QImage checker(2, 2, QImage::Format_ARGB32);
+    checker.setPixel(0, 0, qRgb(0, 0, 0));
+    checker.setPixel(1, 0, qRgb(255, 255, 255));
+    checker.setPixel(0, 1, qRgb(255, 255, 255));
+    checker.setPixel(1, 1, qRgb(0, 0, 0));
+
+    // half of the light is 188 in sRGB, not 128
+    QImage mip = image::generateMip(checker);
+    QCOMPARE(mip.size(), QSize(1, 1));
+    QVERIFY(std::abs(qRed(mip.pixel(0, 0)) - 188) <= 1);
+    QCOMPARE(qAlpha(mip.pixel(0, 0)), 255);
+
+    image::MipOptions linear;
+    linear.isSRGB = false;
+    mip = image::generateMip(checker, linear);
+    QVERIFY(std::abs(qRed(mip.pixel(0, 0)) - 128) <= 1);
+}
+
+void ImageTests::testKaiserMips() {
+    image::MipOptions options;
+    options.filter = image::MipFilter::Kaiser;
+
+    QImage uniform(32, 32, QImage::Format_ARGB32);
+    uniform.fill(qRgba(100, 150, 200, 255));
+    for (const auto& mip : image::generateMipChain(uniform, options)) {
+        for (int y = 0; y < mip.height(); ++y) {
+            for (int x = 0; x < mip.width(); ++x) {
+                QRgb texel = mip.pixel(x, y);
+                QVERIFY(std::abs(qRed(texel) - 100) <= 1);
+                QVERIFY(std::abs(qGreen(texel) - 150) <= 1);
+                QVERIFY(std::abs(qBlue(texel) - 200) <= 1);
+                QCOMPARE(qAlpha(texel), 255);
+            }
+        }
+    }
+}
+
+void ImageTests::testBlockCompression() {
+    QImage image = makeTestImage(64, 64, true);
+
+    QCOMPARE(image::evalBlockCompressedSize(64, 64, image::BlockFormat::BC1), (size_t)(16 * 16 * 8));
+    QCOMPARE(image::evalBlockCompressedSize(6, 5, image::BlockFormat::BC4), (size_t)(2 * 2 * 8));
+    QCOMPARE(image::evalBlockCompressedSize(6, 5, image::BlockFormat::BC5), (size_t)(2 * 2 * 16));
+
+    std::vector<uint8_t> blocks(image::evalBlockCompressedSize(64, 64, image::BlockFormat::BC3));
+    image::compressBlocks(image, image::BlockFormat::BC3, blocks.data());
+    int maxError = evalMaxBlockError(image, blocks, 16, [](const uint8_t* block, int texel, QRgb expected) {
+        QRgb colors[16];
+        decodeColorBlock(block + 8, colors);
+        QRgb actual = colors[texel];
+        return std::max({ std::abs(qRed(actual) - qRed(expected)), std::abs(qGreen(actual) - qGreen(expected)),
+                          std::abs(qBlue(actual) - qBlue(expected)) });
+    });
+    QVERIFY(maxError <= MAX_COLOR_ERROR);
+
+    maxError = evalMaxBlockError(image, blocks, 16, [](const uint8_t* block, int texel, QRgb expected) {
+        uint8_t alphas[16];
+        decodeChannelBlock(block, alphas);
+        return std::abs(alphas[texel] - qAlpha(expected));
+    });
+    QVERIFY(maxError <= MAX_CHANNEL_ERROR);
+
+    blocks.assign(image::evalBlockCompressedSize(64, 64, image::BlockFormat::BC5), 0);
+    image::compressBlocks(image, image::BlockFormat::BC5, blocks.data());
+    maxError = evalMaxBlockError(image, blocks, 16, [](const uint8_t* block, int texel, QRgb expected) {
+        uint8_t reds[16];
+        uint8_t greens[16];
+        decodeChannelBlock(block, reds);
+        decodeChannelBlock(block + 8, greens);
+        return std::max(std::abs(reds[texel] - qRed(expected)), std::abs(greens[texel] - qGreen(expected)));
+    });
+    QVERIFY(maxError <= MAX_CHANNEL_ERROR);
+
+    // a color that 565 holds exactly comes back exactly, also in the partial blocks at the edges
+    QImage solid(6, 5, QImage::Format_ARGB32);
+    solid.fill(qRgb(255, 0, 255));
+    blocks.assign(image::evalBlockCompressedSize(6, 5, image::BlockFormat::BC1), 0);
+    image::compressBlocks(solid, image::BlockFormat::BC1, blocks.data());
+    maxError = evalMaxBlockError(solid, blocks, 8, [](const uint8_t* block, int texel, QRgb expected) {
+        QRgb colors[16];
+        decodeColorBlock(block, colors);
+        QRgb actual = colors[texel];
+        return std::max({ std::abs(qRed(actual) - qRed(expected)), std::abs(qGreen(actual) - qGreen(expected)),
+                          std::abs(qBlue(actual) - qBlue(expected)) });
+    });
+    QCOMPARE(maxError, 0);
+}
+
+void ImageTests::testNativeTextureProcessing() {
+    QImage image = makeTestImage(256, 128, false);
+    image::setColorTexturesCompressionEnabled(true);
+
+    image::setNativeTextureProcessingEnabled(false);
+    auto nvttTexture = image::TextureUsage::process2DTextureColorFromImage(image, "nvtt", false);
+    image::setNativeTextureProcessingEnabled(true);
+    auto nativeTexture = image::TextureUsage::process2DTextureColorFromImage(image, "native", false);
+
+    image::setNativeTextureProcessingEnabled(false);
+    image::setColorTexturesCompressionEnabled(false);
+
+    QVERIFY(nvttTexture && nativeTexture);
+    QCOMPARE(nativeTexture->getStoredMipFormat(), nvttTexture->getStoredMipFormat());
+    QCOMPARE(nativeTexture->getNumMips(), nvttTexture->getNumMips());
+    for (uint16_t level = 0; level < nvttTexture->getNumMips(); ++level) {
+        QVERIFY(nativeTexture->isStoredMipFaceAvailable(level));
+        QCOMPARE(nativeTexture->accessStoredMipFace(level)->size(), nvttTexture->accessStoredMipFace(level)->size());
+    }
+}
+
+void ImageTests::benchmarkTextureProcessing_data() {
+    QTest::addColumn<bool>("native");
+    QTest::newRow("nvtt") << false;
+    QTest::newRow("native") << true;
+}
+
+void ImageTests::benchmarkTextureProcessing() {
+    QFETCH(bool, native);
+    image::setColorTexturesCompressionEnabled(true);
+    image::setNativeTextureProcessingEnabled(native);
+
+    QBENCHMARK_ONCE {
+        for (const auto& image : _corpus) {
+            auto texture = image::TextureUsage::process2DTextureColorFromImage(image, "benchmark", false);
+            QVERIFY(texture);
+        }
+    }
+
+    image::setNativeTextureProcessingEnabled(false);
+    image::setColorTexturesCompressionEnabled(false);
+}
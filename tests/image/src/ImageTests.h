@@ -0,0 +1,35 @@
+//
+//  ImageTests.h
+//  tests/image/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ImageTests_h
+#define hifi_ImageTests_h
+
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtGui/QImage>
+
+class ImageTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testMipChain();
+    void testGammaCorrectMips();
+    void testKaiserMips();
+    void testBlockCompression();
+    void testNativeTextureProcessing();
+    void benchmarkTextureProcessing_data();
+    void benchmarkTextureProcessing();
+
+private:
+    std::vector<QImage> _corpus;
+};
+
+#endif // hifi_ImageTests_h
@@ -23,6 +23,10 @@
 #include <SimpleMovingAverage.h>
 #include <StDev.h>
 
+#include <AudioJitterEstimator.h>
+#include <AudioLossConcealment.h>
+#include <AudioSRC.h>
+
 #include "JitterTests.h"
 
 // Uncomment this to run manually
@@ -32,6 +36,135 @@
 
 QTEST_MAIN(JitterTests)
 
+static const int FRAME_USECS = 10000;
+static const int FRAME_SAMPLES = 240;
+
+// a deterministic network: most packets arrive within 5ms of when they were sent, 1 in 20 is 40ms late
+static uint64_t simulatedArrival(int packet) {
+    uint64_t jitter = (packet % 20 == 7) ? 40000 : (packet * 7919) % 5000;
+    return 1000000 + (uint64_t)packet * FRAME_USECS + jitter;
+}
+
+void JitterTests::jitterEstimatorTargetsPercentile() {
+    AudioJitterEstimator lowPercentile(500, 0.9f, FRAME_USECS);
+    AudioJitterEstimator highPercentile(500, 0.99f, FRAME_USECS);
+
+    for (int i = 0; i < 2000; i++) {
+        lowPercentile.packetReceived((uint16_t)i, simulatedArrival(i));
+        highPercentile.packetReceived((uint16_t)i, simulatedArrival(i));
+    }
+
+    // 90% of packets are within 5ms, so one frame plus one for granularity is enough
+    QVERIFY(lowPercentile.getPercentileDelayUsecs() < 5000);
+    QCOMPARE(lowPercentile.getTargetFrames(), 2);
+
+    // covering 99% has to wait for the late packets
+    QVERIFY(highPercentile.getPercentileDelayUsecs() >= 40000 - 5000);
+    QCOMPARE(highPercentile.getTargetFrames(), 1 + 4);
+}
+
+void JitterTests::jitterEstimatorHandlesLateAndWrappedPackets() {
+    AudioJitterEstimator estimator(100, 0.95f, FRAME_USECS);
+
+    // start near the end of the sequence space, so the numbers wrap, and swap every 10th pair of packets
+    for (int i = 0; i < 400; i++) {
+        int packet = (i % 10 == 4) ? i + 1 : (i % 10 == 5) ? i - 1 : i;
+        estimator.packetReceived((uint16_t)(65500 + packet), 1000000 + (uint64_t)i * FRAME_USECS);
+    }
+
+    // each swap is one packet a frame early and one a frame late, not a jump across the sequence space
+    QCOMPARE(estimator.getPercentileDelayUsecs(), 2 * FRAME_USECS);
+    QCOMPARE(estimator.getTargetFrames(), 3);
+}
+
+static float concealmentSine(int sample) {
+    return 8000.0f * sinf(2.0f * (float)M_PI * 180.0f * sample / 24000.0f);
+}
+
+void JitterTests::lossConcealmentIsContinuous() {
+    AudioLossConcealment concealment(1, FRAME_SAMPLES);
+
+    int16_t frame[FRAME_SAMPLES];
+    int sample = 0;
+    for (int f = 0; f < 5; f++) {
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            frame[i] = (int16_t)concealmentSine(sample++);
+        }
+        concealment.frameReceived(frame);
+    }
+
+    // the largest step between samples of the original is about 2*pi*f/fs of its amplitude
+    const int MAX_STEP = (int)(8000.0f * 2.0f * (float)M_PI * 180.0f / 24000.0f) + 50;
+
+    int16_t previous = frame[FRAME_SAMPLES - 1];
+    for (int f = 0; f < 2; f++) {
+        concealment.frameLost(frame);
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            QVERIFY(abs(frame[i] - previous) <= MAX_STEP);
+            previous = frame[i];
+        }
+        sample += FRAME_SAMPLES;
+    }
+    QCOMPARE(concealment.getConsecutiveLostFrames(), 2);
+
+    // and back into the received audio without a click
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        frame[i] = (int16_t)concealmentSine(sample++);
+    }
+    concealment.frameReceived(frame);
+    QVERIFY(abs(frame[0] - previous) <= 2 * MAX_STEP);
+    QCOMPARE(concealment.getConsecutiveLostFrames(), 0);
+}
+
+void JitterTests::lossConcealmentFadesOut() {
+    AudioLossConcealment concealment(2, FRAME_SAMPLES);
+
+    int16_t frame[FRAME_SAMPLES * 2];
+    for (int f = 0; f < 3; f++) {
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            frame[2 * i] = frame[2 * i + 1] = (int16_t)concealmentSine(f * FRAME_SAMPLES + i);
+        }
+        concealment.frameReceived(frame);
+    }
+
+    // after a long loss there is nothing left to conceal with
+    for (int f = 0; f < 50; f++) {
+        concealment.frameLost(frame);
+    }
+    for (int i = 0; i < FRAME_SAMPLES * 2; i++) {
+        QCOMPARE((int)frame[i], 0);
+    }
+
+    // and with no history, loss is silence
+    concealment.reset();
+    concealment.frameLost(frame);
+    for (int i = 0; i < FRAME_SAMPLES * 2; i++) {
+        QCOMPARE((int)frame[i], 0);
+    }
+}
+
+void JitterTests::timeStretchChangesOutputLength() {
+    const float MAX_STRETCH = 0.05f;
+    const int NUM_FRAMES = 100;
+
+    int16_t input[FRAME_SAMPLES * 2] = {};
+    int16_t output[FRAME_SAMPLES * 4];
+
+    for (float stretch : { 1.0f, 1.0f - MAX_STRETCH, 1.0f + MAX_STRETCH, 2.0f }) {
+        AudioSRC stretcher(2, MAX_STRETCH);
+        stretcher.setStretch(stretch);
+
+        int outputFrames = 0;
+        for (int f = 0; f < NUM_FRAMES; f++) {
+            outputFrames += stretcher.render(input, output, FRAME_SAMPLES);
+        }
+
+        // stretches beyond the maximum are clamped to it
+        float expected = NUM_FRAMES * FRAME_SAMPLES * std::min(stretch, 1.0f + MAX_STRETCH);
+        QVERIFY(fabsf(outputFrames - expected) <= 2.0f);
+    }
+}
+
 #else // RUN_MANUALLY
 
 const quint64 MSEC_TO_USEC = 1000;
@@ -140,6 +140,70 @@ void KtxTests::testKtxSerialization() {
     testTexture->setKtxBacking(TEST_IMAGE_KTX.fileName().toStdString());
 }
 
+void KtxTests::testKtxSupercompression() {
+    const QString TEST_IMAGE = getRootPath() + "/scripts/developer/tests/cube_texture.png";
+    QImage image(TEST_IMAGE);
+    gpu::TexturePointer testTexture = image::TextureUsage::process2DTextureColorFromImage(image, TEST_IMAGE.toStdString(), true);
+    auto ktxMemory = gpu::Texture::serialize(*testTexture);
+    QVERIFY(ktxMemory.get());
+    const auto& ktxStorage = ktxMemory->getStorage();
+
+    auto dictionary = ktx::KTX::trainSupercompressionDictionary(*ktxMemory);
+    QVERIFY(dictionary.size() <= ktx::KTX::MAX_DICTIONARY_SIZE);
+
+    for (const auto& withDictionary : { std::vector<ktx::Byte>(), dictionary }) {
+        auto supercompressed = ktx::KTX::supercompress(*ktxMemory, withDictionary);
+        QVERIFY(supercompressed.get());
+        QVERIFY(supercompressed->size() < ktxStorage->size());
+        QVERIFY(ktx::KTX::validate(supercompressed));
+
+        auto header = reinterpret_cast<const ktx::Header*>(supercompressed->data());
+        auto keyValues = ktx::KTX::parseKeyValues(header->bytesOfKeyValueData, supercompressed->data() + ktx::KTX_HEADER_SIZE);
+        ktx::SupercompressionTable table;
+        QVERIFY(ktx::SupercompressionTable::parse(keyValues, table));
+        QCOMPARE(table.imageSizes.size(), ktxMemory->_images.size());
+        QCOMPARE((size_t)table.dictionarySize, withDictionary.size());
+
+        // each mip decompresses on its own, as when it is requested by byte range
+        auto texels = supercompressed->data() + ktx::KTX_HEADER_SIZE + header->bytesOfKeyValueData;
+        ktx::Decompressor decompressor(texels + table.getDictionaryOffset(), table.dictionarySize);
+        for (uint16_t level = 0; level < table.imageSizes.size(); ++level) {
+            const auto& image = ktxMemory->_images[level];
+            std::vector<ktx::Byte> mip(image._imageSize);
+            QVERIFY(decompressor.decompress(texels + table.getImageOffset(level) + ktx::IMAGE_SIZE_WIDTH, table.imageSizes[level],
+                                            mip.data(), mip.size()));
+            QVERIFY(0 == memcmp(mip.data(), image._faceBytes[0], mip.size()));
+        }
+
+        // and the whole file reads back as the KTX it was made from
+        auto ktxFile = ktx::KTX::create(supercompressed);
+        QVERIFY(ktxFile.get());
+        QVERIFY(ktxFile->isValid());
+        const auto& fileStorage = ktxFile->getStorage();
+        QCOMPARE(fileStorage->size(), ktxStorage->size());
+        QVERIFY(0 == memcmp(fileStorage->data(), ktxStorage->data(), ktxStorage->size()));
+    }
+}
+
+void KtxTests::benchmarkKtxSupercompression() {
+    const QString TEST_IMAGE = getRootPath() + "/scripts/developer/tests/cube_texture.png";
+    QImage image(TEST_IMAGE);
+    gpu::TexturePointer testTexture = image::TextureUsage::process2DTextureColorFromImage(image, TEST_IMAGE.toStdString(), true);
+    auto ktxMemory = gpu::Texture::serialize(*testTexture);
+    QVERIFY(ktxMemory.get());
+
+    auto supercompressed = ktx::KTX::supercompress(*ktxMemory);
+    auto withDictionary = ktx::KTX::supercompress(*ktxMemory, ktx::KTX::trainSupercompressionDictionary(*ktxMemory));
+    QVERIFY(supercompressed.get() && withDictionary.get());
+    qDebug() << "KTX" << ktxMemory->getStorage()->size() << "bytes, supercompressed" << supercompressed->size()
+        << "bytes, with a dictionary" << withDictionary->size() << "bytes";
+
+    QBENCHMARK {
+        auto storage = ktx::KTX::decompress(supercompressed);
+        QVERIFY(storage.get());
+    }
+}
+
 #if 0
 
 static const QString TEST_FOLDER { "H:/ktx_cacheold" };
@@ -0,0 +1,168 @@
+//
+//  AssetCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCacheTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <AssetCache.h>
+
+QTEST_GUILESS_MAIN(AssetCacheTests)
+
+static QByteArray createAsset(int size) {
+    QByteArray data(size, 0);
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)(i * 31 + 7);
+    }
+    return data;
+}
+
+static ByteRange createRange(int64_t fromInclusive, int64_t toExclusive) {
+    ByteRange range;
+    range.fromInclusive = fromInclusive;
+    range.toExclusive = toExclusive;
+    return range;
+}
+
+static std::shared_ptr<AssetCache> createCache(const QString& path) {
+    auto cache = std::make_shared<AssetCache>(path.toStdString());
+    cache->initialize();
+    return cache;
+}
+
+void AssetCacheTests::wholeAssetTest() {
+    auto cache = createCache(_testDir.path() + "/whole");
+
+    auto asset = createAsset(10000);
+    auto hash = hashData(asset).toHex();
+
+    QVERIFY(cache->read(hash).isNull());
+    QVERIFY(cache->write(hash, asset));
+
+    QCOMPARE(cache->read(hash), asset);
+
+    // any range is served from the whole asset, including ones from its end
+    QCOMPARE(cache->read(hash, createRange(100, 2000)), asset.mid(100, 1900));
+    QCOMPARE(cache->read(hash, createRange(-300, 0)), asset.right(300));
+    QCOMPARE(cache->read(hash, createRange(-20000, 0)), asset);
+
+    // the asset server refuses a range past the end, so the cache doesn't serve it
+    QVERIFY(cache->read(hash, createRange(9000, 11000)).isNull());
+
+    // hashes aren't case sensitive
+    QCOMPARE(cache->read(hash.toUpper()), asset);
+}
+
+void AssetCacheTests::byteRangeTest() {
+    auto cache = createCache(_testDir.path() + "/range");
+
+    auto asset = createAsset(10000);
+    auto hash = hashData(asset).toHex();
+
+    auto range = createRange(1000, 5000);
+    QVERIFY(cache->write(hash, asset.mid(1000, 4000), range));
+
+    // the range and the ranges it covers, but not the asset or the ranges it doesn't cover
+    QCOMPARE(cache->read(hash, range), asset.mid(1000, 4000));
+    QCOMPARE(cache->read(hash, createRange(2000, 3000)), asset.mid(2000, 1000));
+    QCOMPARE(cache->read(hash, createRange(1000, 1001)), asset.mid(1000, 1));
+    QVERIFY(cache->read(hash).isNull());
+    QVERIFY(cache->read(hash, createRange(500, 1500)).isNull());
+    QVERIFY(cache->read(hash, createRange(4000, 6000)).isNull());
+    QVERIFY(cache->read(hash, createRange(-100, 0)).isNull());
+
+    // a range from the end is only served as itself
+    auto endRange = createRange(-100, 0);
+    QVERIFY(cache->write(hash, asset.right(100), endRange));
+    QCOMPARE(cache->read(hash, endRange), asset.right(100));
+    QVERIFY(cache->read(hash, createRange(-50, 0)).isNull());
+
+    // once the whole asset is in, it serves everything
+    QVERIFY(cache->write(hash, asset));
+    QCOMPARE(cache->read(hash, createRange(500, 1500)), asset.mid(500, 1000));
+    QCOMPARE(cache->read(hash, createRange(-50, 0)), asset.right(50));
+}
+
+void AssetCacheTests::persistTest() {
+    auto path = _testDir.path() + "/persist";
+    auto asset = createAsset(4000);
+    auto hash = hashData(asset).toHex();
+    auto range = createRange(0, 1000);
+
+    {
+        auto cache = createCache(path);
+        QVERIFY(cache->write(hash, asset.left(1000), range));
+    }
+
+    // the ranges are found again from the files on disk
+    auto cache = createCache(path);
+    QCOMPARE(cache->read(hash, range), asset.left(1000));
+    QCOMPARE(cache->read(hash, createRange(200, 300)), asset.mid(200, 100));
+}
+
+void AssetCacheTests::concurrentReadTest() {
+    auto cache = createCache(_testDir.path() + "/concurrent");
+
+    const int ASSET_SIZE = 1 << 20;
+    auto asset = createAsset(ASSET_SIZE);
+    auto hash = hashData(asset).toHex();
+    QVERIFY(cache->write(hash, asset));
+
+    const int NUM_THREADS = 8;
+    const int NUM_READS = 200;
+    const int READ_SIZE = 4096;
+    std::atomic<int> numMismatches { 0 };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < NUM_READS; ++i) {
+                int offset = ((t * NUM_READS + i) * 7919) % (ASSET_SIZE - READ_SIZE);
+                if (cache->read(hash, createRange(offset, offset + READ_SIZE)) != asset.mid(offset, READ_SIZE)) {
+                    ++numMismatches;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(numMismatches.load(), 0);
+}
+
+void AssetCacheTests::assetHashesTest() {
+    auto cache = createCache(_testDir.path() + "/hashes");
+
+    auto first = createAsset(1000);
+    auto second = createAsset(2000);
+    auto third = createAsset(3000);
+    auto firstHash = hashData(first).toHex();
+    auto secondHash = hashData(second).toHex();
+    auto thirdHash = hashData(third).toHex();
+
+    QVERIFY(cache->write(firstHash, first));
+    QVERIFY(cache->write(secondHash.toUpper(), second));
+    QVERIFY(cache->write(thirdHash, third.mid(0, 100), createRange(0, 100)));
+
+    // only whole assets are held, so only they are listed
+    auto hashes = cache->getAssetHashes();
+    std::sort(hashes.begin(), hashes.end());
+
+    std::vector<AssetHash> expected { firstHash, secondHash };
+    std::sort(expected.begin(), expected.end());
+    QVERIFY(hashes == expected);
+
+    cache->wipe();
+    QVERIFY(cache->getAssetHashes().empty());
+}
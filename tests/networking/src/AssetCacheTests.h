@@ -0,0 +1,30 @@
+//
+//  AssetCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCacheTests_h
+#define hifi_AssetCacheTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class AssetCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void wholeAssetTest();
+    void byteRangeTest();
+    void persistTest();
+    void concurrentReadTest();
+    void assetHashesTest();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_AssetCacheTests_h
@@ -0,0 +1,109 @@
+//
+//  AssetUtilsTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUtilsTests.h"
+
+#include <QtCore/QBuffer>
+
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetUtilsTests)
+
+static const DataOffset CHUNK_SIZE = 16;
+
+// two and a half chunks, with bytes that differ from chunk to chunk
+static QByteArray makeAsset() {
+    QByteArray data;
+    for (int i = 0; i < 2 * CHUNK_SIZE + CHUNK_SIZE / 2; ++i) {
+        data.append((char)i);
+    }
+    return data;
+}
+
+static QList<QByteArray> hashAsset(const QByteArray& data) {
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    return hashChunks(buffer, CHUNK_SIZE);
+}
+
+void AssetUtilsTests::numChunksTest() {
+    QCOMPARE(getNumChunks(0, CHUNK_SIZE), 0);
+    QCOMPARE(getNumChunks(1, CHUNK_SIZE), 1);
+    QCOMPARE(getNumChunks(CHUNK_SIZE, CHUNK_SIZE), 1);
+    QCOMPARE(getNumChunks(CHUNK_SIZE + 1, CHUNK_SIZE), 2);
+    QCOMPARE(getNumChunks(3 * CHUNK_SIZE, CHUNK_SIZE), 3);
+
+    // nonsense from the asset server doesn't make chunks
+    QCOMPARE(getNumChunks(-1, CHUNK_SIZE), 0);
+    QCOMPARE(getNumChunks(CHUNK_SIZE, 0), 0);
+}
+
+void AssetUtilsTests::hashChunksTest() {
+    auto data = makeAsset();
+    auto hashes = hashAsset(data);
+
+    QCOMPARE(hashes.size(), getNumChunks(data.size(), CHUNK_SIZE));
+    QCOMPARE(hashes.size(), 3);
+    QCOMPARE(hashes[0], hashData(data.mid(0, CHUNK_SIZE)));
+    QCOMPARE(hashes[1], hashData(data.mid(CHUNK_SIZE, CHUNK_SIZE)));
+    QCOMPARE(hashes[2], hashData(data.mid(2 * CHUNK_SIZE)));
+    QVERIFY(hashes[0] != hashes[1]);
+
+    // an asset that is a whole number of chunks has no empty chunk at the end
+    hashes = hashAsset(data.left(2 * CHUNK_SIZE));
+    QCOMPARE(hashes.size(), 2);
+    QCOMPARE(hashes[1], hashData(data.mid(CHUNK_SIZE, CHUNK_SIZE)));
+}
+
+void AssetUtilsTests::hashEmptyTest() {
+    QVERIFY(hashAsset(QByteArray()).isEmpty());
+
+    // a device that can't be read
+    QBuffer buffer;
+    QVERIFY(hashChunks(buffer, CHUNK_SIZE).isEmpty());
+}
+
+void AssetUtilsTests::validChunkTest() {
+    auto data = makeAsset();
+    auto hashes = hashAsset(data);
+
+    for (int i = 0; i < hashes.size(); ++i) {
+        auto chunk = data.mid(i * CHUNK_SIZE, CHUNK_SIZE);
+        QVERIFY(isValidChunk(chunk, i, data.size(), CHUNK_SIZE, hashes));
+    }
+}
+
+void AssetUtilsTests::invalidChunkTest() {
+    auto data = makeAsset();
+    auto hashes = hashAsset(data);
+    auto firstChunk = data.left(CHUNK_SIZE);
+    auto lastChunk = data.mid(2 * CHUNK_SIZE);
+
+    // the right bytes for another chunk
+    QVERIFY(!isValidChunk(firstChunk, 1, data.size(), CHUNK_SIZE, hashes));
+
+    // a changed byte
+    auto tampered = firstChunk;
+    tampered[3] = tampered[3] + 1;
+    QVERIFY(!isValidChunk(tampered, 0, data.size(), CHUNK_SIZE, hashes));
+
+    // cut short, or with something after it
+    QVERIFY(!isValidChunk(firstChunk.left(CHUNK_SIZE - 1), 0, data.size(), CHUNK_SIZE, hashes));
+    QVERIFY(!isValidChunk(lastChunk + QByteArray(1, 0), 2, data.size(), CHUNK_SIZE, hashes));
+    QVERIFY(!isValidChunk(QByteArray(), 0, data.size(), CHUNK_SIZE, hashes));
+
+    // chunks the asset doesn't have
+    QVERIFY(!isValidChunk(lastChunk, 3, data.size(), CHUNK_SIZE, hashes));
+    QVERIFY(!isValidChunk(firstChunk, -1, data.size(), CHUNK_SIZE, hashes));
+
+    // fewer hashes than chunks
+    QVERIFY(!isValidChunk(lastChunk, 2, data.size(), CHUNK_SIZE, hashes.mid(0, 2)));
+}
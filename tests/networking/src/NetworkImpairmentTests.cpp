@@ -0,0 +1,185 @@
+//
+//  NetworkImpairmentTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkImpairmentTests.h"
+
+#include <udt/NetworkImpairment.h>
+
+QTEST_MAIN(NetworkImpairmentTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+using TimePoint = NetworkImpairment::TimePoint;
+
+static const HifiSockAddr SOCK_ADDR(QHostAddress::LocalHost, 40102);
+
+// the delivery times of numDatagrams sent a millisecond apart, with a null time for the lost ones
+static std::vector<TimePoint> impair(NetworkImpairment& impairment, int numDatagrams, TimePoint start) {
+    std::vector<TimePoint> deliveryTimes;
+    std::vector<int> queued;
+
+    for (int i = 0; i < numDatagrams; ++i) {
+        QByteArray data = QByteArray::number(i);
+        if (impairment.queueDatagram(NetworkImpairment::Outbound, data, SOCK_ADDR, start + milliseconds(i))) {
+            queued.push_back(i);
+        }
+    }
+
+    deliveryTimes.resize(numDatagrams);
+    for (const auto& datagram : impairment.takeDueDatagrams(NetworkImpairment::Outbound, TimePoint::max())) {
+        deliveryTimes[datagram.data.toInt()] = datagram.deliveryTime;
+    }
+
+    return deliveryTimes;
+}
+
+void NetworkImpairmentTests::parseTest() {
+    NetworkImpairment::Settings settings;
+
+    QVERIFY(NetworkImpairment::parseSettings("seed=7,loss=2.5,burst=1,burst-length=4,delay=50,jitter=10,"
+                                             "jitter-distribution=pareto,reorder=5,reorder-delay=20,"
+                                             "bandwidth=2000,buffer=50", settings));
+    QCOMPARE(settings.seed, (uint32_t)7);
+    QCOMPARE(settings.loss, 0.025f);
+    QCOMPARE(settings.burstLoss, 0.01f);
+    QCOMPARE(settings.burstLength, 4);
+    QCOMPARE(settings.delay, 50);
+    QCOMPARE(settings.jitter, 10);
+    QCOMPARE(settings.jitterDistribution, NetworkImpairment::Pareto);
+    QCOMPARE(settings.reorder, 0.05f);
+    QCOMPARE(settings.reorderDelay, 20);
+    QCOMPARE(settings.bandwidth, 2000);
+    QCOMPARE(settings.bufferSize, 50);
+    QVERIFY(settings.isEnabled());
+
+    // what isn't given is left at its default
+    QVERIFY(NetworkImpairment::parseSettings("delay=20", settings));
+    QCOMPARE(settings.delay, 20);
+    QCOMPARE(settings.loss, 0.0f);
+    QVERIFY(settings.isEnabled());
+
+    QVERIFY(NetworkImpairment::parseSettings("seed=3", settings));
+    QVERIFY(!settings.isEnabled());
+
+    // a malformed string leaves the settings alone
+    QVERIFY(!NetworkImpairment::parseSettings("loss", settings));
+    QVERIFY(!NetworkImpairment::parseSettings("loss=lots", settings));
+    QVERIFY(!NetworkImpairment::parseSettings("loss=150", settings));
+    QVERIFY(!NetworkImpairment::parseSettings("delay=-1", settings));
+    QVERIFY(!NetworkImpairment::parseSettings("jitter-distribution=cauchy", settings));
+    QVERIFY(!NetworkImpairment::parseSettings("latency=10", settings));
+    QCOMPARE(settings.seed, (uint32_t)3);
+}
+
+void NetworkImpairmentTests::determinismTest() {
+    NetworkImpairment::Settings settings;
+    settings.seed = 42;
+    settings.loss = 0.1f;
+    settings.burstLoss = 0.02f;
+    settings.delay = 20;
+    settings.jitter = 5;
+    settings.jitterDistribution = NetworkImpairment::Normal;
+    settings.reorder = 0.05f;
+
+    const int NUM_DATAGRAMS = 1000;
+    auto start = p_high_resolution_clock::now();
+
+    NetworkImpairment first(settings);
+    NetworkImpairment second(settings);
+    auto firstTimes = impair(first, NUM_DATAGRAMS, start);
+    auto secondTimes = impair(second, NUM_DATAGRAMS, start);
+
+    QVERIFY(firstTimes == secondTimes);
+    QCOMPARE(first.getNumLost(), second.getNumLost());
+    QVERIFY(first.getNumLost() > 0);
+    QVERIFY(first.getNumLost() < NUM_DATAGRAMS / 2);
+
+    // and another seed impairs it another way
+    settings.seed = 43;
+    NetworkImpairment third(settings);
+    QVERIFY(impair(third, NUM_DATAGRAMS, start) != firstTimes);
+}
+
+void NetworkImpairmentTests::linkIndependenceTest() {
+    NetworkImpairment::Settings settings;
+    settings.seed = 42;
+    settings.loss = 0.1f;
+    settings.delay = 20;
+    settings.jitter = 5;
+
+    const int NUM_DATAGRAMS = 1000;
+    const HifiSockAddr OTHER_SOCK_ADDR(QHostAddress::LocalHost, 40103);
+    auto start = p_high_resolution_clock::now();
+
+    NetworkImpairment alone(settings);
+    auto aloneTimes = impair(alone, NUM_DATAGRAMS, start);
+
+    // the same datagrams, after as many to another address and as many inbound from this one
+    NetworkImpairment shared(settings);
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        shared.queueDatagram(NetworkImpairment::Outbound, QByteArray::number(i), OTHER_SOCK_ADDR, start + milliseconds(i));
+        shared.queueDatagram(NetworkImpairment::Inbound, QByteArray::number(i), SOCK_ADDR, start + milliseconds(i));
+    }
+    shared.takeDueDatagrams(NetworkImpairment::Outbound, TimePoint::max());
+    QVERIFY(impair(shared, NUM_DATAGRAMS, start) == aloneTimes);
+}
+
+void NetworkImpairmentTests::orderTest() {
+    NetworkImpairment::Settings settings;
+    settings.delay = 30;
+    settings.jitter = 20;
+
+    const int NUM_DATAGRAMS = 200;
+    auto start = p_high_resolution_clock::now();
+
+    NetworkImpairment impairment(settings);
+    auto deliveryTimes = impair(impairment, NUM_DATAGRAMS, start);
+
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        QVERIFY(deliveryTimes[i] >= start + milliseconds(i + settings.delay));
+        if (i > 0) {
+            QVERIFY(deliveryTimes[i] >= deliveryTimes[i - 1]);
+        }
+    }
+}
+
+void NetworkImpairmentTests::bandwidthTest() {
+    NetworkImpairment::Settings settings;
+    settings.bandwidth = 800; // a hundred bytes a millisecond
+    settings.bufferSize = 10;
+
+    NetworkImpairment impairment(settings);
+    auto now = p_high_resolution_clock::now();
+
+    // a burst of ten millisecond datagrams fills the buffer, and the rest are dropped
+    const QByteArray DATAGRAM(1000, 'x');
+    const int NUM_DATAGRAMS = 4;
+    int numQueued = 0;
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        if (impairment.queueDatagram(NetworkImpairment::Outbound, DATAGRAM, SOCK_ADDR, now)) {
+            ++numQueued;
+        }
+    }
+    QCOMPARE(numQueued, 2);
+    QCOMPARE(impairment.getNumLost(), NUM_DATAGRAMS - numQueued);
+
+    auto datagrams = impairment.takeDueDatagrams(NetworkImpairment::Outbound, TimePoint::max());
+    QCOMPARE((int)datagrams.size(), numQueued);
+    QVERIFY(datagrams[0].deliveryTime == now + milliseconds(10));
+    QVERIFY(datagrams[1].deliveryTime == now + milliseconds(20));
+
+    // the other direction and other addresses have their own bottleneck
+    QVERIFY(impairment.queueDatagram(NetworkImpairment::Inbound, DATAGRAM, SOCK_ADDR, now));
+    QVERIFY(impairment.queueDatagram(NetworkImpairment::Outbound, DATAGRAM,
+                                     HifiSockAddr(QHostAddress::LocalHost, 40103), now));
+    QVERIFY(impairment.takeDueDatagrams(NetworkImpairment::Outbound, now + milliseconds(9)).empty());
+    QCOMPARE((int)impairment.takeDueDatagrams(NetworkImpairment::Inbound, now + milliseconds(10)).size(), 1);
+}
@@ -0,0 +1,37 @@
+//
+//  NetworkImpairmentTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkImpairmentTests_h
+#define hifi_NetworkImpairmentTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class NetworkImpairmentTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test parsing the settings from the command line format
+    void parseTest();
+
+    // Test the same seed and traffic are impaired the same way
+    void determinismTest();
+
+    // Test traffic to one address doesn't change how another is impaired
+    void linkIndependenceTest();
+
+    // Test delay and jitter without re-ordering keep the datagrams in order
+    void orderTest();
+
+    // Test the bandwidth cap spaces the datagrams out and drops what doesn't fit its buffer
+    void bandwidthTest();
+};
+
+#endif // hifi_NetworkImpairmentTests_h
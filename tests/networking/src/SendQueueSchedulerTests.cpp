@@ -0,0 +1,206 @@
+//
+//  SendQueueSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueSchedulerTests.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include <udt/SendQueueScheduler.h>
+
+QTEST_MAIN(SendQueueSchedulerTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+using TimePoint = SendQueueScheduler::TimePoint;
+using Schedule = SendQueueScheduler::Client::Schedule;
+
+class TestClient : public SendQueueScheduler::Client {
+public:
+    using Service = std::function<Schedule(TestClient& client, TimePoint now)>;
+
+    TestClient(Service service) : _service(service) {}
+
+    Schedule service(TimePoint now) override {
+        lastService = now;
+        ++numServices;
+        return _service(*this, now);
+    }
+
+    std::atomic<int> numServices { 0 };
+    TimePoint lastService;
+
+private:
+    Service _service;
+};
+
+static bool waitFor(std::function<bool()> condition, milliseconds timeout = milliseconds(2000)) {
+    auto end = p_high_resolution_clock::now() + timeout;
+    while (!condition()) {
+        if (p_high_resolution_clock::now() > end) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+// Services a client that is due now on a scheduler with one thread.  Deadlines come off the heap in order, so once it has
+// been serviced nothing that was due before it is still waiting.
+static bool serviceProbe(SendQueueScheduler& scheduler) {
+    TestClient probe([](TestClient& client, TimePoint now) -> Schedule {
+        return { now, false, true };
+    });
+    scheduler.add(&probe);
+    bool wasServiced = waitFor([&] { return probe.numServices == 1; });
+    scheduler.remove(&probe);
+    return wasServiced;
+}
+
+void SendQueueSchedulerTests::deadlineTest() {
+    SendQueueScheduler scheduler(2);
+    QCOMPARE(scheduler.getNumThreads(), 2);
+
+    static const auto PERIOD = milliseconds(20);
+    static const int NUM_SERVICES = 5;
+
+    TimePoint first;
+    TestClient client([&](TestClient& client, TimePoint now) -> Schedule {
+        if (client.numServices == 1) {
+            first = now;
+        }
+        return { now + PERIOD, false, client.numServices == NUM_SERVICES };
+    });
+    scheduler.add(&client);
+
+    QVERIFY(waitFor([&] { return client.numServices == NUM_SERVICES; }));
+
+    // the client is never serviced before its deadline, and not again once it's finished
+    QVERIFY(client.lastService - first >= (NUM_SERVICES - 1) * PERIOD);
+    std::this_thread::sleep_for(PERIOD * 2);
+    QCOMPARE((int)client.numServices, NUM_SERVICES);
+
+    scheduler.remove(&client);
+}
+
+void SendQueueSchedulerTests::wakeTest() {
+    SendQueueScheduler scheduler(1);
+
+    TestClient client([](TestClient& client, TimePoint now) -> Schedule {
+        return { now + seconds(60), true };
+    });
+    scheduler.add(&client);
+    QVERIFY(waitFor([&] { return client.numServices == 1; }));
+
+    scheduler.wake(&client);
+    QVERIFY(waitFor([&] { return client.numServices == 2; }));
+
+    scheduler.remove(&client);
+}
+
+void SendQueueSchedulerTests::wakePacingTest() {
+    SendQueueScheduler scheduler(1);
+
+    TestClient client([](TestClient& client, TimePoint now) -> Schedule {
+        return { now + seconds(60) };
+    });
+    scheduler.add(&client);
+    QVERIFY(waitFor([&] { return client.numServices == 1; }));
+
+    // a client that isn't waiting is only serviced at its deadline, rather than ahead of a client added after the wake
+    scheduler.wake(&client);
+    QVERIFY(serviceProbe(scheduler));
+    QCOMPARE((int)client.numServices, 1);
+
+    scheduler.remove(&client);
+}
+
+void SendQueueSchedulerTests::wakeWhileServicingTest() {
+    SendQueueScheduler scheduler(1);
+
+    std::atomic<bool> isServicing { false };
+    std::atomic<bool> canFinish { false };
+    TestClient client([&](TestClient& client, TimePoint now) -> Schedule {
+        if (client.numServices == 1) {
+            isServicing = true;
+            while (!canFinish) {
+                std::this_thread::yield();
+            }
+        }
+        return { now + seconds(60), true };
+    });
+    scheduler.add(&client);
+    QVERIFY(waitFor([&] { return (bool)isServicing; }));
+
+    // woken before it decides to wait, it's serviced again right away rather than after its wait
+    scheduler.wake(&client);
+    canFinish = true;
+    QVERIFY(waitFor([&] { return client.numServices == 2; }));
+
+    scheduler.remove(&client);
+}
+
+void SendQueueSchedulerTests::removeTest() {
+    SendQueueScheduler scheduler(1);
+
+    static const auto SERVICE_DURATION = milliseconds(50);
+    std::atomic<bool> isServicing { false };
+    std::atomic<bool> wasServiced { false };
+    TestClient client([&](TestClient& client, TimePoint now) -> Schedule {
+        isServicing = true;
+        std::this_thread::sleep_for(SERVICE_DURATION);
+        wasServiced = true;
+        return { now };
+    });
+    scheduler.add(&client);
+    QVERIFY(waitFor([&] { return (bool)isServicing; }));
+
+    // remove returns once the servicing is done, after which there is none
+    scheduler.remove(&client);
+    QVERIFY(wasServiced);
+    int numServices = client.numServices;
+    QVERIFY(serviceProbe(scheduler));
+    QCOMPARE((int)client.numServices, numServices);
+
+    // removing a client that isn't there does nothing
+    scheduler.remove(&client);
+}
+
+void SendQueueSchedulerTests::manyClientsTest() {
+    static const int NUM_THREADS = 2;
+    static const int NUM_CLIENTS = 1000;
+    static const int NUM_SERVICES = 10;
+    static const auto PERIOD = milliseconds(10);
+
+    SendQueueScheduler scheduler(NUM_THREADS);
+
+    std::vector<std::unique_ptr<TestClient>> clients;
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients.emplace_back(new TestClient([](TestClient& client, TimePoint now) -> Schedule {
+            return { now + PERIOD, false, client.numServices == NUM_SERVICES };
+        }));
+    }
+
+    for (auto& client : clients) {
+        scheduler.add(client.get());
+    }
+
+    QVERIFY(waitFor([&] {
+        return std::all_of(clients.begin(), clients.end(), [](const std::unique_ptr<TestClient>& client) {
+            return client->numServices == NUM_SERVICES;
+        });
+    }, milliseconds(10000)));
+
+    for (auto& client : clients) {
+        scheduler.remove(client.get());
+    }
+}
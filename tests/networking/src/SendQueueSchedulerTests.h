@@ -0,0 +1,40 @@
+//
+//  SendQueueSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueSchedulerTests_h
+#define hifi_SendQueueSchedulerTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SendQueueSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test clients are serviced at their deadlines
+    void deadlineTest();
+
+    // Test waking a client that waits
+    void wakeTest();
+
+    // Test a client that paces isn't serviced before its deadline when woken
+    void wakePacingTest();
+
+    // Test a client woken while it is being serviced
+    void wakeWhileServicingTest();
+
+    // Test removing a client waits for it to be serviced and stops its servicing
+    void removeTest();
+
+    // Test many clients on few threads
+    void manyClientsTest();
+};
+
+#endif // hifi_SendQueueSchedulerTests_h
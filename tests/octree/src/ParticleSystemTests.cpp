@@ -0,0 +1,214 @@
+//
+//  ParticleSystemTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ParticleSystemTests.h"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <NumericalConstants.h>
+#include <ParticleSystem.h>
+#include <TBBHelpers.h>
+
+QTEST_MAIN(ParticleSystemTests)
+
+const float STEP = 1.0f / 90.0f;
+
+static ParticleEmitter makeEmitter(uint32_t maxParticles, float emitRate, float lifespan) {
+    ParticleEmitter emitter;
+    emitter.maxParticles = maxParticles;
+    emitter.emitRate = emitRate;
+    emitter.lifespan = lifespan;
+    emitter.emitSpeed = 1.0f;
+    emitter.speedSpread = 0.0f;
+    emitter.emitAcceleration = glm::vec3(0.0f, -9.8f, 0.0f);
+    emitter.emitDimensions = glm::vec3(1.0f);
+    emitter.polarFinish = PI;
+    emitter.azimuthStart = -PI;
+    emitter.azimuthFinish = PI;
+    return emitter;
+}
+
+// a system full of particles, all of which live for the whole benchmark
+static void fillSystem(ParticleSystem& system, int numParticles) {
+    ParticleEmitter emitter = makeEmitter(numParticles, (float)numParticles, 1000.0f);
+    system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), 1.0f);
+    emitter.isEmitting = false;
+    system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f);
+}
+
+void ParticleSystemTests::randomSequence() {
+    // the same seed gives the same values, however they are asked for
+    const int NUM_VALUES = 1001;
+    std::vector<float> all(NUM_VALUES);
+    ParticleRandom random(17);
+    random.fill(all.data(), NUM_VALUES);
+
+    std::vector<float> pieces(NUM_VALUES);
+    ParticleRandom piecewise(17);
+    int filled = 0;
+    for (int count = 1; filled < NUM_VALUES; count++) {
+        int n = std::min(count, NUM_VALUES - filled);
+        piecewise.fill(pieces.data() + filled, n);
+        filled += n;
+    }
+    QVERIFY(all == pieces);
+
+    float sum = 0.0f;
+    for (float value : all) {
+        QVERIFY(value >= 0.0f && value < 1.0f);
+        sum += value;
+    }
+    QVERIFY(fabsf(sum / NUM_VALUES - 0.5f) < 0.05f);
+
+    ParticleRandom other(18);
+    std::vector<float> otherValues(NUM_VALUES);
+    other.fill(otherValues.data(), NUM_VALUES);
+    QVERIFY(all != otherValues);
+}
+
+void ParticleSystemTests::particlesDieOldestFirst() {
+    const float EMIT_RATE = 1000.0f;
+    const float LIFESPAN = 0.05f;
+    ParticleSystem system;
+    ParticleEmitter emitter = makeEmitter(1000, EMIT_RATE, LIFESPAN);
+    for (int i = 0; i < 20; i++) {
+        system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), STEP);
+        for (int j = 1; j < system.getNumParticles(); j++) {
+            QVERIFY(system.getLifetime(j - 1) >= system.getLifetime(j));
+        }
+        QVERIFY(system.getLifetime(0) < LIFESPAN);
+    }
+    QVERIFY(std::abs(system.getNumParticles() - (int)(EMIT_RATE * LIFESPAN)) <= 1);
+
+    // once emitting stops the rest die off
+    emitter.isEmitting = false;
+    system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), LIFESPAN);
+    QVERIFY(system.isEmpty());
+}
+
+void ParticleSystemTests::overflowDropsOldest() {
+    const uint32_t MAX_PARTICLES = 100;
+    ParticleSystem system;
+    ParticleEmitter emitter = makeEmitter(MAX_PARTICLES, 1000.0f, 10.0f);
+    for (int i = 0; i < 30; i++) {
+        system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), STEP);
+    }
+    QCOMPARE(system.getNumParticles(), (int)MAX_PARTICLES);
+    // the newest particles were kept
+    QVERIFY(system.getLifetime(0) < MAX_PARTICLES / 1000.0f + STEP);
+
+    float newest = system.getLifetime(system.getNumParticles() - 1);
+    system.setCapacity(MAX_PARTICLES / 4);
+    QCOMPARE(system.getNumParticles(), (int)MAX_PARTICLES / 4);
+    QCOMPARE(system.getLifetime(system.getNumParticles() - 1), newest);
+}
+
+void ParticleSystemTests::integrateConstantAcceleration() {
+    // a single particle emitted along z, at the very start of the first step
+    ParticleSystem system;
+    ParticleEmitter emitter = makeEmitter(10, 0.01f, 100.0f);
+    emitter.emitDimensions = glm::vec3(0.0f);
+    emitter.polarFinish = 0.0f;
+    emitter.emitSpeed = 2.0f;
+    emitter.emitAcceleration = glm::vec3(0.0f, 0.0f, -1.0f);
+
+    float time = 0.0f;
+    for (int i = 0; i < 100; i++) {
+        system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), STEP);
+        time += STEP;
+    }
+    QCOMPARE(system.getNumParticles(), 1);
+    QVERIFY(fabsf(system.getLifetime(0) - time) < 1.0e-4f);
+    float expectedZ = emitter.emitSpeed * time + 0.5f * emitter.emitAcceleration.z * time * time;
+    QVERIFY(fabsf(system.getPosition(0).z - expectedZ) < 1.0e-3f);
+    QVERIFY(fabsf(system.getVelocity(0).z - (emitter.emitSpeed + emitter.emitAcceleration.z * time)) < 1.0e-4f);
+}
+
+void ParticleSystemTests::writePrimitivesAcrossWrap() {
+    ParticleSystem system;
+    ParticleEmitter emitter = makeEmitter(64, 1000.0f, 10.0f);
+    // overflow for a while so the head of the ring is somewhere in the middle
+    for (int i = 0; i < 13; i++) {
+        system.step(emitter, glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f), STEP);
+    }
+    QCOMPARE(system.getNumParticles(), 64);
+
+    std::vector<ParticleSystem::Primitive> primitives(system.getNumParticles());
+    system.writePrimitives(primitives.data());
+    for (int i = 0; i < system.getNumParticles(); i++) {
+        QVERIFY(primitives[i].xyz == system.getPosition(i));
+        QCOMPARE(primitives[i].uv.x, system.getLifetime(i));
+        QCOMPARE(primitives[i].uv.y, system.getSeed(i));
+    }
+}
+
+void ParticleSystemTests::benchmarkStep() {
+    const int NUM_STEPS = 100;
+    for (int numParticles : { 100000, 1000000 }) {
+        ParticleSystem system;
+        fillSystem(system, numParticles);
+        QVERIFY(system.getNumParticles() > numParticles * 9 / 10);
+
+        ParticleEmitter emitter = makeEmitter(numParticles, 0.0f, 1000.0f);
+        emitter.isEmitting = false;
+        std::vector<ParticleSystem::Primitive> primitives(numParticles);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < NUM_STEPS; i++) {
+            system.step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), STEP);
+        }
+        qint64 stepNsecs = timer.nsecsElapsed();
+        timer.restart();
+        for (int i = 0; i < NUM_STEPS; i++) {
+            system.writePrimitives(primitives.data());
+        }
+        qint64 writeNsecs = timer.nsecsElapsed();
+        qDebug() << system.getNumParticles() << "particles:"
+            << (float)stepNsecs / (NUM_STEPS * 1000) << "usecs per step,"
+            << (float)writeNsecs / (NUM_STEPS * 1000) << "usecs per write";
+    }
+}
+
+void ParticleSystemTests::benchmarkParallelEmitters() {
+    const int NUM_EMITTERS = 10;
+    const int NUM_PARTICLES = 100000;
+    const int NUM_STEPS = 50;
+    std::vector<std::unique_ptr<ParticleSystem>> systems;
+    for (int i = 0; i < NUM_EMITTERS; i++) {
+        systems.emplace_back(new ParticleSystem());
+        fillSystem(*systems.back(), NUM_PARTICLES);
+    }
+    ParticleEmitter emitter = makeEmitter(NUM_PARTICLES, 1000.0f, 1000.0f);
+
+    for (bool parallel : { false, true }) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int step = 0; step < NUM_STEPS; step++) {
+            if (parallel) {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, systems.size(), 1),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            systems[i]->step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), STEP);
+                        }
+                    });
+            } else {
+                for (auto& system : systems) {
+                    system->step(emitter, glm::vec3(0.0f), glm::vec3(0.0f), STEP);
+                }
+            }
+        }
+        qDebug() << (parallel ? "parallel" : "serial") << NUM_EMITTERS << "emitters of" << NUM_PARTICLES
+            << "particles,"
+            << (float)timer.nsecsElapsed() / (NUM_STEPS * 1000) << "usecs per step";
+    }
+}
@@ -0,0 +1,29 @@
+//
+//  ParticleSystemTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParticleSystemTests_h
+#define hifi_ParticleSystemTests_h
+
+#include <QtTest/QtTest>
+
+class ParticleSystemTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void randomSequence();
+    void particlesDieOldestFirst();
+    void overflowDropsOldest();
+    void integrateConstantAcceleration();
+    void writePrimitivesAcrossWrap();
+    void benchmarkStep();
+    void benchmarkParallelEmitters();
+};
+
+#endif // hifi_ParticleSystemTests_h
@@ -0,0 +1,181 @@
+//
+//  PolyVoxBricksTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PolyVoxBricksTests.h"
+
+#include <PolyVoxBricks.h>
+
+QTEST_MAIN(PolyVoxBricksTests)
+
+static QByteArray makeBrickVoxels(int seed) {
+    // runs of different lengths, some of them longer than a single length byte can hold
+    QByteArray voxels(PolyVoxBricks::VOXELS_PER_BRICK, '\0');
+    int i = 0;
+    int run = 0;
+    while (i < voxels.size()) {
+        int runLength = (run * 37 + seed) % 300 + 1;
+        for (int j = 0; j < runLength && i < voxels.size(); j++) {
+            voxels[i++] = (char)((run + seed) % 4);
+        }
+        run++;
+    }
+    return voxels;
+}
+
+static QByteArray makeLegacyVoxelData(quint16 xSize, quint16 ySize, quint16 zSize, const QByteArray& voxels) {
+    QByteArray voxelData;
+    QDataStream writer(&voxelData, QIODevice::WriteOnly | QIODevice::Truncate);
+    writer << xSize << ySize << zSize;
+    writer << qCompress(voxels, 9);
+    return voxelData;
+}
+
+void PolyVoxBricksTests::encodeDecodeBrick() {
+    for (int seed = 0; seed < 5; seed++) {
+        QByteArray voxels = makeBrickVoxels(seed);
+        QByteArray encoded = PolyVoxBricks::encodeBrick(voxels);
+        QVERIFY(encoded.size() < voxels.size());
+
+        QByteArray decoded;
+        QVERIFY(PolyVoxBricks::decodeBrick(encoded, decoded));
+        QCOMPARE(decoded, voxels);
+    }
+
+    // a brick of one value is a single run
+    QByteArray full(PolyVoxBricks::VOXELS_PER_BRICK, (char)255);
+    QByteArray decoded;
+    QVERIFY(PolyVoxBricks::encodeBrick(full).size() <= 3);
+    QVERIFY(PolyVoxBricks::decodeBrick(PolyVoxBricks::encodeBrick(full), decoded));
+    QCOMPARE(decoded, full);
+}
+
+void PolyVoxBricksTests::emptyBricksTakeNoSpace() {
+    QByteArray zeros(PolyVoxBricks::VOXELS_PER_BRICK, '\0');
+    QVERIFY(PolyVoxBricks::encodeBrick(zeros).isEmpty());
+
+    PolyVoxBricks bricks(128, 128, 128);
+    QCOMPARE(bricks.getNumBricks(), 8 * 8 * 8);
+    QVERIFY(bricks.toVoxelData().size() < 64);
+}
+
+void PolyVoxBricksTests::roundTripVoxelData() {
+    // sizes that aren't a multiple of the brick size leave partial bricks along the upper edges
+    PolyVoxBricks bricks(40, 20, 17);
+    QCOMPARE(bricks.getNumBricks(), 3 * 2 * 2);
+    for (int brickIndex = 0; brickIndex < bricks.getNumBricks(); brickIndex += 2) {
+        bricks.setBrickVoxels(brickIndex, makeBrickVoxels(brickIndex));
+    }
+
+    PolyVoxBricks copy;
+    QVERIFY(copy.fromVoxelData(bricks.toVoxelData()));
+    QVERIFY(copy.hasSize(40, 20, 17));
+    QVERIFY(copy.findChangedBricks(bricks).empty());
+    QCOMPARE(copy.getBrickVoxels(4), makeBrickVoxels(4));
+    QVERIFY(copy.isBrickEmpty(1));
+}
+
+void PolyVoxBricksTests::readLegacyVoxelData() {
+    const quint16 xSize = 20;
+    const quint16 ySize = 18;
+    const quint16 zSize = 3;
+    QByteArray voxels(xSize * ySize * zSize, '\0');
+    for (int i = 0; i < voxels.size(); i++) {
+        voxels[i] = (char)(i % 7);
+    }
+
+    PolyVoxBricks bricks;
+    QVERIFY(bricks.fromVoxelData(makeLegacyVoxelData(xSize, ySize, zSize, voxels)));
+    QVERIFY(bricks.hasSize(xSize, ySize, zSize));
+
+    // voxel (17, 16, 2) is in the last brick
+    int brickIndex = bricks.getBrickIndex(17, 16, 2);
+    QCOMPARE(brickIndex, 3);
+    QByteArray brickVoxels = bricks.getBrickVoxels(brickIndex);
+    int legacyIndex = (2 * ySize * xSize) + (16 * xSize) + 17;
+    int brickOffset = (17 - 16) + (16 - 16) * PolyVoxBricks::BRICK_SIZE +
+        2 * PolyVoxBricks::BRICK_SIZE * PolyVoxBricks::BRICK_SIZE;
+    QCOMPARE(brickVoxels[brickOffset], voxels[legacyIndex]);
+
+    // and it can be written back out in the bricked format
+    PolyVoxBricks copy;
+    QVERIFY(copy.fromVoxelData(bricks.toVoxelData()));
+    QVERIFY(copy.findChangedBricks(bricks).empty());
+}
+
+void PolyVoxBricksTests::mergeDelta() {
+    PolyVoxBricks server(32, 32, 32);
+    server.setBrickVoxels(0, makeBrickVoxels(1));
+    QByteArray serverVoxelData = server.toVoxelData();
+
+    // two people edit different bricks of the same volume at once
+    PolyVoxBricks first = server;
+    first.setBrickVoxels(3, makeBrickVoxels(2));
+    QByteArray firstDelta = first.toDeltaVoxelData({ 3 });
+
+    PolyVoxBricks second = server;
+    second.setBrickVoxels(0, QByteArray(PolyVoxBricks::VOXELS_PER_BRICK, '\0'));
+    second.setBrickVoxels(5, makeBrickVoxels(3));
+    QByteArray secondDelta = second.toDeltaVoxelData({ 0, 5 });
+
+    QVERIFY(PolyVoxBricks::isDeltaVoxelData(firstDelta));
+    QVERIFY(!PolyVoxBricks::isDeltaVoxelData(serverVoxelData));
+    QVERIFY(firstDelta.size() < first.toVoxelData().size());
+
+    serverVoxelData = PolyVoxBricks::mergeVoxelData(serverVoxelData, firstDelta);
+    serverVoxelData = PolyVoxBricks::mergeVoxelData(serverVoxelData, secondDelta);
+
+    PolyVoxBricks merged;
+    QVERIFY(merged.fromVoxelData(serverVoxelData));
+    QVERIFY(merged.isBrickEmpty(0));
+    QCOMPARE(merged.getBrickVoxels(3), makeBrickVoxels(2));
+    QCOMPARE(merged.getBrickVoxels(5), makeBrickVoxels(3));
+
+    // a whole voxelData replaces what was there
+    QCOMPARE(PolyVoxBricks::mergeVoxelData(serverVoxelData, first.toVoxelData()), first.toVoxelData());
+}
+
+void PolyVoxBricksTests::mergeDeltaIntoResizedVolume() {
+    QByteArray voxels(16 * 16 * 16, (char)1);
+    QByteArray voxelData = makeLegacyVoxelData(16, 16, 16, voxels);
+
+    PolyVoxBricks resized(32, 16, 16);
+    resized.setBrickVoxels(1, makeBrickVoxels(4));
+    QByteArray merged = PolyVoxBricks::mergeVoxelData(voxelData, resized.toDeltaVoxelData({ 1 }));
+
+    PolyVoxBricks bricks;
+    QVERIFY(bricks.fromVoxelData(merged));
+    QVERIFY(bricks.hasSize(32, 16, 16));
+    QCOMPARE(bricks.getBrickVoxels(0), voxels);
+    QCOMPARE(bricks.getBrickVoxels(1), makeBrickVoxels(4));
+}
+
+void PolyVoxBricksTests::rejectMalformedData() {
+    PolyVoxBricks bricks;
+    QVERIFY(!bricks.fromVoxelData(QByteArray()));
+    QVERIFY(!bricks.fromVoxelData(QByteArray(4, '\0')));
+
+    // a delta isn't a whole volume
+    PolyVoxBricks source(16, 16, 16);
+    QByteArray delta = source.toDeltaVoxelData({ 0 });
+    QVERIFY(!bricks.fromVoxelData(delta));
+
+    // a run past the end of the brick
+    QByteArray encoded;
+    encoded.append((char)1);
+    encoded.append((char)(0x80 | 0x01));
+    encoded.append((char)0x40);
+    QByteArray decoded;
+    QVERIFY(!PolyVoxBricks::decodeBrick(encoded, decoded));
+
+    // a delta that can't be read leaves the voxel data alone
+    QByteArray voxelData = source.toVoxelData();
+    QByteArray truncatedDelta = delta.left(delta.size() - 4);
+    QCOMPARE(PolyVoxBricks::mergeVoxelData(voxelData, truncatedDelta), voxelData);
+}
@@ -0,0 +1,29 @@
+//
+//  PolyVoxBricksTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PolyVoxBricksTests_h
+#define hifi_PolyVoxBricksTests_h
+
+#include <QtTest/QtTest>
+
+class PolyVoxBricksTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void encodeDecodeBrick();
+    void emptyBricksTakeNoSpace();
+    void roundTripVoxelData();
+    void readLegacyVoxelData();
+    void mergeDelta();
+    void mergeDeltaIntoResizedVolume();
+    void rejectMalformedData();
+};
+
+#endif // hifi_PolyVoxBricksTests_h
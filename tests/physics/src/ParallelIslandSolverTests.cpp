@@ -0,0 +1,162 @@
+//
+//  ParallelIslandSolverTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ParallelIslandSolverTests.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <ThreadSafeDynamicsWorld.h>
+
+QTEST_MAIN(ParallelIslandSolverTests)
+
+const btScalar STEP = btScalar(1.0f / 60.0f);
+const btScalar BOX_HALF_EXTENT = 0.5f;
+
+// stacks of boxes standing on a static floor, each stack is its own simulation island
+class StackWorld {
+public:
+    StackWorld(int numStacks, int stackHeight, bool parallel) :
+        _dispatcher(&_collisionConfig),
+        _world(&_dispatcher, &_broadphase, &_solver, &_collisionConfig),
+        _boxShape(btVector3(BOX_HALF_EXTENT, BOX_HALF_EXTENT, BOX_HALF_EXTENT)),
+        _floorShape(btVector3(0.0f, 1.0f, 0.0f), 0.0f)
+    {
+        _world.setGravity(btVector3(0.0f, -9.8f, 0.0f));
+        _world.setParallelIslandSolving(parallel);
+        _isParallel = _world.isParallelIslandSolving();
+
+        addBody(&_floorShape, btVector3(0.0f, 0.0f, 0.0f), 0.0f);
+
+        // stacks are far enough apart to never touch, and the boxes are a little offset so the contacts aren't symmetric
+        int stacksPerRow = (int)ceilf(sqrtf((float)numStacks));
+        for (int i = 0; i < numStacks; ++i) {
+            btScalar x = 3.0f * (i % stacksPerRow);
+            btScalar z = 3.0f * (i / stacksPerRow);
+            for (int j = 0; j < stackHeight; ++j) {
+                btScalar offset = 0.05f * (btScalar)((i + j) % 3 - 1);
+                addBody(&_boxShape, btVector3(x + offset, BOX_HALF_EXTENT + 1.01f * j, z), 1.0f);
+            }
+        }
+    }
+
+    ~StackWorld() {
+        for (auto& body : _bodies) {
+            _world.removeRigidBody(body.get());
+        }
+    }
+
+    btRigidBody* addBody(btCollisionShape* shape, const btVector3& position, btScalar mass) {
+        btVector3 inertia(0.0f, 0.0f, 0.0f);
+        if (mass > 0.0f) {
+            shape->calculateLocalInertia(mass, inertia);
+        }
+        btRigidBody::btRigidBodyConstructionInfo info(mass, nullptr, shape, inertia);
+        info.m_startWorldTransform.setOrigin(position);
+        btRigidBody* body = new btRigidBody(info);
+        body->setActivationState(DISABLE_DEACTIVATION);
+        _world.addRigidBody(body);
+        _bodies.emplace_back(body);
+        return body;
+    }
+
+    void step(int numSteps) {
+        for (int i = 0; i < numSteps; ++i) {
+            _world.stepSimulationWithSubstepCallback(STEP, 1, STEP);
+        }
+    }
+
+    const std::vector<std::unique_ptr<btRigidBody>>& getBodies() const { return _bodies; }
+    bool isParallel() const { return _isParallel; }
+
+private:
+    btDefaultCollisionConfiguration _collisionConfig;
+    btCollisionDispatcher _dispatcher;
+    btDbvtBroadphase _broadphase;
+    btSequentialImpulseConstraintSolver _solver;
+    ThreadSafeDynamicsWorld _world;
+    btBoxShape _boxShape;
+    btStaticPlaneShape _floorShape;
+    std::vector<std::unique_ptr<btRigidBody>> _bodies;
+    bool _isParallel { false };
+};
+
+static btScalar maxPositionDifference(const StackWorld& a, const StackWorld& b) {
+    btScalar maxDifference = 0.0f;
+    for (size_t i = 0; i < a.getBodies().size(); ++i) {
+        btVector3 difference = a.getBodies()[i]->getWorldTransform().getOrigin() -
+            b.getBodies()[i]->getWorldTransform().getOrigin();
+        maxDifference = btMax(maxDifference, difference.length());
+    }
+    return maxDifference;
+}
+
+void ParallelIslandSolverTests::initTestCase() {
+    if (!ThreadSafeDynamicsWorld::supportsParallelIslandSolving()) {
+        QSKIP("Bullet was built without the thread-safe profiler, islands are always solved on one thread");
+    }
+}
+
+void ParallelIslandSolverTests::testMatchesSerialSolve() {
+    const int NUM_STACKS = 36;
+    const int STACK_HEIGHT = 6;
+    const int NUM_STEPS = 120;
+
+    StackWorld serial(NUM_STACKS, STACK_HEIGHT, false);
+    StackWorld parallel(NUM_STACKS, STACK_HEIGHT, true);
+    QVERIFY(parallel.isParallel());
+    serial.step(NUM_STEPS);
+    parallel.step(NUM_STEPS);
+
+    // islands don't share dynamic bodies, so solving them separately shouldn't change the result
+    QVERIFY(maxPositionDifference(serial, parallel) < 1.0e-4f);
+
+    // and the boxes should have landed rather than fallen through the floor
+    for (const auto& body : parallel.getBodies()) {
+        QVERIFY(body->getWorldTransform().getOrigin().getY() > 0.0f);
+    }
+}
+
+void ParallelIslandSolverTests::testSharedKinematicBody() {
+    const int NUM_STACKS = 16;
+    const int STACK_HEIGHT = 4;
+    const int NUM_STEPS = 60;
+
+    StackWorld serial(NUM_STACKS, STACK_HEIGHT, false);
+    StackWorld parallel(NUM_STACKS, STACK_HEIGHT, true);
+
+    // a kinematic slab that every stack rests on, its islands have to be solved on the same thread
+    btBoxShape slabShape(btVector3(50.0f, 0.1f, 50.0f));
+    for (StackWorld* world : { &serial, &parallel }) {
+        btRigidBody* slab = world->addBody(&slabShape, btVector3(0.0f, -0.05f, 0.0f), 0.0f);
+        slab->setCollisionFlags(slab->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+    }
+
+    QVERIFY(parallel.isParallel());
+    serial.step(NUM_STEPS);
+    parallel.step(NUM_STEPS);
+    QVERIFY(maxPositionDifference(serial, parallel) < 1.0e-4f);
+}
+
+void ParallelIslandSolverTests::benchmarkStacks() {
+    const int NUM_STACKS = 128;
+    const int STACK_HEIGHT = 8;
+    const int NUM_STEPS = 240;
+
+    for (bool parallel : { false, true }) {
+        StackWorld world(NUM_STACKS, STACK_HEIGHT, parallel);
+        QElapsedTimer timer;
+        timer.start();
+        world.step(NUM_STEPS);
+        qDebug() << (parallel ? "parallel" : "serial") << NUM_STACKS * STACK_HEIGHT << "bodies,"
+            << NUM_STEPS << "steps" << timer.elapsed() << "msecs";
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  ParallelIslandSolverTests.h
+//  tests/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParallelIslandSolverTests_h
+#define hifi_ParallelIslandSolverTests_h
+
+#include <QtTest/QtTest>
+
+class ParallelIslandSolverTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testMatchesSerialSolve();
+    void testSharedKinematicBody();
+    void benchmarkStacks();
+};
+
+#endif // hifi_ParallelIslandSolverTests_h
@@ -0,0 +1,126 @@
+//
+//  ServerSimulationTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ServerSimulationTests.h"
+
+#include <AddressManager.h>
+#include <EntityEditPacketSender.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <PhysicalEntitySimulation.h>
+#include <PhysicsEngine.h>
+#include <PhysicsHelpers.h>
+#include <ShapeManager.h>
+#include <SimulationOwner.h>
+
+QTEST_MAIN(ServerSimulationTests)
+
+// keeps the bids of the simulation rather than sending them to an entity-server
+class BidRecorder : public EntityEditPacketSender {
+public:
+    virtual void queueEditEntityMessage(PacketType type, EntityTreePointer entityTree,
+                                        EntityItemID entityItemID, const EntityItemProperties& properties) override {
+        if (properties.simulationOwnerChanged()) {
+            bidPriorities[entityItemID] = properties.getSimulationOwner().getPriority();
+        }
+    }
+
+    QHash<EntityItemID, quint8> bidPriorities;
+};
+
+void ServerSimulationTests::initTestCase() {
+    // the tree and the edit sender need a NodeList
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer);
+}
+
+void ServerSimulationTests::cleanupTestCase() {
+    DependencyManager::destroy<NodeList>();
+    DependencyManager::destroy<AddressManager>();
+}
+
+void ServerSimulationTests::testModelWithoutPointsAndPrimitive() {
+    // the pieces of the entity-server's physics thread
+    ShapeManager shapeManager;
+    ObjectMotionState::setShapeManager(&shapeManager);
+    Physics::setSessionUUID(QUuid::createUuid());
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsServer(true);
+    PhysicsEnginePointer physicsEngine(new PhysicsEngine(Vectors::ZERO));
+    physicsEngine->init();
+    PhysicalEntitySimulationPointer simulation(new PhysicalEntitySimulation());
+    BidRecorder bidRecorder;
+    simulation->init(tree, physicsEngine, &bidRecorder);
+    simulation->setVolunteerPriority(SERVER_SIMULATION_PRIORITY);
+    tree->setSimulation(simulation);
+
+    // a falling box
+    EntityItemProperties boxProperties;
+    boxProperties.setType(EntityTypes::Box);
+    boxProperties.setDimensions(glm::vec3(1.0f));
+    boxProperties.setDynamic(true);
+    boxProperties.setGravity(glm::vec3(0.0f, -9.8f, 0.0f));
+    boxProperties.setVelocity(glm::vec3(0.0f, -1.0f, 0.0f));
+    EntityItemID boxID(QUuid::createUuid());
+
+    // a model whose hulls are built from the points of its geometry, which the entity-server never downloads
+    EntityItemProperties modelProperties;
+    modelProperties.setType(EntityTypes::Model);
+    modelProperties.setModelURL("http://localhost/model.fbx");
+    modelProperties.setShapeType(SHAPE_TYPE_SIMPLE_COMPOUND);
+    modelProperties.setDimensions(glm::vec3(1.0f));
+    EntityItemID modelID(QUuid::createUuid());
+
+    EntityItemPointer box = tree->addEntity(boxID, boxProperties);
+    EntityItemPointer model = tree->addEntity(modelID, modelProperties);
+    QVERIFY(box && model);
+
+    // the box goes into physics, and the model is left out rather than cooked or retried
+    VectorOfMotionStates motionStates;
+    tree->withReadLock([&] {
+        simulation->getObjectsToAddToPhysics(motionStates);
+        physicsEngine->addObjects(motionStates);
+    });
+    QCOMPARE((int)motionStates.size(), 1);
+    QVERIFY(box->getPhysicsInfo() != nullptr);
+    QVERIFY(model->getPhysicsInfo() == nullptr);
+    QCOMPARE(shapeManager.getNumCookingShapes(), 0);
+    tree->withReadLock([&] {
+        simulation->getObjectsToAddToPhysics(motionStates);
+    });
+    QVERIFY(motionStates.empty());
+
+    // step until the box has moved, the engine steps by the time that has passed since its last step
+    glm::vec3 startPosition = box->getPosition();
+    const int MAX_TICKS = 100;
+    for (int i = 0; i < MAX_TICKS && bidRecorder.bidPriorities.isEmpty(); ++i) {
+        QTest::qSleep((int)(PHYSICS_ENGINE_FIXED_SUBSTEP * MSECS_PER_SECOND) + 1);
+        tree->withWriteLock([&] {
+            physicsEngine->stepSimulation();
+            if (physicsEngine->hasOutgoingChanges()) {
+                simulation->handleChangedMotionStates(physicsEngine->getChangedMotionStates());
+            }
+        });
+    }
+    QVERIFY(box->getPosition().y < startPosition.y);
+
+    // the server bids for the box at its own priority, and for nothing else
+    QCOMPARE(bidRecorder.bidPriorities.size(), 1);
+    QVERIFY(bidRecorder.bidPriorities.contains(boxID));
+    QCOMPARE(bidRecorder.bidPriorities[boxID], SERVER_SIMULATION_PRIORITY);
+
+    // take the objects out of physics before the ShapeManager goes away
+    tree->setSimulation(nullptr);
+    QCOMPARE(physicsEngine->getNumCollisionObjects(), 0);
+}
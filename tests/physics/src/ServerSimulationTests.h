@@ -0,0 +1,25 @@
+//
+//  ServerSimulationTests.h
+//  tests/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ServerSimulationTests_h
+#define hifi_ServerSimulationTests_h
+
+#include <QtTest/QtTest>
+
+class ServerSimulationTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testModelWithoutPointsAndPrimitive();
+};
+
+#endif // hifi_ServerSimulationTests_h
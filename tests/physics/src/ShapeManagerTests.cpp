@@ -10,6 +10,8 @@
 //
 
 #include <iostream>
+#include <CookedShapeCache.h>
+#include <ShapeFactory.h>
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 #include <Extents.h>
@@ -185,7 +187,7 @@ void ShapeManagerTests::addCapsuleShape() {
     */
 }
 
-void ShapeManagerTests::addCompoundShape() {
+static ShapeInfo makeCompoundInfo(int numHulls) {
     // initialize some points for generating tetrahedral convex hulls
     QVector<glm::vec3> tetrahedron;
     tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
@@ -196,7 +198,6 @@ void ShapeManagerTests::addCompoundShape() {
 
     // compute the points of the hulls
     ShapeInfo::PointCollection pointCollection;
-    int numHulls = 5;
     glm::vec3 offsetNormal(1.0f, 0.0f, 0.0f);
     Extents extents;
     for (int i = 0; i < numHulls; ++i) {
@@ -216,6 +217,12 @@ void ShapeManagerTests::addCompoundShape() {
     glm::vec3 halfExtents = 0.5f * (extents.maximum - extents.minimum);
     info.setParams(SHAPE_TYPE_COMPOUND, halfExtents);
     info.setPointCollection(pointCollection);
+    return info;
+}
+
+void ShapeManagerTests::addCompoundShape() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundInfo(numHulls);
 
     // create the shape
     ShapeManager shapeManager;
@@ -243,3 +250,123 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+void ShapeManagerTests::addCompoundShapeAsync() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundInfo(numHulls);
+
+    // the first request starts cooking the shape
+    ShapeManager shapeManager;
+    QVERIFY(shapeManager.getShapeAsync(info) == nullptr);
+    QCOMPARE(shapeManager.getNumCookingShapes(), 1);
+
+    // the cooked shape is held for whoever asked for it to pick up
+    shapeManager.waitForCookedShapes();
+    QCOMPARE(shapeManager.getNumCookingShapes(), 0);
+    QCOMPARE(shapeManager.getNumCookedShapes(), 1);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+
+    // and garbage collection leaves it alone until it is picked up
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumCookedShapes(), 1);
+
+    const btCollisionShape* shape = shapeManager.getShapeAsync(info);
+    QVERIFY(shape != nullptr);
+    QCOMPARE(shapeManager.getNumCookedShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), numHulls);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+
+    // release the shape
+    shapeManager.releaseShape(shape);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::unclaimedCookedShape() {
+    ShapeInfo info = makeCompoundInfo(5);
+
+    // a shape that is cooked for an object that goes away before it picks the shape up
+    ShapeManager shapeManager;
+    QVERIFY(shapeManager.getShapeAsync(info) == nullptr);
+    shapeManager.waitForCookedShapes();
+    QCOMPARE(shapeManager.getNumCookedShapes(), 1);
+
+    // survives one garbage collection, and is deleted by the next
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumCookedShapes(), 1);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumCookedShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+
+    // asking for it again cooks it again
+    QVERIFY(shapeManager.getShapeAsync(info) == nullptr);
+    QCOMPARE(shapeManager.getNumCookingShapes(), 1);
+    shapeManager.waitForCookedShapes();
+}
+
+void ShapeManagerTests::failedCookedShape() {
+    // a simple compound without any triangles can't be built
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_SIMPLE_COMPOUND, glm::vec3(1.0f));
+
+    ShapeManager shapeManager;
+    QVERIFY(shapeManager.getShapeAsync(info) == nullptr);
+    shapeManager.waitForCookedShapes();
+    QVERIFY(shapeManager.hasFailedToCook(info));
+
+    // asking again doesn't cook it again
+    QVERIFY(shapeManager.getShapeAsync(info) == nullptr);
+    QCOMPARE(shapeManager.getNumCookingShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::cookedShapeRoundTrip() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundInfo(numHulls);
+
+    ShapeManager shapeManager;
+    const btCollisionShape* shape = shapeManager.getShape(info);
+    QVERIFY(shape != nullptr);
+
+    QByteArray cooked = CookedShapeCache::writeCookedShape(shape);
+    QVERIFY(!cooked.isEmpty());
+
+    btCollisionShape* readShape = CookedShapeCache::readCookedShape(cooked);
+    QVERIFY(readShape != nullptr);
+    QCOMPARE(readShape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+
+    // the hulls come back with the same points and bounds
+    const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+    const btCompoundShape* readCompound = static_cast<const btCompoundShape*>(readShape);
+    QCOMPARE(readCompound->getNumChildShapes(), numHulls);
+    for (int i = 0; i < numHulls; ++i) {
+        const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(compound->getChildShape(i));
+        const btConvexHullShape* readHull = static_cast<const btConvexHullShape*>(readCompound->getChildShape(i));
+        QCOMPARE(readHull->getNumPoints(), hull->getNumPoints());
+        QCOMPARE(readHull->getMargin(), hull->getMargin());
+        for (int j = 0; j < hull->getNumPoints(); ++j) {
+            QVERIFY(readHull->getScaledPoint(j) == hull->getScaledPoint(j));
+        }
+    }
+
+    btVector3 minCorner, maxCorner, readMinCorner, readMaxCorner;
+    btTransform identity;
+    identity.setIdentity();
+    shape->getAabb(identity, minCorner, maxCorner);
+    readShape->getAabb(identity, readMinCorner, readMaxCorner);
+    QVERIFY((readMinCorner - minCorner).length() < 1.0e-5f);
+    QVERIFY((readMaxCorner - maxCorner).length() < 1.0e-5f);
+
+    // anything that isn't made of hulls isn't cooked
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    const btCollisionShape* box = shapeManager.getShape(boxInfo);
+    QVERIFY(CookedShapeCache::writeCookedShape(box).isEmpty());
+    QVERIFY(CookedShapeCache::readCookedShape(QByteArray()) == nullptr);
+
+    ShapeFactory::deleteShape(readShape);
+    shapeManager.releaseShape(shape);
+    shapeManager.releaseShape(box);
+}
@@ -25,6 +25,10 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void addCompoundShapeAsync();
+    void unclaimedCookedShape();
+    void failedCookedShape();
+    void cookedShapeRoundTrip();
 };
 
 #endif // hifi_ShapeManagerTests_h
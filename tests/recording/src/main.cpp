@@ -2,13 +2,22 @@
 #include <QtTest/QtTest>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QString>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
 
 #ifdef Q_OS_WIN32
 #include <Windows.h>
 #endif
 
 #include <recording/Clip.h>
+#include <recording/Ensemble.h>
 #include <recording/Frame.h>
+#include <recording/FrameCodec.h>
+
+#include <AvatarData.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "Constants.h"
 
@@ -97,6 +106,330 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+// frame data that changes a little from one frame to the next, like a moving avatar's
+QByteArray makeSlowlyChangingData(int frameIndex) {
+    const int DATA_SIZE = 1024;
+    QByteArray data(DATA_SIZE, 0);
+    for (int i = 0; i < DATA_SIZE; ++i) {
+        data[i] = (char)((i * 7) + (i % 16 == 0 ? frameIndex : 0));
+    }
+    return data;
+}
+
+void testFrameCodec() {
+    const int NUM_FRAMES = FrameCodec::KEY_FRAME_INTERVAL * 3 + 10;
+
+    FrameCodec codec;
+    int numDeltaFrames = 0;
+    QByteArray previousData;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        Frame frame(TEST_FRAME_TYPE, 0.0f, makeSlowlyChangingData(i));
+        QByteArray stored = codec.encode(frame);
+        int encoding = FrameCodec::readEncoding(stored.constData(), stored.size());
+        QVERIFY(encoding == FrameCodec::KEY_FRAME || encoding == FrameCodec::DELTA_FRAME);
+        if (encoding == FrameCodec::DELTA_FRAME) {
+            ++numDeltaFrames;
+        }
+        QVERIFY(FrameCodec::decode(stored, previousData) == frame.data);
+        previousData = frame.data;
+    }
+    // one key frame per interval
+    int numKeyFrames = (NUM_FRAMES + FrameCodec::KEY_FRAME_INTERVAL - 1) / FrameCodec::KEY_FRAME_INTERVAL;
+    QVERIFY(numDeltaFrames == NUM_FRAMES - numKeyFrames);
+
+    // the clip reads back the same frames, in order and after seeking
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+    // one frame per millisecond, the Frame constructor takes the time offset as a Frame::Time
+    auto writeClip = Clip::newClip();
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)i, makeSlowlyChangingData(i)));
+    }
+    Clip::toFile(fileName, writeClip);
+    QVERIFY(QFileInfo(fileName).size() < NUM_FRAMES * makeSlowlyChangingData(0).size() / 4);
+
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == (size_t)NUM_FRAMES);
+    readClip->seek(0);
+    int frameIndex = 0;
+    for (auto frame = readClip->nextFrame(); frame; frame = readClip->nextFrame(), ++frameIndex) {
+        QVERIFY(frame->data == makeSlowlyChangingData(frameIndex));
+    }
+    QVERIFY(frameIndex == NUM_FRAMES);
+
+    const int SEEK_FRAMES[] = { NUM_FRAMES - 1, FrameCodec::KEY_FRAME_INTERVAL + 5, 3, FrameCodec::KEY_FRAME_INTERVAL };
+    for (int seekFrame : SEEK_FRAMES) {
+        readClip->seekFrameTime((Frame::Time)seekFrame);
+        auto frame = readClip->nextFrame();
+        QVERIFY(frame);
+        QVERIFY(frame->data == makeSlowlyChangingData(seekFrame));
+    }
+
+    // and so does a copy
+    auto copy = readClip->duplicate();
+    copy->seek(0);
+    QVERIFY(copy->nextFrame()->data == makeSlowlyChangingData(0));
+}
+
+const int NUM_BENCHMARK_JOINTS = 80;
+
+void poseBenchmarkAvatar(AvatarData& avatar, int frameIndex) {
+    QVector<JointData> joints(NUM_BENCHMARK_JOINTS);
+    for (int i = 0; i < NUM_BENCHMARK_JOINTS; ++i) {
+        float angle = 0.01f * (float)(frameIndex * (i % 5));
+        joints[i].rotation = glm::angleAxis(angle, glm::normalize(glm::vec3(1.0f, (float)i, 0.5f)));
+        joints[i].rotationSet = true;
+        joints[i].translation = glm::vec3(0.0f, 0.1f + 0.001f * i, 0.0f);
+        joints[i].translationSet = true;
+    }
+    avatar.setRawJointData(joints);
+    avatar.setPosition(glm::vec3(0.01f * frameIndex, 0.0f, 1.0f));
+}
+
+void testAvatarFrames() {
+    AvatarData avatar;
+    avatar.setDisplayName("recorder");
+    poseBenchmarkAvatar(avatar, 10);
+
+    QByteArray legacyFrame = QJsonDocument(avatar.toJson()).toBinaryData();
+    QByteArray frame = AvatarData::toFrame(avatar);
+    QVERIFY(AvatarData::isBinaryFrame(frame));
+    QVERIFY(!AvatarData::isBinaryFrame(legacyFrame));
+    QVERIFY(frame.size() < legacyFrame.size() / 4);
+
+    // old and new frames play back the same, to within the quantization of the joints
+    AvatarData legacyPlayback;
+    AvatarData::fromFrame(legacyFrame, legacyPlayback);
+    AvatarData playback;
+    AvatarData::fromFrame(frame, playback);
+    QVERIFY(playback.getDisplayName() == "recorder");
+    QVERIFY(glm::distance(playback.getPosition(), legacyPlayback.getPosition()) < 0.001f);
+    auto legacyJoints = legacyPlayback.getRawJointData();
+    auto joints = playback.getRawJointData();
+    QVERIFY(joints.size() == NUM_BENCHMARK_JOINTS && legacyJoints.size() == NUM_BENCHMARK_JOINTS);
+    for (int i = 0; i < NUM_BENCHMARK_JOINTS; ++i) {
+        QVERIFY(std::abs(glm::dot(joints[i].rotation, legacyJoints[i].rotation)) > 0.9999f);
+        QVERIFY(glm::distance(joints[i].translation, legacyJoints[i].translation) < 0.001f);
+    }
+
+    QByteArray convertedFrame = AvatarData::convertLegacyFrame(legacyFrame);
+    QVERIFY(AvatarData::isBinaryFrame(convertedFrame));
+    QVERIFY(convertedFrame.size() == frame.size());
+}
+
+void benchmarkAvatarFrameDecode() {
+    const int NUM_FRAMES = 900; // 10 seconds at 90 Hz
+
+    AvatarData avatar;
+    QVector<QByteArray> legacyFrames;
+    QVector<QByteArray> frames;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        poseBenchmarkAvatar(avatar, i);
+        legacyFrames.push_back(QJsonDocument(avatar.toJson()).toBinaryData());
+        frames.push_back(AvatarData::toFrame(avatar));
+    }
+
+    AvatarData playback;
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto& frame : legacyFrames) {
+        AvatarData::fromFrame(frame, playback);
+    }
+    qint64 legacyNsecs = timer.nsecsElapsed();
+    timer.restart();
+    for (const auto& frame : frames) {
+        AvatarData::fromFrame(frame, playback);
+    }
+    qint64 nsecs = timer.nsecsElapsed();
+
+    qDebug() << "avatar frame decode, usecs per frame: json" << legacyNsecs / (NUM_FRAMES * 1000)
+        << "binary" << nsecs / (NUM_FRAMES * 1000);
+
+    // the size of the same performance recorded both ways
+    FrameType avatarFrameType = Frame::registerFrameType(AvatarData::FRAME_NAME);
+    auto legacyClip = Clip::newClip();
+    auto clip = Clip::newClip();
+    int legacyBytes = 0;
+    int bytes = 0;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        float timeOffset = (float)Frame::secondsToFrameTime((float)i / 90.0f);
+        legacyBytes += legacyFrames[i].size();
+        bytes += frames[i].size();
+        legacyClip->addFrame(std::make_shared<Frame>(avatarFrameType, timeOffset, legacyFrames[i]));
+        clip->addFrame(std::make_shared<Frame>(avatarFrameType, timeOffset, frames[i]));
+    }
+    qDebug() << "avatar frame bytes: json" << legacyBytes << "binary" << bytes
+        << "json clip" << Clip::toBuffer(legacyClip).size() << "binary clip" << Clip::toBuffer(clip).size();
+
+    // decoding the stored frames of a clip file while playing it back
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+    Clip::toFile(fileName, clip);
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    readClip->seek(0);
+    timer.restart();
+    for (auto frame = readClip->nextFrame(); frame; frame = readClip->nextFrame()) {
+        AvatarData::fromFrame(frame->data, playback);
+    }
+    qint64 clipNsecs = timer.nsecsElapsed();
+    qDebug() << "clip playback, usecs per frame:" << clipNsecs / (NUM_FRAMES * 1000);
+}
+
+void testEnsemble() {
+    // ten frames, 10 msecs apart
+    auto clip = Clip::newClip();
+    for (int i = 0; i < 10; ++i) {
+        clip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * 10), QByteArray(1, (char)i)));
+    }
+
+    DependencyManager::set<Ensemble>();
+    auto ensemble = DependencyManager::get<Ensemble>();
+    auto timeline = ensemble->getTimeline(clip);
+    QVERIFY(timeline);
+    QVERIFY(timeline == ensemble->getTimeline(clip));
+    QVERIFY(timeline->frameCount() == 10);
+    QVERIFY(timeline->length() == 90);
+    QVERIFY(timeline->findFrame(45) == 5);
+
+    // half the actors start halfway into the clip
+    const int NUM_ACTORS = 200;
+    std::vector<int> lastFrames(NUM_ACTORS, -1);
+    std::vector<int> numFrames(NUM_ACTORS, 0);
+    for (int i = 0; i < NUM_ACTORS; ++i) {
+        float timeOffset = (i % 2) ? 0.05f : 0.0f;
+        ensemble->addActor(timeline, [&, i](const FrameConstPointer& frame, const Transform& basis) {
+            lastFrames[i] = frame->data[0];
+            ++numFrames[i];
+        }, Transform(), timeOffset, false);
+    }
+    QVERIFY(ensemble->getNumActors() == NUM_ACTORS);
+
+    quint64 start = usecTimestampNow();
+    ensemble->update(start);
+    QVERIFY(numFrames[0] == 1 && numFrames[1] == 1);
+    QVERIFY(lastFrames[0] == 0 && lastFrames[1] == 5);
+
+    // actors that don't loop leave once they're done
+    ensemble->update(start + USECS_PER_SECOND);
+    QVERIFY(ensemble->getNumActors() == 0);
+    for (int i = 0; i < NUM_ACTORS; ++i) {
+        QVERIFY(lastFrames[i] == 9);
+        QVERIFY(numFrames[i] == ((i % 2) ? 5 : 10));
+    }
+
+    // looping actors go around again, and can remove themselves
+    int numLoopedFrames = 0;
+    auto countFrame = [&](const FrameConstPointer& frame, const Transform& basis) {
+        ++numLoopedFrames;
+    };
+    Ensemble::ActorID looper = ensemble->addActor(timeline, countFrame);
+    Ensemble::ActorID quitter = Ensemble::INVALID_ACTOR;
+    quitter = ensemble->addActor(timeline, [&](const FrameConstPointer& frame, const Transform& basis) {
+        ensemble->removeActor(quitter);
+    });
+    start = usecTimestampNow();
+    ensemble->update(start + USECS_PER_SECOND);
+    QVERIFY(numLoopedFrames > 10);
+    QVERIFY(ensemble->hasActor(looper));
+    QVERIFY(!ensemble->hasActor(quitter));
+    ensemble->removeActor(looper);
+    QVERIFY(ensemble->getNumActors() == 0);
+
+    // actors are told when they reach the end, whether they start over or leave
+    int numLoops = 0;
+    int numEnds = 0;
+    auto ignoreFrame = [](const FrameConstPointer& frame, const Transform& basis) {};
+    Ensemble::ActorID repeater = ensemble->addActor(timeline, ignoreFrame, Transform(), 0.0f, true, [&](bool looped) {
+        numLoops += looped ? 1 : 0;
+        numEnds += looped ? 0 : 1;
+    });
+    ensemble->addActor(timeline, ignoreFrame, Transform(), 0.0f, false, [&](bool looped) {
+        QVERIFY(!looped);
+        ++numEnds;
+    });
+    start = usecTimestampNow();
+    ensemble->update(start + USECS_PER_SECOND);
+    QVERIFY(numLoops > 1);
+    QVERIFY(numEnds == 1);
+    QVERIFY(ensemble->getNumActors() == 1);
+    ensemble->setActorLooping(repeater, false);
+    ensemble->update(start + 2 * USECS_PER_SECOND);
+    QVERIFY(ensemble->getNumActors() == 0);
+    QVERIFY(numEnds == 2);
+
+    DependencyManager::destroy<Ensemble>();
+}
+
+void benchmarkEnsemblePlayback() {
+    const int NUM_FRAMES = 900;
+    const int NUM_ACTORS = 50;
+    const quint64 FRAME_USECS = USECS_PER_SECOND / 90;
+
+    AvatarData recordedAvatar;
+    FrameType avatarFrameType = Frame::registerFrameType(AvatarData::FRAME_NAME);
+    auto clip = Clip::newClip();
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        poseBenchmarkAvatar(recordedAvatar, i);
+        float timeOffset = (float)Frame::secondsToFrameTime((float)i / 90.0f);
+        clip->addFrame(std::make_shared<Frame>(avatarFrameType, timeOffset, AvatarData::toFrame(recordedAvatar)));
+    }
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+    Clip::toFile(fileName, clip);
+    std::vector<std::unique_ptr<AvatarData>> avatars;
+    for (int i = 0; i < NUM_ACTORS; ++i) {
+        avatars.emplace_back(new AvatarData());
+    }
+
+    // every actor with a clip of its own, as with a Deck per actor
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_ACTORS; ++i) {
+        auto actorClip = Clip::fromFile(fileName);
+        actorClip->seek(0);
+        for (auto frame = actorClip->nextFrame(); frame; frame = actorClip->nextFrame()) {
+            AvatarData::fromFrame(frame->data, *avatars[i]);
+        }
+    }
+    qint64 clipsNsecs = timer.nsecsElapsed();
+
+    // all of them sharing one timeline
+    timer.restart();
+    DependencyManager::set<Ensemble>();
+    auto ensemble = DependencyManager::get<Ensemble>();
+    auto timeline = ensemble->getTimeline(Clip::fromFile(fileName));
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < NUM_ACTORS; ++i) {
+        AvatarData* avatar = avatars[i].get();
+        ensemble->addActor(timeline, [avatar](const FrameConstPointer& frame, const Transform& basis) {
+            AvatarData::fromFrame(frame->data, *avatar);
+        }, Transform(), 0.0f, false);
+    }
+    for (quint64 now = start; ensemble->getNumActors() > 0; now += FRAME_USECS) {
+        ensemble->update(now);
+    }
+    qint64 ensembleNsecs = timer.nsecsElapsed();
+    QVERIFY(ensemble->getNumFramesHandled() == (uint64_t)(NUM_FRAMES * NUM_ACTORS));
+    DependencyManager::destroy<Ensemble>();
+
+    qDebug() << NUM_ACTORS << "actors playing" << NUM_FRAMES << "avatar frames, msecs: clip per actor"
+        << clipsNsecs / NSECS_PER_MSEC << "shared timeline" << ensembleNsecs / NSECS_PER_MSEC;
+}
+
 #ifdef Q_OS_WIN32
 void myMessageHandler(QtMsgType type, const QMessageLogContext & context, const QString & msg) {
     OutputDebugStringA(msg.toLocal8Bit().toStdString().c_str());
@@ -111,4 +444,9 @@ int main(int, const char**) {
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testFrameCodec();
+    testAvatarFrames();
+    benchmarkAvatarFrameDecode();
+    testEnsemble();
+    benchmarkEnsemblePlayback();
 }
\ No newline at end of file
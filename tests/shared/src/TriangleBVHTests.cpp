@@ -0,0 +1,218 @@
+//
+//  TriangleBVHTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleBVHTests.h"
+
+#include <cfloat>
+#include <random>
+
+#include <NumericalConstants.h>
+#include <TriangleBVH.h>
+#include <TriangleSet.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(TriangleBVHTests)
+
+static std::vector<Triangle> makeSingleTriangle() {
+    Triangle triangle = { glm::vec3(-1.0f, -1.0f, 1.0f), glm::vec3(1.0f, -1.0f, 1.0f), glm::vec3(0.0f, 1.0f, 1.0f) };
+    return std::vector<Triangle>(1, triangle);
+}
+
+static std::vector<Triangle> makeTriangleSoup(int numTriangles, std::mt19937& generator) {
+    std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> edge(-1.0f, 1.0f);
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < numTriangles; i++) {
+        glm::vec3 v0(position(generator), position(generator), position(generator));
+        glm::vec3 v1 = v0 + glm::vec3(edge(generator), edge(generator), edge(generator));
+        glm::vec3 v2 = v0 + glm::vec3(edge(generator), edge(generator), edge(generator));
+        triangles.push_back({ v0, v1, v2 });
+    }
+    return triangles;
+}
+
+// a closed, outward facing, finely tessellated sphere, like a typical model
+static std::vector<Triangle> makeSphere(int rings, int segments, float radius) {
+    auto vertex = [&](int ring, int segment) {
+        float theta = PI * ring / rings;
+        float phi = TWO_PI * segment / segments;
+        return radius * glm::vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+    };
+
+    std::vector<Triangle> triangles;
+    for (int ring = 0; ring < rings; ring++) {
+        for (int segment = 0; segment < segments; segment++) {
+            glm::vec3 v00 = vertex(ring, segment);
+            glm::vec3 v01 = vertex(ring, segment + 1);
+            glm::vec3 v10 = vertex(ring + 1, segment);
+            glm::vec3 v11 = vertex(ring + 1, segment + 1);
+            triangles.push_back({ v00, v01, v11 });
+            triangles.push_back({ v00, v11, v10 });
+        }
+    }
+    return triangles;
+}
+
+static bool findClosestTriangle(const std::vector<Triangle>& triangles, const glm::vec3& origin,
+                                const glm::vec3& direction, float& distance) {
+    bool intersects = false;
+    distance = FLT_MAX;
+    for (const auto& triangle : triangles) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangle, triangleDistance) && triangleDistance < distance) {
+            distance = triangleDistance;
+            intersects = true;
+        }
+    }
+    return intersects;
+}
+
+void TriangleBVHTests::testEmptyAndSmallSets() {
+    float distance;
+    BoxFace face;
+    glm::vec3 normal;
+
+    TriangleBVH empty;
+    QCOMPARE(empty.findRayIntersection(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), distance, face, normal, true), false);
+    QCOMPARE(empty.convexHullContains(glm::vec3(0.0f)), false);
+
+    // a single triangle facing +z
+    TriangleBVH single(makeSingleTriangle());
+    QCOMPARE(single.size(), (size_t)1);
+
+    QCOMPARE(single.findRayIntersection(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, -1.0f), distance, face, normal, true), true);
+    QCOMPARE_WITH_ABS_ERROR(distance, 2.0f, EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(normal, glm::vec3(0.0f, 0.0f, 1.0f), EPSILON);
+
+    // missing to the side, and pointing away
+    QCOMPARE(single.findRayIntersection(glm::vec3(5.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, -1.0f), distance, face, normal, true), false);
+    QCOMPARE(single.findRayIntersection(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, 1.0f), distance, face, normal, true), false);
+
+    // without precision only the bounds are tested
+    QCOMPARE(single.findRayIntersection(glm::vec3(0.9f, 0.9f, 3.0f), glm::vec3(0.0f, 0.0f, -1.0f), distance, face, normal, false), true);
+    QCOMPARE(single.findRayIntersection(glm::vec3(0.9f, 0.9f, 3.0f), glm::vec3(0.0f, 0.0f, -1.0f), distance, face, normal, true), false);
+}
+
+void TriangleBVHTests::testBackfaces() {
+    TriangleBVH single(makeSingleTriangle());
+
+    float distance;
+    BoxFace face;
+    glm::vec3 normal;
+
+    // from behind the triangle
+    QCOMPARE(single.findRayIntersection(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, 1.0f), distance, face, normal, true, false), false);
+    QCOMPARE(single.findRayIntersection(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, 1.0f), distance, face, normal, true, true), true);
+    QCOMPARE_WITH_ABS_ERROR(distance, 2.0f, EPSILON);
+}
+
+void TriangleBVHTests::testMatchesBruteForce() {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+
+    const int NUM_RAYS = 1000;
+    for (int numTriangles : { 1, 3, 5, 17, 1000, 20000 }) {
+        std::vector<Triangle> triangles = makeTriangleSoup(numTriangles, generator);
+        TriangleBVH bvh(triangles);
+        QCOMPARE(bvh.size(), (size_t)numTriangles);
+
+        for (int i = 0; i < NUM_RAYS; i++) {
+            // aim near the middle of the soup, so most rays hit something
+            glm::vec3 origin(position(generator), position(generator), position(generator));
+            glm::vec3 target(offset(generator), offset(generator), offset(generator));
+            glm::vec3 direction = glm::normalize(target - origin);
+
+            float expectedDistance;
+            bool expected = findClosestTriangle(triangles, origin, direction, expectedDistance);
+
+            float distance;
+            BoxFace face;
+            glm::vec3 normal;
+            bool intersects = bvh.findRayIntersection(origin, direction, distance, face, normal, true);
+
+            QCOMPARE(intersects, expected);
+            if (expected) {
+                QCOMPARE_WITH_ABS_ERROR(distance, expectedDistance, 0.001f);
+            }
+        }
+    }
+}
+
+void TriangleBVHTests::testConvexHullContains() {
+    TriangleBVH sphere(makeSphere(16, 32, 1.0f));
+
+    QCOMPARE(sphere.convexHullContains(glm::vec3(0.0f)), true);
+    QCOMPARE(sphere.convexHullContains(glm::vec3(0.5f, 0.2f, -0.3f)), true);
+    QCOMPARE(sphere.convexHullContains(glm::vec3(0.9f, 0.9f, 0.0f)), false);
+    QCOMPARE(sphere.convexHullContains(glm::vec3(2.0f, 0.0f, 0.0f)), false);
+}
+
+void TriangleBVHTests::benchmarkPicking() {
+    // about the size of a detailed avatar or building
+    std::vector<Triangle> triangles = makeSphere(256, 512, 1.0f);
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<float> position(-0.3f, 0.3f);
+
+    // every ray hits the front of the sphere
+    const int NUM_RAYS = 10000;
+    std::vector<glm::vec3> origins;
+    std::vector<glm::vec3> directions;
+    for (int i = 0; i < NUM_RAYS; i++) {
+        origins.push_back(glm::vec3(position(generator), position(generator), 5.0f));
+        directions.push_back(glm::normalize(glm::vec3(position(generator), position(generator), -5.0f)));
+    }
+
+    float distance;
+    BoxFace face;
+    glm::vec3 normal;
+
+    int setHits = 0;
+    {
+        QElapsedTimer timer;
+        timer.start();
+        TriangleSet set;
+        set.reserve(triangles.size());
+        for (const auto& triangle : triangles) {
+            set.insert(triangle);
+        }
+        set.balanceOctree();
+        qint64 buildTime = timer.elapsed();
+
+        timer.start();
+        for (int i = 0; i < NUM_RAYS; i++) {
+            setHits += set.findRayIntersection(origins[i], directions[i], distance, face, normal, true) ? 1 : 0;
+        }
+        qDebug() << "TriangleSet" << triangles.size() << "triangles, build" << buildTime << "msecs,"
+            << NUM_RAYS << "picks" << timer.elapsed() << "msecs";
+    }
+
+    int bvhHits = 0;
+    {
+        QElapsedTimer timer;
+        timer.start();
+        TriangleBVH bvh(triangles);
+        qint64 buildTime = timer.elapsed();
+
+        timer.start();
+        int trianglesTouched = 0;
+        for (int i = 0; i < NUM_RAYS; i++) {
+            bvhHits += bvh.findRayIntersection(origins[i], directions[i], distance, face, normal, true, false, trianglesTouched) ? 1 : 0;
+        }
+        qDebug() << "TriangleBVH" << triangles.size() << "triangles, build" << buildTime << "msecs,"
+            << NUM_RAYS << "picks" << timer.elapsed() << "msecs," << (float)trianglesTouched / NUM_RAYS << "triangles per pick";
+    }
+
+    QCOMPARE(bvhHits, NUM_RAYS);
+    QCOMPARE(bvhHits, setHits);
+}
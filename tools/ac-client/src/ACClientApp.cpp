@@ -19,6 +19,7 @@
 #include <AddressManager.h>
 #include <DependencyManager.h>
 #include <SettingHandle.h>
+#include <udt/NetworkImpairment.h>
 
 #include "ACClientApp.h"
 
@@ -46,6 +47,10 @@ ACClientApp::ACClientApp(int argc, char* argv[]) :
     const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
     parser.addOption(listenPortOption);
 
+    const QCommandLineOption networkImpairmentOption(udt::NETWORK_IMPAIRMENT_OPTION,
+                                                     udt::NETWORK_IMPAIRMENT_OPTION_DESCRIPTION, "settings");
+    parser.addOption(networkImpairmentOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -97,6 +102,16 @@ ACClientApp::ACClientApp(int argc, char* argv[]) :
         _password = pieces[1];
     }
 
+    if (parser.isSet(networkImpairmentOption)) {
+        udt::NetworkImpairment::Settings impairmentSettings;
+        if (!udt::NetworkImpairment::parseSettings(parser.value(networkImpairmentOption), impairmentSettings)) {
+            qDebug() << "--" + udt::NETWORK_IMPAIRMENT_OPTION << "could not be parsed";
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+        udt::NetworkImpairment::setDefaultSettings(impairmentSettings);
+    }
+
     Setting::init();
     DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
 
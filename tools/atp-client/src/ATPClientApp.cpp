@@ -24,6 +24,7 @@
 #include <SettingHandle.h>
 #include <AssetUpload.h>
 #include <StatTracker.h>
+#include <shared/GlobalAppProperties.h>
 
 #include "ATPClientApp.h"
 
@@ -57,6 +58,15 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
     const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
     parser.addOption(listenPortOption);
 
+    const QCommandLineOption peerAssistOption("peer-assist", "fetch assets from the agents that hold them, and share them");
+    parser.addOption(peerAssistOption);
+
+    const QCommandLineOption seedOption("seed", "keep sharing what was fetched for a while after", "seconds");
+    parser.addOption(seedOption);
+
+    const QCommandLineOption cacheOption("cache", "asset cache directory, one each for clients on the same machine", "dir");
+    parser.addOption(cacheOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -125,6 +135,17 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
         _listenPort = parser.value(listenPortOption).toInt();
     }
 
+    _peerAssist = parser.isSet(peerAssistOption);
+
+    if (parser.isSet(seedOption)) {
+        _seedSeconds = parser.value(seedOption).toInt();
+    }
+
+    if (parser.isSet(cacheOption)) {
+        // read by the AssetClient when it is made
+        setProperty(hifi::properties::APP_LOCAL_DATA_PATH, parser.value(cacheOption));
+    }
+
     _domainServerAddress = QString("127.0.0.1") + ":" + QString::number(domainPort);
     if (parser.isSet(domainAddressOption)) {
         _domainServerAddress = parser.value(domainAddressOption);
@@ -199,6 +220,7 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
 
     auto assetClient = DependencyManager::set<AssetClient>();
     assetClient->init();
+    assetClient->setPeerAssistEnabled(_peerAssist);
 
     if (_verbose) {
         qDebug() << "domain-server address is" << _domainServerAddress;
@@ -206,7 +228,7 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
 
     DependencyManager::get<AddressManager>()->handleLookupString(_domainServerAddress, false);
 
-    QTimer* _timeoutTimer = new QTimer(this);
+    _timeoutTimer = new QTimer(this);
     _timeoutTimer->setSingleShot(true);
     connect(_timeoutTimer, &QTimer::timeout, this, &ATPClientApp::timedOut);
     _timeoutTimer->start(TIMEOUT_MILLISECONDS);
@@ -317,7 +339,7 @@ void ATPClientApp::setMapping(QString hash) {
             qDebug() << "mapping set.";
         }
         request->deleteLater();
-        finish(0);
+        seedThenFinish();
     });
 
     request->start();
@@ -385,12 +407,29 @@ void ATPClientApp::download(AssetHash hash) {
         }
 
         request->deleteLater();
-        finish(0);
+        seedThenFinish();
     });
 
     assetRequest->start();
 }
 
+void ATPClientApp::seedThenFinish() {
+    if (_seedSeconds <= 0) {
+        finish(0);
+        return;
+    }
+
+    if (_verbose) {
+        qDebug() << "sharing for" << _seedSeconds << "seconds";
+    }
+
+    // peers the asset server points here fetch from us until then
+    _timeoutTimer->stop();
+    QTimer::singleShot(_seedSeconds * (int)MSECS_PER_SECOND, this, [this] {
+        finish(0);
+    });
+}
+
 void ATPClientApp::finish(int exitCode) {
     auto nodeList = DependencyManager::get<NodeList>();
 
@@ -46,8 +46,11 @@ private:
     void lookupAsset();
     void listAssets();
     void download(AssetHash hash);
+    void seedThenFinish();
     void finish(int exitCode);
     bool _verbose;
+    bool _peerAssist { false };
+    int _seedSeconds { 0 };
 
     QUrl _url;
     QString _localOutputFile;
@@ -10,11 +10,15 @@
 //
 
 #include <QDataStream>
+#include <QFile>
 #include <QLoggingCategory>
 #include <QCommandLineParser>
+#include <DataServerAccountInfo.h>
+#include <NumericalConstants.h>
 #include <PathUtils.h>
 #include <LimitedNodeList.h>
 #include <NetworkLogging.h>
+#include <SharedUtil.h>
 
 #include "ICEClientApp.h"
 
@@ -43,6 +47,21 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     const QCommandLineOption cacheSTUNOption("s", "cache stun-server response");
     parser.addOption(cacheSTUNOption);
 
+    const QCommandLineOption heartbeatRateOption("heartbeats",
+        "send domain heartbeats to the ice-server at this rate instead of querying it, "
+        "-n is then the number of seconds to run for", "packets-per-second");
+    parser.addOption(heartbeatRateOption);
+
+    const QCommandLineOption heartbeatDomainsOption("domains",
+        "number of domains to send heartbeats for, the first uses -d and the rest random IDs that the ice-server has "
+        "no public key for, so their heartbeats only load its signature failure and public key request path", "1");
+    parser.addOption(heartbeatDomainsOption);
+
+    const QCommandLineOption heartbeatKeyOption("key",
+        "DER private key of the -d domain to sign heartbeats with, heartbeats are sent with a bad signature without one",
+        "path");
+    parser.addOption(heartbeatKeyOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -103,6 +122,28 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
         qDebug() << "ICE-server address is" << _iceServerAddr;
     }
 
+    if (parser.isSet(heartbeatRateOption)) {
+        _heartbeatRate = parser.value(heartbeatRateOption).toInt();
+
+        if (parser.isSet(heartbeatDomainsOption)) {
+            _numLoadDomains = std::max(parser.value(heartbeatDomainsOption).toInt(), 1);
+        }
+
+        QByteArray privateKey;
+        if (parser.isSet(heartbeatKeyOption)) {
+            QFile keyFile(parser.value(heartbeatKeyOption));
+            if (!keyFile.open(QIODevice::ReadOnly)) {
+                qCritical() << "Could not open private key" << keyFile.fileName();
+                QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+                return;
+            }
+            privateKey = keyFile.readAll();
+        }
+
+        startHeartbeatLoad(privateKey);
+        return;
+    }
+
     setState(lookUpStunServer);
 
     QTimer* doTimer = new QTimer(this);
@@ -286,6 +327,81 @@ void ICEClientApp::icePingDomainServer() {
     checkDomainPingCount();
 }
 
+void ICEClientApp::startHeartbeatLoad(const QByteArray& privateKey) {
+    openSocket();
+
+    DataServerAccountInfo accountInfo;
+    accountInfo.setPrivateKey(privateKey);
+
+    // build one signed heartbeat per domain up front, the same way a domain-server re-sends its heartbeat
+    // (only the first domain's can verify, the ice-server looks up the public key of the others and fails them)
+    for (int i = 0; i < _numLoadDomains; ++i) {
+        QUuid domainID = (i == 0 && !_domainID.isNull()) ? _domainID : QUuid::createUuid();
+
+        auto heartbeatPacket = NLPacket::create(PacketType::ICEServerHeartbeat);
+        QDataStream heartbeatStream(heartbeatPacket.get());
+        heartbeatStream << domainID << _publicSockAddr << _localSockAddr;
+
+        auto plaintext = QByteArray::fromRawData(heartbeatPacket->getPayload(), heartbeatPacket->getPayloadSize());
+        QByteArray signature = accountInfo.signPlaintext(plaintext);
+        if (signature.isEmpty()) {
+            // no key to sign with, send something the ice-server will have to reject
+            signature = QByteArray(256, 0);
+        }
+        heartbeatStream << signature;
+
+        _heartbeatPackets.push_back(std::move(heartbeatPacket));
+    }
+
+    qDebug() << "Sending" << _heartbeatRate << "heartbeats per second for" << _numLoadDomains << "domains to" << _iceServerAddr;
+
+    _lastHeartbeatLoadSend = usecTimestampNow();
+
+    const int HEARTBEAT_LOAD_INTERVAL_MSECS = 5;
+    _heartbeatLoadTimer = new QTimer(this);
+    _heartbeatLoadTimer->setTimerType(Qt::PreciseTimer);
+    connect(_heartbeatLoadTimer, &QTimer::timeout, this, &ICEClientApp::sendHeartbeatLoad);
+    _heartbeatLoadTimer->start(HEARTBEAT_LOAD_INTERVAL_MSECS);
+
+    QTimer* reportTimer = new QTimer(this);
+    connect(reportTimer, &QTimer::timeout, this, &ICEClientApp::reportHeartbeatLoad);
+    reportTimer->start(MSECS_PER_SECOND);
+}
+
+void ICEClientApp::sendHeartbeatLoad() {
+    // send as many heartbeats as we owe for the time that passed, so that timer jitter doesn't change the rate
+    quint64 now = usecTimestampNow();
+    _heartbeatsOwed += (double)(now - _lastHeartbeatLoadSend) / USECS_PER_SECOND * _heartbeatRate;
+    _lastHeartbeatLoadSend = now;
+
+    while (_heartbeatsOwed >= 1.0) {
+        _socket->writePacket(*_heartbeatPackets[_nextHeartbeat], _iceServerAddr);
+        _nextHeartbeat = (_nextHeartbeat + 1) % _heartbeatPackets.size();
+
+        ++_heartbeatsSent;
+        _heartbeatsOwed -= 1.0;
+    }
+}
+
+void ICEClientApp::reportHeartbeatLoad() {
+    ++_heartbeatLoadSeconds;
+
+    qDebug() << "sent" << _heartbeatsSent << "heartbeats/s, received" << _heartbeatACKs << "ACKs/s and"
+        << _heartbeatDenials << "denials/s, unanswered" << _heartbeatsSent - _heartbeatACKs - _heartbeatDenials;
+
+    _totalHeartbeatsSent += _heartbeatsSent;
+    _totalHeartbeatACKs += _heartbeatACKs;
+    _totalHeartbeatDenials += _heartbeatDenials;
+    _heartbeatsSent = _heartbeatACKs = _heartbeatDenials = 0;
+
+    if (_actionMax > 0 && (unsigned int)_heartbeatLoadSeconds >= _actionMax) {
+        int totalReplies = _totalHeartbeatACKs + _totalHeartbeatDenials;
+        qDebug() << "sent" << _totalHeartbeatsSent << "heartbeats in" << _heartbeatLoadSeconds << "seconds -"
+            << totalReplies / _heartbeatLoadSeconds << "replies/s," << _totalHeartbeatsSent - totalReplies << "unanswered";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+}
+
 void ICEClientApp::processSTUNResponse(std::unique_ptr<udt::BasePacket> packet) {
     if (_verbose) {
         qDebug() << "got stun response";
@@ -327,7 +443,11 @@ void ICEClientApp::processPacket(std::unique_ptr<udt::Packet> packet) {
     QSharedPointer<ReceivedMessage> message = QSharedPointer<ReceivedMessage>::create(*nlPacket);
     const HifiSockAddr& senderAddr = message->getSenderSockAddr();
 
-    if (nlPacket->getType() == PacketType::ICEServerPeerInformation) {
+    if (nlPacket->getType() == PacketType::ICEServerHeartbeatACK) {
+        ++_heartbeatACKs;
+    } else if (nlPacket->getType() == PacketType::ICEServerHeartbeatDenied) {
+        ++_heartbeatDenials;
+    } else if (nlPacket->getType() == PacketType::ICEServerPeerInformation) {
         // cancel the timeout timer
         _iceResponseTimer.stop();
 
@@ -18,6 +18,7 @@
 #include <udt/Socket.h>
 #include <ReceivedMessage.h>
 #include <NetworkPeer.h>
+#include <NLPacket.h>
 
 
 class ICEClientApp : public QCoreApplication {
@@ -36,6 +37,8 @@ public:
 public slots:
     void iceResponseTimeout();
     void stunResponseTimeout();
+    void sendHeartbeatLoad();
+    void reportHeartbeatLoad();
 
 private:
     enum State {
@@ -61,6 +64,8 @@ private:
     void processPacket(std::unique_ptr<udt::Packet> packet);
     void checkDomainPingCount();
 
+    void startHeartbeatLoad(const QByteArray& privateKey);
+
     bool _verbose;
     bool _cacheSTUNResult; // should we only talk to stun server once?
     bool _stunResultSet { false }; // have we already talked to stun server?
@@ -89,6 +94,22 @@ private:
     QTimer _stunResponseTimer;
     QTimer _iceResponseTimer;
     int _domainPingCount { 0 };
+
+    // heartbeat load generation, to measure how many heartbeats per second an ice-server can handle
+    int _heartbeatRate { 0 };
+    int _numLoadDomains { 1 };
+    std::vector<std::unique_ptr<NLPacket>> _heartbeatPackets;
+    QTimer* _heartbeatLoadTimer { nullptr };
+    quint64 _lastHeartbeatLoadSend { 0 };
+    double _heartbeatsOwed { 0.0 };
+    size_t _nextHeartbeat { 0 };
+    int _heartbeatsSent { 0 };
+    int _heartbeatACKs { 0 };
+    int _heartbeatDenials { 0 };
+    int _totalHeartbeatsSent { 0 };
+    int _totalHeartbeatACKs { 0 };
+    int _totalHeartbeatDenials { 0 };
+    int _heartbeatLoadSeconds { 0 };
 };
 
 
@@ -0,0 +1,55 @@
+//
+//  AgentGroup.cpp
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AgentGroup.h"
+
+#include <SharedUtil.h>
+
+// well under an audio frame, so the frames go out close to when they are due
+static const int UPDATE_INTERVAL_MSECS = 2;
+
+AgentGroup::AgentGroup(const VirtualAgent::Settings& settings, QObject* parent) :
+    QObject(parent),
+    _settings(settings),
+    _updateTimer(new QTimer(this))
+{
+    _updateTimer->setTimerType(Qt::PreciseTimer);
+    connect(_updateTimer, &QTimer::timeout, this, &AgentGroup::update);
+}
+
+void AgentGroup::addAgents(int firstIndex, int count, int stride) {
+    for (int i = 0; i < count; ++i) {
+        _agents.push_back(new VirtualAgent(firstIndex + i * stride, _settings, _stats, this));
+    }
+    _numAgents = (int)_agents.size();
+
+    // the timer is started here rather than when the group is made so that it runs on the group's thread
+    if (!_updateTimer->isActive()) {
+        _updateTimer->start(UPDATE_INTERVAL_MSECS);
+    }
+}
+
+void AgentGroup::stop() {
+    _updateTimer->stop();
+
+    for (auto agent : _agents) {
+        agent->disconnectFromDomain();
+        agent->deleteLater();
+    }
+    _agents.clear();
+    _numAgents = 0;
+}
+
+void AgentGroup::update() {
+    quint64 now = usecTimestampNow();
+    for (auto agent : _agents) {
+        agent->update(now);
+    }
+}
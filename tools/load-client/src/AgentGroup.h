@@ -0,0 +1,51 @@
+//
+//  AgentGroup.h
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AgentGroup_h
+#define hifi_AgentGroup_h
+
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include "VirtualAgent.h"
+
+// The virtual agents that live on one thread, all updated from one timer.
+class AgentGroup : public QObject {
+    Q_OBJECT
+public:
+    AgentGroup(const VirtualAgent::Settings& settings, QObject* parent = nullptr);
+
+    const VirtualAgentStats& getStats() const { return _stats; }
+    int getNumAgents() const { return _numAgents; }
+
+public slots:
+    // adds count agents, the first with firstIndex and each after it stride more than the one before
+    void addAgents(int firstIndex, int count, int stride);
+
+    // disconnects every agent from the domain and removes them
+    void stop();
+
+private slots:
+    void update();
+
+private:
+    const VirtualAgent::Settings _settings;
+    VirtualAgentStats _stats;
+
+    QTimer* _updateTimer;
+    std::vector<VirtualAgent*> _agents;
+    std::atomic<int> _numAgents { 0 };
+};
+
+#endif // hifi_AgentGroup_h
@@ -0,0 +1,290 @@
+//
+//  LoadClientApp.cpp
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadClientApp.h"
+
+#include <cmath>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QLoggingCategory>
+
+#include <AudioConstants.h>
+#include <DomainHandler.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+#include <shared/QtHelpers.h>
+#include <udt/NetworkImpairment.h>
+
+static const float TONE_FREQUENCY = 440.0f;
+static const float TONE_AMPLITUDE = 0.25f;
+
+static const float KILOBITS_PER_BYTE = 8.0f / 1000.0f;
+
+// a second of a tone, which loops without a click since it holds a whole number of its periods
+static QByteArray createToneClip() {
+    QByteArray clip(AudioConstants::SAMPLE_RATE * AudioConstants::SAMPLE_SIZE, 0);
+    auto samples = reinterpret_cast<AudioConstants::AudioSample*>(clip.data());
+    for (int i = 0; i < AudioConstants::SAMPLE_RATE; ++i) {
+        float phase = TWO_PI * TONE_FREQUENCY * i / AudioConstants::SAMPLE_RATE;
+        samples[i] = (AudioConstants::AudioSample)(sinf(phase) * TONE_AMPLITUDE * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+    return clip;
+}
+
+LoadClientApp::LoadClientApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity load client, simulates many agents in a domain");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "host[:port]", "127.0.0.1");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption numAgentsOption("n", "number of agents", "count", "10");
+    parser.addOption(numAgentsOption);
+
+    const QCommandLineOption numThreadsOption("threads", "number of threads the agents are spread over", "count",
+                                              QString::number(QThread::idealThreadCount()));
+    parser.addOption(numThreadsOption);
+
+    const QCommandLineOption rampOption("ramp", "agents added at each step, all of them at once if it is 0", "count", "0");
+    parser.addOption(rampOption);
+
+    const QCommandLineOption stepDurationOption("step-duration", "seconds each step lasts", "seconds", "10");
+    parser.addOption(stepDurationOption);
+
+    const QCommandLineOption audioOption("audio", "what the agents say: tone, silent, or a file of raw 24kHz 16-bit mono samples",
+                                         "source", "tone");
+    parser.addOption(audioOption);
+
+    const QCommandLineOption avatarRateOption("avatar-rate", "avatar data packets each agent sends per second", "rate", "45");
+    parser.addOption(avatarRateOption);
+
+    const QCommandLineOption entityEditRateOption("entity-edit-rate", "edits each agent makes to its entity per second",
+                                                  "rate", "1");
+    parser.addOption(entityEditRateOption);
+
+    const QCommandLineOption outputOption("output", "also write the results to a CSV file", "path");
+    parser.addOption(outputOption);
+
+    const QCommandLineOption networkImpairmentOption(udt::NETWORK_IMPAIRMENT_OPTION,
+                                                     udt::NETWORK_IMPAIRMENT_OPTION_DESCRIPTION, "settings");
+    parser.addOption(networkImpairmentOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (!parser.isSet(verboseOutput)) {
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtWarningMsg, false);
+    }
+
+    VirtualAgent::Settings settings;
+
+    QStringList domainAddress = parser.value(domainAddressOption).split(':');
+    quint16 domainPort = domainAddress.size() > 1 ? domainAddress[1].toUShort() : DEFAULT_DOMAIN_SERVER_PORT;
+    settings.domainServer = HifiSockAddr(domainAddress[0], domainPort, true);
+    if (settings.domainServer.getAddress().isNull()) {
+        qDebug() << "Could not find the domain-server at" << parser.value(domainAddressOption);
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    QString audio = parser.value(audioOption);
+    if (audio == "tone") {
+        settings.audioClip = createToneClip();
+    } else if (audio != "silent") {
+        QFile audioFile(audio);
+        if (!audioFile.open(QIODevice::ReadOnly)) {
+            qDebug() << "Could not open" << audio;
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+        settings.audioClip = audioFile.readAll();
+
+        // whole samples only
+        settings.audioClip.chop(settings.audioClip.size() % AudioConstants::SAMPLE_SIZE);
+    }
+
+    settings.avatarRate = parser.value(avatarRateOption).toInt();
+    settings.entityEditRate = parser.value(entityEditRateOption).toFloat();
+
+    if (parser.isSet(networkImpairmentOption)) {
+        udt::NetworkImpairment::Settings impairmentSettings;
+        if (!udt::NetworkImpairment::parseSettings(parser.value(networkImpairmentOption), impairmentSettings)) {
+            qDebug() << "--" + udt::NETWORK_IMPAIRMENT_OPTION << "could not be parsed";
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+        udt::NetworkImpairment::setDefaultSettings(impairmentSettings);
+    }
+
+    _numAgents = std::max(0, parser.value(numAgentsOption).toInt());
+    _rampStep = parser.value(rampOption).toInt();
+    if (_rampStep <= 0) {
+        _rampStep = _numAgents;
+    }
+
+    int numThreads = std::max(1, std::min(parser.value(numThreadsOption).toInt(), _numAgents));
+    for (int i = 0; i < numThreads; ++i) {
+        auto thread = new QThread(this);
+        thread->setObjectName(QString("Agent Group %1").arg(i));
+
+        auto group = new AgentGroup(settings);
+        group->moveToThread(thread);
+        connect(thread, &QThread::finished, group, &QObject::deleteLater);
+        thread->start();
+
+        _threads.push_back(thread);
+        _groups.push_back(group);
+    }
+
+    if (parser.isSet(outputOption)) {
+        _outputFile.setFileName(parser.value(outputOption));
+        if (!_outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qDebug() << "Could not open" << _outputFile.fileName();
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+        _output.setDevice(&_outputFile);
+        _output << "agents,connected,denied,mixes per agent per second,avatar packets per agent per second,"
+                << "entity packets per agent per second,audio mixer ping ms,avatar mixer ping ms,entity server ping ms,"
+                << "sent kbps,received kbps" << endl;
+    }
+
+    qDebug() << "Running" << _numAgents << "agents on" << numThreads << "threads against" << settings.domainServer;
+
+    _stepTimer.setInterval(parser.value(stepDurationOption).toInt() * (int)MSECS_PER_SECOND);
+    connect(&_stepTimer, &QTimer::timeout, this, &LoadClientApp::endStep);
+
+    addAgents();
+}
+
+LoadClientApp::~LoadClientApp() {
+    for (auto thread : _threads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+void LoadClientApp::addAgents() {
+    int count = std::min(_rampStep, _numAgents - _numStarted);
+
+    // agent i goes to group i modulo the number of groups, so each step spreads evenly over the threads
+    int numGroups = (int)_groups.size();
+    for (int i = 0; i < numGroups; ++i) {
+        int firstIndex = _numStarted + ((i - _numStarted) % numGroups + numGroups) % numGroups;
+        int groupCount = (_numStarted + count - firstIndex + numGroups - 1) / numGroups;
+        if (groupCount > 0) {
+            QMetaObject::invokeMethod(_groups[i], "addAgents", Q_ARG(int, firstIndex), Q_ARG(int, groupCount),
+                                      Q_ARG(int, numGroups));
+        }
+    }
+    _numStarted += count;
+
+    _stepStartTotals = sumStats();
+    _stepElapsed.start();
+    _stepTimer.start();
+}
+
+LoadClientApp::Totals LoadClientApp::sumStats() const {
+    Totals totals;
+    for (auto group : _groups) {
+        const auto& stats = group->getStats();
+        totals.numMixedAudioPackets += stats.numMixedAudioPackets;
+        totals.numAvatarPackets += stats.numAvatarPackets;
+        totals.numEntityPackets += stats.numEntityPackets;
+        totals.bytesSent += stats.bytesSent;
+        totals.bytesReceived += stats.bytesReceived;
+        for (int i = 0; i < VirtualAgentStats::NumServers; ++i) {
+            totals.pingTotals[i] += stats.pingTotals[i];
+            totals.numPings[i] += stats.numPings[i];
+        }
+        totals.numConnected += stats.numConnected;
+        totals.numDenied += stats.numDenied;
+    }
+    return totals;
+}
+
+void LoadClientApp::endStep() {
+    Totals totals = sumStats();
+    const Totals& start = _stepStartTotals;
+
+    float seconds = (float)_stepElapsed.elapsed() / MSECS_PER_SECOND;
+    float agentSeconds = seconds * std::max(1, totals.numConnected);
+
+    auto perAgentPerSecond = [&](quint64 count, quint64 startCount) {
+        return (float)(count - startCount) / agentSeconds;
+    };
+
+    float pingMsecs[VirtualAgentStats::NumServers];
+    for (int i = 0; i < VirtualAgentStats::NumServers; ++i) {
+        quint64 numPings = totals.numPings[i] - start.numPings[i];
+        pingMsecs[i] = numPings > 0 ? (float)(totals.pingTotals[i] - start.pingTotals[i]) / numPings / USECS_PER_MSEC : 0.0f;
+    }
+
+    float mixRate = perAgentPerSecond(totals.numMixedAudioPackets, start.numMixedAudioPackets);
+    float avatarRate = perAgentPerSecond(totals.numAvatarPackets, start.numAvatarPackets);
+    float entityRate = perAgentPerSecond(totals.numEntityPackets, start.numEntityPackets);
+    float sentKbps = (totals.bytesSent - start.bytesSent) * KILOBITS_PER_BYTE / seconds;
+    float receivedKbps = (totals.bytesReceived - start.bytesReceived) * KILOBITS_PER_BYTE / seconds;
+
+    qDebug().nospace() << _numStarted << " agents, " << totals.numConnected << " connected, " << totals.numDenied
+        << " denied - per agent per second: " << mixRate << " mixes, " << avatarRate << " avatar packets, "
+        << entityRate << " entity packets - ping ms: audio " << pingMsecs[VirtualAgentStats::AudioMixer]
+        << ", avatar " << pingMsecs[VirtualAgentStats::AvatarMixer]
+        << ", entity " << pingMsecs[VirtualAgentStats::EntityServer]
+        << " - " << sentKbps << " kbps sent, " << receivedKbps << " kbps received";
+
+    if (_outputFile.isOpen()) {
+        _output << _numStarted << "," << totals.numConnected << "," << totals.numDenied << "," << mixRate << ","
+                << avatarRate << "," << entityRate << "," << pingMsecs[VirtualAgentStats::AudioMixer] << ","
+                << pingMsecs[VirtualAgentStats::AvatarMixer] << "," << pingMsecs[VirtualAgentStats::EntityServer] << ","
+                << sentKbps << "," << receivedKbps << endl;
+    }
+
+    if (_numStarted < _numAgents) {
+        addAgents();
+    } else {
+        finish(0);
+    }
+}
+
+void LoadClientApp::finish(int exitCode) {
+    _stepTimer.stop();
+
+    for (auto group : _groups) {
+        BLOCKING_INVOKE_METHOD(group, "stop");
+    }
+
+    // give the disconnects a moment to go out before the sockets are gone
+    QTimer::singleShot((int)MSECS_PER_SECOND, this, [this, exitCode] {
+        exit(exitCode);
+    });
+}
@@ -0,0 +1,68 @@
+//
+//  LoadClientApp.h
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadClientApp_h
+#define hifi_LoadClientApp_h
+
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include "AgentGroup.h"
+
+// Ramps up virtual agents in a domain step by step and reports, for each step, the rates at which they get mixes,
+// avatars and entities back and the round trips to the servers, as a scalability curve.
+class LoadClientApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    LoadClientApp(int argc, char* argv[]);
+    ~LoadClientApp();
+
+private slots:
+    void endStep();
+
+private:
+    struct Totals {
+        quint64 numMixedAudioPackets { 0 };
+        quint64 numAvatarPackets { 0 };
+        quint64 numEntityPackets { 0 };
+        quint64 bytesSent { 0 };
+        quint64 bytesReceived { 0 };
+        quint64 pingTotals[VirtualAgentStats::NumServers] {};
+        quint64 numPings[VirtualAgentStats::NumServers] {};
+        int numConnected { 0 };
+        int numDenied { 0 };
+    };
+
+    Totals sumStats() const;
+    void addAgents();
+    void finish(int exitCode);
+
+    int _numAgents { 0 };
+    int _numStarted { 0 };
+    int _rampStep { 0 };
+
+    std::vector<AgentGroup*> _groups;
+    std::vector<QThread*> _threads;
+
+    QTimer _stepTimer;
+    QElapsedTimer _stepElapsed;
+    Totals _stepStartTotals;
+
+    QFile _outputFile;
+    QTextStream _output;
+};
+
+#endif // hifi_LoadClientApp_h
@@ -0,0 +1,526 @@
+//
+//  VirtualAgent.cpp
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "VirtualAgent.h"
+
+#include <cmath>
+
+#include <QtCore/QDataStream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <AudioConstants.h>
+#include <EntityItemProperties.h>
+#include <LimitedNodeList.h>
+#include <NetworkPeer.h>
+#include <NodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <ReceivedMessage.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+#include <shared/NetworkUtils.h>
+#include <udt/PacketHeaders.h>
+
+static const quint64 PING_INTERVAL_USECS = USECS_PER_SECOND;
+static const quint64 PUNCH_PING_INTERVAL_USECS = UDP_PUNCH_PING_INTERVAL_MS * USECS_PER_MSEC;
+static const quint64 CHECK_IN_INTERVAL_USECS = DOMAIN_SERVER_CHECK_IN_MSECS * USECS_PER_MSEC;
+
+// as often as the interface re-sends its view when it hasn't changed much
+static const quint64 QUERY_INTERVAL_USECS = 3 * USECS_PER_SECOND;
+
+// every so often ask for the full domain list in case we missed some of the unreliable list packets
+static const int FULL_DOMAIN_LIST_REQUEST_INTERVAL = 10;
+
+// the agents walk around circles of this radius at this speed
+static const float PATH_RADIUS = 0.75f;
+static const float WALKING_SPEED = 1.0f; // meters per second
+
+static const glm::vec3 ENTITY_DIMENSIONS { 0.2f };
+static const glm::vec3 ENTITY_OFFSET { 0.0f, 1.0f, 0.0f };
+
+// long enough to outlive a run, so they're cleaned up even if an agent doesn't get to erase its own
+static const float ENTITY_LIFETIME = 3600.0f;
+
+static const glm::vec3 AVATAR_BOUNDING_BOX_CORNER { -0.5f, 0.0f, -0.5f };
+static const glm::vec3 AVATAR_BOUNDING_BOX_SCALE { 1.0f, 1.8f, 1.0f };
+
+static const QString AUDIO_CODEC_NAME = "pcm";
+
+VirtualAgentStats::VirtualAgentStats() {
+    for (int i = 0; i < NumServers; ++i) {
+        pingTotals[i] = 0;
+        numPings[i] = 0;
+    }
+}
+
+static int serverForNodeType(NodeType_t type) {
+    switch (type) {
+        case NodeType::AudioMixer:
+            return VirtualAgentStats::AudioMixer;
+        case NodeType::AvatarMixer:
+            return VirtualAgentStats::AvatarMixer;
+        case NodeType::EntityServer:
+            return VirtualAgentStats::EntityServer;
+        default:
+            return -1;
+    }
+}
+
+VirtualAgent::VirtualAgent(int index, const Settings& settings, VirtualAgentStats& stats, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _settings(settings),
+    _stats(stats),
+    _socket(new udt::Socket(this, false))
+{
+    _socket->bind(QHostAddress::AnyIPv4);
+    _socket->setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+
+    // the domain-server gets to us on the address it is reached from, no STUN for a domain on this network
+    auto localAddress = settings.domainServer.getAddress().isLoopback() ? QHostAddress(QHostAddress::LocalHost)
+                                                                        : getGuessedLocalAddress();
+    _localSockAddr = HifiSockAddr(localAddress, _socket->localPort());
+
+    _avatar.setDisplayName(QString("load-client %1").arg(index));
+
+    _octreeQuery.setCameraFov(DEFAULT_FIELD_OF_VIEW_DEGREES);
+    _octreeQuery.setCameraAspectRatio(DEFAULT_ASPECT_RATIO);
+    _octreeQuery.setCameraNearClip(DEFAULT_NEAR_CLIP);
+    _octreeQuery.setCameraFarClip(DEFAULT_FAR_CLIP);
+
+    // so the agents started together don't all send at once
+    quint64 now = usecTimestampNow();
+    quint64 stagger = (quint64)(index * 7919) % USECS_PER_SECOND;
+    _nextCheckIn = now;
+    _nextAudioFrame = now + stagger % AudioConstants::NETWORK_FRAME_USECS;
+    _nextAvatarUpdate = now + stagger % (USECS_PER_SECOND / std::max(1, _settings.avatarRate));
+    _nextQuery = now + stagger;
+    _nextEntityEdit = now + stagger;
+}
+
+void VirtualAgent::update(quint64 now) {
+    if (now >= _nextCheckIn) {
+        sendCheckIn();
+        _nextCheckIn = now + CHECK_IN_INTERVAL_USECS;
+    }
+
+    if (!_isConnected) {
+        return;
+    }
+
+    sendPings(now);
+
+    // catch up if we were late, but don't make up for a stall
+    const int MAX_FRAMES_PER_UPDATE = 2;
+    for (int i = 0; i < MAX_FRAMES_PER_UPDATE && now >= _nextAudioFrame; ++i) {
+        sendAudio();
+        _nextAudioFrame += AudioConstants::NETWORK_FRAME_USECS;
+    }
+    if (now >= _nextAudioFrame) {
+        _nextAudioFrame = now + AudioConstants::NETWORK_FRAME_USECS;
+    }
+
+    if (_settings.avatarRate > 0 && now >= _nextAvatarUpdate) {
+        sendAvatar(now);
+        _nextAvatarUpdate = std::max(_nextAvatarUpdate + USECS_PER_SECOND / _settings.avatarRate, now);
+    }
+
+    if (now >= _nextQuery) {
+        sendQueries();
+        _nextQuery = now + QUERY_INTERVAL_USECS;
+    }
+
+    if (_settings.entityEditRate > 0.0f && now >= _nextEntityEdit && _servers[Server::EntityServer].isActive()) {
+        sendEntityEdit(_hasAddedEntity ? PacketType::EntityEdit : PacketType::EntityAdd, now);
+        _hasAddedEntity = true;
+        _nextEntityEdit = now + (quint64)(USECS_PER_SECOND / _settings.entityEditRate);
+    }
+}
+
+void VirtualAgent::disconnectFromDomain() {
+    if (_hasAddedEntity && _servers[Server::EntityServer].isActive()) {
+        QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
+        if (EntityItemProperties::encodeEraseEntityMessage(_entityID, buffer)) {
+            auto packet = NLPacket::create(PacketType::EntityErase);
+            packet->writePrimitive(_entityEditSequenceNumber++);
+            packet->writePrimitive(usecTimestampNow());
+            packet->write(buffer);
+            sendToServer(Server::EntityServer, std::move(packet));
+        }
+    }
+
+    if (_isConnected) {
+        auto packet = NLPacket::create(PacketType::DomainDisconnectRequest, 0);
+        packet->writeSourceID(_sessionUUID);
+        _stats.bytesSent += _socket->writePacket(*packet, _settings.domainServer);
+
+        _isConnected = false;
+        --_stats.numConnected;
+    }
+}
+
+void VirtualAgent::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    _stats.bytesReceived += nlPacket->getDataSize();
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList:
+            processDomainList(*nlPacket);
+            break;
+        case PacketType::DomainServerAddedNode: {
+            ReceivedMessage message(*nlPacket);
+            QDataStream stream(message.getMessage());
+            parseServer(stream);
+            break;
+        }
+        case PacketType::DomainConnectionDenied:
+            ++_stats.numDenied;
+            break;
+        case PacketType::Ping:
+            processPing(*nlPacket);
+            break;
+        case PacketType::PingReply:
+            processPingReply(*nlPacket);
+            break;
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            ++_stats.numMixedAudioPackets;
+            break;
+        case PacketType::BulkAvatarData:
+            ++_stats.numAvatarPackets;
+            break;
+        case PacketType::EntityData:
+            ++_stats.numEntityPackets;
+            break;
+        default:
+            break;
+    }
+}
+
+void VirtualAgent::processDomainList(NLPacket& packet) {
+    ReceivedMessage message(packet);
+    QDataStream stream(message.getMessage());
+
+    QUuid domainUUID;
+    QUuid sessionUUID;
+    NodePermissions permissions;
+    quint32 revision;
+    bool isDelta;
+    QList<QUuid> removedNodes;
+    stream >> domainUUID >> sessionUUID >> permissions >> revision >> isDelta >> removedNodes;
+
+    _sessionUUID = sessionUUID;
+    if (!_isConnected) {
+        _isConnected = true;
+        ++_stats.numConnected;
+    }
+
+    _lastDomainListRevision = isDelta ? std::max(_lastDomainListRevision, revision) : revision;
+
+    for (auto& server : _servers) {
+        if (removedNodes.contains(server.uuid)) {
+            server = ServerPeer();
+        }
+    }
+
+    while (stream.device()->pos() < message.getSize()) {
+        parseServer(stream);
+    }
+}
+
+void VirtualAgent::parseServer(QDataStream& stream) {
+    qint8 nodeType;
+    QUuid nodeUUID;
+    QUuid connectionSecret;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+    stream >> nodeType >> nodeUUID >> publicSocket >> localSocket >> permissions >> isReplicated >> connectionSecret;
+
+    int server = serverForNodeType(nodeType);
+    if (server < 0) {
+        return;
+    }
+
+    // if the public socket address is 0 then it's reachable at the same IP as the domain server
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_settings.domainServer.getAddress());
+    }
+
+    auto& peer = _servers[server];
+    if (peer.uuid != nodeUUID) {
+        // a server we haven't reached yet, punch through to it
+        peer = ServerPeer();
+        peer.uuid = nodeUUID;
+    }
+    peer.publicSocket = publicSocket;
+    peer.localSocket = localSocket;
+    peer.connectionSecret = connectionSecret;
+}
+
+void VirtualAgent::processPing(NLPacket& packet) {
+    int server = serverForPacket(packet);
+    if (server < 0) {
+        // we'll answer once the domain-server tells us about it
+        return;
+    }
+
+    quint8 pingType;
+    quint64 pingTime;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&pingTime);
+
+    auto reply = NLPacket::create(PacketType::PingReply, sizeof(pingType) + sizeof(pingTime) + sizeof(quint64));
+    reply->writePrimitive(pingType);
+    reply->writePrimitive(pingTime);
+    reply->writePrimitive(usecTimestampNow());
+    sendToServer((Server)server, std::move(reply), packet.getSenderSockAddr());
+}
+
+void VirtualAgent::processPingReply(NLPacket& packet) {
+    int server = serverForPacket(packet);
+    if (server < 0) {
+        return;
+    }
+
+    quint8 pingType;
+    quint64 pingTime;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&pingTime);
+
+    auto& peer = _servers[server];
+    if (!peer.isActive()) {
+        peer.activeSocket = packet.getSenderSockAddr();
+        peer.nextPing = usecTimestampNow() + PING_INTERVAL_USECS;
+    } else if (pingType == PingType::Agnostic) {
+        _stats.pingTotals[server] += usecTimestampNow() - pingTime;
+        ++_stats.numPings[server];
+    }
+}
+
+void VirtualAgent::sendCheckIn() {
+    PacketType packetType = _isConnected ? PacketType::DomainListRequest : PacketType::DomainConnectRequest;
+    auto packet = NLPacket::create(packetType);
+    QDataStream stream(packet.get());
+
+    if (packetType == PacketType::DomainConnectRequest) {
+        stream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        stream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        // no hardware address, and a fingerprint of its own so the domain-server can tell the agents apart
+        stream << QString() << QUuid::createUuid();
+    }
+
+    QList<NodeType_t> nodeTypesOfInterest;
+    nodeTypesOfInterest << NodeType::AudioMixer << NodeType::AvatarMixer << NodeType::EntityServer;
+    stream << (NodeType_t)NodeType::Agent << _localSockAddr << _localSockAddr << nodeTypesOfInterest << QString();
+
+    if (packetType == PacketType::DomainListRequest) {
+        bool requestFullList = (_numDomainListRequests++ % FULL_DOMAIN_LIST_REQUEST_INTERVAL) == 0;
+        stream << (requestFullList ? quint32(0) : _lastDomainListRevision);
+
+        packet->writeSourceID(_sessionUUID);
+    } else {
+        // anonymous
+        stream << QString();
+    }
+
+    _stats.bytesSent += _socket->writePacket(*packet, _settings.domainServer);
+}
+
+void VirtualAgent::sendPings(quint64 now) {
+    for (int i = 0; i < VirtualAgentStats::NumServers; ++i) {
+        auto& peer = _servers[i];
+        if (peer.uuid.isNull() || now < peer.nextPing) {
+            continue;
+        }
+
+        auto createPing = [&](quint8 pingType) {
+            auto ping = NLPacket::create(PacketType::Ping, sizeof(pingType) + sizeof(quint64));
+            ping->writePrimitive(pingType);
+            ping->writePrimitive(now);
+            return ping;
+        };
+
+        if (peer.isActive()) {
+            sendToServer((Server)i, createPing(PingType::Agnostic));
+            peer.nextPing = now + PING_INTERVAL_USECS;
+        } else {
+            sendToServer((Server)i, createPing(PingType::Local), peer.localSocket);
+            sendToServer((Server)i, createPing(PingType::Public), peer.publicSocket);
+            peer.nextPing = now + PUNCH_PING_INTERVAL_USECS;
+        }
+    }
+}
+
+void VirtualAgent::sendAudio() {
+    if (!_servers[Server::AudioMixer].isActive()) {
+        return;
+    }
+
+    quint64 now = usecTimestampNow();
+    bool isSilent = _settings.audioClip.isEmpty();
+
+    auto packet = NLPacket::create(isSilent ? PacketType::SilentAudioFrame : PacketType::MicrophoneAudioNoEcho);
+    packet->writePrimitive(_audioSequenceNumber++);
+    packet->writeString(AUDIO_CODEC_NAME);
+
+    if (isSilent) {
+        packet->writePrimitive((quint16)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        packet->writePrimitive((quint8)0); // mono
+    }
+
+    packet->writePrimitive(getPosition(now));
+    packet->writePrimitive(getOrientation(now));
+    packet->writePrimitive(AVATAR_BOUNDING_BOX_CORNER);
+    packet->writePrimitive(AVATAR_BOUNDING_BOX_SCALE);
+
+    if (!isSilent) {
+        // loop the clip, wrapping around its end
+        int bytesLeft = AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
+        const auto& clip = _settings.audioClip;
+        while (bytesLeft > 0) {
+            int bytes = std::min(bytesLeft, clip.size() - _audioClipPosition);
+            packet->write(clip.constData() + _audioClipPosition, bytes);
+            _audioClipPosition = (_audioClipPosition + bytes) % clip.size();
+            bytesLeft -= bytes;
+        }
+    }
+
+    sendToServer(Server::AudioMixer, std::move(packet));
+}
+
+void VirtualAgent::sendAvatar(quint64 now) {
+    if (!_servers[Server::AvatarMixer].isActive()) {
+        return;
+    }
+
+    _avatar.setPosition(getPosition(now));
+    _avatar.setOrientation(getOrientation(now));
+
+    bool sendAll = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+    QByteArray avatarByteArray = _avatar.toByteArrayStateful(sendAll ? AvatarData::SendAllData : AvatarData::CullSmallData);
+    _avatar.doneEncoding(true);
+
+    auto packet = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequenceNumber));
+    packet->writePrimitive(_avatarSequenceNumber++);
+    packet->write(avatarByteArray);
+    sendToServer(Server::AvatarMixer, std::move(packet));
+}
+
+void VirtualAgent::sendQueries() {
+    quint64 now = usecTimestampNow();
+    auto position = getPosition(now);
+    auto orientation = getOrientation(now);
+
+    if (_servers[Server::AvatarMixer].isActive()) {
+        // the avatar mixer only sends us the avatars we can see
+        ViewFrustum viewFrustum;
+        viewFrustum.setPosition(position);
+        viewFrustum.setOrientation(orientation);
+        viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                                   DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+        viewFrustum.calculate();
+
+        QByteArray viewFrustumByteArray = viewFrustum.toByteArray();
+        auto packet = NLPacket::create(PacketType::ViewFrustum, viewFrustumByteArray.size());
+        packet->write(viewFrustumByteArray);
+        sendToServer(Server::AvatarMixer, std::move(packet));
+    }
+
+    if (_servers[Server::EntityServer].isActive()) {
+        _octreeQuery.setCameraPosition(position);
+        _octreeQuery.setCameraOrientation(orientation);
+
+        auto packet = NLPacket::create(PacketType::EntityQuery);
+        int size = _octreeQuery.getBroadcastData(reinterpret_cast<unsigned char*>(packet->getPayload()));
+        packet->setPayloadSize(size);
+        sendToServer(Server::EntityServer, std::move(packet));
+    }
+}
+
+void VirtualAgent::sendEntityEdit(PacketType type, quint64 now) {
+    EntityItemProperties properties;
+    if (type == PacketType::EntityAdd) {
+        _entityID = EntityItemID(QUuid::createUuid());
+        properties.setType(EntityTypes::Box);
+        properties.setName(QString("load-client %1").arg(_index));
+        properties.setDimensions(ENTITY_DIMENSIONS);
+        properties.setLifetime(ENTITY_LIFETIME);
+    }
+    properties.setPosition(getPosition(now) + ENTITY_OFFSET);
+    properties.setLastEdited(now);
+
+    QByteArray buffer(NLPacket::maxPayloadSize(type), 0);
+    if (!EntityItemProperties::encodeEntityEditPacket(type, _entityID, properties, buffer)) {
+        return;
+    }
+
+    // the same header the edit packet sender gives them
+    auto packet = NLPacket::create(type);
+    packet->writePrimitive(_entityEditSequenceNumber++);
+    packet->writePrimitive(now);
+    packet->write(buffer);
+    sendToServer(Server::EntityServer, std::move(packet));
+}
+
+void VirtualAgent::sendToServer(Server server, std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr) {
+    const auto& peer = _servers[server];
+    const auto& destination = sockAddr.isNull() ? peer.activeSocket : sockAddr;
+    if (destination.isNull()) {
+        return;
+    }
+
+    if (!NON_SOURCED_PACKETS.contains(packet->getType())) {
+        packet->writeSourceID(_sessionUUID);
+    }
+    if (!peer.connectionSecret.isNull() && !NON_SOURCED_PACKETS.contains(packet->getType())
+        && !NON_VERIFIED_PACKETS.contains(packet->getType())) {
+        packet->writeVerificationHashGivenSecret(peer.connectionSecret);
+    }
+
+    _stats.bytesSent += _socket->writePacket(*packet, destination);
+}
+
+int VirtualAgent::serverForPacket(const NLPacket& packet) const {
+    for (int i = 0; i < VirtualAgentStats::NumServers; ++i) {
+        if (!_servers[i].uuid.isNull() && _servers[i].uuid == packet.getSourceID()) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+float VirtualAgent::getPathAngle(quint64 now) const {
+    double seconds = (double)now / USECS_PER_SECOND;
+    return (float)fmod(seconds * WALKING_SPEED / PATH_RADIUS + _index, TWO_PI);
+}
+
+glm::vec3 VirtualAgent::getPosition(quint64 now) const {
+    // the agents walk around circles laid out on a square grid
+    const int GRID_SIZE = 32;
+    glm::vec3 center(_index % GRID_SIZE, 0.0f, _index / GRID_SIZE);
+    center *= _settings.spacing;
+
+    float angle = getPathAngle(now);
+    return center + PATH_RADIUS * glm::vec3(cosf(angle), 0.0f, sinf(angle));
+}
+
+glm::quat VirtualAgent::getOrientation(quint64 now) const {
+    // facing along the circle
+    return glm::angleAxis(-getPathAngle(now), glm::vec3(0.0f, 1.0f, 0.0f));
+}
@@ -0,0 +1,152 @@
+//
+//  VirtualAgent.h
+//  tools/load-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_VirtualAgent_h
+#define hifi_VirtualAgent_h
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QObject>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+#include <EntityItemID.h>
+#include <HifiSockAddr.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <OctreeQuery.h>
+#include <udt/Socket.h>
+
+// counts of what the agents of a group sent and received, read from other threads
+struct VirtualAgentStats {
+    enum Server {
+        AudioMixer,
+        AvatarMixer,
+        EntityServer,
+        NumServers
+    };
+
+    std::atomic<int> numConnected { 0 }; // agents with a domain-server session
+    std::atomic<int> numDenied { 0 }; // connection refusals from the domain-server
+
+    std::atomic<quint64> numMixedAudioPackets { 0 };
+    std::atomic<quint64> numAvatarPackets { 0 };
+    std::atomic<quint64> numEntityPackets { 0 };
+
+    std::atomic<quint64> bytesSent { 0 };
+    std::atomic<quint64> bytesReceived { 0 };
+
+    // round trips of the pings to each server, in microseconds
+    std::atomic<quint64> pingTotals[NumServers];
+    std::atomic<quint64> numPings[NumServers];
+
+    VirtualAgentStats();
+};
+
+// A simulated user that takes part in a domain without a NodeList.
+//
+// The NodeList is a singleton, so each agent speaks the domain protocol itself on a socket of its own: it connects to the
+// domain-server, punches through to the audio mixer, avatar mixer and entity server it is told about, and answers their
+// pings.  Once it reaches them it streams microphone audio, avatar data with synthetic motion, entity queries and edits to
+// an entity of its own, and it counts the mixes, avatars and entities it gets back and the round trips of its pings.
+//
+// It is driven by update calls from its group rather than timers of its own, so that thousands of them cost a few threads.
+class VirtualAgent : public QObject {
+    Q_OBJECT
+public:
+    struct Settings {
+        HifiSockAddr domainServer;
+        QByteArray audioClip; // 24kHz mono samples streamed in a loop, silent frames if it is empty
+        int avatarRate { 45 }; // avatar data packets per second
+        float entityEditRate { 1.0f }; // edits per second to the agent's entity, none if it is 0
+        float spacing { 2.0f }; // between the centers of the paths the agents walk, in meters
+    };
+
+    VirtualAgent(int index, const Settings& settings, VirtualAgentStats& stats, QObject* parent = nullptr);
+
+    // sends whatever is due at now, in microseconds since the epoch
+    void update(quint64 now);
+
+    // leaves the domain, erasing the agent's entity
+    void disconnectFromDomain();
+
+private:
+    using Server = VirtualAgentStats::Server;
+
+    struct ServerPeer {
+        QUuid uuid;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket; // whichever of the two answered our pings first
+        QUuid connectionSecret;
+        quint64 nextPing { 0 };
+
+        bool isActive() const { return !activeSocket.isNull(); }
+    };
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void processDomainList(NLPacket& packet);
+    void parseServer(QDataStream& stream);
+    void processPing(NLPacket& packet);
+    void processPingReply(NLPacket& packet);
+
+    void sendCheckIn();
+    void sendPings(quint64 now);
+    void sendAudio();
+    void sendAvatar(quint64 now);
+    void sendQueries();
+    void sendEntityEdit(PacketType type, quint64 now);
+
+    void sendToServer(Server server, std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr = HifiSockAddr());
+    int serverForPacket(const NLPacket& packet) const;
+
+    float getPathAngle(quint64 now) const;
+    glm::vec3 getPosition(quint64 now) const;
+    glm::quat getOrientation(quint64 now) const;
+
+    const int _index;
+    const Settings _settings;
+    VirtualAgentStats& _stats;
+
+    udt::Socket* _socket;
+    HifiSockAddr _localSockAddr;
+
+    QUuid _sessionUUID;
+    bool _isConnected { false };
+    quint32 _lastDomainListRevision { 0 };
+    int _numDomainListRequests { 0 };
+
+    ServerPeer _servers[VirtualAgentStats::NumServers];
+
+    quint64 _nextCheckIn { 0 };
+    quint64 _nextAudioFrame { 0 };
+    quint64 _nextAvatarUpdate { 0 };
+    quint64 _nextQuery { 0 };
+    quint64 _nextEntityEdit { 0 };
+
+    quint16 _audioSequenceNumber { 0 };
+    int _audioClipPosition { 0 };
+
+    AvatarData _avatar;
+    AvatarDataSequenceNumber _avatarSequenceNumber { 0 };
+
+    OctreeQuery _octreeQuery;
+
+    EntityItemID _entityID;
+    bool _hasAddedEntity { false };
+    quint16 _entityEditSequenceNumber { 0 };
+};
+
+#endif // hifi_VirtualAgent_h
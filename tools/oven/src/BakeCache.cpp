@@ -0,0 +1,79 @@
+//
+//  BakeCache.cpp
+//  tools/oven/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+
+#include "ModelBakingLoggingCategory.h"
+
+#include "BakeCache.h"
+
+static const std::string BAKE_CACHE_EXTENSION = "bake";
+static const QDataStream::Version BAKE_CACHE_STREAM_VERSION = QDataStream::Qt_5_6;
+
+BakeCache::BakeCache(const std::string& dirname, QObject* parent) :
+    FileCache(dirname, BAKE_CACHE_EXTENSION, parent) {
+}
+
+BakeCache::Key BakeCache::getKey(const QString& bakerVersion, const QString& options, const QByteArray& source) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(bakerVersion.toUtf8());
+    hash.addData("\n");
+    hash.addData(options.toUtf8());
+    hash.addData("\n");
+    hash.addData(source);
+    return hash.result().toHex().toStdString();
+}
+
+bool BakeCache::read(const Key& key, BakedFiles& files) {
+    auto file = getFile(key);
+    if (!file) {
+        return false;
+    }
+
+    QFile entry { QString::fromStdString(file->getFilepath()) };
+    if (!entry.open(QIODevice::ReadOnly)) {
+        qCWarning(model_baking) << "Could not open bake cache entry" << entry.fileName();
+        return false;
+    }
+
+    QDataStream stream(&entry);
+    stream.setVersion(BAKE_CACHE_STREAM_VERSION);
+    stream >> files;
+
+    return stream.status() == QDataStream::Ok && !files.isEmpty();
+}
+
+bool BakeCache::write(const Key& key, const BakedFiles& files) {
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(BAKE_CACHE_STREAM_VERSION);
+        stream << files;
+    }
+
+    // an entry is only written after a miss, which for an existing entry means it could not be read back
+    return writeFile(data.constData(), Metadata(key, data.size()), true) != nullptr;
+}
+
+bool BakeCache::claim(const Key& key) {
+    std::lock_guard<std::mutex> lock(_claimsMutex);
+    return _claims.insert(key).second;
+}
+
+void BakeCache::release(const Key& key) {
+    {
+        std::lock_guard<std::mutex> lock(_claimsMutex);
+        _claims.erase(key);
+    }
+
+    emit released(QString::fromStdString(key));
+}
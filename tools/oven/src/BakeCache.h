@@ -0,0 +1,59 @@
+//
+//  BakeCache.h
+//  tools/oven/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeCache_h
+#define hifi_BakeCache_h
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+
+#include <shared/FileCache.h>
+
+// the files that a bake produced, by their name in its output folder
+using BakedFiles = QMap<QString, QByteArray>;
+
+// A disk cache of the results of bakes, keyed by the hash of what was baked, the version of the baker that baked it
+// and the options that change its output.  A re-bake of an asset that didn't change is a read from the cache.
+//
+// Bakers claim a key before baking it, so that bakers of the same source in the same run wait for the first one
+// instead of baking it again.  It can be used from any thread.
+class BakeCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    BakeCache(const std::string& dirname, QObject* parent = nullptr);
+
+    static Key getKey(const QString& bakerVersion, const QString& options, const QByteArray& source);
+
+    // false if there are no files cached for the key
+    bool read(const Key& key, BakedFiles& files);
+    bool write(const Key& key, const BakedFiles& files);
+
+    // true if the caller should bake the key, false if another baker has claimed it already,
+    // in which case released is emitted with that key once it is done
+    bool claim(const Key& key);
+    void release(const Key& key);
+
+signals:
+    void released(const QString& key);
+
+private:
+    std::mutex _claimsMutex;
+    std::unordered_set<Key> _claims;
+};
+
+using BakeCachePointer = std::shared_ptr<BakeCache>;
+
+#endif // hifi_BakeCache_h
@@ -9,10 +9,35 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "ModelBakingLoggingCategory.h"
 
 #include "Baker.h"
 
+void BakeStats::add(const Baker& baker) {
+    ++numBaked;
+    if (baker.wasCached()) {
+        ++numCached;
+    }
+    bakeTimeMsecs += std::max(baker.getBakeTimeMsecs(), (qint64)0);
+}
+
+BakeStats& BakeStats::operator+=(const BakeStats& other) {
+    numBaked += other.numBaked;
+    numCached += other.numCached;
+    bakeTimeMsecs += other.bakeTimeMsecs;
+    return *this;
+}
+
+Baker::Baker() {
+    connect(this, &Baker::finished, this, [this] {
+        if (_bakeTimeMsecs < 0 && _bakeTimer.isValid()) {
+            _bakeTimeMsecs = _bakeTimer.elapsed();
+        }
+    });
+}
+
 void Baker::handleError(const QString& error) {
     qCCritical(model_baking).noquote() << error;
     _errorList.append(error);
@@ -12,18 +12,45 @@
 #ifndef hifi_Baker_h
 #define hifi_Baker_h
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 
+#include "BakeCache.h"
+
+class Baker;
+
+// the number of assets of one type that were baked, how many of those came from the bake cache, and the time spent on them
+struct BakeStats {
+    int numBaked { 0 };
+    int numCached { 0 };
+    qint64 bakeTimeMsecs { 0 };
+
+    void add(const Baker& baker);
+    BakeStats& operator+=(const BakeStats& other);
+};
+
 class Baker : public QObject {
     Q_OBJECT
 
 public:
+    Baker();
+
     bool hasErrors() const { return !_errorList.isEmpty(); }
     QStringList getErrors() const { return _errorList; }
 
     bool hasWarnings() const { return !_warningList.isEmpty(); }
     QStringList getWarnings() const { return _warningList; }
 
+    // bakes with a cache read their results from it when the source didn't change, and write them to it when it did
+    void setBakeCache(BakeCachePointer bakeCache) { _bakeCache = bakeCache; }
+
+    // the time from the start of the bake to when it finished, and whether it was read from the bake cache
+    qint64 getBakeTimeMsecs() const { return _bakeTimeMsecs; }
+    bool wasCached() const { return _wasCached; }
+
+    // the size of the source that was baked, once it is loaded
+    qint64 getInputSize() const { return _inputSize; }
+
 public slots:
     virtual void bake() = 0;
 
@@ -36,8 +63,19 @@ protected:
 
     void handleErrors(const QStringList& errors);
 
+    // called by bake implementations when they start, the bake time is taken the first time they emit finished
+    void startBakeTimer() { _bakeTimer.start(); }
+
     QStringList _errorList;
     QStringList _warningList;
+
+    BakeCachePointer _bakeCache;
+    bool _wasCached { false };
+    qint64 _inputSize { 0 };
+
+private:
+    QElapsedTimer _bakeTimer;
+    qint64 _bakeTimeMsecs { -1 };
 };
 
 #endif // hifi_Baker_h
@@ -16,7 +16,9 @@
 #include "ModelBakingLoggingCategory.h"
 #include "Oven.h"
 #include "BakerCLI.h"
+#include "BatchBaker.h"
 #include "FBXBaker.h"
+#include "OBJBaker.h"
 #include "TextureBaker.h"
 
 BakerCLI::BakerCLI(Oven* parent) : QObject(parent) {
@@ -30,9 +32,11 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
     }
 
     static const QString MODEL_EXTENSION { ".fbx" };
+    static const QString OBJ_EXTENSION { ".obj" };
 
     // check what kind of baker we should be creating
     bool isFBX = inputUrl.toDisplayString().endsWith(MODEL_EXTENSION, Qt::CaseInsensitive);
+    bool isOBJ = inputUrl.toDisplayString().endsWith(OBJ_EXTENSION, Qt::CaseInsensitive);
     bool isSupportedImage = false;
 
     for (QByteArray format : QImageReader::supportedImageFormats()) {
@@ -43,6 +47,9 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
     if (isFBX) {
         _baker = std::unique_ptr<Baker> { new FBXBaker(inputUrl, outputPath, []() -> QThread* { return qApp->getNextWorkerThread(); }) };
         _baker->moveToThread(qApp->getFBXBakerThread());
+    } else if (isOBJ) {
+        _baker = std::unique_ptr<Baker> { new OBJBaker(inputUrl, outputPath, []() -> QThread* { return qApp->getNextWorkerThread(); }) };
+        _baker->moveToThread(qApp->getNextWorkerThread());
     } else if (isSupportedImage) {
         _baker = std::unique_ptr<Baker> { new TextureBaker(inputUrl, image::TextureUsage::CUBE_TEXTURE, outputPath) };
         _baker->moveToThread(qApp->getNextWorkerThread());
@@ -51,6 +58,8 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
         QApplication::exit(1);
     }
 
+    _baker->setBakeCache(qApp->getBakeCache());
+
     // invoke the bake method on the baker thread
     QMetaObject::invokeMethod(_baker.get(), "bake");
 
@@ -58,7 +67,22 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString outputPath) {
     connect(_baker.get(), &Baker::finished, this, &BakerCLI::handleFinishedBaker);
 }
 
+void BakerCLI::bakeBatch(const QUrl& manifestUrl, const QString& outputPath, const QString& reportPath, qint64 memoryBudget) {
+    // the batch baker hands its assets to the baker threads itself, so it stays on this one
+    _baker = std::unique_ptr<Baker> { new BatchBaker(manifestUrl, outputPath, reportPath, memoryBudget) };
+    _baker->setBakeCache(qApp->getBakeCache());
+
+    connect(_baker.get(), &Baker::finished, this, &BakerCLI::handleFinishedBaker);
+
+    // start the bake once the event loop is running
+    QMetaObject::invokeMethod(_baker.get(), "bake", Qt::QueuedConnection);
+}
+
 void BakerCLI::handleFinishedBaker() {
+    for (const auto& error : _baker->getErrors()) {
+        qCWarning(model_baking) << error;
+    }
+
     qCDebug(model_baking) << "Finished baking file.";
     QApplication::exit(_baker.get()->hasErrors());
 }
\ No newline at end of file
@@ -23,6 +23,7 @@ class BakerCLI : public QObject {
 public:
     BakerCLI(Oven* parent);
     void bakeFile(QUrl inputUrl, const QString outputPath);
+    void bakeBatch(const QUrl& manifestUrl, const QString& outputPath, const QString& reportPath, qint64 memoryBudget);
 
 private slots:
     void handleFinishedBaker();  
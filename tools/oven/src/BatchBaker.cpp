@@ -0,0 +1,528 @@
+//
+//  BatchBaker.cpp
+//  tools/oven/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QRegExp>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtGui/QImageReader>
+
+#include <NumericalConstants.h>
+
+#include "Gzip.h"
+
+#include "FBXBaker.h"
+#include "ModelBakingLoggingCategory.h"
+#include "OBJBaker.h"
+#include "Oven.h"
+#include "TextureBaker.h"
+
+#include "BatchBaker.h"
+
+// what a bake is estimated to hold in memory at once: a texture has its source image, a float copy of it while its
+// mips are generated, and the mips; a model has its scene, which is several times the size of its file
+static const qint64 TEXTURE_BAKE_BYTES_PER_PIXEL = 32;
+static const qint64 MODEL_BAKE_BYTES_PER_SOURCE_BYTE = 16;
+static const qint64 MIN_BAKE_MEMORY_ESTIMATE = 16 * BYTES_PER_MEGABYTE;
+
+// assets that are downloaded can't be looked at before they are baked
+static const qint64 REMOTE_BAKE_MEMORY_ESTIMATE = 256 * BYTES_PER_MEGABYTE;
+
+// an interrupted batch re-bakes no more than the assets that finished in this long before it stopped
+static const int REPORT_WRITE_INTERVAL_MSECS = 5 * MSECS_PER_SECOND;
+
+static const QString ENTITIES_OBJECT_KEY = "Entities";
+static const QString ENTITY_MODEL_URL_KEY = "modelURL";
+static const QString ENTITY_SKYBOX_KEY = "skybox";
+static const QString ENTITY_SKYBOX_URL_KEY = "url";
+static const QString ENTITY_KEYLIGHT_KEY = "keyLight";
+static const QString ENTITY_KEYLIGHT_AMBIENT_URL_KEY = "ambientURL";
+
+static const QString REPORT_MANIFEST_KEY = "manifest";
+static const QString REPORT_OUTPUT_PATH_KEY = "outputPath";
+static const QString REPORT_ELAPSED_TIME_KEY = "elapsedMsecs";
+static const QString REPORT_SUMMARY_KEY = "summary";
+static const QString REPORT_ASSETS_KEY = "assets";
+
+static const QString ASSET_URL_KEY = "url";
+static const QString ASSET_TYPE_KEY = "type";
+static const QString ASSET_TEXTURE_TYPE_KEY = "textureType";
+static const QString ASSET_STATUS_KEY = "status";
+static const QString ASSET_OUTPUT_FOLDER_KEY = "outputFolder";
+static const QString ASSET_OUTPUT_FILES_KEY = "outputFiles";
+static const QString ASSET_BAKED_FILE_KEY = "bakedFile";
+static const QString ASSET_INPUT_SIZE_KEY = "inputSize";
+static const QString ASSET_OUTPUT_SIZE_KEY = "outputSize";
+static const QString ASSET_BAKE_TIME_KEY = "bakeTimeMsecs";
+static const QString ASSET_CACHED_KEY = "cached";
+static const QString ASSET_TEXTURES_KEY = "textures";
+static const QString ASSET_ERRORS_KEY = "errors";
+static const QString ASSET_WARNINGS_KEY = "warnings";
+
+static const QString SUMMARY_NUM_ASSETS_KEY = "numAssets";
+static const QString SUMMARY_NUM_BAKED_KEY = "numBaked";
+static const QString SUMMARY_NUM_FAILED_KEY = "numFailed";
+static const QString SUMMARY_NUM_CACHED_KEY = "numCached";
+
+static const QString MODEL_ASSET_TYPE = "model";
+static const QString TEXTURE_ASSET_TYPE = "texture";
+
+static const QString BAKED_STATUS = "baked";
+static const QString FAILED_STATUS = "failed";
+static const QString PENDING_STATUS = "pending";
+
+static const QHash<QString, image::TextureUsage::Type> TEXTURE_TYPES_BY_NAME {
+    { "default", image::TextureUsage::DEFAULT_TEXTURE },
+    { "strict", image::TextureUsage::STRICT_TEXTURE },
+    { "albedo", image::TextureUsage::ALBEDO_TEXTURE },
+    { "normal", image::TextureUsage::NORMAL_TEXTURE },
+    { "bump", image::TextureUsage::BUMP_TEXTURE },
+    { "specular", image::TextureUsage::SPECULAR_TEXTURE },
+    { "roughness", image::TextureUsage::ROUGHNESS_TEXTURE },
+    { "gloss", image::TextureUsage::GLOSS_TEXTURE },
+    { "emissive", image::TextureUsage::EMISSIVE_TEXTURE },
+    { "cube", image::TextureUsage::CUBE_TEXTURE },
+    { "occlusion", image::TextureUsage::OCCLUSION_TEXTURE },
+    { "lightmap", image::TextureUsage::LIGHTMAP_TEXTURE }
+};
+
+BatchBaker::BatchBaker(const QUrl& manifestURL, const QString& outputPath, const QString& reportPath, qint64 memoryBudget) :
+    _manifestURL(manifestURL),
+    _outputPath(outputPath),
+    _reportPath(reportPath),
+    _memoryBudget(memoryBudget)
+{
+
+}
+
+void BatchBaker::bake() {
+    startBakeTimer();
+    _batchTimer.start();
+
+    if (!QDir().mkpath(_outputPath)) {
+        handleError("Could not create output folder " + _outputPath);
+        return;
+    }
+
+    loadManifest();
+
+    if (hasErrors()) {
+        return;
+    }
+
+    loadPreviousReport();
+
+    for (int i = 0; i < (int)_assets.size(); ++i) {
+        if (!_assets[i].isFinished) {
+            _pendingAssets.enqueue(i);
+        }
+    }
+
+    // FBX bakes all wait for the one FBX thread, the others each take a worker thread
+    _maxConcurrentBakes = std::max(QThread::idealThreadCount(), 1);
+
+    _reportTimer = new QTimer(this);
+    _reportTimer->setSingleShot(true);
+    _reportTimer->setInterval(REPORT_WRITE_INTERVAL_MSECS);
+    connect(_reportTimer, &QTimer::timeout, this, &BatchBaker::writeReport);
+
+    qCDebug(model_baking) << "Baking" << _pendingAssets.size() << "of" << _assets.size() << "assets from" << _manifestURL
+        << "with a memory budget of" << _memoryBudget / BYTES_PER_MEGABYTE << "MB";
+
+    startNextBakes();
+
+    // in case every asset was baked by a previous run
+    checkIfFinished();
+}
+
+void BatchBaker::loadManifest() {
+    QFile manifestFile { _manifestURL.toLocalFile() };
+
+    if (!manifestFile.open(QIODevice::ReadOnly)) {
+        handleError("Could not open manifest " + manifestFile.fileName());
+        return;
+    }
+
+    auto contents = manifestFile.readAll();
+
+    // check if we need to inflate a gzipped entities file
+    if (QFileInfo(manifestFile.fileName()).suffix() == "gz") {
+        QByteArray uncompressedContents;
+        gunzip(contents, uncompressedContents);
+        contents = uncompressedContents;
+    }
+
+    // a manifest that isn't a JSON object is a list of assets
+    QJsonParseError parseError;
+    auto jsonDocument = QJsonDocument::fromJson(contents, &parseError);
+
+    if (parseError.error == QJsonParseError::NoError && jsonDocument.isObject()) {
+        loadDomainManifest(jsonDocument.object());
+    } else {
+        loadAssetList(contents);
+    }
+
+    if (_assets.empty()) {
+        handleError("There are no assets to bake in " + manifestFile.fileName());
+    }
+}
+
+void BatchBaker::loadDomainManifest(const QJsonObject& domain) {
+    for (const auto& entityValue : domain[ENTITIES_OBJECT_KEY].toArray()) {
+        auto entity = entityValue.toObject();
+
+        if (entity.contains(ENTITY_MODEL_URL_KEY)) {
+            QUrl modelURL { entity[ENTITY_MODEL_URL_KEY].toString() };
+
+            // models that are baked already are left alone
+            if (!modelURL.fileName().contains(".baked.", Qt::CaseInsensitive)) {
+                addAsset(modelURL.adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment), image::TextureUsage::DEFAULT_TEXTURE);
+            }
+        }
+
+        auto skyboxURL = entity[ENTITY_SKYBOX_KEY].toObject()[ENTITY_SKYBOX_URL_KEY].toString();
+        if (!skyboxURL.isEmpty()) {
+            addAsset(QUrl(skyboxURL).adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment), image::TextureUsage::CUBE_TEXTURE);
+        }
+
+        auto ambientURL = entity[ENTITY_KEYLIGHT_KEY].toObject()[ENTITY_KEYLIGHT_AMBIENT_URL_KEY].toString();
+        if (!ambientURL.isEmpty()) {
+            addAsset(QUrl(ambientURL).adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment), image::TextureUsage::CUBE_TEXTURE);
+        }
+    }
+}
+
+void BatchBaker::loadAssetList(const QByteArray& assetList) {
+    // relative paths are relative to the folder of the list
+    auto manifestDir = QFileInfo(_manifestURL.toLocalFile()).absoluteDir();
+
+    for (const auto& rawLine : assetList.split('\n')) {
+        auto line = QString::fromUtf8(rawLine).trimmed();
+
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        // the texture type is optional, so a last word that isn't one is part of the path
+        auto textureType = image::TextureUsage::DEFAULT_TEXTURE;
+        auto typeSeparator = line.lastIndexOf(QRegExp("\\s"));
+        if (typeSeparator > 0) {
+            auto typeName = line.mid(typeSeparator + 1).toLower();
+            if (TEXTURE_TYPES_BY_NAME.contains(typeName)) {
+                textureType = TEXTURE_TYPES_BY_NAME[typeName];
+                line = line.left(typeSeparator).trimmed();
+            }
+        }
+
+        QUrl url { line };
+        if (url.scheme() != "http" && url.scheme() != "https" && url.scheme() != "ftp" && url.scheme() != "file") {
+            url = QUrl::fromLocalFile(manifestDir.absoluteFilePath(line));
+        }
+
+        addAsset(url, textureType);
+    }
+}
+
+void BatchBaker::addAsset(const QUrl& url, image::TextureUsage::Type textureType) {
+    if (_assetIndices.contains(url)) {
+        return;
+    }
+
+    auto suffix = QFileInfo(url.fileName()).suffix().toLower();
+
+    Asset asset;
+    asset.url = url;
+    asset.textureType = textureType;
+
+    if (suffix == "fbx" || suffix == "obj") {
+        asset.type = AssetType::Model;
+    } else if (QImageReader::supportedImageFormats().contains(suffix.toLatin1())) {
+        asset.type = AssetType::Texture;
+    } else {
+        handleWarning("Skipping " + url.toString() + ", it is neither a model nor an image the oven can bake");
+        return;
+    }
+
+    // the same asset always bakes to the same folder, which is what lets a batch resume
+    auto urlHash = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex().left(8);
+    asset.outputFolder = QFileInfo(url.fileName()).completeBaseName() + "-" + urlHash;
+
+    asset.memoryEstimate = REMOTE_BAKE_MEMORY_ESTIMATE;
+    if (url.isLocalFile()) {
+        auto filePath = url.toLocalFile();
+
+        if (asset.type == AssetType::Texture) {
+            auto imageSize = QImageReader(filePath).size();
+            if (imageSize.isValid()) {
+                asset.memoryEstimate = (qint64)imageSize.width() * imageSize.height() * TEXTURE_BAKE_BYTES_PER_PIXEL;
+            }
+        } else {
+            // the textures of a model are baked while it holds its share of the budget
+            asset.memoryEstimate = QFileInfo(filePath).size() * MODEL_BAKE_BYTES_PER_SOURCE_BYTE;
+        }
+
+        asset.memoryEstimate = std::max(asset.memoryEstimate, MIN_BAKE_MEMORY_ESTIMATE);
+    }
+
+    _assetIndices.insert(url, (int)_assets.size());
+    _assets.push_back(asset);
+}
+
+void BatchBaker::loadPreviousReport() {
+    QFile reportFile { _reportPath };
+
+    if (!reportFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    auto previousAssets = QJsonDocument::fromJson(reportFile.readAll()).object()[REPORT_ASSETS_KEY].toArray();
+    int numResumed = 0;
+
+    for (const auto& previousAsset : previousAssets) {
+        auto result = previousAsset.toObject();
+        auto it = _assetIndices.find(QUrl(result[ASSET_URL_KEY].toString()));
+
+        if (it == _assetIndices.end() || result[ASSET_STATUS_KEY].toString() != BAKED_STATUS) {
+            continue;
+        }
+
+        // the output of an asset that was baked is kept as long as it is still there
+        auto& asset = _assets[it.value()];
+        if (result[ASSET_OUTPUT_FOLDER_KEY].toString() == asset.outputFolder && QDir(_outputPath).exists(asset.outputFolder)) {
+            asset.isFinished = true;
+            asset.result = result;
+            ++numResumed;
+        }
+    }
+
+    if (numResumed > 0) {
+        qCDebug(model_baking) << "Resuming from" << _reportPath << "where" << numResumed << "assets were baked";
+    }
+}
+
+void BatchBaker::startNextBakes() {
+    while (!_pendingAssets.isEmpty() && _bakingAssets.size() < _maxConcurrentBakes) {
+        // one bake always runs, even when it alone is over the budget
+        auto memoryEstimate = _assets[_pendingAssets.head()].memoryEstimate;
+        if (!_bakingAssets.isEmpty() && _memoryInUse + memoryEstimate > _memoryBudget) {
+            break;
+        }
+
+        startBake(_pendingAssets.dequeue());
+    }
+}
+
+void BatchBaker::startBake(int index) {
+    auto& asset = _assets[index];
+
+    // whatever an interrupted bake of this asset left behind is replaced
+    QDir outputDir { _outputPath };
+    QDir(outputDir.absoluteFilePath(asset.outputFolder)).removeRecursively();
+    outputDir.mkpath(asset.outputFolder);
+
+    auto assetOutputPath = outputDir.absoluteFilePath(asset.outputFolder);
+    auto textureThreadGetter = []() -> QThread* {
+        return qApp->getNextWorkerThread();
+    };
+
+    QSharedPointer<Baker> baker;
+    QThread* bakerThread;
+
+    if (asset.type == AssetType::Texture) {
+        baker = QSharedPointer<Baker>(new TextureBaker(asset.url, asset.textureType, assetOutputPath), &Baker::deleteLater);
+        bakerThread = qApp->getNextWorkerThread();
+    } else if (asset.url.fileName().endsWith(".obj", Qt::CaseInsensitive)) {
+        baker = QSharedPointer<Baker>(new OBJBaker(asset.url, assetOutputPath, textureThreadGetter), &Baker::deleteLater);
+        bakerThread = qApp->getNextWorkerThread();
+    } else {
+        baker = QSharedPointer<Baker>(new FBXBaker(asset.url, assetOutputPath, textureThreadGetter, false), &Baker::deleteLater);
+        bakerThread = qApp->getFBXBakerThread();
+    }
+
+    baker->setBakeCache(_bakeCache);
+
+    connect(baker.data(), &Baker::finished, this, [this, index] {
+        handleFinishedAsset(index);
+    });
+
+    _bakingAssets.insert(index, baker);
+    _memoryInUse += asset.memoryEstimate;
+
+    baker->moveToThread(bakerThread);
+    QMetaObject::invokeMethod(baker.data(), "bake");
+}
+
+void BatchBaker::handleFinishedAsset(int index) {
+    auto baker = _bakingAssets.take(index);
+
+    if (!baker) {
+        return;
+    }
+
+    auto& asset = _assets[index];
+    _memoryInUse -= asset.memoryEstimate;
+
+    QJsonObject result;
+    result[ASSET_URL_KEY] = asset.url.toString();
+    result[ASSET_TYPE_KEY] = asset.type == AssetType::Model ? MODEL_ASSET_TYPE : TEXTURE_ASSET_TYPE;
+    if (asset.type == AssetType::Texture) {
+        result[ASSET_TEXTURE_TYPE_KEY] = TEXTURE_TYPES_BY_NAME.key(asset.textureType);
+    }
+    result[ASSET_STATUS_KEY] = baker->hasErrors() ? FAILED_STATUS : BAKED_STATUS;
+    result[ASSET_OUTPUT_FOLDER_KEY] = asset.outputFolder;
+
+    // the output is what the bake left in the folder of the asset, relative to the output path
+    QDir outputDir { _outputPath };
+    QJsonArray outputFiles;
+    qint64 outputSize = 0;
+
+    QDirIterator outputIterator(outputDir.absoluteFilePath(asset.outputFolder), QDir::Files, QDirIterator::Subdirectories);
+    while (outputIterator.hasNext()) {
+        outputIterator.next();
+        outputFiles.append(outputDir.relativeFilePath(outputIterator.filePath()));
+        outputSize += outputIterator.fileInfo().size();
+    }
+
+    result[ASSET_OUTPUT_FILES_KEY] = outputFiles;
+    result[ASSET_INPUT_SIZE_KEY] = (double)baker->getInputSize();
+    result[ASSET_OUTPUT_SIZE_KEY] = (double)outputSize;
+    result[ASSET_BAKE_TIME_KEY] = (double)std::max(baker->getBakeTimeMsecs(), (qint64)0);
+    result[ASSET_CACHED_KEY] = baker->wasCached();
+
+    // the file to point to in place of the original, and the textures that were baked with a model
+    QString bakedFile;
+    BakeStats textureStats;
+
+    if (auto textureBaker = qobject_cast<TextureBaker*>(baker.data())) {
+        bakedFile = textureBaker->getBakedTextureFileName();
+    } else if (auto objBaker = qobject_cast<OBJBaker*>(baker.data())) {
+        bakedFile = objBaker->getBakedOBJRelativePath();
+        textureStats = objBaker->getTextureStats();
+    } else if (auto fbxBaker = qobject_cast<FBXBaker*>(baker.data())) {
+        bakedFile = fbxBaker->getBakedFBXRelativePath();
+        textureStats = fbxBaker->getTextureStats();
+    }
+
+    if (!baker->hasErrors() && !bakedFile.isEmpty()) {
+        result[ASSET_BAKED_FILE_KEY] = asset.outputFolder + "/" + bakedFile;
+    }
+
+    if (asset.type == AssetType::Model) {
+        QJsonObject textures;
+        textures[SUMMARY_NUM_BAKED_KEY] = textureStats.numBaked;
+        textures[SUMMARY_NUM_CACHED_KEY] = textureStats.numCached;
+        textures[ASSET_BAKE_TIME_KEY] = (double)textureStats.bakeTimeMsecs;
+        result[ASSET_TEXTURES_KEY] = textures;
+    }
+
+    if (baker->hasErrors()) {
+        result[ASSET_ERRORS_KEY] = QJsonArray::fromStringList(baker->getErrors());
+        qCWarning(model_baking) << "Failed to bake" << asset.url;
+    }
+
+    if (baker->hasWarnings()) {
+        result[ASSET_WARNINGS_KEY] = QJsonArray::fromStringList(baker->getWarnings());
+    }
+
+    asset.isFinished = true;
+    asset.result = result;
+
+    if (!_reportTimer->isActive()) {
+        _reportTimer->start();
+    }
+
+    startNextBakes();
+    checkIfFinished();
+}
+
+void BatchBaker::checkIfFinished() {
+    if (!_pendingAssets.isEmpty() || !_bakingAssets.isEmpty()) {
+        return;
+    }
+
+    _reportTimer->stop();
+    writeReport();
+
+    auto numFailed = std::count_if(_assets.cbegin(), _assets.cend(), [](const Asset& asset) {
+        return asset.result[ASSET_STATUS_KEY].toString() == FAILED_STATUS;
+    });
+
+    qCDebug(model_baking) << "Finished baking" << _assets.size() << "assets," << numFailed << "failed, the report is at"
+        << _reportPath;
+
+    if (numFailed > 0) {
+        _errorList << QString("%1 of %2 assets failed to bake").arg(numFailed).arg(_assets.size());
+    }
+
+    emit finished();
+}
+
+void BatchBaker::writeReport() {
+    // the report is replaced in one go, so an interruption leaves the previous one
+    QSaveFile reportFile { _reportPath };
+
+    if (!reportFile.open(QIODevice::WriteOnly) || reportFile.write(QJsonDocument(createReport()).toJson()) == -1
+        || !reportFile.commit()) {
+        handleWarning("Could not write bake report " + _reportPath);
+    }
+}
+
+QJsonObject BatchBaker::createReport() const {
+    QJsonArray assets;
+    QJsonObject modelSummary;
+    QJsonObject textureSummary;
+
+    for (const auto& asset : _assets) {
+        auto& summary = asset.type == AssetType::Model ? modelSummary : textureSummary;
+        summary[SUMMARY_NUM_ASSETS_KEY] = summary[SUMMARY_NUM_ASSETS_KEY].toInt() + 1;
+
+        if (!asset.isFinished) {
+            QJsonObject pending;
+            pending[ASSET_URL_KEY] = asset.url.toString();
+            pending[ASSET_TYPE_KEY] = asset.type == AssetType::Model ? MODEL_ASSET_TYPE : TEXTURE_ASSET_TYPE;
+            pending[ASSET_STATUS_KEY] = PENDING_STATUS;
+            assets.append(pending);
+            continue;
+        }
+
+        const auto& result = asset.result;
+        assets.append(result);
+
+        auto countKey = result[ASSET_STATUS_KEY].toString() == BAKED_STATUS ? SUMMARY_NUM_BAKED_KEY : SUMMARY_NUM_FAILED_KEY;
+        summary[countKey] = summary[countKey].toInt() + 1;
+        if (result[ASSET_CACHED_KEY].toBool()) {
+            summary[SUMMARY_NUM_CACHED_KEY] = summary[SUMMARY_NUM_CACHED_KEY].toInt() + 1;
+        }
+
+        for (const auto& key : { ASSET_INPUT_SIZE_KEY, ASSET_OUTPUT_SIZE_KEY, ASSET_BAKE_TIME_KEY }) {
+            summary[key] = summary[key].toDouble() + result[key].toDouble();
+        }
+    }
+
+    QJsonObject summaries;
+    summaries[MODEL_ASSET_TYPE] = modelSummary;
+    summaries[TEXTURE_ASSET_TYPE] = textureSummary;
+
+    QJsonObject report;
+    report[REPORT_MANIFEST_KEY] = _manifestURL.toString();
+    report[REPORT_OUTPUT_PATH_KEY] = _outputPath;
+    report[REPORT_ELAPSED_TIME_KEY] = (double)_batchTimer.elapsed();
+    report[REPORT_SUMMARY_KEY] = summaries;
+    report[REPORT_ASSETS_KEY] = assets;
+    return report;
+}
@@ -0,0 +1,97 @@
+//
+//  BatchBaker.h
+//  tools/oven/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BatchBaker_h
+#define hifi_BatchBaker_h
+
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QQueue>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+
+#include <image/Image.h>
+
+#include "Baker.h"
+
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+
+// Bakes every model and texture of a manifest, without the GUI.  The manifest is either a domain entities file, of
+// which the models and skyboxes are baked, or a list of assets with one URL or path per line, optionally followed by
+// the texture type of an image.
+//
+// As many assets are baked at once as there are threads, as long as the memory their bakes are estimated to take
+// stays within the budget.  Each asset is baked to a folder of its own under the output path, and the JSON report
+// is re-written as they finish.  Assets that the report lists as baked are skipped when a batch is run again, so an
+// interrupted batch resumes where it left off.
+class BatchBaker : public Baker {
+    Q_OBJECT
+
+public:
+    BatchBaker(const QUrl& manifestURL, const QString& outputPath, const QString& reportPath, qint64 memoryBudget);
+
+public slots:
+    virtual void bake() override;
+
+private slots:
+    void writeReport();
+
+private:
+    enum class AssetType { Model, Texture };
+
+    struct Asset {
+        QUrl url;
+        AssetType type;
+        image::TextureUsage::Type textureType { image::TextureUsage::DEFAULT_TEXTURE };
+
+        // relative to the output path
+        QString outputFolder;
+        qint64 memoryEstimate { 0 };
+
+        bool isFinished { false };
+        QJsonObject result;
+    };
+
+    void loadManifest();
+    void loadDomainManifest(const QJsonObject& domain);
+    void loadAssetList(const QByteArray& assetList);
+    void addAsset(const QUrl& url, image::TextureUsage::Type textureType);
+
+    void loadPreviousReport();
+
+    void startNextBakes();
+    void startBake(int index);
+    void handleFinishedAsset(int index);
+    void checkIfFinished();
+
+    QJsonObject createReport() const;
+
+    QUrl _manifestURL;
+    QString _outputPath;
+    QString _reportPath;
+    qint64 _memoryBudget;
+
+    std::vector<Asset> _assets;
+    QHash<QUrl, int> _assetIndices;
+
+    QQueue<int> _pendingAssets;
+    QHash<int, QSharedPointer<Baker>> _bakingAssets;
+    int _maxConcurrentBakes { 1 };
+    qint64 _memoryInUse { 0 };
+
+    QTimer* _reportTimer { nullptr };
+    QElapsedTimer _batchTimer;
+};
+
+#endif // hifi_BatchBaker_h
@@ -16,6 +16,8 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 
+#include <NumericalConstants.h>
+
 #include "Gzip.h"
 
 #include "Oven.h"
@@ -39,6 +41,8 @@ DomainBaker::DomainBaker(const QUrl& localModelFileURL, const QString& domainNam
 }
 
 void DomainBaker::bake() {
+    startBakeTimer();
+
     setupOutputFolder();
 
     if (hasErrors()) {
@@ -198,6 +202,8 @@ void DomainBaker::enumerateEntities() {
                             }), &FBXBaker::deleteLater
                         };
 
+                        baker->setBakeCache(_bakeCache);
+
                         // make sure our handler is called when the baker is done
                         connect(baker.data(), &Baker::finished, this, &DomainBaker::handleFinishedModelBaker);
 
@@ -270,6 +276,8 @@ void DomainBaker::bakeSkybox(QUrl skyboxURL, QJsonValueRef entity) {
                 &TextureBaker::deleteLater
             };
 
+            skyboxBaker->setBakeCache(_bakeCache);
+
             // make sure our handler is called when the skybox baker is done
             connect(skyboxBaker.data(), &TextureBaker::finished, this, &DomainBaker::handleFinishedSkyboxBaker);
 
@@ -294,6 +302,9 @@ void DomainBaker::handleFinishedModelBaker() {
     auto baker = qobject_cast<FBXBaker*>(sender());
 
     if (baker) {
+        _modelStats.add(*baker);
+        _textureStats += baker->getTextureStats();
+
         if (!baker->hasErrors()) {
             // this FBXBaker is done and everything went according to plan
             qDebug() << "Re-writing entity references to" << baker->getFBXUrl();
@@ -375,6 +386,8 @@ void DomainBaker::handleFinishedSkyboxBaker() {
     auto baker = qobject_cast<TextureBaker*>(sender());
 
     if (baker) {
+        _skyboxStats.add(*baker);
+
         if (!baker->hasErrors()) {
             // this FBXBaker is done and everything went according to plan
             qDebug() << "Re-writing entity references to" << baker->getTextureURL();
@@ -458,6 +471,8 @@ void DomainBaker::checkIfRewritingComplete() {
             return;
         }
 
+        logBakeStats();
+
         // we've now written out our new models file - time to say that we are finished up
         emit finished();
     }
@@ -500,3 +515,16 @@ void DomainBaker::writeNewEntitiesFile() {
     qDebug() << "Exported entities file with baked model URLs to" << bakedEntitiesFilePath;
 }
 
+void DomainBaker::logBakeStats() {
+    // bakes of different assets overlap, so the time for each type is the sum of the time each of its bakes took
+    auto logStats = [](const char* type, const BakeStats& stats) {
+        if (stats.numBaked > 0) {
+            qDebug().nospace() << "Baked " << stats.numBaked << " " << type << " in "
+                << (float)stats.bakeTimeMsecs / MSECS_PER_SECOND << "s, " << stats.numCached << " from the bake cache";
+        }
+    };
+
+    logStats("models", _modelStats);
+    logStats("model textures", _textureStats);
+    logStats("skyboxes", _skyboxStats);
+}
@@ -31,6 +31,11 @@ public:
                 const QString& baseOutputPath, const QUrl& destinationPath,
                 bool shouldRebakeOriginals = false);
 
+    // the models, the textures linked from them, and the skyboxes baked so far
+    const BakeStats& getModelStats() const { return _modelStats; }
+    const BakeStats& getTextureStats() const { return _textureStats; }
+    const BakeStats& getSkyboxStats() const { return _skyboxStats; }
+
 signals:
     void allModelsFinished();
     void bakeProgress(int baked, int total);
@@ -46,6 +51,7 @@ private:
     void enumerateEntities();
     void checkIfRewritingComplete();
     void writeNewEntitiesFile();
+    void logBakeStats();
 
     void bakeSkybox(QUrl skyboxURL, QJsonValueRef entity);
     bool rewriteSkyboxURL(QJsonValueRef urlValue, TextureBaker* baker);
@@ -68,6 +74,10 @@ private:
     int _completedSubBakes { 0 };
 
     bool _shouldRebakeOriginals { false };
+
+    BakeStats _modelStats;
+    BakeStats _textureStats;
+    BakeStats _skyboxStats;
 };
 
 #endif // hifi_DomainBaker_h
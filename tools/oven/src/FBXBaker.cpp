@@ -11,13 +11,18 @@
 
 #include <cmath> // need this include so we don't get an error looking for std::isnan
 
+#ifdef HAVE_FBX_SDK
 #include <fbxsdk.h>
+#endif
 
 #include <QtConcurrent>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
 #include <QtCore/QEventLoop>
 #include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QThread>
 
 #include <mutex>
@@ -30,6 +35,8 @@
 
 #include "FBXBaker.h"
 
+#ifdef HAVE_FBX_SDK
+
 std::once_flag onceFlag;
 FBXSDKManagerUniquePointer FBXBaker::_sdkManager { nullptr };
 
@@ -62,6 +69,8 @@ QString FBXBaker::pathToCopyOfOriginal() const {
 void FBXBaker::bake() {
     qCDebug(model_baking) << "Baking" << _fbxURL;
 
+    startBakeTimer();
+
     // setup the output folder for the results of this bake
     setupOutputFolder();
 
@@ -76,6 +85,21 @@ void FBXBaker::bake() {
 }
 
 void FBXBaker::bakeSourceCopy() {
+    _inputSize = QFileInfo(pathToCopyOfOriginal()).size();
+
+    if (_bakeCache) {
+        QFile copyOfOriginal { pathToCopyOfOriginal() };
+        if (!copyOfOriginal.open(QIODevice::ReadOnly)) {
+            handleError("Could not read copy of " + _fbxURL.toString());
+            return;
+        }
+
+        // an FBX that was baked before skips the FBX SDK, only its linked textures are checked for changes
+        if (restoreFromCache(copyOfOriginal.readAll())) {
+            return;
+        }
+    }
+
     // load the scene from the FBX file
     importScene();
 
@@ -375,6 +399,8 @@ void FBXBaker::rewriteAndBakeSceneTextures() {
                                 // figure out the URL to this texture, embedded or external
                                 auto urlToTexture = getTextureURL(textureFileInfo, fileTexture);
 
+                                _sceneTextures.append({ urlToTexture, textureType, bakedTextureFileName });
+
                                 // write the new filename into the FBX scene
                                 fileTexture->SetFileName(bakedTextureFilePath.toLocal8Bit());
 
@@ -404,6 +430,8 @@ void FBXBaker::bakeTexture(const QUrl& textureURL, image::TextureUsage::Type tex
         &TextureBaker::deleteLater
     };
 
+    bakingTexture->setBakeCache(_bakeCache);
+
     // make sure we hear when the baking texture is done
     connect(bakingTexture.data(), &Baker::finished, this, &FBXBaker::handleBakedTexture);
 
@@ -420,19 +448,15 @@ void FBXBaker::handleBakedTexture() {
 
     // make sure we haven't already run into errors, and that this is a valid texture
     if (bakedTexture) {
+        _textureStats.add(*bakedTexture);
+
         if (!hasErrors()) {
             if (!bakedTexture->hasErrors()) {
                 if (_copyOriginals) {
                     // we've been asked to make copies of the originals, so we need to make copies of this if it is a linked texture
 
                     // use the path to the texture being baked to determine if this was an embedded or a linked texture
-
-                    // it is embeddded if the texure being baked was inside the original output folder
-                    // since that is where the FBX SDK places the .fbm folder it generates when importing the FBX
-
-                    auto originalOutputFolder = QUrl::fromLocalFile(_uniqueOutputPath + ORIGINAL_OUTPUT_SUBFOLDER);
-
-                    if (!originalOutputFolder.isParentOf(bakedTexture->getTextureURL())) {
+                    if (!isEmbeddedTexture(bakedTexture->getTextureURL())) {
                         // for linked textures we want to save a copy of original texture beside the original FBX
 
                         qCDebug(model_baking) << "Saving original texture for" << bakedTexture->getTextureURL();
@@ -487,6 +511,13 @@ void FBXBaker::handleBakedTexture() {
     }
 }
 
+bool FBXBaker::isEmbeddedTexture(const QUrl& textureURL) const {
+    // it is embeddded if the texure being baked was inside the original output folder
+    // since that is where the FBX SDK places the .fbm folder it generates when importing the FBX
+    auto originalOutputFolder = QUrl::fromLocalFile(_uniqueOutputPath + ORIGINAL_OUTPUT_SUBFOLDER);
+    return originalOutputFolder.isParentOf(textureURL);
+}
+
 void FBXBaker::exportScene() {
     // setup the exporter
     FbxExporter* exporter = FbxExporter::Create(_sdkManager.get(), "");
@@ -548,7 +579,130 @@ void FBXBaker::checkIfTexturesFinished() {
         } else {
             qCDebug(model_baking) << "Finished baking" << _fbxURL;
 
+            if (_bakeCache && !_wasCached) {
+                writeToCache();
+            }
+
             emit finished();
         }
     }
 }
+
+// the bake cache entry of an FBX holds the linked textures under this name, beside the baked FBX and its embedded textures
+static const QString LINKED_TEXTURES_CACHE_FILE_NAME = "linked-textures.json";
+static const QString LINKED_TEXTURE_URL_KEY = "url";
+static const QString LINKED_TEXTURE_TYPE_KEY = "type";
+
+QString FBXBaker::getBakeCacheOptions() const {
+    // linked textures are resolved relative to the FBX, and embedded textures are baked into the entry
+    return "url:" + _fbxURL.toString() + " texture:" + TEXTURE_BAKER_VERSION + " " + TextureBaker::getCacheOptions();
+}
+
+bool FBXBaker::restoreFromCache(const QByteArray& originalFBX) {
+    _cacheKey = BakeCache::getKey(FBX_BAKER_VERSION, getBakeCacheOptions(), originalFBX);
+
+    BakedFiles cachedFiles;
+    if (!_bakeCache->read(_cacheKey, cachedFiles)) {
+        return false;
+    }
+
+    auto linkedTextures = QJsonDocument::fromJson(cachedFiles.take(LINKED_TEXTURES_CACHE_FILE_NAME)).array();
+    auto bakedFBXFileName = _fbxName + BAKED_FBX_EXTENSION;
+
+    if (!cachedFiles.contains(bakedFBXFileName)) {
+        handleWarning("Bake cache entry for " + _fbxURL.toString() + " has no baked FBX, it will be re-baked");
+        return false;
+    }
+
+    // the baked FBX and its embedded textures
+    for (auto it = cachedFiles.cbegin(); it != cachedFiles.cend(); ++it) {
+        QFile bakedFile { _uniqueOutputPath + BAKED_OUTPUT_SUBFOLDER + it.key() };
+        if (!bakedFile.open(QIODevice::WriteOnly) || bakedFile.write(it.value()) == -1) {
+            handleError("Could not write " + bakedFile.fileName() + " from the bake cache");
+            return true;
+        }
+    }
+
+    _bakedFBXRelativePath = _uniqueOutputPath + BAKED_OUTPUT_SUBFOLDER + bakedFBXFileName;
+    _bakedFBXRelativePath.remove(_baseOutputPath + "/");
+    _wasCached = true;
+
+    qCDebug(model_baking) << "Restored baked FBX" << _fbxURL << "from the bake cache";
+
+    // the linked textures can change without the FBX changing, so they go through their own bakes and cache entries
+    for (const auto& linkedTexture : linkedTextures) {
+        auto textureObject = linkedTexture.toObject();
+        QUrl textureURL { textureObject[LINKED_TEXTURE_URL_KEY].toString() };
+        auto textureType = (image::TextureUsage::Type)textureObject[LINKED_TEXTURE_TYPE_KEY].toInt();
+
+        if (!_bakingTextures.contains(textureURL)) {
+            bakeTexture(textureURL, textureType, _uniqueOutputPath + BAKED_OUTPUT_SUBFOLDER);
+        }
+    }
+
+    checkIfTexturesFinished();
+    return true;
+}
+
+void FBXBaker::writeToCache() {
+    QDir bakedOutputDir { _uniqueOutputPath + BAKED_OUTPUT_SUBFOLDER };
+    BakedFiles bakedFiles;
+    QJsonArray linkedTextures;
+
+    QStringList bakedFileNames { _fbxName + BAKED_FBX_EXTENSION };
+    QSet<QUrl> linkedTextureURLs;
+
+    for (const auto& sceneTexture : _sceneTextures) {
+        if (isEmbeddedTexture(sceneTexture.url)) {
+            bakedFileNames << sceneTexture.bakedFileName;
+        } else if (!linkedTextureURLs.contains(sceneTexture.url)) {
+            linkedTextureURLs.insert(sceneTexture.url);
+
+            QJsonObject textureObject;
+            textureObject[LINKED_TEXTURE_URL_KEY] = sceneTexture.url.toString();
+            textureObject[LINKED_TEXTURE_TYPE_KEY] = (int)sceneTexture.type;
+            linkedTextures.append(textureObject);
+        }
+    }
+
+    for (const auto& bakedFileName : bakedFileNames) {
+        QFile bakedFile { bakedOutputDir.absoluteFilePath(bakedFileName) };
+        if (!bakedFile.open(QIODevice::ReadOnly)) {
+            handleWarning("Could not add " + bakedFile.fileName() + " to the bake cache");
+            return;
+        }
+        bakedFiles.insert(bakedFileName, bakedFile.readAll());
+    }
+
+    bakedFiles.insert(LINKED_TEXTURES_CACHE_FILE_NAME, QJsonDocument(linkedTextures).toJson(QJsonDocument::Compact));
+
+    if (!_bakeCache->write(_cacheKey, bakedFiles)) {
+        handleWarning("Could not add baked FBX for " + _fbxURL.toString() + " to the bake cache");
+    }
+}
+
+#else
+
+// without the FBX SDK the oven still bakes textures and OBJ models, and an FBX bake fails right away
+
+FBXBaker::FBXBaker(const QUrl& fbxURL, const QString& baseOutputPath,
+                   TextureBakerThreadGetter textureThreadGetter, bool copyOriginals) :
+    _fbxURL(fbxURL),
+    _baseOutputPath(baseOutputPath),
+    _textureThreadGetter(textureThreadGetter),
+    _copyOriginals(copyOriginals)
+{
+    auto fileName = fbxURL.fileName();
+    _fbxName = fileName.left(fileName.lastIndexOf('.'));
+}
+
+void FBXBaker::bake() {
+    startBakeTimer();
+    handleError("Could not bake " + _fbxURL.toString() + ", the oven was built without the FBX SDK");
+}
+
+void FBXBaker::bakeSourceCopy() {}
+void FBXBaker::handleFBXNetworkReply() {}
+void FBXBaker::handleBakedTexture() {}
+
+#endif // HAVE_FBX_SDK
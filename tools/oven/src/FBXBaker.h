@@ -30,9 +30,10 @@ namespace fbxsdk {
 }
 
 static const QString BAKED_FBX_EXTENSION = ".baked.fbx";
-using FBXSDKManagerUniquePointer = std::unique_ptr<fbxsdk::FbxManager, std::function<void (fbxsdk::FbxManager *)>>;
 
-using TextureBakerThreadGetter = std::function<QThread*()>;
+// bump this when a change to the FBX baker changes what it outputs, so cached bakes are not re-used
+static const QString FBX_BAKER_VERSION = "1";
+using FBXSDKManagerUniquePointer = std::unique_ptr<fbxsdk::FbxManager, std::function<void (fbxsdk::FbxManager *)>>;
 
 class FBXBaker : public Baker {
     Q_OBJECT
@@ -43,6 +44,9 @@ public:
     QUrl getFBXUrl() const { return _fbxURL; }
     QString getBakedFBXRelativePath() const { return _bakedFBXRelativePath; }
 
+    // the textures linked from this FBX that were baked along with it
+    const BakeStats& getTextureStats() const { return _textureStats; }
+
 public slots:
     // all calls to FBXBaker::bake for FBXBaker instances must be from the same thread
     // because the Autodesk SDK will cause a crash if it is called from multiple threads
@@ -71,6 +75,12 @@ private:
 
     void checkIfTexturesFinished();
 
+    QString getBakeCacheOptions() const;
+    bool restoreFromCache(const QByteArray& originalFBX);
+    void writeToCache();
+
+    bool isEmbeddedTexture(const QUrl& textureURL) const;
+
     QString createBakedTextureFileName(const QFileInfo& textureFileInfo);
     QUrl getTextureURL(const QFileInfo& textureFileInfo, fbxsdk::FbxFileTexture* fileTexture);
 
@@ -91,6 +101,17 @@ private:
     QMultiHash<QUrl, QSharedPointer<TextureBaker>> _bakingTextures;
     QHash<QString, int> _textureNameMatchCount;
 
+    // the textures re-mapped in the scene, which are written to the bake cache with the baked FBX
+    struct SceneTexture {
+        QUrl url;
+        image::TextureUsage::Type type;
+        QString bakedFileName;
+    };
+    QList<SceneTexture> _sceneTextures;
+    BakeCache::Key _cacheKey;
+
+    BakeStats _textureStats;
+
     TextureBakerThreadGetter _textureThreadGetter;
 
     bool _copyOriginals { true };
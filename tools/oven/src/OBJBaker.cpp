@@ -0,0 +1,267 @@
+//
+//  OBJBaker.cpp
+//  tools/oven/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QFile>
+#include <QtCore/QRegExp>
+#include <QtNetwork/QNetworkReply>
+
+#include <NetworkAccessManager.h>
+#include <SharedUtil.h>
+
+#include "ModelBakingLoggingCategory.h"
+
+#include "OBJBaker.h"
+
+static const QString BAKED_OUTPUT_SUBFOLDER = "baked/";
+
+static const QString MATERIAL_LIBRARY_KEYWORD = "mtllib";
+static const QString DIFFUSE_MAP_KEYWORD = "map_Kd";
+static const QString SPECULAR_MAP_KEYWORD = "map_Ks";
+
+OBJBaker::OBJBaker(const QUrl& objURL, const QString& baseOutputPath, TextureBakerThreadGetter textureThreadGetter) :
+    _objURL(objURL),
+    _baseOutputPath(baseOutputPath),
+    _textureThreadGetter(textureThreadGetter)
+{
+    // grab the name of the OBJ from the URL, this is used for folder output names
+    auto fileName = objURL.fileName();
+    _objName = fileName.left(fileName.lastIndexOf('.'));
+}
+
+void OBJBaker::bake() {
+    qCDebug(model_baking) << "Baking" << _objURL;
+
+    startBakeTimer();
+
+    // setup the output folder for the results of this bake
+    setupOutputFolder();
+
+    if (hasErrors()) {
+        return;
+    }
+
+    loadFile(_objURL, [this](bool success, const QByteArray& obj) {
+        if (success) {
+            handleLoadedOBJ(obj);
+        } else {
+            handleError("Failed to load " + _objURL.toString());
+        }
+    });
+}
+
+void OBJBaker::setupOutputFolder() {
+    // construct the output path using the name of the OBJ and the base output path
+    QString uniqueOutputPath = _baseOutputPath + "/" + _objName + "/";
+
+    // make sure there isn't already an output directory using the same name
+    int iteration = 0;
+
+    while (QDir(uniqueOutputPath).exists()) {
+        uniqueOutputPath = _baseOutputPath + "/" + _objName + "-" + QString::number(++iteration) + "/";
+    }
+
+    qCDebug(model_baking) << "Creating OBJ output folder" << uniqueOutputPath;
+
+    _bakedOutputPath = uniqueOutputPath + BAKED_OUTPUT_SUBFOLDER;
+
+    if (!QDir().mkpath(_bakedOutputPath)) {
+        handleError("Failed to create OBJ output folder " + uniqueOutputPath);
+    }
+}
+
+void OBJBaker::loadFile(const QUrl& url, LoadHandler handler) {
+    // check if the file is local or first needs to be downloaded
+    if (url.isLocalFile()) {
+        QFile localFile { url.toLocalFile() };
+
+        if (localFile.open(QIODevice::ReadOnly)) {
+            handler(true, localFile.readAll());
+        } else {
+            handler(false, QByteArray());
+        }
+    } else {
+        // remote file, kick off a download
+        auto& networkAccessManager = NetworkAccessManager::getInstance();
+
+        QNetworkRequest networkRequest;
+
+        // setup the request to follow re-directs and always hit the network
+        networkRequest.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+        networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+        networkRequest.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
+
+        networkRequest.setUrl(url);
+
+        qCDebug(model_baking) << "Downloading" << url;
+
+        auto networkReply = networkAccessManager.get(networkRequest);
+        connect(networkReply, &QNetworkReply::finished, this, [networkReply, handler] {
+            networkReply->deleteLater();
+
+            if (networkReply->error() == QNetworkReply::NoError) {
+                handler(true, networkReply->readAll());
+            } else {
+                handler(false, QByteArray());
+            }
+        });
+    }
+}
+
+void OBJBaker::handleLoadedOBJ(const QByteArray& obj) {
+    _inputSize = obj.size();
+
+    // the OBJ itself doesn't change, only the material libraries beside it do
+    QFile bakedOBJ { _bakedOutputPath + _objName + BAKED_OBJ_EXTENSION };
+
+    if (!bakedOBJ.open(QIODevice::WriteOnly) || bakedOBJ.write(obj) == -1) {
+        handleError("Could not write baked OBJ for " + _objURL.toString());
+        return;
+    }
+
+    // save the relative path to this OBJ inside our passed output folder
+    _bakedOBJRelativePath = bakedOBJ.fileName();
+    _bakedOBJRelativePath.remove(_baseOutputPath + "/");
+
+    // find the material libraries without splitting up what could be a very large OBJ
+    QStringList libraryNames;
+    int lineStart = 0;
+    while (lineStart < obj.size()) {
+        int lineEnd = obj.indexOf('\n', lineStart);
+        if (lineEnd == -1) {
+            lineEnd = obj.size();
+        }
+
+        if (obj.at(lineStart) == MATERIAL_LIBRARY_KEYWORD.at(0)) {
+            auto tokens = QString::fromUtf8(obj.mid(lineStart, lineEnd - lineStart)).simplified().split(' ');
+            if (tokens.size() > 1 && tokens[0] == MATERIAL_LIBRARY_KEYWORD) {
+                for (int i = 1; i < tokens.size(); ++i) {
+                    // interface throws away any path of a material library and loads it from beside the OBJ
+                    auto libraryName = QUrl(tokens[i]).fileName();
+                    if (!libraryName.isEmpty() && !libraryNames.contains(libraryName)) {
+                        libraryNames << libraryName;
+                    }
+                }
+            }
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    _numPendingMaterialLibraries = libraryNames.size();
+
+    for (const auto& libraryName : libraryNames) {
+        // the baked material libraries go beside the baked OBJ, where interface will look for them
+        loadFile(_objURL.resolved(QUrl(libraryName)), [this, libraryName](bool success, const QByteArray& library) {
+            if (success) {
+                handleLoadedMaterialLibrary(libraryName, library);
+            } else {
+                _errorList << "Failed to load material library " + libraryName + " of " + _objURL.toString();
+            }
+
+            --_numPendingMaterialLibraries;
+            checkIfFinished();
+        });
+    }
+
+    // in case there were no material libraries, or they were all local and had no textures
+    checkIfFinished();
+}
+
+void OBJBaker::handleLoadedMaterialLibrary(const QString& libraryName, const QByteArray& library) {
+    _inputSize += library.size();
+
+    QByteArray bakedLibrary;
+
+    for (const auto& line : library.split('\n')) {
+        auto text = QString::fromUtf8(line).trimmed();
+        auto keyword = text.left(text.indexOf(QRegExp("\\s")));
+        auto reference = text.mid(keyword.length()).trimmed();
+
+        if ((keyword == DIFFUSE_MAP_KEYWORD || keyword == SPECULAR_MAP_KEYWORD) && !reference.isEmpty()) {
+            // interface only uses the file name of a map, beside the OBJ, and skips TGA files
+            auto textureFileName = QUrl(reference).fileName();
+
+            if (!textureFileName.isEmpty() && !textureFileName.endsWith(".tga", Qt::CaseInsensitive)) {
+                auto textureType = keyword == DIFFUSE_MAP_KEYWORD ?
+                    image::TextureUsage::ALBEDO_TEXTURE : image::TextureUsage::SPECULAR_TEXTURE;
+                bakeTexture(_objURL.resolved(QUrl(textureFileName)), textureType);
+
+                // the name the texture baker gives the baked texture
+                auto bakedTextureFileName = textureFileName.left(textureFileName.lastIndexOf('.')) + BAKED_TEXTURE_EXT;
+                bakedLibrary += keyword.toUtf8() + " " + bakedTextureFileName.toUtf8() + "\n";
+                continue;
+            }
+        }
+
+        bakedLibrary += line + "\n";
+    }
+
+    // splitting added a line after the last newline
+    bakedLibrary.chop(1);
+
+    QFile bakedLibraryFile { _bakedOutputPath + libraryName };
+
+    if (!bakedLibraryFile.open(QIODevice::WriteOnly) || bakedLibraryFile.write(bakedLibrary) == -1) {
+        _errorList << "Could not write baked material library " + libraryName + " of " + _objURL.toString();
+    }
+}
+
+void OBJBaker::bakeTexture(const QUrl& textureURL, image::TextureUsage::Type textureType) {
+    // a map used by more than one material is baked once
+    if (_textureURLs.contains(textureURL)) {
+        return;
+    }
+    _textureURLs.insert(textureURL);
+
+    QSharedPointer<TextureBaker> bakingTexture {
+        new TextureBaker(textureURL, textureType, _bakedOutputPath),
+        &TextureBaker::deleteLater
+    };
+
+    bakingTexture->setBakeCache(_bakeCache);
+
+    // make sure we hear when the baking texture is done
+    connect(bakingTexture.data(), &Baker::finished, this, &OBJBaker::handleBakedTexture);
+
+    // keep a shared pointer to the baking texture
+    _bakingTextures.insert(textureURL, bakingTexture);
+
+    // start baking the texture on one of our available worker threads
+    bakingTexture->moveToThread(_textureThreadGetter());
+    QMetaObject::invokeMethod(bakingTexture.data(), "bake");
+}
+
+void OBJBaker::handleBakedTexture() {
+    auto bakedTexture = qobject_cast<TextureBaker*>(sender());
+
+    if (bakedTexture && _bakingTextures.contains(bakedTexture->getTextureURL())) {
+        _textureStats.add(*bakedTexture);
+
+        if (bakedTexture->hasErrors()) {
+            // we don't emit finished yet so that the other textures can finish baking first
+            _errorList << bakedTexture->getErrors();
+        }
+
+        _bakingTextures.remove(bakedTexture->getTextureURL());
+        checkIfFinished();
+    }
+}
+
+void OBJBaker::checkIfFinished() {
+    if (!_hasFinished && _numPendingMaterialLibraries == 0 && _bakingTextures.isEmpty()) {
+        _hasFinished = true;
+
+        if (!hasErrors()) {
+            qCDebug(model_baking) << "Finished baking" << _objURL;
+        }
+
+        emit finished();
+    }
+}
@@ -0,0 +1,76 @@
+//
+//  OBJBaker.h
+//  tools/oven/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OBJBaker_h
+#define hifi_OBJBaker_h
+
+#include <functional>
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QUrl>
+
+#include "Baker.h"
+#include "TextureBaker.h"
+
+static const QString BAKED_OBJ_EXTENSION = ".baked.obj";
+
+// Bakes the textures of an OBJ model to KTX.  The OBJ is kept as it is and its material libraries are re-written to
+// point to the baked textures, so this needs no SDK.  Only the diffuse and specular maps are baked since those are
+// the ones the OBJ reader in interface loads.
+class OBJBaker : public Baker {
+    Q_OBJECT
+public:
+    OBJBaker(const QUrl& objURL, const QString& baseOutputPath, TextureBakerThreadGetter textureThreadGetter);
+
+    QUrl getOBJUrl() const { return _objURL; }
+    QString getBakedOBJRelativePath() const { return _bakedOBJRelativePath; }
+
+    // the textures of this OBJ that were baked along with it
+    const BakeStats& getTextureStats() const { return _textureStats; }
+
+public slots:
+    virtual void bake() override;
+
+private slots:
+    void handleBakedTexture();
+
+private:
+    using LoadHandler = std::function<void(bool success, const QByteArray& data)>;
+
+    void setupOutputFolder();
+    void loadFile(const QUrl& url, LoadHandler handler);
+
+    void handleLoadedOBJ(const QByteArray& obj);
+    void handleLoadedMaterialLibrary(const QString& libraryName, const QByteArray& library);
+
+    void bakeTexture(const QUrl& textureURL, image::TextureUsage::Type textureType);
+    void checkIfFinished();
+
+    QUrl _objURL;
+    QString _objName;
+
+    QString _baseOutputPath;
+    QString _bakedOutputPath;
+    QString _bakedOBJRelativePath;
+
+    int _numPendingMaterialLibraries { 0 };
+    QHash<QUrl, QSharedPointer<TextureBaker>> _bakingTextures;
+    QSet<QUrl> _textureURLs;
+
+    TextureBakerThreadGetter _textureThreadGetter;
+    BakeStats _textureStats;
+
+    bool _hasFinished { false };
+};
+
+#endif // hifi_OBJBaker_h
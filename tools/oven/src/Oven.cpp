@@ -12,6 +12,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QThread>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QFileInfo>
 
 #include <image/Image.h>
 #include <SettingInterface.h>
@@ -19,11 +20,26 @@
 #include "ui/OvenMainWindow.h"
 #include "Oven.h"
 #include "BakerCLI.h"
+#include "BatchBaker.h"
+#include "TextureBaker.h"
 
 static const QString OUTPUT_FOLDER = "/Users/birarda/code/hifi/lod/test-oven/export";
 
 static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
+static const QString CLI_SUPERCOMPRESS_PARAMETER = "supercompress";
+static const QString CLI_NATIVE_PARAMETER = "native";
+static const QString CLI_CACHE_PARAMETER = "cache";
+static const QString CLI_NO_CACHE_PARAMETER = "no-cache";
+static const QString CLI_BATCH_PARAMETER = "batch";
+static const QString CLI_REPORT_PARAMETER = "report";
+static const QString CLI_MEMORY_BUDGET_PARAMETER = "memory-budget";
+
+static const QString DEFAULT_REPORT_FILE_NAME = "bake-report.json";
+static const qint64 DEFAULT_MEMORY_BUDGET_MB = 4096;
+
+// relative to the application data folder
+static const QString DEFAULT_BAKE_CACHE_DIRECTORY = "bake-cache";
 
 Oven::Oven(int argc, char* argv[]) :
     QApplication(argc, argv)
@@ -39,7 +55,16 @@ Oven::Oven(int argc, char* argv[]) :
    
     parser.addOptions({
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
-        { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" }
+        { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
+        { CLI_SUPERCOMPRESS_PARAMETER, "Compress the mips of baked textures with zstd." },
+        { CLI_NATIVE_PARAMETER, "Generate and compress texture mips with the parallel encoder instead of nvtt." },
+        { CLI_CACHE_PARAMETER, "Path to folder that holds the results of previous bakes.", "cache" },
+        { CLI_NO_CACHE_PARAMETER, "Bake every asset again, without reading or writing the bake cache." },
+        { CLI_BATCH_PARAMETER, "Path to a domain entities file or a list of assets to bake into the output folder.", "manifest" },
+        { CLI_REPORT_PARAMETER, "Path to the JSON report of a batch, by default " + DEFAULT_REPORT_FILE_NAME
+            + " in the output folder.", "report" },
+        { CLI_MEMORY_BUDGET_PARAMETER, "Megabytes that the bakes of a batch may take at once, by default "
+            + QString::number(DEFAULT_MEMORY_BUDGET_MB) + ".", "megabytes" }
     });
     parser.addHelpOption();
     parser.process(*this);
@@ -49,6 +74,17 @@ Oven::Oven(int argc, char* argv[]) :
     image::setGrayscaleTexturesCompressionEnabled(true);
     image::setNormalTexturesCompressionEnabled(true);
     image::setCubeTexturesCompressionEnabled(true);
+    image::setNativeTextureProcessingEnabled(parser.isSet(CLI_NATIVE_PARAMETER));
+
+    TextureBaker::setSupercompressionEnabled(parser.isSet(CLI_SUPERCOMPRESS_PARAMETER));
+
+    // assets that haven't changed since a previous bake are copied from the bake cache instead of being baked again
+    if (!parser.isSet(CLI_NO_CACHE_PARAMETER)) {
+        auto cacheDirectory = parser.isSet(CLI_CACHE_PARAMETER) ?
+            QDir(QDir::fromNativeSeparators(parser.value(CLI_CACHE_PARAMETER))).absolutePath() : DEFAULT_BAKE_CACHE_DIRECTORY;
+        _bakeCache = std::make_shared<BakeCache>(cacheDirectory.toStdString());
+        _bakeCache->initialize();
+    }
 
     // setup our worker threads
     setupWorkerThreads(QThread::idealThreadCount() - 1);
@@ -58,7 +94,30 @@ Oven::Oven(int argc, char* argv[]) :
     setupFBXBakerThread();
 
     // check if we were passed any command line arguments that would tell us just to run without the GUI
-    if (parser.isSet(CLI_INPUT_PARAMETER) || parser.isSet(CLI_OUTPUT_PARAMETER)) {
+    if (parser.isSet(CLI_BATCH_PARAMETER)) {
+        if (parser.isSet(CLI_OUTPUT_PARAMETER)) {
+            auto outputPath = QDir(QDir::fromNativeSeparators(parser.value(CLI_OUTPUT_PARAMETER))).absolutePath();
+            auto reportPath = parser.isSet(CLI_REPORT_PARAMETER) ?
+                QFileInfo(QDir::fromNativeSeparators(parser.value(CLI_REPORT_PARAMETER))).absoluteFilePath() :
+                QDir(outputPath).absoluteFilePath(DEFAULT_REPORT_FILE_NAME);
+
+            bool isValidBudget = true;
+            auto memoryBudgetMB = parser.isSet(CLI_MEMORY_BUDGET_PARAMETER) ?
+                parser.value(CLI_MEMORY_BUDGET_PARAMETER).toLongLong(&isValidBudget) : DEFAULT_MEMORY_BUDGET_MB;
+
+            if (!isValidBudget || memoryBudgetMB <= 0) {
+                qWarning() << "The memory budget must be a positive number of megabytes";
+                memoryBudgetMB = DEFAULT_MEMORY_BUDGET_MB;
+            }
+
+            BakerCLI* cli = new BakerCLI(this);
+            auto manifestPath = QFileInfo(QDir::fromNativeSeparators(parser.value(CLI_BATCH_PARAMETER))).absoluteFilePath();
+            cli->bakeBatch(QUrl::fromLocalFile(manifestPath), outputPath, reportPath, memoryBudgetMB * BYTES_PER_MEGABYTE);
+        } else {
+            parser.showHelp();
+            QApplication::quit();
+        }
+    } else if (parser.isSet(CLI_INPUT_PARAMETER) || parser.isSet(CLI_OUTPUT_PARAMETER)) {
         if (parser.isSet(CLI_INPUT_PARAMETER) && parser.isSet(CLI_OUTPUT_PARAMETER)) {
             BakerCLI* cli = new BakerCLI(this);
             QUrl inputUrl(QDir::fromNativeSeparators(parser.value(CLI_INPUT_PARAMETER)));
@@ -18,6 +18,8 @@
 
 #include <atomic>
 
+#include "BakeCache.h"
+
 #if defined(qApp)
 #undef qApp
 #endif
@@ -37,6 +39,9 @@ public:
     QThread* getFBXBakerThread();
     QThread* getNextWorkerThread();
 
+    // null when the oven was asked to bake without the cache
+    BakeCachePointer getBakeCache() const { return _bakeCache; }
+
 private:
     void setupWorkerThreads(int numWorkerThreads);
     void setupFBXBakerThread();
@@ -47,6 +52,8 @@ private:
 
     std::atomic<uint> _nextWorkerThreadIndex;
     int _numWorkerThreads;
+
+    BakeCachePointer _bakeCache;
 };
 
 
@@ -24,6 +24,9 @@
 #include "TextureBaker.h"
 
 const QString BAKED_TEXTURE_EXT = ".ktx";
+const QString TEXTURE_BAKER_VERSION = "1";
+
+std::atomic<bool> TextureBaker::_isSupercompressionEnabled { false };
 
 TextureBaker::TextureBaker(const QUrl& textureURL, image::TextureUsage::Type textureType, const QDir& outputDirectory) :
     _textureURL(textureURL),
@@ -36,6 +39,8 @@ TextureBaker::TextureBaker(const QUrl& textureURL, image::TextureUsage::Type tex
 }
 
 void TextureBaker::bake() {
+    startBakeTimer();
+
     // once our texture is loaded, kick off a the processing
     connect(this, &TextureBaker::originalTextureLoaded, this, &TextureBaker::processTexture);
 
@@ -94,7 +99,82 @@ void TextureBaker::handleTextureNetworkReply() {
     }
 }
 
+QString TextureBaker::getCacheOptions() {
+    return QString("color:%1 normal:%2 grayscale:%3 cube:%4 native:%5 supercompress:%6")
+        .arg(image::isColorTexturesCompressionEnabled())
+        .arg(image::isNormalTexturesCompressionEnabled())
+        .arg(image::isGrayscaleTexturesCompressionEnabled())
+        .arg(image::isCubeTexturesCompressionEnabled())
+        .arg(image::isNativeTextureProcessingEnabled())
+        .arg(isSupercompressionEnabled());
+}
+
 void TextureBaker::processTexture() {
+    _inputSize = _originalTexture.size();
+
+    if (!_bakeCache) {
+        encodeTexture();
+        return;
+    }
+
+    if (_cacheKey.empty()) {
+        auto options = QString("type:%1 ").arg((int)_textureType) + getCacheOptions();
+        _cacheKey = BakeCache::getKey(TEXTURE_BAKER_VERSION, options, _originalTexture);
+    }
+
+    if (restoreFromCache()) {
+        return;
+    }
+
+    // listen before claiming so that a release between the two isn't missed
+    connect(_bakeCache.get(), &BakeCache::released, this, &TextureBaker::handleReleasedBake);
+
+    if (!_bakeCache->claim(_cacheKey)) {
+        // another baker is baking the same texture, this one takes its result once it is done
+        qCDebug(model_baking) << "Waiting for the bake of a texture with the same contents as" << _textureURL;
+        return;
+    }
+
+    disconnect(_bakeCache.get(), &BakeCache::released, this, &TextureBaker::handleReleasedBake);
+
+    // the baker that had it may have released it between the read and the claim
+    if (!restoreFromCache()) {
+        encodeTexture();
+    }
+
+    _bakeCache->release(_cacheKey);
+}
+
+void TextureBaker::handleReleasedBake(const QString& key) {
+    if (key.toStdString() != _cacheKey) {
+        return;
+    }
+
+    disconnect(_bakeCache.get(), &BakeCache::released, this, &TextureBaker::handleReleasedBake);
+
+    // the other bake failed if its result isn't cached, in which case this one tries for itself
+    processTexture();
+}
+
+bool TextureBaker::restoreFromCache() {
+    BakedFiles cachedFiles;
+    if (!_bakeCache->read(_cacheKey, cachedFiles)) {
+        return false;
+    }
+
+    QFile bakedTextureFile { _outputDirectory.absoluteFilePath(_bakedTextureFileName) };
+    if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(cachedFiles.first()) == -1) {
+        handleError("Could not write baked texture for " + _textureURL.toString());
+        return true;
+    }
+
+    qCDebug(model_baking) << "Restored baked texture" << _textureURL << "from the bake cache";
+    _wasCached = true;
+    emit finished();
+    return true;
+}
+
+void TextureBaker::encodeTexture() {
     auto processedTexture = image::processImage(_originalTexture, _textureURL.toString().toStdString(),
                                                 ABSOLUTE_MAX_TEXTURE_NUM_PIXELS, _textureType);
 
@@ -116,16 +196,53 @@ void TextureBaker::processTexture() {
         return;
     }
 
-    const char* data = reinterpret_cast<const char*>(memKTX->_storage->data());
-    const size_t length = memKTX->_storage->size();
+    auto storage = memKTX->getStorage();
+    if (isSupercompressionEnabled()) {
+        storage = supercompress(*memKTX);
+
+        if (!storage) {
+            handleError("Could not supercompress " + _textureURL.toString());
+            return;
+        }
+
+        qCDebug(model_baking) << "Supercompressed" << _textureURL << "from" << memKTX->getStorage()->size()
+            << "to" << storage->size() << "bytes";
+    }
+
+    const char* data = reinterpret_cast<const char*>(storage->data());
+    const size_t length = storage->size();
 
     // attempt to write the baked texture to the destination file path
     QFile bakedTextureFile { _outputDirectory.absoluteFilePath(_bakedTextureFileName) };
 
     if (!bakedTextureFile.open(QIODevice::WriteOnly) || bakedTextureFile.write(data, length) == -1) {
         handleError("Could not write baked texture for " + _textureURL.toString());
+        return;
+    }
+
+    if (_bakeCache) {
+        BakedFiles bakedFiles;
+        bakedFiles.insert(_bakedTextureFileName, QByteArray(data, (int)length));
+        if (!_bakeCache->write(_cacheKey, bakedFiles)) {
+            handleWarning("Could not add baked texture for " + _textureURL.toString() + " to the bake cache");
+        }
     }
 
     qCDebug(model_baking) << "Baked texture" << _textureURL;
     emit finished();
 }
+
+ktx::StoragePointer TextureBaker::supercompress(const ktx::KTX& ktx) {
+    auto supercompressed = ktx::KTX::supercompress(ktx);
+
+    // a dictionary goes in the file too, so it is only used when it saves more than its own size
+    auto dictionary = ktx::KTX::trainSupercompressionDictionary(ktx);
+    if (!dictionary.empty()) {
+        auto withDictionary = ktx::KTX::supercompress(ktx, dictionary);
+        if (withDictionary && (!supercompressed || withDictionary->size() < supercompressed->size())) {
+            supercompressed = withDictionary;
+        }
+    }
+
+    return supercompressed;
+}
@@ -12,16 +12,25 @@
 #ifndef hifi_TextureBaker_h
 #define hifi_TextureBaker_h
 
+#include <atomic>
+#include <functional>
+
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QRunnable>
 
 #include <image/Image.h>
+#include <ktx/KTX.h>
 
 #include "Baker.h"
 
 extern const QString BAKED_TEXTURE_EXT;
 
+using TextureBakerThreadGetter = std::function<QThread*()>;
+
+// bump this when a change to the texture baker changes what it outputs, so cached bakes are not re-used
+extern const QString TEXTURE_BAKER_VERSION;
+
 class TextureBaker : public Baker {
     Q_OBJECT
 
@@ -35,6 +44,13 @@ public:
     QString getDestinationFilePath() const { return _outputDirectory.absoluteFilePath(_bakedTextureFileName); }
     QString getBakedTextureFileName() const { return _bakedTextureFileName; }
 
+    // baked textures are supercompressed with zstd when this is set, see ktx::SupercompressionTable
+    static void setSupercompressionEnabled(bool enabled) { _isSupercompressionEnabled = enabled; }
+    static bool isSupercompressionEnabled() { return _isSupercompressionEnabled; }
+
+    // the settings that change the output of a bake, which are part of the bake cache key of a texture
+    static QString getCacheOptions();
+
 public slots:
     virtual void bake() override;
 
@@ -43,17 +59,27 @@ signals:
 
 private slots:
     void processTexture();
+    void handleReleasedBake(const QString& key);
 
 private:
     void loadTexture();
     void handleTextureNetworkReply();
 
+    void encodeTexture();
+    bool restoreFromCache();
+
+    static ktx::StoragePointer supercompress(const ktx::KTX& ktx);
+
+    static std::atomic<bool> _isSupercompressionEnabled;
+
     QUrl _textureURL;
     QByteArray _originalTexture;
     image::TextureUsage::Type _textureType;
 
     QDir _outputDirectory;
     QString _bakedTextureFileName;
+
+    BakeCache::Key _cacheKey;
 };
 
 #endif // hifi_TextureBaker_h
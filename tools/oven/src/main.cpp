@@ -8,9 +8,23 @@
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 
+#include <cstring>
+
+#include <QtCore/QtGlobal>
+
 #include "Oven.h"
 
 int main (int argc, char** argv) {
+    // baking from the command line needs no display, so it can run on a build machine without one
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], "-i") == 0 || strncmp(argv[i], "--batch", strlen("--batch")) == 0) {
+                qputenv("QT_QPA_PLATFORM", "offscreen");
+                break;
+            }
+        }
+    }
+
     Oven app(argc, argv);
     return app.exec();
 }
@@ -216,6 +216,9 @@ void DomainBakeWidget::bakeButtonClicked() {
                                 _rebakeOriginalsCheckBox->isChecked())
         };
 
+        // re-use what was baked before for the assets that didn't change
+        domainBaker->setBakeCache(qApp->getBakeCache());
+
         // make sure we hear from the baker when it is done
         connect(domainBaker.get(), &DomainBaker::finished, this, &DomainBakeWidget::handleFinishedBaker);
 
@@ -185,6 +185,8 @@ void ModelBakeWidget::bakeButtonClicked() {
             }, false)
         };
 
+        baker->setBakeCache(qApp->getBakeCache());
+
         // move the baker to the FBX baker thread
         baker->moveToThread(qApp->getFBXBakerThread());
 
@@ -180,6 +180,8 @@ void SkyboxBakeWidget::bakeButtonClicked() {
             new TextureBaker(skyboxToBakeURL, image::TextureUsage::CUBE_TEXTURE, outputDirectory.absolutePath())
         };
 
+        baker->setBakeCache(qApp->getBakeCache());
+
         // move the baker to a worker thread
         baker->moveToThread(qApp->getNextWorkerThread());
 
@@ -0,0 +1,102 @@
+//
+//  RecordingConvertApp.cpp
+//  tools/recording-convert/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RecordingConvertApp.h"
+
+#include <QCommandLineParser>
+#include <QFileInfo>
+
+#include <AvatarData.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+
+RecordingConvertApp::RecordingConvertApp(int argc, char* argv[]) : QCoreApplication(argc, argv) {
+
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity Recording Converter\n"
+        "Rewrites a recording with the binary avatar frames and delta encoded frames.");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption inputFilenameOption("i", "input file", "recording.hfr");
+    parser.addOption(inputFilenameOption);
+
+    const QCommandLineOption outputFilenameOption("o", "output file", "recording.hfr");
+    parser.addOption(outputFilenameOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        return;
+    }
+
+    if (!parser.isSet(inputFilenameOption) || !parser.isSet(outputFilenameOption)) {
+        qCritical() << "Both an input and an output file are required";
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    bool verbose = parser.isSet(verboseOutput);
+    QString inputFilename = parser.value(inputFilenameOption);
+    QString outputFilename = parser.value(outputFilenameOption);
+
+    // the frame types of the input clip are mapped to the ones registered here
+    recording::FrameType avatarFrameType = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+
+    auto inputClip = recording::Clip::fromFile(inputFilename);
+    if (!inputClip) {
+        qCritical() << "Failed to read recording " << inputFilename;
+        _returnCode = 2;
+        return;
+    }
+
+    auto outputClip = recording::Clip::newClip();
+    int numAvatarFrames = 0;
+    int numFailedFrames = 0;
+    inputClip->seekFrameTime(0);
+    for (auto frame = inputClip->nextFrame(); frame; frame = inputClip->nextFrame()) {
+        auto convertedFrame = std::make_shared<recording::Frame>();
+        convertedFrame->type = frame->type;
+        convertedFrame->timeOffset = frame->timeOffset;
+        convertedFrame->data = frame->data;
+        if (frame->type == avatarFrameType) {
+            convertedFrame->data = AvatarData::convertLegacyFrame(frame->data);
+            if (convertedFrame->data.isEmpty()) {
+                ++numFailedFrames;
+                continue;
+            }
+            ++numAvatarFrames;
+        }
+        outputClip->addFrame(convertedFrame);
+    }
+
+    recording::Clip::toFile(outputFilename, outputClip);
+
+    if (verbose) {
+        qDebug() << "Converted" << numAvatarFrames << "avatar frames of" << outputClip->frameCount() << "frames";
+        qDebug() << "Size" << QFileInfo(inputFilename).size() << "->" << QFileInfo(outputFilename).size() << "bytes";
+    }
+    if (numFailedFrames > 0) {
+        qWarning() << "Dropped" << numFailedFrames << "avatar frames that could not be read";
+    }
+}
+
+RecordingConvertApp::~RecordingConvertApp() {
+}
@@ -0,0 +1,28 @@
+//
+//  RecordingConvertApp.h
+//  tools/recording-convert/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RecordingConvertApp_h
+#define hifi_RecordingConvertApp_h
+
+#include <QCoreApplication>
+
+class RecordingConvertApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    RecordingConvertApp(int argc, char* argv[]);
+    ~RecordingConvertApp();
+
+    int getReturnCode() const { return _returnCode; }
+
+private:
+    int _returnCode { 0 };
+};
+
+#endif //hifi_RecordingConvertApp_h
@@ -0,0 +1,109 @@
+//
+//  LoopbackLink.cpp
+//  tools/udt-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoopbackLink.h"
+
+#include <algorithm>
+
+#include <NumericalConstants.h>
+
+using namespace std::chrono;
+
+static const double BITS_PER_BYTE = 8.0;
+
+LoopbackLink::LoopbackLink(const HifiSockAddr& server, const Settings& settings, QObject* parent) :
+    QObject(parent),
+    _settings(settings),
+    _socket(this),
+    _server(server),
+    _bottleneckFreeTime(p_high_resolution_clock::now())
+{
+    _socket.bind(QHostAddress::LocalHost);
+    connect(&_socket, &QUdpSocket::readyRead, this, &LoopbackLink::readPendingDatagrams);
+
+    _deliveryTimer.setSingleShot(true);
+    _deliveryTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_deliveryTimer, &QTimer::timeout, this, &LoopbackLink::deliverDatagrams);
+}
+
+HifiSockAddr LoopbackLink::getSockAddr() const {
+    return HifiSockAddr(QHostAddress::LocalHost, _socket.localPort());
+}
+
+void LoopbackLink::readPendingDatagrams() {
+    while (_socket.hasPendingDatagrams()) {
+        auto now = p_high_resolution_clock::now();
+
+        Datagram datagram;
+        HifiSockAddr sender;
+        datagram.data.resize(_socket.pendingDatagramSize());
+        auto sizeRead = _socket.readDatagram(datagram.data.data(), datagram.data.size(),
+                                             sender.getAddressPointer(), sender.getPortPointer());
+        if (sizeRead <= 0) {
+            continue;
+        }
+
+        if (_distribution(_generator) < _settings.loss) {
+            ++_numRandomDrops;
+            continue;
+        }
+
+        auto delay = microseconds(_settings.latency * USECS_PER_MSEC / 2);
+        if (_settings.jitter > 0) {
+            delay += microseconds((int)(_distribution(_generator) * _settings.jitter * USECS_PER_MSEC));
+        }
+
+        if (sender == _server) {
+            datagram.destination = _client;
+            datagram.deliveryTime = now + delay;
+        } else {
+            // anything that isn't the server is the client, and goes through the bottleneck
+            _client = sender;
+            datagram.destination = _server;
+
+            auto queueStart = std::max(now, _bottleneckFreeTime);
+            if (queueStart - now > milliseconds(_settings.bufferSize)) {
+                ++_numBufferDrops;
+                continue;
+            }
+
+            // at a megabit per second, a bit takes a microsecond
+            auto transmitTime = microseconds((int)(sizeRead * BITS_PER_BYTE / _settings.bandwidth));
+            _bottleneckFreeTime = queueStart + transmitTime;
+            datagram.deliveryTime = _bottleneckFreeTime + delay;
+        }
+
+        _datagrams.push(datagram);
+    }
+
+    scheduleDelivery();
+}
+
+void LoopbackLink::deliverDatagrams() {
+    auto now = p_high_resolution_clock::now();
+    while (!_datagrams.empty() && _datagrams.top().deliveryTime <= now) {
+        const auto& datagram = _datagrams.top();
+        if (!datagram.destination.isNull()) {
+            _socket.writeDatagram(datagram.data, datagram.destination.getAddress(), datagram.destination.getPort());
+        }
+        _datagrams.pop();
+    }
+
+    scheduleDelivery();
+}
+
+void LoopbackLink::scheduleDelivery() {
+    if (_datagrams.empty()) {
+        return;
+    }
+
+    auto untilNext = duration_cast<milliseconds>(_datagrams.top().deliveryTime - p_high_resolution_clock::now());
+    _deliveryTimer.start(std::max(0, (int)untilNext.count()));
+}
@@ -0,0 +1,82 @@
+//
+//  LoopbackLink.h
+//  tools/udt-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LoopbackLink_h
+#define hifi_LoopbackLink_h
+
+#include <queue>
+#include <random>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtNetwork/QUdpSocket>
+
+#include <HifiSockAddr.h>
+#include <PortableHighResolutionClock.h>
+
+// Relays the datagrams between a client and a server on this machine as a slower, longer and lossier link would.
+//
+// The datagrams from the client go through a bottleneck of the given bandwidth, with a buffer that drops what doesn't
+// fit, and both directions are delayed by half the round trip latency plus some jitter and randomly dropped.
+class LoopbackLink : public QObject {
+    Q_OBJECT
+public:
+    struct Settings {
+        int latency { 100 }; // round trip, in milliseconds
+        int jitter { 0 }; // at most, added to the delay of each datagram, in milliseconds
+        float loss { 0.0f }; // chance of dropping each datagram, in each direction
+        int bandwidth { 100 }; // of the bottleneck from the client to the server, in megabits per second
+        int bufferSize { 100 }; // of the bottleneck, in milliseconds at its bandwidth
+    };
+
+    LoopbackLink(const HifiSockAddr& server, const Settings& settings, QObject* parent = nullptr);
+
+    // the address the client sends to for the server
+    HifiSockAddr getSockAddr() const;
+
+    int getNumRandomDrops() const { return _numRandomDrops; }
+    int getNumBufferDrops() const { return _numBufferDrops; }
+
+private slots:
+    void readPendingDatagrams();
+    void deliverDatagrams();
+
+private:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    struct Datagram {
+        TimePoint deliveryTime;
+        QByteArray data;
+        HifiSockAddr destination;
+
+        bool operator>(const Datagram& other) const { return deliveryTime > other.deliveryTime; }
+    };
+
+    void scheduleDelivery();
+
+    Settings _settings;
+    QUdpSocket _socket;
+    HifiSockAddr _server;
+    HifiSockAddr _client;
+
+    std::priority_queue<Datagram, std::vector<Datagram>, std::greater<Datagram>> _datagrams;
+    TimePoint _bottleneckFreeTime; // when the bottleneck is done with what is queued in it
+    QTimer _deliveryTimer;
+
+    std::mt19937 _generator { std::random_device()() };
+    std::uniform_real_distribution<float> _distribution { 0.0f, 1.0f };
+
+    int _numRandomDrops { 0 };
+    int _numBufferDrops { 0 };
+};
+
+#endif // hifi_LoopbackLink_h
@@ -12,7 +12,9 @@
 #include "UDTTest.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QTimer>
 
+#include <udt/BBRCC.h>
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
@@ -55,6 +57,49 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption CONGESTION_CONTROL {
+    "congestion-control", "congestion control for sent packets: default, vegas or bbr (default is vegas), "
+    "or a comma separated list of them to compare with --loopback", "names"
+};
+const QCommandLineOption LOOPBACK {
+    "loopback", "send to a receiver on this machine through an emulated link, with each congestion control in turn, "
+    "and compare them"
+};
+const QCommandLineOption LOOPBACK_DURATION {
+    "loopback-duration", "seconds to send with each congestion control on the loopback link (default is 10)", "seconds"
+};
+const QCommandLineOption LINK_LATENCY {
+    "link-latency", "round trip latency of the loopback link (default is 100ms)", "milliseconds"
+};
+const QCommandLineOption LINK_JITTER {
+    "link-jitter", "max jitter added to each packet on the loopback link (default is 0ms)", "milliseconds"
+};
+const QCommandLineOption LINK_LOSS {
+    "link-loss", "percentage of packets lost on the loopback link, in each direction (default is 0)", "percent"
+};
+const QCommandLineOption LINK_BANDWIDTH {
+    "link-bandwidth", "bottleneck bandwidth of the loopback link (default is 100Mb/s)", "megabits per second"
+};
+const QCommandLineOption LINK_BUFFER {
+    "link-buffer", "bottleneck buffer of the loopback link (default is 100ms)", "milliseconds"
+};
+
+const QStringList CONGESTION_CONTROLS { "default", "vegas", "bbr" };
+
+const QStringList LOOPBACK_RESULTS_TABLE_HEADERS {
+    "Congestion Control", "Goodput (Mb/s)", "Avg RTT (ms)", "Sent Packets", "Re-sent Packets", "Timeouts",
+    "Link Drops", "Buffer Drops"
+};
+
+static std::unique_ptr<udt::CongestionControlVirtualFactory> createCongestionControlFactory(const QString& name) {
+    if (name == "default") {
+        return std::unique_ptr<udt::CongestionControlVirtualFactory>(new udt::CongestionControlFactory<udt::DefaultCC>());
+    } else if (name == "bbr") {
+        return std::unique_ptr<udt::CongestionControlVirtualFactory>(new udt::CongestionControlFactory<udt::BBRCC>());
+    } else {
+        return std::unique_ptr<udt::CongestionControlVirtualFactory>(new udt::CongestionControlFactory<udt::TCPVegasCC>());
+    }
+}
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -78,6 +123,51 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // randomize the seed for packet size randomization
     srand(time(NULL));
 
+    QStringList congestionControls { "vegas" };
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        congestionControls = _argumentParser.value(CONGESTION_CONTROL).split(',', QString::SkipEmptyParts);
+        for (auto& name : congestionControls) {
+            if (!CONGESTION_CONTROLS.contains(name)) {
+                qCritical() << "Unknown congestion control" << name << "- expected one of" << CONGESTION_CONTROLS;
+                QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            }
+        }
+    }
+
+    if (_argumentParser.isSet(LOOPBACK)) {
+        _loopbackCongestionControls = congestionControls;
+
+        if (_argumentParser.isSet(LOOPBACK_DURATION)) {
+            _loopbackDuration = _argumentParser.value(LOOPBACK_DURATION).toInt();
+        }
+        if (_argumentParser.isSet(LINK_LATENCY)) {
+            _linkSettings.latency = _argumentParser.value(LINK_LATENCY).toInt();
+        }
+        if (_argumentParser.isSet(LINK_JITTER)) {
+            _linkSettings.jitter = _argumentParser.value(LINK_JITTER).toInt();
+        }
+        if (_argumentParser.isSet(LINK_LOSS)) {
+            static const float PERCENT = 100.0f;
+            _linkSettings.loss = _argumentParser.value(LINK_LOSS).toFloat() / PERCENT;
+        }
+        if (_argumentParser.isSet(LINK_BANDWIDTH)) {
+            _linkSettings.bandwidth = std::max(1, _argumentParser.value(LINK_BANDWIDTH).toInt());
+        }
+        if (_argumentParser.isSet(LINK_BUFFER)) {
+            _linkSettings.bufferSize = _argumentParser.value(LINK_BUFFER).toInt();
+        }
+
+        if (_argumentParser.isSet(TARGET_OPTION)) {
+            qCritical() << "Cannot set a target when sending on the loopback link.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+    } else if (congestionControls.size() > 1) {
+        qCritical() << "Cannot compare congestion controls without --loopback.";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    } else if (!congestionControls.isEmpty()) {
+        _socket.setCongestionControlFactory(createCongestionControlFactory(congestionControls.front()));
+    }
+
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
     
@@ -171,7 +261,9 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // seed the generator with a value that the receiver will also use when verifying the ordered message
     _generator.seed(messageSeed);
     
-    if (!_target.isNull()) {
+    if (!_loopbackCongestionControls.isEmpty()) {
+        startNextLoopbackRun();
+    } else if (!_target.isNull()) {
         sendInitialPackets();
     } else {
         // this is a receiver - in case there are ordered packets (messages) being sent to us make sure that we handle them
@@ -228,7 +320,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, CONGESTION_CONTROL, LOOPBACK, LOOPBACK_DURATION,
+        LINK_LATENCY, LINK_JITTER, LINK_LOSS, LINK_BANDWIDTH, LINK_BUFFER
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -260,6 +353,11 @@ void UDTTest::sendInitialPackets() {
 
 void UDTTest::sendPacket() {
     
+    if (_target.isNull()) {
+        // between loopback runs, nowhere to send
+        return;
+    }
+    
     if (_maxSendPackets != -1 && _totalQueuedPackets > _maxSendPackets) {
         // don't send more packets, we've hit max
         return;
@@ -399,6 +497,21 @@ void UDTTest::sampleStats() {
         
         // output this line of values
         qDebug() << qPrintable(values.join(" | "));
+
+        if (_loopbackReceiver && !_loopbackResults.empty()) {
+            auto& result = _loopbackResults.back();
+            result.sentPackets += stats.sentPackets;
+            result.retransmissions += stats.events[udt::ConnectionStats::Stats::Retransmission];
+            result.timeouts += stats.events[udt::ConnectionStats::Stats::ReceivedTimeoutNAK];
+            if (stats.rtt > 0) {
+                result.rttTotal += stats.rtt;
+                ++result.numRTTSamples;
+            }
+
+            for (auto& sockAddr : _loopbackReceiver->getConnectionSockAddrs()) {
+                result.receivedUtilBytes += _loopbackReceiver->sampleStatsForConnection(sockAddr).receivedUtilBytes;
+            }
+        }
     } else {
         if (first) {
             // output the headers for stats for our table
@@ -434,3 +547,84 @@ void UDTTest::sampleStats() {
         }
     }
 }
+
+void UDTTest::startNextLoopbackRun() {
+    if (++_loopbackRunIndex >= _loopbackCongestionControls.size()) {
+        printLoopbackResults();
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+
+    const auto& congestionControl = _loopbackCongestionControls[_loopbackRunIndex];
+
+    // both ends use the congestion control, the receiver's decides how it ACKs and NAKs
+    _socket.setCongestionControlFactory(createCongestionControlFactory(congestionControl));
+
+    _loopbackReceiver = new udt::Socket(this);
+    _loopbackReceiver->setCongestionControlFactory(createCongestionControlFactory(congestionControl));
+    _loopbackReceiver->bind(QHostAddress::LocalHost);
+
+    _loopbackLink = new LoopbackLink(HifiSockAddr(QHostAddress::LocalHost, _loopbackReceiver->localPort()),
+                                     _linkSettings, this);
+    _target = _loopbackLink->getSockAddr();
+
+    LoopbackResult result;
+    result.congestionControl = congestionControl;
+    _loopbackResults.push_back(result);
+
+    qDebug() << "Sending with" << congestionControl << "congestion control for" << _loopbackDuration << "seconds"
+        << "through a" << _linkSettings.bandwidth << "Mb/s link with" << _linkSettings.latency << "ms latency,"
+        << _linkSettings.jitter << "ms jitter and" << _linkSettings.loss * 100.0f << "% loss";
+
+    _totalQueuedPackets = 0;
+    _totalQueuedBytes = 0;
+    sendInitialPackets();
+
+    static const int MSECS_PER_SECOND = 1000;
+    QTimer::singleShot(_loopbackDuration * MSECS_PER_SECOND, this, &UDTTest::finishLoopbackRun);
+}
+
+void UDTTest::finishLoopbackRun() {
+    // pick up what happened since the last stats
+    sampleStats();
+
+    auto& result = _loopbackResults.back();
+    result.numRandomDrops = _loopbackLink->getNumRandomDrops();
+    result.numBufferDrops = _loopbackLink->getNumBufferDrops();
+
+    // stop sending, the packets still queued for the connection go with it
+    _socket.cleanupConnection(_target);
+    _target = HifiSockAddr();
+
+    _loopbackReceiver->deleteLater();
+    _loopbackReceiver = nullptr;
+    _loopbackLink->deleteLater();
+    _loopbackLink = nullptr;
+
+    startNextLoopbackRun();
+}
+
+void UDTTest::printLoopbackResults() {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+    static const double USECS_PER_MSEC = 1000.0;
+
+    qDebug() << qPrintable(LOOPBACK_RESULTS_TABLE_HEADERS.join(" | "));
+
+    for (auto& result : _loopbackResults) {
+        double goodput = result.receivedUtilBytes * MEGABITS_PER_BYTE / _loopbackDuration;
+        double averageRTT = result.numRTTSamples > 0 ? result.rttTotal / (result.numRTTSamples * USECS_PER_MSEC) : 0.0;
+
+        int headerIndex = -1;
+        QStringList values {
+            result.congestionControl.rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(goodput, 'f', 2).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(averageRTT, 'f', 2).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.sentPackets).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.retransmissions).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.timeouts).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.numRandomDrops).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size()),
+            QString::number(result.numBufferDrops).rightJustified(LOOPBACK_RESULTS_TABLE_HEADERS[++headerIndex].size())
+        };
+        qDebug() << qPrintable(values.join(" | "));
+    }
+}
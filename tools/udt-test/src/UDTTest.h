@@ -25,11 +25,26 @@
 
 #include <ReceivedMessage.h>
 
+#include "LoopbackLink.h"
+
 struct Message {
     udt::MessageNumber messageNumber;
     QByteArray data;
 };
 
+// what a congestion control did with the loopback link
+struct LoopbackResult {
+    QString congestionControl;
+    int64_t receivedUtilBytes { 0 };
+    int sentPackets { 0 };
+    int retransmissions { 0 };
+    int timeouts { 0 };
+    int64_t rttTotal { 0 };
+    int numRTTSamples { 0 };
+    int numRandomDrops { 0 };
+    int numBufferDrops { 0 };
+};
+
 class UDTTest : public QCoreApplication {
     Q_OBJECT
 public:
@@ -45,6 +60,11 @@ private:
     
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
+
+    // sends through a LoopbackLink to a receiver of our own with each congestion control in turn, and compares them
+    void startNextLoopbackRun();
+    void finishLoopbackRun();
+    void printLoopbackResults();
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
@@ -71,6 +91,14 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    QStringList _loopbackCongestionControls; // to compare with the loopback link, empty if not running on it
+    int _loopbackRunIndex { -1 };
+    int _loopbackDuration { 10 }; // of each run, in seconds
+    LoopbackLink::Settings _linkSettings;
+    udt::Socket* _loopbackReceiver { nullptr };
+    LoopbackLink* _loopbackLink { nullptr };
+    std::vector<LoopbackResult> _loopbackResults;
 };
 
 #endif // hifi_UDTTest_h